@@ -0,0 +1,147 @@
+// description: Compares the throughput of the single-stream gzip compressor with the parallel one at
+//    each compression level, over either a file or generated delimited data.
+//    usage: GzipBenchmark [--threads N] [--block_size BYTES] [--size BYTES | --file FILE]
+
+#include "ParallelGzipCompressor.hpp"
+#include "Stopwatch.hpp"
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string.h>
+
+namespace
+{
+	// counts what it is given, so only compression is timed
+	class CountingSink
+	{
+	public:
+		typedef char char_type;
+		typedef boost::iostreams::sink_tag category;
+
+		CountingSink( size_t& o_rCount ) : m_pCount( &o_rCount ) {}
+
+		std::streamsize write( const char*, std::streamsize i_Size )
+		{
+			*m_pCount += i_Size;
+			return i_Size;
+		}
+
+	private:
+		size_t* m_pCount;
+	};
+
+	// rows of ids, dates & amounts, roughly like the results of a typical load
+	std::string MakeData( size_t i_Size )
+	{
+		std::ostringstream result;
+		unsigned int value( 12345 );
+		size_t row( 0 );
+		while( size_t( result.tellp() ) < i_Size )
+		{
+			value = value * 1103515245 + 12345;
+			result << row++ << ",2014-10-" << std::setw( 2 ) << std::setfill( '0' ) << ( 1 + ( value >> 16 ) % 28 ) << ','
+				   << ( ( value >> 8 ) % 5000 ) << ",campaign_" << ( value % 97 ) << ',' << ( ( value >> 4 ) % 100000 ) / 100.0 << '\n';
+		}
+		return result.str().substr( 0, i_Size );
+	}
+
+	template< typename Filter >
+	double Run( const Filter& i_rFilter, const std::string& i_rData, size_t& o_rCompressedSize )
+	{
+		o_rCompressedSize = 0;
+		Stopwatch stopwatch;
+		boost::iostreams::filtering_ostream filter;
+		filter.push( i_rFilter );
+		filter.push( CountingSink( o_rCompressedSize ) );
+		filter.write( i_rData.data(), i_rData.size() );
+		filter.reset();
+		return stopwatch.GetElapsedMilliseconds() / 1000.0;
+	}
+
+	void Report( const std::string& i_rName, int i_Level, const std::string& i_rData, size_t i_CompressedSize, double i_Seconds )
+	{
+		std::cout << std::setw( 10 ) << i_rName
+				  << std::setw( 7 ) << i_Level
+				  << std::setw( 14 ) << i_CompressedSize
+				  << std::setw( 9 ) << std::fixed << std::setprecision( 3 ) << double( i_CompressedSize ) / i_rData.size()
+				  << std::setw( 10 ) << std::setprecision( 3 ) << i_Seconds
+				  << std::setw( 10 ) << std::setprecision( 1 ) << i_rData.size() / i_Seconds / ( 1024 * 1024 )
+				  << std::endl;
+	}
+}
+
+int main( int argc, char** argv )
+{
+	size_t threads( boost::thread::hardware_concurrency() );
+	size_t blockSize( 131072 );
+	size_t size( 64 * 1024 * 1024 );
+	std::string fileName;
+	for( int i = 1; i + 1 < argc; i += 2 )
+	{
+		if( ::strcmp( argv[i], "--threads" ) == 0 )
+		{
+			threads = boost::lexical_cast< size_t >( argv[i+1] );
+		}
+		else if( ::strcmp( argv[i], "--block_size" ) == 0 )
+		{
+			blockSize = boost::lexical_cast< size_t >( argv[i+1] );
+		}
+		else if( ::strcmp( argv[i], "--size" ) == 0 )
+		{
+			size = boost::lexical_cast< size_t >( argv[i+1] );
+		}
+		else if( ::strcmp( argv[i], "--file" ) == 0 )
+		{
+			fileName = argv[i+1];
+		}
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--threads N] [--block_size BYTES] [--size BYTES | --file FILE]" << std::endl;
+			return 1;
+		}
+	}
+	if( threads == 0 )
+	{
+		threads = 1;
+	}
+
+	std::string data;
+	if( fileName.empty() )
+	{
+		data = MakeData( size );
+	}
+	else
+	{
+		std::ifstream file( fileName.c_str() );
+		if( !file )
+		{
+			std::cerr << "Unable to open file: " << fileName << std::endl;
+			return 1;
+		}
+		std::ostringstream contents;
+		contents << file.rdbuf();
+		data = contents.str();
+	}
+
+	std::cout << "input bytes: " << data.size() << " threads: " << threads << " block size: " << blockSize << std::endl;
+	std::cout << std::setw( 10 ) << "mode" << std::setw( 7 ) << "level" << std::setw( 14 ) << "output bytes"
+			  << std::setw( 9 ) << "ratio" << std::setw( 10 ) << "seconds" << std::setw( 10 ) << "MB/s" << std::endl;
+
+	GzipBlockPool pool( threads );
+	for( int level = 1; level <= 9; ++level )
+	{
+		size_t compressedSize( 0 );
+		double seconds = Run( boost::iostreams::gzip_compressor( boost::iostreams::gzip_params( level ) ), data, compressedSize );
+		Report( "single", level, data, compressedSize, seconds );
+
+		seconds = Run( ParallelGzipCompressor( pool, level, blockSize ), data, compressedSize );
+		Report( "parallel", level, data, compressedSize, seconds );
+	}
+
+	return 0;
+}
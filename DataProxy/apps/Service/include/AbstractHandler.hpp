@@ -24,12 +24,13 @@ class DataProxyClient;
 class AbstractHandler : public boost::noncopyable, public IWebService
 {
 public:
-	AbstractHandler( DataProxyClient& i_rDataProxyClient, const std::string& i_rDplConfig, bool i_EnableXForwardedFor );
+	AbstractHandler( DataProxyClient& i_rDataProxyClient, bool i_EnableXForwardedFor );
 	virtual ~AbstractHandler();
 
+	// the node a request is for: its path, less any trailing slash
+	static std::string GetName( HTTPRequest& i_rRequest );
+
 protected:
-	bool CheckConfig( HTTPResponse& o_rResponse ) const;
-	std::string GetName( HTTPRequest& i_rRequest ) const;
 	void GetParams( HTTPRequest& i_rRequest, std::string& o_rName, std::map< std::string, std::string >& o_rParams ) const;
 	DataProxyClient& GetDataProxyClient(); 
 
@@ -37,7 +38,6 @@ protected:
 
 private:
 	DataProxyClient& m_rDataProxyClient;
-	std::string m_DplConfig;
 	bool m_EnableXForwardedFor;
 };
 
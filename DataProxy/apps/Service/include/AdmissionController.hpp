@@ -0,0 +1,73 @@
+// description: Limits how many requests may be in progress at once for a node, or for a group of nodes
+//    sharing a name prefix. Requests beyond the limit wait in a bounded queue for a free slot; when the queue
+//    is full, or a request has waited too long, it is turned away so it does not tie up a service thread.
+
+#ifndef _ADMISSION_CONTROLLER_
+#define _ADMISSION_CONTROLLER_
+
+#include "MVException.hpp"
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <map>
+#include <string>
+
+MV_MAKEEXCEPTIONCLASS( AdmissionControllerException, MVException );
+
+class AdmissionController : public boost::noncopyable
+{
+private:
+	struct Limit;
+
+public:
+	AdmissionController();
+	virtual ~AdmissionController();
+
+	// reads limits from a file of the form:
+	// <AdmissionControl>
+	//   <Limit node="name" maxConcurrent="4" maxQueued="16" queueTimeout="2.5" />
+	//   <Limit nodePrefix="db_" maxConcurrent="8" />
+	// </AdmissionControl>
+	void Parse( const std::string& i_rConfigFileSpec );
+
+	// a prefix limit is shared by all the nodes it matches; a node with a limit of its own is governed by that
+	// alone, otherwise by the longest matching prefix. a queue timeout of 0 waits as long as it takes.
+	// all limits must be added before the controller is used
+	void AddLimit( const std::string& i_rNode, bool i_IsPrefix, size_t i_MaxConcurrent, size_t i_MaxQueued, double i_QueueTimeout );
+
+	// holds a slot for a node (waiting for one if necessary) for as long as the ticket exists
+	class Ticket : public boost::noncopyable
+	{
+	public:
+		Ticket( AdmissionController& i_rController, const std::string& i_rNode );
+		virtual ~Ticket();
+
+		// false if the request was turned away
+		bool IsAdmitted() const;
+
+	private:
+		boost::shared_ptr< Limit > m_pLimit;
+		bool m_Admitted;
+	};
+
+private:
+	struct Limit
+	{
+		size_t m_MaxConcurrent;
+		size_t m_MaxQueued;
+		double m_QueueTimeout;
+
+		boost::mutex m_Mutex;
+		boost::condition_variable m_SlotReleased;
+		size_t m_Active;
+		size_t m_Queued;
+	};
+
+	boost::shared_ptr< Limit > FindLimit( const std::string& i_rNode ) const;
+
+	std::map< std::string, boost::shared_ptr< Limit > > m_NodeLimits;
+	std::map< std::string, boost::shared_ptr< Limit > > m_PrefixLimits;
+};
+
+#endif // _ADMISSION_CONTROLLER_
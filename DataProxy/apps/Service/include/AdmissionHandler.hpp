@@ -0,0 +1,27 @@
+// description: Wraps another handler, passing each request through only once the admission controller has
+//    found room for it; a request that is turned away gets 503 Service Unavailable.
+
+#ifndef _ADMISSION_HANDLER_
+#define _ADMISSION_HANDLER_
+
+#include "IWebService.hpp"
+#include <boost/noncopyable.hpp>
+
+class HTTPRequest;
+class HTTPResponse;
+class AdmissionController;
+
+class AdmissionHandler : public boost::noncopyable, public IWebService
+{
+public:
+	AdmissionHandler( IWebService& i_rHandler, AdmissionController& i_rAdmissionController );
+	virtual ~AdmissionHandler();
+
+	virtual void Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse );
+
+private:
+	IWebService& m_rHandler;
+	AdmissionController& m_rAdmissionController;
+};
+
+#endif // _ADMISSION_HANDLER_
@@ -0,0 +1,61 @@
+// description: Writes a response body as it is produced, using chunked transfer encoding, so the
+//    client starts receiving data before the load is complete. The status line & headers are sent with
+//    the first chunk. Once they are out, a failure can no longer be reported through the status code, so
+//    it is reported in a trailer field instead.
+//    HTTPResponse has no chunked mode, so the chunk framing is written through WriteData along with the data.
+//    That only works if the web server passes what it is given through as is (no Content-Length, no chunking
+//    of its own), which is why streaming is off unless the stream_loads option enables it.
+
+#ifndef _CHUNKED_RESPONSE_
+#define _CHUNKED_RESPONSE_
+
+#include <boost/noncopyable.hpp>
+#include <boost/iostreams/categories.hpp>
+#include <ios>
+#include <string>
+
+class HTTPResponse;
+
+class ChunkedResponse : public boost::noncopyable
+{
+public:
+	// writes each block it is given as a chunk, for use at the end of a boost::iostreams chain;
+	// the buffer size it is pushed with determines the chunk size
+	class Sink
+	{
+	public:
+		typedef char char_type;
+		typedef boost::iostreams::sink_tag category;
+
+		Sink( ChunkedResponse& o_rResponse );
+
+		std::streamsize write( const char* i_pData, std::streamsize i_Size );
+
+	private:
+		ChunkedResponse* m_pResponse;
+	};
+
+	// i_rEncoding is sent as the Content-Encoding, unless it is empty
+	ChunkedResponse( HTTPResponse& o_rResponse, const std::string& i_rEncoding );
+	virtual ~ChunkedResponse();
+
+	// whether the status & headers have been sent
+	bool HasStarted() const;
+
+	void WriteChunk( const char* i_pData, std::streamsize i_Size );
+
+	// ends a successful response
+	void Finish();
+
+	// ends a response that failed after it was started, reporting the message in a trailer
+	void Fail( const std::string& i_rMessage );
+
+private:
+	void Start();
+
+	HTTPResponse& m_rResponse;
+	std::string m_Encoding;
+	bool m_Started;
+};
+
+#endif // _CHUNKED_RESPONSE_
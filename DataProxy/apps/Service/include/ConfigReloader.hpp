@@ -0,0 +1,66 @@
+// description: Keeps the service's DataProxyClient up to date with its config file, off the request path.
+//    A background thread re-initializes the client when the process receives SIGHUP and, if enabled, each
+//    time it checks the config (and its entities) for changes. DataProxyClient only publishes a configuration
+//    once it has been built in full, so a config that fails to load leaves the previous one serving requests;
+//    the failure is logged, and retried on every check & SIGHUP, so a fix to the config or any of its entities
+//    is picked up. A failure that repeats is only logged again once a minute, unless a SIGHUP asked for it.
+//    Cached load responses were loaded through the previous configuration, so a new one clears them.
+
+#ifndef _CONFIG_RELOADER_
+#define _CONFIG_RELOADER_
+
+#include "MVException.hpp"
+#include "Stopwatch.hpp"
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/atomic.hpp>
+#include <boost/thread/thread.hpp>
+#include <string>
+
+MV_MAKEEXCEPTIONCLASS( ConfigReloaderException, MVException );
+
+class DataProxyClient;
+class ResponseCache;
+
+class ConfigReloader : public boost::noncopyable
+{
+public:
+	// i_CheckSeconds: how often to check the config for changes (0: only reload on SIGHUP)
+	// i_UseFileNotification: check for changes with inotify instead of stat'ing every file
+	// i_pResponseCache: the load responses to clear when a new configuration is published (NULL if there are none)
+	ConfigReloader( DataProxyClient& i_rDataProxyClient, const std::string& i_rDplConfig, double i_CheckSeconds, bool i_UseFileNotification,
+					ResponseCache* i_pResponseCache );
+	virtual ~ConfigReloader();
+
+	// SIGHUP must be blocked on every thread so that only the reloader receives it (rather than it
+	// terminating the process). call from main before any other threads have been started
+	static void BlockReloadSignal();
+
+	// initializes the client from the config on the calling thread. returns false if it failed,
+	// in which case the client keeps whatever configuration it had
+	bool Reload();
+
+	// starts & stops the background thread; Stop is called on destruction
+	void Start();
+	void Stop();
+
+	// sends SIGHUP to the background thread, which reloads as it would for a SIGHUP sent to the process
+	void Signal();
+
+private:
+	bool Reload( bool i_LogRepeatedError );
+	void Run();
+	void Check();
+
+	DataProxyClient& m_rDataProxyClient;
+	std::string m_DplConfig;
+	double m_CheckSeconds;
+	ResponseCache* m_pResponseCache;
+	bool m_Failed;
+	std::string m_LastError;
+	Stopwatch m_LastErrorTimer;
+	boost::atomic< bool > m_Stopping;
+	boost::scoped_ptr< boost::thread > m_pThread;
+};
+
+#endif // _CONFIG_RELOADER_
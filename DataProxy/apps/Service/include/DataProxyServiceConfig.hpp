@@ -28,11 +28,27 @@ public:
 	virtual const std::string& GetInstanceId() const;
 	virtual const std::string& GetLogConfig() const;
 	virtual const std::string& GetDplConfig() const;
+	virtual double GetDplConfigRecheckSeconds() const;
+	virtual bool GetDplConfigNotify() const;
 	virtual uint GetPort() const;
 	virtual uint GetNumThreads() const;
 	virtual uint GetMaxRequestSize() const;
 	virtual int GetZLibCompressionLevel() const;
+	virtual int GetZstdCompressionLevel() const;
+	virtual int GetLz4CompressionLevel() const;
+	virtual size_t GetMaxDecodedBodySize() const;
 	virtual bool GetEnableXForwardedFor() const;
+	virtual bool GetStreamLoads() const;
+	virtual uint GetStreamChunkSize() const;
+	virtual uint GetParallelGZipThreads() const;
+	virtual uint GetParallelGZipBlockSize() const;
+	virtual bool GetEnableETags() const;
+	virtual double GetResponseCacheSeconds() const;
+	virtual size_t GetResponseCacheBytes() const;
+	virtual const std::string& GetAdmissionConfig() const;
+	virtual const std::string& GetMetricsPath() const;
+	virtual uint GetMetricsMaxNodes() const;
+	virtual double GetTraceSampleRate() const;
 
 	virtual const std::string& GetLoadWhitelistFile() const;
 	virtual const std::string& GetStoreWhitelistFile() const;
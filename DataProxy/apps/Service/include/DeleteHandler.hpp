@@ -19,14 +19,19 @@
 class HTTPRequest;
 class HTTPResponse;
 class DataProxyClient;
+class ResponseCache;
 
 class DeleteHandler : public AbstractHandler
 {
 public:
-	DeleteHandler( DataProxyClient& i_rDataProxyClient, const std::string& i_rDplConfig, bool i_EnableXForwardedFor );
+	// i_pResponseCache: the load responses to invalidate for each node deleted from (NULL if there are none)
+	DeleteHandler( DataProxyClient& i_rDataProxyClient, bool i_EnableXForwardedFor, ResponseCache* i_pResponseCache );
 	virtual ~DeleteHandler();
 
 	virtual void Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse );
+
+private:
+	ResponseCache* m_pResponseCache;
 };
 
 #endif // _DELETE_HANDLER_
@@ -14,25 +14,51 @@
 
 
 #include "AbstractHandler.hpp"
+#include "ResponseCache.hpp"
 #include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <string>
 #include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
 
 class HTTPRequest;
 class HTTPResponse;
 class DataProxyClient;
+class GzipBlockPool;
 
 class LoadHandler : public AbstractHandler
 {
 public:
-	LoadHandler( DataProxyClient& i_rDataProxyClient, const std::string& i_rDplConfig, int i_ZLibCompressionLevel, bool i_EnableXForwardedFor );
+	// a compression level of 0 disables that encoding. i_pResponseCache may be NULL, to not cache responses
+	LoadHandler( DataProxyClient& i_rDataProxyClient, int i_ZLibCompressionLevel, int i_ZstdCompressionLevel,
+				 int i_Lz4CompressionLevel, bool i_EnableXForwardedFor, bool i_StreamResponses, size_t i_ChunkSize, size_t i_ParallelGZipThreads,
+				 size_t i_ParallelGZipBlockSize, bool i_EnableETags, ResponseCache* i_pResponseCache );
 	virtual ~LoadHandler();
 
 	virtual void Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse );
 
 private:
+	// picks the encoding to respond with, or returns empty if the response should not be compressed
+	std::string NegotiateEncoding( const std::string& i_rAcceptEncoding ) const;
+	void PushCompressor( const std::string& i_rEncoding, const std::string& i_rAcceptEncoding, boost::iostreams::filtering_ostream& o_rFilter );
+
+	// writes the result to the client as it is loaded, using chunked transfer encoding
+	void HandleStreaming( const std::string& i_rName, const std::map< std::string, std::string >& i_rParameters, HTTPResponse& o_rResponse,
+						  const std::string& i_rEncoding, boost::iostreams::filtering_ostream& i_rFilter );
+
+	// writes a fully loaded result, or just 304 Not Modified if the client already has it
+	void WriteResponse( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse, const std::string& i_rEncoding, const ResponseCache::Response& i_rResponse );
+
 	boost::iostreams::gzip_params m_GZipParams;
 	bool m_CompressionEnabled;
+	boost::scoped_ptr< GzipBlockPool > m_pGZipPool;	// only if gzip compression is done in parallel
+	size_t m_GZipBlockSize;
+	int m_ZstdCompressionLevel;
+	int m_Lz4CompressionLevel;
+	bool m_StreamResponses;
+	size_t m_ChunkSize;
+	bool m_EnableETags;
+	ResponseCache* m_pCache;	// NULL if responses are not cached
 };
 
 #endif // _LOAD_HANDLER_
@@ -0,0 +1,71 @@
+// description: boost::iostreams filters for the lz4 frame format, in the same form as the library's own
+//    gzip & zstd filters. The compressor writes a single frame with a checksum of its content; the
+//    decompressor reads a single frame, verifying the checksum if there is one.
+
+#ifndef _LZ4_FILTER_
+#define _LZ4_FILTER_
+
+#include "MVException.hpp"
+#include <boost/iostreams/constants.hpp>
+#include <boost/iostreams/filter/symmetric.hpp>
+#include <boost/noncopyable.hpp>
+#include <string>
+
+struct LZ4F_cctx_s;
+struct LZ4F_dctx_s;
+
+MV_MAKEEXCEPTIONCLASS( Lz4Exception, MVException );
+
+class Lz4CompressorImpl : public boost::noncopyable
+{
+public:
+	typedef char char_type;
+
+	// i_Level follows lz4: 1-2 use the fast mode, 3-12 the high compression mode
+	Lz4CompressorImpl( int i_Level );
+	virtual ~Lz4CompressorImpl();
+
+	bool filter( const char*& io_rpSourceBegin, const char* i_pSourceEnd, char*& io_rpDestBegin, char* i_pDestEnd, bool i_Flush );
+	void close();
+
+private:
+	// compressed data that did not fit in the destination yet
+	void Drain( char*& io_rpDestBegin, char* i_pDestEnd );
+
+	LZ4F_cctx_s* m_pContext;
+	int m_Level;
+	bool m_Begun;
+	bool m_Ended;
+	std::string m_Pending;
+	size_t m_PendingOffset;
+};
+
+class Lz4DecompressorImpl : public boost::noncopyable
+{
+public:
+	typedef char char_type;
+
+	Lz4DecompressorImpl();
+	virtual ~Lz4DecompressorImpl();
+
+	bool filter( const char*& io_rpSourceBegin, const char* i_pSourceEnd, char*& io_rpDestBegin, char* i_pDestEnd, bool i_Flush );
+	void close();
+
+private:
+	LZ4F_dctx_s* m_pContext;
+	bool m_Done;
+};
+
+class Lz4Compressor : public boost::iostreams::symmetric_filter< Lz4CompressorImpl >
+{
+public:
+	Lz4Compressor( int i_Level, std::streamsize i_BufferSize = boost::iostreams::default_device_buffer_size );
+};
+
+class Lz4Decompressor : public boost::iostreams::symmetric_filter< Lz4DecompressorImpl >
+{
+public:
+	Lz4Decompressor( std::streamsize i_BufferSize = boost::iostreams::default_device_buffer_size );
+};
+
+#endif // _LZ4_FILTER_
@@ -0,0 +1,29 @@
+// description: Wraps another handler, recording the latency, status & response size of each request it
+//    passes through in the service metrics, under the requested node & the given operation.
+
+#ifndef _METERING_HANDLER_
+#define _METERING_HANDLER_
+
+#include "IWebService.hpp"
+#include <boost/noncopyable.hpp>
+#include <string>
+
+class HTTPRequest;
+class HTTPResponse;
+class ServiceMetrics;
+
+class MeteringHandler : public boost::noncopyable, public IWebService
+{
+public:
+	MeteringHandler( IWebService& i_rHandler, ServiceMetrics& i_rMetrics, const std::string& i_rOperation );
+	virtual ~MeteringHandler();
+
+	virtual void Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse );
+
+private:
+	IWebService& m_rHandler;
+	ServiceMetrics& m_rMetrics;
+	std::string m_Operation;
+};
+
+#endif // _METERING_HANDLER_
@@ -0,0 +1,29 @@
+// description: Answers GET requests for the metrics path with the service metrics in plain text, passing
+//    all other requests on to the handler for loads.
+
+#ifndef _METRICS_HANDLER_
+#define _METRICS_HANDLER_
+
+#include "IWebService.hpp"
+#include <boost/noncopyable.hpp>
+#include <string>
+
+class HTTPRequest;
+class HTTPResponse;
+class ServiceMetrics;
+
+class MetricsHandler : public boost::noncopyable, public IWebService
+{
+public:
+	MetricsHandler( ServiceMetrics& i_rMetrics, const std::string& i_rPath, IWebService& i_rLoadHandler );
+	virtual ~MetricsHandler();
+
+	virtual void Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse );
+
+private:
+	ServiceMetrics& m_rMetrics;
+	std::string m_Path;
+	IWebService& m_rLoadHandler;
+};
+
+#endif // _METRICS_HANDLER_
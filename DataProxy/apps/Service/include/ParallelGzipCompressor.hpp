@@ -0,0 +1,134 @@
+// description: Compresses a stream in gzip format using several threads. The input is cut into fixed-size
+//    blocks which are deflated independently on a shared pool of threads, then written out in order as a
+//    single gzip member. Each block but the last ends on a byte boundary (a sync flush), so the blocks can
+//    simply be concatenated; the crc of the whole stream is combined from the crcs of the blocks. The
+//    price is a slightly larger result, since no block can refer back into the one before it.
+
+#ifndef _PARALLEL_GZIP_COMPRESSOR_
+#define _PARALLEL_GZIP_COMPRESSOR_
+
+#include "MVException.hpp"
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/iostreams/categories.hpp>
+#include <boost/iostreams/write.hpp>
+#include <deque>
+#include <ios>
+#include <string>
+
+MV_MAKEEXCEPTIONCLASS( ParallelGzipException, MVException );
+
+// the threads that deflate blocks; one pool is shared by any number of compressors
+class GzipBlockPool : public boost::noncopyable
+{
+public:
+	struct Block
+	{
+		std::string m_Input;	// released once the block is deflated
+		size_t m_InputSize;
+		unsigned long m_Crc;
+		std::string m_Output;
+		std::string m_Error;
+		int m_Level;
+		bool m_Final;
+		bool m_Complete;
+	};
+
+	GzipBlockPool( size_t i_NumThreads );
+	virtual ~GzipBlockPool();
+
+	size_t GetNumThreads() const;
+
+	void Submit( boost::shared_ptr< Block > i_pBlock );
+	bool IsComplete( const Block& i_rBlock );
+	void Wait( const Block& i_rBlock );
+
+private:
+	void Run();
+	static void Deflate( Block& io_rBlock );
+
+	boost::mutex m_Mutex;
+	boost::condition_variable m_BlockSubmitted;
+	boost::condition_variable m_BlockCompleted;
+	std::deque< boost::shared_ptr< Block > > m_Queue;
+	bool m_Stopping;
+	boost::thread_group m_Threads;
+};
+
+class ParallelGzipCompressor
+{
+public:
+	typedef char char_type;
+	struct category : public boost::iostreams::output_filter_tag, public boost::iostreams::multichar_tag, public boost::iostreams::closable_tag {};
+
+	// i_Level follows zlib: -1 for the zlib default, otherwise 1-9
+	ParallelGzipCompressor( GzipBlockPool& i_rPool, int i_Level, size_t i_BlockSize );
+
+	template< typename Sink >
+	std::streamsize write( Sink& o_rSink, const char* i_pData, std::streamsize i_Size )
+	{
+		m_pState->Write( i_pData, i_Size );
+		WriteOutput( o_rSink );
+		return i_Size;
+	}
+
+	template< typename Sink >
+	void close( Sink& o_rSink )
+	{
+		m_pState->Finish();
+		WriteOutput( o_rSink );
+	}
+
+private:
+	// filters are copied when they are pushed onto a chain, so all the state lives here
+	class State : public boost::noncopyable
+	{
+	public:
+		State( GzipBlockPool& i_rPool, int i_Level, size_t i_BlockSize );
+
+		void Write( const char* i_pData, std::streamsize i_Size );
+		void Finish();
+
+		// compressed data that is ready to be written
+		std::string m_Output;
+
+	private:
+		void Submit( bool i_Final );
+		void Collect( bool i_All );
+		void Reset();
+
+		GzipBlockPool& m_rPool;
+		int m_Level;
+		size_t m_BlockSize;
+		size_t m_MaxPending;
+		std::string m_Input;
+		std::deque< boost::shared_ptr< GzipBlockPool::Block > > m_Pending;
+		bool m_HeaderWritten;
+		unsigned long m_Crc;
+		unsigned long m_Size;
+	};
+
+	template< typename Sink >
+	void WriteOutput( Sink& o_rSink )
+	{
+		std::string& rOutput = m_pState->m_Output;
+		std::streamsize offset( 0 );
+		while( offset < std::streamsize( rOutput.size() ) )
+		{
+			std::streamsize written = boost::iostreams::write( o_rSink, rOutput.data() + offset, rOutput.size() - offset );
+			if( written <= 0 )
+			{
+				MV_THROW( ParallelGzipException, "Unable to write compressed data" );
+			}
+			offset += written;
+		}
+		rOutput.clear();
+	}
+
+	boost::shared_ptr< State > m_pState;
+};
+
+#endif // _PARALLEL_GZIP_COMPRESSOR_
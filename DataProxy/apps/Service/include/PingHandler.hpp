@@ -26,7 +26,7 @@ MV_MAKEEXCEPTIONCLASS( PingHandlerException, MVException );
 class PingHandler : public AbstractHandler
 {
 public:
-	PingHandler( DataProxyClient& i_rDataProxyClient, const std::string& i_rDplConfig );
+	PingHandler( DataProxyClient& i_rDataProxyClient );
 	virtual ~PingHandler();
 
 	virtual void Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse );
@@ -0,0 +1,80 @@
+// description: Holds recent load responses, exactly as they were sent (i.e. already encoded), keyed by node,
+//    parameters & encoding, so a repeated request can be answered without loading again. Entries expire a
+//    fixed time after they were stored. Memory is bounded by a byte budget; when it is exceeded the least
+//    recently used entries are dropped. A write to a node drops that node's entries, and a new configuration
+//    drops them all; entries of other nodes that read the same data only go stale until they expire.
+
+#ifndef _RESPONSE_CACHE_
+#define _RESPONSE_CACHE_
+
+#include "detail/LruCache.hpp"
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <map>
+#include <string>
+
+class ResponseCache : public boost::noncopyable
+{
+public:
+	struct Response
+	{
+		std::string m_Data;
+		std::string m_ETag;		// empty if etags are not enabled
+	};
+
+	ResponseCache( double i_TimeToLiveSeconds, size_t i_MaxBytes );
+	virtual ~ResponseCache();
+
+	// returns the fresh response stored under the key, or NULL if there is none
+	boost::shared_ptr< const Response > Get( const std::string& i_rKey );
+
+	// stores a response, replacing any under the same key; a response that could never fit is not stored
+	void Put( const std::string& i_rKey, boost::shared_ptr< const Response > i_pResponse );
+
+	// as above, unless entries have been dropped since i_Generation (the GetGeneration() from before the response
+	// was loaded), in which case it may be stale and is not stored
+	void Put( const std::string& i_rKey, boost::shared_ptr< const Response > i_pResponse, size_t i_Generation );
+
+	// drops the entries for a node, e.g. because it has been written to
+	void Invalidate( const std::string& i_rName );
+
+	// drops every entry, e.g. because the nodes have been reconfigured
+	void Clear();
+
+	// changes each time entries are invalidated or cleared
+	size_t GetGeneration() const;
+
+	size_t GetBytes() const;
+
+	// an unambiguous key for a request
+	static std::string MakeKey( const std::string& i_rName, const std::map< std::string, std::string >& i_rParameters, const std::string& i_rEncoding );
+
+	// invalidates a node's entries once a write to it is done, however it ended: even a failed write may have
+	// changed the data. does nothing without a cache
+	class ScopedInvalidation : public boost::noncopyable
+	{
+	public:
+		ScopedInvalidation( ResponseCache* i_pCache, const std::string& i_rName );
+		~ScopedInvalidation();
+
+	private:
+		ResponseCache* m_pCache;
+		std::string m_Name;
+	};
+
+private:
+	typedef LruCache< boost::shared_ptr< const Response > > EntryCache;
+
+	static size_t GetSize( const std::string& i_rKey, const Response& i_rResponse );
+	static std::string MakeKeyPrefix( const std::string& i_rName );
+
+	double m_TimeToLive;
+	size_t m_MaxBytes;
+
+	mutable boost::mutex m_Mutex;
+	EntryCache m_Entries;
+	size_t m_Generation;
+};
+
+#endif // _RESPONSE_CACHE_
@@ -0,0 +1,108 @@
+// description: Per-node, per-operation request metrics: latency histograms, in-flight counts, request,
+//    error & byte counters. Recording is lock-free; the only lock is a shared one taken to find a node's
+//    metrics, held exclusively just the first time a node is seen. Written out in a plain-text format
+//    (one "name{labels} value" per line) that metric scrapers understand.
+
+#ifndef _SERVICE_METRICS_
+#define _SERVICE_METRICS_
+
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/cstdint.hpp>
+#include <map>
+#include <ostream>
+#include <string>
+
+// latencies in microseconds, in buckets of a quarter power of two: quantiles read from it are within ~20%
+class LatencyHistogram : public boost::noncopyable
+{
+public:
+	LatencyHistogram();
+
+	void Record( boost::uint64_t i_Micros );
+
+	boost::uint64_t GetCount() const;
+	boost::uint64_t GetSum() const;
+	boost::uint64_t GetMax() const;
+
+	// the latency below which the given fraction of requests fall (at the top of its bucket, at most the max)
+	boost::uint64_t GetQuantile( double i_Quantile ) const;
+
+	static size_t GetBucket( boost::uint64_t i_Micros );
+	static boost::uint64_t GetBucketLimit( size_t i_Bucket );
+
+private:
+	enum { NUM_BUCKETS = 4 * 63 };
+
+	boost::atomic< boost::uint64_t > m_Buckets[ NUM_BUCKETS ];
+	boost::atomic< boost::uint64_t > m_Count;
+	boost::atomic< boost::uint64_t > m_Sum;
+	boost::atomic< boost::uint64_t > m_Max;
+};
+
+class ServiceMetrics : public boost::noncopyable
+{
+private:
+	struct Metrics;
+
+public:
+	// requests to nodes beyond the first i_MaxNodes are counted together under OTHER_NODES, so that a
+	// stream of requests for nonexistent nodes cannot grow the metrics without bound. the name is reserved:
+	// requests to a node called OTHER_NODES are counted there too, and don't take up one of the i_MaxNodes
+	ServiceMetrics( size_t i_MaxNodes );
+	virtual ~ServiceMetrics();
+
+	static const std::string OTHER_NODES;
+
+	// tracks one request from construction to destruction; it counts as an error unless it is given a
+	// status below 400
+	class Request : public boost::noncopyable
+	{
+	public:
+		Request( ServiceMetrics& i_rMetrics, const std::string& i_rNode, const std::string& i_rOperation );
+		virtual ~Request();
+
+		void SetStatus( int i_Status );
+		void AddBytes( size_t i_Bytes );
+
+	private:
+		boost::shared_ptr< Metrics > m_pMetrics;
+		double m_Start;
+		int m_Status;
+		size_t m_Bytes;
+	};
+
+	void Write( std::ostream& o_rOutput ) const;
+
+private:
+	struct Metrics
+	{
+		LatencyHistogram m_Latency;
+		boost::atomic< boost::uint64_t > m_InFlight;
+		boost::atomic< boost::uint64_t > m_Requests;
+		boost::atomic< boost::uint64_t > m_Errors;
+		boost::atomic< boost::uint64_t > m_Bytes;
+	};
+
+	// keyed by node, then operation
+	typedef std::map< std::pair< std::string, std::string >, boost::shared_ptr< Metrics > > MetricsMap;
+	// keyed by operation
+	typedef std::map< std::string, boost::shared_ptr< Metrics > > OperationMetricsMap;
+
+	boost::shared_ptr< Metrics > GetMetrics( const std::string& i_rNode, const std::string& i_rOperation );
+
+	// whether a request's metrics are kept under OTHER_NODES rather than its node's own. m_Mutex must be held
+	bool IsOtherNode( const std::string& i_rNode ) const;
+
+	size_t m_MaxNodes;
+	double m_Start;
+
+	mutable boost::shared_mutex m_Mutex;
+	MetricsMap m_Metrics;
+	OperationMetricsMap m_OtherNodeMetrics;
+	std::map< std::string, size_t > m_Nodes;	// # of operations seen for each node (other than OTHER_NODES)
+};
+
+#endif // _SERVICE_METRICS_
@@ -13,22 +13,33 @@
 #define _STORE_HANDLER_
 
 #include "AbstractHandler.hpp"
+#include "MVException.hpp"
 #include <boost/noncopyable.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
 #include <string>
 
 class HTTPRequest;
 class HTTPResponse;
 class DataProxyClient;
+class ResponseCache;
+
+MV_MAKEEXCEPTIONCLASS( StoreHandlerException, MVException );
 
 class StoreHandler : public AbstractHandler 
 {
 public:
-	StoreHandler( DataProxyClient& i_rDataProxyClient, const std::string& i_rDplConfig, bool i_EnableXForwardedFor );
+	// i_pResponseCache: the load responses to invalidate for each node written to (NULL if there are none)
+	StoreHandler( DataProxyClient& i_rDataProxyClient, bool i_EnableXForwardedFor, size_t i_MaxDecodedBodySize, ResponseCache* i_pResponseCache );
 	virtual ~StoreHandler();
 
 	virtual void Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse );
 
 private:
+	// pushes the filter that decodes a request body sent with the given Content-Encoding
+	void PushDecompressor( const std::string& i_rEncoding, boost::iostreams::filtering_istream& o_rFilter ) const;
+
+	size_t m_MaxDecodedBodySize;
+	ResponseCache* m_pResponseCache;
 };
 
 #endif // _STORE_HANDLER_
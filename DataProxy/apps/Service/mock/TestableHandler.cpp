@@ -17,8 +17,8 @@
 #include "HTTPResponse.hpp"
 #include "DataProxyService.hpp"
 
-TestableHandler::TestableHandler( DataProxyClient& i_rDataProxyClient, const std::string& i_rDplConfig, bool i_EnableXForwardedFor )
-:	AbstractHandler( i_rDataProxyClient, i_rDplConfig, i_EnableXForwardedFor )
+TestableHandler::TestableHandler( DataProxyClient& i_rDataProxyClient, bool i_EnableXForwardedFor )
+:	AbstractHandler( i_rDataProxyClient, i_EnableXForwardedFor )
 {
 }
 
@@ -26,11 +26,6 @@ TestableHandler::~TestableHandler()
 {
 }
 
-bool TestableHandler::CallCheckConfig( HTTPResponse& o_rResponse )
-{
-	return AbstractHandler::CheckConfig( o_rResponse );
-}
-
 void TestableHandler::CallGetParams( HTTPRequest& i_rRequest, std::string& o_rName, std::map< std::string, std::string >& o_rParams )
 {
 	AbstractHandler::GetParams( i_rRequest, o_rName, o_rParams );
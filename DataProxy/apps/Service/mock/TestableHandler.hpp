@@ -24,10 +24,9 @@ class DataProxyClient;
 class TestableHandler : public AbstractHandler
 {
 public:
-	TestableHandler( DataProxyClient& i_rDataProxyClient, const std::string& i_rDplConfig, bool i_EnableXForwardedFor );
+	TestableHandler( DataProxyClient& i_rDataProxyClient, bool i_EnableXForwardedFor );
 	virtual ~TestableHandler();
 
-	bool CallCheckConfig( HTTPResponse& o_rResponse );
 	void CallGetParams( HTTPRequest& i_rRequest, std::string& o_rName, std::map< std::string, std::string >& o_rParams );
 	virtual void Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse );
 };
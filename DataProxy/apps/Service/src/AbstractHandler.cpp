@@ -17,9 +17,8 @@
 #include "HTTPResponse.hpp"
 #include "DataProxyService.hpp"
 
-AbstractHandler::AbstractHandler( DataProxyClient& i_rDataProxyClient, const std::string& i_rDplConfig, bool i_EnableXForwardedFor )
+AbstractHandler::AbstractHandler( DataProxyClient& i_rDataProxyClient, bool i_EnableXForwardedFor )
 :	m_rDataProxyClient( i_rDataProxyClient ),
-	m_DplConfig( i_rDplConfig ),
 	m_EnableXForwardedFor( i_EnableXForwardedFor )
 {
 }
@@ -33,30 +32,11 @@ DataProxyClient& AbstractHandler::GetDataProxyClient()
 	return m_rDataProxyClient;
 }
 
-bool AbstractHandler::CheckConfig( HTTPResponse& o_rResponse ) const
-{
-	try
-	{
-		m_rDataProxyClient.Initialize( m_DplConfig );
-		return true;
-	}
-	catch( const std::exception& i_rEx )
-	{
-		std::stringstream msg;
-		msg << "Error initializing DPL with file: " << m_DplConfig << ": " << i_rEx.what();
-		MVLOGGER( "root.lib.DataProxy.Service.AbstractHandler.CheckConfig.ErrorInitializing", msg.str() );
-		o_rResponse.SetHTTPStatusCode( HTTP_STATUS_INTERNAL_SERVER_ERROR );
-		o_rResponse.WriteHeader( SERVER, DATA_PROXY_SERVICE_VERSION );
-		o_rResponse.WriteData( msg.str() + "\n" );
-		return false;
-	}
-}
-
-std::string AbstractHandler::GetName( HTTPRequest& i_rRequest ) const
+std::string AbstractHandler::GetName( HTTPRequest& i_rRequest )
 {
 	// strip the trailing slash
 	std::string result = i_rRequest.GetPath();
-	if( result[ result.size() - 1 ] == '/' )
+	if( !result.empty() && result[ result.size() - 1 ] == '/' )
 	{
 		result = result.substr( 0, result.size() - 1 );
 	}
@@ -0,0 +1,226 @@
+#include "AdmissionController.hpp"
+#include "XMLUtilities.hpp"
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread_time.hpp>
+#include <xercesc/dom/DOM.hpp>
+#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/sax/HandlerBase.hpp>
+#include <set>
+#include <vector>
+
+namespace
+{
+	const std::string LIMIT_NODE( "Limit" );
+	const std::string NODE_ATTRIBUTE( "node" );
+	const std::string NODE_PREFIX_ATTRIBUTE( "nodePrefix" );
+	const std::string MAX_CONCURRENT_ATTRIBUTE( "maxConcurrent" );
+	const std::string MAX_QUEUED_ATTRIBUTE( "maxQueued" );
+	const std::string QUEUE_TIMEOUT_ATTRIBUTE( "queueTimeout" );
+
+	template< typename T_Data >
+	T_Data GetValue( xercesc::DOMNode* i_pNode, const std::string& i_rName, T_Data i_Default, const std::string& i_rType )
+	{
+		xercesc::DOMAttr* pAttribute = XMLUtilities::GetAttribute( i_pNode, i_rName );
+		if( pAttribute == NULL )
+		{
+			return i_Default;
+		}
+		std::string value = XMLUtilities::XMLChToString( pAttribute->getValue() );
+		try
+		{
+			return boost::lexical_cast< T_Data >( value );
+		}
+		catch( const boost::bad_lexical_cast& )
+		{
+			MV_THROW( AdmissionControllerException, "Error parsing " << i_rName << " attribute: " << value << " as " << i_rType );
+		}
+	}
+
+	// lexical_cast would happily wrap a negative number around to a huge one
+	size_t GetCount( xercesc::DOMNode* i_pNode, const std::string& i_rName )
+	{
+		int result = GetValue< int >( i_pNode, i_rName, 0, "int" );
+		if( result < 0 )
+		{
+			MV_THROW( AdmissionControllerException, "Illegal value provided: " << result << " for attribute: " << i_rName << "; must be non-negative" );
+		}
+		return size_t( result );
+	}
+}
+
+AdmissionController::AdmissionController()
+:	m_NodeLimits(),
+	m_PrefixLimits()
+{
+}
+
+AdmissionController::~AdmissionController()
+{
+}
+
+void AdmissionController::Parse( const std::string& i_rConfigFileSpec )
+{
+	xercesc::XercesDOMParser parser;
+	xercesc::HandlerBase errorHandler;
+	try
+	{
+		parser.setErrorHandler( &errorHandler );
+		parser.parse( i_rConfigFileSpec.c_str() );
+		xercesc::DOMElement* pConfig = parser.getDocument()->getDocumentElement();
+
+		std::set< std::string > allowedChildren;
+		allowedChildren.insert( LIMIT_NODE );
+		XMLUtilities::ValidateNode( pConfig, allowedChildren );
+		XMLUtilities::ValidateAttributes( pConfig, std::set< std::string >() );
+
+		std::set< std::string > allowedAttributes;
+		allowedAttributes.insert( NODE_ATTRIBUTE );
+		allowedAttributes.insert( NODE_PREFIX_ATTRIBUTE );
+		allowedAttributes.insert( MAX_CONCURRENT_ATTRIBUTE );
+		allowedAttributes.insert( MAX_QUEUED_ATTRIBUTE );
+		allowedAttributes.insert( QUEUE_TIMEOUT_ATTRIBUTE );
+
+		std::vector< xercesc::DOMNode* > limitNodes;
+		XMLUtilities::GetChildrenByName( limitNodes, pConfig, LIMIT_NODE );
+		std::vector< xercesc::DOMNode* >::const_iterator iter = limitNodes.begin();
+		for( ; iter != limitNodes.end(); ++iter )
+		{
+			XMLUtilities::ValidateNode( *iter, std::set< std::string >() );
+			XMLUtilities::ValidateAttributes( *iter, allowedAttributes );
+
+			xercesc::DOMAttr* pNode = XMLUtilities::GetAttribute( *iter, NODE_ATTRIBUTE );
+			xercesc::DOMAttr* pNodePrefix = XMLUtilities::GetAttribute( *iter, NODE_PREFIX_ATTRIBUTE );
+			if( ( pNode == NULL ) == ( pNodePrefix == NULL ) )
+			{
+				MV_THROW( AdmissionControllerException, LIMIT_NODE << " must have exactly one of the attributes: " << NODE_ATTRIBUTE << ", " << NODE_PREFIX_ATTRIBUTE );
+			}
+			if( XMLUtilities::GetAttribute( *iter, MAX_CONCURRENT_ATTRIBUTE ) == NULL )
+			{
+				MV_THROW( AdmissionControllerException, LIMIT_NODE << " is missing the attribute: " << MAX_CONCURRENT_ATTRIBUTE );
+			}
+
+			AddLimit( XMLUtilities::XMLChToString( ( pNode != NULL ? pNode : pNodePrefix )->getValue() ),
+					  pNodePrefix != NULL,
+					  GetCount( *iter, MAX_CONCURRENT_ATTRIBUTE ),
+					  GetCount( *iter, MAX_QUEUED_ATTRIBUTE ),
+					  GetValue< double >( *iter, QUEUE_TIMEOUT_ATTRIBUTE, 0, "double" ) );
+		}
+	}
+	catch( const xercesc::SAXParseException& ex )
+	{
+		MV_THROW( AdmissionControllerException, "Error parsing file: " << i_rConfigFileSpec << ": " << XMLUtilities::XMLChToString( ex.getMessage() ) );
+	}
+	catch( const xercesc::XMLException& ex )
+	{
+		MV_THROW( AdmissionControllerException, "Error parsing file: " << i_rConfigFileSpec << ": " << XMLUtilities::XMLChToString( ex.getMessage() ) );
+	}
+}
+
+void AdmissionController::AddLimit( const std::string& i_rNode, bool i_IsPrefix, size_t i_MaxConcurrent, size_t i_MaxQueued, double i_QueueTimeout )
+{
+	if( i_MaxConcurrent == 0 )
+	{
+		MV_THROW( AdmissionControllerException, "Limit for: " << i_rNode << ": " << MAX_CONCURRENT_ATTRIBUTE << " must be positive" );
+	}
+	if( i_QueueTimeout < 0 )
+	{
+		MV_THROW( AdmissionControllerException, "Limit for: " << i_rNode << ": " << QUEUE_TIMEOUT_ATTRIBUTE << " must be non-negative" );
+	}
+
+	boost::shared_ptr< Limit > pLimit( new Limit() );
+	pLimit->m_MaxConcurrent = i_MaxConcurrent;
+	pLimit->m_MaxQueued = i_MaxQueued;
+	pLimit->m_QueueTimeout = i_QueueTimeout;
+	pLimit->m_Active = 0;
+	pLimit->m_Queued = 0;
+
+	std::map< std::string, boost::shared_ptr< Limit > >& rLimits = ( i_IsPrefix ? m_PrefixLimits : m_NodeLimits );
+	if( !rLimits.insert( std::make_pair( i_rNode, pLimit ) ).second )
+	{
+		MV_THROW( AdmissionControllerException, "Duplicate limit for " << ( i_IsPrefix ? "node prefix" : "node" ) << ": " << i_rNode );
+	}
+}
+
+boost::shared_ptr< AdmissionController::Limit > AdmissionController::FindLimit( const std::string& i_rNode ) const
+{
+	std::map< std::string, boost::shared_ptr< Limit > >::const_iterator iter = m_NodeLimits.find( i_rNode );
+	if( iter != m_NodeLimits.end() )
+	{
+		return iter->second;
+	}
+
+	boost::shared_ptr< Limit > pResult;
+	size_t longest( 0 );
+	for( iter = m_PrefixLimits.begin(); iter != m_PrefixLimits.end(); ++iter )
+	{
+		if( i_rNode.compare( 0, iter->first.size(), iter->first ) == 0 && ( !pResult || iter->first.size() > longest ) )
+		{
+			pResult = iter->second;
+			longest = iter->first.size();
+		}
+	}
+	return pResult;
+}
+
+AdmissionController::Ticket::Ticket( AdmissionController& i_rController, const std::string& i_rNode )
+:	m_pLimit( i_rController.FindLimit( i_rNode ) ),
+	m_Admitted( true )
+{
+	if( !m_pLimit )
+	{
+		return;
+	}
+
+	Limit& rLimit = *m_pLimit;
+	boost::unique_lock< boost::mutex > lock( rLimit.m_Mutex );
+
+	// requests already waiting go first
+	if( rLimit.m_Active < rLimit.m_MaxConcurrent && rLimit.m_Queued == 0 )
+	{
+		++rLimit.m_Active;
+		return;
+	}
+	if( rLimit.m_Queued >= rLimit.m_MaxQueued )
+	{
+		m_Admitted = false;
+		return;
+	}
+
+	++rLimit.m_Queued;
+	boost::system_time deadline = boost::get_system_time() + boost::posix_time::microseconds( int64_t( rLimit.m_QueueTimeout * 1000000 ) );
+	while( rLimit.m_Active >= rLimit.m_MaxConcurrent )
+	{
+		if( rLimit.m_QueueTimeout == 0 )
+		{
+			rLimit.m_SlotReleased.wait( lock );
+		}
+		else if( !rLimit.m_SlotReleased.timed_wait( lock, deadline ) && rLimit.m_Active >= rLimit.m_MaxConcurrent )
+		{
+			m_Admitted = false;
+			break;
+		}
+	}
+	--rLimit.m_Queued;
+	if( m_Admitted )
+	{
+		++rLimit.m_Active;
+	}
+}
+
+AdmissionController::Ticket::~Ticket()
+{
+	if( !m_pLimit || !m_Admitted )
+	{
+		return;
+	}
+	{
+		boost::unique_lock< boost::mutex > lock( m_pLimit->m_Mutex );
+		--m_pLimit->m_Active;
+	}
+	m_pLimit->m_SlotReleased.notify_one();
+}
+
+bool AdmissionController::Ticket::IsAdmitted() const
+{
+	return m_Admitted;
+}
@@ -0,0 +1,42 @@
+#include "AdmissionHandler.hpp"
+#include "AdmissionController.hpp"
+#include "MVLogger.hpp"
+#include "WebServerCommon.hpp"
+#include "AbstractHandler.hpp"
+#include "HTTPRequest.hpp"
+#include "HTTPResponse.hpp"
+#include "DataProxyService.hpp"
+
+namespace
+{
+	const int SERVICE_UNAVAILABLE_STATUS( 503 );
+}
+
+AdmissionHandler::AdmissionHandler( IWebService& i_rHandler, AdmissionController& i_rAdmissionController )
+:	m_rHandler( i_rHandler ),
+	m_rAdmissionController( i_rAdmissionController )
+{
+}
+
+AdmissionHandler::~AdmissionHandler()
+{
+}
+
+void AdmissionHandler::Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse )
+{
+	std::string name = AbstractHandler::GetName( i_rRequest );
+
+	AdmissionController::Ticket ticket( m_rAdmissionController, name );
+	if( !ticket.IsAdmitted() )
+	{
+		std::stringstream msg;
+		msg << "Too many requests in progress for node: " << name;
+		MVLOGGER( "root.lib.DataProxy.Service.AdmissionHandler.Rejected", msg.str() );
+		o_rResponse.SetHTTPStatusCode( SERVICE_UNAVAILABLE_STATUS );
+		o_rResponse.WriteHeader( SERVER, DATA_PROXY_SERVICE_VERSION );
+		o_rResponse.WriteData( msg.str() + "\n" );
+		return;
+	}
+
+	m_rHandler.Handle( i_rRequest, o_rResponse );
+}
@@ -0,0 +1,95 @@
+#include "ChunkedResponse.hpp"
+#include "WebServerCommon.hpp"
+#include "HTTPResponse.hpp"
+#include "DataProxyService.hpp"
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+	const std::string CONTENT_ENCODING( "Content-Encoding" );
+	const std::string TRANSFER_ENCODING( "Transfer-Encoding" );
+	const std::string CHUNKED( "chunked" );
+	const std::string TRAILER( "Trailer" );
+	const std::string ERROR_TRAILER( "X-DataProxy-Error" );
+	const std::string CRLF( "\r\n" );
+	const std::string LAST_CHUNK( "0\r\n" );
+}
+
+ChunkedResponse::Sink::Sink( ChunkedResponse& o_rResponse )
+:	m_pResponse( &o_rResponse )
+{
+}
+
+std::streamsize ChunkedResponse::Sink::write( const char* i_pData, std::streamsize i_Size )
+{
+	m_pResponse->WriteChunk( i_pData, i_Size );
+	return i_Size;
+}
+
+ChunkedResponse::ChunkedResponse( HTTPResponse& o_rResponse, const std::string& i_rEncoding )
+:	m_rResponse( o_rResponse ),
+	m_Encoding( i_rEncoding ),
+	m_Started( false )
+{
+}
+
+ChunkedResponse::~ChunkedResponse()
+{
+}
+
+bool ChunkedResponse::HasStarted() const
+{
+	return m_Started;
+}
+
+void ChunkedResponse::WriteChunk( const char* i_pData, std::streamsize i_Size )
+{
+	// a zero-length chunk would end the body
+	if( i_Size <= 0 )
+	{
+		return;
+	}
+	Start();
+
+	std::ostringstream chunk;
+	chunk << std::hex << i_Size << CRLF;
+	chunk.write( i_pData, i_Size );
+	chunk << CRLF;
+	m_rResponse.WriteData( chunk.str() );
+}
+
+void ChunkedResponse::Finish()
+{
+	Start();
+	m_rResponse.WriteData( LAST_CHUNK + CRLF );
+}
+
+void ChunkedResponse::Fail( const std::string& i_rMessage )
+{
+	Start();
+
+	// a line break would end the trailer field early
+	std::string message( i_rMessage );
+	std::replace( message.begin(), message.end(), '\r', ' ' );
+	std::replace( message.begin(), message.end(), '\n', ' ' );
+	m_rResponse.WriteData( LAST_CHUNK + ERROR_TRAILER + ": " + message + CRLF + CRLF );
+}
+
+void ChunkedResponse::Start()
+{
+	if( m_Started )
+	{
+		return;
+	}
+	m_Started = true;
+
+	m_rResponse.SetHTTPStatusCode( HTTP_STATUS_OK );
+	m_rResponse.WriteHeader( SERVER, DATA_PROXY_SERVICE_VERSION );
+	m_rResponse.WriteHeader( TRANSFER_ENCODING, CHUNKED );
+	if( !m_Encoding.empty() )
+	{
+		m_rResponse.WriteHeader( CONTENT_ENCODING, m_Encoding );
+	}
+	m_rResponse.WriteHeader( TRAILER, ERROR_TRAILER );
+}
@@ -0,0 +1,176 @@
+#include "ConfigReloader.hpp"
+#include "DataProxyClient.hpp"
+#include "ResponseCache.hpp"
+#include "MVLogger.hpp"
+#include <boost/bind.hpp>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+
+namespace
+{
+	// how often a reload that keeps failing the same way is logged
+	const double REPEATED_ERROR_LOG_SECONDS( 60 );
+
+	void GetReloadSignals( sigset_t& o_rSignals )
+	{
+		::sigemptyset( &o_rSignals );
+		::sigaddset( &o_rSignals, SIGHUP );
+	}
+}
+
+ConfigReloader::ConfigReloader( DataProxyClient& i_rDataProxyClient, const std::string& i_rDplConfig, double i_CheckSeconds, bool i_UseFileNotification,
+								ResponseCache* i_pResponseCache )
+:	m_rDataProxyClient( i_rDataProxyClient ),
+	m_DplConfig( i_rDplConfig ),
+	m_CheckSeconds( i_CheckSeconds ),
+	m_pResponseCache( i_pResponseCache ),
+	m_Failed( false ),
+	m_LastError(),
+	m_LastErrorTimer(),
+	m_Stopping( false ),
+	m_pThread()
+{
+	if( m_CheckSeconds < 0 )
+	{
+		MV_THROW( ConfigReloaderException, "Check seconds: " << m_CheckSeconds << " must be non-negative" );
+	}
+
+	// the reloader decides when to check, so the client should look at the files each time it is asked to
+	m_rDataProxyClient.SetConfigCheckOptions( 0, i_UseFileNotification );
+}
+
+ConfigReloader::~ConfigReloader()
+{
+	Stop();
+}
+
+void ConfigReloader::BlockReloadSignal()
+{
+	sigset_t signals;
+	GetReloadSignals( signals );
+	int result = ::pthread_sigmask( SIG_BLOCK, &signals, NULL );
+	if( result != 0 )
+	{
+		MV_THROW( ConfigReloaderException, "Unable to block SIGHUP: " << ::strerror( result ) );
+	}
+}
+
+bool ConfigReloader::Reload()
+{
+	return Reload( true );
+}
+
+bool ConfigReloader::Reload( bool i_LogRepeatedError )
+{
+	// most checks find nothing has changed, and the client keeps its configuration
+	std::string previousMD5 = m_rDataProxyClient.GetConfigMD5();
+	try
+	{
+		m_rDataProxyClient.Initialize( m_DplConfig );
+	}
+	catch( const std::exception& i_rEx )
+	{
+		// a broken config is retried on every check, so only say so again when there is something new
+		m_Failed = true;
+		if( i_LogRepeatedError || i_rEx.what() != m_LastError || m_LastErrorTimer.GetElapsedMilliseconds() >= REPEATED_ERROR_LOG_SECONDS * 1000 )
+		{
+			m_LastError = i_rEx.what();
+			m_LastErrorTimer.Reset();
+			MVLOGGER( "root.lib.DataProxy.Service.ConfigReloader.Reload.ErrorInitializing",
+				"Error initializing DPL with file: " << m_DplConfig << ": " << m_LastError << ". Any previous config remains in use" );
+		}
+		return false;
+	}
+
+	if( m_Failed )
+	{
+		MVLOGGER( "root.lib.DataProxy.Service.ConfigReloader.Reload.Recovered", "Initialized DPL with file: " << m_DplConfig );
+	}
+	if( m_pResponseCache != NULL && m_rDataProxyClient.GetConfigMD5() != previousMD5 )
+	{
+		MVLOGGER( "root.lib.DataProxy.Service.ConfigReloader.Reload.ClearedResponseCache", "DPL config: " << m_DplConfig
+			<< " has changed; clearing the response cache" );
+		m_pResponseCache->Clear();
+	}
+	m_Failed = false;
+	m_LastError.clear();
+	return true;
+}
+
+void ConfigReloader::Start()
+{
+	if( m_pThread )
+	{
+		return;
+	}
+	m_Stopping = false;
+
+	// the thread must be started with the signal blocked (it is woken with it by Stop), whatever the caller's mask
+	sigset_t signals;
+	sigset_t previous;
+	GetReloadSignals( signals );
+	::pthread_sigmask( SIG_BLOCK, &signals, &previous );
+	m_pThread.reset( new boost::thread( boost::bind( &ConfigReloader::Run, this ) ) );
+	::pthread_sigmask( SIG_SETMASK, &previous, NULL );
+}
+
+void ConfigReloader::Stop()
+{
+	if( !m_pThread )
+	{
+		return;
+	}
+	m_Stopping = true;
+	::pthread_kill( m_pThread->native_handle(), SIGHUP );
+	m_pThread->join();
+	m_pThread.reset();
+}
+
+void ConfigReloader::Signal()
+{
+	if( !m_pThread )
+	{
+		return;
+	}
+	int result = ::pthread_kill( m_pThread->native_handle(), SIGHUP );
+	if( result != 0 )
+	{
+		MV_THROW( ConfigReloaderException, "Unable to signal the reloader thread: " << ::strerror( result ) );
+	}
+}
+
+void ConfigReloader::Run()
+{
+	sigset_t signals;
+	GetReloadSignals( signals );
+	timespec timeout;
+	timeout.tv_sec = time_t( m_CheckSeconds );
+	timeout.tv_nsec = long( ( m_CheckSeconds - timeout.tv_sec ) * 1000000000 );
+
+	while( true )
+	{
+		int signal = ( m_CheckSeconds > 0 ) ? ::sigtimedwait( &signals, NULL, &timeout ) : ::sigwaitinfo( &signals, NULL );
+		if( m_Stopping )
+		{
+			return;
+		}
+		if( signal == SIGHUP )
+		{
+			MVLOGGER( "root.lib.DataProxy.Service.ConfigReloader.Run.ReceivedSignal", "Received SIGHUP; checking DPL config: " << m_DplConfig );
+			Reload();
+		}
+		else if( signal < 0 && errno == EAGAIN )
+		{
+			Check();
+		}
+	}
+}
+
+void ConfigReloader::Check()
+{
+	// the client decides whether the config or any of its entities needs re-reading; a config that failed
+	// to load is always re-read, since whatever broke it may have been fixed
+	Reload( false );
+}
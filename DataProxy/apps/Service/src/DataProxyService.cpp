@@ -19,6 +19,15 @@
 #include "DeleteHandler.hpp"
 #include "ApplicationMonitor.hpp"
 #include "PingHandler.hpp"
+#include "ConfigReloader.hpp"
+#include "AdmissionController.hpp"
+#include "AdmissionHandler.hpp"
+#include "ServiceMetrics.hpp"
+#include "MeteringHandler.hpp"
+#include "MetricsHandler.hpp"
+#include "ResponseCache.hpp"
+#include "detail/RequestTrace.hpp"
+#include <boost/scoped_ptr.hpp>
 
 namespace
 {
@@ -30,12 +39,19 @@ namespace
 	const std::string STATS_PER_HOUR_ESTIMATE( "stats_per_hour_estimate" );
 
 	const std::string MATCH_ALL( ".*" );
+
+	const std::string LOAD_OPERATION( "load" );
+	const std::string STORE_OPERATION( "store" );
+	const std::string DELETE_OPERATION( "delete" );
 }
 
 int main( int argc, char** argv )
 {
 	try
 	{
+		// the config reloader is the only thread to receive SIGHUP; every thread started from here on inherits this
+		ConfigReloader::BlockReloadSignal();
+
 		DataProxyServiceConfig config( argc, argv );
 		MVLogger::Init( "/dev/null", config.GetLogConfig(), config.GetInstanceId() );
 		XMLPlatformUtils::Initialize();
@@ -57,19 +73,61 @@ int main( int argc, char** argv )
 			ApplicationMonitor::Init( config.GetMonitorConfig() );
 		}
 
+		RequestTrace::SetSampleRate( config.GetTraceSampleRate() );
+
 		// create handlers
 		DataProxyClient client( true );
-		PingHandler pingHandler( client, config.GetDplConfig() );
-		LoadHandler loadHandler( client, config.GetDplConfig(), config.GetZLibCompressionLevel(), config.GetEnableXForwardedFor() );
-		StoreHandler storeHandler( client, config.GetDplConfig(), config.GetEnableXForwardedFor() );
-		DeleteHandler deleteHandler( client, config.GetDplConfig(), config.GetEnableXForwardedFor() );
+		// the load handler fills the response cache; writes and config changes invalidate it
+		boost::scoped_ptr< ResponseCache > pResponseCache;
+		if( config.GetResponseCacheSeconds() > 0 )
+		{
+			pResponseCache.reset( new ResponseCache( config.GetResponseCacheSeconds(), config.GetResponseCacheBytes() ) );
+		}
+		PingHandler pingHandler( client );
+		LoadHandler loadHandler( client, config.GetZLibCompressionLevel(), config.GetZstdCompressionLevel(), config.GetLz4CompressionLevel(),
+								  config.GetEnableXForwardedFor(), config.GetStreamLoads(), config.GetStreamChunkSize(), config.GetParallelGZipThreads(),
+								  config.GetParallelGZipBlockSize(), config.GetEnableETags(), pResponseCache.get() );
+		StoreHandler storeHandler( client, config.GetEnableXForwardedFor(), config.GetMaxDecodedBodySize(), pResponseCache.get() );
+		DeleteHandler deleteHandler( client, config.GetEnableXForwardedFor(), pResponseCache.get() );
+
+		// limit requests per node; pings are never held up
+		AdmissionController admissionController;
+		if( !config.GetAdmissionConfig().empty() )
+		{
+			admissionController.Parse( config.GetAdmissionConfig() );
+		}
+		AdmissionHandler admittedLoadHandler( loadHandler, admissionController );
+		AdmissionHandler admittedStoreHandler( storeHandler, admissionController );
+		AdmissionHandler admittedDeleteHandler( deleteHandler, admissionController );
+		IWebService* pLoadHandler = &admittedLoadHandler;
+		IWebService* pStoreHandler = &admittedStoreHandler;
+		IWebService* pDeleteHandler = &admittedDeleteHandler;
+
+		// record metrics (including rejected requests) if there is a path to serve them on
+		ServiceMetrics metrics( config.GetMetricsMaxNodes() );
+		MeteringHandler meteredLoadHandler( admittedLoadHandler, metrics, LOAD_OPERATION );
+		MeteringHandler meteredStoreHandler( admittedStoreHandler, metrics, STORE_OPERATION );
+		MeteringHandler meteredDeleteHandler( admittedDeleteHandler, metrics, DELETE_OPERATION );
+		MetricsHandler metricsHandler( metrics, config.GetMetricsPath(), meteredLoadHandler );
+		if( !config.GetMetricsPath().empty() )
+		{
+			pLoadHandler = &metricsHandler;
+			pStoreHandler = &meteredStoreHandler;
+			pDeleteHandler = &meteredDeleteHandler;
+		}
 
 		// register handlers
-		rWebServer.AddWebService( HTTP_POST, MATCH_ALL, storeHandler, config.GetStoreWhitelistFile() );
-		rWebServer.AddWebService( HTTP_GET, MATCH_ALL, loadHandler, config.GetLoadWhitelistFile() );
-		rWebServer.AddWebService( HTTP_DELETE, MATCH_ALL, deleteHandler, config.GetDeleteWhitelistFile() );
+		rWebServer.AddWebService( HTTP_POST, MATCH_ALL, *pStoreHandler, config.GetStoreWhitelistFile() );
+		rWebServer.AddWebService( HTTP_GET, MATCH_ALL, *pLoadHandler, config.GetLoadWhitelistFile() );
+		rWebServer.AddWebService( HTTP_DELETE, MATCH_ALL, *pDeleteHandler, config.GetDeleteWhitelistFile() );
 		rWebServer.AddWebService( HTTP_HEAD, MATCH_ALL, pingHandler, config.GetPingWhitelistFile() );
 
+		// load the dpl config up front, then watch it for changes in the background. if it cannot be loaded,
+		// requests fail until it is fixed
+		ConfigReloader configReloader( client, config.GetDplConfig(), config.GetDplConfigRecheckSeconds(), config.GetDplConfigNotify(), pResponseCache.get() );
+		configReloader.Reload();
+		configReloader.Start();
+
 		// start webservice
 		MVLOGGER( "root.lib.DataProxy.Service.CreatedWebserver", "Starting data proxy service, instance id: " << config.GetInstanceId() << ", listening on port: " << config.GetPort() );
 		rWebServer.Run();
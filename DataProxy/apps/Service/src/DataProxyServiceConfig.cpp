@@ -18,11 +18,27 @@ namespace
 	const char* INSTANCE_ID( "instance_id" );
 	const char* LOG_CONFIG( "log_config" );
 	const char* DPL_CONFIG( "dpl_config" );
+	const char* DPL_CONFIG_RECHECK_SECONDS( "dpl_config_recheck_seconds" );
+	const char* DPL_CONFIG_NOTIFY( "dpl_config_notify" );
 	const char* PORT( "port" );
 	const char* NUM_THREADS( "num_threads" );
 	const char* MAX_REQUEST_SIZE( "max_request_size" );
 	const char* ZLIB_COMPRESSION_LEVEL( "zlib_compression_level" );
+	const char* ZSTD_COMPRESSION_LEVEL( "zstd_compression_level" );
+	const char* LZ4_COMPRESSION_LEVEL( "lz4_compression_level" );
+	const char* MAX_DECODED_BODY_SIZE( "max_decoded_body_size" );
 	const char* ENABLE_X_FORWARDED_FOR( "enable_x-forwarded-for" );
+	const char* STREAM_LOADS( "stream_loads" );
+	const char* STREAM_CHUNK_SIZE( "stream_chunk_size" );
+	const char* PARALLEL_GZIP_THREADS( "parallel_gzip_threads" );
+	const char* PARALLEL_GZIP_BLOCK_SIZE( "parallel_gzip_block_size" );
+	const char* ENABLE_ETAGS( "enable_etags" );
+	const char* RESPONSE_CACHE_SECONDS( "response_cache_seconds" );
+	const char* RESPONSE_CACHE_BYTES( "response_cache_bytes" );
+	const char* ADMISSION_CONFIG( "admission_config" );
+	const char* METRICS_PATH( "metrics_path" );
+	const char* METRICS_MAX_NODES( "metrics_max_nodes" );
+	const char* TRACE_SAMPLE_RATE( "trace_sample_rate" );
 	const char* LOAD_WHITELIST_FILE( "load_whitelist_file" );
 	const char* STORE_WHITELIST_FILE( "store_whitelist_file" );
 	const char* DELETE_WHITELIST_FILE( "delete_whitelist_file" );
@@ -40,11 +56,27 @@ DataProxyServiceConfig::DataProxyServiceConfig( int argc, char** argv )
 		( INSTANCE_ID, boost::program_options::value<std::string>(), "instance id for this data manager\n (used mostly for logging)" )
 		( LOG_CONFIG, boost::program_options::value<std::string>()->default_value(""), "log4cxx configuration file" )
 		( DPL_CONFIG, boost::program_options::value<std::string>(), "dpl config to use to initialize dpl handler" )
+		( DPL_CONFIG_RECHECK_SECONDS, boost::program_options::value<double>()->default_value(1), "number of seconds between background checks of the dpl config (and its entities) for changes.\n0: only reload the dpl config on SIGHUP" )
+		( DPL_CONFIG_NOTIFY, boost::program_options::value<bool>()->default_value(false), "if toggled, use file notification (inotify) to detect dpl config changes instead of checking file status" )
 		( PORT, boost::program_options::value<uint>(), "port to listen on" )
 		( NUM_THREADS, boost::program_options::value<uint>(), "number of threads to handle requests" )
 		( MAX_REQUEST_SIZE, boost::program_options::value<uint>()->default_value(16384), "byte limit for url requests" )
 		( ENABLE_X_FORWARDED_FOR, boost::program_options::value<bool>()->default_value(false), "if toggled, enable parsing, appending, and forwarding of X-Forwarded-For HTTP header field" )
 		( ZLIB_COMPRESSION_LEVEL, boost::program_options::value<int>()->default_value(0), "zlib dynamic compression level\n  -1: use zlib default\n   0: disable compression\n 1-9: legal compression levels" )
+		( ZSTD_COMPRESSION_LEVEL, boost::program_options::value<int>()->default_value(0), "zstd dynamic compression level\n   0: disable compression\n1-19: legal compression levels" )
+		( LZ4_COMPRESSION_LEVEL, boost::program_options::value<int>()->default_value(0), "lz4 dynamic compression level\n   0: disable compression\n 1-2: fast compression\n3-12: high compression levels\nwhen a client accepts several enabled encodings with the same weight, zstd is preferred over lz4, and lz4 over gzip" )
+		( MAX_DECODED_BODY_SIZE, boost::program_options::value<size_t>()->default_value(1073741824), "maximum number of bytes a compressed (gzip, zstd or lz4) store body may decode to. stores whose body decodes to more are rejected with 413" )
+		( STREAM_LOADS, boost::program_options::value<bool>()->default_value(false), "if toggled, send load results to the client as they are loaded using chunked transfer encoding, instead of collecting each result before responding.\nerrors that occur once data has been sent are reported in the X-DataProxy-Error trailer.\nthe chunk framing is written as part of the response data, so this requires a web server that sends the data it is given unmodified, without a Content-Length or chunking of its own. check that it does before enabling this" )
+		( STREAM_CHUNK_SIZE, boost::program_options::value<uint>()->default_value(65536), "streaming only: number of bytes buffered before they are sent as a chunk" )
+		( PARALLEL_GZIP_THREADS, boost::program_options::value<uint>()->default_value(0), "number of threads shared by all requests for gzip compression. each response is cut into blocks that are compressed in parallel, at the cost of a slightly larger result.\n0: compress each response as a single stream in the request thread" )
+		( PARALLEL_GZIP_BLOCK_SIZE, boost::program_options::value<uint>()->default_value(131072), "parallel gzip only: number of uncompressed bytes in each block" )
+		( ENABLE_ETAGS, boost::program_options::value<bool>()->default_value(false), "if toggled, tag load responses with an ETag (a hash of the response) and answer requests whose If-None-Match matches it with 304 Not Modified.\nstreamed responses are not tagged" )
+		( RESPONSE_CACHE_SECONDS, boost::program_options::value<double>()->default_value(0), "number of seconds to keep load responses in memory, so identical requests are answered without loading again.\nresponses are keyed by all load parameters, so with enable_x-forwarded-for each client address gets its own entries.\na store or delete through the service drops the node's responses, and a new dpl config drops them all.\n0: disable the response cache" )
+		( RESPONSE_CACHE_BYTES, boost::program_options::value<size_t>()->default_value(67108864), "response cache only: maximum number of bytes held; least recently used responses are dropped to stay under it" )
+		( ADMISSION_CONFIG, boost::program_options::value<std::string>()->default_value(""), "xml file limiting the number of load, store & delete requests in progress at once for a node or node prefix, with a bounded queue for requests waiting on a slot. requests beyond that are answered with 503.\nwaiting requests hold a service thread, so the limits should leave room within num_threads for other nodes.\nif empty, requests are not limited" )
+		( METRICS_PATH, boost::program_options::value<std::string>()->default_value(""), "if set, record latency, error & byte counts for each node & operation, and serve them as plain text to GET requests for this path (which can then not be loaded as a node).\nif empty, metrics are not recorded" )
+		( METRICS_MAX_NODES, boost::program_options::value<uint>()->default_value(1000), "metrics only: number of nodes recorded separately; requests for any others are recorded together as node \"__other\"" )
+		( TRACE_SAMPLE_RATE, boost::program_options::value<double>()->default_value(0), "fraction of requests, from 0 to 1, whose call tree through the dpl nodes is logged as a json trace (under root.lib.DataProxy.RequestTrace.Trace).\n0: do not trace requests" )
 		( LOAD_WHITELIST_FILE, boost::program_options::value<std::string>()->default_value(""), "ip whitelist file for load (GET) operations.\nif empty or nonexistent, all incoming ips will be allowed.\nif present, only the ips defined in the file (newline-separated) will be allowed to load data.\nrequests may have multiple ip addresses for a single request (via X-Forwarded-For field); in this case at least one of the ips must be in the whitelist for the request to succeed" )
 		( STORE_WHITELIST_FILE, boost::program_options::value<std::string>()->default_value(""), "ip whitelist file for store (POST) operations.\nsame semantics as load whitelist" )
 		( DELETE_WHITELIST_FILE, boost::program_options::value<std::string>()->default_value(""), "ip whitelist file for delete (DELETE) operations.\nsame semantics as load whitelist" )
@@ -61,6 +93,51 @@ DataProxyServiceConfig::DataProxyServiceConfig( int argc, char** argv )
 	{
 		MV_THROW( DataProxyServiceConfigException, "" << ZLIB_COMPRESSION_LEVEL << ": " << zlibCompression << " is not in the range: [-1,9]" );
 	}
+
+	int zstdCompression = m_Options[ZSTD_COMPRESSION_LEVEL].as< int >();
+	if( zstdCompression < 0 || zstdCompression > 19 )
+	{
+		MV_THROW( DataProxyServiceConfigException, "" << ZSTD_COMPRESSION_LEVEL << ": " << zstdCompression << " is not in the range: [0,19]" );
+	}
+
+	int lz4Compression = m_Options[LZ4_COMPRESSION_LEVEL].as< int >();
+	if( lz4Compression < 0 || lz4Compression > 12 )
+	{
+		MV_THROW( DataProxyServiceConfigException, "" << LZ4_COMPRESSION_LEVEL << ": " << lz4Compression << " is not in the range: [0,12]" );
+	}
+
+	if( m_Options[MAX_DECODED_BODY_SIZE].as< size_t >() == 0 )
+	{
+		MV_THROW( DataProxyServiceConfigException, "" << MAX_DECODED_BODY_SIZE << ": must be positive" );
+	}
+
+	double recheckSeconds = m_Options[DPL_CONFIG_RECHECK_SECONDS].as< double >();
+	if( recheckSeconds < 0 )
+	{
+		MV_THROW( DataProxyServiceConfigException, "" << DPL_CONFIG_RECHECK_SECONDS << ": " << recheckSeconds << " must be non-negative" );
+	}
+
+	double responseCacheSeconds = m_Options[RESPONSE_CACHE_SECONDS].as< double >();
+	if( responseCacheSeconds < 0 )
+	{
+		MV_THROW( DataProxyServiceConfigException, "" << RESPONSE_CACHE_SECONDS << ": " << responseCacheSeconds << " must be non-negative" );
+	}
+
+	double traceSampleRate = m_Options[TRACE_SAMPLE_RATE].as< double >();
+	if( traceSampleRate < 0 || traceSampleRate > 1 )
+	{
+		MV_THROW( DataProxyServiceConfigException, "" << TRACE_SAMPLE_RATE << ": " << traceSampleRate << " is not in the range: [0,1]" );
+	}
+
+	if( m_Options[STREAM_CHUNK_SIZE].as< uint >() == 0 )
+	{
+		MV_THROW( DataProxyServiceConfigException, "" << STREAM_CHUNK_SIZE << ": must be positive" );
+	}
+
+	if( m_Options[PARALLEL_GZIP_BLOCK_SIZE].as< uint >() == 0 )
+	{
+		MV_THROW( DataProxyServiceConfigException, "" << PARALLEL_GZIP_BLOCK_SIZE << ": must be positive" );
+	}
 }
 
 DataProxyServiceConfig::~DataProxyServiceConfig()
@@ -82,6 +159,16 @@ const std::string& DataProxyServiceConfig::GetDplConfig() const
 	return m_Options[DPL_CONFIG].as< std::string >();
 }
 
+double DataProxyServiceConfig::GetDplConfigRecheckSeconds() const
+{
+	return m_Options[DPL_CONFIG_RECHECK_SECONDS].as< double >();
+}
+
+bool DataProxyServiceConfig::GetDplConfigNotify() const
+{
+	return m_Options[DPL_CONFIG_NOTIFY].as< bool >();
+}
+
 uint DataProxyServiceConfig::GetPort() const
 {
 	return m_Options[PORT].as< uint >();
@@ -102,11 +189,81 @@ int DataProxyServiceConfig::GetZLibCompressionLevel() const
 	return m_Options[ZLIB_COMPRESSION_LEVEL].as< int >();
 }
 
+int DataProxyServiceConfig::GetZstdCompressionLevel() const
+{
+	return m_Options[ZSTD_COMPRESSION_LEVEL].as< int >();
+}
+
+int DataProxyServiceConfig::GetLz4CompressionLevel() const
+{
+	return m_Options[LZ4_COMPRESSION_LEVEL].as< int >();
+}
+
+size_t DataProxyServiceConfig::GetMaxDecodedBodySize() const
+{
+	return m_Options[MAX_DECODED_BODY_SIZE].as< size_t >();
+}
+
 bool DataProxyServiceConfig::GetEnableXForwardedFor() const
 {
 	return m_Options[ENABLE_X_FORWARDED_FOR].as< bool >();
 }
 
+bool DataProxyServiceConfig::GetStreamLoads() const
+{
+	return m_Options[STREAM_LOADS].as< bool >();
+}
+
+uint DataProxyServiceConfig::GetStreamChunkSize() const
+{
+	return m_Options[STREAM_CHUNK_SIZE].as< uint >();
+}
+
+uint DataProxyServiceConfig::GetParallelGZipThreads() const
+{
+	return m_Options[PARALLEL_GZIP_THREADS].as< uint >();
+}
+
+uint DataProxyServiceConfig::GetParallelGZipBlockSize() const
+{
+	return m_Options[PARALLEL_GZIP_BLOCK_SIZE].as< uint >();
+}
+
+bool DataProxyServiceConfig::GetEnableETags() const
+{
+	return m_Options[ENABLE_ETAGS].as< bool >();
+}
+
+double DataProxyServiceConfig::GetResponseCacheSeconds() const
+{
+	return m_Options[RESPONSE_CACHE_SECONDS].as< double >();
+}
+
+size_t DataProxyServiceConfig::GetResponseCacheBytes() const
+{
+	return m_Options[RESPONSE_CACHE_BYTES].as< size_t >();
+}
+
+const std::string& DataProxyServiceConfig::GetAdmissionConfig() const
+{
+	return m_Options[ADMISSION_CONFIG].as< std::string >();
+}
+
+const std::string& DataProxyServiceConfig::GetMetricsPath() const
+{
+	return m_Options[METRICS_PATH].as< std::string >();
+}
+
+uint DataProxyServiceConfig::GetMetricsMaxNodes() const
+{
+	return m_Options[METRICS_MAX_NODES].as< uint >();
+}
+
+double DataProxyServiceConfig::GetTraceSampleRate() const
+{
+	return m_Options[TRACE_SAMPLE_RATE].as< double >();
+}
+
 const std::string& DataProxyServiceConfig::GetLoadWhitelistFile() const
 {
 	return m_Options[LOAD_WHITELIST_FILE].as< std::string >();
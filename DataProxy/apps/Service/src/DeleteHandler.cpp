@@ -15,9 +15,11 @@
 #include "HTTPRequest.hpp"
 #include "HTTPResponse.hpp"
 #include "DataProxyService.hpp"
+#include "ResponseCache.hpp"
 
-DeleteHandler::DeleteHandler( DataProxyClient& i_rDataProxyClient, const std::string& i_rDplConfig, bool i_EnableXForwardedFor )
-:	AbstractHandler( i_rDataProxyClient, i_rDplConfig, i_EnableXForwardedFor )
+DeleteHandler::DeleteHandler( DataProxyClient& i_rDataProxyClient, bool i_EnableXForwardedFor, ResponseCache* i_pResponseCache )
+:	AbstractHandler( i_rDataProxyClient, i_EnableXForwardedFor ),
+	m_pResponseCache( i_pResponseCache )
 {
 }
 
@@ -27,17 +29,13 @@ DeleteHandler::~DeleteHandler()
 
 void DeleteHandler::Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse )
 {
-	if( !CheckConfig( o_rResponse ) )
-	{
-		return;
-	}
-
 	std::map< std::string, std::string > parameters;
 	std::string name;
 	GetParams( i_rRequest, name, parameters ); 
 
 	try
 	{
+		ResponseCache::ScopedInvalidation invalidation( m_pResponseCache, name );
 		AbstractHandler::GetDataProxyClient().Delete( name, parameters );
 	}
 	catch( const std::exception& i_rEx )
@@ -10,6 +10,9 @@
 //
 
 #include "LoadHandler.hpp"
+#include "ChunkedResponse.hpp"
+#include "Lz4Filter.hpp"
+#include "ParallelGzipCompressor.hpp"
 #include "DataProxyClient.hpp"
 #include "MVLogger.hpp"
 #include "WebServerCommon.hpp"
@@ -18,8 +21,10 @@
 #include "StringUtilities.hpp"
 #include "DateTime.hpp"
 #include "DataProxyService.hpp"
+#include "MVUtility.hpp"
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/filter/zstd.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/lexical_cast.hpp>
 
@@ -28,12 +33,84 @@ namespace
 	const std::string ACCEPT_ENCODING( "Accept-Encoding" );
 	const std::string CONTENT_LENGTH( "Content-Length" );
 	const std::string CONTENT_ENCODING( "Content-Encoding" );
+	const std::string ETAG( "ETag" );
+	const std::string IF_NONE_MATCH( "If-None-Match" );
+	const std::string WEAK_ETAG_PREFIX( "W/" );
+	const std::string ANY_ETAG( "*" );
+	const std::string IF_NONE_MATCH_SEPARATORS( ", " );
+	const int NOT_MODIFIED_STATUS( 304 );
 	const std::string GZIP( "gzip" );
+	const std::string ZSTD( "zstd" );
+	const std::string LZ4( "lz4" );
 	const std::string ACCEPT_ENCODING_SEPARATORS( ", " );
+	const std::string QUALITY_PREFIX( "q=" );
+
+	// the weight the client gave each encoding it listed: 1 unless it gave a q-value. an encoding
+	// with a weight of 0 is one the client refuses
+	std::map< std::string, double > ParseAcceptEncoding( const std::string& i_rAcceptEncoding )
+	{
+		std::map< std::string, double > result;
+		std::vector< std::string > tokens;
+		Tokenize( tokens, i_rAcceptEncoding, ACCEPT_ENCODING_SEPARATORS );
+
+		std::map< std::string, double >::iterator previous = result.end();
+		std::vector< std::string >::const_iterator iter = tokens.begin();
+		for( ; iter != tokens.end(); ++iter )
+		{
+			// "gzip;q=0.5" is a single token, but "gzip; q=0.5" leaves the q-value on its own
+			std::string name = iter->substr( 0, iter->find( ';' ) );
+			std::string parameter = ( name.size() < iter->size() ? iter->substr( name.size() + 1 ) : "" );
+			if( name.find( QUALITY_PREFIX ) == 0 && previous != result.end() )
+			{
+				parameter = name;
+				name = previous->first;
+			}
+			if( name.empty() )
+			{
+				continue;
+			}
+
+			double weight( 1 );
+			if( parameter.find( QUALITY_PREFIX ) == 0 )
+			{
+				try
+				{
+					weight = boost::lexical_cast< double >( parameter.substr( QUALITY_PREFIX.size() ) );
+				}
+				catch( const boost::bad_lexical_cast& )
+				{
+					// an unreadable q-value is ignored
+				}
+			}
+			previous = result.insert( std::make_pair( name, weight ) ).first;
+			previous->second = weight;
+		}
+		return result;
+	}
+
+	// whether any tag the client listed is the given one. responses are never changed in transit, so weak
+	// tags are compared the same as strong ones
+	bool MatchesETag( const std::string& i_rIfNoneMatch, const std::string& i_rETag )
+	{
+		std::vector< std::string > tokens;
+		Tokenize( tokens, i_rIfNoneMatch, IF_NONE_MATCH_SEPARATORS );
+		std::vector< std::string >::const_iterator iter = tokens.begin();
+		for( ; iter != tokens.end(); ++iter )
+		{
+			std::string tag = ( iter->find( WEAK_ETAG_PREFIX ) == 0 ? iter->substr( WEAK_ETAG_PREFIX.size() ) : *iter );
+			if( tag == ANY_ETAG || tag == i_rETag )
+			{
+				return true;
+			}
+		}
+		return false;
+	}
 }
 
-LoadHandler::LoadHandler( DataProxyClient& i_rDataProxyClient, const std::string& i_rDplConfig, int i_ZLibCompressionLevel, bool i_EnableXForwardedFor )
-:	AbstractHandler( i_rDataProxyClient, i_rDplConfig, i_EnableXForwardedFor ),
+LoadHandler::LoadHandler( DataProxyClient& i_rDataProxyClient, int i_ZLibCompressionLevel, int i_ZstdCompressionLevel,
+						  int i_Lz4CompressionLevel, bool i_EnableXForwardedFor, bool i_StreamResponses, size_t i_ChunkSize, size_t i_ParallelGZipThreads,
+						  size_t i_ParallelGZipBlockSize, bool i_EnableETags, ResponseCache* i_pResponseCache )
+:	AbstractHandler( i_rDataProxyClient, i_EnableXForwardedFor ),
 	// gzip params have all default values except for the compression level
 	m_GZipParams( i_ZLibCompressionLevel,
 				  boost::iostreams::gzip::deflated,
@@ -43,8 +120,20 @@ LoadHandler::LoadHandler( DataProxyClient& i_rDataProxyClient, const std::string
 				  "",	// file name
 				  "",	// comment
 				  0 ),	// mtime
-	m_CompressionEnabled( i_ZLibCompressionLevel != 0 )
+	m_CompressionEnabled( i_ZLibCompressionLevel != 0 ),
+	m_pGZipPool(),
+	m_GZipBlockSize( i_ParallelGZipBlockSize ),
+	m_ZstdCompressionLevel( i_ZstdCompressionLevel ),
+	m_Lz4CompressionLevel( i_Lz4CompressionLevel ),
+	m_StreamResponses( i_StreamResponses ),
+	m_ChunkSize( i_ChunkSize ),
+	m_EnableETags( i_EnableETags ),
+	m_pCache( i_pResponseCache )
 {
+	if( m_CompressionEnabled && i_ParallelGZipThreads > 0 )
+	{
+		m_pGZipPool.reset( new GzipBlockPool( i_ParallelGZipThreads ) );
+	}
 }
 
 LoadHandler::~LoadHandler()
@@ -53,37 +142,51 @@ LoadHandler::~LoadHandler()
 
 void LoadHandler::Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse )
 {
-	if( !AbstractHandler::CheckConfig( o_rResponse ) )
+	std::map< std::string, std::string > parameters;
+	std::string name;
+	AbstractHandler::GetParams( i_rRequest, name, parameters ); 
+
+	std::string encoding;
+	Nullable< std::string > acceptEncoding = i_rRequest.GetHeaderEntry( ACCEPT_ENCODING );
+	if( !acceptEncoding.IsNull() )
 	{
-		return;
+		encoding = NegotiateEncoding( static_cast< std::string& >( acceptEncoding ) );
 	}
 
-	std::string encoding;
-	std::ostringstream results;
+	// a cached response is already encoded, so it is only good for requests that negotiate the same encoding.
+	// the key covers every parameter, including the X-Forwarded-For chain when that is enabled (nodes may load
+	// by it), so then responses are only shared between requests from the same clients
+	std::string cacheKey;
+	size_t cacheGeneration = 0;
+	if( m_pCache != NULL )
+	{
+		cacheKey = ResponseCache::MakeKey( name, parameters, encoding );
+		boost::shared_ptr< const ResponseCache::Response > pCached = m_pCache->Get( cacheKey );
+		if( pCached )
+		{
+			MVLOGGER( "root.lib.DataProxy.Service.LoadHandler.CacheHit", "Answering load from node: " << name << " from the response cache" );
+			WriteResponse( i_rRequest, o_rResponse, encoding, *pCached );
+			return;
+		}
+		// a write that finishes while this load runs may make its result stale
+		cacheGeneration = m_pCache->GetGeneration();
+	}
 
 	// we will use a boost filtering_ostream, optionally tacking on compressors based on incoming parameters
 	// need to scope the filter because the gzip_compressor does not support flush operations; it will need to go out of scope
 	boost::scoped_ptr< boost::iostreams::filtering_ostream > pFilter( new boost::iostreams::filtering_ostream() );
-	Nullable< std::string > acceptEncoding = i_rRequest.GetHeaderEntry( ACCEPT_ENCODING );
-	if( !acceptEncoding.IsNull() && m_CompressionEnabled )
+	if( !encoding.empty() )
 	{
-		std::vector< std::string > encodings;
-		Tokenize( encodings, acceptEncoding, ACCEPT_ENCODING_SEPARATORS );
-
-		// 1. gzip
-		if( std::find( encodings.begin(), encodings.end(), GZIP ) != encodings.end() )
-		{
-			MVLOGGER( "root.lib.DataProxy.Service.LoadHandler.UsingCompression.GZip", "Using gzip compression; parsed from client's " << ACCEPT_ENCODING << " field: '" << acceptEncoding << "'" );
-			pFilter->push( boost::iostreams::gzip_compressor( m_GZipParams ) );
-			encoding = GZIP;
-		}
+		PushCompressor( encoding, static_cast< std::string& >( acceptEncoding ), *pFilter );
+	}
+	if( m_StreamResponses )
+	{
+		HandleStreaming( name, parameters, o_rResponse, encoding, *pFilter );
+		return;
 	}
+	std::ostringstream results;
 	pFilter->push( results );
 
-	std::map< std::string, std::string > parameters;
-	std::string name;
-	AbstractHandler::GetParams( i_rRequest, name, parameters ); 
-
 	// try to issue the load command
 	try
 	{
@@ -103,16 +206,153 @@ void LoadHandler::Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse )
 	// force the filter to go out of scope so data is flushed to the underlying stream
 	pFilter.reset( NULL );
 
+	boost::shared_ptr< ResponseCache::Response > pResponse( new ResponseCache::Response() );
+	pResponse->m_Data = results.str();
+	if( m_EnableETags )
+	{
+		// the tag covers the bytes as they are sent, so each encoding of a result gets its own
+		pResponse->m_ETag = "\"" + MVUtility::GetMD5( pResponse->m_Data ) + "\"";
+	}
+	if( m_pCache != NULL )
+	{
+		m_pCache->Put( cacheKey, pResponse, cacheGeneration );
+	}
+
+	WriteResponse( i_rRequest, o_rResponse, encoding, *pResponse );
+}
+
+std::string LoadHandler::NegotiateEncoding( const std::string& i_rAcceptEncoding ) const
+{
+	std::map< std::string, double > weights = ParseAcceptEncoding( i_rAcceptEncoding );
+
+	// the client's weights decide; between equally weighted encodings, the faster one is preferred
+	std::vector< std::string > candidates;
+	if( m_ZstdCompressionLevel != 0 )
+	{
+		candidates.push_back( ZSTD );
+	}
+	if( m_Lz4CompressionLevel != 0 )
+	{
+		candidates.push_back( LZ4 );
+	}
+	if( m_CompressionEnabled )
+	{
+		candidates.push_back( GZIP );
+	}
+
+	std::string result;
+	double bestWeight( 0 );
+	std::vector< std::string >::const_iterator iter = candidates.begin();
+	for( ; iter != candidates.end(); ++iter )
+	{
+		std::map< std::string, double >::const_iterator weightIter = weights.find( *iter );
+		if( weightIter != weights.end() && weightIter->second > bestWeight )
+		{
+			result = *iter;
+			bestWeight = weightIter->second;
+		}
+	}
+	return result;
+}
+
+void LoadHandler::PushCompressor( const std::string& i_rEncoding, const std::string& i_rAcceptEncoding, boost::iostreams::filtering_ostream& o_rFilter )
+{
+	if( i_rEncoding == ZSTD )
+	{
+		MVLOGGER( "root.lib.DataProxy.Service.LoadHandler.UsingCompression.Zstd", "Using zstd compression; parsed from client's " << ACCEPT_ENCODING << " field: '" << i_rAcceptEncoding << "'" );
+		o_rFilter.push( boost::iostreams::zstd_compressor( boost::iostreams::zstd_params( m_ZstdCompressionLevel ) ) );
+	}
+	else if( i_rEncoding == LZ4 )
+	{
+		MVLOGGER( "root.lib.DataProxy.Service.LoadHandler.UsingCompression.Lz4", "Using lz4 compression; parsed from client's " << ACCEPT_ENCODING << " field: '" << i_rAcceptEncoding << "'" );
+		o_rFilter.push( Lz4Compressor( m_Lz4CompressionLevel ) );
+	}
+	else
+	{
+		MVLOGGER( "root.lib.DataProxy.Service.LoadHandler.UsingCompression.GZip", "Using gzip compression; parsed from client's " << ACCEPT_ENCODING << " field: '" << i_rAcceptEncoding << "'" );
+		if( m_pGZipPool )
+		{
+			o_rFilter.push( ParallelGzipCompressor( *m_pGZipPool, m_GZipParams.level, m_GZipBlockSize ) );
+		}
+		else
+		{
+			o_rFilter.push( boost::iostreams::gzip_compressor( m_GZipParams ) );
+		}
+	}
+}
+
+void LoadHandler::HandleStreaming( const std::string& i_rName, const std::map< std::string, std::string >& i_rParameters, HTTPResponse& o_rResponse,
+								   const std::string& i_rEncoding, boost::iostreams::filtering_ostream& i_rFilter )
+{
+	// each time the sink's buffer fills, its contents go out to the client as a chunk
+	ChunkedResponse chunked( o_rResponse, i_rEncoding );
+	i_rFilter.push( ChunkedResponse::Sink( chunked ), m_ChunkSize );
+
+	try
+	{
+		AbstractHandler::GetDataProxyClient().Load( i_rName, i_rParameters, i_rFilter );
+
+		// popping the chain closes the compressor (if any) & flushes the last of the data
+		i_rFilter.reset();
+	}
+	catch( const std::exception& i_rEx )
+	{
+		std::stringstream msg;
+		msg << "Error loading data from node: " << i_rName << ": " << i_rEx.what();
+		MVLOGGER( "root.lib.DataProxy.Service.LoadHandler.ErrorLoading", msg.str() );
+
+		// whatever is still buffered belongs to a failed load; drop it rather than send it
+		i_rFilter.set_auto_close( false );
+		while( !i_rFilter.empty() )
+		{
+			i_rFilter.pop();
+		}
+		i_rFilter.set_auto_close( true );
+
+		// if the status has already gone out, the failure can only be reported in the trailer
+		if( chunked.HasStarted() )
+		{
+			chunked.Fail( msg.str() );
+			return;
+		}
+		o_rResponse.SetHTTPStatusCode( HTTP_STATUS_INTERNAL_SERVER_ERROR );
+		o_rResponse.WriteHeader( SERVER, DATA_PROXY_SERVICE_VERSION );
+		o_rResponse.WriteData( msg.str() + "\n" );
+		return;
+	}
+
+	chunked.Finish();
+}
+
+void LoadHandler::WriteResponse( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse, const std::string& i_rEncoding, const ResponseCache::Response& i_rResponse )
+{
+	if( !i_rResponse.m_ETag.empty() )
+	{
+		Nullable< std::string > ifNoneMatch = i_rRequest.GetHeaderEntry( IF_NONE_MATCH );
+		if( !ifNoneMatch.IsNull() && MatchesETag( static_cast< std::string& >( ifNoneMatch ), i_rResponse.m_ETag ) )
+		{
+			o_rResponse.SetHTTPStatusCode( NOT_MODIFIED_STATUS );
+			o_rResponse.WriteHeader( SERVER, DATA_PROXY_SERVICE_VERSION );
+			o_rResponse.WriteHeader( ETAG, i_rResponse.m_ETag );
+			o_rResponse.WriteData( "" );
+			return;
+		}
+	}
+
 	o_rResponse.SetHTTPStatusCode( HTTP_STATUS_OK );
 	o_rResponse.WriteHeader( SERVER, DATA_PROXY_SERVICE_VERSION );
-	o_rResponse.WriteHeader( CONTENT_LENGTH, boost::lexical_cast< std::string >( results.tellp() ) );
+	o_rResponse.WriteHeader( CONTENT_LENGTH, boost::lexical_cast< std::string >( i_rResponse.m_Data.size() ) );
 	
 	// if we set the encoding, write it to the response header
-	if( !encoding.empty() )
+	if( !i_rEncoding.empty() )
+	{
+		o_rResponse.WriteHeader( CONTENT_ENCODING, i_rEncoding );
+	}
+	if( !i_rResponse.m_ETag.empty() )
 	{
-		o_rResponse.WriteHeader( CONTENT_ENCODING, encoding );
+		o_rResponse.WriteHeader( ETAG, i_rResponse.m_ETag );
 	}
 
 	// write the result
-	o_rResponse.WriteData( results.str() );
+	o_rResponse.WriteData( i_rResponse.m_Data );
 }
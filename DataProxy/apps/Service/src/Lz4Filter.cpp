@@ -0,0 +1,155 @@
+#include "Lz4Filter.hpp"
+#include <lz4frame.h>
+#include <string.h>
+
+namespace
+{
+	// input is compressed this much at a time, which bounds the size of the pending output
+	const size_t MAX_INPUT_SIZE( 64 * 1024 );
+
+	size_t Check( size_t i_Result, const std::string& i_rOperation )
+	{
+		if( ::LZ4F_isError( i_Result ) )
+		{
+			MV_THROW( Lz4Exception, "Error during " << i_rOperation << ": " << ::LZ4F_getErrorName( i_Result ) );
+		}
+		return i_Result;
+	}
+
+	LZ4F_preferences_t GetPreferences( int i_Level )
+	{
+		LZ4F_preferences_t result;
+		::memset( &result, 0, sizeof( result ) );
+		result.compressionLevel = i_Level;
+		result.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+		return result;
+	}
+}
+
+Lz4CompressorImpl::Lz4CompressorImpl( int i_Level )
+:	m_pContext( NULL ),
+	m_Level( i_Level ),
+	m_Begun( false ),
+	m_Ended( false ),
+	m_Pending(),
+	m_PendingOffset( 0 )
+{
+	Check( ::LZ4F_createCompressionContext( &m_pContext, LZ4F_VERSION ), "lz4 initialization" );
+}
+
+Lz4CompressorImpl::~Lz4CompressorImpl()
+{
+	::LZ4F_freeCompressionContext( m_pContext );
+}
+
+bool Lz4CompressorImpl::filter( const char*& io_rpSourceBegin, const char* i_pSourceEnd, char*& io_rpDestBegin, char* i_pDestEnd, bool i_Flush )
+{
+	LZ4F_preferences_t preferences = GetPreferences( m_Level );
+	if( !m_Begun )
+	{
+		m_Pending.resize( LZ4F_HEADER_SIZE_MAX );
+		m_Pending.resize( Check( ::LZ4F_compressBegin( m_pContext, &m_Pending[0], m_Pending.size(), &preferences ), "lz4 compression" ) );
+		m_PendingOffset = 0;
+		m_Begun = true;
+	}
+
+	while( true )
+	{
+		Drain( io_rpDestBegin, i_pDestEnd );
+		if( m_PendingOffset < m_Pending.size() )
+		{
+			return true;
+		}
+
+		if( io_rpSourceBegin != i_pSourceEnd )
+		{
+			size_t size = std::min( size_t( i_pSourceEnd - io_rpSourceBegin ), MAX_INPUT_SIZE );
+			m_Pending.resize( ::LZ4F_compressBound( size, &preferences ) );
+			m_Pending.resize( Check( ::LZ4F_compressUpdate( m_pContext, &m_Pending[0], m_Pending.size(), io_rpSourceBegin, size, NULL ), "lz4 compression" ) );
+			m_PendingOffset = 0;
+			io_rpSourceBegin += size;
+		}
+		else if( i_Flush && !m_Ended )
+		{
+			m_Pending.resize( ::LZ4F_compressBound( 0, &preferences ) );
+			m_Pending.resize( Check( ::LZ4F_compressEnd( m_pContext, &m_Pending[0], m_Pending.size(), NULL ), "lz4 compression" ) );
+			m_PendingOffset = 0;
+			m_Ended = true;
+		}
+		else
+		{
+			// when flushing, false means the frame is complete; otherwise it means nothing more can be done yet
+			return !i_Flush;
+		}
+	}
+}
+
+void Lz4CompressorImpl::close()
+{
+	m_Begun = false;
+	m_Ended = false;
+	m_Pending.clear();
+	m_PendingOffset = 0;
+}
+
+void Lz4CompressorImpl::Drain( char*& io_rpDestBegin, char* i_pDestEnd )
+{
+	size_t size = std::min( size_t( i_pDestEnd - io_rpDestBegin ), m_Pending.size() - m_PendingOffset );
+	::memcpy( io_rpDestBegin, m_Pending.data() + m_PendingOffset, size );
+	io_rpDestBegin += size;
+	m_PendingOffset += size;
+}
+
+Lz4DecompressorImpl::Lz4DecompressorImpl()
+:	m_pContext( NULL ),
+	m_Done( false )
+{
+	Check( ::LZ4F_createDecompressionContext( &m_pContext, LZ4F_VERSION ), "lz4 initialization" );
+}
+
+Lz4DecompressorImpl::~Lz4DecompressorImpl()
+{
+	::LZ4F_freeDecompressionContext( m_pContext );
+}
+
+bool Lz4DecompressorImpl::filter( const char*& io_rpSourceBegin, const char* i_pSourceEnd, char*& io_rpDestBegin, char* i_pDestEnd, bool i_Flush )
+{
+	if( m_Done )
+	{
+		return false;
+	}
+
+	size_t sourceSize = i_pSourceEnd - io_rpSourceBegin;
+	size_t destSize = i_pDestEnd - io_rpDestBegin;
+	size_t hint = Check( ::LZ4F_decompress( m_pContext, io_rpDestBegin, &destSize, io_rpSourceBegin, &sourceSize, NULL ), "lz4 decompression" );
+	io_rpSourceBegin += sourceSize;
+	io_rpDestBegin += destSize;
+
+	// a hint of zero means the frame is complete & all of it has been written
+	if( hint == 0 )
+	{
+		m_Done = true;
+		return false;
+	}
+	if( i_Flush && io_rpSourceBegin == i_pSourceEnd && destSize == 0 )
+	{
+		MV_THROW( Lz4Exception, "Unexpected end of lz4 data" );
+	}
+	return true;
+}
+
+void Lz4DecompressorImpl::close()
+{
+	::LZ4F_resetDecompressionContext( m_pContext );
+	m_Done = false;
+}
+
+Lz4Compressor::Lz4Compressor( int i_Level, std::streamsize i_BufferSize )
+:	boost::iostreams::symmetric_filter< Lz4CompressorImpl >( i_BufferSize, i_Level )
+{
+}
+
+Lz4Decompressor::Lz4Decompressor( std::streamsize i_BufferSize )
+:	boost::iostreams::symmetric_filter< Lz4DecompressorImpl >( i_BufferSize )
+{
+}
@@ -0,0 +1,60 @@
+#include "MeteringHandler.hpp"
+#include "ServiceMetrics.hpp"
+#include "AbstractHandler.hpp"
+#include "HTTPRequest.hpp"
+#include "HTTPResponse.hpp"
+
+namespace
+{
+	// passes everything through to the real response, noting the status & counting the bytes written
+	class MeteredResponse : public HTTPResponse
+	{
+	public:
+		MeteredResponse( HTTPResponse& i_rResponse, ServiceMetrics::Request& i_rRequest )
+		:	m_rResponse( i_rResponse ),
+			m_rRequest( i_rRequest )
+		{
+		}
+
+		virtual void SetHTTPStatusCode( int i_Status )
+		{
+			m_rRequest.SetStatus( i_Status );
+			m_rResponse.SetHTTPStatusCode( i_Status );
+		}
+
+		virtual void WriteHeader( const std::string& i_rName, const std::string& i_rValue )
+		{
+			m_rResponse.WriteHeader( i_rName, i_rValue );
+		}
+
+		virtual void WriteData( const std::string& i_rData )
+		{
+			m_rRequest.AddBytes( i_rData.size() );
+			m_rResponse.WriteData( i_rData );
+		}
+
+	private:
+		HTTPResponse& m_rResponse;
+		ServiceMetrics::Request& m_rRequest;
+	};
+}
+
+MeteringHandler::MeteringHandler( IWebService& i_rHandler, ServiceMetrics& i_rMetrics, const std::string& i_rOperation )
+:	m_rHandler( i_rHandler ),
+	m_rMetrics( i_rMetrics ),
+	m_Operation( i_rOperation )
+{
+}
+
+MeteringHandler::~MeteringHandler()
+{
+}
+
+void MeteringHandler::Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse )
+{
+	std::string name = AbstractHandler::GetName( i_rRequest );
+
+	ServiceMetrics::Request request( m_rMetrics, name, m_Operation );
+	MeteredResponse response( o_rResponse, request );
+	m_rHandler.Handle( i_rRequest, response );
+}
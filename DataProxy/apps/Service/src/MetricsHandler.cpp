@@ -0,0 +1,51 @@
+#include "MetricsHandler.hpp"
+#include "ServiceMetrics.hpp"
+#include "WebServerCommon.hpp"
+#include "HTTPRequest.hpp"
+#include "HTTPResponse.hpp"
+#include "DataProxyService.hpp"
+#include <boost/lexical_cast.hpp>
+#include <sstream>
+
+namespace
+{
+	const std::string CONTENT_TYPE( "Content-Type" );
+	const std::string CONTENT_LENGTH( "Content-Length" );
+	const std::string TEXT_PLAIN( "text/plain; version=0.0.4" );
+
+	std::string StripSlashes( const std::string& i_rPath )
+	{
+		size_t begin = ( !i_rPath.empty() && i_rPath[0] == '/' ) ? 1 : 0;
+		size_t end = ( i_rPath.size() > begin && i_rPath[ i_rPath.size() - 1 ] == '/' ) ? i_rPath.size() - 1 : i_rPath.size();
+		return i_rPath.substr( begin, end - begin );
+	}
+}
+
+MetricsHandler::MetricsHandler( ServiceMetrics& i_rMetrics, const std::string& i_rPath, IWebService& i_rLoadHandler )
+:	m_rMetrics( i_rMetrics ),
+	m_Path( StripSlashes( i_rPath ) ),
+	m_rLoadHandler( i_rLoadHandler )
+{
+}
+
+MetricsHandler::~MetricsHandler()
+{
+}
+
+void MetricsHandler::Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse )
+{
+	if( StripSlashes( i_rRequest.GetPath() ) != m_Path )
+	{
+		m_rLoadHandler.Handle( i_rRequest, o_rResponse );
+		return;
+	}
+
+	std::stringstream metrics;
+	m_rMetrics.Write( metrics );
+
+	o_rResponse.SetHTTPStatusCode( HTTP_STATUS_OK );
+	o_rResponse.WriteHeader( SERVER, DATA_PROXY_SERVICE_VERSION );
+	o_rResponse.WriteHeader( CONTENT_TYPE, TEXT_PLAIN );
+	o_rResponse.WriteHeader( CONTENT_LENGTH, boost::lexical_cast< std::string >( metrics.str().size() ) );
+	o_rResponse.WriteData( metrics.str() );
+}
@@ -0,0 +1,258 @@
+#include "ParallelGzipCompressor.hpp"
+#include <boost/bind.hpp>
+#include <zlib.h>
+
+namespace
+{
+	// no file name, comment or modification time; os: unix
+	const unsigned char GZIP_HEADER[] = { 0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0, 0, 3 };
+
+	// raw deflate: the gzip header & trailer are written by the compressor rather than by zlib
+	const int RAW_WINDOW_BITS( -MAX_WBITS );
+	const int MEM_LEVEL( 8 );
+
+	// a sync flush may add an empty stored block on top of the deflate bound
+	const size_t FLUSH_OVERHEAD( 16 );
+
+	void AppendLittleEndian( std::string& o_rData, unsigned long i_Value )
+	{
+		for( int i = 0; i < 4; ++i )
+		{
+			o_rData.push_back( char( ( i_Value >> ( 8 * i ) ) & 0xff ) );
+		}
+	}
+}
+
+GzipBlockPool::GzipBlockPool( size_t i_NumThreads )
+:	m_Mutex(),
+	m_BlockSubmitted(),
+	m_BlockCompleted(),
+	m_Queue(),
+	m_Stopping( false ),
+	m_Threads()
+{
+	if( i_NumThreads == 0 )
+	{
+		MV_THROW( ParallelGzipException, "Number of threads must be positive" );
+	}
+	for( size_t i = 0; i < i_NumThreads; ++i )
+	{
+		m_Threads.create_thread( boost::bind( &GzipBlockPool::Run, this ) );
+	}
+}
+
+GzipBlockPool::~GzipBlockPool()
+{
+	{
+		boost::unique_lock< boost::mutex > lock( m_Mutex );
+		m_Stopping = true;
+	}
+	m_BlockSubmitted.notify_all();
+	m_Threads.join_all();
+}
+
+size_t GzipBlockPool::GetNumThreads() const
+{
+	return m_Threads.size();
+}
+
+void GzipBlockPool::Submit( boost::shared_ptr< Block > i_pBlock )
+{
+	{
+		boost::unique_lock< boost::mutex > lock( m_Mutex );
+		i_pBlock->m_Complete = false;
+		m_Queue.push_back( i_pBlock );
+	}
+	m_BlockSubmitted.notify_one();
+}
+
+bool GzipBlockPool::IsComplete( const Block& i_rBlock )
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	return i_rBlock.m_Complete;
+}
+
+void GzipBlockPool::Wait( const Block& i_rBlock )
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	while( !i_rBlock.m_Complete )
+	{
+		m_BlockCompleted.wait( lock );
+	}
+}
+
+void GzipBlockPool::Run()
+{
+	while( true )
+	{
+		boost::shared_ptr< Block > pBlock;
+		{
+			boost::unique_lock< boost::mutex > lock( m_Mutex );
+			while( m_Queue.empty() && !m_Stopping )
+			{
+				m_BlockSubmitted.wait( lock );
+			}
+			if( m_Queue.empty() )
+			{
+				return;
+			}
+			pBlock = m_Queue.front();
+			m_Queue.pop_front();
+		}
+
+		Deflate( *pBlock );
+
+		{
+			boost::unique_lock< boost::mutex > lock( m_Mutex );
+			pBlock->m_Complete = true;
+		}
+		m_BlockCompleted.notify_all();
+	}
+}
+
+void GzipBlockPool::Deflate( Block& io_rBlock )
+{
+	io_rBlock.m_InputSize = io_rBlock.m_Input.size();
+	io_rBlock.m_Crc = ::crc32( ::crc32( 0L, Z_NULL, 0 ), reinterpret_cast< const Bytef* >( io_rBlock.m_Input.data() ), io_rBlock.m_Input.size() );
+
+	z_stream stream;
+	stream.zalloc = Z_NULL;
+	stream.zfree = Z_NULL;
+	stream.opaque = Z_NULL;
+	if( ::deflateInit2( &stream, io_rBlock.m_Level, Z_DEFLATED, RAW_WINDOW_BITS, MEM_LEVEL, Z_DEFAULT_STRATEGY ) != Z_OK )
+	{
+		io_rBlock.m_Error = "Unable to initialize deflate stream";
+		return;
+	}
+
+	io_rBlock.m_Output.resize( ::deflateBound( &stream, io_rBlock.m_Input.size() ) + FLUSH_OVERHEAD );
+	stream.next_in = reinterpret_cast< Bytef* >( const_cast< char* >( io_rBlock.m_Input.data() ) );
+	stream.avail_in = io_rBlock.m_Input.size();
+	int flush = io_rBlock.m_Final ? Z_FINISH : Z_SYNC_FLUSH;
+	while( true )
+	{
+		stream.next_out = reinterpret_cast< Bytef* >( &io_rBlock.m_Output[ stream.total_out ] );
+		stream.avail_out = io_rBlock.m_Output.size() - stream.total_out;
+		int result = ::deflate( &stream, flush );
+		if( result == Z_STREAM_ERROR )
+		{
+			io_rBlock.m_Error = "Error deflating block";
+			break;
+		}
+		// the flush is complete when zlib stops short of filling the output
+		if( result == Z_STREAM_END || ( !io_rBlock.m_Final && stream.avail_out > 0 ) )
+		{
+			break;
+		}
+		io_rBlock.m_Output.resize( io_rBlock.m_Output.size() * 2 );
+	}
+	io_rBlock.m_Output.resize( stream.total_out );
+	::deflateEnd( &stream );
+
+	std::string().swap( io_rBlock.m_Input );
+}
+
+ParallelGzipCompressor::ParallelGzipCompressor( GzipBlockPool& i_rPool, int i_Level, size_t i_BlockSize )
+:	m_pState( new State( i_rPool, i_Level, i_BlockSize ) )
+{
+}
+
+ParallelGzipCompressor::State::State( GzipBlockPool& i_rPool, int i_Level, size_t i_BlockSize )
+:	m_Output(),
+	m_rPool( i_rPool ),
+	m_Level( i_Level ),
+	m_BlockSize( i_BlockSize ),
+	// enough to keep every thread busy, without holding the whole stream in memory
+	m_MaxPending( 2 * i_rPool.GetNumThreads() ),
+	m_Input(),
+	m_Pending(),
+	m_HeaderWritten( false ),
+	m_Crc( 0 ),
+	m_Size( 0 )
+{
+	if( m_BlockSize == 0 )
+	{
+		MV_THROW( ParallelGzipException, "Block size must be positive" );
+	}
+	Reset();
+}
+
+void ParallelGzipCompressor::State::Write( const char* i_pData, std::streamsize i_Size )
+{
+	while( i_Size > 0 )
+	{
+		size_t size = std::min( size_t( i_Size ), m_BlockSize - m_Input.size() );
+		m_Input.append( i_pData, size );
+		i_pData += size;
+		i_Size -= size;
+		if( m_Input.size() == m_BlockSize )
+		{
+			Submit( false );
+			Collect( false );
+		}
+	}
+}
+
+void ParallelGzipCompressor::State::Finish()
+{
+	Submit( true );
+	Collect( true );
+	AppendLittleEndian( m_Output, m_Crc );
+	AppendLittleEndian( m_Output, m_Size );
+	Reset();
+}
+
+void ParallelGzipCompressor::State::Submit( bool i_Final )
+{
+	boost::shared_ptr< GzipBlockPool::Block > pBlock( new GzipBlockPool::Block() );
+	pBlock->m_Input.swap( m_Input );
+	pBlock->m_InputSize = 0;
+	pBlock->m_Crc = 0;
+	pBlock->m_Level = m_Level;
+	pBlock->m_Final = i_Final;
+	pBlock->m_Complete = false;
+	m_Input.reserve( m_BlockSize );
+	m_rPool.Submit( pBlock );
+	m_Pending.push_back( pBlock );
+}
+
+void ParallelGzipCompressor::State::Collect( bool i_All )
+{
+	while( !m_Pending.empty() )
+	{
+		GzipBlockPool::Block& rBlock = *m_Pending.front();
+
+		// past the limit, wait for the oldest block rather than queue up more
+		if( !i_All && m_Pending.size() <= m_MaxPending && !m_rPool.IsComplete( rBlock ) )
+		{
+			break;
+		}
+		m_rPool.Wait( rBlock );
+		if( !rBlock.m_Error.empty() )
+		{
+			std::string error = rBlock.m_Error;
+			m_Pending.clear();
+			MV_THROW( ParallelGzipException, error );
+		}
+
+		if( !m_HeaderWritten )
+		{
+			m_Output.append( reinterpret_cast< const char* >( GZIP_HEADER ), sizeof( GZIP_HEADER ) );
+			m_HeaderWritten = true;
+		}
+		m_Output += rBlock.m_Output;
+		m_Crc = ::crc32_combine( m_Crc, rBlock.m_Crc, rBlock.m_InputSize );
+		m_Size += rBlock.m_InputSize;
+		m_Pending.pop_front();
+	}
+}
+
+void ParallelGzipCompressor::State::Reset()
+{
+	m_Input.clear();
+	m_Input.reserve( m_BlockSize );
+	m_Pending.clear();
+	m_HeaderWritten = false;
+	m_Crc = ::crc32( 0L, Z_NULL, 0 );
+	m_Size = 0;
+}
@@ -24,8 +24,8 @@ namespace
 	const std::string MODE_DEFAULT( "x" );
 }
 
-PingHandler::PingHandler( DataProxyClient& i_rDataProxyClient, const std::string& i_rDplConfig )
-:	AbstractHandler( i_rDataProxyClient, i_rDplConfig, false )
+PingHandler::PingHandler( DataProxyClient& i_rDataProxyClient )
+:	AbstractHandler( i_rDataProxyClient, false )
 {
 }
 
@@ -35,11 +35,6 @@ PingHandler::~PingHandler()
 
 void PingHandler::Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse )
 {
-	if( !CheckConfig( o_rResponse ) )
-	{
-		return;
-	}
-
 	std::string name = GetName( i_rRequest );
 	int mode = 0;
 
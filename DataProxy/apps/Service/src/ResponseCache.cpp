@@ -0,0 +1,135 @@
+#include "ResponseCache.hpp"
+#include "detail/ClockUtilities.hpp"
+
+ResponseCache::ResponseCache( double i_TimeToLiveSeconds, size_t i_MaxBytes )
+:	m_TimeToLive( i_TimeToLiveSeconds ),
+	m_MaxBytes( i_MaxBytes ),
+	m_Mutex(),
+	m_Entries(),
+	m_Generation( 0 )
+{
+}
+
+ResponseCache::~ResponseCache()
+{
+}
+
+boost::shared_ptr< const ResponseCache::Response > ResponseCache::Get( const std::string& i_rKey )
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	EntryCache::Iterator iter = m_Entries.Find( i_rKey );
+	if( iter == m_Entries.End() )
+	{
+		return boost::shared_ptr< const Response >();
+	}
+	if( iter->m_Expiration <= ClockUtilities::Now() )
+	{
+		m_Entries.Remove( iter );
+		return boost::shared_ptr< const Response >();
+	}
+	m_Entries.Touch( iter );
+	return iter->m_Value;
+}
+
+void ResponseCache::Put( const std::string& i_rKey, boost::shared_ptr< const Response > i_pResponse )
+{
+	Put( i_rKey, i_pResponse, GetGeneration() );
+}
+
+void ResponseCache::Put( const std::string& i_rKey, boost::shared_ptr< const Response > i_pResponse, size_t i_Generation )
+{
+	size_t size = GetSize( i_rKey, *i_pResponse );
+	if( size > m_MaxBytes )
+	{
+		return;
+	}
+
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	if( i_Generation != m_Generation )
+	{
+		return;
+	}
+	m_Entries.Insert( i_rKey, i_pResponse, size, ClockUtilities::Now() + m_TimeToLive );
+	while( m_Entries.GetBytes() > m_MaxBytes )
+	{
+		m_Entries.Remove( m_Entries.GetOldest() );
+	}
+}
+
+size_t ResponseCache::GetBytes() const
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	return m_Entries.GetBytes();
+}
+
+void ResponseCache::Invalidate( const std::string& i_rName )
+{
+	std::string prefix = MakeKeyPrefix( i_rName );
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	++m_Generation;
+	EntryCache::Iterator iter = m_Entries.Begin();
+	while( iter != m_Entries.End() )
+	{
+		EntryCache::Iterator current = iter++;
+		if( current->m_Key.compare( 0, prefix.size(), prefix ) == 0 )
+		{
+			m_Entries.Remove( current );
+		}
+	}
+}
+
+void ResponseCache::Clear()
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	++m_Generation;
+	while( m_Entries.Begin() != m_Entries.End() )
+	{
+		m_Entries.Remove( m_Entries.Begin() );
+	}
+}
+
+size_t ResponseCache::GetGeneration() const
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	return m_Generation;
+}
+
+std::string ResponseCache::MakeKey( const std::string& i_rName, const std::map< std::string, std::string >& i_rParameters, const std::string& i_rEncoding )
+{
+	std::string result = MakeKeyPrefix( i_rName );
+	EntryCache::AppendKeyField( result, i_rEncoding );
+	std::map< std::string, std::string >::const_iterator iter = i_rParameters.begin();
+	for( ; iter != i_rParameters.end(); ++iter )
+	{
+		EntryCache::AppendKeyField( result, iter->first );
+		EntryCache::AppendKeyField( result, iter->second );
+	}
+	return result;
+}
+
+size_t ResponseCache::GetSize( const std::string& i_rKey, const Response& i_rResponse )
+{
+	return i_rKey.size() + i_rResponse.m_Data.size() + i_rResponse.m_ETag.size();
+}
+
+std::string ResponseCache::MakeKeyPrefix( const std::string& i_rName )
+{
+	// the name is length-prefixed, so no other node's keys can start with the same prefix
+	std::string result;
+	EntryCache::AppendKeyField( result, i_rName );
+	return result;
+}
+
+ResponseCache::ScopedInvalidation::ScopedInvalidation( ResponseCache* i_pCache, const std::string& i_rName )
+:	m_pCache( i_pCache ),
+	m_Name( i_rName )
+{
+}
+
+ResponseCache::ScopedInvalidation::~ScopedInvalidation()
+{
+	if( m_pCache != NULL )
+	{
+		m_pCache->Invalidate( m_Name );
+	}
+}
@@ -0,0 +1,297 @@
+#include "ServiceMetrics.hpp"
+#include "detail/ClockUtilities.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+	const double QUANTILES[] = { 0.5, 0.9, 0.99 };
+	const char* QUANTILE_LABELS[] = { "0.5", "0.9", "0.99" };
+
+	// i_Start is a ClockUtilities::Now(); the monotonic clock keeps latencies right when the system time is set
+	boost::uint64_t MicrosSince( double i_Start )
+	{
+		double result = ( ClockUtilities::Now() - i_Start ) * 1e6;
+		return result > 0 ? boost::uint64_t( result ) : 0;
+	}
+
+	double Seconds( boost::uint64_t i_Micros )
+	{
+		return i_Micros / 1e6;
+	}
+
+	// label values are quoted; node names come from clients, so anything that would end the quote is escaped
+	std::string Escape( const std::string& i_rValue )
+	{
+		std::string result;
+		for( std::string::const_iterator iter = i_rValue.begin(); iter != i_rValue.end(); ++iter )
+		{
+			if( *iter == '\\' || *iter == '"' )
+			{
+				result += '\\';
+				result += *iter;
+			}
+			else if( *iter == '\n' )
+			{
+				result += "\\n";
+			}
+			else
+			{
+				result += *iter;
+			}
+		}
+		return result;
+	}
+
+	std::string Labels( const std::string& i_rNode, const std::string& i_rOperation )
+	{
+		return "node=\"" + Escape( i_rNode ) + "\",operation=\"" + Escape( i_rOperation ) + "\"";
+	}
+}
+
+const std::string ServiceMetrics::OTHER_NODES( "__other" );
+
+LatencyHistogram::LatencyHistogram()
+:	m_Count( 0 ),
+	m_Sum( 0 ),
+	m_Max( 0 )
+{
+	for( size_t i = 0; i < NUM_BUCKETS; ++i )
+	{
+		m_Buckets[i] = 0;
+	}
+}
+
+size_t LatencyHistogram::GetBucket( boost::uint64_t i_Micros )
+{
+	if( i_Micros < 4 )
+	{
+		return size_t( i_Micros );
+	}
+	// the top two bits below the leading one pick the quarter
+	int exponent = 63 - __builtin_clzll( i_Micros );
+	return 4 * ( exponent - 1 ) + size_t( ( i_Micros >> ( exponent - 2 ) ) & 3 );
+}
+
+boost::uint64_t LatencyHistogram::GetBucketLimit( size_t i_Bucket )
+{
+	if( i_Bucket < 4 )
+	{
+		return i_Bucket;
+	}
+	int exponent = int( i_Bucket / 4 ) + 1;
+	boost::uint64_t width = boost::uint64_t( 1 ) << ( exponent - 2 );
+	return ( 4 + i_Bucket % 4 ) * width + width - 1;
+}
+
+void LatencyHistogram::Record( boost::uint64_t i_Micros )
+{
+	m_Buckets[ GetBucket( i_Micros ) ].fetch_add( 1, boost::memory_order_relaxed );
+	m_Count.fetch_add( 1, boost::memory_order_relaxed );
+	m_Sum.fetch_add( i_Micros, boost::memory_order_relaxed );
+	boost::uint64_t max = m_Max.load( boost::memory_order_relaxed );
+	while( i_Micros > max && !m_Max.compare_exchange_weak( max, i_Micros, boost::memory_order_relaxed ) )
+	{
+	}
+}
+
+boost::uint64_t LatencyHistogram::GetCount() const
+{
+	return m_Count.load( boost::memory_order_relaxed );
+}
+
+boost::uint64_t LatencyHistogram::GetSum() const
+{
+	return m_Sum.load( boost::memory_order_relaxed );
+}
+
+boost::uint64_t LatencyHistogram::GetMax() const
+{
+	return m_Max.load( boost::memory_order_relaxed );
+}
+
+boost::uint64_t LatencyHistogram::GetQuantile( double i_Quantile ) const
+{
+	// the buckets may move on while they are read, so the total is taken from them rather than from m_Count
+	boost::uint64_t counts[ NUM_BUCKETS ];
+	boost::uint64_t total( 0 );
+	for( size_t i = 0; i < NUM_BUCKETS; ++i )
+	{
+		counts[i] = m_Buckets[i].load( boost::memory_order_relaxed );
+		total += counts[i];
+	}
+	if( total == 0 )
+	{
+		return 0;
+	}
+
+	boost::uint64_t rank = boost::uint64_t( i_Quantile * total );
+	if( rank >= total )
+	{
+		rank = total - 1;
+	}
+	boost::uint64_t seen( 0 );
+	for( size_t i = 0; i < NUM_BUCKETS; ++i )
+	{
+		seen += counts[i];
+		if( seen > rank )
+		{
+			return std::min( GetBucketLimit( i ), GetMax() );
+		}
+	}
+	return GetMax();
+}
+
+ServiceMetrics::ServiceMetrics( size_t i_MaxNodes )
+:	m_MaxNodes( i_MaxNodes ),
+	m_Start( ClockUtilities::Now() ),
+	m_Mutex(),
+	m_Metrics(),
+	m_OtherNodeMetrics(),
+	m_Nodes()
+{
+}
+
+ServiceMetrics::~ServiceMetrics()
+{
+}
+
+boost::shared_ptr< ServiceMetrics::Metrics > ServiceMetrics::GetMetrics( const std::string& i_rNode, const std::string& i_rOperation )
+{
+	{
+		// nodes past the limit are found under OTHER_NODES here too, so they don't all take the exclusive lock
+		boost::shared_lock< boost::shared_mutex > lock( m_Mutex );
+		if( IsOtherNode( i_rNode ) )
+		{
+			OperationMetricsMap::const_iterator iter = m_OtherNodeMetrics.find( i_rOperation );
+			if( iter != m_OtherNodeMetrics.end() )
+			{
+				return iter->second;
+			}
+		}
+		else
+		{
+			MetricsMap::const_iterator iter = m_Metrics.find( std::make_pair( i_rNode, i_rOperation ) );
+			if( iter != m_Metrics.end() )
+			{
+				return iter->second;
+			}
+		}
+	}
+
+	boost::unique_lock< boost::shared_mutex > lock( m_Mutex );
+	bool otherNode = IsOtherNode( i_rNode );
+	boost::shared_ptr< Metrics >& rpMetrics = otherNode ? m_OtherNodeMetrics[ i_rOperation ] : m_Metrics[ std::make_pair( i_rNode, i_rOperation ) ];
+	if( !rpMetrics )
+	{
+		rpMetrics.reset( new Metrics() );
+		rpMetrics->m_InFlight = 0;
+		rpMetrics->m_Requests = 0;
+		rpMetrics->m_Errors = 0;
+		rpMetrics->m_Bytes = 0;
+		if( !otherNode )
+		{
+			++m_Nodes[ i_rNode ];
+		}
+	}
+	return rpMetrics;
+}
+
+bool ServiceMetrics::IsOtherNode( const std::string& i_rNode ) const
+{
+	return i_rNode == OTHER_NODES || ( m_Nodes.find( i_rNode ) == m_Nodes.end() && m_Nodes.size() >= m_MaxNodes );
+}
+
+ServiceMetrics::Request::Request( ServiceMetrics& i_rMetrics, const std::string& i_rNode, const std::string& i_rOperation )
+:	m_pMetrics( i_rMetrics.GetMetrics( i_rNode, i_rOperation ) ),
+	m_Start( ClockUtilities::Now() ),
+	m_Status( 0 ),
+	m_Bytes( 0 )
+{
+	m_pMetrics->m_InFlight.fetch_add( 1, boost::memory_order_relaxed );
+}
+
+ServiceMetrics::Request::~Request()
+{
+	m_pMetrics->m_Latency.Record( MicrosSince( m_Start ) );
+	m_pMetrics->m_Requests.fetch_add( 1, boost::memory_order_relaxed );
+	if( m_Status == 0 || m_Status >= 400 )
+	{
+		m_pMetrics->m_Errors.fetch_add( 1, boost::memory_order_relaxed );
+	}
+	m_pMetrics->m_Bytes.fetch_add( m_Bytes, boost::memory_order_relaxed );
+	m_pMetrics->m_InFlight.fetch_sub( 1, boost::memory_order_relaxed );
+}
+
+void ServiceMetrics::Request::SetStatus( int i_Status )
+{
+	m_Status = i_Status;
+}
+
+void ServiceMetrics::Request::AddBytes( size_t i_Bytes )
+{
+	m_Bytes += i_Bytes;
+}
+
+void ServiceMetrics::Write( std::ostream& o_rOutput ) const
+{
+	// counters are totals since the service started; rates are the difference between two scrapes
+	std::stringstream requests;
+	std::stringstream errors;
+	std::stringstream bytes;
+	std::stringstream inFlight;
+	std::stringstream latency;
+	std::stringstream latencyMax;
+	requests << "# TYPE dataproxy_requests_total counter\n";
+	errors << "# TYPE dataproxy_errors_total counter\n";
+	bytes << "# TYPE dataproxy_response_bytes_total counter\n";
+	inFlight << "# TYPE dataproxy_requests_in_flight gauge\n";
+	latency << "# TYPE dataproxy_latency_seconds summary\n";
+	latencyMax << "# TYPE dataproxy_latency_seconds_max gauge\n";
+	latency << std::fixed << std::setprecision( 6 );
+	latencyMax << std::fixed << std::setprecision( 6 );
+
+	// the metrics themselves are atomic, so they are read without holding the lock
+	std::vector< std::pair< std::string, boost::shared_ptr< Metrics > > > series;
+	{
+		boost::shared_lock< boost::shared_mutex > lock( m_Mutex );
+		MetricsMap::const_iterator iter = m_Metrics.begin();
+		for( ; iter != m_Metrics.end(); ++iter )
+		{
+			series.push_back( std::make_pair( Labels( iter->first.first, iter->first.second ), iter->second ) );
+		}
+		OperationMetricsMap::const_iterator otherIter = m_OtherNodeMetrics.begin();
+		for( ; otherIter != m_OtherNodeMetrics.end(); ++otherIter )
+		{
+			series.push_back( std::make_pair( Labels( OTHER_NODES, otherIter->first ), otherIter->second ) );
+		}
+	}
+
+	std::vector< std::pair< std::string, boost::shared_ptr< Metrics > > >::const_iterator iter = series.begin();
+	for( ; iter != series.end(); ++iter )
+	{
+		const std::string& labels = iter->first;
+		const Metrics& rMetrics = *iter->second;
+
+		requests << "dataproxy_requests_total{" << labels << "} " << rMetrics.m_Requests.load() << "\n";
+		errors << "dataproxy_errors_total{" << labels << "} " << rMetrics.m_Errors.load() << "\n";
+		bytes << "dataproxy_response_bytes_total{" << labels << "} " << rMetrics.m_Bytes.load() << "\n";
+		inFlight << "dataproxy_requests_in_flight{" << labels << "} " << rMetrics.m_InFlight.load() << "\n";
+		for( size_t i = 0; i < sizeof( QUANTILES ) / sizeof( QUANTILES[0] ); ++i )
+		{
+			latency << "dataproxy_latency_seconds{" << labels << ",quantile=\"" << QUANTILE_LABELS[i] << "\"} "
+					<< Seconds( rMetrics.m_Latency.GetQuantile( QUANTILES[i] ) ) << "\n";
+		}
+		latency << "dataproxy_latency_seconds_sum{" << labels << "} " << Seconds( rMetrics.m_Latency.GetSum() ) << "\n";
+		latency << "dataproxy_latency_seconds_count{" << labels << "} " << rMetrics.m_Latency.GetCount() << "\n";
+		latencyMax << "dataproxy_latency_seconds_max{" << labels << "} " << Seconds( rMetrics.m_Latency.GetMax() ) << "\n";
+	}
+
+	std::stringstream uptime;
+	uptime << "# TYPE dataproxy_uptime_seconds gauge\n"
+		   << "dataproxy_uptime_seconds " << std::fixed << std::setprecision( 3 ) << Seconds( MicrosSince( m_Start ) ) << "\n";
+
+	o_rOutput << uptime.str() << requests.str() << errors.str() << bytes.str() << inFlight.str() << latency.str() << latencyMax.str();
+}
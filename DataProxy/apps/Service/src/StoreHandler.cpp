@@ -16,9 +16,63 @@
 #include "HTTPRequest.hpp"
 #include "HTTPResponse.hpp"
 #include "DataProxyService.hpp"
+#include "Lz4Filter.hpp"
+#include "ResponseCache.hpp"
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/zstd.hpp>
+#include <boost/iostreams/operations.hpp>
 
-StoreHandler::StoreHandler( DataProxyClient& i_rDataProxyClient, const std::string& i_rDplConfig, bool i_EnableXForwardedFor )
-:	AbstractHandler( i_rDataProxyClient, i_rDplConfig, i_EnableXForwardedFor )
+namespace
+{
+	const std::string CONTENT_ENCODING( "Content-Encoding" );
+	const std::string IDENTITY( "identity" );
+	const std::string GZIP( "gzip" );
+	const std::string ZSTD( "zstd" );
+	const std::string LZ4( "lz4" );
+	const int REQUEST_ENTITY_TOO_LARGE_STATUS( 413 );
+
+	// fails the read once more than the given number of bytes have been decoded, so a small body can't decode
+	// into an unbounded amount of data
+	class DecodedSizeLimit
+	{
+	public:
+		typedef char char_type;
+		typedef boost::iostreams::multichar_input_filter_tag category;
+
+		DecodedSizeLimit( size_t i_MaxSize, bool& o_rExceeded )
+		:	m_MaxSize( i_MaxSize ),
+			m_Size( 0 ),
+			m_pExceeded( &o_rExceeded )
+		{
+		}
+
+		template< typename Source >
+		std::streamsize read( Source& i_rSource, char* o_pData, std::streamsize i_Size )
+		{
+			std::streamsize result = boost::iostreams::read( i_rSource, o_pData, i_Size );
+			if( result > 0 )
+			{
+				m_Size += result;
+				if( m_Size > m_MaxSize )
+				{
+					*m_pExceeded = true;
+					MV_THROW( StoreHandlerException, "Decoded request body exceeds the limit of " << m_MaxSize << " bytes" );
+				}
+			}
+			return result;
+		}
+
+	private:
+		size_t m_MaxSize;
+		size_t m_Size;
+		bool* m_pExceeded;
+	};
+}
+
+StoreHandler::StoreHandler( DataProxyClient& i_rDataProxyClient, bool i_EnableXForwardedFor, size_t i_MaxDecodedBodySize, ResponseCache* i_pResponseCache )
+:	AbstractHandler( i_rDataProxyClient, i_EnableXForwardedFor ),
+	m_MaxDecodedBodySize( i_MaxDecodedBodySize ),
+	m_pResponseCache( i_pResponseCache )
 {
 }
 
@@ -28,25 +82,55 @@ StoreHandler::~StoreHandler()
 
 void StoreHandler::Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse )
 {
-	if( !AbstractHandler::CheckConfig( o_rResponse ) )
-	{
-		return;
-	}
-
 	std::map< std::string, std::string > parameters;
 	std::string name;
 	AbstractHandler::GetParams( i_rRequest, name, parameters ); 
+
+	std::string encoding;
+	Nullable< std::string > contentEncoding = i_rRequest.GetHeaderEntry( CONTENT_ENCODING );
+	if( !contentEncoding.IsNull() )
+	{
+		encoding = static_cast< std::string& >( contentEncoding );
+	}
 	
+	bool tooLarge = false;
 	try
 	{
-		AbstractHandler::GetDataProxyClient().Store( name, parameters, i_rRequest.GetPostData() );
+		ResponseCache::ScopedInvalidation invalidation( m_pResponseCache, name );
+		if( encoding.empty() || encoding == IDENTITY )
+		{
+			AbstractHandler::GetDataProxyClient().Store( name, parameters, i_rRequest.GetPostData() );
+		}
+		else
+		{
+			// the body is decoded as the node reads it, up to the decoded size limit. the decoded stream can't be
+			// rewound, so a node that may rewind it (e.g. to retry) spools it as it reads, spilling to disk past the
+			// memoryLimit of its Write Staging element
+			boost::iostreams::filtering_istream decoded;
+			decoded.push( DecodedSizeLimit( m_MaxDecodedBodySize, tooLarge ) );
+			PushDecompressor( encoding, decoded );
+			decoded.push( i_rRequest.GetPostData() );
+			// a body that fails to decode throws through the node's Store, so nothing it read is committed
+			decoded.exceptions( std::ios_base::badbit );
+			AbstractHandler::GetDataProxyClient().Store( name, parameters, decoded );
+
+			// in case a node read the body without noticing the failure
+			if( tooLarge )
+			{
+				MV_THROW( StoreHandlerException, "Decoded request body exceeds the limit of " << m_MaxDecodedBodySize << " bytes" );
+			}
+			if( decoded.bad() )
+			{
+				MV_THROW( StoreHandlerException, "Error decoding request body with " << CONTENT_ENCODING << ": " << encoding );
+			}
+		}
 	}
 	catch( const std::exception& i_rEx )
 	{
 		std::stringstream msg;
 		msg << "Error storing data to node: " << name << ": " << i_rEx.what();
 		MVLOGGER( "root.lib.DataProxy.Service.StoreHandler.ErrorStoring", msg.str() );
-		o_rResponse.SetHTTPStatusCode( HTTP_STATUS_INTERNAL_SERVER_ERROR );
+		o_rResponse.SetHTTPStatusCode( tooLarge ? REQUEST_ENTITY_TOO_LARGE_STATUS : HTTP_STATUS_INTERNAL_SERVER_ERROR );
 		o_rResponse.WriteHeader( SERVER, DATA_PROXY_SERVICE_VERSION );
 		o_rResponse.WriteData( msg.str() + "\n" );
 		return;
@@ -56,3 +140,24 @@ void StoreHandler::Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse )
 	o_rResponse.WriteHeader( SERVER, DATA_PROXY_SERVICE_VERSION );
 	o_rResponse.WriteData("");
 }
+
+void StoreHandler::PushDecompressor( const std::string& i_rEncoding, boost::iostreams::filtering_istream& o_rFilter ) const
+{
+	if( i_rEncoding == GZIP )
+	{
+		o_rFilter.push( boost::iostreams::gzip_decompressor() );
+	}
+	else if( i_rEncoding == ZSTD )
+	{
+		o_rFilter.push( boost::iostreams::zstd_decompressor() );
+	}
+	else if( i_rEncoding == LZ4 )
+	{
+		o_rFilter.push( Lz4Decompressor() );
+	}
+	else
+	{
+		MV_THROW( StoreHandlerException, "Unsupported " << CONTENT_ENCODING << ": " << i_rEncoding );
+	}
+	MVLOGGER( "root.lib.DataProxy.Service.StoreHandler.UsingDecompression", "Decoding request body with " << CONTENT_ENCODING << ": " << i_rEncoding );
+}
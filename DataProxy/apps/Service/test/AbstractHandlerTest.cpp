@@ -59,37 +59,6 @@ void AbstractHandlerTest::tearDown()
 	m_pTempDir.reset( NULL );
 }
 
-void AbstractHandlerTest::testCheckConfig()
-{
-	DataProxyClient client;
-	MockHTTPResponse response;
-
-	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
-
-	TestableHandler handler( client, dplConfigFileSpec, false );
-	
-	// error condition #1: initialization fails because the file doesn't exist
-	CPPUNIT_ASSERT_NO_THROW( CPPUNIT_ASSERT( !handler.CallCheckConfig( response ) ) );
-	std::stringstream expected;
-	expected << "SetHTTPStatusCode called with Code: 500 Message: " << std::endl
-			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
-			 << "WriteData called with Data: Error initializing DPL with file: " << dplConfigFileSpec << ": private/DataProxyClient.cpp:\\d+: Cannot find config file.*";
-	CPPUNIT_ASSERT( boost::regex_match( response.GetLog(), boost::regex( expected.str() ) ) );
-
-	// now create file
-	std::ofstream file( dplConfigFileSpec.c_str() );
-	file << "<DplConfig>" << std::endl
-		 << "  <DataNode name=\"n1\" type=\"local\" location=\"" << m_pTempDir->GetDirectoryName() << "\" />" << std::endl
-		 << "</DplConfig>" << std::endl;
-	file.close();
-
-	// successful config 
-	response.ClearLog();
-	expected.str("");
-	CPPUNIT_ASSERT_NO_THROW( CPPUNIT_ASSERT( handler.CallCheckConfig( response ) ) );
-	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
-}
-
 void AbstractHandlerTest::testGetParams()
 {
 	DataProxyClient client;
@@ -111,7 +80,7 @@ void AbstractHandlerTest::testGetParams()
 	file.close();
 
 	boost::scoped_ptr< TestableHandler > pHandler;
-	pHandler.reset( new TestableHandler( client, dplConfigFileSpec, false ) );
+	pHandler.reset( new TestableHandler( client, false ) );
 
 	// Case 1: GetParams should strip the trailing slash
 	std::string name;
@@ -121,7 +90,7 @@ void AbstractHandlerTest::testGetParams()
 	CPPUNIT_ASSERT( params.empty() );
 
 	// Case 2: test that XForwardedFor in the request is added to the parameters
-	pHandler.reset( new TestableHandler( client, dplConfigFileSpec, true ) );
+	pHandler.reset( new TestableHandler( client, true ) );
 	params[ "param1" ] = "VALUE1";
 	params[ "PARAM2" ] = "value2";
 	params[ "param3" ] = "VALUE3";
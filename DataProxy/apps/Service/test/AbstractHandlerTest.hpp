@@ -24,7 +24,6 @@ class AbstractHandlerTest : public CppUnit::TestFixture
 private:
 
 	CPPUNIT_TEST_SUITE(AbstractHandlerTest);
-	CPPUNIT_TEST(testCheckConfig);
 	CPPUNIT_TEST(testGetParams);
 	CPPUNIT_TEST_SUITE_END();
 
@@ -36,7 +35,6 @@ public:
 	void setUp();
 	void tearDown();
 
-	void testCheckConfig();
 	void testGetParams();
 
 private:
@@ -0,0 +1,256 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#include "AdmissionControllerTest.hpp"
+#include "AdmissionController.hpp"
+#include "TempDirectory.hpp"
+#include "AssertThrowWithMessage.hpp"
+#include "Stopwatch.hpp"
+#include "XMLUtilities.hpp"
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <fstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(AdmissionControllerTest);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(AdmissionControllerTest, "AdmissionControllerTest");
+
+namespace
+{
+	void WriteFile( const std::string& i_rFileSpec, const std::string& i_rData )
+	{
+		std::ofstream file( i_rFileSpec.c_str() );
+		file << i_rData;
+		file.close();
+	}
+
+	void Admit( AdmissionController& i_rController, const std::string& i_rNode, bool& o_rAdmitted )
+	{
+		AdmissionController::Ticket ticket( i_rController, i_rNode );
+		o_rAdmitted = ticket.IsAdmitted();
+	}
+
+	// gives a waiting thread time to join the queue
+	void Pause()
+	{
+		boost::this_thread::sleep( boost::posix_time::milliseconds( 100 ) );
+	}
+}
+
+AdmissionControllerTest::AdmissionControllerTest()
+:	m_pTempDir( NULL )
+{
+	XMLPlatformUtils::Initialize();
+}
+
+AdmissionControllerTest::~AdmissionControllerTest()
+{
+	XMLPlatformUtils::Terminate();
+}
+
+void AdmissionControllerTest::setUp()
+{
+	m_pTempDir.reset( new TempDirectory() );
+}
+
+void AdmissionControllerTest::tearDown()
+{
+	m_pTempDir.reset( NULL );
+}
+
+void AdmissionControllerTest::testLimit()
+{
+	AdmissionController controller;
+	controller.AddLimit( "n1", false, 2, 0, 0 );
+
+	boost::scoped_ptr< AdmissionController::Ticket > pTicket1( new AdmissionController::Ticket( controller, "n1" ) );
+	AdmissionController::Ticket ticket2( controller, "n1" );
+	CPPUNIT_ASSERT( pTicket1->IsAdmitted() );
+	CPPUNIT_ASSERT( ticket2.IsAdmitted() );
+
+	// with no queue, a third request is turned away at once
+	{
+		AdmissionController::Ticket ticket( controller, "n1" );
+		CPPUNIT_ASSERT( !ticket.IsAdmitted() );
+	}
+
+	// other nodes are not limited
+	for( int i = 0; i < 10; ++i )
+	{
+		AdmissionController::Ticket ticket( controller, "n2" );
+		CPPUNIT_ASSERT( ticket.IsAdmitted() );
+	}
+
+	// a rejected ticket does not give up a slot it never had, but a released one frees its slot
+	pTicket1.reset( NULL );
+	AdmissionController::Ticket ticket3( controller, "n1" );
+	CPPUNIT_ASSERT( ticket3.IsAdmitted() );
+	AdmissionController::Ticket ticket4( controller, "n1" );
+	CPPUNIT_ASSERT( !ticket4.IsAdmitted() );
+}
+
+void AdmissionControllerTest::testQueue()
+{
+	AdmissionController controller;
+	controller.AddLimit( "n1", false, 1, 1, 0 );
+
+	bool admitted( false );
+	boost::thread waiter;
+	{
+		AdmissionController::Ticket ticket1( controller, "n1" );
+		CPPUNIT_ASSERT( ticket1.IsAdmitted() );
+
+		waiter = boost::thread( boost::bind( &Admit, boost::ref( controller ), "n1", boost::ref( admitted ) ) );
+		Pause();
+
+		// the queue is full
+		AdmissionController::Ticket ticket2( controller, "n1" );
+		CPPUNIT_ASSERT( !ticket2.IsAdmitted() );
+		CPPUNIT_ASSERT( !admitted );
+	}
+
+	// releasing the slot lets the waiting request in
+	waiter.join();
+	CPPUNIT_ASSERT( admitted );
+
+	AdmissionController::Ticket ticket3( controller, "n1" );
+	CPPUNIT_ASSERT( ticket3.IsAdmitted() );
+}
+
+void AdmissionControllerTest::testQueueTimeout()
+{
+	AdmissionController controller;
+	controller.AddLimit( "n1", false, 1, 5, 0.2 );
+
+	AdmissionController::Ticket ticket1( controller, "n1" );
+	CPPUNIT_ASSERT( ticket1.IsAdmitted() );
+
+	Stopwatch stopwatch;
+	AdmissionController::Ticket ticket2( controller, "n1" );
+	CPPUNIT_ASSERT( !ticket2.IsAdmitted() );
+	CPPUNIT_ASSERT( stopwatch.GetElapsedMilliseconds() >= 190 );
+}
+
+void AdmissionControllerTest::testPrefix()
+{
+	AdmissionController controller;
+	controller.AddLimit( "db_", true, 2, 0, 0 );
+	controller.AddLimit( "db_slow_", true, 1, 0, 0 );
+	controller.AddLimit( "db_fast", false, 3, 0, 0 );
+
+	// nodes sharing a prefix share its slots
+	{
+		AdmissionController::Ticket ticket1( controller, "db_a" );
+		AdmissionController::Ticket ticket2( controller, "db_b" );
+		AdmissionController::Ticket ticket3( controller, "db_c" );
+		CPPUNIT_ASSERT( ticket1.IsAdmitted() );
+		CPPUNIT_ASSERT( ticket2.IsAdmitted() );
+		CPPUNIT_ASSERT( !ticket3.IsAdmitted() );
+
+		// the longest prefix wins, and a node's own limit beats any prefix
+		AdmissionController::Ticket ticket4( controller, "db_slow_1" );
+		AdmissionController::Ticket ticket5( controller, "db_slow_2" );
+		CPPUNIT_ASSERT( ticket4.IsAdmitted() );
+		CPPUNIT_ASSERT( !ticket5.IsAdmitted() );
+
+		AdmissionController::Ticket ticket6( controller, "db_fast" );
+		AdmissionController::Ticket ticket7( controller, "db_fast" );
+		AdmissionController::Ticket ticket8( controller, "db_fast" );
+		AdmissionController::Ticket ticket9( controller, "db_fast" );
+		CPPUNIT_ASSERT( ticket6.IsAdmitted() );
+		CPPUNIT_ASSERT( ticket7.IsAdmitted() );
+		CPPUNIT_ASSERT( ticket8.IsAdmitted() );
+		CPPUNIT_ASSERT( !ticket9.IsAdmitted() );
+
+		AdmissionController::Ticket ticket10( controller, "db" );
+		CPPUNIT_ASSERT( ticket10.IsAdmitted() );
+	}
+
+	AdmissionController::Ticket ticket( controller, "db_c" );
+	CPPUNIT_ASSERT( ticket.IsAdmitted() );
+}
+
+void AdmissionControllerTest::testIllegal()
+{
+	AdmissionController controller;
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( controller.AddLimit( "n1", false, 0, 0, 0 ), AdmissionControllerException,
+		".*:\\d+: Limit for: n1: maxConcurrent must be positive" );
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( controller.AddLimit( "n1", false, 1, 0, -1 ), AdmissionControllerException,
+		".*:\\d+: Limit for: n1: queueTimeout must be non-negative" );
+
+	controller.AddLimit( "n1", false, 1, 0, 0 );
+	controller.AddLimit( "n1", true, 1, 0, 0 );
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( controller.AddLimit( "n1", false, 2, 0, 0 ), AdmissionControllerException,
+		".*:\\d+: Duplicate limit for node: n1" );
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( controller.AddLimit( "n1", true, 2, 0, 0 ), AdmissionControllerException,
+		".*:\\d+: Duplicate limit for node prefix: n1" );
+}
+
+void AdmissionControllerTest::testParse()
+{
+	std::string fileSpec( m_pTempDir->GetDirectoryName() + "/admission.xml" );
+	WriteFile( fileSpec,
+		"<AdmissionControl>\n"
+		"  <Limit node=\"n1\" maxConcurrent=\"1\" maxQueued=\"1\" queueTimeout=\"0.2\" />\n"
+		"  <Limit nodePrefix=\"db_\" maxConcurrent=\"2\" />\n"
+		"</AdmissionControl>\n" );
+
+	AdmissionController controller;
+	CPPUNIT_ASSERT_NO_THROW( controller.Parse( fileSpec ) );
+
+	AdmissionController::Ticket ticket1( controller, "n1" );
+	CPPUNIT_ASSERT( ticket1.IsAdmitted() );
+	Stopwatch stopwatch;
+	AdmissionController::Ticket ticket2( controller, "n1" );
+	CPPUNIT_ASSERT( !ticket2.IsAdmitted() );
+	CPPUNIT_ASSERT( stopwatch.GetElapsedMilliseconds() >= 190 );
+
+	AdmissionController::Ticket ticket3( controller, "db_a" );
+	AdmissionController::Ticket ticket4( controller, "db_b" );
+	AdmissionController::Ticket ticket5( controller, "db_c" );
+	CPPUNIT_ASSERT( ticket3.IsAdmitted() );
+	CPPUNIT_ASSERT( ticket4.IsAdmitted() );
+	CPPUNIT_ASSERT( !ticket5.IsAdmitted() );
+}
+
+void AdmissionControllerTest::testParseIllegal()
+{
+	std::string fileSpec( m_pTempDir->GetDirectoryName() + "/admission.xml" );
+	AdmissionController controller;
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( controller.Parse( fileSpec ), AdmissionControllerException,
+		".*:\\d+: Error parsing file: " << fileSpec << ": .*" );
+
+	WriteFile( fileSpec, "<AdmissionControl><Limit maxConcurrent=\"1\" /></AdmissionControl>" );
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( controller.Parse( fileSpec ), AdmissionControllerException,
+		".*:\\d+: Limit must have exactly one of the attributes: node, nodePrefix" );
+
+	WriteFile( fileSpec, "<AdmissionControl><Limit node=\"n1\" nodePrefix=\"n\" maxConcurrent=\"1\" /></AdmissionControl>" );
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( controller.Parse( fileSpec ), AdmissionControllerException,
+		".*:\\d+: Limit must have exactly one of the attributes: node, nodePrefix" );
+
+	WriteFile( fileSpec, "<AdmissionControl><Limit node=\"n1\" /></AdmissionControl>" );
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( controller.Parse( fileSpec ), AdmissionControllerException,
+		".*:\\d+: Limit is missing the attribute: maxConcurrent" );
+
+	WriteFile( fileSpec, "<AdmissionControl><Limit node=\"n1\" maxConcurrent=\"1\" maxQueued=\"-1\" /></AdmissionControl>" );
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( controller.Parse( fileSpec ), AdmissionControllerException,
+		".*:\\d+: Illegal value provided: -1 for attribute: maxQueued; must be non-negative" );
+
+	WriteFile( fileSpec, "<AdmissionControl><Limit node=\"n1\" maxConcurrent=\"many\" /></AdmissionControl>" );
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( controller.Parse( fileSpec ), AdmissionControllerException,
+		".*:\\d+: Error parsing maxConcurrent attribute: many as int" );
+
+	WriteFile( fileSpec, "<AdmissionControl><Limit node=\"n1\" maxConcurrent=\"1\" burst=\"2\" /></AdmissionControl>" );
+	CPPUNIT_ASSERT_THROW( controller.Parse( fileSpec ), XMLUtilitiesException );
+
+	WriteFile( fileSpec, "<AdmissionControl><Other /></AdmissionControl>" );
+	CPPUNIT_ASSERT_THROW( controller.Parse( fileSpec ), XMLUtilitiesException );
+}
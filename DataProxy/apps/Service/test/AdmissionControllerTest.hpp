@@ -0,0 +1,55 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#ifndef _ADMISSION_CONTROLLER_TEST_HPP_
+#define _ADMISSION_CONTROLLER_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <boost/scoped_ptr.hpp>
+
+class TempDirectory;
+
+class AdmissionControllerTest : public CppUnit::TestFixture
+{
+private:
+
+	CPPUNIT_TEST_SUITE(AdmissionControllerTest);
+	CPPUNIT_TEST(testLimit);
+	CPPUNIT_TEST(testQueue);
+	CPPUNIT_TEST(testQueueTimeout);
+	CPPUNIT_TEST(testPrefix);
+	CPPUNIT_TEST(testIllegal);
+	CPPUNIT_TEST(testParse);
+	CPPUNIT_TEST(testParseIllegal);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+
+	AdmissionControllerTest();
+	virtual ~AdmissionControllerTest();
+
+	void setUp();
+	void tearDown();
+
+	void testLimit();
+	void testQueue();
+	void testQueueTimeout();
+	void testPrefix();
+	void testIllegal();
+	void testParse();
+	void testParseIllegal();
+
+private:
+	boost::scoped_ptr< TempDirectory > m_pTempDir;
+};
+
+#endif //_ADMISSION_CONTROLLER_TEST_HPP_
@@ -0,0 +1,137 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#include "AdmissionHandlerTest.hpp"
+#include "AdmissionHandler.hpp"
+#include "AdmissionController.hpp"
+#include "DataProxyService.hpp"
+#include "MockHTTPRequest.hpp"
+#include "MockHTTPResponse.hpp"
+#include "HTTPResponse.hpp"
+#include "WebServerCommon.hpp"
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(AdmissionHandlerTest);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(AdmissionHandlerTest, "AdmissionHandlerTest");
+
+namespace
+{
+	// answers each request with its path; requests for "slow" are held until released
+	class HoldingHandler : public IWebService
+	{
+	public:
+		HoldingHandler()
+		:	m_Mutex(),
+			m_Changed(),
+			m_Held( 0 ),
+			m_Released( false )
+		{
+		}
+
+		virtual void Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse )
+		{
+			if( i_rRequest.GetPath() == "slow" )
+			{
+				boost::unique_lock< boost::mutex > lock( m_Mutex );
+				++m_Held;
+				m_Changed.notify_all();
+				while( !m_Released )
+				{
+					m_Changed.wait( lock );
+				}
+			}
+			o_rResponse.SetHTTPStatusCode( HTTP_STATUS_OK );
+			o_rResponse.WriteData( i_rRequest.GetPath() );
+		}
+
+		void WaitForHeld( int i_Count )
+		{
+			boost::unique_lock< boost::mutex > lock( m_Mutex );
+			while( m_Held < i_Count )
+			{
+				m_Changed.wait( lock );
+			}
+		}
+
+		void Release()
+		{
+			boost::unique_lock< boost::mutex > lock( m_Mutex );
+			m_Released = true;
+			m_Changed.notify_all();
+		}
+
+	private:
+		boost::mutex m_Mutex;
+		boost::condition_variable m_Changed;
+		int m_Held;
+		bool m_Released;
+	};
+
+	void Handle( IWebService& i_rHandler, const std::string& i_rPath, std::string& o_rLog )
+	{
+		MockHTTPRequest request;
+		MockHTTPResponse response;
+		request.SetPath( i_rPath );
+		i_rHandler.Handle( request, response );
+		o_rLog = response.GetLog();
+	}
+}
+
+AdmissionHandlerTest::AdmissionHandlerTest()
+{
+}
+
+AdmissionHandlerTest::~AdmissionHandlerTest()
+{
+}
+
+void AdmissionHandlerTest::testHandle()
+{
+	AdmissionController controller;
+	controller.AddLimit( "slow", false, 1, 0, 0 );
+	HoldingHandler holdingHandler;
+	AdmissionHandler handler( holdingHandler, controller );
+
+	std::string slowLog;
+	boost::thread slowRequest( boost::bind( &Handle, boost::ref( handler ), "slow", boost::ref( slowLog ) ) );
+	holdingHandler.WaitForHeld( 1 );
+
+	// the slow node is full, so the next request for it is turned away (a trailing slash makes no difference)
+	std::string log;
+	Handle( handler, "slow/", log );
+	std::stringstream expected;
+	expected << "SetHTTPStatusCode called with Code: 503 Message: " << std::endl
+			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			 << "WriteData called with Data: Too many requests in progress for node: slow\n" << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), log );
+
+	// other nodes carry on
+	Handle( handler, "fast", log );
+	expected.str("");
+	expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+			 << "WriteData called with Data: fast" << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), log );
+
+	holdingHandler.Release();
+	slowRequest.join();
+	expected.str("");
+	expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+			 << "WriteData called with Data: slow" << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), slowLog );
+
+	// once the slow request is done, its slot is free again
+	Handle( handler, "slow", log );
+	CPPUNIT_ASSERT_EQUAL( expected.str(), log );
+}
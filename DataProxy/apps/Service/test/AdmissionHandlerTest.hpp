@@ -0,0 +1,34 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#ifndef _ADMISSION_HANDLER_TEST_HPP_
+#define _ADMISSION_HANDLER_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class AdmissionHandlerTest : public CppUnit::TestFixture
+{
+private:
+
+	CPPUNIT_TEST_SUITE(AdmissionHandlerTest);
+	CPPUNIT_TEST(testHandle);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+
+	AdmissionHandlerTest();
+	virtual ~AdmissionHandlerTest();
+
+	void testHandle();
+};
+
+#endif //_ADMISSION_HANDLER_TEST_HPP_
@@ -0,0 +1,135 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#include "ChunkedResponseTest.hpp"
+#include "ChunkedResponse.hpp"
+#include "DataProxyService.hpp"
+#include "MockHTTPResponse.hpp"
+#include <boost/iostreams/filtering_stream.hpp>
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ChunkedResponseTest);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(ChunkedResponseTest, "ChunkedResponseTest");
+
+namespace
+{
+	std::string Headers( const std::string& i_rEncoding = "" )
+	{
+		std::stringstream result;
+		result << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+			   << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			   << "WriteHeader called with Name: Transfer-Encoding Value: chunked" << std::endl;
+		if( !i_rEncoding.empty() )
+		{
+			result << "WriteHeader called with Name: Content-Encoding Value: " << i_rEncoding << std::endl;
+		}
+		result << "WriteHeader called with Name: Trailer Value: X-DataProxy-Error" << std::endl;
+		return result.str();
+	}
+}
+
+ChunkedResponseTest::ChunkedResponseTest()
+{
+}
+
+ChunkedResponseTest::~ChunkedResponseTest()
+{
+}
+
+void ChunkedResponseTest::testWrite()
+{
+	MockHTTPResponse response;
+	ChunkedResponse chunked( response, "" );
+	CPPUNIT_ASSERT( !chunked.HasStarted() );
+	CPPUNIT_ASSERT_EQUAL( std::string(""), response.GetLog() );
+
+	std::string data( "this is some data that is longer than fifteen bytes" );
+	CPPUNIT_ASSERT_NO_THROW( chunked.WriteChunk( data.c_str(), 4 ) );
+	CPPUNIT_ASSERT( chunked.HasStarted() );
+	CPPUNIT_ASSERT_NO_THROW( chunked.WriteChunk( data.c_str() + 4, data.size() - 4 ) );
+	CPPUNIT_ASSERT_NO_THROW( chunked.Finish() );
+
+	std::stringstream expected;
+	expected << Headers()
+			 << "WriteData called with Data: 4\r\nthis\r\n" << std::endl
+			 << "WriteData called with Data: 2f\r\n" << data.substr( 4 ) << "\r\n" << std::endl
+			 << "WriteData called with Data: 0\r\n\r\n" << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+}
+
+void ChunkedResponseTest::testEncoding()
+{
+	MockHTTPResponse response;
+	ChunkedResponse chunked( response, "gzip" );
+	CPPUNIT_ASSERT_NO_THROW( chunked.WriteChunk( "abc", 3 ) );
+	CPPUNIT_ASSERT_NO_THROW( chunked.Finish() );
+
+	std::stringstream expected;
+	expected << Headers( "gzip" )
+			 << "WriteData called with Data: 3\r\nabc\r\n" << std::endl
+			 << "WriteData called with Data: 0\r\n\r\n" << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+}
+
+void ChunkedResponseTest::testEmpty()
+{
+	MockHTTPResponse response;
+	ChunkedResponse chunked( response, "" );
+
+	// an empty write would terminate the body, so it is not sent (and does not start the response)
+	CPPUNIT_ASSERT_NO_THROW( chunked.WriteChunk( "abc", 0 ) );
+	CPPUNIT_ASSERT( !chunked.HasStarted() );
+	CPPUNIT_ASSERT_EQUAL( std::string(""), response.GetLog() );
+
+	// finishing a response with no data still sends the status & headers
+	CPPUNIT_ASSERT_NO_THROW( chunked.Finish() );
+	CPPUNIT_ASSERT( chunked.HasStarted() );
+	std::stringstream expected;
+	expected << Headers()
+			 << "WriteData called with Data: 0\r\n\r\n" << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+}
+
+void ChunkedResponseTest::testFail()
+{
+	MockHTTPResponse response;
+	ChunkedResponse chunked( response, "" );
+	CPPUNIT_ASSERT_NO_THROW( chunked.WriteChunk( "abc", 3 ) );
+	CPPUNIT_ASSERT_NO_THROW( chunked.Fail( "something went\r\nwrong\n" ) );
+
+	std::stringstream expected;
+	expected << Headers()
+			 << "WriteData called with Data: 3\r\nabc\r\n" << std::endl
+			 << "WriteData called with Data: 0\r\nX-DataProxy-Error: something went  wrong \r\n\r\n" << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+}
+
+void ChunkedResponseTest::testSink()
+{
+	MockHTTPResponse response;
+	ChunkedResponse chunked( response, "" );
+	boost::iostreams::filtering_ostream output;
+	output.push( ChunkedResponse::Sink( chunked ), 5 );
+
+	// the buffer size the sink is pushed with determines the chunk size
+	output << "0123456789ab";
+	CPPUNIT_ASSERT( chunked.HasStarted() );
+	output.reset();
+	CPPUNIT_ASSERT_NO_THROW( chunked.Finish() );
+
+	std::stringstream expected;
+	expected << Headers()
+			 << "WriteData called with Data: 5\r\n01234\r\n" << std::endl
+			 << "WriteData called with Data: 5\r\n56789\r\n" << std::endl
+			 << "WriteData called with Data: 2\r\nab\r\n" << std::endl
+			 << "WriteData called with Data: 0\r\n\r\n" << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+}
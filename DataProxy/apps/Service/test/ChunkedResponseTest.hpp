@@ -0,0 +1,42 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#ifndef _CHUNKED_RESPONSE_TEST_HPP_
+#define _CHUNKED_RESPONSE_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class ChunkedResponseTest : public CppUnit::TestFixture
+{
+private:
+
+	CPPUNIT_TEST_SUITE(ChunkedResponseTest);
+	CPPUNIT_TEST(testWrite);
+	CPPUNIT_TEST(testEncoding);
+	CPPUNIT_TEST(testEmpty);
+	CPPUNIT_TEST(testFail);
+	CPPUNIT_TEST(testSink);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+
+	ChunkedResponseTest();
+	virtual ~ChunkedResponseTest();
+
+	void testWrite();
+	void testEncoding();
+	void testEmpty();
+	void testFail();
+	void testSink();
+};
+
+#endif //_CHUNKED_RESPONSE_TEST_HPP_
@@ -0,0 +1,261 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#include "ConfigReloaderTest.hpp"
+#include "ConfigReloader.hpp"
+#include "ResponseCache.hpp"
+#include "DataProxyClient.hpp"
+#include "TempDirectory.hpp"
+#include "ProxyUtilities.hpp"
+#include "AssertThrowWithMessage.hpp"
+#include "XMLUtilities.hpp"
+#include <boost/thread/thread.hpp>
+#include <fstream>
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ConfigReloaderTest);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(ConfigReloaderTest, "ConfigReloaderTest");
+
+namespace
+{
+	void WriteFile( const std::string& i_rFileSpec, const std::string& i_rData )
+	{
+		std::ofstream file( i_rFileSpec.c_str() );
+		file << i_rData;
+		file.close();
+	}
+
+	std::string GetConfig( const std::string& i_rLocation, const std::string& i_rExtraNode = "" )
+	{
+		std::stringstream result;
+		result << "<DplConfig>" << std::endl
+			   << "  <DataNode name=\"n1\" type=\"local\" location=\"" << i_rLocation << "\" />" << std::endl;
+		if( !i_rExtraNode.empty() )
+		{
+			result << "  <DataNode name=\"" << i_rExtraNode << "\" type=\"local\" location=\"" << i_rLocation << "\" />" << std::endl;
+		}
+		result << "</DplConfig>" << std::endl;
+		return result.str();
+	}
+
+	bool CanLoad( DataProxyClient& i_rClient, const std::string& i_rNode, const std::map< std::string, std::string >& i_rParams )
+	{
+		try
+		{
+			std::stringstream data;
+			i_rClient.Load( i_rNode, i_rParams, data );
+			return true;
+		}
+		catch( const std::exception& )
+		{
+			return false;
+		}
+	}
+
+	// the reloader works in the background, so give it a while to pick up a change
+	bool WaitForLoad( DataProxyClient& i_rClient, const std::string& i_rNode, const std::map< std::string, std::string >& i_rParams )
+	{
+		for( int i = 0; i < 100; ++i )
+		{
+			if( CanLoad( i_rClient, i_rNode, i_rParams ) )
+			{
+				return true;
+			}
+			boost::this_thread::sleep( boost::posix_time::milliseconds( 50 ) );
+		}
+		return false;
+	}
+}
+
+ConfigReloaderTest::ConfigReloaderTest()
+:	m_pTempDir( NULL )
+{
+	XMLPlatformUtils::Initialize();
+}
+
+ConfigReloaderTest::~ConfigReloaderTest()
+{
+	XMLPlatformUtils::Terminate();
+}
+
+void ConfigReloaderTest::setUp()
+{
+	m_pTempDir.reset( new TempDirectory() );
+}
+
+void ConfigReloaderTest::tearDown()
+{
+	m_pTempDir.reset( NULL );
+}
+
+void ConfigReloaderTest::testReload()
+{
+	DataProxyClient client;
+	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
+	std::map< std::string, std::string > params;
+	params[ "param1" ] = "value1";
+	WriteFile( m_pTempDir->GetDirectoryName() + "/" + ProxyUtilities::ToString( params ), "some data" );
+
+	ConfigReloader reloader( client, dplConfigFileSpec, 0, false, NULL );
+
+	// the file doesn't exist
+	CPPUNIT_ASSERT( !reloader.Reload() );
+	CPPUNIT_ASSERT( !CanLoad( client, "n1", params ) );
+
+	WriteFile( dplConfigFileSpec, GetConfig( m_pTempDir->GetDirectoryName() ) );
+	CPPUNIT_ASSERT( reloader.Reload() );
+	std::stringstream data;
+	CPPUNIT_ASSERT_NO_THROW( client.Load( "n1", params, data ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "some data" ), data.str() );
+
+	// a broken config leaves the previous one in place
+	WriteFile( dplConfigFileSpec, "<DplConfig>" );
+	CPPUNIT_ASSERT( !reloader.Reload() );
+	CPPUNIT_ASSERT( CanLoad( client, "n1", params ) );
+
+	WriteFile( dplConfigFileSpec, GetConfig( m_pTempDir->GetDirectoryName(), "n2" ) );
+	CPPUNIT_ASSERT( reloader.Reload() );
+	CPPUNIT_ASSERT( CanLoad( client, "n1", params ) );
+	CPPUNIT_ASSERT( CanLoad( client, "n2", params ) );
+}
+
+void ConfigReloaderTest::testCheck()
+{
+	DataProxyClient client;
+	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
+	std::map< std::string, std::string > params;
+	params[ "param1" ] = "value1";
+	WriteFile( m_pTempDir->GetDirectoryName() + "/" + ProxyUtilities::ToString( params ), "some data" );
+	WriteFile( dplConfigFileSpec, GetConfig( m_pTempDir->GetDirectoryName() ) );
+
+	ConfigReloader reloader( client, dplConfigFileSpec, 0.05, false, NULL );
+	CPPUNIT_ASSERT( reloader.Reload() );
+	reloader.Start();
+	CPPUNIT_ASSERT( !CanLoad( client, "n2", params ) );
+
+	// changes are picked up without any request having to check for them
+	WriteFile( dplConfigFileSpec, GetConfig( m_pTempDir->GetDirectoryName(), "n2" ) );
+	CPPUNIT_ASSERT( WaitForLoad( client, "n2", params ) );
+
+	// a broken config is not swapped in, but is picked up once it is fixed
+	WriteFile( dplConfigFileSpec, "<DplConfig>" );
+	boost::this_thread::sleep( boost::posix_time::milliseconds( 200 ) );
+	CPPUNIT_ASSERT( CanLoad( client, "n2", params ) );
+
+	WriteFile( dplConfigFileSpec, GetConfig( m_pTempDir->GetDirectoryName(), "n3" ) );
+	CPPUNIT_ASSERT( WaitForLoad( client, "n3", params ) );
+	CPPUNIT_ASSERT( !CanLoad( client, "n2", params ) );
+
+	reloader.Stop();
+}
+
+void ConfigReloaderTest::testCheckEntity()
+{
+	DataProxyClient client;
+	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
+	std::string nodesFileSpec = m_pTempDir->GetDirectoryName() + "/nodes.xml";
+	std::map< std::string, std::string > params;
+	params[ "param1" ] = "value1";
+	WriteFile( m_pTempDir->GetDirectoryName() + "/" + ProxyUtilities::ToString( params ), "some data" );
+
+	std::stringstream config;
+	config << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << std::endl
+		   << "<!DOCTYPE doc[" << std::endl
+		   << "<!ENTITY nodes SYSTEM \"" << nodesFileSpec << "\">" << std::endl
+		   << "]>" << std::endl
+		   << "<DplConfig>" << std::endl
+		   << "  &nodes;" << std::endl
+		   << "</DplConfig>" << std::endl;
+	WriteFile( dplConfigFileSpec, config.str() );
+	std::stringstream nodes;
+	nodes << "<DataNode name=\"n1\" type=\"local\" location=\"" << m_pTempDir->GetDirectoryName() << "\" />" << std::endl;
+	WriteFile( nodesFileSpec, nodes.str() );
+
+	ConfigReloader reloader( client, dplConfigFileSpec, 0.05, false, NULL );
+	CPPUNIT_ASSERT( reloader.Reload() );
+	reloader.Start();
+
+	// a broken entity is not swapped in, and a fix to it is picked up though the config file itself is untouched
+	WriteFile( nodesFileSpec, "<DataNode name=\"n2\"" );
+	boost::this_thread::sleep( boost::posix_time::milliseconds( 200 ) );
+	CPPUNIT_ASSERT( CanLoad( client, "n1", params ) );
+
+	nodes << "<DataNode name=\"n2\" type=\"local\" location=\"" << m_pTempDir->GetDirectoryName() << "\" />" << std::endl;
+	WriteFile( nodesFileSpec, nodes.str() );
+	CPPUNIT_ASSERT( WaitForLoad( client, "n2", params ) );
+	CPPUNIT_ASSERT( CanLoad( client, "n1", params ) );
+
+	reloader.Stop();
+}
+
+void ConfigReloaderTest::testSignal()
+{
+	DataProxyClient client;
+	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
+	std::map< std::string, std::string > params;
+	params[ "param1" ] = "value1";
+	WriteFile( m_pTempDir->GetDirectoryName() + "/" + ProxyUtilities::ToString( params ), "some data" );
+	WriteFile( dplConfigFileSpec, GetConfig( m_pTempDir->GetDirectoryName() ) );
+
+	// no checks: changes are only picked up on SIGHUP
+	ConfigReloader reloader( client, dplConfigFileSpec, 0, false, NULL );
+	CPPUNIT_ASSERT( reloader.Reload() );
+	reloader.Start();
+
+	WriteFile( dplConfigFileSpec, GetConfig( m_pTempDir->GetDirectoryName(), "n2" ) );
+	boost::this_thread::sleep( boost::posix_time::milliseconds( 200 ) );
+	CPPUNIT_ASSERT( !CanLoad( client, "n2", params ) );
+
+	// signalling the reloader's thread rather than the process, which would also reach any other thread
+	// that doesn't block SIGHUP
+	CPPUNIT_ASSERT_NO_THROW( reloader.Signal() );
+	CPPUNIT_ASSERT( WaitForLoad( client, "n2", params ) );
+
+	reloader.Stop();
+}
+
+void ConfigReloaderTest::testClearsResponseCache()
+{
+	DataProxyClient client;
+	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
+	WriteFile( dplConfigFileSpec, GetConfig( m_pTempDir->GetDirectoryName() ) );
+
+	ResponseCache cache( 3600, 1024 );
+	boost::shared_ptr< ResponseCache::Response > pResponse( new ResponseCache::Response() );
+	pResponse->m_Data = "some data";
+
+	ConfigReloader reloader( client, dplConfigFileSpec, 0, false, &cache );
+	CPPUNIT_ASSERT( reloader.Reload() );
+	cache.Put( "key", pResponse );
+
+	// reloading a config that hasn't changed keeps the cached responses
+	CPPUNIT_ASSERT( reloader.Reload() );
+	CPPUNIT_ASSERT( cache.Get( "key" ) );
+
+	// as does one that fails to load, since the previous config is still serving them
+	WriteFile( dplConfigFileSpec, "<DplConfig>" );
+	CPPUNIT_ASSERT( !reloader.Reload() );
+	CPPUNIT_ASSERT( cache.Get( "key" ) );
+
+	// a new config clears them
+	WriteFile( dplConfigFileSpec, GetConfig( m_pTempDir->GetDirectoryName(), "n2" ) );
+	CPPUNIT_ASSERT( reloader.Reload() );
+	CPPUNIT_ASSERT( !cache.Get( "key" ) );
+}
+
+void ConfigReloaderTest::testIllegal()
+{
+	DataProxyClient client;
+	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( ConfigReloader( client, dplConfigFileSpec, -1, false, NULL ), ConfigReloaderException,
+		".*:\\d+: Check seconds: -1 must be non-negative" );
+}
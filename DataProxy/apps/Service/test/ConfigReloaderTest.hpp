@@ -0,0 +1,53 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#ifndef _CONFIG_RELOADER_TEST_HPP_
+#define _CONFIG_RELOADER_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <boost/scoped_ptr.hpp>
+
+class TempDirectory;
+
+class ConfigReloaderTest : public CppUnit::TestFixture
+{
+private:
+
+	CPPUNIT_TEST_SUITE(ConfigReloaderTest);
+	CPPUNIT_TEST(testReload);
+	CPPUNIT_TEST(testCheck);
+	CPPUNIT_TEST(testCheckEntity);
+	CPPUNIT_TEST(testSignal);
+	CPPUNIT_TEST(testClearsResponseCache);
+	CPPUNIT_TEST(testIllegal);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+
+	ConfigReloaderTest();
+	virtual ~ConfigReloaderTest();
+
+	void setUp();
+	void tearDown();
+
+	void testReload();
+	void testCheck();
+	void testCheckEntity();
+	void testSignal();
+	void testClearsResponseCache();
+	void testIllegal();
+
+private:
+	boost::scoped_ptr< TempDirectory > m_pTempDir;
+};
+
+#endif //_CONFIG_RELOADER_TEST_HPP_
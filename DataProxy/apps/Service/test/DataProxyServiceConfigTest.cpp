@@ -48,6 +48,11 @@ void DataProxyServiceConfigTest::testParameters()
 		"--num_threads", "45",
 		"--max_request_size", "678",
 		"--zlib_compression_level", "7",
+		"--zstd_compression_level", "4",
+		"--lz4_compression_level", "9",
+		"--max_decoded_body_size", "4096",
+		"--dpl_config_recheck_seconds", "2.5",
+		"--dpl_config_notify", "1",
 		"--load_whitelist_file", "lwf",
 		"--store_whitelist_file", "swf",
 		"--delete_whitelist_file", "dwf",
@@ -56,6 +61,17 @@ void DataProxyServiceConfigTest::testParameters()
 		"--stats_retention_size", "123",
 		"--stats_per_hour_estimate", "468",
 		"--enable_x-forwarded-for", "1",
+		"--stream_loads", "1",
+		"--stream_chunk_size", "4096",
+		"--parallel_gzip_threads", "3",
+		"--parallel_gzip_block_size", "1024",
+		"--enable_etags", "1",
+		"--response_cache_seconds", "1.5",
+		"--response_cache_bytes", "2048",
+		"--admission_config", "my_admission_config",
+		"--metrics_path", "my_metrics_path",
+		"--metrics_max_nodes", "12",
+		"--trace_sample_rate", "0.25",
 		"--monitoring_config", "my_monitoring_config"
 	};
 	int argc = sizeof(argv)/sizeof(char*);
@@ -74,10 +90,26 @@ void DataProxyServiceConfigTest::testParameters()
 	CPPUNIT_ASSERT_EQUAL( uint(45), config.GetNumThreads() );
 	CPPUNIT_ASSERT_EQUAL( uint(678), config.GetMaxRequestSize() );
 	CPPUNIT_ASSERT_EQUAL( 7, config.GetZLibCompressionLevel() );
+	CPPUNIT_ASSERT_EQUAL( 4, config.GetZstdCompressionLevel() );
+	CPPUNIT_ASSERT_EQUAL( 9, config.GetLz4CompressionLevel() );
+	CPPUNIT_ASSERT_EQUAL( size_t(4096), config.GetMaxDecodedBodySize() );
+	CPPUNIT_ASSERT_EQUAL( 2.5, config.GetDplConfigRecheckSeconds() );
+	CPPUNIT_ASSERT( config.GetDplConfigNotify() );
 	CPPUNIT_ASSERT_EQUAL( uint(17), config.GetStatsRetentionHours() );
 	CPPUNIT_ASSERT_EQUAL( long(123), config.GetStatsRetentionSize() );
 	CPPUNIT_ASSERT_EQUAL( size_t(468), config.GetStatsPerHourEstimate() );
 	CPPUNIT_ASSERT( config.GetEnableXForwardedFor() );
+	CPPUNIT_ASSERT( config.GetStreamLoads() );
+	CPPUNIT_ASSERT_EQUAL( uint(4096), config.GetStreamChunkSize() );
+	CPPUNIT_ASSERT_EQUAL( uint(3), config.GetParallelGZipThreads() );
+	CPPUNIT_ASSERT_EQUAL( uint(1024), config.GetParallelGZipBlockSize() );
+	CPPUNIT_ASSERT( config.GetEnableETags() );
+	CPPUNIT_ASSERT_EQUAL( 1.5, config.GetResponseCacheSeconds() );
+	CPPUNIT_ASSERT_EQUAL( size_t(2048), config.GetResponseCacheBytes() );
+	CPPUNIT_ASSERT_EQUAL( std::string("my_admission_config"), config.GetAdmissionConfig() );
+	CPPUNIT_ASSERT_EQUAL( std::string("my_metrics_path"), config.GetMetricsPath() );
+	CPPUNIT_ASSERT_EQUAL( uint(12), config.GetMetricsMaxNodes() );
+	CPPUNIT_ASSERT_EQUAL( 0.25, config.GetTraceSampleRate() );
 	CPPUNIT_ASSERT_EQUAL( std::string("my_monitoring_config"), config.GetMonitorConfig() );
 }
 
@@ -107,7 +139,23 @@ void DataProxyServiceConfigTest::testOptionalParameters()
 	CPPUNIT_ASSERT_EQUAL( uint(45), config.GetNumThreads() );
 	CPPUNIT_ASSERT_EQUAL( uint(16384), config.GetMaxRequestSize() );
 	CPPUNIT_ASSERT_EQUAL( 0, config.GetZLibCompressionLevel() );
+	CPPUNIT_ASSERT_EQUAL( 0, config.GetZstdCompressionLevel() );
+	CPPUNIT_ASSERT_EQUAL( 0, config.GetLz4CompressionLevel() );
+	CPPUNIT_ASSERT_EQUAL( size_t(1073741824), config.GetMaxDecodedBodySize() );
+	CPPUNIT_ASSERT_EQUAL( 1.0, config.GetDplConfigRecheckSeconds() );
+	CPPUNIT_ASSERT( !config.GetDplConfigNotify() );
 	CPPUNIT_ASSERT( !config.GetEnableXForwardedFor() );
+	CPPUNIT_ASSERT( !config.GetStreamLoads() );
+	CPPUNIT_ASSERT_EQUAL( uint(65536), config.GetStreamChunkSize() );
+	CPPUNIT_ASSERT_EQUAL( uint(0), config.GetParallelGZipThreads() );
+	CPPUNIT_ASSERT_EQUAL( uint(131072), config.GetParallelGZipBlockSize() );
+	CPPUNIT_ASSERT( !config.GetEnableETags() );
+	CPPUNIT_ASSERT_EQUAL( 0.0, config.GetResponseCacheSeconds() );
+	CPPUNIT_ASSERT_EQUAL( size_t(67108864), config.GetResponseCacheBytes() );
+	CPPUNIT_ASSERT_EQUAL( std::string(""), config.GetAdmissionConfig() );
+	CPPUNIT_ASSERT_EQUAL( std::string(""), config.GetMetricsPath() );
+	CPPUNIT_ASSERT_EQUAL( uint(1000), config.GetMetricsMaxNodes() );
+	CPPUNIT_ASSERT_EQUAL( 0.0, config.GetTraceSampleRate() );
 	CPPUNIT_ASSERT_EQUAL( uint(24), config.GetStatsRetentionHours() );
 	CPPUNIT_ASSERT_EQUAL( long(-1), config.GetStatsRetentionSize() );
 	CPPUNIT_ASSERT_EQUAL( size_t(5000), config.GetStatsPerHourEstimate() );
@@ -144,4 +192,116 @@ void DataProxyServiceConfigTest::testIllegalParameters()
 	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( DataProxyServiceConfig( argc4, const_cast<char**>(argv4) ), DataProxyServiceConfigException,
 		".*:\\d+: zlib_compression_level: 10 is not in the range: \\[-1,9\\]" );
 
+	const char* argv5[] = 
+	{
+		"dpls",
+		"--instance_id", "my_instance_id",
+		"--dpl_config", "my_dpl_config",
+		"--port", "43",
+		"--num_threads", "45",
+		"--dpl_config_recheck_seconds", "-1",
+	};
+	int argc5 = sizeof(argv5)/sizeof(char*);
+	
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( DataProxyServiceConfig( argc5, const_cast<char**>(argv5) ), DataProxyServiceConfigException,
+		".*:\\d+: dpl_config_recheck_seconds: -1 must be non-negative" );
+
+	const char* argv6[] = 
+	{
+		"dpls",
+		"--instance_id", "my_instance_id",
+		"--dpl_config", "my_dpl_config",
+		"--port", "43",
+		"--num_threads", "45",
+		"--stream_chunk_size", "0",
+	};
+	int argc6 = sizeof(argv6)/sizeof(char*);
+	
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( DataProxyServiceConfig( argc6, const_cast<char**>(argv6) ), DataProxyServiceConfigException,
+		".*:\\d+: stream_chunk_size: must be positive" );
+
+	const char* argv7[] = 
+	{
+		"dpls",
+		"--instance_id", "my_instance_id",
+		"--dpl_config", "my_dpl_config",
+		"--port", "43",
+		"--num_threads", "45",
+		"--parallel_gzip_block_size", "0",
+	};
+	int argc7 = sizeof(argv7)/sizeof(char*);
+	
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( DataProxyServiceConfig( argc7, const_cast<char**>(argv7) ), DataProxyServiceConfigException,
+		".*:\\d+: parallel_gzip_block_size: must be positive" );
+
+	const char* argv8[] = 
+	{
+		"dpls",
+		"--instance_id", "my_instance_id",
+		"--dpl_config", "my_dpl_config",
+		"--port", "43",
+		"--num_threads", "45",
+		"--zstd_compression_level", "20",
+	};
+	int argc8 = sizeof(argv8)/sizeof(char*);
+	
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( DataProxyServiceConfig( argc8, const_cast<char**>(argv8) ), DataProxyServiceConfigException,
+		".*:\\d+: zstd_compression_level: 20 is not in the range: \\[0,19\\]" );
+
+	const char* argv9[] = 
+	{
+		"dpls",
+		"--instance_id", "my_instance_id",
+		"--dpl_config", "my_dpl_config",
+		"--port", "43",
+		"--num_threads", "45",
+		"--lz4_compression_level", "-1",
+	};
+	int argc9 = sizeof(argv9)/sizeof(char*);
+	
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( DataProxyServiceConfig( argc9, const_cast<char**>(argv9) ), DataProxyServiceConfigException,
+		".*:\\d+: lz4_compression_level: -1 is not in the range: \\[0,12\\]" );
+
+	const char* argv10[] = 
+	{
+		"dpls",
+		"--instance_id", "my_instance_id",
+		"--dpl_config", "my_dpl_config",
+		"--port", "43",
+		"--num_threads", "45",
+		"--response_cache_seconds", "-1",
+	};
+	int argc10 = sizeof(argv10)/sizeof(char*);
+	
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( DataProxyServiceConfig( argc10, const_cast<char**>(argv10) ), DataProxyServiceConfigException,
+		".*:\\d+: response_cache_seconds: -1 must be non-negative" );
+
+	const char* argv11[] = 
+	{
+		"dpls",
+		"--instance_id", "my_instance_id",
+		"--dpl_config", "my_dpl_config",
+		"--port", "43",
+		"--num_threads", "45",
+		"--max_decoded_body_size", "0",
+	};
+	int argc11 = sizeof(argv11)/sizeof(char*);
+	
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( DataProxyServiceConfig( argc11, const_cast<char**>(argv11) ), DataProxyServiceConfigException,
+		".*:\\d+: max_decoded_body_size: must be positive" );
+
+	const char* argv12[] = 
+	{
+		"dpls",
+		"--instance_id", "my_instance_id",
+		"--dpl_config", "my_dpl_config",
+		"--port", "43",
+		"--num_threads", "45",
+		"--trace_sample_rate", "1.5",
+	};
+	int argc12 = sizeof(argv12)/sizeof(char*);
+	
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( DataProxyServiceConfig( argc12, const_cast<char**>(argv12) ), DataProxyServiceConfigException,
+		".*:\\d+: trace_sample_rate: 1.5 is not in the range: \\[0,1\\]" );
+
 }
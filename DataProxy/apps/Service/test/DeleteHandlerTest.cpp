@@ -81,17 +81,17 @@ void DeleteHandlerTest::testDelete()
 
 	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
 
-	DeleteHandler handler( client, dplConfigFileSpec, false );
+	DeleteHandler handler( client, false, NULL );
 	
 	request.SetQueryParams( params );
 	request.SetPath( "n1" );
 
-	// error condition #1: initialization fails because the file doesn't exist
+	// error condition #1: the client has not been initialized with a config
 	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
 	std::stringstream expected;
 	expected << "SetHTTPStatusCode called with Code: 500 Message: " << std::endl
 			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
-			 << "WriteData called with Data: Error initializing DPL with file: " << dplConfigFileSpec << ": private/DataProxyClient.cpp:\\d+: Cannot find config file.*";
+			 << "WriteData called with Data: Error deleting data to node: n1: private/DataProxyClient.cpp:\\d+: Attempted to issue Delete request on uninitialized DataProxyClient.*";
 	CPPUNIT_ASSERT( boost::regex_match( response.GetLog(), boost::regex( expected.str() ) ) );
 	response.ClearLog();
 	expected.str("");
@@ -103,6 +103,7 @@ void DeleteHandlerTest::testDelete()
 		 << "  <DataNode name=\"n2\" type=\"local\" location=\"" << dir2 << "\" />" << std::endl
 		 << "</DplConfig>" << std::endl;
 	file.close();
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( dplConfigFileSpec ) );
 
 	// successful delete
 	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
@@ -166,8 +167,9 @@ void DeleteHandlerTest::testDeleteXForwardedFor()
 		 << "  <DataNode name=\"n1\" type=\"local\" location=\"" << dir1 << "\" />" << std::endl
 		 << "</DplConfig>" << std::endl;
 	file.close();
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( dplConfigFileSpec ) );
 
-	DeleteHandler handler( client, dplConfigFileSpec, true );
+	DeleteHandler handler( client, true, NULL );
 
 	// successful delete
 	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
@@ -11,19 +11,25 @@
 
 #include "LoadHandlerTest.hpp"
 #include "LoadHandler.hpp"
+#include "StoreHandler.hpp"
+#include "DeleteHandler.hpp"
+#include "Lz4Filter.hpp"
 #include "TempDirectory.hpp"
 #include "DataProxyService.hpp"
 #include "DataProxyClient.hpp"
 #include "FileUtilities.hpp"
 #include "MockHTTPRequest.hpp"
 #include "MockHTTPResponse.hpp"
+#include "MVUtility.hpp"
 #include "ProxyUtilities.hpp"
 #include "XMLUtilities.hpp"
 #include <boost/regex.hpp>
+#include <boost/lexical_cast.hpp>
 #include <fstream>
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/copy.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/zstd.hpp>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(LoadHandlerTest);
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(LoadHandlerTest, "LoadHandlerTest");
@@ -36,6 +42,18 @@ namespace
 		file << i_rData;
 		file.close();
 	}
+
+	template< typename T_Compressor >
+	std::string Compress( const T_Compressor& i_rCompressor, const std::string& i_rData )
+	{
+		std::stringstream result;
+		boost::iostreams::filtering_ostream filter;
+		filter.push( i_rCompressor );
+		filter.push( result );
+		filter << i_rData;
+		filter.reset();
+		return result.str();
+	}
 }
 
 LoadHandlerTest::LoadHandlerTest()
@@ -93,18 +111,18 @@ void LoadHandlerTest::testLoad()
 
 	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
 
-	LoadHandler handler( client, dplConfigFileSpec, -1, false );
+	LoadHandler handler( client, -1, 0, 0, false, false, 65536, 0, 131072, false, NULL );
 	
 	request.SetQueryParams( paramsA );
 	request.SetPath( "n1" );
 	request.SetHTTPHeader( "X-Forwarded-For", "client1, client2" ); 	// ignored because constructor flag was false so this will not be parsed / forwarded
 
-	// error condition #1: initialization fails because the file doesn't exist
+	// error condition #1: the client has not been initialized with a config
 	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
 	std::stringstream expected;
 	expected << "SetHTTPStatusCode called with Code: 500 Message: " << std::endl
 			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
-			 << "WriteData called with Data: Error initializing DPL with file: " << dplConfigFileSpec << ": private/DataProxyClient.cpp:\\d+: Cannot find config file.*";
+			 << "WriteData called with Data: Error loading data from node: n1: private/DataProxyClient.cpp:\\d+: Attempted to issue Load request on uninitialized DataProxyClient.*";
 	CPPUNIT_ASSERT( boost::regex_match( response.GetLog(), boost::regex( expected.str() ) ) );
 	response.ClearLog();
 	expected.str("");
@@ -116,6 +134,7 @@ void LoadHandlerTest::testLoad()
 		 << "  <DataNode name=\"n2\" type=\"local\" location=\"" << dir2 << "\" />" << std::endl
 		 << "</DplConfig>" << std::endl;
 	file.close();
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( dplConfigFileSpec ) );
 
 	// successful load
 	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
@@ -182,13 +201,14 @@ void LoadHandlerTest::testLoadCompressed()
 
 	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
 
-	LoadHandler handler( client, dplConfigFileSpec, -1, false );
+	LoadHandler handler( client, -1, 0, 0, false, false, 65536, 0, 131072, false, NULL );
 	
 	std::ofstream file( dplConfigFileSpec.c_str() );
 	file << "<DplConfig>" << std::endl
 		 << "  <DataNode name=\"n1\" type=\"local\" location=\"" << dir1 << "\" />" << std::endl
 		 << "</DplConfig>" << std::endl;
 	file.close();
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( dplConfigFileSpec ) );
 
 	std::stringstream expected;
 
@@ -287,13 +307,14 @@ void LoadHandlerTest::testLoadCompressedCustomLevel()
 
 	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
 
-	LoadHandler handler( client, dplConfigFileSpec, 9, false );
+	LoadHandler handler( client, 9, 0, 0, false, false, 65536, 0, 131072, false, NULL );
 	
 	std::ofstream file( dplConfigFileSpec.c_str() );
 	file << "<DplConfig>" << std::endl
 		 << "  <DataNode name=\"n1\" type=\"local\" location=\"" << dir1 << "\" />" << std::endl
 		 << "</DplConfig>" << std::endl;
 	file.close();
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( dplConfigFileSpec ) );
 
 	std::stringstream expected;
 
@@ -311,7 +332,7 @@ void LoadHandlerTest::testLoadCompressedCustomLevel()
 
 	// server-side disable compression (0)
 	request.SetHTTPHeader( "Accept-Encoding", "gzip" );
-	LoadHandler handler2( client, dplConfigFileSpec, 0, false );
+	LoadHandler handler2( client, 0, 0, 0, false, false, 65536, 0, 131072, false, NULL );
 	CPPUNIT_ASSERT_NO_THROW( handler2.Handle( request, response ) );
 	expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
 			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
@@ -320,6 +341,156 @@ void LoadHandlerTest::testLoadCompressedCustomLevel()
 	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
 }
 
+void LoadHandlerTest::testLoadCompressedParallel()
+{
+	DataProxyClient client;
+	MockHTTPRequest request;
+	MockHTTPResponse response;
+
+	std::map< std::string, std::string > params;
+	request.SetQueryParams( params );
+	request.SetPath( "n1" );
+
+	std::string dir1( m_pTempDir->GetDirectoryName() + "/dir1" );
+	CPPUNIT_ASSERT_NO_THROW( FileUtilities::CreateDirectory( dir1 ) );
+	std::string file1( dir1 + "/" + ProxyUtilities::ToString( params ) );
+	std::string data1( "this is some data in file 1" );
+	WriteFile( file1, data1 );
+
+	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
+
+	// 10-byte blocks, so the result is made up of several independently compressed blocks
+	LoadHandler handler( client, 9, 0, 0, false, false, 65536, 2, 10, false, NULL );
+	
+	std::ofstream file( dplConfigFileSpec.c_str() );
+	file << "<DplConfig>" << std::endl
+		 << "  <DataNode name=\"n1\" type=\"local\" location=\"" << dir1 << "\" />" << std::endl
+		 << "</DplConfig>" << std::endl;
+	file.close();
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( dplConfigFileSpec ) );
+
+	// the blocks are not compressed the same way as a single stream, so the result is checked by decompressing it
+	request.SetHTTPHeader( "Accept-Encoding", "gzip" );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	std::string log = response.GetLog();
+	boost::smatch match;
+	CPPUNIT_ASSERT_MESSAGE( log, boost::regex_match( log, match, boost::regex(
+		"SetHTTPStatusCode called with Code: 200 Message: \n"
+		"WriteHeader called with Name: Server Value: .*\n"
+		"WriteHeader called with Name: Content-Length Value: (\\d+)\n"
+		"WriteHeader called with Name: Content-Encoding Value: gzip\n"
+		"WriteData called with Data: (.*)\n" ) ) );
+	std::string gzipData1 = match[2];
+	CPPUNIT_ASSERT_EQUAL( boost::lexical_cast< size_t >( match[1].str() ), gzipData1.size() );
+
+	std::stringstream gzipIn( gzipData1 );
+	std::stringstream result;
+	boost::iostreams::filtering_istream gunzipFilter;
+	gunzipFilter.push( boost::iostreams::gzip_decompressor() );
+	gunzipFilter.push( gzipIn );
+	boost::iostreams::copy( gunzipFilter, result );
+	CPPUNIT_ASSERT_EQUAL( data1, result.str() );
+	response.ClearLog();
+
+	// no compression if the client does not ask for it
+	request.SetHTTPHeader( "Accept-Encoding", "" );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	std::stringstream expected;
+	expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			 << "WriteHeader called with Name: Content-Length Value: " << data1.size() << std::endl
+			 << "WriteData called with Data: " << data1 << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+}
+
+void LoadHandlerTest::testLoadCompressedNegotiation()
+{
+	DataProxyClient client;
+	MockHTTPRequest request;
+	MockHTTPResponse response;
+
+	std::map< std::string, std::string > params;
+	request.SetQueryParams( params );
+	request.SetPath( "n1" );
+
+	std::string dir1( m_pTempDir->GetDirectoryName() + "/dir1" );
+	CPPUNIT_ASSERT_NO_THROW( FileUtilities::CreateDirectory( dir1 ) );
+	std::string file1( dir1 + "/" + ProxyUtilities::ToString( params ) );
+	std::string data1( "this is some data in file 1" );
+	WriteFile( file1, data1 );
+
+	std::string gzipData1 = Compress( boost::iostreams::gzip_compressor(), data1 );
+	std::string zstdData1 = Compress( boost::iostreams::zstd_compressor( boost::iostreams::zstd_params( 3 ) ), data1 );
+	std::string lz4Data1 = Compress( Lz4Compressor( 1 ), data1 );
+
+	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
+
+	LoadHandler handler( client, -1, 3, 1, false, false, 65536, 0, 131072, false, NULL );
+	
+	std::ofstream file( dplConfigFileSpec.c_str() );
+	file << "<DplConfig>" << std::endl
+		 << "  <DataNode name=\"n1\" type=\"local\" location=\"" << dir1 << "\" />" << std::endl
+		 << "</DplConfig>" << std::endl;
+	file.close();
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( dplConfigFileSpec ) );
+
+	// each case: the client's Accept-Encoding, and the encoding that should be chosen
+	std::vector< std::pair< std::string, std::string > > cases;
+	cases.push_back( std::make_pair( "gzip", "gzip" ) );
+	cases.push_back( std::make_pair( "lz4", "lz4" ) );
+	cases.push_back( std::make_pair( "zstd", "zstd" ) );
+	cases.push_back( std::make_pair( "gzip, lz4", "lz4" ) );
+	cases.push_back( std::make_pair( "gzip,lz4,zstd", "zstd" ) );
+	cases.push_back( std::make_pair( "zstd;q=0, lz4;q=0.5, gzip", "gzip" ) );
+	cases.push_back( std::make_pair( "zstd; q=0.1, lz4;q=0.5", "lz4" ) );
+	cases.push_back( std::make_pair( "zstd;q=0", "" ) );
+	cases.push_back( std::make_pair( "br, deflate", "" ) );
+
+	std::vector< std::pair< std::string, std::string > >::const_iterator iter = cases.begin();
+	for( ; iter != cases.end(); ++iter )
+	{
+		std::string data = data1;
+		if( iter->second == "gzip" )
+		{
+			data = gzipData1;
+		}
+		else if( iter->second == "zstd" )
+		{
+			data = zstdData1;
+		}
+		else if( iter->second == "lz4" )
+		{
+			data = lz4Data1;
+		}
+
+		request.SetHTTPHeader( "Accept-Encoding", iter->first );
+		CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+		std::stringstream expected;
+		expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+				 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+				 << "WriteHeader called with Name: Content-Length Value: " << data.size() << std::endl;
+		if( !iter->second.empty() )
+		{
+			expected << "WriteHeader called with Name: Content-Encoding Value: " << iter->second << std::endl;
+		}
+		expected << "WriteData called with Data: " << data << std::endl;
+		CPPUNIT_ASSERT_EQUAL_MESSAGE( iter->first, expected.str(), response.GetLog() );
+		response.ClearLog();
+	}
+
+	// an encoding that is not enabled is never chosen
+	LoadHandler gzipOnlyHandler( client, -1, 0, 0, false, false, 65536, 0, 131072, false, NULL );
+	request.SetHTTPHeader( "Accept-Encoding", "zstd, lz4, gzip;q=0.1" );
+	CPPUNIT_ASSERT_NO_THROW( gzipOnlyHandler.Handle( request, response ) );
+	std::stringstream expected;
+	expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			 << "WriteHeader called with Name: Content-Length Value: " << gzipData1.size() << std::endl
+			 << "WriteHeader called with Name: Content-Encoding Value: gzip" << std::endl
+			 << "WriteData called with Data: " << gzipData1 << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+}
+
 void LoadHandlerTest::testLoadXForwardedFor()
 {
 	DataProxyClient client;
@@ -345,7 +516,7 @@ void LoadHandlerTest::testLoadXForwardedFor()
 
 	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
 
-	LoadHandler handler( client, dplConfigFileSpec, -1, true );
+	LoadHandler handler( client, -1, 0, 0, true, false, 65536, 0, 131072, false, NULL );
 	
 	request.SetQueryParams( paramsA );
 	request.SetPath( "n1" );
@@ -356,6 +527,7 @@ void LoadHandlerTest::testLoadXForwardedFor()
 		 << "  <DataNode name=\"n1\" type=\"local\" location=\"" << dir1 << "\" />" << std::endl
 		 << "</DplConfig>" << std::endl;
 	file.close();
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( dplConfigFileSpec ) );
 
 	// successful load
 	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
@@ -383,3 +555,294 @@ void LoadHandlerTest::testLoadXForwardedFor()
 	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
 }
 
+
+void LoadHandlerTest::testLoadStreaming()
+{
+	DataProxyClient client;
+	MockHTTPRequest request;
+	MockHTTPResponse response;
+
+	std::map< std::string, std::string > params;
+	request.SetQueryParams( params );
+	request.SetPath( "n1" );
+
+	std::string dir1( m_pTempDir->GetDirectoryName() + "/dir1" );
+	CPPUNIT_ASSERT_NO_THROW( FileUtilities::CreateDirectory( dir1 ) );
+	std::string file1( dir1 + "/" + ProxyUtilities::ToString( params ) );
+	std::string data1( "this is some data in file 1" );
+	WriteFile( file1, data1 );
+
+	std::stringstream gzipData1;
+	boost::iostreams::filtering_ostream gzipFilter;
+	gzipFilter.push( boost::iostreams::gzip_compressor() );
+	gzipFilter.push( gzipData1 );
+	std::istringstream gzipIn( data1 );
+	boost::iostreams::copy( gzipIn, gzipFilter );
+
+	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
+
+	std::ofstream file( dplConfigFileSpec.c_str() );
+	file << "<DplConfig>" << std::endl
+		 << "  <DataNode name=\"n1\" type=\"local\" location=\"" << dir1 << "\" />" << std::endl
+		 << "  <DataNode name=\"n2\" type=\"exe\" >" << std::endl
+		 << "    <Read command=\"echo data; exit 1\" timeout=\"5\" />" << std::endl
+		 << "  </DataNode>" << std::endl
+		 << "</DplConfig>" << std::endl;
+	file.close();
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( dplConfigFileSpec ) );
+
+	LoadHandler handler( client, -1, 0, 0, false, true, 65536, 0, 131072, false, NULL );
+
+	// successful load: the whole result fits in one chunk
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	std::stringstream expected;
+	expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			 << "WriteHeader called with Name: Transfer-Encoding Value: chunked" << std::endl
+			 << "WriteHeader called with Name: Trailer Value: X-DataProxy-Error" << std::endl
+			 << "WriteData called with Data: " << std::hex << data1.size() << std::dec << "\r\n" << data1 << "\r\n" << std::endl
+			 << "WriteData called with Data: 0\r\n\r\n" << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+	expected.str("");
+	response.ClearLog();
+
+	// successful compressed load
+	request.SetHTTPHeader( "Accept-Encoding", "gzip" );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			 << "WriteHeader called with Name: Transfer-Encoding Value: chunked" << std::endl
+			 << "WriteHeader called with Name: Content-Encoding Value: gzip" << std::endl
+			 << "WriteHeader called with Name: Trailer Value: X-DataProxy-Error" << std::endl
+			 << "WriteData called with Data: " << std::hex << gzipData1.str().size() << std::dec << "\r\n" << gzipData1.str() << "\r\n" << std::endl
+			 << "WriteData called with Data: 0\r\n\r\n" << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+	expected.str("");
+	response.ClearLog();
+	request.SetHTTPHeader( "Accept-Encoding", "" );
+
+	// a failure before any data has been sent is reported with the usual status
+	request.SetPath( "unknown" );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	expected << "SetHTTPStatusCode called with Code: 500 Message: " << std::endl
+			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			 << "WriteData called with Data: Error loading data from node: unknown: private/DataProxyClient.cpp:\\d+: Attempted to issue Load request on unknown data node 'unknown'.*";
+	CPPUNIT_ASSERT( boost::regex_match( response.GetLog(), boost::regex( expected.str() ) ) );
+	expected.str("");
+	response.ClearLog();
+
+	// a failure after data has been sent is reported in the trailer; with 2-byte chunks, the
+	// first four bytes go out before the command's exit status is known
+	LoadHandler smallChunkHandler( client, -1, 0, 0, false, true, 2, 0, 131072, false, NULL );
+	request.SetPath( "n2" );
+	CPPUNIT_ASSERT_NO_THROW( smallChunkHandler.Handle( request, response ) );
+	expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			 << "WriteHeader called with Name: Transfer-Encoding Value: chunked" << std::endl
+			 << "WriteHeader called with Name: Trailer Value: X-DataProxy-Error" << std::endl
+			 << "WriteData called with Data: 2\r\nda\r\n" << std::endl
+			 << "WriteData called with Data: 2\r\nta\r\n" << std::endl
+			 << "WriteData called with Data: 0\r\nX-DataProxy-Error: Error loading data from node: n2: .*:\\d+: Command: 'echo data; exit 1' returned non-zero status: 1\\. Standard error: \r\n\r\n" << std::endl;
+	CPPUNIT_ASSERT_MESSAGE( response.GetLog(), boost::regex_match( response.GetLog(), boost::regex( expected.str() ) ) );
+}
+
+void LoadHandlerTest::testLoadETag()
+{
+	DataProxyClient client;
+	MockHTTPRequest request;
+	MockHTTPResponse response;
+
+	std::map< std::string, std::string > params;
+	request.SetQueryParams( params );
+	request.SetPath( "n1" );
+
+	std::string dir1( m_pTempDir->GetDirectoryName() + "/dir1" );
+	CPPUNIT_ASSERT_NO_THROW( FileUtilities::CreateDirectory( dir1 ) );
+	std::string file1( dir1 + "/" + ProxyUtilities::ToString( params ) );
+	std::string data1( "this is some data in file 1" );
+	WriteFile( file1, data1 );
+
+	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
+	std::ofstream file( dplConfigFileSpec.c_str() );
+	file << "<DplConfig>" << std::endl
+		 << "  <DataNode name=\"n1\" type=\"local\" location=\"" << dir1 << "\" />" << std::endl
+		 << "</DplConfig>" << std::endl;
+	file.close();
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( dplConfigFileSpec ) );
+
+	LoadHandler handler( client, -1, 0, 0, false, false, 65536, 0, 131072, true, NULL );
+
+	std::string etag( "\"" + MVUtility::GetMD5( data1 ) + "\"" );
+	std::stringstream fullResponse;
+	fullResponse << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+				 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+				 << "WriteHeader called with Name: Content-Length Value: " << data1.size() << std::endl
+				 << "WriteHeader called with Name: ETag Value: " << etag << std::endl
+				 << "WriteData called with Data: " << data1 << std::endl;
+	std::stringstream notModified;
+	notModified << "SetHTTPStatusCode called with Code: 304 Message: " << std::endl
+				<< "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+				<< "WriteHeader called with Name: ETag Value: " << etag << std::endl
+				<< "WriteData called with Data: " << std::endl;
+
+	// without If-None-Match, the result is sent along with its tag
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	CPPUNIT_ASSERT_EQUAL( fullResponse.str(), response.GetLog() );
+	response.ClearLog();
+
+	// a matching tag (alone, in a list, weak, or *) gets 304 with no body
+	std::vector< std::string > matches;
+	matches.push_back( etag );
+	matches.push_back( "\"other\", " + etag );
+	matches.push_back( "W/" + etag );
+	matches.push_back( "*" );
+	std::vector< std::string >::const_iterator iter = matches.begin();
+	for( ; iter != matches.end(); ++iter )
+	{
+		request.SetHTTPHeader( "If-None-Match", *iter );
+		CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+		CPPUNIT_ASSERT_EQUAL_MESSAGE( *iter, notModified.str(), response.GetLog() );
+		response.ClearLog();
+	}
+
+	// a stale tag gets the full result
+	request.SetHTTPHeader( "If-None-Match", "\"other\"" );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	CPPUNIT_ASSERT_EQUAL( fullResponse.str(), response.GetLog() );
+	response.ClearLog();
+
+	// once the data changes, so does the tag
+	std::string data2( "this is some new data in file 1" );
+	WriteFile( file1, data2 );
+	request.SetHTTPHeader( "If-None-Match", etag );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	std::stringstream expected;
+	expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			 << "WriteHeader called with Name: Content-Length Value: " << data2.size() << std::endl
+			 << "WriteHeader called with Name: ETag Value: \"" << MVUtility::GetMD5( data2 ) << "\"" << std::endl
+			 << "WriteData called with Data: " << data2 << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+	response.ClearLog();
+
+	// without etags enabled, If-None-Match is ignored
+	LoadHandler untaggedHandler( client, -1, 0, 0, false, false, 65536, 0, 131072, false, NULL );
+	request.SetHTTPHeader( "If-None-Match", "*" );
+	CPPUNIT_ASSERT_NO_THROW( untaggedHandler.Handle( request, response ) );
+	expected.str("");
+	expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			 << "WriteHeader called with Name: Content-Length Value: " << data2.size() << std::endl
+			 << "WriteData called with Data: " << data2 << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+}
+
+void LoadHandlerTest::testLoadCached()
+{
+	DataProxyClient client;
+	MockHTTPRequest request;
+	MockHTTPResponse response;
+
+	std::map< std::string, std::string > paramsA;
+	paramsA[ "param1" ] = "a";
+	std::map< std::string, std::string > paramsB;
+	paramsB[ "param1" ] = "b";
+	request.SetPath( "n1" );
+
+	std::string dir1( m_pTempDir->GetDirectoryName() + "/dir1" );
+	CPPUNIT_ASSERT_NO_THROW( FileUtilities::CreateDirectory( dir1 ) );
+	std::string file1a( dir1 + "/" + ProxyUtilities::ToString( paramsA ) );
+	std::string file1b( dir1 + "/" + ProxyUtilities::ToString( paramsB ) );
+	std::string data1a( "this is some data in file 1a" );
+	std::string data1b( "this is some data in file 1b" );
+	WriteFile( file1a, data1a );
+	WriteFile( file1b, data1b );
+
+	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
+	std::ofstream file( dplConfigFileSpec.c_str() );
+	file << "<DplConfig>" << std::endl
+		 << "  <DataNode name=\"n1\" type=\"local\" location=\"" << dir1 << "\" />" << std::endl
+		 << "</DplConfig>" << std::endl;
+	file.close();
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( dplConfigFileSpec ) );
+
+	ResponseCache cache( 3600, 67108864 );
+	LoadHandler handler( client, -1, 0, 0, false, false, 65536, 0, 131072, false, &cache );
+
+	std::stringstream expected;
+	expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			 << "WriteHeader called with Name: Content-Length Value: " << data1a.size() << std::endl
+			 << "WriteData called with Data: " << data1a << std::endl;
+
+	// the first load reads the file; once it is changed, the same request is still answered from the cache
+	request.SetQueryParams( paramsA );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+	response.ClearLog();
+
+	WriteFile( file1a, "this is changed data in file 1a" );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+	response.ClearLog();
+
+	// different parameters are a different entry
+	request.SetQueryParams( paramsB );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	expected.str("");
+	expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			 << "WriteHeader called with Name: Content-Length Value: " << data1b.size() << std::endl
+			 << "WriteData called with Data: " << data1b << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+	response.ClearLog();
+
+	// so is a different encoding
+	std::string gzipData1a = Compress( boost::iostreams::gzip_compressor(), "this is changed data in file 1a" );
+	request.SetQueryParams( paramsA );
+	request.SetHTTPHeader( "Accept-Encoding", "gzip" );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	expected.str("");
+	expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			 << "WriteHeader called with Name: Content-Length Value: " << gzipData1a.size() << std::endl
+			 << "WriteHeader called with Name: Content-Encoding Value: gzip" << std::endl
+			 << "WriteData called with Data: " << gzipData1a << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+	response.ClearLog();
+
+	// failed loads are not cached
+	request.SetHTTPHeader( "Accept-Encoding", "" );
+	request.SetPath( "unknown" );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	CPPUNIT_ASSERT( response.GetLog().find( "Code: 500" ) != std::string::npos );
+	response.ClearLog();
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	CPPUNIT_ASSERT( response.GetLog().find( "Code: 500" ) != std::string::npos );
+	response.ClearLog();
+
+	// a store to the node drops its entries, so the next load sees what was stored
+	std::string storedData1a( "this is stored data in file 1a" );
+	StoreHandler storeHandler( client, false, 1024, &cache );
+	request.SetPath( "n1" );
+	request.SetPostData( storedData1a );
+	CPPUNIT_ASSERT_NO_THROW( storeHandler.Handle( request, response ) );
+	CPPUNIT_ASSERT( response.GetLog().find( "Code: 200" ) != std::string::npos );
+	response.ClearLog();
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	expected.str("");
+	expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			 << "WriteHeader called with Name: Content-Length Value: " << storedData1a.size() << std::endl
+			 << "WriteData called with Data: " << storedData1a << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+	response.ClearLog();
+
+	// and so does a delete
+	DeleteHandler deleteHandler( client, false, &cache );
+	CPPUNIT_ASSERT_NO_THROW( deleteHandler.Handle( request, response ) );
+	CPPUNIT_ASSERT( response.GetLog().find( "Code: 200" ) != std::string::npos );
+	response.ClearLog();
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	CPPUNIT_ASSERT( response.GetLog().find( "Code: 500" ) != std::string::npos );
+}
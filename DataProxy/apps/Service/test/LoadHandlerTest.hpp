@@ -26,7 +26,12 @@ private:
 	CPPUNIT_TEST(testLoad);
 	CPPUNIT_TEST(testLoadCompressed);
 	CPPUNIT_TEST(testLoadCompressedCustomLevel);
+	CPPUNIT_TEST(testLoadCompressedParallel);
+	CPPUNIT_TEST(testLoadCompressedNegotiation);
 	CPPUNIT_TEST(testLoadXForwardedFor);
+	CPPUNIT_TEST(testLoadStreaming);
+	CPPUNIT_TEST(testLoadETag);
+	CPPUNIT_TEST(testLoadCached);
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -40,7 +45,12 @@ public:
 	void testLoad();
 	void testLoadCompressed();
 	void testLoadCompressedCustomLevel();
+	void testLoadCompressedParallel();
+	void testLoadCompressedNegotiation();
 	void testLoadXForwardedFor();
+	void testLoadStreaming();
+	void testLoadETag();
+	void testLoadCached();
 
 private:
 	boost::scoped_ptr< TempDirectory > m_pTempDir;
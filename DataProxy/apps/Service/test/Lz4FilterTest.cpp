@@ -0,0 +1,144 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#include "Lz4FilterTest.hpp"
+#include "Lz4Filter.hpp"
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/copy.hpp>
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(Lz4FilterTest);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(Lz4FilterTest, "Lz4FilterTest");
+
+namespace
+{
+	std::string Compress( const std::string& i_rData, int i_Level, std::streamsize i_BufferSize = boost::iostreams::default_device_buffer_size )
+	{
+		std::stringstream result;
+		boost::iostreams::filtering_ostream filter;
+		filter.push( Lz4Compressor( i_Level, i_BufferSize ) );
+		filter.push( result );
+		filter << i_rData;
+		filter.reset();
+		return result.str();
+	}
+
+	std::string Decompress( const std::string& i_rData, std::streamsize i_BufferSize = boost::iostreams::default_device_buffer_size )
+	{
+		std::stringstream input( i_rData );
+		std::stringstream result;
+		boost::iostreams::filtering_istream filter;
+		filter.push( Lz4Decompressor( i_BufferSize ) );
+		filter.push( input );
+		boost::iostreams::copy( filter, result );
+		return result.str();
+	}
+
+	// reads the way a data node would, stopping at the first failure
+	std::string Read( std::istream& i_rInput )
+	{
+		std::string result;
+		char buffer[ 1024 ];
+		while( i_rInput.read( buffer, sizeof( buffer ) ) || i_rInput.gcount() > 0 )
+		{
+			result.append( buffer, i_rInput.gcount() );
+		}
+		return result;
+	}
+
+	std::string MakeData( size_t i_Size )
+	{
+		std::string result;
+		result.reserve( i_Size );
+		unsigned int value( 12345 );
+		while( result.size() < i_Size )
+		{
+			value = value * 1103515245 + 12345;
+			result.push_back( "abcdefgh,\n"[ ( value >> 16 ) % 10 ] );
+		}
+		return result;
+	}
+}
+
+Lz4FilterTest::Lz4FilterTest()
+{
+}
+
+Lz4FilterTest::~Lz4FilterTest()
+{
+}
+
+void Lz4FilterTest::testRoundTrip()
+{
+	std::string data( "this is some data, this is some data, this is some data" );
+	std::string result = Compress( data, 1 );
+
+	// the lz4 frame magic number
+	CPPUNIT_ASSERT_EQUAL( std::string( "\x04\x22\x4d\x18" ), result.substr( 0, 4 ) );
+	CPPUNIT_ASSERT_EQUAL( data, Decompress( result ) );
+
+	// larger than a single call's worth of input
+	data = MakeData( 300000 );
+	result = Compress( data, 1 );
+	CPPUNIT_ASSERT( result.size() < data.size() );
+	CPPUNIT_ASSERT_EQUAL( data, Decompress( result ) );
+}
+
+void Lz4FilterTest::testLevels()
+{
+	std::string data = MakeData( 100000 );
+	for( int level = 1; level <= 12; ++level )
+	{
+		std::string result = Compress( data, level );
+		CPPUNIT_ASSERT( result.size() < data.size() );
+		CPPUNIT_ASSERT_EQUAL( data, Decompress( result ) );
+	}
+}
+
+void Lz4FilterTest::testEmpty()
+{
+	std::string result = Compress( "", 1 );
+	CPPUNIT_ASSERT( !result.empty() );
+	CPPUNIT_ASSERT_EQUAL( std::string(""), Decompress( result ) );
+}
+
+void Lz4FilterTest::testSmallBuffers()
+{
+	// output is handed over a few bytes at a time in both directions
+	std::string data = MakeData( 70000 );
+	std::string result = Compress( data, 9, 7 );
+	CPPUNIT_ASSERT_EQUAL( result, Compress( data, 9 ) );
+	CPPUNIT_ASSERT_EQUAL( data, Decompress( result, 5 ) );
+}
+
+void Lz4FilterTest::testCorrupt()
+{
+	std::string data = MakeData( 1000 );
+	std::string result = Compress( data, 1 );
+
+	// a truncated frame fails the stream once the available data has been read
+	std::stringstream truncated( result.substr( 0, result.size() - 10 ) );
+	boost::iostreams::filtering_istream filter;
+	filter.push( Lz4Decompressor() );
+	filter.push( truncated );
+	std::string output = Read( filter );
+	CPPUNIT_ASSERT( filter.bad() );
+	CPPUNIT_ASSERT( output.size() < data.size() );
+	CPPUNIT_ASSERT_EQUAL( data.substr( 0, output.size() ), output );
+
+	// not lz4 at all
+	std::stringstream garbage( "this is not lz4 data" );
+	boost::iostreams::filtering_istream filter2;
+	filter2.push( Lz4Decompressor() );
+	filter2.push( garbage );
+	CPPUNIT_ASSERT_EQUAL( std::string(""), Read( filter2 ) );
+	CPPUNIT_ASSERT( filter2.bad() );
+}
@@ -0,0 +1,42 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#ifndef _LZ4_FILTER_TEST_HPP_
+#define _LZ4_FILTER_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class Lz4FilterTest : public CppUnit::TestFixture
+{
+private:
+
+	CPPUNIT_TEST_SUITE(Lz4FilterTest);
+	CPPUNIT_TEST(testRoundTrip);
+	CPPUNIT_TEST(testLevels);
+	CPPUNIT_TEST(testEmpty);
+	CPPUNIT_TEST(testSmallBuffers);
+	CPPUNIT_TEST(testCorrupt);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+
+	Lz4FilterTest();
+	virtual ~Lz4FilterTest();
+
+	void testRoundTrip();
+	void testLevels();
+	void testEmpty();
+	void testSmallBuffers();
+	void testCorrupt();
+};
+
+#endif //_LZ4_FILTER_TEST_HPP_
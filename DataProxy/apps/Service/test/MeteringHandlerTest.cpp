@@ -0,0 +1,76 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#include "MeteringHandlerTest.hpp"
+#include "MeteringHandler.hpp"
+#include "ServiceMetrics.hpp"
+#include "MockHTTPRequest.hpp"
+#include "MockHTTPResponse.hpp"
+#include "WebServerCommon.hpp"
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MeteringHandlerTest);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(MeteringHandlerTest, "MeteringHandlerTest");
+
+namespace
+{
+	// answers "bad" with an error, and anything else with its path
+	class EchoHandler : public IWebService
+	{
+	public:
+		virtual void Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse )
+		{
+			o_rResponse.SetHTTPStatusCode( i_rRequest.GetPath() == "bad" ? HTTP_STATUS_INTERNAL_SERVER_ERROR : HTTP_STATUS_OK );
+			o_rResponse.WriteHeader( "Name", "Value" );
+			o_rResponse.WriteData( i_rRequest.GetPath() );
+			o_rResponse.WriteData( i_rRequest.GetPath() );
+		}
+	};
+}
+
+MeteringHandlerTest::MeteringHandlerTest()
+{
+}
+
+MeteringHandlerTest::~MeteringHandlerTest()
+{
+}
+
+void MeteringHandlerTest::testHandle()
+{
+	ServiceMetrics metrics( 100 );
+	EchoHandler echoHandler;
+	MeteringHandler handler( echoHandler, metrics, "load" );
+
+	MockHTTPRequest request;
+	MockHTTPResponse response;
+
+	// the response goes through untouched
+	request.SetPath( "node/" );
+	handler.Handle( request, response );
+	std::stringstream expected;
+	expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+			 << "WriteHeader called with Name: Name Value: Value" << std::endl
+			 << "WriteData called with Data: node/" << std::endl
+			 << "WriteData called with Data: node/" << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+
+	request.SetPath( "bad" );
+	handler.Handle( request, response );
+
+	std::stringstream result;
+	metrics.Write( result );
+	CPPUNIT_ASSERT( result.str().find( "\ndataproxy_requests_total{node=\"node\",operation=\"load\"} 1\n" ) != std::string::npos );
+	CPPUNIT_ASSERT( result.str().find( "\ndataproxy_errors_total{node=\"node\",operation=\"load\"} 0\n" ) != std::string::npos );
+	CPPUNIT_ASSERT( result.str().find( "\ndataproxy_response_bytes_total{node=\"node\",operation=\"load\"} 10\n" ) != std::string::npos );
+	CPPUNIT_ASSERT( result.str().find( "\ndataproxy_requests_total{node=\"bad\",operation=\"load\"} 1\n" ) != std::string::npos );
+	CPPUNIT_ASSERT( result.str().find( "\ndataproxy_errors_total{node=\"bad\",operation=\"load\"} 1\n" ) != std::string::npos );
+}
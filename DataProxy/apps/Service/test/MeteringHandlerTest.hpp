@@ -0,0 +1,34 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#ifndef _METERING_HANDLER_TEST_HPP_
+#define _METERING_HANDLER_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class MeteringHandlerTest : public CppUnit::TestFixture
+{
+private:
+
+	CPPUNIT_TEST_SUITE(MeteringHandlerTest);
+	CPPUNIT_TEST(testHandle);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+
+	MeteringHandlerTest();
+	virtual ~MeteringHandlerTest();
+
+	void testHandle();
+};
+
+#endif //_METERING_HANDLER_TEST_HPP_
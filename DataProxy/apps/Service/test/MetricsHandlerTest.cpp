@@ -0,0 +1,91 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#include "MetricsHandlerTest.hpp"
+#include "MetricsHandler.hpp"
+#include "ServiceMetrics.hpp"
+#include "DataProxyService.hpp"
+#include "MockHTTPRequest.hpp"
+#include "MockHTTPResponse.hpp"
+#include "WebServerCommon.hpp"
+#include <boost/regex.hpp>
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MetricsHandlerTest);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(MetricsHandlerTest, "MetricsHandlerTest");
+
+namespace
+{
+	class EchoHandler : public IWebService
+	{
+	public:
+		virtual void Handle( HTTPRequest& i_rRequest, HTTPResponse& o_rResponse )
+		{
+			o_rResponse.SetHTTPStatusCode( HTTP_STATUS_OK );
+			o_rResponse.WriteData( i_rRequest.GetPath() );
+		}
+	};
+}
+
+MetricsHandlerTest::MetricsHandlerTest()
+{
+}
+
+MetricsHandlerTest::~MetricsHandlerTest()
+{
+}
+
+void MetricsHandlerTest::testHandle()
+{
+	ServiceMetrics metrics( 100 );
+	{
+		ServiceMetrics::Request request( metrics, "n1", "load" );
+		request.SetStatus( HTTP_STATUS_OK );
+	}
+	EchoHandler echoHandler;
+	MetricsHandler handler( metrics, "/_metrics", echoHandler );
+
+	MockHTTPRequest request;
+	MockHTTPResponse response;
+
+	// anything but the metrics path is a load
+	request.SetPath( "n1" );
+	handler.Handle( request, response );
+	std::stringstream expected;
+	expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+			 << "WriteData called with Data: n1" << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+	response.ClearLog();
+
+	std::stringstream metricsText;
+	metrics.Write( metricsText );
+	std::vector< std::string > paths;
+	paths.push_back( "_metrics" );
+	paths.push_back( "_metrics/" );
+	paths.push_back( "/_metrics" );
+	std::vector< std::string >::const_iterator iter = paths.begin();
+	for( ; iter != paths.end(); ++iter )
+	{
+		request.SetPath( *iter );
+		handler.Handle( request, response );
+		std::string log = response.GetLog();
+		response.ClearLog();
+
+		expected.str("");
+		expected << "SetHTTPStatusCode called with Code: 200 Message: \n"
+				 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << "\n"
+				 << "WriteHeader called with Name: Content-Type Value: text/plain; version=0\\.0\\.4\n"
+				 << "WriteHeader called with Name: Content-Length Value: \\d+\n"
+				 << "WriteData called with Data: # TYPE dataproxy_uptime_seconds gauge\n"
+				 << "(.*\n)*dataproxy_requests_total\\{node=\"n1\",operation=\"load\"\\} 1\n(.*\n)*";
+		CPPUNIT_ASSERT_MESSAGE( *iter + ": " + log, boost::regex_match( log, boost::regex( expected.str() ) ) );
+	}
+}
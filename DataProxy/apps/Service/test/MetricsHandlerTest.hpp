@@ -0,0 +1,34 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#ifndef _METRICS_HANDLER_TEST_HPP_
+#define _METRICS_HANDLER_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class MetricsHandlerTest : public CppUnit::TestFixture
+{
+private:
+
+	CPPUNIT_TEST_SUITE(MetricsHandlerTest);
+	CPPUNIT_TEST(testHandle);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+
+	MetricsHandlerTest();
+	virtual ~MetricsHandlerTest();
+
+	void testHandle();
+};
+
+#endif //_METRICS_HANDLER_TEST_HPP_
@@ -0,0 +1,178 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#include "ParallelGzipCompressorTest.hpp"
+#include "ParallelGzipCompressor.hpp"
+#include "AssertThrowWithMessage.hpp"
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/copy.hpp>
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ParallelGzipCompressorTest);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(ParallelGzipCompressorTest, "ParallelGzipCompressorTest");
+
+namespace
+{
+	std::string Compress( GzipBlockPool& i_rPool, int i_Level, size_t i_BlockSize, const std::string& i_rData )
+	{
+		std::stringstream result;
+		boost::iostreams::filtering_ostream filter;
+		filter.push( ParallelGzipCompressor( i_rPool, i_Level, i_BlockSize ) );
+		filter.push( result );
+		filter << i_rData;
+		filter.reset();
+		return result.str();
+	}
+
+	std::string Decompress( const std::string& i_rData )
+	{
+		std::stringstream input( i_rData );
+		std::stringstream result;
+		boost::iostreams::filtering_istream filter;
+		filter.push( boost::iostreams::gzip_decompressor() );
+		filter.push( input );
+		boost::iostreams::copy( filter, result );
+		return result.str();
+	}
+
+	// compressible, but not trivially so
+	std::string MakeData( size_t i_Size )
+	{
+		std::string result;
+		result.reserve( i_Size );
+		unsigned int value( 12345 );
+		while( result.size() < i_Size )
+		{
+			value = value * 1103515245 + 12345;
+			result.push_back( "abcdefgh,\n"[ ( value >> 16 ) % 10 ] );
+		}
+		return result;
+	}
+}
+
+ParallelGzipCompressorTest::ParallelGzipCompressorTest()
+{
+}
+
+ParallelGzipCompressorTest::~ParallelGzipCompressorTest()
+{
+}
+
+void ParallelGzipCompressorTest::testCompress()
+{
+	GzipBlockPool pool( 4 );
+	CPPUNIT_ASSERT_EQUAL( size_t( 4 ), pool.GetNumThreads() );
+
+	// less than a block, exactly one block, exactly several blocks, and a partial last block
+	std::string data = MakeData( 1000 );
+	CPPUNIT_ASSERT_EQUAL( data.substr( 0, 10 ), Decompress( Compress( pool, -1, 100, data.substr( 0, 10 ) ) ) );
+	CPPUNIT_ASSERT_EQUAL( data.substr( 0, 100 ), Decompress( Compress( pool, -1, 100, data.substr( 0, 100 ) ) ) );
+	CPPUNIT_ASSERT_EQUAL( data, Decompress( Compress( pool, -1, 100, data ) ) );
+	CPPUNIT_ASSERT_EQUAL( data.substr( 0, 950 ), Decompress( Compress( pool, -1, 100, data.substr( 0, 950 ) ) ) );
+
+	// the header is a plain gzip header: magic, deflate, no flags
+	std::string result = Compress( pool, -1, 100, data );
+	CPPUNIT_ASSERT_EQUAL( std::string( "\x1f\x8b\x08\x00", 4 ), result.substr( 0, 4 ) );
+
+	// data written in pieces that straddle blocks
+	std::stringstream output;
+	boost::iostreams::filtering_ostream filter;
+	filter.push( ParallelGzipCompressor( pool, 6, 64 ) );
+	filter.push( output, 7 );
+	for( size_t i = 0; i < data.size(); i += 33 )
+	{
+		filter.write( data.data() + i, std::min( size_t( 33 ), data.size() - i ) );
+	}
+	filter.reset();
+	CPPUNIT_ASSERT_EQUAL( data, Decompress( output.str() ) );
+}
+
+void ParallelGzipCompressorTest::testEmpty()
+{
+	GzipBlockPool pool( 2 );
+	std::string result = Compress( pool, -1, 100, "" );
+
+	// still a complete gzip member: header, an empty final block & the trailer
+	CPPUNIT_ASSERT( result.size() >= 20 );
+	CPPUNIT_ASSERT_EQUAL( std::string(""), Decompress( result ) );
+}
+
+void ParallelGzipCompressorTest::testLevels()
+{
+	GzipBlockPool pool( 3 );
+	std::string data = MakeData( 50000 );
+	for( int level = -1; level <= 9; ++level )
+	{
+		if( level == 0 )
+		{
+			continue;
+		}
+		std::string result = Compress( pool, level, 4096, data );
+		CPPUNIT_ASSERT( result.size() < data.size() );
+		CPPUNIT_ASSERT_EQUAL( data, Decompress( result ) );
+	}
+}
+
+void ParallelGzipCompressorTest::testManyBlocks()
+{
+	// many more blocks than may be pending at once, with a single thread
+	GzipBlockPool pool( 1 );
+	std::string data = MakeData( 200000 );
+	CPPUNIT_ASSERT_EQUAL( data, Decompress( Compress( pool, 1, 1000, data ) ) );
+}
+
+void ParallelGzipCompressorTest::testSharedPool()
+{
+	GzipBlockPool pool( 2 );
+	std::string data1 = MakeData( 10000 );
+	std::string data2 = MakeData( 7777 );
+
+	// two compressors interleaving their writes on the same pool
+	std::stringstream output1;
+	std::stringstream output2;
+	boost::iostreams::filtering_ostream filter1;
+	boost::iostreams::filtering_ostream filter2;
+	filter1.push( ParallelGzipCompressor( pool, 5, 512 ) );
+	filter1.push( output1 );
+	filter2.push( ParallelGzipCompressor( pool, 5, 300 ) );
+	filter2.push( output2 );
+	for( size_t i = 0; i < data1.size(); i += 1000 )
+	{
+		filter1.write( data1.data() + i, std::min( size_t( 1000 ), data1.size() - i ) );
+		if( i < data2.size() )
+		{
+			filter2.write( data2.data() + i, std::min( size_t( 1000 ), data2.size() - i ) );
+		}
+	}
+	filter1.reset();
+	filter2.reset();
+	CPPUNIT_ASSERT_EQUAL( data1, Decompress( output1.str() ) );
+	CPPUNIT_ASSERT_EQUAL( data2, Decompress( output2.str() ) );
+}
+
+void ParallelGzipCompressorTest::testIllegal()
+{
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( GzipBlockPool( 0 ), ParallelGzipException, ".*:\\d+: Number of threads must be positive" );
+
+	GzipBlockPool pool( 1 );
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( ParallelGzipCompressor( pool, 1, 0 ), ParallelGzipException, ".*:\\d+: Block size must be positive" );
+
+	// zlib rejects the level when a block is deflated, which fails the stream once the block is collected
+	std::stringstream output;
+	boost::iostreams::filtering_ostream filter;
+	filter.push( ParallelGzipCompressor( pool, 12, 10 ) );
+	filter.push( output );
+	filter << MakeData( 100 );
+	filter.flush();
+	CPPUNIT_ASSERT( filter.bad() );
+	CPPUNIT_ASSERT_EQUAL( std::string(""), output.str() );
+}
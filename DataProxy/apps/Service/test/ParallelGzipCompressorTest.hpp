@@ -0,0 +1,44 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#ifndef _PARALLEL_GZIP_COMPRESSOR_TEST_HPP_
+#define _PARALLEL_GZIP_COMPRESSOR_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class ParallelGzipCompressorTest : public CppUnit::TestFixture
+{
+private:
+
+	CPPUNIT_TEST_SUITE(ParallelGzipCompressorTest);
+	CPPUNIT_TEST(testCompress);
+	CPPUNIT_TEST(testEmpty);
+	CPPUNIT_TEST(testLevels);
+	CPPUNIT_TEST(testManyBlocks);
+	CPPUNIT_TEST(testSharedPool);
+	CPPUNIT_TEST(testIllegal);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+
+	ParallelGzipCompressorTest();
+	virtual ~ParallelGzipCompressorTest();
+
+	void testCompress();
+	void testEmpty();
+	void testLevels();
+	void testManyBlocks();
+	void testSharedPool();
+	void testIllegal();
+};
+
+#endif //_PARALLEL_GZIP_COMPRESSOR_TEST_HPP_
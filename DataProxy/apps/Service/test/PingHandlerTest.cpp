@@ -70,17 +70,17 @@ void PingHandlerTest::testPing()
 
 	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
 
-	PingHandler handler( client, dplConfigFileSpec );
+	PingHandler handler( client );
 	
 	request.SetQueryParams( params );
 	request.SetPath( "n1" );
 
-	// error condition #1: initialization fails because the file doesn't exist
+	// error condition #1: the client has not been initialized with a config
 	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
 	std::stringstream expected;
 	expected << "SetHTTPStatusCode called with Code: 500 Message: " << std::endl
 			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
-			 << "WriteData called with Data: Error initializing DPL with file: " << dplConfigFileSpec << ": private/DataProxyClient.cpp:\\d+: Cannot find config file.*";
+			 << "WriteData called with Data: Error pinging node: n1 with mode \\d+: private/DataProxyClient.cpp:\\d+: Attempted to issue Ping request on uninitialized DataProxyClient.*";
 	CPPUNIT_ASSERT_REGEX_MATCH( expected.str(), response.GetLog() );
 	response.ClearLog();
 	expected.str("");
@@ -91,6 +91,7 @@ void PingHandlerTest::testPing()
 		 << "  <DataNode name=\"n1\" type=\"local\" location=\"" << m_pTempDir->GetDirectoryName() << "\" />" << std::endl
 		 << "</DplConfig>" << std::endl;
 	file.close();
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( dplConfigFileSpec ) );
 
 	// successful ping
 	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
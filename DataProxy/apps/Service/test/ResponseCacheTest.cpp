@@ -0,0 +1,176 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#include "ResponseCacheTest.hpp"
+#include "ResponseCache.hpp"
+#include <boost/thread/thread.hpp>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ResponseCacheTest);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(ResponseCacheTest, "ResponseCacheTest");
+
+namespace
+{
+	boost::shared_ptr< const ResponseCache::Response > MakeResponse( const std::string& i_rData, const std::string& i_rETag = "" )
+	{
+		boost::shared_ptr< ResponseCache::Response > pResult( new ResponseCache::Response() );
+		pResult->m_Data = i_rData;
+		pResult->m_ETag = i_rETag;
+		return pResult;
+	}
+}
+
+ResponseCacheTest::ResponseCacheTest()
+{
+}
+
+ResponseCacheTest::~ResponseCacheTest()
+{
+}
+
+void ResponseCacheTest::testGetPut()
+{
+	ResponseCache cache( 3600, 1024 );
+	CPPUNIT_ASSERT( !cache.Get( "key1" ) );
+
+	cache.Put( "key1", MakeResponse( "data1", "\"tag1\"" ) );
+	boost::shared_ptr< const ResponseCache::Response > pResponse = cache.Get( "key1" );
+	CPPUNIT_ASSERT( pResponse );
+	CPPUNIT_ASSERT_EQUAL( std::string( "data1" ), pResponse->m_Data );
+	CPPUNIT_ASSERT_EQUAL( std::string( "\"tag1\"" ), pResponse->m_ETag );
+	CPPUNIT_ASSERT_EQUAL( size_t( 4 + 5 + 6 ), cache.GetBytes() );
+	CPPUNIT_ASSERT( !cache.Get( "key2" ) );
+
+	// replacing an entry replaces its size too
+	cache.Put( "key1", MakeResponse( "data" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "data" ), cache.Get( "key1" )->m_Data );
+	CPPUNIT_ASSERT_EQUAL( size_t( 4 + 4 ), cache.GetBytes() );
+
+	// a response that has been handed out outlives its replacement
+	cache.Put( "key1", MakeResponse( "other" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "data1" ), pResponse->m_Data );
+}
+
+void ResponseCacheTest::testExpiration()
+{
+	ResponseCache cache( 0.1, 1024 );
+	cache.Put( "key1", MakeResponse( "data1" ) );
+	CPPUNIT_ASSERT( cache.Get( "key1" ) );
+
+	boost::this_thread::sleep( boost::posix_time::milliseconds( 200 ) );
+	CPPUNIT_ASSERT( !cache.Get( "key1" ) );
+	CPPUNIT_ASSERT_EQUAL( size_t( 0 ), cache.GetBytes() );
+}
+
+void ResponseCacheTest::testEviction()
+{
+	// room for three 10-byte entries
+	ResponseCache cache( 3600, 30 );
+	cache.Put( "key1", MakeResponse( "123456" ) );
+	cache.Put( "key2", MakeResponse( "123456" ) );
+	cache.Put( "key3", MakeResponse( "123456" ) );
+	CPPUNIT_ASSERT_EQUAL( size_t( 30 ), cache.GetBytes() );
+
+	// using key1 makes key2 the least recently used
+	CPPUNIT_ASSERT( cache.Get( "key1" ) );
+	cache.Put( "key4", MakeResponse( "123456" ) );
+	CPPUNIT_ASSERT( cache.Get( "key1" ) );
+	CPPUNIT_ASSERT( !cache.Get( "key2" ) );
+	CPPUNIT_ASSERT( cache.Get( "key3" ) );
+	CPPUNIT_ASSERT( cache.Get( "key4" ) );
+	CPPUNIT_ASSERT_EQUAL( size_t( 30 ), cache.GetBytes() );
+
+	// a larger entry pushes out as many as it needs to
+	cache.Put( "key5", MakeResponse( "1234567890123456" ) );
+	CPPUNIT_ASSERT( !cache.Get( "key1" ) );
+	CPPUNIT_ASSERT( !cache.Get( "key3" ) );
+	CPPUNIT_ASSERT( cache.Get( "key4" ) );
+	CPPUNIT_ASSERT( cache.Get( "key5" ) );
+	CPPUNIT_ASSERT_EQUAL( size_t( 30 ), cache.GetBytes() );
+}
+
+void ResponseCacheTest::testOversized()
+{
+	ResponseCache cache( 3600, 10 );
+	cache.Put( "key1", MakeResponse( "123456" ) );
+	cache.Put( "key2", MakeResponse( "12345678" ) );
+
+	// the entry that could not fit is dropped without disturbing the rest
+	CPPUNIT_ASSERT( cache.Get( "key1" ) );
+	CPPUNIT_ASSERT( !cache.Get( "key2" ) );
+	CPPUNIT_ASSERT_EQUAL( size_t( 10 ), cache.GetBytes() );
+}
+
+void ResponseCacheTest::testMakeKey()
+{
+	std::map< std::string, std::string > params1;
+	params1[ "a" ] = "b";
+	params1[ "c" ] = "d";
+	std::map< std::string, std::string > params2;
+	params2[ "a" ] = "bc";
+	params2[ "" ] = "d";
+	std::map< std::string, std::string > params3;
+	params3[ "a" ] = "b";
+
+	CPPUNIT_ASSERT_EQUAL( ResponseCache::MakeKey( "n1", params1, "gzip" ), ResponseCache::MakeKey( "n1", params1, "gzip" ) );
+	CPPUNIT_ASSERT( ResponseCache::MakeKey( "n1", params1, "gzip" ) != ResponseCache::MakeKey( "n2", params1, "gzip" ) );
+	CPPUNIT_ASSERT( ResponseCache::MakeKey( "n1", params1, "gzip" ) != ResponseCache::MakeKey( "n1", params1, "" ) );
+	CPPUNIT_ASSERT( ResponseCache::MakeKey( "n1", params1, "" ) != ResponseCache::MakeKey( "n1", params2, "" ) );
+	CPPUNIT_ASSERT( ResponseCache::MakeKey( "n1", params1, "" ) != ResponseCache::MakeKey( "n1", params3, "" ) );
+	CPPUNIT_ASSERT( ResponseCache::MakeKey( "n1", params3, "" ) != ResponseCache::MakeKey( "n1a", std::map< std::string, std::string >(), "" ) );
+}
+
+void ResponseCacheTest::testInvalidate()
+{
+	std::map< std::string, std::string > parameters;
+	parameters[ "param1" ] = "value1";
+	std::string key1( ResponseCache::MakeKey( "n1", parameters, "" ) );
+	std::string key1Gzip( ResponseCache::MakeKey( "n1", parameters, "gzip" ) );
+	std::string key2( ResponseCache::MakeKey( "n2", parameters, "" ) );
+	// a name that another starts with
+	std::string key11( ResponseCache::MakeKey( "n11", parameters, "" ) );
+
+	ResponseCache cache( 3600, 1024 );
+	cache.Put( key1, MakeResponse( "data1" ) );
+	cache.Put( key1Gzip, MakeResponse( "gzipped1" ) );
+	cache.Put( key2, MakeResponse( "data2" ) );
+	cache.Put( key11, MakeResponse( "data11" ) );
+
+	// invalidating a node drops each of its entries, and only those
+	size_t generation = cache.GetGeneration();
+	cache.Invalidate( "n1" );
+	CPPUNIT_ASSERT( !cache.Get( key1 ) );
+	CPPUNIT_ASSERT( !cache.Get( key1Gzip ) );
+	CPPUNIT_ASSERT( cache.Get( key2 ) );
+	CPPUNIT_ASSERT( cache.Get( key11 ) );
+	CPPUNIT_ASSERT_EQUAL( key2.size() + 5 + key11.size() + 6, cache.GetBytes() );
+
+	// a response loaded before the invalidation may be stale, so it isn't stored
+	cache.Put( key1, MakeResponse( "data1" ), generation );
+	CPPUNIT_ASSERT( !cache.Get( key1 ) );
+	cache.Put( key1, MakeResponse( "data1" ), cache.GetGeneration() );
+	CPPUNIT_ASSERT( cache.Get( key1 ) );
+
+	{
+		ResponseCache::ScopedInvalidation invalidation( &cache, "n2" );
+		CPPUNIT_ASSERT( cache.Get( key2 ) );
+	}
+	CPPUNIT_ASSERT( !cache.Get( key2 ) );
+	CPPUNIT_ASSERT( cache.Get( key1 ) );
+
+	// clearing drops everything
+	generation = cache.GetGeneration();
+	cache.Clear();
+	CPPUNIT_ASSERT( !cache.Get( key1 ) );
+	CPPUNIT_ASSERT( !cache.Get( key11 ) );
+	CPPUNIT_ASSERT_EQUAL( size_t( 0 ), cache.GetBytes() );
+	cache.Put( key1, MakeResponse( "data1" ), generation );
+	CPPUNIT_ASSERT( !cache.Get( key1 ) );
+}
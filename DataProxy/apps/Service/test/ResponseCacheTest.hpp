@@ -0,0 +1,44 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#ifndef _RESPONSE_CACHE_TEST_HPP_
+#define _RESPONSE_CACHE_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class ResponseCacheTest : public CppUnit::TestFixture
+{
+private:
+
+	CPPUNIT_TEST_SUITE(ResponseCacheTest);
+	CPPUNIT_TEST(testGetPut);
+	CPPUNIT_TEST(testExpiration);
+	CPPUNIT_TEST(testEviction);
+	CPPUNIT_TEST(testOversized);
+	CPPUNIT_TEST(testMakeKey);
+	CPPUNIT_TEST(testInvalidate);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+
+	ResponseCacheTest();
+	virtual ~ResponseCacheTest();
+
+	void testGetPut();
+	void testExpiration();
+	void testEviction();
+	void testOversized();
+	void testMakeKey();
+	void testInvalidate();
+};
+
+#endif //_RESPONSE_CACHE_TEST_HPP_
@@ -0,0 +1,209 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#include "ServiceMetricsTest.hpp"
+#include "ServiceMetrics.hpp"
+#include <boost/regex.hpp>
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ServiceMetricsTest);
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(ServiceMetricsTest, "ServiceMetricsTest");
+
+namespace
+{
+	std::string Write( const ServiceMetrics& i_rMetrics )
+	{
+		std::stringstream result;
+		i_rMetrics.Write( result );
+		return result.str();
+	}
+
+	// the value of the line for a metric, or empty if there is none
+	std::string GetValue( const std::string& i_rMetrics, const std::string& i_rName )
+	{
+		std::string prefix = i_rName + " ";
+		size_t pos = i_rMetrics.find( "\n" + prefix );
+		if( pos == std::string::npos )
+		{
+			return "";
+		}
+		pos += prefix.size() + 1;
+		return i_rMetrics.substr( pos, i_rMetrics.find( '\n', pos ) - pos );
+	}
+}
+
+ServiceMetricsTest::ServiceMetricsTest()
+{
+}
+
+ServiceMetricsTest::~ServiceMetricsTest()
+{
+}
+
+void ServiceMetricsTest::testHistogramBuckets()
+{
+	// small values are exact
+	for( boost::uint64_t i = 0; i < 8; ++i )
+	{
+		CPPUNIT_ASSERT_EQUAL( size_t( i ), LatencyHistogram::GetBucket( i ) );
+		CPPUNIT_ASSERT_EQUAL( i, LatencyHistogram::GetBucketLimit( i ) );
+	}
+
+	// beyond that, each power of two is split in four
+	CPPUNIT_ASSERT_EQUAL( size_t( 8 ), LatencyHistogram::GetBucket( 8 ) );
+	CPPUNIT_ASSERT_EQUAL( size_t( 8 ), LatencyHistogram::GetBucket( 9 ) );
+	CPPUNIT_ASSERT_EQUAL( size_t( 9 ), LatencyHistogram::GetBucket( 10 ) );
+	CPPUNIT_ASSERT_EQUAL( size_t( 11 ), LatencyHistogram::GetBucket( 15 ) );
+	CPPUNIT_ASSERT_EQUAL( size_t( 12 ), LatencyHistogram::GetBucket( 16 ) );
+	CPPUNIT_ASSERT_EQUAL( boost::uint64_t( 9 ), LatencyHistogram::GetBucketLimit( 8 ) );
+	CPPUNIT_ASSERT_EQUAL( boost::uint64_t( 15 ), LatencyHistogram::GetBucketLimit( 11 ) );
+	CPPUNIT_ASSERT_EQUAL( boost::uint64_t( 19 ), LatencyHistogram::GetBucketLimit( 12 ) );
+
+	// every value falls at or under the limit of its bucket, and above the limit of the one before
+	boost::uint64_t values[] = { 100, 1000, 12345, 999999, 1000000, 123456789, 0xffffffffffffffffULL };
+	for( size_t i = 0; i < sizeof( values ) / sizeof( values[0] ); ++i )
+	{
+		size_t bucket = LatencyHistogram::GetBucket( values[i] );
+		CPPUNIT_ASSERT( values[i] <= LatencyHistogram::GetBucketLimit( bucket ) );
+		CPPUNIT_ASSERT( values[i] > LatencyHistogram::GetBucketLimit( bucket - 1 ) );
+	}
+	CPPUNIT_ASSERT_EQUAL( size_t( 4 * 63 - 1 ), LatencyHistogram::GetBucket( 0xffffffffffffffffULL ) );
+}
+
+void ServiceMetricsTest::testHistogramQuantiles()
+{
+	LatencyHistogram histogram;
+	CPPUNIT_ASSERT_EQUAL( boost::uint64_t( 0 ), histogram.GetQuantile( 0.5 ) );
+
+	// 1000 requests of 1ms-1s
+	for( boost::uint64_t i = 1; i <= 1000; ++i )
+	{
+		histogram.Record( i * 1000 );
+	}
+	CPPUNIT_ASSERT_EQUAL( boost::uint64_t( 1000 ), histogram.GetCount() );
+	CPPUNIT_ASSERT_EQUAL( boost::uint64_t( 500500000 ), histogram.GetSum() );
+	CPPUNIT_ASSERT_EQUAL( boost::uint64_t( 1000000 ), histogram.GetMax() );
+
+	// quantiles are within a quarter power of two above the true value
+	double quantiles[] = { 0.5, 0.9, 0.99 };
+	for( size_t i = 0; i < sizeof( quantiles ) / sizeof( quantiles[0] ); ++i )
+	{
+		double actual = quantiles[i] * 1000000;
+		boost::uint64_t estimate = histogram.GetQuantile( quantiles[i] );
+		CPPUNIT_ASSERT( estimate >= actual );
+		CPPUNIT_ASSERT( estimate <= actual * 1.25 );
+	}
+
+	// never more than the max
+	CPPUNIT_ASSERT_EQUAL( boost::uint64_t( 1000000 ), histogram.GetQuantile( 1 ) );
+}
+
+void ServiceMetricsTest::testRequests()
+{
+	ServiceMetrics metrics( 100 );
+	{
+		ServiceMetrics::Request request1( metrics, "n1", "load" );
+		ServiceMetrics::Request request2( metrics, "n1", "load" );
+		request1.SetStatus( 200 );
+		request1.AddBytes( 10 );
+		request1.AddBytes( 5 );
+		request2.SetStatus( 304 );
+
+		std::string result = Write( metrics );
+		CPPUNIT_ASSERT_EQUAL( std::string( "2" ), GetValue( result, "dataproxy_requests_in_flight{node=\"n1\",operation=\"load\"}" ) );
+		CPPUNIT_ASSERT_EQUAL( std::string( "0" ), GetValue( result, "dataproxy_requests_total{node=\"n1\",operation=\"load\"}" ) );
+	}
+	{
+		ServiceMetrics::Request request( metrics, "n1", "load" );
+		request.SetStatus( 500 );
+		request.AddBytes( 20 );
+	}
+	{
+		// a request that never got a status is an error too
+		ServiceMetrics::Request request( metrics, "n1", "store" );
+	}
+
+	std::string result = Write( metrics );
+	CPPUNIT_ASSERT_EQUAL( std::string( "0" ), GetValue( result, "dataproxy_requests_in_flight{node=\"n1\",operation=\"load\"}" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "3" ), GetValue( result, "dataproxy_requests_total{node=\"n1\",operation=\"load\"}" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "1" ), GetValue( result, "dataproxy_errors_total{node=\"n1\",operation=\"load\"}" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "35" ), GetValue( result, "dataproxy_response_bytes_total{node=\"n1\",operation=\"load\"}" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "3" ), GetValue( result, "dataproxy_latency_seconds_count{node=\"n1\",operation=\"load\"}" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "1" ), GetValue( result, "dataproxy_requests_total{node=\"n1\",operation=\"store\"}" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "1" ), GetValue( result, "dataproxy_errors_total{node=\"n1\",operation=\"store\"}" ) );
+}
+
+void ServiceMetricsTest::testMaxNodes()
+{
+	ServiceMetrics metrics( 2 );
+	{
+		ServiceMetrics::Request request1( metrics, "n1", "load" );
+		ServiceMetrics::Request request2( metrics, "n2", "load" );
+		ServiceMetrics::Request request3( metrics, "n3", "load" );
+		ServiceMetrics::Request request4( metrics, "n4", "store" );
+
+		// nodes already seen can still have new operations
+		ServiceMetrics::Request request5( metrics, "n1", "delete" );
+	}
+
+	std::string result = Write( metrics );
+	CPPUNIT_ASSERT_EQUAL( std::string( "1" ), GetValue( result, "dataproxy_requests_total{node=\"n1\",operation=\"load\"}" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "1" ), GetValue( result, "dataproxy_requests_total{node=\"n1\",operation=\"delete\"}" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "1" ), GetValue( result, "dataproxy_requests_total{node=\"n2\",operation=\"load\"}" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "" ), GetValue( result, "dataproxy_requests_total{node=\"n3\",operation=\"load\"}" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "1" ), GetValue( result, "dataproxy_requests_total{node=\"__other\",operation=\"load\"}" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "1" ), GetValue( result, "dataproxy_requests_total{node=\"__other\",operation=\"store\"}" ) );
+
+	// a node named like the overflow is counted with it, without taking up one of the slots
+	ServiceMetrics reservedMetrics( 1 );
+	{
+		ServiceMetrics::Request request1( reservedMetrics, ServiceMetrics::OTHER_NODES, "load" );
+		ServiceMetrics::Request request2( reservedMetrics, "n1", "load" );
+		ServiceMetrics::Request request3( reservedMetrics, "n2", "load" );
+	}
+	result = Write( reservedMetrics );
+	CPPUNIT_ASSERT_EQUAL( std::string( "1" ), GetValue( result, "dataproxy_requests_total{node=\"n1\",operation=\"load\"}" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "2" ), GetValue( result, "dataproxy_requests_total{node=\"__other\",operation=\"load\"}" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string::npos, result.find( "node=\"n2\"" ) );
+	CPPUNIT_ASSERT_EQUAL( result.find( "dataproxy_requests_total{node=\"__other\"" ), result.rfind( "dataproxy_requests_total{node=\"__other\"" ) );
+}
+
+void ServiceMetricsTest::testWrite()
+{
+	ServiceMetrics metrics( 100 );
+	{
+		ServiceMetrics::Request request( metrics, "a\"b", "load" );
+		request.SetStatus( 200 );
+	}
+
+	std::string labels( "\\{node=\"a\\\\\"b\",operation=\"load\"" );
+	std::stringstream expected;
+	expected << "# TYPE dataproxy_uptime_seconds gauge\n"
+			 << "dataproxy_uptime_seconds \\d+\\.\\d{3}\n"
+			 << "# TYPE dataproxy_requests_total counter\n"
+			 << "dataproxy_requests_total" << labels << "\\} 1\n"
+			 << "# TYPE dataproxy_errors_total counter\n"
+			 << "dataproxy_errors_total" << labels << "\\} 0\n"
+			 << "# TYPE dataproxy_response_bytes_total counter\n"
+			 << "dataproxy_response_bytes_total" << labels << "\\} 0\n"
+			 << "# TYPE dataproxy_requests_in_flight gauge\n"
+			 << "dataproxy_requests_in_flight" << labels << "\\} 0\n"
+			 << "# TYPE dataproxy_latency_seconds summary\n"
+			 << "dataproxy_latency_seconds" << labels << ",quantile=\"0\\.5\"\\} \\d+\\.\\d{6}\n"
+			 << "dataproxy_latency_seconds" << labels << ",quantile=\"0\\.9\"\\} \\d+\\.\\d{6}\n"
+			 << "dataproxy_latency_seconds" << labels << ",quantile=\"0\\.99\"\\} \\d+\\.\\d{6}\n"
+			 << "dataproxy_latency_seconds_sum" << labels << "\\} \\d+\\.\\d{6}\n"
+			 << "dataproxy_latency_seconds_count" << labels << "\\} 1\n"
+			 << "# TYPE dataproxy_latency_seconds_max gauge\n"
+			 << "dataproxy_latency_seconds_max" << labels << "\\} \\d+\\.\\d{6}\n";
+	std::string result = Write( metrics );
+	CPPUNIT_ASSERT_MESSAGE( result, boost::regex_match( result, boost::regex( expected.str() ) ) );
+}
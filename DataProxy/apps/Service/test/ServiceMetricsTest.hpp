@@ -0,0 +1,42 @@
+//
+// FILE NAME:       $HeadURL$
+//
+// REVISION:        $Revision$
+//
+// COPYRIGHT:       (c) 2007 Advertising.com All Rights Reserved.
+//
+// LAST UPDATED:    $Date$
+//
+// UPDATED BY:      $Author$
+
+#ifndef _SERVICE_METRICS_TEST_HPP_
+#define _SERVICE_METRICS_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class ServiceMetricsTest : public CppUnit::TestFixture
+{
+private:
+
+	CPPUNIT_TEST_SUITE(ServiceMetricsTest);
+	CPPUNIT_TEST(testHistogramBuckets);
+	CPPUNIT_TEST(testHistogramQuantiles);
+	CPPUNIT_TEST(testRequests);
+	CPPUNIT_TEST(testMaxNodes);
+	CPPUNIT_TEST(testWrite);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+
+	ServiceMetricsTest();
+	virtual ~ServiceMetricsTest();
+
+	void testHistogramBuckets();
+	void testHistogramQuantiles();
+	void testRequests();
+	void testMaxNodes();
+	void testWrite();
+};
+
+#endif //_SERVICE_METRICS_TEST_HPP_
@@ -13,6 +13,7 @@
 #include "DataProxyService.hpp"
 #include "DataProxyClient.hpp"
 #include "StoreHandler.hpp"
+#include "Lz4Filter.hpp"
 #include "TempDirectory.hpp"
 #include "FileUtilities.hpp"
 #include "MockHTTPRequest.hpp"
@@ -21,6 +22,9 @@
 #include "AssertFileContents.hpp"
 #include "XMLUtilities.hpp"
 #include <boost/regex.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/zstd.hpp>
 #include <fstream>
 
 CPPUNIT_TEST_SUITE_REGISTRATION(StoreHandlerTest);
@@ -28,12 +32,26 @@ CPPUNIT_TEST_SUITE_NAMED_REGISTRATION(StoreHandlerTest, "StoreHandlerTest");
 
 namespace
 {
+	const size_t MAX_DECODED_BODY_SIZE( 16 * 1024 * 1024 );
+
 	void WriteFile( const std::string& i_rFileSpec, const std::string& i_rData )
 	{
 		std::ofstream file( i_rFileSpec.c_str() );
 		file << i_rData;
 		file.close();
 	}
+
+	template< typename T_Compressor >
+	std::string Compress( const T_Compressor& i_rCompressor, const std::string& i_rData )
+	{
+		std::stringstream result;
+		boost::iostreams::filtering_ostream filter;
+		filter.push( i_rCompressor );
+		filter.push( result );
+		filter << i_rData;
+		filter.reset();
+		return result.str();
+	}
 }
 
 StoreHandlerTest::StoreHandlerTest()
@@ -87,18 +105,18 @@ void StoreHandlerTest::testStore()
 
 	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
 
-	StoreHandler handler( client, dplConfigFileSpec, false );
+	StoreHandler handler( client, false, MAX_DECODED_BODY_SIZE, NULL );
 	
 	request.SetQueryParams( paramsA );
 	request.SetPath( "n1" );
 	request.SetPostData( data1a );
 
-	// error condition #1: initialization fails because the file doesn't exist
+	// error condition #1: the client has not been initialized with a config
 	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
 	std::stringstream expected;
 	expected << "SetHTTPStatusCode called with Code: 500 Message: " << std::endl
 			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
-			 << "WriteData called with Data: Error initializing DPL with file: " << dplConfigFileSpec << ": private/DataProxyClient.cpp:\\d+: Cannot find config file.*";
+			 << "WriteData called with Data: Error storing data to node: n1: private/DataProxyClient.cpp:\\d+: Attempted to issue Store request on uninitialized DataProxyClient.*";
 	CPPUNIT_ASSERT( boost::regex_match( response.GetLog(), boost::regex( expected.str() ) ) );
 	response.ClearLog();
 	expected.str("");
@@ -110,6 +128,7 @@ void StoreHandlerTest::testStore()
 		 << "  <DataNode name=\"n2\" type=\"local\" location=\"" << dir2 << "\" />" << std::endl
 		 << "</DplConfig>" << std::endl;
 	file.close();
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( dplConfigFileSpec ) );
 
 	// successful store
 	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
@@ -176,7 +195,7 @@ void StoreHandlerTest::testStoreXForwardedFor()
 
 	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
 
-	StoreHandler handler( client, dplConfigFileSpec, true );
+	StoreHandler handler( client, true, MAX_DECODED_BODY_SIZE, NULL );
 	
 	request.SetQueryParams( paramsA );
 	request.SetPath( "n1" );
@@ -188,6 +207,7 @@ void StoreHandlerTest::testStoreXForwardedFor()
 		 << "  <DataNode name=\"n1\" type=\"local\" location=\"" << dir1 << "\" />" << std::endl
 		 << "</DplConfig>" << std::endl;
 	file.close();
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( dplConfigFileSpec ) );
 
 	// successful store
 	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
@@ -216,3 +236,165 @@ void StoreHandlerTest::testStoreXForwardedFor()
 	CPPUNIT_ASSERT_FILE_CONTENTS( data2a, file2a );
 }
 
+void StoreHandlerTest::testStoreCompressed()
+{
+	DataProxyClient client;
+	MockHTTPRequest request;
+	MockHTTPResponse response;
+
+	std::map< std::string, std::string > params;
+	params[ "param1" ] = "value1";
+
+	std::string dir1( m_pTempDir->GetDirectoryName() + "/dir1" );
+	CPPUNIT_ASSERT_NO_THROW( FileUtilities::CreateDirectory( dir1 ) );
+	std::string file1( dir1 + "/" + ProxyUtilities::ToString( params ) );
+
+	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
+
+	StoreHandler handler( client, false, MAX_DECODED_BODY_SIZE, NULL );
+	
+	request.SetQueryParams( params );
+	request.SetPath( "n1" );
+
+	std::ofstream file( dplConfigFileSpec.c_str() );
+	file << "<DplConfig>" << std::endl
+		 << "  <DataNode name=\"n1\" type=\"local\" location=\"" << dir1 << "\" />" << std::endl
+		 << "</DplConfig>" << std::endl;
+	file.close();
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( dplConfigFileSpec ) );
+
+	std::stringstream expected;
+	expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			 << "WriteData called with Data: " << std::endl;
+
+	// each body is stored decoded
+	std::string gzipData( "this is some gzip data" );
+	request.SetHTTPHeader( "Content-Encoding", "gzip" );
+	request.SetPostData( Compress( boost::iostreams::gzip_compressor(), gzipData ) );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+	CPPUNIT_ASSERT_FILE_CONTENTS( gzipData, file1 );
+	response.ClearLog();
+
+	std::string zstdData( "this is some zstd data" );
+	request.SetHTTPHeader( "Content-Encoding", "zstd" );
+	request.SetPostData( Compress( boost::iostreams::zstd_compressor(), zstdData ) );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+	CPPUNIT_ASSERT_FILE_CONTENTS( zstdData, file1 );
+	response.ClearLog();
+
+	std::string lz4Data( "this is some lz4 data" );
+	request.SetHTTPHeader( "Content-Encoding", "lz4" );
+	request.SetPostData( Compress( Lz4Compressor( 1 ), lz4Data ) );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+	CPPUNIT_ASSERT_FILE_CONTENTS( lz4Data, file1 );
+	response.ClearLog();
+
+	std::string identityData( "this is some uncompressed data" );
+	request.SetHTTPHeader( "Content-Encoding", "identity" );
+	request.SetPostData( identityData );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+	CPPUNIT_ASSERT_FILE_CONTENTS( identityData, file1 );
+	response.ClearLog();
+	expected.str("");
+
+	// an encoding that is not supported
+	request.SetHTTPHeader( "Content-Encoding", "br" );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	expected << "SetHTTPStatusCode called with Code: 500 Message: " << std::endl
+			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			 << "WriteData called with Data: Error storing data to node: n1: .*StoreHandler.cpp:\\d+: Unsupported Content-Encoding: br" << std::endl;
+	CPPUNIT_ASSERT_MESSAGE( response.GetLog(), boost::regex_match( response.GetLog(), boost::regex( expected.str() ) ) );
+	response.ClearLog();
+	expected.str("");
+
+	// a body that does not decode
+	request.SetHTTPHeader( "Content-Encoding", "lz4" );
+	request.SetPostData( "this is not lz4 data" );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	expected << "SetHTTPStatusCode called with Code: 500 Message: " << std::endl
+			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			 << "WriteData called with Data: Error storing data to node: n1: .*" << std::endl;
+	CPPUNIT_ASSERT_MESSAGE( response.GetLog(), boost::regex_match( response.GetLog(), boost::regex( expected.str() ) ) );
+	CPPUNIT_ASSERT_FILE_CONTENTS( identityData, file1 );
+	response.ClearLog();
+
+	// bodies that fail to decode only after much of the data has been read don't get stored either
+	std::stringstream largeData;
+	for( int i = 0; i < 100000; ++i )
+	{
+		largeData << "line " << i << ",some,column,data" << std::endl;
+	}
+	std::string largeGzip( Compress( boost::iostreams::gzip_compressor(), largeData.str() ) );
+	request.SetHTTPHeader( "Content-Encoding", "gzip" );
+
+	request.SetPostData( largeGzip.substr( 0, largeGzip.size() / 2 ) );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	CPPUNIT_ASSERT_MESSAGE( response.GetLog(), boost::regex_match( response.GetLog(), boost::regex( expected.str() ) ) );
+	CPPUNIT_ASSERT_FILE_CONTENTS( identityData, file1 );
+	response.ClearLog();
+
+	// all of it decodes, but the trailing checksum doesn't match
+	std::string corruptGzip( largeGzip );
+	corruptGzip[ corruptGzip.size() - 8 ] ^= 0xff;
+	request.SetPostData( corruptGzip );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	CPPUNIT_ASSERT_MESSAGE( response.GetLog(), boost::regex_match( response.GetLog(), boost::regex( expected.str() ) ) );
+	CPPUNIT_ASSERT_FILE_CONTENTS( identityData, file1 );
+}
+
+void StoreHandlerTest::testStoreCompressedTooLarge()
+{
+	DataProxyClient client;
+	MockHTTPRequest request;
+	MockHTTPResponse response;
+
+	std::map< std::string, std::string > params;
+	params[ "param1" ] = "value1";
+
+	std::string dir1( m_pTempDir->GetDirectoryName() + "/dir1" );
+	CPPUNIT_ASSERT_NO_THROW( FileUtilities::CreateDirectory( dir1 ) );
+	std::string file1( dir1 + "/" + ProxyUtilities::ToString( params ) );
+
+	std::string dplConfigFileSpec = m_pTempDir->GetDirectoryName() + "/dplConfig.xml";
+
+	StoreHandler handler( client, false, 1000, NULL );
+	
+	request.SetQueryParams( params );
+	request.SetPath( "n1" );
+
+	std::ofstream file( dplConfigFileSpec.c_str() );
+	file << "<DplConfig>" << std::endl
+		 << "  <DataNode name=\"n1\" type=\"local\" location=\"" << dir1 << "\" />" << std::endl
+		 << "</DplConfig>" << std::endl;
+	file.close();
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( dplConfigFileSpec ) );
+
+	// a body that decodes to exactly the limit is stored
+	std::string data( 1000, 'a' );
+	request.SetHTTPHeader( "Content-Encoding", "gzip" );
+	request.SetPostData( Compress( boost::iostreams::gzip_compressor(), data ) );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	std::stringstream expected;
+	expected << "SetHTTPStatusCode called with Code: 200 Message: " << std::endl
+			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			 << "WriteData called with Data: " << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), response.GetLog() );
+	CPPUNIT_ASSERT_FILE_CONTENTS( data, file1 );
+	response.ClearLog();
+	expected.str("");
+
+	// a small body that decodes to far more than the limit is rejected without being stored
+	std::string bomb( Compress( boost::iostreams::gzip_compressor(), std::string( 1024 * 1024, 'b' ) ) );
+	request.SetPostData( bomb );
+	CPPUNIT_ASSERT_NO_THROW( handler.Handle( request, response ) );
+	expected << "SetHTTPStatusCode called with Code: 413 Message: " << std::endl
+			 << "WriteHeader called with Name: Server Value: " << DATA_PROXY_SERVICE_VERSION << std::endl
+			 << "WriteData called with Data: Error storing data to node: n1: .*Decoded request body exceeds the limit of 1000 bytes" << std::endl;
+	CPPUNIT_ASSERT_MESSAGE( response.GetLog(), boost::regex_match( response.GetLog(), boost::regex( expected.str() ) ) );
+	CPPUNIT_ASSERT_FILE_CONTENTS( data, file1 );
+}
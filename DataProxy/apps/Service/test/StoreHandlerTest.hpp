@@ -25,6 +25,8 @@ private:
 	CPPUNIT_TEST_SUITE(StoreHandlerTest);
 	CPPUNIT_TEST(testStore);
 	CPPUNIT_TEST(testStoreXForwardedFor);
+	CPPUNIT_TEST(testStoreCompressed);
+	CPPUNIT_TEST(testStoreCompressedTooLarge);
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -37,6 +39,8 @@ public:
 
 	void testStore();
 	void testStoreXForwardedFor();
+	void testStoreCompressed();
+	void testStoreCompressedTooLarge();
 
 private:
 	boost::scoped_ptr< TempDirectory > m_pTempDir;
@@ -0,0 +1,189 @@
+// description: Compares the rows/sec of formatting database rows by streaming each column through
+//    operator<< (as DatabaseProxy::LoadImpl used to) with the block-buffered CsvRowWriter, with and
+//    without quoting.
+//    usage: CsvRowWriterBenchmark [--rows N] [--columns N] [--block_size BYTES]
+
+#include "CsvRowWriter.hpp"
+#include "Stopwatch.hpp"
+#include <boost/iostreams/stream.hpp>
+#include <boost/lexical_cast.hpp>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string.h>
+
+namespace
+{
+	// counts what it is given, so only formatting is timed
+	class CountingSink
+	{
+	public:
+		typedef char char_type;
+		typedef boost::iostreams::sink_tag category;
+
+		CountingSink( size_t& o_rCount ) : m_pCount( &o_rCount ) {}
+
+		std::streamsize write( const char*, std::streamsize i_Size )
+		{
+			*m_pCount += i_Size;
+			return i_Size;
+		}
+
+	private:
+		size_t* m_pCount;
+	};
+
+	typedef std::vector< Nullable< std::string > > Row;
+
+	// distinct rows of ids, dates, names & amounts, with the occasional null, to be cycled through
+	std::vector< Row > MakeRows( size_t i_Columns )
+	{
+		std::vector< Row > result( 1024 );
+		unsigned int value( 12345 );
+		for( size_t i = 0; i < result.size(); ++i )
+		{
+			for( size_t j = 0; j < i_Columns; ++j )
+			{
+				value = value * 1103515245 + 12345;
+				std::ostringstream column;
+				switch( j % 4 )
+				{
+				case 0:
+					column << ( value >> 8 ) % 1000000;
+					break;
+				case 1:
+					column << "2014-10-" << std::setw( 2 ) << std::setfill( '0' ) << ( 1 + ( value >> 16 ) % 28 );
+					break;
+				case 2:
+					column << "campaign_" << ( value % 97 );
+					break;
+				default:
+					column << ( ( value >> 4 ) % 100000 ) / 100.0;
+				}
+				result[i].push_back( ( value >> 20 ) % 50 == 0 ? Nullable< std::string >() : Nullable< std::string >( column.str() ) );
+			}
+		}
+		return result;
+	}
+
+	// the bound column buffers are refilled for each row, as by Database::Statement::NextRow
+	void Fetch( const std::vector< Row >& i_rRows, size_t i_Row, Row& o_rColumns )
+	{
+		const Row& rSource = i_rRows[ i_Row % i_rRows.size() ];
+		for( size_t i = 0; i < o_rColumns.size(); ++i )
+		{
+			o_rColumns[i] = rSource[i];
+		}
+	}
+
+	double RunStream( const std::vector< Row >& i_rRows, size_t i_RowCount, size_t& o_rBytes )
+	{
+		o_rBytes = 0;
+		const std::string fieldSeparator( "," );
+		const std::string recordSeparator( "\n" );
+		CountingSink sink( o_rBytes );
+		boost::iostreams::stream< CountingSink > output( sink );
+		Row columns( i_rRows[0].size() );
+		Stopwatch stopwatch;
+		for( size_t row = 0; row < i_RowCount; ++row )
+		{
+			Fetch( i_rRows, row, columns );
+			Row::const_iterator colIter = columns.begin();
+			for( ; colIter != columns.end(); ++colIter )
+			{
+				if( colIter == columns.begin() )
+				{
+					output << *colIter;
+				}
+				else
+				{
+					output << fieldSeparator << *colIter;
+				}
+			}
+			output << recordSeparator;
+		}
+		output << std::flush;
+		return stopwatch.GetElapsedMilliseconds() / 1000.0;
+	}
+
+	double RunWriter( const std::vector< Row >& i_rRows, size_t i_RowCount, size_t i_BlockSize, bool i_Quote, size_t& o_rBytes )
+	{
+		o_rBytes = 0;
+		CountingSink sink( o_rBytes );
+		boost::iostreams::stream< CountingSink > output( sink );
+		Row columns( i_rRows[0].size() );
+		Stopwatch stopwatch;
+		CsvRowWriter writer( output, ",", "\n", i_BlockSize );
+		if( i_Quote )
+		{
+			writer.SetQuote( '"' );
+			writer.SetNullValue( "\\N" );
+		}
+		for( size_t row = 0; row < i_RowCount; ++row )
+		{
+			Fetch( i_rRows, row, columns );
+			writer.WriteRow( columns );
+		}
+		writer.Flush();
+		return stopwatch.GetElapsedMilliseconds() / 1000.0;
+	}
+
+	void Report( const std::string& i_rName, size_t i_RowCount, size_t i_Bytes, double i_Seconds )
+	{
+		std::cout << std::setw( 10 ) << i_rName
+				  << std::setw( 14 ) << i_Bytes
+				  << std::setw( 10 ) << std::fixed << std::setprecision( 3 ) << i_Seconds
+				  << std::setw( 14 ) << std::setprecision( 0 ) << i_RowCount / i_Seconds
+				  << std::setw( 10 ) << std::setprecision( 1 ) << i_Bytes / i_Seconds / ( 1024 * 1024 )
+				  << std::endl;
+	}
+}
+
+int main( int argc, char** argv )
+{
+	size_t rows( 5000000 );
+	size_t columns( 8 );
+	size_t blockSize( CsvRowWriter::DEFAULT_BLOCK_SIZE );
+	for( int i = 1; i + 1 < argc; i += 2 )
+	{
+		if( ::strcmp( argv[i], "--rows" ) == 0 )
+		{
+			rows = boost::lexical_cast< size_t >( argv[i+1] );
+		}
+		else if( ::strcmp( argv[i], "--columns" ) == 0 )
+		{
+			columns = boost::lexical_cast< size_t >( argv[i+1] );
+		}
+		else if( ::strcmp( argv[i], "--block_size" ) == 0 )
+		{
+			blockSize = boost::lexical_cast< size_t >( argv[i+1] );
+		}
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--rows N] [--columns N] [--block_size BYTES]" << std::endl;
+			return 1;
+		}
+	}
+	if( columns == 0 )
+	{
+		columns = 1;
+	}
+
+	std::vector< Row > data = MakeRows( columns );
+
+	std::cout << "rows: " << rows << " columns: " << columns << " block size: " << blockSize << std::endl;
+	std::cout << std::setw( 10 ) << "mode" << std::setw( 14 ) << "output bytes" << std::setw( 10 ) << "seconds"
+			  << std::setw( 14 ) << "rows/s" << std::setw( 10 ) << "MB/s" << std::endl;
+
+	size_t bytes( 0 );
+	double seconds = RunStream( data, rows, bytes );
+	Report( "stream", rows, bytes, seconds );
+
+	seconds = RunWriter( data, rows, blockSize, false, bytes );
+	Report( "writer", rows, bytes, seconds );
+
+	seconds = RunWriter( data, rows, blockSize, true, bytes );
+	Report( "quoted", rows, bytes, seconds );
+
+	return 0;
+}
@@ -43,6 +43,9 @@ const std::string READ_NODE( "Read" );
 const std::string WRITE_NODE( "Write" );
 const std::string DELETE_NODE( "Delete" );
 const std::string TEE_NODE( "Tee" );
+const std::string STAGING_NODE( "Staging" );
+const std::string CACHE_NODE( "Cache" );
+const std::string COALESCE_NODE( "Coalesce" );
 
 // common formatters
 const std::string KEY_FORMATTER( "%k" );
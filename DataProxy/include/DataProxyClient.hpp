@@ -16,10 +16,17 @@
 #include "detail/DPLVisibility.hpp"
 #include "detail/DatabaseConnectionManager.hpp"
 #include "detail/NodeFactory.hpp"
+#include "detail/ConfigChangeDetector.hpp"
 #include <xercesc/dom/DOM.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/enable_shared_from_this.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/thread/future.hpp>
+#include <boost/function.hpp>
 #include <map>
 #include <vector>
 
@@ -31,19 +38,56 @@ class ParameterTranslator;
 class TransformerManager;
 class Database;
 class AbstractNode;
+class WorkerPool;
 
 class DLL_DPL_PUBLIC DataProxyClient : public boost::noncopyable
 {
 public:
+	// one of the loads in a LoadMany batch, and its outcome
+	struct LoadRequest
+	{
+		LoadRequest( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::ostream& o_rData );
+
+		std::string m_Name;
+		std::map<std::string,std::string> m_Parameters;
+		std::ostream* m_pData;
+		bool m_Succeeded;
+		std::string m_Error;
+	};
+
 	DataProxyClient( bool i_DoNotInitializeXerces = false );
 	virtual ~DataProxyClient();
 
 	virtual void Initialize( const std::string& i_rConfigFileSpec );
+	// controls how Initialize decides whether the config file must be re-read:
+	// i_MinimumRecheckSeconds: how long to trust the config after verifying it hasn't changed (0: always check)
+	// i_UseFileNotification: be notified of changes (inotify) instead of checking file status on each call
+	virtual void SetConfigCheckOptions( double i_MinimumRecheckSeconds, bool i_UseFileNotification );
+	// the MD5 of the published config file (and its entities), or empty if none has been published. it changes
+	// exactly when Initialize publishes a new configuration
+	virtual std::string GetConfigMD5() const;
 	virtual void Ping( const std::string& i_rName, int i_Mode ) const;
 	virtual void Load( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::ostream& o_rData ) const;
 	virtual void Store( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::istream& i_rData ) const;
 	virtual void Delete( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters ) const;
 
+	// issues a batch of independent loads, up to i_MaxConcurrency of them at once (the calling thread runs one share).
+	// every name is checked before any load is issued, and all of them use the same configuration. a failed load
+	// does not stop the others; each request's outcome is recorded in it. returns true if every load succeeded
+	virtual bool LoadMany( std::vector< LoadRequest >& io_rRequests, size_t i_MaxConcurrency ) const;
+
+	// asynchronous versions of the above, run on a pool of worker threads. the future completes when the request
+	// does (get() rethrows any exception it threw); the stream must remain valid until then. each request uses
+	// the configuration published when it starts running. requests issued inside a transaction are part of it:
+	// Commit and Rollback wait for all outstanding requests first (as does BeginTransaction)
+	virtual boost::unique_future< void > LoadAsync( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::ostream& o_rData ) const;
+	virtual boost::unique_future< void > StoreAsync( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::istream& i_rData ) const;
+	virtual boost::unique_future< void > DeleteAsync( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters ) const;
+	// the # of worker threads, i.e. the most asynchronous requests that run at once (default: 8).
+	// a derived client must call WaitForAsyncRequests() in its destructor if its requests may still be running
+	virtual void SetAsyncWorkerThreads( size_t i_NumThreads );
+	virtual void WaitForAsyncRequests() const;
+
 	virtual bool InsideTransaction();
 	virtual void BeginTransaction( bool i_AbortCurrent = false );
 	virtual void Commit();
@@ -67,26 +111,61 @@ private:
 
 	typedef std::map< std::string, boost::shared_ptr< AbstractNode > > NodesMap;
 
-	void PrivateRollback( bool i_ObtainLock );
-	void InitializeImplementation( const std::string& i_rConfigFileSpec, INodeFactory& i_rNodeFactory, DatabaseConnectionManager& i_rDatabaseConnectionManager );
-	std::string ExtractName( xercesc::DOMNode* i_pNode ) const;
-	void CheckForCycles( const NodesMap::const_iterator& i_rIter, int i_WhichPath, const std::vector< std::string >& i_rNamePath ) const;
+	// everything built from one version of the config file. once published, a configuration is
+	// never modified: re-initialization builds a new one off to the side and swaps it in, while
+	// requests already in flight finish against the configuration they started with
+	struct Configuration : public boost::enable_shared_from_this< Configuration >
+	{
+		boost::shared_ptr< DatabaseConnectionManager > m_pDatabaseConnectionManager;
+		NodesMap m_Nodes;
+		std::string m_ConfigFileMD5;
+	};
+	typedef boost::shared_ptr< const Configuration > ConfigurationPtr;
+
+	// pins the configuration used by a request (and any requests it forwards) on the current thread
+	class ScopedConfiguration;
+
+	ConfigurationPtr GetPublishedConfiguration() const;
+	// the configuration pinned by the request running on this thread, if any
+	ConfigurationPtr GetCurrentConfiguration() const;
+	// issues a store against the given configuration, from a thread that isn't already running a request. the
+	// reference is taken over, and released before the store completes
+	void StoreImpl( ConfigurationPtr& io_rpConfiguration, const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::istream& i_rData ) const;
+	void PrivateRollback( const Configuration& i_rConfiguration );
+	void InitializeImplementation( const std::string& i_rConfigFileSpec, INodeFactory& i_rNodeFactory, DatabaseConnectionManager* i_pDatabaseConnectionManager );
+	void BuildConfiguration( const std::string& i_rConfigFileSpec, INodeFactory& i_rNodeFactory, Configuration& o_rConfiguration );
+	std::string ExtractName( xercesc::DOMNode* i_pNode, const NodesMap& i_rNodes ) const;
+	void CheckForCycles( const NodesMap& i_rNodes, const NodesMap::const_iterator& i_rIter, int i_WhichPath, const std::vector< std::string >& i_rNamePath ) const;
 	void HandleResult( const std::string& i_rName, const NodesMap::const_iterator& i_rNodeIter, bool i_bSuccess, const std::string i_Operation ) const;
+	boost::unique_future< void > PostAsync( const boost::function< void() >& i_rRequest ) const;
+	void LoadManyWorker( const Configuration& i_rConfiguration, std::vector< LoadRequest >& io_rRequests, size_t& io_rNext, boost::mutex& i_rNextMutex ) const;
 
-	bool m_Initialized;
-	NodesMap m_Nodes;
 	bool m_DoNotInitializeXerces;
 	bool m_InsideTransaction;
-	std::string m_ConfigFileMD5;
+	ConfigChangeDetector m_ConfigChangeDetector;
 
-	DatabaseConnectionManager m_DatabaseConnectionManager;
 	NodeFactory m_NodeFactory;
 	
 	mutable std::vector< std::string > m_PendingCommitNodes;
 	mutable std::vector< std::string > m_PendingRollbackNodes;
 	mutable std::vector< std::string > m_AutoCommittedNodes;
+	// guards the above, which requests running on other threads may update during a transaction
+	mutable boost::mutex m_TransactionMutex;
+
+	// m_pConfiguration is only ever replaced as a whole; m_ConfigurationMutex is held just long enough
+	// to copy or swap the pointer. m_InitializeMutex serializes building new configurations
+	ConfigurationPtr m_pConfiguration;
+	mutable boost::mutex m_ConfigurationMutex;
+	boost::mutex m_InitializeMutex;
+	mutable boost::thread_specific_ptr< const Configuration > m_pCurrentConfiguration;
+	// the # of requests (on any thread) currently holding a configuration; guarded by m_ConfigurationMutex
+	mutable size_t m_ActiveRequests;
+	mutable boost::condition_variable m_RequestsDone;
 
-	mutable boost::shared_mutex m_ConfigMutex;
+	// created on the first asynchronous request
+	mutable boost::shared_ptr< WorkerPool > m_pWorkerPool;
+	mutable boost::mutex m_WorkerPoolMutex;
+	size_t m_AsyncWorkerThreads;
 };
 
 #endif //_DATA_PROXY_CLIENT_HPP_
@@ -18,14 +18,19 @@
 #include <xercesc/dom/DOM.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 #include <string>
 #include <set>
 #include <map>
+#include <vector>
 
 class DataProxyClient;
 class ParameterTranslator;
 class TransformerManager;
 class RequestForwarder;
+class ConcurrentTee;
+class ResultCache;
+class LoadCoalescer;
 
 MV_MAKEEXCEPTIONCLASS( NodeConfigException, MVException );
 MV_MAKEEXCEPTIONCLASS( ParameterValidationException, MVException );
@@ -56,6 +61,9 @@ public:
 	virtual bool SupportsTransactions() const = 0;
 	virtual void Commit() = 0;
 	virtual void Rollback() = 0;
+
+	// drops any cached load results, e.g. once writes to the node have been committed
+	void ClearCache();
 	
 protected:
 	// static helpers for validating xml
@@ -68,6 +76,9 @@ protected:
 									   const std::set< std::string >& i_rAdditionalWriteAttributes,
 									   const std::set< std::string >& i_rAdditionalDeleteAttributes );
 
+	// when loads are coalesced, the # of loads waiting on an identical one that is in flight
+	size_t GetCoalescedLoadCount() const;
+
 	// the operations that children must implement
 	virtual void LoadImpl( const std::map<std::string,std::string>& i_rParameters, std::ostream& o_rData ) = 0;
 	virtual void StoreImpl( const std::map<std::string,std::string>& i_rParameters, std::istream& i_rData ) = 0;
@@ -76,18 +87,28 @@ protected:
 	virtual void InsertImplWriteForwards( std::set< std::string >& o_rForwards ) const = 0;
 	virtual void InsertImplDeleteForwards( std::set< std::string >& o_rForwards ) const = 0;
 
+	// whether StoreImpl rewinds its input (e.g. to send it to several destinations); if so, an input that can't be
+	// rewound is spooled for it
+	virtual bool StoreImplRewindsInput() const;
+
 private:
 	DATUMINFO( Translator, boost::shared_ptr<ParameterTranslator> );
 	DATUMINFO( Transformers, boost::shared_ptr<TransformerManager>);
 	DATUMINFO( RequiredParameters, std::set<std::string> );
 	DATUMINFO( RetryCount, uint );
 	DATUMINFO( RetryDelay, double );
+	DATUMINFO( RetryUntilFirstByte, bool );
 	DATUMINFO( ForwardNodeName, Nullable<std::string> );
 	DATUMINFO( IncludeNodeNameAsParameter, Nullable<std::string> );
 	DATUMINFO( UseTranslatedParameters, bool );
 	DATUMINFO( UseTransformedStream, bool );
 	DATUMINFO( LogCritical, bool );
 	DATUMINFO( Operation, Nullable<std::string> ); 
+	DATUMINFO( MemoryLimit, size_t );
+	DATUMINFO( WorkingDir, std::string );
+	DATUMINFO( Concurrent, bool );
+	DATUMINFO( Async, bool );
+	DATUMINFO( BufferSize, size_t );
 
 	typedef
 		GenericDatum< Translator,					// parameter translator
@@ -95,23 +116,36 @@ private:
 		GenericDatum< RequiredParameters,			// required parameters
 		GenericDatum< RetryCount,					// before failure forwarding, # of retries
 		GenericDatum< RetryDelay,					// seconds to pause before retrying
+		GenericDatum< RetryUntilFirstByte,			// read only: stream results, retrying only until data is produced
 		GenericDatum< ForwardNodeName,				// failure forwarding: name
 		GenericDatum< IncludeNodeNameAsParameter,	// failure forwarding: include node name as parameters
 		GenericDatum< UseTranslatedParameters,		// failure forwarding: use translated params (or original)
 		GenericDatum< UseTransformedStream,		// failure forwarding: use transformed stream (or original)
 		GenericDatum< LogCritical,					// failure forwarding: log an error (vs. warning)
 		GenericDatum< Operation,					// operation mode for read, write and delete nodes 
-		RowEnd > > > > > > > > > > >
+		RowEnd > > > > > > > > > > > >
 	NodeConfigDatum;
 
 	typedef
 		GenericDatum< ForwardNodeName,
 		GenericDatum< UseTranslatedParameters,
 		GenericDatum< UseTransformedStream,
-		RowEnd > > >
+		GenericDatum< Concurrent,					// copy the stream to the tee as it is returned (vs. before)
+		GenericDatum< Async,						// concurrent only: do not wait for the tee to complete
+		GenericDatum< BufferSize,					// concurrent only: # of bytes the tee may fall behind
+		RowEnd > > > > > >
 	TeeConfigDatum;
 
+	typedef
+		GenericDatum< MemoryLimit,					// # of bytes staged (or spooled) in memory before spilling to disk
+		GenericDatum< WorkingDir,					// directory to spill staged (or spooled) data to
+		RowEnd > >
+	StagingConfigDatum;
+
 	void SetConfig( const xercesc::DOMNode& i_rNode, NodeConfigDatum& o_rConfig ) const;
+	void SetStagingConfig( const xercesc::DOMNode& i_rNode, StagingConfigDatum& o_rConfig ) const;
+	void AddPendingTee( boost::shared_ptr< ConcurrentTee > i_pTee );
+	bool StoreRewindsInput() const;
 	
 	protected:
 	std::string m_Name;
@@ -122,6 +156,18 @@ private:
 	NodeConfigDatum m_WriteConfig;
 	NodeConfigDatum m_DeleteConfig;
 	TeeConfigDatum m_TeeConfig;
+	StagingConfigDatum m_ReadStagingConfig;
+	StagingConfigDatum m_WriteStagingConfig;	// for spooling store input that cannot be rewound
+
+	// results of recent loads, if the read side has a cache configured
+	boost::shared_ptr< ResultCache > m_pCache;
+
+	// joins identical loads that are in flight at once, if the read side is configured to
+	boost::shared_ptr< LoadCoalescer > m_pCoalescer;
+
+	// asynchronous tees still completing; they are waited for when the node is destroyed
+	boost::mutex m_PendingTeesMutex;
+	std::vector< boost::shared_ptr< ConcurrentTee > > m_PendingTees;
 };
 
 
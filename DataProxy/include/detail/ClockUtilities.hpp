@@ -0,0 +1,19 @@
+// description: Reads the system clocks as fractional seconds. The monotonic clock is for measuring intervals
+//    & expirations, since it never jumps; the realtime clock is for timestamps that are reported.
+
+#ifndef _CLOCK_UTILITIES_HPP_
+#define _CLOCK_UTILITIES_HPP_
+
+#include <time.h>
+
+namespace ClockUtilities
+{
+	inline double Now( clockid_t i_Clock = CLOCK_MONOTONIC )
+	{
+		timespec now;
+		::clock_gettime( i_Clock, &now );
+		return now.tv_sec + now.tv_nsec / 1e9;
+	}
+}
+
+#endif //_CLOCK_UTILITIES_HPP_
@@ -27,6 +27,9 @@ public:
 	virtual ~ColumnFormatStreamTransformer();
 
 	virtual boost::shared_ptr< std::istream > TransformInput( boost::shared_ptr< std::istream > i_pInputStream, const std::map< std::string, std::string >& i_rParameters );
+
+	virtual bool SupportsStreaming() const;
+	virtual void TransformInput( std::istream& i_rInputStream, std::ostream& o_rOutputStream, const std::map< std::string, std::string >& i_rParameters );
 };
 
 #endif //_COLUMN_FORMAT_STREAM_TRANSFORMER_HPP_
@@ -0,0 +1,93 @@
+// description: Copies a stream to another node's Store while the stream is being written to its primary
+//    destination (e.g. the client of a Load), rather than buffering all of it and replaying it afterwards.
+//    The Store runs on its own thread, reading through a bounded StreamPipe, so the primary destination is
+//    held up only when the tee falls more than a buffer behind. The Store reads the pipe as it is filled unless
+//    the target node may have to rewind its input (retries, failure forwarding, etc.), in which case the input is
+//    spooled, spilling to disk past the node's write Staging memoryLimit. If the Store stops reading early (e.g. it
+//    fails), the rest of the stream is no longer copied; the primary destination is never failed by the tee.
+//    The tee may be finished synchronously (waiting for the Store to complete and rethrowing any error) or
+//    asynchronously (the Store completes in the background and any error is logged).
+
+#ifndef _CONCURRENT_TEE_HPP_
+#define _CONCURRENT_TEE_HPP_
+
+#include "StreamPipe.hpp"
+#include "RequestForwarder.hpp"
+#include "RequestTrace.hpp"
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/iostreams/categories.hpp>
+#include <exception>
+#include <ios>
+#include <map>
+#include <string>
+
+class ConcurrentTee : public boost::noncopyable
+{
+public:
+	// the copy of the stream; for use with boost::iostreams::tee()
+	class Sink
+	{
+	public:
+		typedef char char_type;
+		typedef boost::iostreams::sink_tag category;
+
+		Sink( StreamPipe& i_rPipe );
+
+		std::streamsize write( const char* i_pData, std::streamsize i_Size );
+
+	private:
+		StreamPipe* m_pPipe;
+	};
+
+	ConcurrentTee( boost::shared_ptr< RequestForwarder > i_pRequestForwarder,
+				   const std::string& i_rNodeName,
+				   const std::map< std::string, std::string >& i_rParameters,
+				   size_t i_BufferSize );
+	virtual ~ConcurrentTee();
+
+	Sink GetSink();
+
+	// the stream is complete: wait for the Store to finish, rethrowing any error it encountered
+	void Finish();
+
+	// the stream is complete: let the Store finish in the background, logging any error it encounters
+	void FinishAsync();
+
+	// the stream failed part way through: make the Store fail rather than store a truncated stream
+	void Abort();
+
+	// true once the Store has finished, successfully or not
+	bool IsComplete() const;
+
+private:
+	struct State
+	{
+		State( boost::shared_ptr< RequestForwarder > i_pRequestForwarder,
+			   const std::string& i_rNodeName,
+			   const std::map< std::string, std::string >& i_rParameters,
+			   size_t i_BufferSize );
+
+		boost::mutex m_Mutex;
+		StreamPipe m_Pipe;
+		boost::shared_ptr< RequestForwarder > m_pRequestForwarder;
+		std::string m_NodeName;
+		std::map< std::string, std::string > m_Parameters;
+		RequestTrace::Context m_TraceContext;	// the request being teed, so the Store is traced as part of it
+		RequestForwarder::PinnedConfiguration m_pConfiguration;	// ...and runs against the configuration that request uses
+		std::exception_ptr m_Error;
+		bool m_Aborted;
+		bool m_Detached;
+		bool m_Complete;
+	};
+
+	static void Run( boost::shared_ptr< State > i_pState );
+
+	boost::shared_ptr< State > m_pState;
+	boost::thread m_Thread;
+	bool m_Finished;
+};
+
+#endif //_CONCURRENT_TEE_HPP_
@@ -0,0 +1,78 @@
+// description: DataProxyClient::Initialize is called on every incoming request by the service, and
+//    a full xerces parse + serialize + md5 of the config is far too expensive to do each time. This class
+//    keeps a cheap fingerprint (device, inode, size, mtime) of the config file and every entity file it
+//    pulled in during the last successful initialization, so that the steady-state check is a handful of
+//    stat() calls (or a single non-blocking read when using inotify). The md5 path is only run when the
+//    fingerprints indicate a possible change.
+//    Fingerprints of files modified too close to the time the config was read are not trusted ("racy"),
+//    since a filesystem with coarse timestamps could hide a subsequent same-size rewrite.
+
+#ifndef _CONFIG_CHANGE_DETECTOR_HPP_
+#define _CONFIG_CHANGE_DETECTOR_HPP_
+
+#include "Stopwatch.hpp"
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <sys/types.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include <map>
+
+class ConfigChangeDetector : public boost::noncopyable
+{
+public:
+	ConfigChangeDetector();
+	virtual ~ConfigChangeDetector();
+
+	// i_MinimumRecheckSeconds: once verified, do not look at the filesystem again for this long
+	// i_UseFileNotification: use inotify watches instead of stat'ing every file on each check
+	void SetOptions( double i_MinimumRecheckSeconds, bool i_UseFileNotification );
+
+	// returns true if the config file may have changed since the last Acknowledge and should be re-read
+	bool HasChanged( const std::string& i_rConfigFileSpec );
+
+	// records the files making up the config that was just verified (by md5) or loaded.
+	// i_ReadTime is the time taken just before the files were read; any file changed at or
+	// after that time is considered racy and will not be trusted
+	void Acknowledge( const std::string& i_rConfigFileSpec, const std::vector< std::string >& i_rEntityFiles, time_t i_ReadTime );
+
+	// forget everything; the next call to HasChanged will return true
+	void Reset();
+
+private:
+	struct Fingerprint
+	{
+		dev_t m_Device;
+		ino_t m_Inode;
+		off_t m_Size;
+		time_t m_ModifiedSeconds;
+		long m_ModifiedNanoseconds;
+		time_t m_ChangedSeconds;
+		long m_ChangedNanoseconds;
+
+		bool operator==( const Fingerprint& i_rRhs ) const;
+	};
+
+	typedef std::map< std::string, Fingerprint > FingerprintMap;
+	typedef std::map< int, std::vector< std::string > > WatchMap;
+
+	static bool GetFingerprint( const std::string& i_rFileSpec, Fingerprint& o_rFingerprint );
+	bool FingerprintsMatch() const;
+	bool WatchFiles();
+	bool DrainNotifications();
+	void ResetImpl();
+	void CloseNotifications();
+
+	mutable boost::mutex m_Mutex;
+	std::string m_ConfigFileSpec;
+	FingerprintMap m_Fingerprints;
+	bool m_Verified;
+	double m_MinimumRecheckSeconds;
+	bool m_UseFileNotification;
+	int m_NotifyDescriptor;
+	WatchMap m_DirectoryWatches;
+	Stopwatch m_RecheckTimer;
+};
+
+#endif //_CONFIG_CHANGE_DETECTOR_HPP_
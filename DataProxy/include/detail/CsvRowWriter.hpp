@@ -0,0 +1,57 @@
+// description: Formats rows of bound database columns as delimited text into a reusable block, writing
+//    only whole blocks to the output stream, so rows are serialized without a stream call per field
+//    or any allocation per row. Fields may optionally be quoted, and nulls written as a given value.
+
+#ifndef _CSV_ROW_WRITER_HPP_
+#define _CSV_ROW_WRITER_HPP_
+
+#include "Nullable.hpp"
+#include <boost/noncopyable.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class CsvRowWriter : public boost::noncopyable
+{
+public:
+	enum
+	{
+		DEFAULT_BLOCK_SIZE = 65536
+	};
+
+	CsvRowWriter( std::ostream& o_rOutput,
+				  const std::string& i_rFieldSeparator,
+				  const std::string& i_rRecordSeparator,
+				  size_t i_BlockSize = DEFAULT_BLOCK_SIZE );
+	virtual ~CsvRowWriter();
+
+	// nulls are written as this value, which is empty by default
+	void SetNullValue( const std::string& i_rNullValue );
+
+	// when set, fields containing the quote, either separator, or matching the null value are surrounded
+	// by the quote, and quotes within them are doubled
+	void SetQuote( char i_Quote );
+
+	void WriteRow( const std::vector< Nullable< std::string > >& i_rColumns );
+
+	// writes what remains of the block & flushes the output
+	void Flush();
+
+private:
+	void Append( const char* i_pData, size_t i_Size );
+	void Append( const std::string& i_rData );
+	void AppendField( const std::string& i_rField );
+	bool NeedsQuotes( const std::string& i_rField ) const;
+	void WriteBlock();
+
+	std::ostream& m_rOutput;
+	std::string m_FieldSeparator;
+	std::string m_RecordSeparator;
+	std::string m_NullValue;
+	bool m_Quoting;
+	char m_Quote;
+	std::vector< char > m_Block;
+	size_t m_BlockUsed;
+};
+
+#endif //_CSV_ROW_WRITER_HPP_
@@ -14,6 +14,8 @@
 #include "MVException.hpp"
 #include <xercesc/sax/HandlerBase.hpp>
 #include <xercesc/sax/InputSource.hpp>
+#include <string>
+#include <vector>
 
 MV_MAKEEXCEPTIONCLASS( EntityResolverException, MVException );
 
@@ -24,6 +26,12 @@ public:
 	virtual ~CustomEntityResolver();
 
 	virtual xercesc::InputSource* resolveEntity( const XMLCh* const i_PublicId, const XMLCh* const i_SystemId );
+
+	// the local files that have been resolved so far
+	const std::vector< std::string >& GetResolvedEntities() const;
+
+private:
+	std::vector< std::string > m_ResolvedEntities;
 };
 
 #endif //_CUSTOM_ENTITY_RESOLVER_HPP_
@@ -14,6 +14,7 @@
 #include "AbstractNode.hpp"
 #include "MVException.hpp"
 #include "Nullable.hpp"
+#include "TableLocks.hpp"
 #include <xercesc/dom/DOM.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/shared_ptr.hpp>
@@ -82,6 +83,8 @@ private:
 	std::string m_ReadHeader;
 	std::string m_ReadFieldSeparator;
 	std::string m_ReadRecordSeparator;
+	Nullable< std::string > m_ReadNullValue;
+	Nullable< char > m_ReadQuote;
 	bool m_ReadConnectionByTable;
 
 	// write settings
@@ -94,7 +97,10 @@ private:
 	std::string m_WriteMySqlMergeQuery;
 	std::string m_WriteOracleMergeQuery;
 	std::string m_WriteVerticaMergeQuery;
+	std::string m_WriteMySqlBatchQuery;		// the staging table versions of the merge queries, for storing rows in batches
+	std::string m_WriteOracleBatchQuery;
 	std::vector< std::string > m_WriteBindColumns;
+	size_t m_WriteBatchSize;
 	std::string m_WriteOnColumnParameterCollision;
 	Nullable<std::string> m_PreStatement;
 	Nullable<std::string> m_PostStatement;
@@ -107,6 +113,8 @@ private:
 	bool m_WriteDirectLoad;
 	bool m_WriteLocalDataFile;
 	bool m_WriteNoCleanUp;
+	bool m_WriteStreamDataFile;		// the data file is a named pipe the loader reads while the incoming data is parsed
+	size_t m_WriteUploadParallelism;	// the number of chunks the data is split into & uploaded concurrently (Oracle only)
 
 	std::map< std::string, std::string > m_WriteRequiredColumns;
 	bool m_WriteConnectionByTable;
@@ -122,7 +130,8 @@ private:
 	std::set< boost::shared_ptr< Database > > m_PendingCommits;
 	std::vector< boost::shared_ptr< ScopedTempTable > > m_PendingDrops;
 
-	boost::shared_mutex m_TableMutex;
+	TableLocks m_StagingTableLocks;
+	TableLocks m_TargetTableLocks;
 	boost::shared_mutex m_PendingCommitsMutex;
 	boost::shared_mutex m_PendingDropsMutex;
 };
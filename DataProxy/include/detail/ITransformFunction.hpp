@@ -12,6 +12,8 @@
 #define _I_TRANFORM_FUNCTION_HPP_
 
 #include <istream>
+#include <ostream>
+#include <stdexcept>
 #include <string>
 #include <map>
 #include <boost/noncopyable.hpp>
@@ -24,6 +26,14 @@ public:
 	virtual ~ITransformFunction() {};
 
 	virtual boost::shared_ptr<std::istream> TransformInput( boost::shared_ptr< std::istream > i_pInput, const std::map<std::string, std::string>& i_rParameters ) = 0;
+
+	// functions that can write output while still reading input (and never seek their input) may override
+	// these, allowing them to run concurrently with their neighbors when a node's transformers are pipelined
+	virtual bool SupportsStreaming() const { return false; }
+	virtual void TransformInput( std::istream& i_rInput, std::ostream& o_rOutput, const std::map<std::string, std::string>& i_rParameters )
+	{
+		throw std::logic_error( "This transform function does not support streaming" );
+	}
 };
 
 #endif // _I_TRANSFORM_FUNCTION
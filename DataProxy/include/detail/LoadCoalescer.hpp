@@ -0,0 +1,80 @@
+// description: Collapses identical loads that are in flight at the same time into one. The first to arrive
+//    under a key leads: it performs the load and, once done, shares its result with every load that joined
+//    under the same key in the meantime, which wait for it instead of loading themselves. A leader that failed
+//    hands its error to its followers, so a failing node isn't then hit by all of them at once. A leader whose
+//    result was larger than the coalescer will hold releases its followers empty-handed, to load for themselves.
+
+#ifndef _LOAD_COALESCER_HPP_
+#define _LOAD_COALESCER_HPP_
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <map>
+#include <string>
+
+class LoadCoalescer : public boost::noncopyable
+{
+private:
+	struct Flight
+	{
+		Flight();
+
+		boost::condition_variable m_Landed;
+		bool m_Complete;
+		boost::shared_ptr< const std::string > m_pResult;
+		boost::shared_ptr< const std::string > m_pError;
+	};
+
+public:
+	// held by the load that leads a flight; its followers are released when it is destroyed
+	class Leader : public boost::noncopyable
+	{
+	public:
+		Leader( LoadCoalescer& i_rCoalescer, const std::string& i_rKey, boost::shared_ptr< Flight > i_pFlight );
+		virtual ~Leader();
+
+		// the result to share with the followers
+		void SetResult( boost::shared_ptr< const std::string > i_pResult );
+
+		// the load failed; the followers are handed the error instead of a result
+		void SetError( const std::string& i_rError );
+
+	private:
+		LoadCoalescer& m_rCoalescer;
+		std::string m_Key;
+		boost::shared_ptr< Flight > m_pFlight;
+		boost::shared_ptr< const std::string > m_pResult;
+		boost::shared_ptr< const std::string > m_pError;
+	};
+
+	LoadCoalescer( size_t i_MaxBytes );
+	virtual ~LoadCoalescer();
+
+	// if no load is in flight under the key, starts one and returns its Leader. otherwise waits for that load
+	// to complete and returns NULL, with o_rpResult set to the leader's result (NULL if it had none to share)
+	// and o_rpError set to the leader's error (NULL unless it failed)
+	boost::shared_ptr< Leader > Join( const std::string& i_rKey,
+									  boost::shared_ptr< const std::string >& o_rpResult,
+									  boost::shared_ptr< const std::string >& o_rpError );
+
+	// the largest result that will be shared
+	size_t GetMaxBytes() const;
+
+	// the # of loads waiting on a flight to complete
+	size_t GetFollowerCount() const;
+
+private:
+	void Land( const std::string& i_rKey,
+			   boost::shared_ptr< Flight > i_pFlight,
+			   boost::shared_ptr< const std::string > i_pResult,
+			   boost::shared_ptr< const std::string > i_pError );
+
+	size_t m_MaxBytes;
+	mutable boost::mutex m_Mutex;
+	std::map< std::string, boost::shared_ptr< Flight > > m_Flights;
+	size_t m_FollowerCount;
+};
+
+#endif //_LOAD_COALESCER_HPP_
@@ -0,0 +1,109 @@
+// description: The bookkeeping shared by caches that evict least recently used entries: entries in recency
+//    order, indexed by key, each with a size that is totalled & a time it expires. It is header-only so the
+//    service can build its caches on it too. It isn't synchronized; the owning cache locks around it and
+//    decides when an entry has expired & which to evict.
+
+#ifndef _LRU_CACHE_HPP_
+#define _LRU_CACHE_HPP_
+
+#include <boost/lexical_cast.hpp>
+#include <boost/noncopyable.hpp>
+#include <list>
+#include <map>
+#include <string>
+
+template< typename T_Value >
+class LruCache : public boost::noncopyable
+{
+public:
+	struct Entry
+	{
+		std::string m_Key;
+		T_Value m_Value;
+		size_t m_Size;
+		double m_Expiration;
+	};
+	typedef typename std::list< Entry >::iterator Iterator;
+
+	LruCache()
+	:	m_Entries(),
+		m_Index(),
+		m_Bytes( 0 )
+	{
+	}
+
+	// returns End() if there is no entry under the key
+	Iterator Find( const std::string& i_rKey )
+	{
+		typename std::map< std::string, Iterator >::iterator indexIter = m_Index.find( i_rKey );
+		return indexIter == m_Index.end() ? m_Entries.end() : indexIter->second;
+	}
+
+	// makes the entry the most recently used
+	void Touch( Iterator i_Iter )
+	{
+		m_Entries.splice( m_Entries.begin(), m_Entries, i_Iter );
+	}
+
+	// adds an entry as the most recently used, replacing any under the same key
+	Iterator Insert( const std::string& i_rKey, const T_Value& i_rValue, size_t i_Size, double i_Expiration )
+	{
+		Iterator existing = Find( i_rKey );
+		if( existing != m_Entries.end() )
+		{
+			Remove( existing );
+		}
+		Entry entry;
+		entry.m_Key = i_rKey;
+		entry.m_Value = i_rValue;
+		entry.m_Size = i_Size;
+		entry.m_Expiration = i_Expiration;
+		m_Entries.push_front( entry );
+		m_Index[ i_rKey ] = m_Entries.begin();
+		m_Bytes += i_Size;
+		return m_Entries.begin();
+	}
+
+	void Remove( Iterator i_Iter )
+	{
+		m_Bytes -= i_Iter->m_Size;
+		m_Index.erase( i_Iter->m_Key );
+		m_Entries.erase( i_Iter );
+	}
+
+	// the least recently used entry; the cache must not be empty
+	Iterator GetOldest()
+	{
+		return --m_Entries.end();
+	}
+
+	// iterates from the most recently used
+	Iterator Begin()
+	{
+		return m_Entries.begin();
+	}
+
+	Iterator End()
+	{
+		return m_Entries.end();
+	}
+
+	size_t GetBytes() const
+	{
+		return m_Bytes;
+	}
+
+	// appends a field to a key so that keys made of the same # of fields are distinct: length-prefixing each
+	// keeps them so no matter what characters the fields contain
+	static void AppendKeyField( std::string& io_rKey, const std::string& i_rField )
+	{
+		io_rKey += boost::lexical_cast< std::string >( i_rField.size() ) + ':' + i_rField;
+	}
+
+private:
+	std::list< Entry > m_Entries;
+	std::map< std::string, Iterator > m_Index;
+	size_t m_Bytes;
+};
+
+#endif //_LRU_CACHE_HPP_
@@ -0,0 +1,44 @@
+// description: Writes data into a named pipe (FIFO) from a thread of its own, so that a separate reader that is only
+//    given the pipe's name (e.g. a bulk loader reading its "data file") can consume the data while it is still being
+//    produced, without it ever touching the disk. The pipe is created by the constructor and written once a reader
+//    opens it. Finish must be called once the reader is done: a writer still waiting for a reader gives up, a writer
+//    whose reader stopped reading early fails, and any failure of the writer is rethrown.
+
+#ifndef _NAMED_PIPE_WRITER_HPP_
+#define _NAMED_PIPE_WRITER_HPP_
+
+#include "MVException.hpp"
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <ostream>
+#include <string>
+
+MV_MAKEEXCEPTIONCLASS( NamedPipeWriterException, MVException );
+
+class NamedPipeWriter : public boost::noncopyable
+{
+public:
+	typedef boost::function< void ( std::ostream& ) > WriteFunction;
+
+	// creates the pipe at i_rFileSpec (which must not exist) & starts writing it with i_rWrite
+	NamedPipeWriter( const std::string& i_rFileSpec, const WriteFunction& i_rWrite );
+	virtual ~NamedPipeWriter();
+
+	// waits for the writer to finish; throws if it failed or never had a reader. the pipe itself is left in place
+	void Finish();
+
+private:
+	void Run();
+
+	std::string m_FileSpec;
+	WriteFunction m_Write;
+	boost::mutex m_Mutex;
+	bool m_Finishing;
+	std::string m_Error;
+	boost::scoped_ptr< boost::thread > m_pThread;
+};
+
+#endif //_NAMED_PIPE_WRITER_HPP_
@@ -30,6 +30,8 @@ public:
 	virtual void Translate( const std::map<std::string,std::string>& i_rInputParameters,
 							   std::map<std::string,std::string>& o_rTranslatedParameters );
 	virtual void TranslateDelayedParameters( std::map< std::string, std::string >& o_rTranslatedParameters, std::istream& i_rData ) const;
+	// whether TranslateDelayedParameters reads (and rewinds) the data
+	bool HasDelayedParameters() const;
 	
 private:
 	DATUMINFO( ParameterName, std::string );
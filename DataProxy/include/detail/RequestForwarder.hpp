@@ -18,6 +18,7 @@
 
 #include "MVException.hpp"
 #include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
 #include <string>
 #include <vector>
 
@@ -34,6 +35,15 @@ public:
 	virtual void Store( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::istream& i_rData ) const;
 	virtual void Delete( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters ) const;
 
+	// a reference to the configuration the request running on this thread uses (null if there is none). a request
+	// forwarded later from another thread with it runs against that configuration, not one published since; the
+	// request takes the reference over, so a configuration it was the last user of is torn down as part of it
+	typedef boost::shared_ptr< const void > PinnedConfiguration;
+	virtual PinnedConfiguration PinConfiguration() const;
+	virtual void Store( PinnedConfiguration& io_rpConfiguration, const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::istream& i_rData ) const;
+
+	virtual bool InsideTransaction() const;
+
 private:
 	const DataProxyClient& m_rDataProxyClient;
 };
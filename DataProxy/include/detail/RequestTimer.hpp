@@ -0,0 +1,73 @@
+// description: Breaks the wall-clock time of a node's load, store or delete down into phases (parameter
+//    translation, the node's own implementation, retry delays, stream transformation, tees, returning the
+//    result, failure forwarding), so that a slow request shows where its time went. When the timer is
+//    destroyed, the time spent in each phase is reported to the request's MonitoringTracker and, for a
+//    top-level request, written out as a single log line. Requests issued through the RequestForwarder on
+//    the same thread (failure forwarding, non-concurrent tees, nodes built from other nodes) are timed as
+//    children of the request that issued them, and appear nested in its log line. Each timer is also a span
+//    of the request's RequestTrace, if it is one of those sampled for tracing.
+
+#ifndef _REQUEST_TIMER_HPP_
+#define _REQUEST_TIMER_HPP_
+
+#include "RequestTrace.hpp"
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+class MonitoringTracker;
+
+class RequestTimer : public boost::noncopyable
+{
+public:
+	RequestTimer( const std::string& i_rNode, const std::string& i_rOperation, MonitoringTracker& i_rTracker );
+	virtual ~RequestTimer();
+
+	// times a phase for as long as it exists. a phase may be entered more than once (e.g. once per retry);
+	// its times are added up. i_rName must outlive the timer
+	class Phase : public boost::noncopyable
+	{
+	public:
+		Phase( RequestTimer& i_rTimer, const std::string& i_rName );
+		virtual ~Phase();
+
+	private:
+		RequestTimer& m_rTimer;
+		const std::string& m_rName;
+		double m_Start;
+	};
+
+	// the result to log; "fail" unless set
+	void SetResult( const std::string& i_rResult );
+
+	// the payload size to trace; 0 unless set
+	void SetBytes( size_t i_Bytes );
+
+	// e.g. node=n1 operation=load result=success total=0.012000 impl=0.002000 forward=0.010000 { node=n2 operation=load ... }
+	std::string GetSummary() const;
+
+	// the seconds spent in the named phase so far
+	double GetSeconds( const std::string& i_rPhase ) const;
+
+	// the innermost request being timed on this thread, for a node to time phases of its own; NULL if none
+	static RequestTimer* GetCurrent();
+
+private:
+	void Add( const std::string& i_rPhase, double i_Seconds );
+
+	std::string m_Node;
+	std::string m_Operation;
+	std::string m_Result;
+	MonitoringTracker& m_rTracker;
+	double m_Start;
+	std::vector< std::pair< std::string, double > > m_Phases;	// in the order they were first entered
+	std::vector< std::string > m_Children;						// summaries of the requests issued from this one
+	RequestTimer* m_pParent;
+	size_t m_Bytes;
+	RequestTrace::Context m_Context;					// this request's span, if it is traced
+	boost::scoped_ptr< RequestTrace::Scope > m_pScope;	// makes it the parent of requests issued from this one
+};
+
+#endif //_REQUEST_TIMER_HPP_
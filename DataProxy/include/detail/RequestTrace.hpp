@@ -0,0 +1,93 @@
+// description: Records the call tree of a single top-level request as it fans out through the RequestForwarder
+//    into other nodes (routes, joins, partitions, failure forwarding, tees). Each node load, store or delete made
+//    on behalf of the request is a span with its parent span, start & end times, byte count and result. The trace
+//    and the current span are carried from node to node by the thread making the request; work handed to another
+//    thread (e.g. a concurrent tee) must take the Context along with it. Once nothing refers to the trace any longer
+//    (i.e. every span, including any asynchronous tee, is done), it is written out as a single JSON call tree.
+//    Only a sample of top-level requests is traced (none by default); the requests they issue are traced with them.
+
+#ifndef _REQUEST_TRACE_HPP_
+#define _REQUEST_TRACE_HPP_
+
+#include <boost/noncopyable.hpp>
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <string>
+#include <vector>
+
+class RequestTrace : public boost::noncopyable
+{
+public:
+	RequestTrace();
+	virtual ~RequestTrace();
+
+	// the trace & span that requests issued on a thread are made on behalf of; empty outside of any request.
+	// a request that isn't being traced has no trace, but is still in a request so what it issues isn't sampled
+	struct Context
+	{
+		Context();
+		Context( const boost::shared_ptr< RequestTrace >& i_pTrace, size_t i_SpanId );
+
+		boost::shared_ptr< RequestTrace > m_pTrace;
+		size_t m_SpanId;
+		bool m_InRequest;
+	};
+
+	// makes a context current on this thread for as long as it exists, then restores the previous one
+	class Scope : public boost::noncopyable
+	{
+	public:
+		Scope( const Context& i_rContext );
+		virtual ~Scope();
+
+	private:
+		Context m_Previous;
+	};
+
+	static Context GetCurrent();
+
+	// the fraction of top-level requests to trace, in [0,1]; 0 (the default) turns tracing off
+	static void SetSampleRate( double i_Rate );
+	static double GetSampleRate();
+
+	// whether the next top-level request should be traced. samples are evenly spaced, so e.g. at a rate of
+	// 0.25 every fourth request is traced
+	static bool Sample();
+
+	const std::string& GetId() const;
+
+	// returns the id of the new span; i_ParentId is 0 for a top-level span
+	size_t BeginSpan( size_t i_ParentId, const std::string& i_rNode, const std::string& i_rOperation );
+	void EndSpan( size_t i_SpanId, const std::string& i_rResult, size_t i_Bytes );
+
+	// e.g. {"traceId":"..","spans":[{"spanId":1,"node":"n1","operation":"load","start":1500000000.000000,
+	//   "end":1500000000.012000,"result":"success","bytes":123,"children":[{"spanId":2,...}]}]}
+	// where start & end are seconds since the epoch; spans still running have no end, result or bytes
+	std::string GetJson() const;
+
+private:
+	struct Span
+	{
+		size_t m_ParentId;
+		std::string m_Node;
+		std::string m_Operation;
+		std::string m_Result;
+		double m_Start;
+		double m_End;
+		size_t m_Bytes;
+	};
+
+	// i_rChildren: the ids of each span's children, indexed by span id (0 for the top-level spans)
+	void WriteSpan( std::ostream& o_rOutput, size_t i_SpanId, const std::vector< std::vector< size_t > >& i_rChildren ) const;
+
+	std::string m_Id;
+	mutable boost::mutex m_Mutex;
+	std::vector< Span > m_Spans;	// span ids are 1-based indexes
+
+	static boost::atomic< double > s_SampleRate;
+	static boost::atomic< boost::uint64_t > s_SampledRequests;
+};
+
+#endif //_REQUEST_TRACE_HPP_
@@ -0,0 +1,100 @@
+// description: Holds the results of recent loads, keyed by the parameters they were loaded with, so a repeated
+//    load can be answered without going back to the data source. Entries expire a fixed time after they were
+//    stored. Memory is bounded by a byte budget; when it is exceeded the least recently used entries are
+//    evicted, either dropped or (if a working directory is configured) spilled to files there, which are
+//    themselves bounded by a separate byte budget and evicted least recently used first. An entry found on
+//    disk is promoted back to memory. The cache is cleared when the data may have changed; a load that was
+//    already in progress when it was cleared doesn't store its (possibly stale) result.
+
+#ifndef _RESULT_CACHE_HPP_
+#define _RESULT_CACHE_HPP_
+
+#include "LruCache.hpp"
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/iostreams/categories.hpp>
+#include <ios>
+#include <map>
+#include <string>
+#include <vector>
+
+class ResultCache : public boost::noncopyable
+{
+public:
+	// collects a result as it is written, for use with boost::iostreams::tee(); a result
+	// larger than the limit is abandoned since it could never be cached
+	class Capture
+	{
+	public:
+		typedef char char_type;
+		typedef boost::iostreams::sink_tag category;
+
+		Capture( std::string& o_rData, bool& o_rOverflowed, size_t i_Limit );
+
+		std::streamsize write( const char* i_pData, std::streamsize i_Size );
+
+	private:
+		std::string* m_pData;
+		bool* m_pOverflowed;
+		size_t m_Limit;
+	};
+
+	// i_rWorkingDir may be empty, in which case entries evicted from memory are dropped
+	ResultCache( double i_TimeToLiveSeconds, size_t i_MaxBytes, const std::string& i_rWorkingDir, size_t i_MaxDiskBytes );
+	virtual ~ResultCache();
+
+	// returns the fresh entry stored under the key, or NULL if there is none. an entry found on disk is
+	// promoted to memory, which may evict others; o_rEvictions is set to the # evicted
+	boost::shared_ptr< const std::string > Get( const std::string& i_rKey, size_t& o_rEvictions );
+
+	// stores an entry, replacing any under the same key; returns the # of entries evicted to make room
+	// (an entry spilled from memory to disk counts as an eviction from memory, and again if later dropped from disk)
+	size_t Put( const std::string& i_rKey, const std::string& i_rData );
+
+	// as above, unless the cache has been cleared since i_Generation (the GetGeneration() from before the data was
+	// loaded), in which case the data may be stale and is not stored
+	size_t Put( const std::string& i_rKey, const std::string& i_rData, size_t i_Generation );
+
+	// drops every entry, e.g. because the data they were loaded from has changed
+	void Clear();
+
+	// changes each time the cache is cleared
+	size_t GetGeneration();
+
+	// the largest entry that can be stored
+	size_t GetMaxEntryBytes() const;
+
+	// an unambiguous key for a set of parameters
+	static std::string MakeKey( const std::map< std::string, std::string >& i_rParameters );
+
+private:
+	// memory entries hold the data; disk entries hold the name of the file it was spilled to
+	typedef LruCache< boost::shared_ptr< const std::string > > MemoryCache;
+	typedef LruCache< std::string > DiskCache;
+
+	// entries evicted from memory that are to be spilled to disk
+	typedef std::vector< MemoryCache::Entry > Spills;
+
+	// files are only created, read & removed with m_Mutex released, so one request's disk I/O doesn't hold up
+	// the others. these are called with it held, and leave the I/O to the caller
+	size_t InsertInMemory( const std::string& i_rKey, boost::shared_ptr< const std::string > i_pData, double i_Expiration, Spills& o_rSpills );
+	// returns the name of the entry's file, which the caller removes
+	std::string RemoveFromDisk( DiskCache::Iterator i_Iter );
+
+	// called without m_Mutex: writes each spill to a file, then indexes it unless the cache was cleared (or the key
+	// stored again) meanwhile. an entry being spilled is briefly in neither tier. returns the # evicted from disk
+	size_t WriteToDisk( const Spills& i_rSpills, size_t i_Generation );
+
+	double m_TimeToLive;
+	size_t m_MaxBytes;
+	std::string m_WorkingDir;
+	size_t m_MaxDiskBytes;
+
+	boost::mutex m_Mutex;
+	MemoryCache m_Memory;
+	DiskCache m_Disk;
+	size_t m_Generation;
+};
+
+#endif //_RESULT_CACHE_HPP_
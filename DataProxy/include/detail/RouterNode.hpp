@@ -43,6 +43,9 @@ public:
 	virtual void InsertImplWriteForwards( std::set< std::string >& o_rForwards ) const;
 	virtual void InsertImplDeleteForwards( std::set< std::string >& o_rForwards ) const;
 
+protected:
+	virtual bool StoreImplRewindsInput() const;
+
 private:
 
 	DATUMINFO( NodeName, std::string );
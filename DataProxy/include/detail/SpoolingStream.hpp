@@ -0,0 +1,75 @@
+// description: Stores need to rewind their input for retries, failure forwarding and nodes that send the same
+//    data to several destinations, so AbstractNode used to require a seekable input, which meant a caller with
+//    a forward-only source (e.g. a request body arriving over a socket) had to buffer all of it first.
+//    A SpoolingStream reads such a source only as its own reader asks for data, and keeps what it has read in a
+//    StagingStream (memory up to a limit, then an unlinked file) so any position read so far can be returned to.
+//    Seeking past what has been read pulls the source forward; seeking to the end drains it.
+//    If the spool can't be written (e.g. the disk is full) the data already read is still returned, but any
+//    attempt to go back over it throws a SpoolingStreamException rather than replaying a hole.
+
+#ifndef _SPOOLING_STREAM_HPP_
+#define _SPOOLING_STREAM_HPP_
+
+#include "StagingStream.hpp"
+#include "MVException.hpp"
+#include <boost/noncopyable.hpp>
+#include <streambuf>
+#include <istream>
+#include <string>
+#include <vector>
+
+MV_MAKEEXCEPTIONCLASS( SpoolingStreamException, MVException );
+
+class SpoolingStreamBuffer : public std::streambuf, public boost::noncopyable
+{
+public:
+	// i_rOwner: the stream reading this buffer, which is made to throw once the spool breaks
+	SpoolingStreamBuffer( std::istream& i_rOwner, std::istream& i_rSource, size_t i_MemoryLimit, const std::string& i_rWorkingDir );
+	virtual ~SpoolingStreamBuffer();
+
+	bool IsSpilled() const;
+	size_t GetSpilledBytes() const;
+
+protected:
+	virtual int_type underflow();
+	virtual pos_type seekoff( off_type i_Offset, std::ios_base::seekdir i_Direction, std::ios_base::openmode i_Mode );
+	virtual pos_type seekpos( pos_type i_Position, std::ios_base::openmode i_Mode );
+
+private:
+	size_t GetReadPosition() const;
+
+	// reads the next block of the source into the get area (and the spool); returns false at the end of the source
+	bool ReadSource();
+
+	// throws if the spool is broken and i_Position has to come from it
+	void CheckSpool( size_t i_Position ) const;
+
+	std::istream& m_rOwner;
+	std::istream& m_rSource;
+	bool m_SourceExhausted;
+	StagingStream m_Spool;
+	size_t m_SpooledSize;
+	bool m_SpoolBroken;
+	std::vector< char > m_GetBuffer;
+	size_t m_GetAreaOffset;
+};
+
+class SpoolingStream : public std::istream
+{
+public:
+	// i_MemoryLimit: the # of bytes of the source to hold in memory before spilling to a file in i_rWorkingDir
+	// once the source goes bad, every read past what was spooled fails (throwing if the source throws on badbit)
+	SpoolingStream( std::istream& i_rSource, size_t i_MemoryLimit, const std::string& i_rWorkingDir );
+	virtual ~SpoolingStream();
+
+	bool IsSpilled() const;
+	size_t GetSpilledBytes() const;
+
+	// whether the stream supports seeking; those that don't need to be spooled before they can be stored
+	static bool IsSeekable( std::istream& i_rStream );
+
+private:
+	SpoolingStreamBuffer m_Buffer;
+};
+
+#endif //_SPOOLING_STREAM_HPP_
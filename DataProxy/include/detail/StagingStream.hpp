@@ -0,0 +1,76 @@
+// description: AbstractNode has to stage a full copy of a load's results whenever it cannot write directly
+//    to the caller's stream (retries, tees, stream transformers). A StagingStream holds that copy in memory
+//    until it grows past a configured limit, at which point everything is moved to an (already unlinked)
+//    temporary file in the configured working directory, and all further data goes to disk.
+//    Data is always appended; reads are independent of writes and may seek anywhere in the data written so far.
+
+#ifndef _STAGING_STREAM_HPP_
+#define _STAGING_STREAM_HPP_
+
+#include <boost/noncopyable.hpp>
+#include <streambuf>
+#include <istream>
+#include <string>
+#include <vector>
+
+class StagingStreamBuffer : public std::streambuf, public boost::noncopyable
+{
+public:
+	StagingStreamBuffer( size_t i_MemoryLimit, const std::string& i_rWorkingDir );
+	virtual ~StagingStreamBuffer();
+
+	// discards all data written so far
+	void Reset();
+
+	bool IsSpilled() const;
+
+	// the total # of bytes written to disk by this buffer (including data discarded by Reset)
+	size_t GetSpilledBytes() const;
+
+protected:
+	virtual std::streamsize xsputn( const char* i_pData, std::streamsize i_Size );
+	virtual int_type overflow( int_type i_Char );
+	virtual int_type underflow();
+	virtual int sync();
+	virtual pos_type seekoff( off_type i_Offset, std::ios_base::seekdir i_Direction, std::ios_base::openmode i_Mode );
+	virtual pos_type seekpos( pos_type i_Position, std::ios_base::openmode i_Mode );
+
+private:
+	char* MemoryBase();
+	size_t GetWrittenSize() const;
+	size_t GetReadPosition() const;
+	void SetPutArea( char* i_pBegin, char* i_pEnd, size_t i_Used );
+	bool GrowMemory();
+	bool Spill();
+	bool FlushPutArea();
+	void CloseFile();
+
+	size_t m_MemoryLimit;
+	std::string m_WorkingDir;
+	std::vector< char > m_Memory;
+	int m_FileDescriptor;
+	size_t m_FileSize;
+	size_t m_GetAreaOffset;
+	std::vector< char > m_PutBuffer;
+	std::vector< char > m_GetBuffer;
+	size_t m_SpilledBytes;
+};
+
+class StagingStream : public std::iostream
+{
+public:
+	// i_MemoryLimit: the # of bytes to hold in memory before spilling to a file in i_rWorkingDir
+	StagingStream( size_t i_MemoryLimit, const std::string& i_rWorkingDir );
+	virtual ~StagingStream();
+
+	// discards all data written so far and clears the stream state
+	void Reset();
+
+	bool IsSpilled() const;
+	size_t GetSpilledBytes() const;
+
+private:
+	StagingStreamBuffer m_Buffer;
+};
+
+#endif //_STAGING_STREAM_HPP_
@@ -0,0 +1,80 @@
+// description: A bounded, in-memory, single-producer/single-consumer byte pipe for handing a stream
+//    from one thread to another. The writer blocks while the pipe is full and the reader blocks while it
+//    is empty, so no more than the pipe's capacity is ever held in memory. Either side may close its end:
+//    closing the write end gives the reader an end-of-stream once the pipe drains; closing the read end
+//    makes any further writes fail, so a producer whose consumer has gone away will not block forever.
+//    A producer that fails part way through can abort its end instead, making the reader fail rather than
+//    mistake a truncated stream for a complete one.
+//    StreamPipeSource/StreamPipeSink adapt the two ends for use with boost::iostreams streams.
+
+#ifndef _STREAM_PIPE_HPP_
+#define _STREAM_PIPE_HPP_
+
+#include "MVException.hpp"
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/iostreams/categories.hpp>
+#include <ios>
+#include <vector>
+
+MV_MAKEEXCEPTIONCLASS( StreamPipeException, MVException );
+
+class StreamPipe : public boost::noncopyable
+{
+public:
+	StreamPipe( size_t i_Capacity );
+	virtual ~StreamPipe();
+
+	// blocks until all the data has been written; throws if the read end is closed
+	void Write( const char* i_pData, size_t i_Size );
+
+	// blocks until at least one byte is available; returns 0 once the write end is closed and the pipe is empty.
+	// throws if the write end has been aborted
+	size_t Read( char* o_pData, size_t i_Size );
+
+	void CloseWrite();
+	void AbortWrite();
+	void CloseRead();
+
+private:
+	boost::mutex m_Mutex;
+	boost::condition_variable m_NotEmpty;
+	boost::condition_variable m_NotFull;
+	std::vector< char > m_Buffer;
+	size_t m_Begin;
+	size_t m_Size;
+	bool m_WriteClosed;
+	bool m_WriteAborted;
+	bool m_ReadClosed;
+};
+
+class StreamPipeSource
+{
+public:
+	typedef char char_type;
+	typedef boost::iostreams::source_tag category;
+
+	StreamPipeSource( StreamPipe& i_rPipe );
+
+	std::streamsize read( char* o_pData, std::streamsize i_Size );
+
+private:
+	StreamPipe* m_pPipe;
+};
+
+class StreamPipeSink
+{
+public:
+	typedef char char_type;
+	typedef boost::iostreams::sink_tag category;
+
+	StreamPipeSink( StreamPipe& i_rPipe );
+
+	std::streamsize write( const char* i_pData, std::streamsize i_Size );
+
+private:
+	StreamPipe* m_pPipe;
+};
+
+#endif //_STREAM_PIPE_HPP_
@@ -37,6 +37,11 @@ public:
 	virtual boost::shared_ptr< std::istream > TransformStream( const std::map< std::string, std::string >& i_rParameters,
 																boost::shared_ptr< std::istream > i_pStream ) const;
 
+	// pipelined form: consumes i_rInput as it arrives and writes the result to o_rOutput. functions that do not
+	// support streaming are handed a fully materialized copy of the input, just as they would be otherwise
+	virtual void TransformStream( const std::map< std::string, std::string >& i_rParameters, std::istream& i_rInput, std::ostream& o_rOutput ) const;
+	bool SupportsStreaming() const;
+
 	static void SwapTransformFunctionDomain( boost::scoped_ptr< ITransformFunctionDomain >& i_pSwapDomain );
 
 private:
@@ -0,0 +1,41 @@
+// description: Exclusive locks on database tables, by name, for serializing the parts of concurrent stores that
+//    share a table (e.g. a fixed staging table, or merges into a target table) while letting stores into
+//    different tables proceed in parallel. A table's lock only exists while it is held or waited on.
+
+#ifndef _TABLE_LOCKS_HPP_
+#define _TABLE_LOCKS_HPP_
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <map>
+#include <string>
+
+class TableLocks : public boost::noncopyable
+{
+public:
+	TableLocks();
+	virtual ~TableLocks();
+
+	// blocks until the table is locked; unlocks it when destroyed
+	class Lock : public boost::noncopyable
+	{
+	public:
+		Lock( TableLocks& i_rLocks, const std::string& i_rTable );
+		virtual ~Lock();
+
+	private:
+		TableLocks& m_rLocks;
+		std::string m_Table;
+		boost::shared_ptr< boost::mutex > m_pMutex;
+	};
+
+	// the number of tables currently locked or waited on
+	size_t GetSize() const;
+
+private:
+	mutable boost::mutex m_Mutex;
+	std::map< std::string, boost::shared_ptr< boost::mutex > > m_Locks;
+};
+
+#endif //_TABLE_LOCKS_HPP_
@@ -33,7 +33,11 @@ public:
 	bool HasStreamTransformers() const;
 	
 private:
+	boost::shared_ptr<std::istream> TransformStreamPipelined( const std::map< std::string, std::string >& i_rParameters, boost::shared_ptr< std::istream > i_pData ) const;
+
 	std::vector< boost::shared_ptr< StreamTransformer > > m_Transformers;
+	bool m_Pipelined;
+	size_t m_PipeSize;
 
 };
 
@@ -0,0 +1,43 @@
+// description: A fixed number of threads servicing a queue of tasks, so the number of tasks running at
+//    once is bounded no matter how many are posted. Tasks run in the order they were posted. A task must
+//    not wait on a task posted after it to the same pool, since with every thread waiting none would be
+//    left to run it. Destroying the pool runs every task already posted before joining the threads.
+
+#ifndef _WORKER_POOL_HPP_
+#define _WORKER_POOL_HPP_
+
+#include <boost/noncopyable.hpp>
+#include <boost/function.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <deque>
+
+class WorkerPool : public boost::noncopyable
+{
+public:
+	WorkerPool( size_t i_NumThreads );
+	virtual ~WorkerPool();
+
+	// queues a task; any exception it throws is logged and discarded
+	void Post( const boost::function< void() >& i_rTask );
+
+	// blocks until no task is queued or running
+	void WaitForIdle();
+
+	size_t GetNumThreads() const;
+
+private:
+	void Run();
+
+	boost::mutex m_Mutex;
+	boost::condition_variable m_TaskPosted;
+	boost::condition_variable m_Idle;
+	std::deque< boost::function< void() > > m_Tasks;
+	size_t m_Running;
+	bool m_Stopping;
+	size_t m_NumThreads;
+	boost::thread_group m_Threads;
+};
+
+#endif //_WORKER_POOL_HPP_
@@ -9,6 +9,7 @@
 // UPDATED BY:      $Author: esaxe $
 
 #include "MockDataProxyClient.hpp"
+#include "AbstractNode.hpp"
 #include <sstream>
 #include <boost/algorithm/string/replace.hpp>
 #include <stdio.h>
@@ -84,7 +85,9 @@ MockDataProxyClient::MockDataProxyClient()
 	m_rLog( m_Log ),
 	m_ExceptionNameAndParameters(),
 	m_DataForNodeParameterAgnostic(),
-	m_DataForNodeAndParameters()
+	m_DataForNodeAndParameters(),
+	m_Nodes(),
+	m_InTransaction( false )
 {
 }
 
@@ -95,7 +98,9 @@ MockDataProxyClient::MockDataProxyClient( std::ostream& o_rLog )
 	m_rLog( o_rLog ),
 	m_ExceptionNameAndParameters(),
 	m_DataForNodeParameterAgnostic(),
-	m_DataForNodeAndParameters()
+	m_DataForNodeAndParameters(),
+	m_Nodes(),
+	m_InTransaction( false )
 {
 }
 
@@ -108,6 +113,12 @@ void MockDataProxyClient::Initialize( const std::string& i_rConfigFileSpec )
 	m_rLog << "Initialize called with ConfigFileSpec: " << i_rConfigFileSpec << std::endl;
 }
 
+void MockDataProxyClient::SetConfigCheckOptions( double i_MinimumRecheckSeconds, bool i_UseFileNotification )
+{
+	m_rLog << "SetConfigCheckOptions called with MinimumRecheckSeconds: " << i_MinimumRecheckSeconds
+		   << " UseFileNotification: " << i_UseFileNotification << std::endl;
+}
+
 void MockDataProxyClient::Ping( const std::string& i_rName, int i_Mode ) const
 {
 	m_Log << "Ping called with Name: " << i_rName << " Mode: " << i_Mode << std::endl;
@@ -150,6 +161,13 @@ void MockDataProxyClient::Load( const std::string& i_rName, const std::map<std::
 
 void MockDataProxyClient::Store( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::istream& i_rData ) const
 {
+	std::map< std::string, AbstractNode* >::const_iterator nodeIter = m_Nodes.find( i_rName );
+	if( nodeIter != m_Nodes.end() )
+	{
+		nodeIter->second->Store( i_rParameters, i_rData );
+		return;
+	}
+
 	std::stringstream dataStream;
 	dataStream << i_rData.rdbuf();
 	std::string data = dataStream.str();
@@ -181,19 +199,27 @@ void MockDataProxyClient::Delete( const std::string& i_rName, const std::map<std
 	}
 }
 
+bool MockDataProxyClient::InsideTransaction()
+{
+	return m_InTransaction;
+}
+
 void MockDataProxyClient::BeginTransaction( bool i_AbortCurrent )
 {
 	m_rLog << "BeginTransaction called" << ( i_AbortCurrent ? ", aborting current" : "" ) << std::endl;
+	m_InTransaction = true;
 }
 
 void MockDataProxyClient::Commit()
 {
 	m_rLog << "Commit called" << std::endl;
+	m_InTransaction = false;
 }
 
 void MockDataProxyClient::Rollback()
 {
 	m_rLog << "Rollback called" << std::endl;
+	m_InTransaction = false;
 }
 
 
@@ -231,3 +257,8 @@ void MockDataProxyClient::SetDataToReturn( const std::string& i_rName, const std
 {
 	m_DataForNodeAndParameters[DataNodeAndParameters(i_rName, i_rParameters)] = i_rData;
 }
+
+void MockDataProxyClient::SetNodeForName( const std::string& i_rName, AbstractNode& i_rNode )
+{
+	m_Nodes[ i_rName ] = &i_rNode;
+}
@@ -13,6 +13,8 @@
 
 #include "DataProxyClient.hpp"
 
+class AbstractNode;
+
 class MockDataProxyClient : public DataProxyClient
 {
 public:
@@ -21,10 +23,12 @@ public:
 	virtual ~MockDataProxyClient();
 
 	virtual void Initialize( const std::string& i_rConfigFileSpec );
+	virtual void SetConfigCheckOptions( double i_MinimumRecheckSeconds, bool i_UseFileNotification );
 	virtual void Ping( const std::string& i_rName, int i_Mode ) const;
 	virtual void Load( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::ostream& o_rData ) const;
 	virtual void Store( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::istream& i_rData ) const;
 	virtual void Delete( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters ) const;
+	virtual bool InsideTransaction();
 	virtual void BeginTransaction( bool i_AbortCurrent = false );
 	virtual void Commit();
 	virtual void Rollback();
@@ -36,6 +40,8 @@ public:
 	void SetExceptionForName( const std::string& i_rName, const std::map<std::string,std::string>& i_rSpecificParameters );
 	void SetDataToReturn( const std::string& i_rName, const std::string& i_rData );
 	void SetDataToReturn( const std::string& i_rName, const std::map<std::string, std::string>& i_rParameters, const std::string& i_rData );
+	// stores to this name are passed on to the given node rather than logged
+	void SetNodeForName( const std::string& i_rName, AbstractNode& i_rNode );
 
 	mutable std::vector< std::string > storedNonPrintableData;
 
@@ -47,6 +53,8 @@ private:
 	typedef std::pair<std::string, std::map<std::string, std::string> > DataNodeAndParameters;
 	typedef std::map<DataNodeAndParameters, std::string > DataNodeAndParametersToResultMap;
 	DataNodeAndParametersToResultMap m_DataForNodeAndParameters;
+	std::map< std::string, AbstractNode* > m_Nodes;
+	bool m_InTransaction;
 };
 
 
@@ -135,6 +135,13 @@ void MockDatabaseConnectionManager::InsertConnection(const std::string& i_rConne
 			( new Database( Database::DBCONN_ODBC_MYSQL, i_rConnection->GetServerName(), i_rConnection->GetDBName(),
 							i_rConnection->GetUserName(), i_rConnection->GetPassword(), false ) );
 	}
+	else if( i_rType == "vertica" )
+	{
+		// there's no vertica unit test database, so this is only good for nodes that never use the connection
+		m_DatabaseTypes[ i_rConnectionName ] = "vertica";
+		m_DatabaseTypes[ MOCK_DATA_DEFINITION_CONNECTION_PREFIX + i_rConnectionName ] = "vertica";
+		m_MockConnectionMap[MOCK_DATA_DEFINITION_CONNECTION_PREFIX + i_rConnectionName] = i_rConnection;
+	}
 	else
 	{
 		MV_THROW( MVException, "Unable to discern database type" );
@@ -14,10 +14,14 @@
 #include "MockDataProxyClient.hpp"
 #include "MockRequestForwarder.hpp"
 #include <boost/make_shared.hpp>
+#include <boost/thread/mutex.hpp>
 
 namespace
 {
 	MockDataProxyClient DEFAULT_DPL_CLIENT;
+
+	// nodes may be called on several threads at once (e.g. by LoadMany), and they share their factory's log
+	boost::mutex LOG_MUTEX;
 }
 
 MockNode::MockNode( std::ostream& i_rLog,
@@ -36,6 +40,8 @@ MockNode::MockNode( std::ostream& i_rLog,
 					const std::set< std::string >& i_rReadForwards,
 					const std::set< std::string >& i_rWriteForwards,
 					const std::set< std::string >& i_rDeleteForwards,
+					const boost::function< void() >& i_rLoadCallback,
+					const boost::function< void() >& i_rStoreCallback,
 					const xercesc::DOMNode& i_rNode )
 :	AbstractNode( i_rName, boost::make_shared< MockRequestForwarder >( DEFAULT_DPL_CLIENT ), i_rNode ),
 	m_rLog( i_rLog ),
@@ -53,7 +59,9 @@ MockNode::MockNode( std::ostream& i_rLog,
 	m_DataToReturn( i_rDataToReturn ),
 	m_ReadForwards( i_rReadForwards ),
 	m_WriteForwards( i_rWriteForwards ),
-	m_DeleteForwards( i_rDeleteForwards )
+	m_DeleteForwards( i_rDeleteForwards ),
+	m_LoadCallback( i_rLoadCallback ),
+	m_StoreCallback( i_rStoreCallback )
 {
 }
 
@@ -63,7 +71,14 @@ MockNode::~MockNode()
 
 bool MockNode::Load( const std::map<std::string,std::string>& i_rParameters, std::ostream& o_rData )
 {
-	m_rLog << "Load called on: " << m_Name << " with parameters: " << ProxyUtilities::ToString( i_rParameters ) << std::endl;
+	{
+		boost::unique_lock< boost::mutex > lock( LOG_MUTEX );
+		m_rLog << "Load called on: " << m_Name << " with parameters: " << ProxyUtilities::ToString( i_rParameters ) << std::endl;
+	}
+	if( m_LoadCallback )
+	{
+		m_LoadCallback();
+	}
 	if( m_LoadException )
 	{
 		MV_THROW( MVException, "Set to throw exception" );
@@ -74,7 +89,14 @@ bool MockNode::Load( const std::map<std::string,std::string>& i_rParameters, std
 
 bool MockNode::Store( const std::map<std::string,std::string>& i_rParameters, std::istream& i_rData )
 {
-	m_rLog << "Store called on: " << m_Name << " with parameters: " << ProxyUtilities::ToString( i_rParameters ) << " with data: " << i_rData.rdbuf() << std::endl;
+	{
+		boost::unique_lock< boost::mutex > lock( LOG_MUTEX );
+		m_rLog << "Store called on: " << m_Name << " with parameters: " << ProxyUtilities::ToString( i_rParameters ) << " with data: " << i_rData.rdbuf() << std::endl;
+	}
+	if( m_StoreCallback )
+	{
+		m_StoreCallback();
+	}
 	if( m_StoreException )
 	{
 		MV_THROW( MVException, "Set to throw exception" );
@@ -84,6 +106,7 @@ bool MockNode::Store( const std::map<std::string,std::string>& i_rParameters, st
 
 bool MockNode::Delete( const std::map<std::string,std::string>& i_rParameters )
 {
+	boost::unique_lock< boost::mutex > lock( LOG_MUTEX );
 	m_rLog << "Delete called on: " << m_Name << " with parameters: " << ProxyUtilities::ToString( i_rParameters ) << std::endl;
 	if( m_DeleteException )
 	{
@@ -111,6 +134,7 @@ bool MockNode::SupportsTransactions() const
 
 void MockNode::Commit()
 {
+	boost::unique_lock< boost::mutex > lock( LOG_MUTEX );
 	m_rLog << "Commit called on: " << m_Name << std::endl;
 	if( m_CommitException )
 	{
@@ -120,6 +144,7 @@ void MockNode::Commit()
 
 void MockNode::Rollback()
 {
+	boost::unique_lock< boost::mutex > lock( LOG_MUTEX );
 	m_rLog << "Rollback called on: " << m_Name << std::endl;
 	if( m_RollbackException )
 	{
@@ -156,6 +181,7 @@ void MockNode::InsertImplDeleteForwards( std::set< std::string >& o_rForwards )
 
 void MockNode::Ping( int i_Mode ) const
 {
+	boost::unique_lock< boost::mutex > lock( LOG_MUTEX );
 	m_rLog << "Ping called on: " << m_Name << " with mode: " << i_Mode << std::endl;
 	if( m_PingException )
 	{
@@ -12,6 +12,7 @@
 #define _MOCK_NODE_HPP_
 
 #include "AbstractNode.hpp"
+#include <boost/function.hpp>
 #include <map>
 #include <set>
 
@@ -34,6 +35,8 @@ public:
 			  const std::set< std::string >& i_rReadForwards,
 			  const std::set< std::string >& i_rWriteForwards,
 			  const std::set< std::string >& i_rDeleteForwards,
+			  const boost::function< void() >& i_rLoadCallback,
+			  const boost::function< void() >& i_rStoreCallback,
 			  const xercesc::DOMNode& i_rNode );
 	virtual ~MockNode();
 	
@@ -76,6 +79,8 @@ private:
 	std::set< std::string > m_ReadForwards;
 	std::set< std::string > m_WriteForwards;
 	std::set< std::string > m_DeleteForwards;
+	boost::function< void() > m_LoadCallback;
+	boost::function< void() > m_StoreCallback;
 };
 
 #endif //_MOCK_NODE_HPP_
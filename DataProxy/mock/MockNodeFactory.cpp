@@ -55,6 +55,8 @@ AbstractNode* MockNodeFactory::CreateNode( const std::string& i_rName, const std
 						 GetValue< std::set< std::string > >( i_rName, m_ReadForwards, std::set< std::string >() ),
 						 GetValue< std::set< std::string > >( i_rName, m_WriteForwards, std::set< std::string >() ),
 						 GetValue< std::set< std::string > >( i_rName, m_DeleteForwards, std::set< std::string >() ),
+						 GetValue< boost::function< void() > >( i_rName, m_LoadCallbacks, boost::function< void() >() ),
+						 GetValue< boost::function< void() > >( i_rName, m_StoreCallbacks, boost::function< void() >() ),
 						 i_rNode );
 }
 
@@ -133,6 +135,16 @@ void MockNodeFactory::AddDeleteForward( const std::string& i_rName, const std::s
 	m_DeleteForwards[ i_rName ].insert( i_rValue );
 }
 
+void MockNodeFactory::SetLoadCallback( const std::string& i_rName, const boost::function< void() >& i_rCallback )
+{
+	m_LoadCallbacks[ i_rName ] = i_rCallback;
+}
+
+void MockNodeFactory::SetStoreCallback( const std::string& i_rName, const boost::function< void() >& i_rCallback )
+{
+	m_StoreCallbacks[ i_rName ] = i_rCallback;
+}
+
 std::string MockNodeFactory::GetLog() const
 {
 	return m_Log.str();
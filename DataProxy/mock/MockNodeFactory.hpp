@@ -12,6 +12,7 @@
 #define _MOCK_NODE_FACTORY_HPP_
 
 #include "INodeFactory.hpp"
+#include <boost/function.hpp>
 #include <sstream>
 #include <map>
 #include <set>
@@ -41,6 +42,9 @@ public:
 	void AddReadForward( const std::string& i_rName, const std::string& i_rValue );
 	void AddWriteForward( const std::string& i_rName, const std::string& i_rValue );
 	void AddDeleteForward( const std::string& i_rName, const std::string& i_rValue );
+	// called by the named node's Load or Store, after it has been logged
+	void SetLoadCallback( const std::string& i_rName, const boost::function< void() >& i_rCallback );
+	void SetStoreCallback( const std::string& i_rName, const boost::function< void() >& i_rCallback );
 
 	std::string GetLog() const;
 
@@ -60,6 +64,8 @@ private:
 	std::map< std::string, std::set< std::string > > m_ReadForwards;
 	std::map< std::string, std::set< std::string > > m_WriteForwards;
 	std::map< std::string, std::set< std::string > > m_DeleteForwards;
+	std::map< std::string, boost::function< void() > > m_LoadCallbacks;
+	std::map< std::string, boost::function< void() > > m_StoreCallbacks;
 };
 
 #endif //_MOCK_NODE_FACTORY_HPP_
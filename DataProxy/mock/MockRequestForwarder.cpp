@@ -30,3 +30,8 @@ void MockRequestForwarder::Delete( const std::string& i_rName, const std::map<st
 {
 	m_rDataProxyClient.Delete( i_rName, i_rParameters );
 }
+
+bool MockRequestForwarder::InsideTransaction() const
+{
+	return const_cast< MockDataProxyClient& >( m_rDataProxyClient ).InsideTransaction();
+}
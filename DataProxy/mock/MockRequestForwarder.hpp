@@ -18,7 +18,9 @@ public:
 	virtual void Ping( const std::string& i_rName, int i_Mode ) const;
 	virtual void Load( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::ostream& o_rData ) const;
 	virtual void Store( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::istream& i_rData ) const;
+	using RequestForwarder::Store;
 	virtual void Delete( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters ) const;
+	virtual bool InsideTransaction() const;
 
 private:
 	const MockDataProxyClient& m_rDataProxyClient;
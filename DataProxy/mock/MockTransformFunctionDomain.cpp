@@ -25,6 +25,7 @@ namespace
 	const std::string STANDARD_TRANSFORM_FUNCTION_KEY( "StandardTransformFunction" );
 	const std::string NULL_TRANSFORM_FUNCTION_KEY( "NullTransformFunction" );
 	const std::string THROWING_TRANSFORM_FUNCTION_KEY( "ThrowingTransformFunction" );
+	const std::string STREAMING_TRANSFORM_FUNCTION_KEY( "StreamingTransformFunction" );
 
 	boost::shared_ptr< ITransformFunction > SharedTransformFunction( ITransformFunction* i_pFunction )
 	{
@@ -42,7 +43,8 @@ MockTransformFunctionDomain::MockTransformFunctionDomain()
 	m_FunctionsByType = boost::assign::map_list_of
 		( STANDARD_TRANSFORM_FUNCTION_KEY, SharedTransformFunction(new StandardMockTransformFunction()) )
 		( NULL_TRANSFORM_FUNCTION_KEY, SharedTransformFunction(new NullMockTransformFunction()) )
-		( THROWING_TRANSFORM_FUNCTION_KEY, SharedTransformFunction(new ThrowingMockTransformFunction()) );
+		( THROWING_TRANSFORM_FUNCTION_KEY, SharedTransformFunction(new ThrowingMockTransformFunction()) )
+		( STREAMING_TRANSFORM_FUNCTION_KEY, SharedTransformFunction(new StreamingMockTransformFunction()) );
 
 	m_FunctionsByPathAndName = boost::assign::map_list_of
 		( STANDARD_TRANSFORM_FUNCTION_KEY_PAIR, m_FunctionsByType[STANDARD_TRANSFORM_FUNCTION_KEY] )
@@ -60,3 +60,38 @@ boost::shared_ptr<std::istream> ThrowingMockTransformFunction::TransformInput( b
 {
 	throw std::runtime_error("an exception");
 }
+
+StreamingMockTransformFunction::StreamingMockTransformFunction()
+{
+}
+
+StreamingMockTransformFunction::~StreamingMockTransformFunction()
+{
+}
+
+boost::shared_ptr<std::istream> StreamingMockTransformFunction::TransformInput( boost::shared_ptr< std::istream > i_pInput, const std::map< std::string, std::string >& i_rParameters )
+{
+	std::stringstream* pStream = new std::stringstream();
+	boost::shared_ptr< std::istream > pResult( pStream );
+	TransformInput( *i_pInput, *pStream, i_rParameters );
+	return pResult;
+}
+
+bool StreamingMockTransformFunction::SupportsStreaming() const
+{
+	return true;
+}
+
+void StreamingMockTransformFunction::TransformInput( std::istream& i_rInput, std::ostream& o_rOutput, const std::map< std::string, std::string >& i_rParameters )
+{
+	std::map< std::string, std::string >::const_iterator paramIter = i_rParameters.begin();
+	for(; paramIter != i_rParameters.end(); ++paramIter)
+	{
+		o_rOutput << paramIter->first << " : " << paramIter->second << std::endl;
+	}
+
+	if( i_rInput.peek() != EOF )
+	{
+		o_rOutput << i_rInput.rdbuf();
+	}
+}
@@ -14,6 +14,7 @@
 #include "ITransformFunction.hpp"
 #include <boost/shared_ptr.hpp>
 #include <istream>
+#include <ostream>
 #include <map>
 #include <string>
 
@@ -44,4 +45,16 @@ public:
 	virtual boost::shared_ptr<std::istream> TransformInput( boost::shared_ptr< std::istream > i_pInput, const std::map< std::string, std::string >& i_rParameters );
 };
 
+// produces the same output as StandardMockTransformFunction, but supports streaming
+class StreamingMockTransformFunction : public ITransformFunction
+{
+public:
+	StreamingMockTransformFunction();
+	virtual ~StreamingMockTransformFunction();
+
+	virtual boost::shared_ptr<std::istream> TransformInput( boost::shared_ptr< std::istream > i_pInput, const std::map< std::string, std::string >& i_rParameters );
+	virtual bool SupportsStreaming() const;
+	virtual void TransformInput( std::istream& i_rInput, std::ostream& o_rOutput, const std::map< std::string, std::string >& i_rParameters );
+};
+
 #endif //_MOCK_TRANSFORM_FUNCTIONS_HPP_
@@ -11,12 +11,6 @@
 #include "TestableDataProxyClient.hpp"
 #include "DatabaseConnectionManager.hpp"
 #include "NodeFactory.hpp"
-#include <boost/scoped_ptr.hpp>
-
-namespace
-{
-	boost::scoped_ptr< DatabaseConnectionManager > s_pDatabaseConnectionManager( NULL );
-}
 
 TestableDataProxyClient::TestableDataProxyClient()
 :	DataProxyClient( true )
@@ -29,24 +23,14 @@ TestableDataProxyClient::~TestableDataProxyClient()
 
 void TestableDataProxyClient::Initialize( const std::string& i_rConfigFileSpec )
 {
-	if( s_pDatabaseConnectionManager == NULL )
-	{
-		s_pDatabaseConnectionManager.reset( new DatabaseConnectionManager( *this ) );
-	}
-
 	NodeFactory nodeFactory( *this );
-	DataProxyClient::Initialize( i_rConfigFileSpec, nodeFactory, *s_pDatabaseConnectionManager );
+	DataProxyClient::Initialize( i_rConfigFileSpec, nodeFactory );
 }
 
 void TestableDataProxyClient::Initialize( const std::string& i_rConfigFileSpec,
 										  INodeFactory& i_rNodeFactory )
 {
-	if( s_pDatabaseConnectionManager == NULL )
-	{
-		s_pDatabaseConnectionManager.reset( new DatabaseConnectionManager( *this ) );
-	}
-
-	DataProxyClient::Initialize( i_rConfigFileSpec, i_rNodeFactory, *s_pDatabaseConnectionManager );
+	DataProxyClient::Initialize( i_rConfigFileSpec, i_rNodeFactory );
 }
 
 void TestableDataProxyClient::Initialize( const std::string& i_rConfigFileSpec,
@@ -12,6 +12,7 @@
 #include "DataProxyClient.hpp"
 #include "ProxyUtilities.hpp"
 #include "MockRequestForwarder.hpp"
+#include "SpoolingStream.hpp"
 #include <boost/iostreams/copy.hpp>
 #include <boost/make_shared.hpp>
 
@@ -26,7 +27,13 @@ TestableNode::TestableNode(	const std::string& i_rName,
 	m_StoreException( false ),
 	m_DeleteException( false ),
 	m_WriteOnLoadException( false ),
+	m_FlushOnLoadException( false ),
 	m_SeekOnStore( false ),
+	m_StoreInputSeekable( false ),
+	m_LoadsMutex(),
+	m_LoadsChanged(),
+	m_HoldLoads( false ),
+	m_LoadsStarted( 0 ),
 	m_ReadForwards(),
 	m_WriteForwards(),
 	m_DeleteForwards()
@@ -39,12 +46,26 @@ TestableNode::~TestableNode()
 
 void TestableNode::LoadImpl( const std::map<std::string,std::string>& i_rParameters, std::ostream& o_rData )
 {
-	m_Log << "LoadImpl called with parameters: " << ProxyUtilities::ToString( i_rParameters ) << std::endl;
+	{
+		// loads may run concurrently, so the log is written under the lock
+		boost::unique_lock< boost::mutex > lock( m_LoadsMutex );
+		m_Log << "LoadImpl called with parameters: " << ProxyUtilities::ToString( i_rParameters ) << std::endl;
+		++m_LoadsStarted;
+		m_LoadsChanged.notify_all();
+		while( m_HoldLoads )
+		{
+			m_LoadsChanged.wait( lock );
+		}
+	}
 	if( m_LoadException )
 	{
 		if( m_WriteOnLoadException )
 		{
 			o_rData << "This is some exception data" << std::endl;
+			if( m_FlushOnLoadException )
+			{
+				o_rData.flush();
+			}
 		}
 		MV_THROW( MVException, "Set to throw exception" );
 	}
@@ -53,6 +74,7 @@ void TestableNode::LoadImpl( const std::map<std::string,std::string>& i_rParamet
 
 void TestableNode::StoreImpl( const std::map<std::string,std::string>& i_rParameters, std::istream& i_rData )
 {
+	m_StoreInputSeekable = SpoolingStream::IsSeekable( i_rData );
 	if( m_SeekOnStore )
 	{
 		std::streampos current = i_rData.tellg();
@@ -145,11 +167,38 @@ void TestableNode::SetWriteOnLoadException( bool i_Exception )
 	m_WriteOnLoadException = i_Exception;
 }
 
+void TestableNode::SetFlushOnLoadException( bool i_Exception )
+{
+	m_FlushOnLoadException = i_Exception;
+}
+
 void TestableNode::SetSeekOnStore( bool i_SeekOnStore )
 {
 	m_SeekOnStore = i_SeekOnStore;
 }
 
+void TestableNode::HoldLoads()
+{
+	boost::unique_lock< boost::mutex > lock( m_LoadsMutex );
+	m_HoldLoads = true;
+}
+
+void TestableNode::ReleaseLoads()
+{
+	boost::unique_lock< boost::mutex > lock( m_LoadsMutex );
+	m_HoldLoads = false;
+	m_LoadsChanged.notify_all();
+}
+
+void TestableNode::WaitForLoadsStarted( size_t i_Count )
+{
+	boost::unique_lock< boost::mutex > lock( m_LoadsMutex );
+	while( m_LoadsStarted < i_Count )
+	{
+		m_LoadsChanged.wait( lock );
+	}
+}
+
 void TestableNode::AddReadForward( const std::string& i_rForward )
 {
 	m_ReadForwards.insert( i_rForward );
@@ -173,3 +222,13 @@ void TestableNode::Ping( int i_Mode ) const
 		MV_THROW( MVException, "Set to throw exception" );
 	}
 }
+
+bool TestableNode::WasStoreInputSeekable() const
+{
+	return m_StoreInputSeekable;
+}
+
+bool TestableNode::StoreImplRewindsInput() const
+{
+	return m_SeekOnStore;
+}
@@ -16,6 +16,8 @@
 #include <vector>
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
 #include <set>
 
 class MockDataProxyClient;
@@ -54,8 +56,22 @@ public:
 	void AddWriteForward( const std::string& i_rForward );
 	void AddDeleteForward( const std::string& i_rForward );
 	void SetWriteOnLoadException( bool i_WriteOnLoadException );
+	void SetFlushOnLoadException( bool i_FlushOnLoadException );
 	void SetSeekOnStore( bool i_SeekOnStore );
 
+	// while held, LoadImpl waits to be released once it has been called
+	void HoldLoads();
+	void ReleaseLoads();
+	void WaitForLoadsStarted( size_t i_Count );
+
+	using AbstractNode::GetCoalescedLoadCount;
+
+	// whether the input of the last StoreImpl could be rewound
+	bool WasStoreInputSeekable() const;
+
+protected:
+	virtual bool StoreImplRewindsInput() const;
+
 private:
 	mutable std::stringstream m_Log;
 	std::string m_DataToReturn;
@@ -64,7 +80,13 @@ private:
 	bool m_StoreException;
 	bool m_DeleteException;
 	bool m_WriteOnLoadException;
+	bool m_FlushOnLoadException;
 	bool m_SeekOnStore;
+	bool m_StoreInputSeekable;
+	boost::mutex m_LoadsMutex;
+	boost::condition_variable m_LoadsChanged;
+	bool m_HoldLoads;
+	size_t m_LoadsStarted;
 	std::set< std::string > m_ReadForwards;
 	std::set< std::string > m_WriteForwards;
 	std::set< std::string > m_DeleteForwards;
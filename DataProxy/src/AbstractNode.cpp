@@ -15,17 +15,27 @@
 #include "DPLCommon.hpp"
 #include "XMLUtilities.hpp"
 #include "ProxyUtilities.hpp"
-#include "LargeStringStream.hpp"
+#include "StagingStream.hpp"
+#include "SpoolingStream.hpp"
+#include "ConcurrentTee.hpp"
+#include "ResultCache.hpp"
+#include "LoadCoalescer.hpp"
+#include "FileUtilities.hpp"
 #include "RequestForwarder.hpp"
+#include "RequestTimer.hpp"
 #include "MVLogger.hpp"
+#include <algorithm>
 #include <fstream>
+#include <limits>
 #include <boost/lexical_cast.hpp>
 #include "Counters.hpp"
 #include "MonitoringTracker.hpp"
 #include <boost/iostreams/categories.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/tee.hpp>
 #include <boost/ref.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
 
 namespace
@@ -36,6 +46,24 @@ namespace
 	const std::string OPERATION_PROCESS( "process" ); // also the default! 
 	const std::string OPERATION_IGNORE( "ignore" );
 
+	const std::string MEMORY_LIMIT_ATTRIBUTE( "memoryLimit" );
+	const std::string WORKING_DIR_ATTRIBUTE( "workingDir" );
+	const std::string DEFAULT_WORKING_DIR( "/tmp" );
+	// a store input that has to be spooled spills to disk past this, unless the write Staging element says otherwise
+	const size_t DEFAULT_WRITE_MEMORY_LIMIT( 64 * 1024 * 1024 );
+
+	const std::string CONCURRENT_ATTRIBUTE( "concurrent" );
+	const std::string ASYNC_ATTRIBUTE( "async" );
+	const std::string BUFFER_SIZE_ATTRIBUTE( "bufferSize" );
+	const size_t DEFAULT_TEE_BUFFER_SIZE( 1024 * 1024 );
+
+	const std::string RETRY_UNTIL_FIRST_BYTE_ATTRIBUTE( "retryUntilFirstByte" );
+
+	const std::string TTL_ATTRIBUTE( "ttl" );
+	const std::string MAX_BYTES_ATTRIBUTE( "maxBytes" );
+	const std::string MAX_DISK_BYTES_ATTRIBUTE( "maxDiskBytes" );
+	const size_t DEFAULT_COALESCE_MAX_BYTES( 64 * 1024 * 1024 );
+
 	const std::string LOAD_SCOPE_ID( "dpl.load" );
 	const std::string STORE_SCOPE_ID( "dpl.store" );
 	const std::string DELETE_SCOPE_ID( "dpl.delete" );
@@ -44,12 +72,31 @@ namespace
 	const std::string METRIC_PAYLOAD_LINES( "payloadLines" );
 	const std::string METRIC_PAYLOAD_BYTES_PRE_TRANSFORM( "payloadBytesPreTransform" );
 	const std::string METRIC_PAYLOAD_LINES_PRE_TRANSFORM( "payloadLinesPreTransform" );
+	const std::string METRIC_PAYLOAD_BYTES_SPILLED( "payloadBytesSpilled" );
+	const std::string METRIC_CACHE_HITS( "cacheHits" );
+	const std::string METRIC_CACHE_MISSES( "cacheMisses" );
+	const std::string METRIC_CACHE_EVICTIONS( "cacheEvictions" );
+	const std::string METRIC_LOADS_COALESCED( "loadsCoalesced" );
 
 	const std::string CHILD_RESULT( "result" );
 	const std::string CHILD_RESULT_SUCCESS( "success" );
 	const std::string CHILD_RESULT_FAILED( "fail" );
 	const std::string CHILD_NODE( "node" );
 
+	const std::string LOAD_OPERATION( "load" );
+	const std::string STORE_OPERATION( "store" );
+	const std::string DELETE_OPERATION( "delete" );
+	const std::string RESULT_FORWARDED( "forwarded" );
+
+	// each is reported as a metric named after it, e.g. "translateSeconds"
+	const std::string PHASE_TRANSLATE( "translate" );
+	const std::string PHASE_IMPL( "impl" );
+	const std::string PHASE_RETRY_DELAY( "retryDelay" );
+	const std::string PHASE_TRANSFORM( "transform" );
+	const std::string PHASE_TEE( "tee" );
+	const std::string PHASE_OUTPUT( "output" );
+	const std::string PHASE_FORWARD( "forward" );
+
 	const std::map< std::string, std::string >& ChooseParameters( const std::map< std::string, std::string >& i_rOriginalParameters,
 																  const std::map< std::string, std::string >& i_rTranslatedParameters,
 																  bool i_ForwardTranslatedParameters )
@@ -61,6 +108,69 @@ namespace
 		return i_rOriginalParameters;
 	}
 
+	// the chain a load is written through: counted, optionally teed and captured for the cache, then on to its destination
+	void PushLoadOutput( boost::iostreams::filtering_ostream& o_rOutput,
+						 boost::iostreams::buffered_counter& i_rCounter,
+						 ConcurrentTee* i_pTee,
+						 const ResultCache::Capture* i_pCapture,
+						 std::ostream& o_rData )
+	{
+		o_rOutput.push( boost::ref( i_rCounter ) );
+		if( i_pTee != NULL )
+		{
+			o_rOutput.push( boost::iostreams::tee( i_pTee->GetSink() ) );
+		}
+		if( i_pCapture != NULL )
+		{
+			o_rOutput.push( boost::iostreams::tee( *i_pCapture ) );
+		}
+		o_rOutput.push( o_rData );
+	}
+
+	// empties the chain without flushing what is still buffered in it on to its destination.
+	// popping from the back first ensures nothing buffered has anywhere left to go
+	void DiscardLoadOutput( boost::iostreams::filtering_ostream& io_rOutput )
+	{
+		io_rOutput.set_auto_close( false );
+		while( !io_rOutput.empty() )
+		{
+			io_rOutput.pop();
+		}
+		io_rOutput.set_auto_close( true );
+	}
+
+	// clears a node's cache once a write to it is done, however it ended: even a failed write may have changed the data
+	class ScopedCacheClear
+	{
+	public:
+		ScopedCacheClear( ResultCache* i_pCache )
+		:	m_pCache( i_pCache )
+		{
+		}
+
+		~ScopedCacheClear()
+		{
+			if( m_pCache != NULL )
+			{
+				m_pCache->Clear();
+			}
+		}
+
+	private:
+		ResultCache* m_pCache;
+	};
+
+	// answers a load with a result that was loaded by another request
+	void WriteSharedResult( const std::string& i_rResult, std::ostream& o_rData, MonitoringTracker& o_rMonitoringTracker, const std::string& i_rMetric )
+	{
+		o_rData.write( i_rResult.data(), i_rResult.size() );
+
+		o_rMonitoringTracker.AddChild( CHILD_RESULT, CHILD_RESULT_SUCCESS );
+		o_rMonitoringTracker.Report( i_rMetric, 1 );
+		o_rMonitoringTracker.Report( METRIC_PAYLOAD_BYTES, double( i_rResult.size() ) );
+		o_rMonitoringTracker.Report( METRIC_PAYLOAD_LINES, double( std::count( i_rResult.begin(), i_rResult.end(), '\n' ) ) );
+	}
+
 	void AddNameIfNecessary( const std::string& i_rName,
 							 std::map< std::string, std::string >& i_rParameters,
 							 const Nullable< std::string >& i_rIncludeNodeNameAsParameter )
@@ -108,7 +218,13 @@ AbstractNode::AbstractNode( const std::string& i_rName, boost::shared_ptr< Reque
 	m_ReadConfig(),
 	m_WriteConfig(),
 	m_DeleteConfig(),
-	m_TeeConfig()
+	m_TeeConfig(),
+	m_ReadStagingConfig(),
+	m_WriteStagingConfig(),
+	m_pCache(),
+	m_pCoalescer(),
+	m_PendingTeesMutex(),
+	m_PendingTees()
 {
 	if( !m_pRequestForwarder )
 	{
@@ -125,6 +241,11 @@ AbstractNode::AbstractNode( const std::string& i_rName, boost::shared_ptr< Reque
 	m_DeleteConfig.SetValue< RetryCount >( 0 );
 	m_DeleteConfig.SetValue< RetryDelay >( 0.0 );
 	m_DeleteConfig.SetValue< LogCritical >( true );
+	m_ReadStagingConfig.SetValue< MemoryLimit >( std::numeric_limits< size_t >::max() );
+	m_ReadStagingConfig.SetValue< WorkingDir >( DEFAULT_WORKING_DIR );
+	m_WriteStagingConfig.SetValue< MemoryLimit >( DEFAULT_WRITE_MEMORY_LIMIT );
+	m_WriteStagingConfig.SetValue< WorkingDir >( DEFAULT_WORKING_DIR );
+	m_TeeConfig.SetValue< BufferSize >( DEFAULT_TEE_BUFFER_SIZE );
 
 	// Validate 
 	xercesc::DOMAttr* pAttribute;
@@ -135,6 +256,67 @@ AbstractNode::AbstractNode( const std::string& i_rName, boost::shared_ptr< Reque
 	{
 		SetConfig( *pNode, m_ReadConfig );
 
+		SetStagingConfig( *pNode, m_ReadStagingConfig );
+
+		// extract Cache configuration
+		xercesc::DOMNode* pCacheNode = XMLUtilities::TryGetSingletonChildByName( pNode, CACHE_NODE );
+		if( pCacheNode != NULL )
+		{
+			std::set< std::string > allowedAttributes;
+			allowedAttributes.insert( TTL_ATTRIBUTE );
+			allowedAttributes.insert( MAX_BYTES_ATTRIBUTE );
+			allowedAttributes.insert( WORKING_DIR_ATTRIBUTE );
+			allowedAttributes.insert( MAX_DISK_BYTES_ATTRIBUTE );
+			XMLUtilities::ValidateAttributes( pCacheNode, allowedAttributes );
+			XMLUtilities::ValidateNode( pCacheNode, std::set< std::string >() );
+
+			double timeToLive = boost::lexical_cast< double >( XMLUtilities::GetAttributeValue( pCacheNode, TTL_ATTRIBUTE ) );
+			size_t maxBytes = boost::lexical_cast< size_t >( XMLUtilities::GetAttributeValue( pCacheNode, MAX_BYTES_ATTRIBUTE ) );
+			if( timeToLive <= 0.0 || maxBytes == 0 )
+			{
+				MV_THROW( NodeConfigException, "Attributes \"" << TTL_ATTRIBUTE << "\" and \"" << MAX_BYTES_ATTRIBUTE << "\" must be greater than 0" );
+			}
+
+			// the disk tier is optional, but once a directory is given it must also be bounded
+			std::string cacheWorkingDir;
+			size_t maxDiskBytes( 0 );
+			pAttribute = XMLUtilities::GetAttribute( pCacheNode, WORKING_DIR_ATTRIBUTE );
+			if( pAttribute != NULL )
+			{
+				cacheWorkingDir = XMLUtilities::XMLChToString( pAttribute->getValue() );
+				maxDiskBytes = boost::lexical_cast< size_t >( XMLUtilities::GetAttributeValue( pCacheNode, MAX_DISK_BYTES_ATTRIBUTE ) );
+				FileUtilities::ValidateDirectory( cacheWorkingDir, R_OK | W_OK );
+			}
+			else if( XMLUtilities::GetAttribute( pCacheNode, MAX_DISK_BYTES_ATTRIBUTE ) != NULL )
+			{
+				MV_THROW( NodeConfigException, "Attribute \"" << MAX_DISK_BYTES_ATTRIBUTE << "\" may only be used on a " << CACHE_NODE
+					<< " that has a " << WORKING_DIR_ATTRIBUTE );
+			}
+			m_pCache.reset( new ResultCache( timeToLive, maxBytes, cacheWorkingDir, maxDiskBytes ) );
+		}
+
+		// extract Coalesce configuration
+		xercesc::DOMNode* pCoalesceNode = XMLUtilities::TryGetSingletonChildByName( pNode, COALESCE_NODE );
+		if( pCoalesceNode != NULL )
+		{
+			std::set< std::string > allowedAttributes;
+			allowedAttributes.insert( MAX_BYTES_ATTRIBUTE );
+			XMLUtilities::ValidateAttributes( pCoalesceNode, allowedAttributes );
+			XMLUtilities::ValidateNode( pCoalesceNode, std::set< std::string >() );
+
+			size_t maxBytes( DEFAULT_COALESCE_MAX_BYTES );
+			pAttribute = XMLUtilities::GetAttribute( pCoalesceNode, MAX_BYTES_ATTRIBUTE );
+			if( pAttribute != NULL )
+			{
+				maxBytes = boost::lexical_cast< size_t >( XMLUtilities::XMLChToString( pAttribute->getValue() ) );
+			}
+			if( maxBytes == 0 )
+			{
+				MV_THROW( NodeConfigException, "Attribute \"" << MAX_BYTES_ATTRIBUTE << "\" must be greater than 0" );
+			}
+			m_pCoalescer.reset( new LoadCoalescer( maxBytes ) );
+		}
+
 		// extract Tee configuration
 		pNode = XMLUtilities::TryGetSingletonChildByName( pNode, TEE_NODE );
 		if( pNode != NULL )
@@ -143,6 +325,9 @@ AbstractNode::AbstractNode( const std::string& i_rName, boost::shared_ptr< Reque
 			allowedAttributes.insert( FORWARD_TO_ATTRIBUTE );
 			allowedAttributes.insert( FORWARD_TRANSLATED_PARAMETERS_ATTRIBUTE );
 			allowedAttributes.insert( FORWARD_TRANSFORMED_STREAM_ATTRIBUTE );
+			allowedAttributes.insert( CONCURRENT_ATTRIBUTE );
+			allowedAttributes.insert( ASYNC_ATTRIBUTE );
+			allowedAttributes.insert( BUFFER_SIZE_ATTRIBUTE );
 			XMLUtilities::ValidateAttributes( pNode, allowedAttributes );
 			XMLUtilities::ValidateNode( pNode, std::set< std::string >() );
 
@@ -157,6 +342,42 @@ AbstractNode::AbstractNode( const std::string& i_rName, boost::shared_ptr< Reque
 			{
 				m_TeeConfig.SetValue< UseTransformedStream >( true );
 			}
+			pAttribute = XMLUtilities::GetAttribute( pNode, CONCURRENT_ATTRIBUTE );
+			if( pAttribute != NULL && XMLUtilities::XMLChToString(pAttribute->getValue()) == "true" )
+			{
+				m_TeeConfig.SetValue< Concurrent >( true );
+			}
+			pAttribute = XMLUtilities::GetAttribute( pNode, ASYNC_ATTRIBUTE );
+			if( pAttribute != NULL && XMLUtilities::XMLChToString(pAttribute->getValue()) == "true" )
+			{
+				m_TeeConfig.SetValue< Async >( true );
+			}
+			pAttribute = XMLUtilities::GetAttribute( pNode, BUFFER_SIZE_ATTRIBUTE );
+			if( pAttribute != NULL )
+			{
+				m_TeeConfig.SetValue< BufferSize >( boost::lexical_cast< size_t >( XMLUtilities::XMLChToString(pAttribute->getValue()) ) );
+			}
+
+			if( !m_TeeConfig.GetValue< Concurrent >() && ( m_TeeConfig.GetValue< Async >() || pAttribute != NULL ) )
+			{
+				MV_THROW( NodeConfigException, "Attributes \"" << ASYNC_ATTRIBUTE << "\" and \"" << BUFFER_SIZE_ATTRIBUTE
+					<< "\" may only be used on a " << TEE_NODE << " that is " << CONCURRENT_ATTRIBUTE );
+			}
+			if( m_TeeConfig.GetValue< BufferSize >() == 0 )
+			{
+				MV_THROW( NodeConfigException, "Attribute \"" << BUFFER_SIZE_ATTRIBUTE << "\" must be greater than 0" );
+			}
+			// the untransformed stream can only be teed as it is loaded, and a load that may be retried has to be staged first
+			if( m_TeeConfig.GetValue< Concurrent >()
+			 && !m_TeeConfig.GetValue< UseTransformedStream >()
+			 && m_ReadConfig.GetValue< Transformers >() != NULL
+			 && m_ReadConfig.GetValue< Transformers >()->HasStreamTransformers()
+			 && m_ReadConfig.GetValue< RetryCount >() > 0
+			 && !m_ReadConfig.GetValue< RetryUntilFirstByte >() )
+			{
+				MV_THROW( NodeConfigException, "A " << CONCURRENT_ATTRIBUTE << " " << TEE_NODE << " of the untransformed stream"
+					<< " cannot be used on a node that also has retries and stream transformers" );
+			}
 		}
 	}
 	
@@ -164,6 +385,11 @@ AbstractNode::AbstractNode( const std::string& i_rName, boost::shared_ptr< Reque
 	if( pNode != NULL )
 	{
 		SetConfig( *pNode, m_WriteConfig );
+		if( m_WriteConfig.GetValue< RetryUntilFirstByte >() )
+		{
+			MV_THROW( NodeConfigException, "Attribute \"" << RETRY_UNTIL_FIRST_BYTE_ATTRIBUTE << "\" may only be used in a " << READ_NODE << " node" );
+		}
+		SetStagingConfig( *pNode, m_WriteStagingConfig );
 	}
 
 	// extract common delete parameters
@@ -171,6 +397,10 @@ AbstractNode::AbstractNode( const std::string& i_rName, boost::shared_ptr< Reque
 	if( pNode != NULL )
 	{
 		SetConfig( *pNode, m_DeleteConfig );
+		if( m_DeleteConfig.GetValue< RetryUntilFirstByte >() )
+		{
+			MV_THROW( NodeConfigException, "Attribute \"" << RETRY_UNTIL_FIRST_BYTE_ATTRIBUTE << "\" may only be used in a " << READ_NODE << " node" );
+		}
 		if( m_DeleteConfig.GetValue< UseTransformedStream >() )
 		{
 			MVLOGGER( "root.lib.DataProxy.DataProxyClient.Delete.ForwardTransform", "Attribute forwardTransformedStream in Delete node"
@@ -193,10 +423,20 @@ bool AbstractNode::Load( const std::map<std::string,std::string>& i_rParameters,
 
 	MonitoringTracker tracker( LOAD_SCOPE_ID );
 	AddChildren( tracker, m_Name, i_rParameters );
+	RequestTimer timer( m_Name, LOAD_OPERATION, tracker );
 
 	// by default we will just use the params passed in
 	const std::map< std::string, std::string >* pUseParameters = &i_rParameters;
 	std::map< std::string, std::string > translatedParameters;
+	bool producedData( false );
+	boost::shared_ptr< LoadCoalescer::Leader > pLeader;
+
+	// inside a transaction, a load may see the transaction's own uncommitted writes, so it neither uses nor fills the
+	// cache, and neither joins nor is joined by identical loads in flight
+	bool insideTransaction = ( m_pCache != NULL || m_pCoalescer != NULL ) && m_pRequestForwarder->InsideTransaction();
+	ResultCache* pCache = ( insideTransaction ? NULL : m_pCache.get() );
+	LoadCoalescer* pCoalescer = ( insideTransaction ? NULL : m_pCoalescer.get() );
+	size_t cacheGeneration( 0 );
 
 	try
 	{
@@ -206,6 +446,7 @@ bool AbstractNode::Load( const std::map<std::string,std::string>& i_rParameters,
 		if( m_ReadConfig.GetValue< Translator >() != NULL )
 		{
 			// if we found a translator, translate the parameters
+			RequestTimer::Phase phase( timer, PHASE_TRANSLATE );
 			m_ReadConfig.GetValue< Translator >()->Translate( i_rParameters, translatedParameters );
 			if( translatedParameters != i_rParameters )
 			{
@@ -216,39 +457,132 @@ bool AbstractNode::Load( const std::map<std::string,std::string>& i_rParameters,
 			pUseParameters = &translatedParameters;
 		}
 
+		// cached and coalesced results are returned as-is; they were already teed when they were loaded
+		std::string requestKey;
+		if( pCache != NULL || pCoalescer != NULL )
+		{
+			requestKey = ResultCache::MakeKey( *pUseParameters );
+		}
+		if( pCache != NULL )
+		{
+			cacheGeneration = pCache->GetGeneration();
+			size_t evictions( 0 );
+			boost::shared_ptr< const std::string > pCached = pCache->Get( requestKey, evictions );
+			if( evictions > 0 )
+			{
+				tracker.Report( METRIC_CACHE_EVICTIONS, double( evictions ) );
+			}
+			if( pCached != NULL )
+			{
+				WriteSharedResult( *pCached, o_rData, tracker, METRIC_CACHE_HITS );
+				timer.SetResult( CHILD_RESULT_SUCCESS );
+				timer.SetBytes( pCached->size() );
+				return true;
+			}
+			tracker.Report( METRIC_CACHE_MISSES, 1 );
+		}
+
+		// if an identical load is already in flight, wait for its result. if it failed, fail with it (forwarding
+		// as usual); if it has no result to share, load as usual
+		if( pCoalescer != NULL )
+		{
+			boost::shared_ptr< const std::string > pShared;
+			boost::shared_ptr< const std::string > pLeaderError;
+			pLeader = pCoalescer->Join( requestKey, pShared, pLeaderError );
+			if( pLeaderError != NULL )
+			{
+				MV_THROW( MVException, "Identical load in flight failed: " << *pLeaderError );
+			}
+			if( pShared != NULL )
+			{
+				WriteSharedResult( *pShared, o_rData, tracker, METRIC_LOADS_COALESCED );
+				timer.SetResult( CHILD_RESULT_SUCCESS );
+				timer.SetBytes( pShared->size() );
+				return true;
+			}
+		}
+
+		const std::map< std::string, std::string >& rTeeParameters = ( m_TeeConfig.GetValue< UseTranslatedParameters >() ? translatedParameters : i_rParameters );
+		bool needToTee = !m_TeeConfig.GetValue< ForwardNodeName >().IsNull();
+		bool concurrentTee = needToTee && m_TeeConfig.GetValue< Concurrent >();
+		boost::shared_ptr< ConcurrentTee > pTee;
+
 		std::ostream* pUseData = &o_rData;
-		std::large_stringstream* pTempIOStream = new std::large_stringstream();
+		StagingStream* pTempIOStream = new StagingStream( m_ReadStagingConfig.GetValue< MemoryLimit >(), m_ReadStagingConfig.GetValue< WorkingDir >() );
 		boost::shared_ptr< std::istream > pTempIOStreamAsIstream( pTempIOStream );
+		size_t spilledBytes( 0 );
 		bool needToTransform = m_ReadConfig.GetValue< Transformers >() != NULL && m_ReadConfig.GetValue< Transformers >()->HasStreamTransformers();
 
-		// if we have a retry-count, we cannot write directly to the stream because the first n calls may fail (can only write the last result)
-		// if we have to tee the data out or if we have transformers configured, we also have to write to a temporary stream
-		if( m_ReadConfig.GetValue< RetryCount >() > 0 || !m_TeeConfig.GetValue< ForwardNodeName >().IsNull() || needToTransform )
+		// if we have a retry-count, we cannot write directly to the stream because the first n calls may fail (can only write the last result),
+		// unless retries are only allowed until the load produces data
+		// if we have to tee the data out (before returning it) or if we have transformers configured, we also have to write to a temporary stream
+		bool retryUntilFirstByte = m_ReadConfig.GetValue< RetryUntilFirstByte >();
+		bool stageForRetries = m_ReadConfig.GetValue< RetryCount >() > 0 && !retryUntilFirstByte;
+		if( stageForRetries || ( needToTee && !concurrentTee ) || needToTransform )
 		{
 			pUseData = pTempIOStream;
 		}
 
+		// a concurrent tee copies the stream as it is loaded if it can (the untransformed stream of a load that won't be retried
+		// once it has produced data), and otherwise as it is returned
+		bool teeWhileLoading = concurrentTee && !stageForRetries
+							&& ( !needToTransform || !m_TeeConfig.GetValue< UseTransformedStream >() );
+		if( teeWhileLoading )
+		{
+			pTee.reset( new ConcurrentTee( m_pRequestForwarder, m_TeeConfig.GetValue< ForwardNodeName >(), rTeeParameters, m_TeeConfig.GetValue< BufferSize >() ) );
+		}
+
+		// the result is captured for the cache and any coalesced loads as it is returned to the client
+		std::string resultData;
+		bool resultOverflowed( false );
+		boost::scoped_ptr< ResultCache::Capture > pCapture;
+		if( pCache != NULL || pLeader != NULL )
+		{
+			size_t captureLimit = std::max( pCache != NULL ? pCache->GetMaxEntryBytes() : 0,
+											pLeader != NULL ? m_pCoalescer->GetMaxBytes() : 0 );
+			pCapture.reset( new ResultCache::Capture( resultData, resultOverflowed, captureLimit ) );
+		}
+		const ResultCache::Capture* pLoadCapture = ( pUseData == &o_rData ? pCapture.get() : NULL );
+
 		boost::scoped_ptr< boost::iostreams::filtering_ostream > output( new boost::iostreams::filtering_ostream() );
 		boost::iostreams::buffered_counter cnt;
-		output->push( boost::ref( cnt) );
-		output->push( *pUseData );
+		PushLoadOutput( *output, cnt, pTee.get(), pLoadCapture, *pUseData );
 
 		// try the maximum # of retries to issue a load request
 		for( uint i=0; i<m_ReadConfig.GetValue< RetryCount >()+1; ++i )
 		{
 			try
 			{
+				RequestTimer::Phase phase( timer, PHASE_IMPL );
 				LoadImpl( *pUseParameters, *output );
 				output->flush();
+				if( pUseData == pTempIOStream && pTempIOStream->bad() )
+				{
+					MV_THROW( MVException, "Error staging data loaded from node: " << m_Name );
+				}
 				break;
 			}
 			catch( const std::exception& ex )
 			{
+				// once the counter has seen data, it may have been passed on to the caller (or the tee), so the
+				// load can be neither retried nor forwarded; anything written after it would corrupt the result
+				if( retryUntilFirstByte && cnt.characters() > 0 )
+				{
+					MVLOGGER( "root.lib.DataProxy.DataProxyClient.Load.NoRetry", "Caught exception while issuing load request: "
+						<< ex.what() << ". Not retrying or forwarding request since it has already produced data" );
+					producedData = true;
+					throw;
+				}
+
 				// if we have some attempts left, clear & seek the output
 				if( i < m_ReadConfig.GetValue< RetryCount >() )
 				{
-					pTempIOStream->str("");
-					pTempIOStream->clear();
+					if( retryUntilFirstByte )
+					{
+						DiscardLoadOutput( *output );
+						PushLoadOutput( *output, cnt, pTee.get(), pLoadCapture, *pUseData );
+					}
+					pTempIOStream->Reset();
 
 					std::stringstream msg;
 					msg << "Caught exception while issuing load request: " << ex.what() << ". Retrying request";
@@ -256,12 +590,18 @@ bool AbstractNode::Load( const std::map<std::string,std::string>& i_rParameters,
 					if( m_ReadConfig.GetValue< RetryDelay >() > 0.0 )
 					{
 						msg << " after " << m_ReadConfig.GetValue< RetryDelay >() << " seconds";
+						RequestTimer::Phase phase( timer, PHASE_RETRY_DELAY );
 						::usleep( ulong( m_ReadConfig.GetValue< RetryDelay >() * MICROSECONDS_PER_SECOND ) );
 					}
 					MVLOGGER( "root.lib.DataProxy.DataProxyClient.Load.Retry", msg.str() );
 				}
 				else
 				{
+					// whatever is still buffered mustn't reach the caller ahead of a forwarded result
+					if( retryUntilFirstByte )
+					{
+						DiscardLoadOutput( *output );
+					}
 					throw;
 				}
 			}
@@ -271,14 +611,16 @@ bool AbstractNode::Load( const std::map<std::string,std::string>& i_rParameters,
 
 		if ( needToTransform )
 		{
-			boost::shared_ptr< std::istream > pTransformedStream =
-				m_ReadConfig.GetValue< Transformers >()->TransformStream( *pUseParameters, pTempIOStreamAsIstream );
+			boost::shared_ptr< std::istream > pTransformedStream;
+			{
+				RequestTimer::Phase phase( timer, PHASE_TRANSFORM );
+				pTransformedStream = m_ReadConfig.GetValue< Transformers >()->TransformStream( *pUseParameters, pTempIOStreamAsIstream );
+			}
 
 			// tee the data if we need to
-			if( !m_TeeConfig.GetValue< ForwardNodeName >().IsNull() )
+			if( needToTee && !concurrentTee )
 			{
-				const std::map< std::string, std::string >& rTeeParameters = ( m_TeeConfig.GetValue< UseTranslatedParameters >() ? translatedParameters : i_rParameters );
-
+				RequestTimer::Phase phase( timer, PHASE_TEE );
 				if (m_TeeConfig.GetValue< UseTransformedStream >())
 				{
 					pTransformedStream->clear();
@@ -295,18 +637,24 @@ bool AbstractNode::Load( const std::map<std::string,std::string>& i_rParameters,
 				}
 			}
 
-			std::large_stringstream* pNewTempIOStream = new std::large_stringstream();
+			spilledBytes += pTempIOStream->GetSpilledBytes();
+			StagingStream* pNewTempIOStream = new StagingStream( m_ReadStagingConfig.GetValue< MemoryLimit >(), m_ReadStagingConfig.GetValue< WorkingDir >() );
 			pTempIOStream = pNewTempIOStream;
 			pUseData = pTempIOStream;
 			pTempIOStreamAsIstream.reset( pTempIOStream );
 
+			RequestTimer::Phase phase( timer, PHASE_TRANSFORM );
 			*pNewTempIOStream << pTransformedStream->rdbuf();
 			pNewTempIOStream->flush();
+			if( pNewTempIOStream->bad() )
+			{
+				MV_THROW( MVException, "Error staging transformed data loaded from node: " << m_Name );
+			}
 		}
 		// tee the data if we need to
-		else if( !m_TeeConfig.GetValue< ForwardNodeName >().IsNull() )
+		else if( needToTee && !concurrentTee )
 		{
-			const std::map< std::string, std::string >& rTeeParameters = ( m_TeeConfig.GetValue< UseTranslatedParameters >() ? translatedParameters : i_rParameters );
+			RequestTimer::Phase phase( timer, PHASE_TEE );
 			m_pRequestForwarder->Store( m_TeeConfig.GetValue< ForwardNodeName >(), rTeeParameters, *pTempIOStream );
 			pTempIOStream->clear();
 			pTempIOStream->seekg( 0L );
@@ -316,13 +664,40 @@ bool AbstractNode::Load( const std::map<std::string,std::string>& i_rParameters,
 		boost::scoped_ptr< boost::iostreams::filtering_ostream > tfStreamOutput( new boost::iostreams::filtering_ostream() );
 		boost::iostreams::buffered_counter cntWithTransform;
 		tfStreamOutput->push( boost::ref( cntWithTransform ) );
+		if( concurrentTee && !teeWhileLoading )
+		{
+			pTee.reset( new ConcurrentTee( m_pRequestForwarder, m_TeeConfig.GetValue< ForwardNodeName >(), rTeeParameters, m_TeeConfig.GetValue< BufferSize >() ) );
+			tfStreamOutput->push( boost::iostreams::tee( pTee->GetSink() ) );
+		}
+		if( pCapture != NULL && pLoadCapture == NULL )
+		{
+			tfStreamOutput->push( boost::iostreams::tee( *pCapture ) );
+		}
 		tfStreamOutput->push( o_rData );
 
 		if( pUseData != &o_rData )
 		{
+			RequestTimer::Phase phase( timer, PHASE_OUTPUT );
 			boost::iostreams::copy( *pUseData->rdbuf(), *tfStreamOutput );
 		}
 		tfStreamOutput.reset( NULL );
+		spilledBytes += pTempIOStream->GetSpilledBytes();
+
+		// the client has all of its data; the tee may still be catching up. inside a transaction, the tee
+		// has to complete before the transaction can, so it is always waited for
+		if( pTee != NULL )
+		{
+			if( m_TeeConfig.GetValue< Async >() && !m_pRequestForwarder->InsideTransaction() )
+			{
+				pTee->FinishAsync();
+				AddPendingTee( pTee );
+			}
+			else
+			{
+				RequestTimer::Phase phase( timer, PHASE_TEE );
+				pTee->Finish();
+			}
+		}
 		
 		if( !o_rData.good() )
 		{
@@ -332,6 +707,7 @@ bool AbstractNode::Load( const std::map<std::string,std::string>& i_rParameters,
 
 		// Monitoring report
 		tracker.AddChild( CHILD_RESULT, CHILD_RESULT_SUCCESS );
+		timer.SetResult( CHILD_RESULT_SUCCESS );
 
 		if( needToTransform )
 		{
@@ -339,11 +715,37 @@ bool AbstractNode::Load( const std::map<std::string,std::string>& i_rParameters,
 			tracker.Report( METRIC_PAYLOAD_LINES_PRE_TRANSFORM, cnt.lines() );
 			tracker.Report( METRIC_PAYLOAD_BYTES, cntWithTransform.characters() );
 			tracker.Report( METRIC_PAYLOAD_LINES, cntWithTransform.lines() );
+			timer.SetBytes( cntWithTransform.characters() );
 		}
 		else
 		{
 			tracker.Report( METRIC_PAYLOAD_BYTES, cnt.characters() );
 			tracker.Report( METRIC_PAYLOAD_LINES, cnt.lines() );
+			timer.SetBytes( cnt.characters() );
+		}
+		if( spilledBytes > 0 )
+		{
+			tracker.Report( METRIC_PAYLOAD_BYTES_SPILLED, double( spilledBytes ) );
+		}
+
+		// results too large to hold are neither cached nor shared. the cache is filled before the coalesced
+		// loads are released, so that a load arriving after them finds the result there
+		if( pCapture != NULL && !resultOverflowed )
+		{
+			boost::shared_ptr< std::string > pResult( new std::string() );
+			pResult->swap( resultData );
+			if( pCache != NULL )
+			{
+				size_t evictions = pCache->Put( requestKey, *pResult, cacheGeneration );
+				if( evictions > 0 )
+				{
+					tracker.Report( METRIC_CACHE_EVICTIONS, double( evictions ) );
+				}
+			}
+			if( pLeader != NULL && pResult->size() <= m_pCoalescer->GetMaxBytes() )
+			{
+				pLeader->SetResult( pResult );
+			}
 		}
 		return true;
 	}
@@ -355,6 +757,13 @@ bool AbstractNode::Load( const std::map<std::string,std::string>& i_rParameters,
 	}
 	catch( const std::exception& ex )
 	{
+		// the coalesced loads fail (or forward) along with this one rather than each trying the node again
+		if( pLeader != NULL )
+		{
+			pLeader->SetError( ex.what() );
+			pLeader.reset();
+		}
+
 		if( m_ReadConfig.GetValue< LogCritical >() )
 		{
 			MVLOGGER( "root.lib.DataProxy.DataProxyClient.Load.Error", "Error issuing load request to node: " << m_Name << ": " << ex.what() );
@@ -364,9 +773,9 @@ bool AbstractNode::Load( const std::map<std::string,std::string>& i_rParameters,
 			MVLOGGER( "root.lib.DataProxy.DataProxyClient.Load.Warning", "There was a non-critical error issuing load request to node: " << m_Name << ": " << ex.what() );
 		}
 
-		// if no forwardTo specified, then just rethrow the exception
+		// if no forwardTo specified, or the failed load has already written to the output, then just rethrow the exception
 		Nullable< std::string > forwardName = m_ReadConfig.GetValue< ForwardNodeName >();
-		if( forwardName.IsNull() )
+		if( forwardName.IsNull() || producedData )
 		{
 			tracker.AddChild( CHILD_RESULT, CHILD_RESULT_FAILED );
 
@@ -383,11 +792,60 @@ bool AbstractNode::Load( const std::map<std::string,std::string>& i_rParameters,
 		MVLOGGER( "root.lib.DataProxy.DataProxyClient.Load.Forward.Info", "Forwarding request to named node: "
 			<< forwardName << " with " << (m_ReadConfig.GetValue< UseTranslatedParameters >() ? "translated" : "original")
 			<< " parameters" << (m_ReadConfig.GetValue< IncludeNodeNameAsParameter >().IsNull() ? "" : " (with failed name added)") );
+		RequestTimer::Phase phase( timer, PHASE_FORWARD );
 		m_pRequestForwarder->Load( static_cast<std::string>( forwardName ), forwardedParams, o_rData );
+		timer.SetResult( RESULT_FORWARDED );
+	}
+	return false;
+}
+
+size_t AbstractNode::GetCoalescedLoadCount() const
+{
+	return ( m_pCoalescer != NULL ? m_pCoalescer->GetFollowerCount() : 0 );
+}
+
+void AbstractNode::ClearCache()
+{
+	if( m_pCache != NULL )
+	{
+		m_pCache->Clear();
 	}
+}
+
+bool AbstractNode::StoreImplRewindsInput() const
+{
 	return false;
 }
 
+bool AbstractNode::StoreRewindsInput() const
+{
+	return m_WriteConfig.GetValue< RetryCount >() > 0
+		|| !m_WriteConfig.GetValue< ForwardNodeName >().IsNull()
+		|| ( m_WriteConfig.GetValue< Translator >() != NULL && m_WriteConfig.GetValue< Translator >()->HasDelayedParameters() )
+		|| ( m_WriteConfig.GetValue< Transformers >() != NULL && m_WriteConfig.GetValue< Transformers >()->HasStreamTransformers() )
+		|| StoreImplRewindsInput();
+}
+
+void AbstractNode::AddPendingTee( boost::shared_ptr< ConcurrentTee > i_pTee )
+{
+	boost::unique_lock< boost::mutex > lock( m_PendingTeesMutex );
+
+	// forget about any that have completed since the last time through
+	std::vector< boost::shared_ptr< ConcurrentTee > >::iterator iter = m_PendingTees.begin();
+	while( iter != m_PendingTees.end() )
+	{
+		if( (*iter)->IsComplete() )
+		{
+			iter = m_PendingTees.erase( iter );
+		}
+		else
+		{
+			++iter;
+		}
+	}
+	m_PendingTees.push_back( i_pTee );
+}
+
 bool AbstractNode::Store( const std::map<std::string,std::string>& i_rParameters, std::istream& i_rData )
 {
 	if( m_WriteConfig.GetValue< Operation >() == OPERATION_IGNORE )
@@ -398,20 +856,35 @@ bool AbstractNode::Store( const std::map<std::string,std::string>& i_rParameters
 
 	MonitoringTracker tracker( STORE_SCOPE_ID );
 	AddChildren( tracker, m_Name, i_rParameters );
+	RequestTimer timer( m_Name, STORE_OPERATION, tracker );
+	ScopedCacheClear cacheClear( m_pCache.get() );
 	
 	// by default we will just use the params passed in
 	const std::map< std::string, std::string >* pUseParameters = &i_rParameters;
 	std::map< std::string, std::string > translatedParameters;
 
+	// retries, failure forwarding, translation, transformation & some nodes rewind the input, so an input that can't be
+	// rewound (e.g. a request body read as it arrives, or a concurrent tee) is spooled as it is read if any of them may
+	// need to. the store still starts as soon as the first data arrives. otherwise the input is read as it is
+	bool rewindable = SpoolingStream::IsSeekable( i_rData );
+	boost::scoped_ptr< SpoolingStream > pSpooledData;
+	if( !rewindable && StoreRewindsInput() )
+	{
+		i_rData.clear();
+		pSpooledData.reset( new SpoolingStream( i_rData, m_WriteStagingConfig.GetValue< MemoryLimit >(), m_WriteStagingConfig.GetValue< WorkingDir >() ) );
+		rewindable = true;
+	}
+	std::istream& rData = ( pSpooledData.get() != NULL ? *pSpooledData : i_rData );
+
 	// store the stream position
-	std::streampos inputPos = i_rData.tellg();
+	std::streampos inputPos = rData.tellg();
 
 	// create some constructs to track transformed stream
 	boost::shared_ptr< std::istream > pTransformedStream;
 	std::streampos transformedInputPos = 0;
 
 	// and by default we stick to the incoming data
-	std::istream* pUseData = &i_rData;
+	std::istream* pUseData = &rData;
 
 	try
 	{
@@ -421,6 +894,7 @@ bool AbstractNode::Store( const std::map<std::string,std::string>& i_rParameters
 		if( m_WriteConfig.GetValue< Translator >() != NULL )
 		{
 			// if we found a translator, translate the parameters
+			RequestTimer::Phase phase( timer, PHASE_TRANSLATE );
 			m_WriteConfig.GetValue< Translator >()->Translate( i_rParameters, translatedParameters );
 			if( translatedParameters != i_rParameters )
 			{
@@ -432,8 +906,11 @@ bool AbstractNode::Store( const std::map<std::string,std::string>& i_rParameters
 		}
 
 		// try to store the data
-		i_rData.clear();
-		i_rData.seekg( inputPos );
+		rData.clear();
+		if( rewindable )
+		{
+			rData.seekg( inputPos );
+		}
 		std::streampos retryPos = inputPos;
 
 		bool needTransform = m_WriteConfig.GetValue< Transformers >() != NULL && m_WriteConfig.GetValue< Transformers >()->HasStreamTransformers();
@@ -442,10 +919,12 @@ bool AbstractNode::Store( const std::map<std::string,std::string>& i_rParameters
 		boost::shared_ptr< std::istream > pPreTransformInputAsIstream(pPreTransformInput);
 		boost::iostreams::buffered_counter cntPreTransform;
 		pPreTransformInput->push( boost::ref( cntPreTransform ) );
-		pPreTransformInput->push( i_rData );
+		pPreTransformInput->push( rData );
 
 		if ( needTransform )
 		{
+			// the transformation itself mostly happens as the stream is read by the store, so is timed with it
+			RequestTimer::Phase phase( timer, PHASE_TRANSFORM );
 			pTransformedStream = m_WriteConfig.GetValue< Transformers >()->TransformStream( *pUseParameters, pPreTransformInputAsIstream );
 			pUseData = pTransformedStream.get();
 			transformedInputPos = pTransformedStream->tellg();
@@ -454,6 +933,7 @@ bool AbstractNode::Store( const std::map<std::string,std::string>& i_rParameters
 
 		if( m_WriteConfig.GetValue< Translator >() != NULL )
 		{
+			RequestTimer::Phase phase( timer, PHASE_TRANSLATE );
 			m_WriteConfig.GetValue< Translator >()->TranslateDelayedParameters( translatedParameters, *pUseData );
 		}
 
@@ -462,15 +942,22 @@ bool AbstractNode::Store( const std::map<std::string,std::string>& i_rParameters
 			try
 			{
 				pUseData->clear();
-				pUseData->seekg( retryPos );
+				if( rewindable )
+				{
+					pUseData->seekg( retryPos );
+				}
 
 				boost::iostreams::filtering_stream<boost::iostreams::input_seekable> input;
 				input.push( boost::iostreams::buffered_input_counter() );
 				input.push( *pUseData );
 
-				StoreImpl( *pUseParameters, input );
+				{
+					RequestTimer::Phase phase( timer, PHASE_IMPL );
+					StoreImpl( *pUseParameters, input );
+				}
 
 				tracker.AddChild( CHILD_RESULT, CHILD_RESULT_SUCCESS );
+				timer.SetResult( CHILD_RESULT_SUCCESS );
 				if( needTransform )
 				{
 					tracker.Report( METRIC_PAYLOAD_BYTES_PRE_TRANSFORM, cntPreTransform.characters() );
@@ -478,6 +965,7 @@ bool AbstractNode::Store( const std::map<std::string,std::string>& i_rParameters
 				}
 		        tracker.Report( METRIC_PAYLOAD_BYTES, input.component< 0, boost::iostreams::buffered_input_counter >()->characters() );
 		        tracker.Report( METRIC_PAYLOAD_LINES, input.component< 0, boost::iostreams::buffered_input_counter >()->lines() );
+				timer.SetBytes( input.component< 0, boost::iostreams::buffered_input_counter >()->characters() );
 
 				return true;
 			}
@@ -495,6 +983,7 @@ bool AbstractNode::Store( const std::map<std::string,std::string>& i_rParameters
 					if( m_WriteConfig.GetValue< RetryDelay >() > 0.0 )
 					{
 						msg << " after " <<  m_WriteConfig.GetValue< RetryDelay >() << " seconds";
+						RequestTimer::Phase phase( timer, PHASE_RETRY_DELAY );
 						::usleep( ulong( m_WriteConfig.GetValue< RetryDelay >() * MICROSECONDS_PER_SECOND ) );
 					}
 					MVLOGGER( "root.lib.DataProxy.DataProxyClient.Store.Retry", msg.str() );
@@ -531,7 +1020,7 @@ bool AbstractNode::Store( const std::map<std::string,std::string>& i_rParameters
 		// and since we're writing, reset the useData to the raw input if that's what we're forwarding
 		if( !m_WriteConfig.GetValue< UseTransformedStream >() )
 		{
-			pUseData = &i_rData;
+			pUseData = &rData;
 		}
 		else
 		{
@@ -550,7 +1039,9 @@ bool AbstractNode::Store( const std::map<std::string,std::string>& i_rParameters
 		pUseData->clear();
 		pUseData->seekg( inputPos );
 
+		RequestTimer::Phase phase( timer, PHASE_FORWARD );
 		m_pRequestForwarder->Store( static_cast<std::string>( forwardName ), forwardedParams, *pUseData );
+		timer.SetResult( RESULT_FORWARDED );
 	}
 	return false;
 }
@@ -565,6 +1056,8 @@ bool AbstractNode::Delete( const std::map<std::string,std::string>& i_rParameter
 
 	MonitoringTracker tracker( DELETE_SCOPE_ID );
 	AddChildren( tracker, m_Name, i_rParameters );
+	RequestTimer timer( m_Name, DELETE_OPERATION, tracker );
+	ScopedCacheClear cacheClear( m_pCache.get() );
 	
 	// by default we will just use the params passed in
 	const std::map< std::string, std::string >* pUseParameters = &i_rParameters;
@@ -578,6 +1071,7 @@ bool AbstractNode::Delete( const std::map<std::string,std::string>& i_rParameter
 		if( m_DeleteConfig.GetValue< Translator >() != NULL )
 		{
 			// if we found a translator, translate the parameters
+			RequestTimer::Phase phase( timer, PHASE_TRANSLATE );
 			m_DeleteConfig.GetValue< Translator >()->Translate( i_rParameters, translatedParameters );
 			if( translatedParameters != i_rParameters )
 			{
@@ -593,8 +1087,12 @@ bool AbstractNode::Delete( const std::map<std::string,std::string>& i_rParameter
 		{
 			try
 			{
-				DeleteImpl( *pUseParameters );
+				{
+					RequestTimer::Phase phase( timer, PHASE_IMPL );
+					DeleteImpl( *pUseParameters );
+				}
 				tracker.AddChild( CHILD_RESULT, CHILD_RESULT_SUCCESS );
+				timer.SetResult( CHILD_RESULT_SUCCESS );
 				return true;
 			}
 			catch( const std::exception& ex )
@@ -611,6 +1109,7 @@ bool AbstractNode::Delete( const std::map<std::string,std::string>& i_rParameter
 				if( m_DeleteConfig.GetValue< RetryDelay >() > 0.0 )
 				{
 					msg << " after " <<  m_DeleteConfig.GetValue< RetryDelay >() << " seconds";
+					RequestTimer::Phase phase( timer, PHASE_RETRY_DELAY );
 					::usleep( ulong( m_DeleteConfig.GetValue< RetryDelay >() * MICROSECONDS_PER_SECOND ) );
 				}
 				MVLOGGER( "root.lib.DataProxy.DataProxyClient.Delete.Retry", msg.str() );
@@ -648,7 +1147,9 @@ bool AbstractNode::Delete( const std::map<std::string,std::string>& i_rParameter
 			<< forwardName << " with " << (m_DeleteConfig.GetValue< UseTranslatedParameters >() ? "translated" : "original")
 			<< " parameters" << (m_DeleteConfig.GetValue< IncludeNodeNameAsParameter >().IsNull() ? "" : " (with failed name added)") );
 		
+		RequestTimer::Phase phase( timer, PHASE_FORWARD );
 		m_pRequestForwarder->Delete( static_cast<std::string>( forwardName ), forwardedParams );
+		timer.SetResult( RESULT_FORWARDED );
 	}
 	return false;
 }
@@ -680,12 +1181,42 @@ void AbstractNode::InsertDeleteForwards( std::set< std::string >& o_rForwards )
 	InsertImplDeleteForwards( o_rForwards );
 }
 
+void AbstractNode::SetStagingConfig( const xercesc::DOMNode& i_rNode, StagingConfigDatum& o_rConfig ) const
+{
+	xercesc::DOMNode* pStagingNode = XMLUtilities::TryGetSingletonChildByName( &i_rNode, STAGING_NODE );
+	if( pStagingNode == NULL )
+	{
+		return;
+	}
+
+	std::set< std::string > allowedAttributes;
+	allowedAttributes.insert( MEMORY_LIMIT_ATTRIBUTE );
+	allowedAttributes.insert( WORKING_DIR_ATTRIBUTE );
+	XMLUtilities::ValidateAttributes( pStagingNode, allowedAttributes );
+	XMLUtilities::ValidateNode( pStagingNode, std::set< std::string >() );
+
+	// parsed signed, so a negative limit is rejected rather than wrapping to a huge one
+	long memoryLimit = boost::lexical_cast< long >( XMLUtilities::GetAttributeValue( pStagingNode, MEMORY_LIMIT_ATTRIBUTE ) );
+	if( memoryLimit < 0 )
+	{
+		MV_THROW( NodeConfigException, "Attribute \"" << MEMORY_LIMIT_ATTRIBUTE << "\" must not be negative" );
+	}
+	o_rConfig.SetValue< MemoryLimit >( size_t( memoryLimit ) );
+	xercesc::DOMAttr* pAttribute = XMLUtilities::GetAttribute( pStagingNode, WORKING_DIR_ATTRIBUTE );
+	if( pAttribute != NULL )
+	{
+		o_rConfig.SetValue< WorkingDir >( XMLUtilities::XMLChToString( pAttribute->getValue() ) );
+	}
+	FileUtilities::ValidateDirectory( o_rConfig.GetValue< WorkingDir >(), R_OK | W_OK );
+}
+
 void AbstractNode::SetConfig( const xercesc::DOMNode& i_rNode, NodeConfigDatum& o_rConfig ) const
 {
 	o_rConfig.SetValue< Translator >( boost::shared_ptr<ParameterTranslator>( new ParameterTranslator( i_rNode ) ) );
 	o_rConfig.SetValue< Transformers >( boost::shared_ptr< TransformerManager >( new TransformerManager( i_rNode ) ) );
 	o_rConfig.SetValue< UseTranslatedParameters >( false );
 	o_rConfig.SetValue< UseTransformedStream >( false );
+	o_rConfig.SetValue< RetryUntilFirstByte >( false );
 
 	std::set< std::string > allowedAttributes;
 	std::set< std::string > allowedElements;
@@ -719,6 +1250,7 @@ void AbstractNode::SetConfig( const xercesc::DOMNode& i_rNode, NodeConfigDatum&
 	allowedAttributes.insert( FORWARD_TO_ATTRIBUTE );
 	allowedAttributes.insert( RETRY_COUNT_ATTRIBUTE );
 	allowedAttributes.insert( RETRY_DELAY_ATTRIBUTE );
+	allowedAttributes.insert( RETRY_UNTIL_FIRST_BYTE_ATTRIBUTE );
 	allowedAttributes.insert( INCLUDE_NAME_AS_PARAMETER_ATTRIBUTE );
 	allowedAttributes.insert( FORWARD_TRANSLATED_PARAMETERS_ATTRIBUTE );
 	allowedAttributes.insert( FORWARD_TRANSFORMED_STREAM_ATTRIBUTE );
@@ -742,6 +1274,18 @@ void AbstractNode::SetConfig( const xercesc::DOMNode& i_rNode, NodeConfigDatum&
 			}
 		}
 
+		// check for retry-until-first-byte; it only limits retries, so without any it would silently do nothing
+		pAttribute = XMLUtilities::GetAttribute( pNode, RETRY_UNTIL_FIRST_BYTE_ATTRIBUTE );
+		if( pAttribute != NULL && XMLUtilities::XMLChToString(pAttribute->getValue()) == "true" )
+		{
+			if( o_rConfig.GetValue< RetryCount >() == 0 )
+			{
+				MV_THROW( NodeConfigException, "Attribute \"" << RETRY_UNTIL_FIRST_BYTE_ATTRIBUTE << "\" requires a nonzero \""
+					<< RETRY_COUNT_ATTRIBUTE << "\" attribute" );
+			}
+			o_rConfig.SetValue< RetryUntilFirstByte >( true );
+		}
+
 		// check for forward-to
 		pAttribute = XMLUtilities::GetAttribute( pNode, FORWARD_TO_ATTRIBUTE );
 		if( pAttribute != NULL )
@@ -831,6 +1375,9 @@ void AbstractNode::ValidateXmlElements( const xercesc::DOMNode& i_rNode,
 		allowedChildren.insert( commonChildren.begin(), commonChildren.end() );
 		allowedChildren.insert( commonReadWriteChildren.begin(), commonReadWriteChildren.end() );
 		allowedChildren.insert( TEE_NODE );
+		allowedChildren.insert( STAGING_NODE );
+		allowedChildren.insert( CACHE_NODE );
+		allowedChildren.insert( COALESCE_NODE );
 		allowedChildren.insert( i_rAdditionalReadElements.begin(), i_rAdditionalReadElements.end() );
 		XMLUtilities::ValidateNode( pNode, allowedChildren );
 	}
@@ -842,6 +1389,7 @@ void AbstractNode::ValidateXmlElements( const xercesc::DOMNode& i_rNode,
 		allowedChildren.clear();
 		allowedChildren.insert( commonChildren.begin(), commonChildren.end() );
 		allowedChildren.insert( commonReadWriteChildren.begin(), commonReadWriteChildren.end() );
+		allowedChildren.insert( STAGING_NODE );
 		allowedChildren.insert( i_rAdditionalWriteElements.begin(), i_rAdditionalWriteElements.end() );
 		XMLUtilities::ValidateNode( pNode, allowedChildren );
 	}
@@ -209,7 +209,18 @@ ColumnFormatStreamTransformer::~ColumnFormatStreamTransformer()
 boost::shared_ptr< std::istream > ColumnFormatStreamTransformer::TransformInput( boost::shared_ptr< std::istream > i_pInputStream, const std::map< std::string, std::string >& i_rParameters )
 {
 	std::large_stringstream* pResult( new std::large_stringstream() );
+	boost::shared_ptr< std::istream > pResultAsIstream( pResult );
+	TransformInput( *i_pInputStream, *pResult, i_rParameters );
+	return pResultAsIstream;
+}
 
+bool ColumnFormatStreamTransformer::SupportsStreaming() const
+{
+	return true;
+}
+
+void ColumnFormatStreamTransformer::TransformInput( std::istream& i_rInputStream, std::ostream& o_rOutputStream, const std::map< std::string, std::string >& i_rParameters )
+{
 	// parse out fields
 	std::vector< ColumnFormatterField > fields;
 	bool foundMod = ParseFields( i_rParameters, fields );
@@ -223,7 +234,7 @@ boost::shared_ptr< std::istream > ColumnFormatStreamTransformer::TransformInput(
 
 	// read a line from the input to get the input header
 	std::string inputHeader;
-	std::getline( *i_pInputStream, inputHeader );
+	std::getline( i_rInputStream, inputHeader );
 	std::vector< std::string > headerFields;
 	boost::iter_split( headerFields, inputHeader, boost::first_finder(COMMA) );
 
@@ -232,13 +243,13 @@ boost::shared_ptr< std::istream > ColumnFormatStreamTransformer::TransformInput(
 	std::string orderCommand = GetFormatCommand( fields, headerFields );
 
 	// output the header
-	*pResult << outputHeader << std::endl;
+	o_rOutputStream << outputHeader << std::endl;
 
 	// short circuit if we're done
-	if( i_pInputStream->peek() == EOF )
+	if( i_rInputStream.peek() == EOF )
 	{
-		pResult->flush();
-		return boost::shared_ptr< std::istream >(pResult);
+		o_rOutputStream.flush();
+		return;
 	}
 
 	// just write the readbuffer from here if the output format is going to be the same (e.g. if we just did renames)
@@ -246,16 +257,16 @@ boost::shared_ptr< std::istream > ColumnFormatStreamTransformer::TransformInput(
 	{
 		MVLOGGER( "root.lib.DataProxy.DataProxyClient.StreamTransformers.ColumnFormat.FormatColumns.NoTransform",
 			"No transformation of data is necessary, as the input columns match the output columns" );
-		*pResult << i_pInputStream->rdbuf();
-		pResult->flush();
-		return boost::shared_ptr< std::istream >(pResult);
+		o_rOutputStream << i_rInputStream.rdbuf();
+		o_rOutputStream.flush();
+		return;
 	}
 
 	// execute!
 	std::large_stringstream standardError;
 	ShellExecutor executor( orderCommand );
 	MVLOGGER( "root.lib.DataProxy.DataProxyClient.StreamTransformers.ColumnFormat.FormatColumns.ExecutingCommand", "Executing command: '" << orderCommand << "'" );
-	int status = executor.Run( timeout, *i_pInputStream, *pResult, standardError );
+	int status = executor.Run( timeout, i_rInputStream, o_rOutputStream, standardError );
 	standardError.flush();
 	if( status != 0 )
 	{
@@ -266,6 +277,5 @@ boost::shared_ptr< std::istream > ColumnFormatStreamTransformer::TransformInput(
 		MVLOGGER( "root.lib.DataProxy.DataProxyClient.StreamTransformers.ColumnFormat.FormatColumns.StandardError",
 			"Column Formatter generated standard error output: " << standardError.rdbuf() );
 	}
-	pResult->flush();
-	return boost::shared_ptr< std::istream >(pResult);
+	o_rOutputStream.flush();
 }
@@ -0,0 +1,179 @@
+#include "ConcurrentTee.hpp"
+#include "RequestForwarder.hpp"
+#include "MVLogger.hpp"
+#include <boost/bind.hpp>
+#include <boost/iostreams/stream.hpp>
+
+namespace
+{
+	void LogError( const std::string& i_rNodeName, const std::exception_ptr& i_rError )
+	{
+		try
+		{
+			std::rethrow_exception( i_rError );
+		}
+		catch( const std::exception& e )
+		{
+			MVLOGGER( "root.lib.DataProxy.ConcurrentTee.Store.Error", "Error issuing tee store request to node: " << i_rNodeName << ": " << e.what() );
+		}
+		catch( ... )
+		{
+			MVLOGGER( "root.lib.DataProxy.ConcurrentTee.Store.Error", "Unknown error issuing tee store request to node: " << i_rNodeName );
+		}
+	}
+}
+
+ConcurrentTee::Sink::Sink( StreamPipe& i_rPipe )
+:	m_pPipe( &i_rPipe )
+{
+}
+
+std::streamsize ConcurrentTee::Sink::write( const char* i_pData, std::streamsize i_Size )
+{
+	try
+	{
+		m_pPipe->Write( i_pData, i_Size );
+	}
+	catch( const StreamPipeException& )
+	{
+		// the store has stopped reading (and will report why); the primary stream carries on regardless
+	}
+	return i_Size;
+}
+
+ConcurrentTee::State::State( boost::shared_ptr< RequestForwarder > i_pRequestForwarder,
+							 const std::string& i_rNodeName,
+							 const std::map< std::string, std::string >& i_rParameters,
+							 size_t i_BufferSize )
+:	m_Mutex(),
+	m_Pipe( i_BufferSize ),
+	m_pRequestForwarder( i_pRequestForwarder ),
+	m_NodeName( i_rNodeName ),
+	m_Parameters( i_rParameters ),
+	m_TraceContext( RequestTrace::GetCurrent() ),
+	m_pConfiguration( i_pRequestForwarder->PinConfiguration() ),
+	m_Error(),
+	m_Aborted( false ),
+	m_Detached( false ),
+	m_Complete( false )
+{
+}
+
+ConcurrentTee::ConcurrentTee( boost::shared_ptr< RequestForwarder > i_pRequestForwarder,
+							  const std::string& i_rNodeName,
+							  const std::map< std::string, std::string >& i_rParameters,
+							  size_t i_BufferSize )
+:	m_pState( new State( i_pRequestForwarder, i_rNodeName, i_rParameters, i_BufferSize ) ),
+	m_Thread( boost::bind( &ConcurrentTee::Run, m_pState ) ),
+	m_Finished( false )
+{
+}
+
+ConcurrentTee::~ConcurrentTee()
+{
+	if( !m_Finished )
+	{
+		Abort();
+	}
+
+	if( m_Thread.get_id() == boost::this_thread::get_id() )
+	{
+		// the store itself is tearing us down (e.g. by releasing the last reference to a configuration containing us);
+		// the thread's state is shared with it, so it can finish without us
+		m_Thread.detach();
+	}
+	else if( m_Thread.joinable() )
+	{
+		m_Thread.join();
+	}
+}
+
+ConcurrentTee::Sink ConcurrentTee::GetSink()
+{
+	return Sink( m_pState->m_Pipe );
+}
+
+void ConcurrentTee::Finish()
+{
+	m_Finished = true;
+	m_pState->m_Pipe.CloseWrite();
+	m_Thread.join();
+
+	if( m_pState->m_Error != NULL )
+	{
+		std::rethrow_exception( m_pState->m_Error );
+	}
+}
+
+void ConcurrentTee::FinishAsync()
+{
+	m_Finished = true;
+	{
+		boost::unique_lock< boost::mutex > lock( m_pState->m_Mutex );
+		m_pState->m_Detached = true;
+		if( m_pState->m_Complete && m_pState->m_Error != NULL )
+		{
+			LogError( m_pState->m_NodeName, m_pState->m_Error );
+		}
+	}
+	m_pState->m_Pipe.CloseWrite();
+}
+
+void ConcurrentTee::Abort()
+{
+	m_Finished = true;
+	{
+		boost::unique_lock< boost::mutex > lock( m_pState->m_Mutex );
+		m_pState->m_Aborted = true;
+	}
+	m_pState->m_Pipe.AbortWrite();
+	if( m_Thread.joinable() && m_Thread.get_id() != boost::this_thread::get_id() )
+	{
+		m_Thread.join();
+	}
+}
+
+bool ConcurrentTee::IsComplete() const
+{
+	boost::unique_lock< boost::mutex > lock( m_pState->m_Mutex );
+	return m_pState->m_Complete;
+}
+
+void ConcurrentTee::Run( boost::shared_ptr< State > i_pState )
+{
+	std::exception_ptr error;
+	try
+	{
+		// the trace is held for as long as the Store runs, rather than for as long as the state is
+		RequestTrace::Scope traceScope( i_pState->m_TraceContext );
+		i_pState->m_TraceContext = RequestTrace::Context();
+		// as is the configuration (the Store takes it over): the state is held by a node of that configuration, so
+		// it mustn't hold it in turn
+		RequestForwarder::PinnedConfiguration pConfiguration;
+		pConfiguration.swap( i_pState->m_pConfiguration );
+
+		StreamPipeSource source( i_pState->m_Pipe );
+		boost::iostreams::stream< StreamPipeSource > input( source );
+		// an aborted stream has to surface as an error, not as a (shorter) complete stream
+		input.exceptions( std::ios_base::badbit );
+		i_pState->m_pRequestForwarder->Store( pConfiguration, i_pState->m_NodeName, i_pState->m_Parameters, input );
+	}
+	catch( ... )
+	{
+		error = std::current_exception();
+	}
+	i_pState->m_Pipe.CloseRead();
+
+	boost::unique_lock< boost::mutex > lock( i_pState->m_Mutex );
+	if( error == NULL && i_pState->m_Aborted )
+	{
+		MVLOGGER( "root.lib.DataProxy.ConcurrentTee.Store.Aborted", "Tee store request to node: " << i_pState->m_NodeName
+			<< " completed even though the stream being teed failed; it may have stored a partial stream" );
+	}
+	i_pState->m_Error = error;
+	i_pState->m_Complete = true;
+	if( error != NULL && i_pState->m_Detached )
+	{
+		LogError( i_pState->m_NodeName, error );
+	}
+}
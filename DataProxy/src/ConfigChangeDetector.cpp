@@ -0,0 +1,267 @@
+#include "ConfigChangeDetector.hpp"
+#include "MVLogger.hpp"
+#include <sys/stat.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <algorithm>
+
+namespace
+{
+	const uint32_t FILE_WATCH_MASK( IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVE_SELF | IN_DELETE_SELF );
+	const uint32_t DIRECTORY_WATCH_MASK( IN_CREATE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM );
+	const size_t NOTIFY_BUFFER_SIZE( 4096 );
+
+	void GetDirectoryAndName( const std::string& i_rFileSpec, std::string& o_rDirectory, std::string& o_rName )
+	{
+		size_t pos = i_rFileSpec.find_last_of( '/' );
+		if( pos == std::string::npos )
+		{
+			o_rDirectory = ".";
+			o_rName = i_rFileSpec;
+			return;
+		}
+		o_rDirectory = ( pos == 0 ? "/" : i_rFileSpec.substr( 0, pos ) );
+		o_rName = i_rFileSpec.substr( pos + 1 );
+	}
+}
+
+bool ConfigChangeDetector::Fingerprint::operator==( const Fingerprint& i_rRhs ) const
+{
+	return m_Device == i_rRhs.m_Device
+		&& m_Inode == i_rRhs.m_Inode
+		&& m_Size == i_rRhs.m_Size
+		&& m_ModifiedSeconds == i_rRhs.m_ModifiedSeconds
+		&& m_ModifiedNanoseconds == i_rRhs.m_ModifiedNanoseconds
+		&& m_ChangedSeconds == i_rRhs.m_ChangedSeconds
+		&& m_ChangedNanoseconds == i_rRhs.m_ChangedNanoseconds;
+}
+
+ConfigChangeDetector::ConfigChangeDetector()
+:	m_Mutex(),
+	m_ConfigFileSpec(),
+	m_Fingerprints(),
+	m_Verified( false ),
+	m_MinimumRecheckSeconds( 0 ),
+	m_UseFileNotification( false ),
+	m_NotifyDescriptor( -1 ),
+	m_DirectoryWatches(),
+	m_RecheckTimer()
+{
+}
+
+ConfigChangeDetector::~ConfigChangeDetector()
+{
+	CloseNotifications();
+}
+
+void ConfigChangeDetector::SetOptions( double i_MinimumRecheckSeconds, bool i_UseFileNotification )
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	m_MinimumRecheckSeconds = i_MinimumRecheckSeconds;
+	m_UseFileNotification = i_UseFileNotification;
+	ResetImpl();
+}
+
+bool ConfigChangeDetector::HasChanged( const std::string& i_rConfigFileSpec )
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	if( !m_Verified || i_rConfigFileSpec != m_ConfigFileSpec )
+	{
+		ResetImpl();
+		m_ConfigFileSpec = i_rConfigFileSpec;
+		return true;
+	}
+
+	if( m_MinimumRecheckSeconds > 0 && m_RecheckTimer.GetElapsedMilliseconds() < m_MinimumRecheckSeconds * 1000 )
+	{
+		return false;
+	}
+
+	bool changed = ( m_NotifyDescriptor >= 0 ) ? DrainNotifications() : !FingerprintsMatch();
+	if( changed )
+	{
+		MVLOGGER( "root.lib.DataProxy.ConfigChangeDetector.HasChanged.Changed",
+			"Detected a possible change to config file: " << i_rConfigFileSpec << " or one of its entities" );
+		ResetImpl();
+		return true;
+	}
+
+	m_RecheckTimer.Reset();
+	return false;
+}
+
+void ConfigChangeDetector::Acknowledge( const std::string& i_rConfigFileSpec, const std::vector< std::string >& i_rEntityFiles, time_t i_ReadTime )
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+
+	// another thread has already acknowledged, or has moved on to a different file
+	if( m_Verified || i_rConfigFileSpec != m_ConfigFileSpec )
+	{
+		return;
+	}
+
+	std::vector< std::string > files( 1, i_rConfigFileSpec );
+	files.insert( files.end(), i_rEntityFiles.begin(), i_rEntityFiles.end() );
+
+	FingerprintMap fingerprints;
+	std::vector< std::string >::const_iterator iter = files.begin();
+	for( ; iter != files.end(); ++iter )
+	{
+		Fingerprint fingerprint;
+		if( !GetFingerprint( *iter, fingerprint ) )
+		{
+			MVLOGGER( "root.lib.DataProxy.ConfigChangeDetector.Acknowledge.StatFailed",
+				"Unable to stat file: " << *iter << ": " << strerror( errno ) << ". Config will be fully re-checked on next initialization" );
+			return;
+		}
+
+		// a file changed within the timestamp granularity of when it was read may have been
+		// rewritten after we read it, without any visible difference in its fingerprint
+		if( fingerprint.m_ChangedSeconds >= i_ReadTime - 1 )
+		{
+			MVLOGGER( "root.lib.DataProxy.ConfigChangeDetector.Acknowledge.RecentlyChanged",
+				"File: " << *iter << " was changed too recently to be fingerprinted. Config will be fully re-checked on next initialization" );
+			return;
+		}
+		fingerprints[ *iter ] = fingerprint;
+	}
+
+	m_Fingerprints.swap( fingerprints );
+	if( m_UseFileNotification )
+	{
+		if( !WatchFiles() )
+		{
+			MVLOGGER( "root.lib.DataProxy.ConfigChangeDetector.Acknowledge.WatchFailed",
+				"Unable to establish file notification watches: " << strerror( errno ) << ". Falling back to checking file status" );
+			CloseNotifications();
+		}
+		// anything that changed before the watches were in place would otherwise go unnoticed
+		if( !FingerprintsMatch() )
+		{
+			ResetImpl();
+			return;
+		}
+	}
+	m_Verified = true;
+	m_RecheckTimer.Reset();
+}
+
+void ConfigChangeDetector::Reset()
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	ResetImpl();
+}
+
+void ConfigChangeDetector::ResetImpl()
+{
+	m_Verified = false;
+	m_Fingerprints.clear();
+	CloseNotifications();
+}
+
+bool ConfigChangeDetector::GetFingerprint( const std::string& i_rFileSpec, Fingerprint& o_rFingerprint )
+{
+	struct stat status;
+	if( ::stat( i_rFileSpec.c_str(), &status ) != 0 )
+	{
+		return false;
+	}
+
+	o_rFingerprint.m_Device = status.st_dev;
+	o_rFingerprint.m_Inode = status.st_ino;
+	o_rFingerprint.m_Size = status.st_size;
+	o_rFingerprint.m_ModifiedSeconds = status.st_mtim.tv_sec;
+	o_rFingerprint.m_ModifiedNanoseconds = status.st_mtim.tv_nsec;
+	o_rFingerprint.m_ChangedSeconds = status.st_ctim.tv_sec;
+	o_rFingerprint.m_ChangedNanoseconds = status.st_ctim.tv_nsec;
+	return true;
+}
+
+bool ConfigChangeDetector::FingerprintsMatch() const
+{
+	FingerprintMap::const_iterator iter = m_Fingerprints.begin();
+	for( ; iter != m_Fingerprints.end(); ++iter )
+	{
+		Fingerprint current;
+		if( !GetFingerprint( iter->first, current ) || !( current == iter->second ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ConfigChangeDetector::WatchFiles()
+{
+	CloseNotifications();
+	m_NotifyDescriptor = ::inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+	if( m_NotifyDescriptor < 0 )
+	{
+		return false;
+	}
+
+	FingerprintMap::const_iterator iter = m_Fingerprints.begin();
+	for( ; iter != m_Fingerprints.end(); ++iter )
+	{
+		// watching the file itself catches in-place writes; watching its directory catches the file
+		// being replaced (e.g. by an editor or deployment tool renaming a new file over it)
+		if( ::inotify_add_watch( m_NotifyDescriptor, iter->first.c_str(), FILE_WATCH_MASK ) < 0 )
+		{
+			return false;
+		}
+		std::string directory;
+		std::string name;
+		GetDirectoryAndName( iter->first, directory, name );
+		int watch = ::inotify_add_watch( m_NotifyDescriptor, directory.c_str(), DIRECTORY_WATCH_MASK );
+		if( watch < 0 )
+		{
+			return false;
+		}
+		m_DirectoryWatches[ watch ].push_back( name );
+	}
+	return true;
+}
+
+bool ConfigChangeDetector::DrainNotifications()
+{
+	bool changed( false );
+	char buffer[ NOTIFY_BUFFER_SIZE ] __attribute__(( aligned( __alignof__( struct inotify_event ) ) ));
+	while( true )
+	{
+		ssize_t bytesRead = ::read( m_NotifyDescriptor, buffer, sizeof( buffer ) );
+		if( bytesRead < 0 )
+		{
+			// EAGAIN means there is nothing (more) to read; anything else, we can no longer trust the watches
+			return errno == EAGAIN ? changed : true;
+		}
+
+		for( char* pData = buffer; pData < buffer + bytesRead; )
+		{
+			const struct inotify_event* pEvent = reinterpret_cast< const struct inotify_event* >( pData );
+			pData += sizeof( struct inotify_event ) + pEvent->len;
+
+			WatchMap::const_iterator findIter = m_DirectoryWatches.find( pEvent->wd );
+			if( findIter == m_DirectoryWatches.end() || pEvent->len == 0 )
+			{
+				// an event on one of the files themselves (or an overflow)
+				changed = true;
+			}
+			else if( std::find( findIter->second.begin(), findIter->second.end(), std::string( pEvent->name ) ) != findIter->second.end() )
+			{
+				changed = true;
+			}
+		}
+	}
+}
+
+void ConfigChangeDetector::CloseNotifications()
+{
+	if( m_NotifyDescriptor >= 0 )
+	{
+		::close( m_NotifyDescriptor );
+		m_NotifyDescriptor = -1;
+	}
+	m_DirectoryWatches.clear();
+}
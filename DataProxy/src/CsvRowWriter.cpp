@@ -0,0 +1,134 @@
+#include "CsvRowWriter.hpp"
+#include <string.h>
+
+CsvRowWriter::CsvRowWriter( std::ostream& o_rOutput,
+							const std::string& i_rFieldSeparator,
+							const std::string& i_rRecordSeparator,
+							size_t i_BlockSize )
+:	m_rOutput( o_rOutput ),
+	m_FieldSeparator( i_rFieldSeparator ),
+	m_RecordSeparator( i_rRecordSeparator ),
+	m_NullValue(),
+	m_Quoting( false ),
+	m_Quote( '"' ),
+	m_Block( i_BlockSize > 0 ? i_BlockSize : 1 ),
+	m_BlockUsed( 0 )
+{
+}
+
+CsvRowWriter::~CsvRowWriter()
+{
+}
+
+void CsvRowWriter::SetNullValue( const std::string& i_rNullValue )
+{
+	m_NullValue = i_rNullValue;
+}
+
+void CsvRowWriter::SetQuote( char i_Quote )
+{
+	m_Quoting = true;
+	m_Quote = i_Quote;
+}
+
+void CsvRowWriter::WriteRow( const std::vector< Nullable< std::string > >& i_rColumns )
+{
+	std::vector< Nullable< std::string > >::const_iterator iter = i_rColumns.begin();
+	for( ; iter != i_rColumns.end(); ++iter )
+	{
+		if( iter != i_rColumns.begin() )
+		{
+			Append( m_FieldSeparator );
+		}
+		if( iter->IsNull() )
+		{
+			Append( m_NullValue );
+		}
+		else
+		{
+			AppendField( static_cast< const std::string& >( *iter ) );
+		}
+	}
+	Append( m_RecordSeparator );
+}
+
+void CsvRowWriter::Flush()
+{
+	WriteBlock();
+	m_rOutput.flush();
+}
+
+void CsvRowWriter::Append( const char* i_pData, size_t i_Size )
+{
+	if( m_BlockUsed + i_Size > m_Block.size() )
+	{
+		WriteBlock();
+		// too big to be worth copying; write it straight through
+		if( i_Size >= m_Block.size() )
+		{
+			m_rOutput.write( i_pData, i_Size );
+			return;
+		}
+	}
+	::memcpy( &m_Block[ m_BlockUsed ], i_pData, i_Size );
+	m_BlockUsed += i_Size;
+}
+
+void CsvRowWriter::Append( const std::string& i_rData )
+{
+	Append( i_rData.data(), i_rData.size() );
+}
+
+void CsvRowWriter::AppendField( const std::string& i_rField )
+{
+	if( !m_Quoting || !NeedsQuotes( i_rField ) )
+	{
+		Append( i_rField );
+		return;
+	}
+
+	Append( &m_Quote, 1 );
+	size_t start = 0;
+	size_t quote;
+	while( ( quote = i_rField.find( m_Quote, start ) ) != std::string::npos )
+	{
+		// the quote itself is appended twice: once with the text before it & once more on its own
+		Append( i_rField.data() + start, quote + 1 - start );
+		Append( &m_Quote, 1 );
+		start = quote + 1;
+	}
+	Append( i_rField.data() + start, i_rField.size() - start );
+	Append( &m_Quote, 1 );
+}
+
+bool CsvRowWriter::NeedsQuotes( const std::string& i_rField ) const
+{
+	// a value matching the null value is quoted so it can be told apart from a null
+	if( i_rField == m_NullValue )
+	{
+		return true;
+	}
+
+	// one pass, only comparing whole separators where their first character is found
+	const char* pField = i_rField.data();
+	size_t size = i_rField.size();
+	for( size_t i = 0; i < size; ++i )
+	{
+		if( pField[i] == m_Quote
+		 || ( !m_FieldSeparator.empty() && pField[i] == m_FieldSeparator[0] && i_rField.compare( i, m_FieldSeparator.size(), m_FieldSeparator ) == 0 )
+		 || ( !m_RecordSeparator.empty() && pField[i] == m_RecordSeparator[0] && i_rField.compare( i, m_RecordSeparator.size(), m_RecordSeparator ) == 0 ) )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void CsvRowWriter::WriteBlock()
+{
+	if( m_BlockUsed > 0 )
+	{
+		m_rOutput.write( &m_Block[0], m_BlockUsed );
+		m_BlockUsed = 0;
+	}
+}
@@ -20,6 +20,7 @@ namespace
 }
 
 CustomEntityResolver::CustomEntityResolver()
+:	m_ResolvedEntities()
 {
 }
 
@@ -48,5 +49,11 @@ xercesc::InputSource* CustomEntityResolver::resolveEntity( const XMLCh* const i_
 		MV_THROW( EntityResolverException, "Unable to find SYSTEM entity: " << systemId );
 	}
 	MVLOGGER( "root.lib.DataProxy.CustomEntityResolver.ResolveEntity.LocalFileInput", msg.str() );
+	m_ResolvedEntities.push_back( systemId );
 	return new LocalFileInputSource( i_SystemId );
 }
+
+const std::vector< std::string >& CustomEntityResolver::GetResolvedEntities() const
+{
+	return m_ResolvedEntities;
+}
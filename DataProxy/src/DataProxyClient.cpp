@@ -22,7 +22,9 @@
 #include "MVUtility.hpp"
 #include "XercesString.hpp"
 #include "LargeStringStream.hpp"
-#include <boost/scoped_ptr.hpp>
+#include "WorkerPool.hpp"
+#include <boost/bind.hpp>
+#include <algorithm>
 #include <string>
 #include <xercesc/dom/DOM.hpp>
 #include <xercesc/util/PlatformUtils.hpp>
@@ -44,6 +46,39 @@ namespace
 	const int WRITE_PATH = 2;
 	const int DELETE_PATH = 3;
 
+	const size_t DEFAULT_ASYNC_WORKER_THREADS( 8 );
+
+	void RunAsync( const boost::function< void() >& i_rRequest, boost::shared_ptr< boost::promise< void > > o_pResult )
+	{
+		try
+		{
+			i_rRequest();
+			o_pResult->set_value();
+		}
+		// boost::current_exception() only preserves exceptions thrown with boost::enable_current_exception, so the
+		// library's own exceptions are copied explicitly to keep their types
+		catch( const PartialCommitException& e )
+		{
+			o_pResult->set_exception( boost::copy_exception( e ) );
+		}
+		catch( const BadStreamException& e )
+		{
+			o_pResult->set_exception( boost::copy_exception( e ) );
+		}
+		catch( const DataProxyClientException& e )
+		{
+			o_pResult->set_exception( boost::copy_exception( e ) );
+		}
+		catch( const MVException& e )
+		{
+			o_pResult->set_exception( boost::copy_exception( e ) );
+		}
+		catch( ... )
+		{
+			o_pResult->set_exception( boost::current_exception() );
+		}
+	}
+
 	void AddIfAbsent( const std::string& i_rName, std::vector< std::string >& o_rNodes )
 	{
 		if( find( o_rNodes.begin(), o_rNodes.end(), i_rName ) == o_rNodes.end() )
@@ -116,7 +151,7 @@ namespace
 		XMLString::release( &m_pData );
 	}
 
-	std::string GetMD5( const std::string& i_rConfigFileSpec )
+	std::string GetMD5( const std::string& i_rConfigFileSpec, std::vector< std::string >& o_rEntityFiles )
 	{
 		try
 		{
@@ -130,6 +165,7 @@ namespace
 			parser.setEntityResolver( &entityResolver );
 			parser.setCreateEntityReferenceNodes( false );
 			parser.parse( i_rConfigFileSpec.c_str() );
+			o_rEntityFiles = entityResolver.GetResolvedEntities();
 
 			pDocument = parser.getDocument();
 			pConfig = pDocument->getDocumentElement();
@@ -159,6 +195,12 @@ namespace
 		}
 	}
 
+	// for pointers whose lifetime is managed elsewhere
+	template< typename T >
+	void NoCleanup( T* )
+	{
+	}
+
 	std::string PrintMode( int i_Mode )
 	{
 		std::stringstream result;
@@ -192,18 +234,126 @@ namespace
 	}
 }
 
+// a thread issuing a request uses the same configuration for that request and for every request it
+// forwards, even if a new configuration is published in the meantime. the outermost scope on a thread
+// takes a reference to the published configuration; nested scopes reuse it. outermost scopes are also
+// counted, so the client can wait for requests still running on other threads (e.g. asynchronous tees)
+class DataProxyClient::ScopedConfiguration : public boost::noncopyable
+{
+public:
+	ScopedConfiguration( const DataProxyClient& i_rClient )
+	:	m_rClient( i_rClient ),
+		m_pPinned(),
+		m_pConfiguration( i_rClient.m_pCurrentConfiguration.get() ),
+		m_Outermost( false )
+	{
+		if( m_pConfiguration == NULL )
+		{
+			boost::unique_lock< boost::mutex > lock( m_rClient.m_ConfigurationMutex );
+			m_pPinned = m_rClient.m_pConfiguration;
+			m_pConfiguration = m_pPinned.get();
+			m_rClient.m_pCurrentConfiguration.reset( m_pConfiguration );
+			m_Outermost = true;
+			++m_rClient.m_ActiveRequests;
+		}
+	}
+
+	// shares a configuration pinned by another thread, which must keep it pinned for the life of this scope
+	ScopedConfiguration( const DataProxyClient& i_rClient, const Configuration& i_rConfiguration )
+	:	m_rClient( i_rClient ),
+		m_pPinned(),
+		m_pConfiguration( &i_rConfiguration ),
+		m_Outermost( false )
+	{
+		if( m_rClient.m_pCurrentConfiguration.get() == NULL )
+		{
+			boost::unique_lock< boost::mutex > lock( m_rClient.m_ConfigurationMutex );
+			m_rClient.m_pCurrentConfiguration.reset( m_pConfiguration );
+			m_Outermost = true;
+			++m_rClient.m_ActiveRequests;
+		}
+	}
+
+	// pins a configuration handed over by another thread, taking over its reference
+	ScopedConfiguration( const DataProxyClient& i_rClient, ConfigurationPtr& io_rpConfiguration )
+	:	m_rClient( i_rClient ),
+		m_pPinned(),
+		m_pConfiguration( io_rpConfiguration.get() ),
+		m_Outermost( false )
+	{
+		m_pPinned.swap( io_rpConfiguration );
+		if( m_rClient.m_pCurrentConfiguration.get() == NULL )
+		{
+			boost::unique_lock< boost::mutex > lock( m_rClient.m_ConfigurationMutex );
+			m_rClient.m_pCurrentConfiguration.reset( m_pConfiguration );
+			m_Outermost = true;
+			++m_rClient.m_ActiveRequests;
+		}
+	}
+
+	~ScopedConfiguration()
+	{
+		if( m_Outermost )
+		{
+			m_rClient.m_pCurrentConfiguration.release();
+			// this may be the last reference to an old configuration, in which case it is torn down here
+			m_pPinned.reset();
+
+			boost::unique_lock< boost::mutex > lock( m_rClient.m_ConfigurationMutex );
+			--m_rClient.m_ActiveRequests;
+			m_rClient.m_RequestsDone.notify_all();
+		}
+	}
+
+	const Configuration* operator->() const
+	{
+		return m_pConfiguration;
+	}
+
+	const Configuration& operator*() const
+	{
+		return *m_pConfiguration;
+	}
+
+	operator bool() const
+	{
+		return m_pConfiguration != NULL;
+	}
+
+private:
+	const DataProxyClient& m_rClient;
+	ConfigurationPtr m_pPinned;
+	const Configuration* m_pConfiguration;
+	bool m_Outermost;
+};
+
+DataProxyClient::LoadRequest::LoadRequest( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::ostream& o_rData )
+:	m_Name( i_rName ),
+	m_Parameters( i_rParameters ),
+	m_pData( &o_rData ),
+	m_Succeeded( false ),
+	m_Error()
+{
+}
+
 DataProxyClient::DataProxyClient( bool i_DoNotInitializeXerces )
-:	m_Initialized( false ),
-	m_Nodes(),
-	m_DoNotInitializeXerces( i_DoNotInitializeXerces ),
+:	m_DoNotInitializeXerces( i_DoNotInitializeXerces ),
 	m_InsideTransaction( false ),
-	m_ConfigFileMD5(),
-	m_DatabaseConnectionManager( *this ),
+	m_ConfigChangeDetector(),
 	m_NodeFactory( *this ),
 	m_PendingCommitNodes(),
 	m_PendingRollbackNodes(),
 	m_AutoCommittedNodes(),
-	m_ConfigMutex()
+	m_TransactionMutex(),
+	m_pConfiguration(),
+	m_ConfigurationMutex(),
+	m_InitializeMutex(),
+	m_pCurrentConfiguration( &NoCleanup< const Configuration > ),
+	m_ActiveRequests( 0 ),
+	m_RequestsDone(),
+	m_pWorkerPool(),
+	m_WorkerPoolMutex(),
+	m_AsyncWorkerThreads( DEFAULT_ASYNC_WORKER_THREADS )
 {
 	// Initialize Xerces if necessary
 	if( !m_DoNotInitializeXerces )
@@ -214,6 +364,16 @@ DataProxyClient::DataProxyClient( bool i_DoNotInitializeXerces )
 
 DataProxyClient::~DataProxyClient()
 {
+	// requests may still be running on other threads (e.g. asynchronous requests & tees), and they refer to this client
+	m_pWorkerPool.reset();
+	{
+		boost::unique_lock< boost::mutex > lock( m_ConfigurationMutex );
+		while( m_ActiveRequests > 0 )
+		{
+			m_RequestsDone.wait( lock );
+		}
+	}
+
 	// Deinitialize Xerces if necessary
 	if( !m_DoNotInitializeXerces )
 	{
@@ -232,192 +392,267 @@ DataProxyClient::~DataProxyClient()
 void DataProxyClient::Initialize( const std::string& i_rConfigFileSpec,
 								  INodeFactory& i_rNodeFactory )
 {
-	InitializeImplementation( i_rConfigFileSpec, i_rNodeFactory, m_DatabaseConnectionManager );
+	InitializeImplementation( i_rConfigFileSpec, i_rNodeFactory, NULL );
 }
 
 void DataProxyClient::Initialize( const std::string& i_rConfigFileSpec,
 								  INodeFactory& i_rNodeFactory,
 								  DatabaseConnectionManager& i_rDatabaseConnectionManager )
 {
-	InitializeImplementation( i_rConfigFileSpec, i_rNodeFactory, i_rDatabaseConnectionManager );
+	InitializeImplementation( i_rConfigFileSpec, i_rNodeFactory, &i_rDatabaseConnectionManager );
 }
 #endif
 
 void DataProxyClient::Initialize( const std::string& i_rConfigFileSpec )
 {
-	InitializeImplementation( i_rConfigFileSpec, m_NodeFactory, m_DatabaseConnectionManager );
+	InitializeImplementation( i_rConfigFileSpec, m_NodeFactory, NULL );
+}
+
+void DataProxyClient::SetConfigCheckOptions( double i_MinimumRecheckSeconds, bool i_UseFileNotification )
+{
+	m_ConfigChangeDetector.SetOptions( i_MinimumRecheckSeconds, i_UseFileNotification );
+}
+
+std::string DataProxyClient::GetConfigMD5() const
+{
+	ConfigurationPtr pPublished = GetPublishedConfiguration();
+	return pPublished ? pPublished->m_ConfigFileMD5 : std::string();
+}
+
+DataProxyClient::ConfigurationPtr DataProxyClient::GetPublishedConfiguration() const
+{
+	boost::unique_lock< boost::mutex > lock( m_ConfigurationMutex );
+	return m_pConfiguration;
+}
+
+DataProxyClient::ConfigurationPtr DataProxyClient::GetCurrentConfiguration() const
+{
+	if( m_pCurrentConfiguration.get() == NULL )
+	{
+		return ConfigurationPtr();
+	}
+	return m_pCurrentConfiguration->shared_from_this();
 }
 
 void DataProxyClient::InitializeImplementation( const std::string& i_rConfigFileSpec,
 												INodeFactory& i_rNodeFactory,
-												DatabaseConnectionManager& i_rDatabaseConnectionManager )
+												DatabaseConnectionManager* i_pDatabaseConnectionManager )
 {
+	// cheap check first: if none of the files making up the config have been touched, there is nothing to do
+	bool changed = m_ConfigChangeDetector.HasChanged( i_rConfigFileSpec );
+	ConfigurationPtr pPublished = GetPublishedConfiguration();
+	if( pPublished && !changed )
+	{
+		return;
+	}
+
 	if( !FileUtilities::DoesExist( i_rConfigFileSpec ) )
 	{
 		MV_THROW( DataProxyClientException, "Cannot find config file: " << i_rConfigFileSpec );
 	}
 	
-	std::string md5 = GetMD5( i_rConfigFileSpec );
-	if ( md5 == m_ConfigFileMD5 )
+	time_t readTime = ::time( NULL );
+	std::vector< std::string > entityFiles;
+	std::string md5 = GetMD5( i_rConfigFileSpec, entityFiles );
+	if ( pPublished && md5 == pPublished->m_ConfigFileMD5 )
 	{
-		m_Initialized = true;
 		MVLOGGER( "root.lib.DataProxy.DataProxyClient.Initialize.MD5Unchanged.NoLock", "Config File MD5 did not change, skip re-initialization." );
+		m_ConfigChangeDetector.Acknowledge( i_rConfigFileSpec, entityFiles, readTime );
 		return;
 	}
 
-	// obtain a lock & re-check
+	// only one thread builds a new configuration at a time; re-check in case another just did
+	boost::unique_lock< boost::mutex > lock( m_InitializeMutex );
+	pPublished = GetPublishedConfiguration();
+	if ( pPublished && md5 == pPublished->m_ConfigFileMD5 )
 	{
-		boost::unique_lock< boost::shared_mutex > lock( m_ConfigMutex );
-		if ( md5 == m_ConfigFileMD5 )
-		{
-			m_Initialized = true;
-			MVLOGGER( "root.lib.DataProxy.DataProxyClient.Initialize.MD5Unchanged.PostLock", "Config File MD5 did not change, skip re-initialization." );
-			return;
-		}
+		MVLOGGER( "root.lib.DataProxy.DataProxyClient.Initialize.MD5Unchanged.PostLock", "Config File MD5 did not change, skip re-initialization." );
+		m_ConfigChangeDetector.Acknowledge( i_rConfigFileSpec, entityFiles, readTime );
+		return;
+	}
 
-		// if already initialized, we need to clear & start over (re-initialize)
-		if( m_Initialized )
+	if( pPublished )
+	{
+		MVLOGGER( "root.lib.DataProxy.DataProxyClient.Initialize.MD5Changed", "MD5 has changed since previous initialization; re-initializing" );
+	}
+	else
+	{
+		MVLOGGER( "root.lib.DataProxy.DataProxyClient.Initialize.FirstInitialization", "Initializing client for the first time" );
+	}
+
+	boost::shared_ptr< Configuration > pConfiguration( new Configuration() );
+	if( i_pDatabaseConnectionManager == NULL )
+	{
+		pConfiguration->m_pDatabaseConnectionManager.reset( new DatabaseConnectionManager( *this ) );
+	}
+	else
+	{
+		// the new connections can't be built into the manager the published configuration (and the requests
+		// running on it) still use, so each configuration needs a manager of its own
+		if( pPublished && pPublished->m_pDatabaseConnectionManager.get() == i_pDatabaseConnectionManager )
 		{
-			MVLOGGER( "root.lib.DataProxy.DataProxyClient.Initialize.MD5Changed", "MD5 has changed since previous initialization; re-initializing" );
-			m_Nodes.clear();
-			i_rDatabaseConnectionManager.ClearConnections();
-			PrivateRollback( false );
+			MV_THROW( DataProxyClientException, "Attempted to re-initialize with the DatabaseConnectionManager used by the published configuration" );
 		}
-		else
+		pConfiguration->m_pDatabaseConnectionManager.reset( i_pDatabaseConnectionManager, &NoCleanup< DatabaseConnectionManager > );
+	}
+	BuildConfiguration( i_rConfigFileSpec, i_rNodeFactory, *pConfiguration );
+	pConfiguration->m_ConfigFileMD5 = md5;
+
+	// publish; the previous configuration is destroyed when the last request using it completes
+	if( pPublished && InsideTransaction() )
+	{
+		// the open transaction is rolled back against the configuration it was made on. every request issued inside
+		// it has to have finished (and been recorded) first, and none may start on that configuration in the meantime
+		WaitForAsyncRequests();
+		boost::unique_lock< boost::mutex > publishLock( m_ConfigurationMutex );
+		size_t ownRequests = ( m_pCurrentConfiguration.get() == NULL ? 0 : 1 );
+		while( m_ActiveRequests > ownRequests )
 		{
-			MVLOGGER( "root.lib.DataProxy.DataProxyClient.Initialize.FirstInitialization", "Initializing client for the first time" );
+			m_RequestsDone.wait( publishLock );
 		}
-		m_Initialized = true;
+		m_pConfiguration = pConfiguration;
+		PrivateRollback( *pPublished );
+	}
+	else
+	{
+		boost::unique_lock< boost::mutex > publishLock( m_ConfigurationMutex );
+		m_pConfiguration = pConfiguration;
+	}
+	m_ConfigChangeDetector.Acknowledge( i_rConfigFileSpec, entityFiles, readTime );
+}
 
-		std::set< std::string > allowedChildren;
+void DataProxyClient::BuildConfiguration( const std::string& i_rConfigFileSpec,
+										  INodeFactory& i_rNodeFactory,
+										  Configuration& o_rConfiguration )
+{
+	DatabaseConnectionManager& rDatabaseConnectionManager = *o_rConfiguration.m_pDatabaseConnectionManager;
+	NodesMap& rNodes = o_rConfiguration.m_Nodes;
+	std::set< std::string > allowedChildren;
 
-		xercesc::XercesDOMParser parser;
-		xercesc::HandlerBase errorHandler;
-		CustomEntityResolver entityResolver;
-		xercesc::DOMDocument* pDocument = NULL;
-		xercesc::DOMElement* pConfig = NULL;
+	xercesc::XercesDOMParser parser;
+	xercesc::HandlerBase errorHandler;
+	CustomEntityResolver entityResolver;
+	xercesc::DOMDocument* pDocument = NULL;
+	xercesc::DOMElement* pConfig = NULL;
 
-		try
+	try
+	{
+		parser.setErrorHandler( &errorHandler );
+		parser.setEntityResolver( &entityResolver );
+		parser.setCreateEntityReferenceNodes( false );
+		parser.parse( i_rConfigFileSpec.c_str() );
+
+		pDocument = parser.getDocument();
+		pConfig = pDocument->getDocumentElement();
+		// validate config node
+		allowedChildren.insert( DATA_NODE );
+		allowedChildren.insert( JOIN_NODE );
+		allowedChildren.insert( ROUTER_NODE );
+		allowedChildren.insert( PARTITION_NODE );
+		allowedChildren.insert( DATABASE_CONNECTIONS_NODE );
+		XMLUtilities::ValidateNode( pConfig, allowedChildren );
+		XMLUtilities::ValidateAttributes( pConfig, std::set< std::string >() );
+		
+		// read the DatabaseConnections elements
+		std::vector<xercesc::DOMNode*> connectionNodes;
+		XMLUtilities::GetChildrenByName( connectionNodes, pConfig, DATABASE_CONNECTIONS_NODE );
+		std::vector<xercesc::DOMNode*>::const_iterator iter = connectionNodes.begin();
+		for( iter = connectionNodes.begin(); iter != connectionNodes.end(); ++iter )
 		{
-			parser.setErrorHandler( &errorHandler );
-			parser.setEntityResolver( &entityResolver );
-			parser.setCreateEntityReferenceNodes( false );
-			parser.parse( i_rConfigFileSpec.c_str() );
-
-			pDocument = parser.getDocument();
-			pConfig = pDocument->getDocumentElement();
-			// validate config node
-			allowedChildren.insert( DATA_NODE );
-			allowedChildren.insert( JOIN_NODE );
-			allowedChildren.insert( ROUTER_NODE );
-			allowedChildren.insert( PARTITION_NODE );
-			allowedChildren.insert( DATABASE_CONNECTIONS_NODE );
-			XMLUtilities::ValidateNode( pConfig, allowedChildren );
-			XMLUtilities::ValidateAttributes( pConfig, std::set< std::string >() );
-			
-			// read the DatabaseConnections elements
-			std::vector<xercesc::DOMNode*> connectionNodes;
-			XMLUtilities::GetChildrenByName( connectionNodes, pConfig, DATABASE_CONNECTIONS_NODE );
-			std::vector<xercesc::DOMNode*>::const_iterator iter = connectionNodes.begin();
-			for( iter = connectionNodes.begin(); iter != connectionNodes.end(); ++iter )
-			{
-				i_rDatabaseConnectionManager.Parse( **iter );
-			}
-
-			//register the newly populated connection container with the resource proxy factory
-			i_rNodeFactory.RegisterDatabaseConnections( i_rDatabaseConnectionManager );
+			rDatabaseConnectionManager.Parse( **iter );
+		}
 
-			// read all our DataNode elements
-			std::vector<xercesc::DOMNode*> dataNodes;
-			XMLUtilities::GetChildrenByName( dataNodes, pConfig, DATA_NODE );
-			iter = dataNodes.begin();
-			for( ; iter != dataNodes.end(); ++iter )
-			{
-				std::string name = ExtractName( *iter );
-				m_Nodes[ name ] = boost::shared_ptr< AbstractNode >( i_rNodeFactory.CreateNode( name, DATA_NODE, **iter ) );
-			}
+		//register the newly populated connection container with the resource proxy factory
+		i_rNodeFactory.RegisterDatabaseConnections( rDatabaseConnectionManager );
 
-			// read all our RouterNode elements
-			std::vector<xercesc::DOMNode*> routerNodes;
-			XMLUtilities::GetChildrenByName( routerNodes, pConfig, ROUTER_NODE );
-			for( iter = routerNodes.begin(); iter != routerNodes.end(); ++iter )
-			{
-				std::string name = ExtractName( *iter );
-				m_Nodes[ name ] = boost::shared_ptr< AbstractNode >( i_rNodeFactory.CreateNode( name, ROUTER_NODE, **iter ) );
-			}
-
-			// read all our PartitionNode elements
-			std::vector<xercesc::DOMNode*> partitionNodes;
-			XMLUtilities::GetChildrenByName( partitionNodes, pConfig, PARTITION_NODE );
-			for( iter = partitionNodes.begin(); iter != partitionNodes.end(); ++iter )
-			{
-				std::string name = ExtractName( *iter );
-				m_Nodes[ name ] = boost::shared_ptr< AbstractNode >( i_rNodeFactory.CreateNode( name, PARTITION_NODE, **iter ) );
-			}
-
-			// read all our JoinNode elements
-			std::vector<xercesc::DOMNode*> joinNodes;
-			XMLUtilities::GetChildrenByName( joinNodes, pConfig, JOIN_NODE );
-			for( iter = joinNodes.begin(); iter != joinNodes.end(); ++iter )
-			{
-				std::string name = ExtractName( *iter );
-				m_Nodes[ name ] = boost::shared_ptr< AbstractNode >( i_rNodeFactory.CreateNode( name, JOIN_NODE, **iter ) );
-			}
+		// read all our DataNode elements
+		std::vector<xercesc::DOMNode*> dataNodes;
+		XMLUtilities::GetChildrenByName( dataNodes, pConfig, DATA_NODE );
+		iter = dataNodes.begin();
+		for( ; iter != dataNodes.end(); ++iter )
+		{
+			std::string name = ExtractName( *iter, rNodes );
+			rNodes[ name ] = boost::shared_ptr< AbstractNode >( i_rNodeFactory.CreateNode( name, DATA_NODE, **iter ) );
 		}
-		catch( const xercesc::SAXParseException& ex )
+
+		// read all our RouterNode elements
+		std::vector<xercesc::DOMNode*> routerNodes;
+		XMLUtilities::GetChildrenByName( routerNodes, pConfig, ROUTER_NODE );
+		for( iter = routerNodes.begin(); iter != routerNodes.end(); ++iter )
 		{
-			ScopedReleasePtr< char > message( xercesc::XMLString::transcode( ex.getMessage() ) );
-			MV_THROW( DataProxyClientException, "Error parsing file: " << i_rConfigFileSpec << ": " << message );
+			std::string name = ExtractName( *iter, rNodes );
+			rNodes[ name ] = boost::shared_ptr< AbstractNode >( i_rNodeFactory.CreateNode( name, ROUTER_NODE, **iter ) );
 		}
-		catch( const xercesc::XMLException& ex )
+
+		// read all our PartitionNode elements
+		std::vector<xercesc::DOMNode*> partitionNodes;
+		XMLUtilities::GetChildrenByName( partitionNodes, pConfig, PARTITION_NODE );
+		for( iter = partitionNodes.begin(); iter != partitionNodes.end(); ++iter )
 		{
-			ScopedReleasePtr< char > message( xercesc::XMLString::transcode( ex.getMessage() ) );
-			MV_THROW( DataProxyClientException, "Error parsing file: " << i_rConfigFileSpec << ": " << message );
+			std::string name = ExtractName( *iter, rNodes );
+			rNodes[ name ] = boost::shared_ptr< AbstractNode >( i_rNodeFactory.CreateNode( name, PARTITION_NODE, **iter ) );
 		}
 
-		// ensure no cycles in dependencies
-		NodesMap::const_iterator nodeIter = m_Nodes.begin();
-		for( ; nodeIter != m_Nodes.end(); ++nodeIter )
+		// read all our JoinNode elements
+		std::vector<xercesc::DOMNode*> joinNodes;
+		XMLUtilities::GetChildrenByName( joinNodes, pConfig, JOIN_NODE );
+		for( iter = joinNodes.begin(); iter != joinNodes.end(); ++iter )
 		{
-			std::vector< std::string > pathStart;
-			pathStart.push_back( nodeIter->first );
+			std::string name = ExtractName( *iter, rNodes );
+			rNodes[ name ] = boost::shared_ptr< AbstractNode >( i_rNodeFactory.CreateNode( name, JOIN_NODE, **iter ) );
+		}
+	}
+	catch( const xercesc::SAXParseException& ex )
+	{
+		ScopedReleasePtr< char > message( xercesc::XMLString::transcode( ex.getMessage() ) );
+		MV_THROW( DataProxyClientException, "Error parsing file: " << i_rConfigFileSpec << ": " << message );
+	}
+	catch( const xercesc::XMLException& ex )
+	{
+		ScopedReleasePtr< char > message( xercesc::XMLString::transcode( ex.getMessage() ) );
+		MV_THROW( DataProxyClientException, "Error parsing file: " << i_rConfigFileSpec << ": " << message );
+	}
 
-			// check read-side
-			CheckForCycles( nodeIter, READ_PATH, pathStart );
+	// ensure no cycles in dependencies
+	NodesMap::const_iterator nodeIter = rNodes.begin();
+	for( ; nodeIter != rNodes.end(); ++nodeIter )
+	{
+		std::vector< std::string > pathStart;
+		pathStart.push_back( nodeIter->first );
 
-			// check write-side
-			CheckForCycles( nodeIter, WRITE_PATH, pathStart );
+		// check read-side
+		CheckForCycles( rNodes, nodeIter, READ_PATH, pathStart );
 
-			// check delete-side
-			CheckForCycles( nodeIter, DELETE_PATH, pathStart );
-		}
+		// check write-side
+		CheckForCycles( rNodes, nodeIter, WRITE_PATH, pathStart );
 
-		// finally, add in all the database connections
-		try
-		{
-			// read the DatabaseConnections elements
-			std::vector<xercesc::DOMNode*> connectionNodes;
-			XMLUtilities::GetChildrenByName( connectionNodes, pConfig, DATABASE_CONNECTIONS_NODE );
-			std::vector<xercesc::DOMNode*>::const_iterator iter = connectionNodes.begin();
-			for( iter = connectionNodes.begin(); iter != connectionNodes.end(); ++iter )
-			{
-				i_rDatabaseConnectionManager.ParseConnectionsByTable( **iter );
-			}
-		}
-		catch( const xercesc::SAXParseException& ex )
-		{
-			MV_THROW( DataProxyClientException, "Error parsing file: " << i_rConfigFileSpec << ": " << xercesc::XMLString::transcode( ex.getMessage() ) );
-		}
-		catch( const xercesc::XMLException& ex )
+		// check delete-side
+		CheckForCycles( rNodes, nodeIter, DELETE_PATH, pathStart );
+	}
+
+	// finally, add in all the database connections
+	try
+	{
+		// read the DatabaseConnections elements
+		std::vector<xercesc::DOMNode*> connectionNodes;
+		XMLUtilities::GetChildrenByName( connectionNodes, pConfig, DATABASE_CONNECTIONS_NODE );
+		std::vector<xercesc::DOMNode*>::const_iterator iter = connectionNodes.begin();
+		for( iter = connectionNodes.begin(); iter != connectionNodes.end(); ++iter )
 		{
-			MV_THROW( DataProxyClientException, "Error parsing file: " << i_rConfigFileSpec << ": " << xercesc::XMLString::transcode( ex.getMessage() ) );
+			rDatabaseConnectionManager.ParseConnectionsByTable( **iter );
 		}
-
-		m_ConfigFileMD5 = md5;
+	}
+	catch( const xercesc::SAXParseException& ex )
+	{
+		MV_THROW( DataProxyClientException, "Error parsing file: " << i_rConfigFileSpec << ": " << xercesc::XMLString::transcode( ex.getMessage() ) );
+	}
+	catch( const xercesc::XMLException& ex )
+	{
+		MV_THROW( DataProxyClientException, "Error parsing file: " << i_rConfigFileSpec << ": " << xercesc::XMLString::transcode( ex.getMessage() ) );
 	}
 }
 
-void DataProxyClient::CheckForCycles( const NodesMap::const_iterator& i_rNodeIter, int i_WhichPath, const std::vector< std::string >& i_rNamePath ) const
+void DataProxyClient::CheckForCycles( const NodesMap& i_rNodes, const NodesMap::const_iterator& i_rNodeIter, int i_WhichPath, const std::vector< std::string >& i_rNamePath ) const
 {
 	// get this node's current forwards
 	std::set< std::string > currentForwards;
@@ -443,8 +678,8 @@ void DataProxyClient::CheckForCycles( const NodesMap::const_iterator& i_rNodeIte
 	for( ; forwardIter != currentForwards.end(); ++forwardIter )
 	{
 		// locate the forward-to node; if it doesn't exist, throw!
-		NodesMap::const_iterator findIter = m_Nodes.find( *forwardIter );
-		if( findIter == m_Nodes.end() )
+		NodesMap::const_iterator findIter = i_rNodes.find( *forwardIter );
+		if( findIter == i_rNodes.end() )
 		{
 			MV_THROW( DataProxyClientException, "Node: " << i_rNodeIter->first << " has a " << pathType
 				<< "-side forward-to node that doesn't exist: '" << *forwardIter << "'" );
@@ -459,14 +694,14 @@ void DataProxyClient::CheckForCycles( const NodesMap::const_iterator& i_rNodeIte
 		// now take a copy of the path, add this one to the end & recurse
 		std::vector< std::string > namePathCopy( i_rNamePath );
 		namePathCopy.push_back( *forwardIter );
-		CheckForCycles( findIter, i_WhichPath, namePathCopy );
+		CheckForCycles( i_rNodes, findIter, i_WhichPath, namePathCopy );
 	}
 }
 
-std::string DataProxyClient::ExtractName( xercesc::DOMNode* i_pNode ) const
+std::string DataProxyClient::ExtractName( xercesc::DOMNode* i_pNode, const NodesMap& i_rNodes ) const
 {
 	std::string name = XMLUtilities::GetAttributeValue( i_pNode, NAME_ATTRIBUTE );
-	if( m_Nodes.find( name ) != m_Nodes.end() )
+	if( i_rNodes.find( name ) != i_rNodes.end() )
 	{
 		MV_THROW( DataProxyClientException, "Node name: '" << name << "' is configured ambiguously" );
 	}
@@ -483,13 +718,13 @@ std::string DataProxyClient::ExtractName( xercesc::DOMNode* i_pNode ) const
 
 void DataProxyClient::Ping( const std::string& i_rName, int i_Mode ) const
 {
-	boost::shared_lock< boost::shared_mutex > lock( m_ConfigMutex );
 	PingImpl( i_rName, i_Mode );
 }
 
 void DataProxyClient::PingImpl( const std::string& i_rName, int i_Mode ) const
 {
-	if( !m_Initialized )
+	ScopedConfiguration configuration( *this );
+	if( !configuration )
 	{
 		MV_THROW( DataProxyClientException, "Attempted to issue Ping request on uninitialized DataProxyClient" );
 	}
@@ -497,8 +732,8 @@ void DataProxyClient::PingImpl( const std::string& i_rName, int i_Mode ) const
 	MVLOGGER( "root.lib.DataProxy.DataProxyClient.Ping.Info", "Ping called for named DataNode: "
 		<< i_rName << " with mode: " << PrintMode( i_Mode ) );
 
-	NodesMap::const_iterator iter = m_Nodes.find( i_rName );
-	if( iter == m_Nodes.end() )
+	NodesMap::const_iterator iter = configuration->m_Nodes.find( i_rName );
+	if( iter == configuration->m_Nodes.end() )
 	{
 		MV_THROW( DataProxyClientException, "Attempted to issue Ping request on unknown data node '" << i_rName << "'. Check XML configuration." );
 	}
@@ -515,13 +750,13 @@ void DataProxyClient::PingImpl( const std::string& i_rName, int i_Mode ) const
 
 void DataProxyClient::Load( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::ostream& o_rData ) const
 {
-	boost::shared_lock< boost::shared_mutex > lock( m_ConfigMutex );
 	LoadImpl( i_rName, i_rParameters, o_rData );
 }
 
 void DataProxyClient::LoadImpl( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::ostream& o_rData ) const
 {
-	if( !m_Initialized )
+	ScopedConfiguration configuration( *this );
+	if( !configuration )
 	{
 		MV_THROW( DataProxyClientException, "Attempted to issue Load request on uninitialized DataProxyClient" );
 	}
@@ -529,8 +764,8 @@ void DataProxyClient::LoadImpl( const std::string& i_rName, const std::map<std::
 	MVLOGGER( "root.lib.DataProxy.DataProxyClient.Load.Info", "Load called for named DataNode: "
 		<< i_rName << " with parameters: " << ProxyUtilities::ToString( i_rParameters ) );
 
-	NodesMap::const_iterator iter = m_Nodes.find( i_rName );
-	if( iter == m_Nodes.end() )
+	NodesMap::const_iterator iter = configuration->m_Nodes.find( i_rName );
+	if( iter == configuration->m_Nodes.end() )
 	{
 		MV_THROW( DataProxyClientException, "Attempted to issue Load request on unknown data node '" << i_rName << "'. Check XML configuration." );
 	}
@@ -542,13 +777,13 @@ void DataProxyClient::LoadImpl( const std::string& i_rName, const std::map<std::
 
 void DataProxyClient::Store( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::istream& i_rData ) const
 {
-	boost::shared_lock< boost::shared_mutex > lock( m_ConfigMutex );
 	StoreImpl( i_rName, i_rParameters, i_rData );
 }
 
 void DataProxyClient::StoreImpl( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::istream& i_rData ) const
 {
-	if( !m_Initialized )
+	ScopedConfiguration configuration( *this );
+	if( !configuration )
 	{
 		MV_THROW( DataProxyClientException, "Attempted to issue Store request on uninitialized DataProxyClient" );
 	}
@@ -556,8 +791,8 @@ void DataProxyClient::StoreImpl( const std::string& i_rName, const std::map<std:
 	MVLOGGER( "root.lib.DataProxy.DataProxyClient.Store.Info", "Store called for named DataNode: "
 		<< i_rName << " with parameters: " << ProxyUtilities::ToString( i_rParameters ) );
 
-	NodesMap::const_iterator iter = m_Nodes.find( i_rName );
-	if( iter == m_Nodes.end() )
+	NodesMap::const_iterator iter = configuration->m_Nodes.find( i_rName );
+	if( iter == configuration->m_Nodes.end() )
 	{
 		MV_THROW( DataProxyClientException, "Attempted to issue Store request on unknown data node '" << i_rName << "'. Check XML configuration." );
 	}
@@ -567,15 +802,22 @@ void DataProxyClient::StoreImpl( const std::string& i_rName, const std::map<std:
 	HandleResult( i_rName, iter, success, STORE_OP );
 }
 
+void DataProxyClient::StoreImpl( ConfigurationPtr& io_rpConfiguration, const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::istream& i_rData ) const
+{
+	// the store (and anything it forwards) finds this configuration pinned on the thread
+	ScopedConfiguration configuration( *this, io_rpConfiguration );
+	StoreImpl( i_rName, i_rParameters, i_rData );
+}
+
 void DataProxyClient::Delete( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters ) const
 {
-	boost::shared_lock< boost::shared_mutex > lock( m_ConfigMutex );
 	DeleteImpl( i_rName, i_rParameters );
 }
 
 void DataProxyClient::DeleteImpl( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters ) const
 {
-	if( !m_Initialized )
+	ScopedConfiguration configuration( *this );
+	if( !configuration )
 	{
 		MV_THROW( DataProxyClientException, "Attempted to issue Delete request on uninitialized DataProxyClient" );
 	}
@@ -583,8 +825,8 @@ void DataProxyClient::DeleteImpl( const std::string& i_rName, const std::map<std
 	MVLOGGER( "root.lib.DataProxy.DataProxyClient.Delete.Info", "Delete called for named DataNode: "
 		<< i_rName << " with parameters: " << ProxyUtilities::ToString( i_rParameters ) );
 
-	NodesMap::const_iterator iter = m_Nodes.find( i_rName );
-	if( iter == m_Nodes.end() )
+	NodesMap::const_iterator iter = configuration->m_Nodes.find( i_rName );
+	if( iter == configuration->m_Nodes.end() )
 	{
 		MV_THROW( DataProxyClientException, "Attempted to issue Delete request on unknown data node '" << i_rName << "'. Check XML configuration." );
 	}
@@ -596,8 +838,10 @@ void DataProxyClient::DeleteImpl( const std::string& i_rName, const std::map<std
 
 void DataProxyClient::HandleResult( const std::string& i_rName, const NodesMap::const_iterator& i_rNodeIter, bool i_bSuccess, const std::string i_Operation ) const
 {
+	boost::unique_lock< boost::mutex > lock( m_TransactionMutex );
 	if( !m_InsideTransaction )
 	{
+		lock.unlock();
 		if( i_rNodeIter->second->SupportsTransactions() )
 		{
 			if( i_bSuccess )
@@ -650,25 +894,181 @@ void DataProxyClient::HandleResult( const std::string& i_rName, const NodesMap::
 	}
 }
 
+bool DataProxyClient::LoadMany( std::vector< LoadRequest >& io_rRequests, size_t i_MaxConcurrency ) const
+{
+	ScopedConfiguration configuration( *this );
+	if( !configuration )
+	{
+		MV_THROW( DataProxyClientException, "Attempted to issue LoadMany request on uninitialized DataProxyClient" );
+	}
+
+	std::vector< std::string > unknownNames;
+	std::vector< LoadRequest >::iterator iter = io_rRequests.begin();
+	for( ; iter != io_rRequests.end(); ++iter )
+	{
+		iter->m_Succeeded = false;
+		iter->m_Error.clear();
+		if( configuration->m_Nodes.find( iter->m_Name ) == configuration->m_Nodes.end() )
+		{
+			AddIfAbsent( iter->m_Name, unknownNames );
+		}
+	}
+	if( !unknownNames.empty() )
+	{
+		std::string names;
+		Join( unknownNames, names, ',' );
+		MV_THROW( DataProxyClientException, "Attempted to issue LoadMany request on unknown data node(s): " << names << ". Check XML configuration." );
+	}
+
+	MVLOGGER( "root.lib.DataProxy.DataProxyClient.LoadMany.Info", "LoadMany called for " << io_rRequests.size()
+		<< " named DataNode(s) with a maximum concurrency of " << i_MaxConcurrency );
+
+	size_t next( 0 );
+	boost::mutex nextMutex;
+	size_t numThreads = std::min( std::max( i_MaxConcurrency, size_t( 1 ) ), io_rRequests.size() );
+	boost::thread_group threads;
+	try
+	{
+		// the calling thread takes a share of the work as well
+		for( size_t i = 1; i < numThreads; ++i )
+		{
+			threads.create_thread( boost::bind( &DataProxyClient::LoadManyWorker, this, boost::cref( *configuration ),
+												boost::ref( io_rRequests ), boost::ref( next ), boost::ref( nextMutex ) ) );
+		}
+	}
+	catch( const boost::thread_resource_error& e )
+	{
+		MVLOGGER( "root.lib.DataProxy.DataProxyClient.LoadMany.Warning", "Unable to start all " << numThreads
+			<< " threads (" << e.what() << "); continuing with " << threads.size() + 1 );
+	}
+	LoadManyWorker( *configuration, io_rRequests, next, nextMutex );
+	threads.join_all();
+
+	bool result = true;
+	for( iter = io_rRequests.begin(); iter != io_rRequests.end(); ++iter )
+	{
+		result = result && iter->m_Succeeded;
+	}
+	return result;
+}
+
+void DataProxyClient::LoadManyWorker( const Configuration& i_rConfiguration, std::vector< LoadRequest >& io_rRequests, size_t& io_rNext, boost::mutex& i_rNextMutex ) const
+{
+	ScopedConfiguration configuration( *this, i_rConfiguration );
+	while( true )
+	{
+		size_t index;
+		{
+			boost::unique_lock< boost::mutex > lock( i_rNextMutex );
+			if( io_rNext >= io_rRequests.size() )
+			{
+				return;
+			}
+			index = io_rNext++;
+		}
+
+		LoadRequest& rRequest = io_rRequests[ index ];
+		try
+		{
+			LoadImpl( rRequest.m_Name, rRequest.m_Parameters, *rRequest.m_pData );
+			rRequest.m_Succeeded = true;
+		}
+		catch( const std::exception& e )
+		{
+			rRequest.m_Error = e.what();
+		}
+		catch( ... )
+		{
+			rRequest.m_Error = "Unknown exception";
+		}
+	}
+}
+
+boost::unique_future< void > DataProxyClient::LoadAsync( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::ostream& o_rData ) const
+{
+	return PostAsync( boost::bind( &DataProxyClient::Load, this, i_rName, i_rParameters, boost::ref( o_rData ) ) );
+}
+
+boost::unique_future< void > DataProxyClient::StoreAsync( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::istream& i_rData ) const
+{
+	return PostAsync( boost::bind( &DataProxyClient::Store, this, i_rName, i_rParameters, boost::ref( i_rData ) ) );
+}
+
+boost::unique_future< void > DataProxyClient::DeleteAsync( const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters ) const
+{
+	return PostAsync( boost::bind( &DataProxyClient::Delete, this, i_rName, i_rParameters ) );
+}
+
+void DataProxyClient::SetAsyncWorkerThreads( size_t i_NumThreads )
+{
+	if( i_NumThreads == 0 )
+	{
+		MV_THROW( DataProxyClientException, "The number of asynchronous worker threads must be greater than 0" );
+	}
+
+	boost::shared_ptr< WorkerPool > pOldPool;
+	{
+		boost::unique_lock< boost::mutex > lock( m_WorkerPoolMutex );
+		m_AsyncWorkerThreads = i_NumThreads;
+		pOldPool.swap( m_pWorkerPool );
+	}
+	// the old pool finishes whatever was already posted to it as it is destroyed
+}
+
+void DataProxyClient::WaitForAsyncRequests() const
+{
+	boost::shared_ptr< WorkerPool > pPool;
+	{
+		boost::unique_lock< boost::mutex > lock( m_WorkerPoolMutex );
+		pPool = m_pWorkerPool;
+	}
+	if( pPool )
+	{
+		pPool->WaitForIdle();
+	}
+}
+
+boost::unique_future< void > DataProxyClient::PostAsync( const boost::function< void() >& i_rRequest ) const
+{
+	boost::shared_ptr< boost::promise< void > > pResult( new boost::promise< void >() );
+	boost::unique_future< void > result = pResult->get_future();
+
+	boost::shared_ptr< WorkerPool > pPool;
+	{
+		boost::unique_lock< boost::mutex > lock( m_WorkerPoolMutex );
+		if( !m_pWorkerPool )
+		{
+			m_pWorkerPool.reset( new WorkerPool( m_AsyncWorkerThreads ) );
+		}
+		pPool = m_pWorkerPool;
+	}
+	pPool->Post( boost::bind( &RunAsync, i_rRequest, pResult ) );
+	return result;
+}
+
 bool DataProxyClient::InsideTransaction()
 {
+	boost::unique_lock< boost::mutex > lock( m_TransactionMutex );
 	return m_InsideTransaction;
 }
 
 void DataProxyClient::BeginTransaction( bool i_AbortCurrent )
 {
-	boost::shared_lock< boost::shared_mutex > lock( m_ConfigMutex );
-	if( !m_Initialized )
+	if( !GetPublishedConfiguration() )
 	{
 		MV_THROW( DataProxyClientException, "Attempted to issue BeginTransaction request on uninitialized DataProxyClient" );
 	}
 
-	if( i_AbortCurrent && m_InsideTransaction )
+	// requests issued before the transaction are not part of it
+	WaitForAsyncRequests();
+
+	if( i_AbortCurrent && InsideTransaction() )
 	{
 		MVLOGGER( "root.lib.DataProxy.DataProxyClient.BeginTransaction.AbortCurrent", "Aborting current transaction before beginning a new one" );
 		Rollback();
 	}
 
+	boost::unique_lock< boost::mutex > lock( m_TransactionMutex );
 	if( m_InsideTransaction )
 	{
 		MV_THROW( DataProxyClientException, "A transaction has already been started. Complete the current transaction by calling Commit() or Rollback() before starting a new one." );
@@ -680,12 +1080,15 @@ void DataProxyClient::BeginTransaction( bool i_AbortCurrent )
 
 void DataProxyClient::Commit()
 {
-	boost::shared_lock< boost::shared_mutex > lock( m_ConfigMutex );
-	if( !m_Initialized )
+	ScopedConfiguration configuration( *this );
+	if( !configuration )
 	{
 		MV_THROW( DataProxyClientException, "Attempted to issue Commit request on uninitialized DataProxyClient" );
 	}
 
+	WaitForAsyncRequests();
+
+	boost::unique_lock< boost::mutex > lock( m_TransactionMutex );
 	if( !m_InsideTransaction )
 	{
 		MVLOGGER( "root.lib.DataProxy.DataProxyClient.Commit.NotInsideTransaction", "Commit was called, but a transaction has not been started" );
@@ -697,8 +1100,8 @@ void DataProxyClient::Commit()
 	std::vector< std::string >::iterator iter = m_PendingCommitNodes.begin();
 	for( ; iter != m_PendingCommitNodes.end(); iter = m_PendingCommitNodes.erase( iter ) )
 	{
-		NodesMap::const_iterator findIter = m_Nodes.find( *iter );
-		if( findIter == m_Nodes.end() )
+		NodesMap::const_iterator findIter = configuration->m_Nodes.find( *iter );
+		if( findIter == configuration->m_Nodes.end() )
 		{
 			// this should never happen
 			MV_THROW( DataProxyClientException, "Unkown node: " << *iter << " was marked for Commit" );
@@ -715,6 +1118,8 @@ void DataProxyClient::Commit()
 				"Error committing data to node: " << *iter << ". Continuing with the remaining commits" );
 			errors << "\nNode: " << *iter << ": " << i_rException.what();
 		}
+		// loads from outside the transaction may have cached what the node held before the commit
+		findIter->second->ClearCache();
 	}
 
 	if( !errors.str().empty() )
@@ -727,8 +1132,8 @@ void DataProxyClient::Commit()
 	iter = m_PendingRollbackNodes.begin();
 	for( ; iter != m_PendingRollbackNodes.end(); iter = m_PendingRollbackNodes.erase( iter ) )
 	{
-		NodesMap::const_iterator findIter = m_Nodes.find( *iter );
-		if( findIter == m_Nodes.end() )
+		NodesMap::const_iterator findIter = configuration->m_Nodes.find( *iter );
+		if( findIter == configuration->m_Nodes.end() )
 		{
 			// this should never happen
 			MV_THROW( DataProxyClientException, "Unkown node: " << *iter << " was marked for Rollback" );
@@ -766,21 +1171,18 @@ void DataProxyClient::Commit()
 
 void DataProxyClient::Rollback()
 {
-	PrivateRollback( true );
-}
-
-void DataProxyClient::PrivateRollback( bool i_ObtainLock )
-{
-	boost::scoped_ptr< boost::shared_lock< boost::shared_mutex > > pLock;
-	if( i_ObtainLock )
-	{
-		pLock.reset( new boost::shared_lock< boost::shared_mutex >( m_ConfigMutex ) );
-	}
-	if( !m_Initialized )
+	ScopedConfiguration configuration( *this );
+	if( !configuration )
 	{
 		MV_THROW( DataProxyClientException, "Attempted to issue Rollback request on uninitialized DataProxyClient" );
 	}
+	WaitForAsyncRequests();
+	PrivateRollback( *configuration );
+}
 
+void DataProxyClient::PrivateRollback( const Configuration& i_rConfiguration )
+{
+	boost::unique_lock< boost::mutex > lock( m_TransactionMutex );
 	if( !m_InsideTransaction )
 	{
 		MVLOGGER( "root.lib.DataProxy.DataProxyClient.Rollback.NotInsideTransaction", "Rollback was called, but a transaction has not been started" );
@@ -792,8 +1194,8 @@ void DataProxyClient::PrivateRollback( bool i_ObtainLock )
 	std::vector< std::string >::iterator iter = m_PendingCommitNodes.begin();
 	for( ; iter != m_PendingCommitNodes.end(); iter = m_PendingCommitNodes.erase( iter ) )
 	{
-		NodesMap::const_iterator findIter = m_Nodes.find( *iter );
-		if( findIter == m_Nodes.end() )
+		NodesMap::const_iterator findIter = i_rConfiguration.m_Nodes.find( *iter );
+		if( findIter == i_rConfiguration.m_Nodes.end() )
 		{
 			// this should never happen
 			MV_THROW( DataProxyClientException, "Unkown node: " << *iter << " was marked for Commit" );
@@ -815,8 +1217,8 @@ void DataProxyClient::PrivateRollback( bool i_ObtainLock )
 	iter = m_PendingRollbackNodes.begin();
 	for( ; iter != m_PendingRollbackNodes.end(); iter = m_PendingRollbackNodes.erase( iter ) )
 	{
-		NodesMap::const_iterator findIter = m_Nodes.find( *iter );
-		if( findIter == m_Nodes.end() )
+		NodesMap::const_iterator findIter = i_rConfiguration.m_Nodes.find( *iter );
+		if( findIter == i_rConfiguration.m_Nodes.end() )
 		{
 			// this should never happen
 			MV_THROW( DataProxyClientException, "Unkown node: " << *iter << " was marked for Rollback" );
@@ -25,9 +25,13 @@
 #include "Stopwatch.hpp"
 #include "DataProxyClient.hpp"
 #include "UniqueIdGenerator.hpp"
+#include "NamedPipeWriter.hpp"
+#include "RequestTimer.hpp"
+#include "CsvRowWriter.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <boost/bind.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/regex.hpp>
 #include <boost/algorithm/string.hpp>
@@ -49,6 +53,8 @@ namespace
 	const std::string HEADER_ATTRIBUTE( "header" );
 	const std::string FIELD_SEPARATOR_ATTRIBUTE( "fieldSeparator" );
 	const std::string RECORD_SEPARATOR_ATTRIBUTE( "recordSeparator" );
+	const std::string NULL_VALUE_ATTRIBUTE( "nullValue" );
+	const std::string QUOTE_ATTRIBUTE( "quote" );
 	const std::string TABLE_ATTRIBUTE( "table" );
 	const std::string STAGING_TABLE_ATTRIBUTE( "stagingTable" );
 	const std::string WORKING_DIR_ATTRIBUTE( "workingDir" );
@@ -56,6 +62,8 @@ namespace
 	const std::string NO_CLEAN_UP_ATTRIBUTE( "noCleanUp" );
 	const std::string INSERT_ONLY_ATTRIBUTE( "insertOnly" );
 	const std::string LOCAL_DATA_ATTRIBUTE( "dataInfileLocal" );
+	const std::string STREAM_DATA_FILE_ATTRIBUTE( "streamDataFile" );
+	const std::string UPLOAD_PARALLELISM_ATTRIBUTE( "uploadParallelism" );
 	const std::string DYNAMIC_STAGING_TABLE_ATTRIBUTE( "dynamicStagingTable" );
 	const std::string MAX_TABLE_NAME_LENGTH_ATTRIBUTE( "maxTableNameLength" );
 	const std::string MAX_BIND_SIZE_ATTRIBUTE( "maxBindSize" );
@@ -65,9 +73,15 @@ namespace
 	const std::string IF_MATCHED_ATTRIBUTE( "ifMatched" );
 	const std::string PRE_STATEMENT_ATTRIBUTE( "pre-statement" );
 	const std::string POST_STATEMENT_ATTRIBUTE( "post-statement" );
+	const std::string BATCH_SIZE_ATTRIBUTE( "batchSize" );
 
 	// statement placeholders
 	const std::string STAGING_TABLE_PLACEHOLDER( "&staging;" );
+	const std::string BATCH_TABLE_ALIAS( "batched" );
+	const std::string CHUNKED_TABLE_ALIAS( "chunked" );
+
+	// the time a store spends waiting on table locks; reported with the request's other phases
+	const std::string PHASE_LOCK_WAIT( "lockWait" );
 
 	// values
 	const std::string FAIL( "fail" );
@@ -84,6 +98,8 @@ namespace
 
 	const int DEFAULT_MAX_BIND_SIZE ( 256 );
 	const int DEFAULT_ROWS_BUFFERED( 100000 );
+	// both mysql & oracle limit the number of bind variables in a statement
+	const size_t MAX_BATCH_BIND_VARIABLES( 65535 );
 
 	std::string GetAllSubstitutions( const std::string& i_rStatement, const std::map< std::string, std::string >& i_rParameters, const std::string& i_rStagingTable )
 	{
@@ -92,6 +108,87 @@ namespace
 		return ProxyUtilities::GetVariableSubstitutedString( result, i_rParameters );
 	}
 
+	// turns a merge query that reads from the staging table into one that reads a batch of rows from an inline table
+	// of bind variables instead (one per column per row), so the batch is stored in a single round trip
+	std::string GetBatchQuery( const std::string& i_rStagingQuery, const std::vector< std::string >& i_rColumns, size_t i_Rows )
+	{
+		std::stringstream rows;
+		rows << "( ";
+		for( size_t row = 0; row < i_Rows; ++row )
+		{
+			rows << ( row == 0 ? "SELECT " : " UNION ALL SELECT " );
+			std::vector< std::string >::const_iterator iter = i_rColumns.begin();
+			for( ; iter != i_rColumns.end(); ++iter )
+			{
+				rows << ( iter == i_rColumns.begin() ? "?" : ", ?" );
+				if( row == 0 )
+				{
+					rows << " AS " << *iter;
+				}
+			}
+			rows << " FROM dual";
+		}
+		rows << " ) " << BATCH_TABLE_ALIAS;
+
+		// columns are referred to by the table's alias; the table itself (in FROM, USING, etc.) by its definition
+		std::string result = i_rStagingQuery;
+		boost::replace_all( result, STAGING_TABLE_PLACEHOLDER + ".", BATCH_TABLE_ALIAS + "." );
+		boost::replace_all( result, STAGING_TABLE_PLACEHOLDER, rows.str() );
+		return result;
+	}
+
+	// turns a merge query that reads from the staging table into one that reads from the union of several staging tables
+	std::string GetChunkedQuery( const std::string& i_rStagingQuery, const std::vector< std::string >& i_rStagingTables )
+	{
+		std::stringstream tables;
+		tables << "( ";
+		std::vector< std::string >::const_iterator iter = i_rStagingTables.begin();
+		for( ; iter != i_rStagingTables.end(); ++iter )
+		{
+			tables << ( iter == i_rStagingTables.begin() ? "SELECT * FROM " : " UNION ALL SELECT * FROM " ) << *iter;
+		}
+		tables << " ) " << CHUNKED_TABLE_ALIAS;
+
+		std::string result = i_rStagingQuery;
+		boost::replace_all( result, STAGING_TABLE_PLACEHOLDER + ".", CHUNKED_TABLE_ALIAS + "." );
+		boost::replace_all( result, STAGING_TABLE_PLACEHOLDER, tables.str() );
+		return result;
+	}
+
+	boost::shared_ptr< Database::Statement > PrepareBatch( Database& i_rDatabase,
+														   const std::string& i_rSql,
+														   std::vector< std::string >& i_rBatchData,
+														   const std::vector< size_t >& i_rBindSizes,
+														   size_t i_Rows )
+	{
+		boost::shared_ptr< Database::Statement > pStatement( new Database::Statement( i_rDatabase, i_rSql ) );
+		for( size_t i = 0; i < i_Rows * i_rBindSizes.size(); ++i )
+		{
+			pStatement->BindVar( i_rBatchData[i], i_rBindSizes[ i % i_rBindSizes.size() ] );
+		}
+		pStatement->CompleteBinding();
+		return pStatement;
+	}
+
+	void ExecuteBatch( Database::Statement& i_rStatement, long long i_FirstRow, size_t i_Rows )
+	{
+		try
+		{
+			i_rStatement.Execute();
+		}
+		catch( const std::exception& i_rException )
+		{
+			MV_THROW( DatabaseProxyException, "Error storing rows " << i_FirstRow << " through " << i_FirstRow + i_Rows - 1 << " of the incoming data: " << i_rException.what() );
+		}
+	}
+
+	TableLocks::Lock* LockTable( TableLocks& i_rLocks, const std::string& i_rTable )
+	{
+		RequestTimer* pTimer = RequestTimer::GetCurrent();
+		boost::scoped_ptr< RequestTimer::Phase > pWait( pTimer == NULL ? NULL : new RequestTimer::Phase( *pTimer, PHASE_LOCK_WAIT ) );
+		return new TableLocks::Lock( i_rLocks, i_rTable );
+	}
+
 	void FillSet( const std::map< std::string, std::string >& i_rMap, std::set< std::string >& o_rSet )
 	{
 		std::map< std::string, std::string >::const_iterator iter = i_rMap.begin();
@@ -121,26 +218,38 @@ namespace
 		return result.str();
 	}
 
-	long long WriteDataFile( const std::string& i_rFileSpec,
-							 const std::string& i_rHeader,
-							 const std::map< std::string, std::string >& i_rParameters,
-							 std::istream& i_rData,
-							 int i_NumCols,
-							 const std::vector< uint >& i_rIndices )
+	void CheckWritten( const std::vector< std::ostream* >& i_rFiles, const std::vector< std::string >& i_rFileSpecs )
 	{
-		// open the file for writing
-		std::ofstream file( i_rFileSpec.c_str() );
-		if( !file.good() )
+		for( size_t i = 0; i < i_rFiles.size(); ++i )
 		{
-			MV_THROW( DatabaseProxyException, "Unable to write to file: " << i_rFileSpec << ". eof: " << file.eof() << ", fail: " << file.fail() << ", bad: " << file.bad() );
+			std::ostream& file = *i_rFiles[i];
+			if( !file.good() )
+			{
+				MV_THROW( DatabaseProxyException, "Error encountered while writing to file: " << i_rFileSpecs[i] << ". eof: " << file.eof() << ", fail: " << file.fail() << ", bad: " << file.bad() );
+			}
 		}
+	}
 
+	// rows are dealt out to the files in turn, so each gets a whole (& roughly equal) share; i_rFileSpecs name o_rFiles in errors
+	long long WriteData( const std::vector< std::ostream* >& o_rFiles,
+						 const std::vector< std::string >& i_rFileSpecs,
+						 const std::string& i_rHeader,
+						 const std::map< std::string, std::string >& i_rParameters,
+						 std::istream& i_rData,
+						 int i_NumCols,
+						 const std::vector< uint >& i_rIndices )
+	{
 		// write the header
-		file << i_rHeader << std::endl;
+		std::vector< std::ostream* >::const_iterator fileIter = o_rFiles.begin();
+		for( ; fileIter != o_rFiles.end(); ++fileIter )
+		{
+			**fileIter << i_rHeader << std::endl;
+		}
 
 		// if we are not using any data from the stream, just write out the parameters in order and quit
 		if( i_rIndices.empty() )
 		{
+			std::ostream& file = *o_rFiles[0];
 			std::map< std::string, std::string >::const_iterator paramIter = i_rParameters.begin();
 			for( ; paramIter != i_rParameters.end(); ++paramIter )
 			{
@@ -152,11 +261,7 @@ namespace
 			}
 			file << std::endl;
 
-			if( !file.good() )
-			{
-				MV_THROW( DatabaseProxyException, "Error encountered while writing to file: " << i_rFileSpec << ". eof: " << file.eof() << ", fail: " << file.fail() << ", bad: " << file.bad() );
-			}
-			file.close();
+			CheckWritten( o_rFiles, i_rFileSpecs );
 			return 1;
 		}
 		
@@ -187,16 +292,112 @@ namespace
 			std::string line;
 			Join( dataColumns, line, ',' );
 			line += constants;
-			file << line << std::endl;
+			*o_rFiles[ count % o_rFiles.size() ] << line << std::endl;
 			++count;
 		}
 
-		if( !file.good() )
+		CheckWritten( o_rFiles, i_rFileSpecs );
+		return count;
+	}
+
+	long long WriteDataFiles( const std::vector< std::string >& i_rFileSpecs,
+							  const std::string& i_rHeader,
+							  const std::map< std::string, std::string >& i_rParameters,
+							  std::istream& i_rData,
+							  int i_NumCols,
+							  const std::vector< uint >& i_rIndices )
+	{
+		// open the files for writing
+		std::vector< boost::shared_ptr< std::ofstream > > files;
+		std::vector< std::ostream* > outputs;
+		std::vector< std::string >::const_iterator iter = i_rFileSpecs.begin();
+		for( ; iter != i_rFileSpecs.end(); ++iter )
+		{
+			boost::shared_ptr< std::ofstream > pFile( new std::ofstream( iter->c_str() ) );
+			if( !pFile->good() )
+			{
+				MV_THROW( DatabaseProxyException, "Unable to write to file: " << *iter << ". eof: " << pFile->eof() << ", fail: " << pFile->fail() << ", bad: " << pFile->bad() );
+			}
+			files.push_back( pFile );
+			outputs.push_back( pFile.get() );
+		}
+		return WriteData( outputs, i_rFileSpecs, i_rHeader, i_rParameters, i_rData, i_NumCols, i_rIndices );
+	}
+
+	// the body of a NamedPipeWriter; o_rCount is only set once the whole stream has been written
+	void StreamDataFile( std::ostream& o_rPipe,
+						 const std::string& i_rFileSpec,
+						 const std::string& i_rHeader,
+						 const std::map< std::string, std::string >& i_rParameters,
+						 std::istream& i_rData,
+						 int i_NumCols,
+						 const std::vector< uint >& i_rIndices,
+						 long long& o_rCount )
+	{
+		o_rCount = WriteData( std::vector< std::ostream* >( 1, &o_rPipe ), std::vector< std::string >( 1, i_rFileSpec ),
+							  i_rHeader, i_rParameters, i_rData, i_NumCols, i_rIndices );
+	}
+
+	// the file specs for the chunks of a file that is split i_Chunks ways; the first chunk keeps the file's own
+	std::vector< std::string > GetChunkFileSpecs( const std::string& i_rFileSpec, size_t i_Chunks )
+	{
+		std::vector< std::string > result( 1, i_rFileSpec );
+		for( size_t i = 1; i < i_Chunks; ++i )
 		{
-			MV_THROW( DatabaseProxyException, "Error encountered while writing to file: " << i_rFileSpec << ". eof: " << file.eof() << ", fail: " << file.fail() << ", bad: " << file.bad() );
+			result.push_back( i_rFileSpec + '.' + boost::lexical_cast< std::string >( i ) );
+		}
+		return result;
+	}
+
+	void RemoveFiles( const std::vector< std::string >& i_rFileSpecs )
+	{
+		std::vector< std::string >::const_iterator iter = i_rFileSpecs.begin();
+		for( ; iter != i_rFileSpecs.end(); ++iter )
+		{
+			FileUtilities::Remove( *iter );
+		}
+	}
+
+	void Upload( SQLLoader& i_rLoader, bool i_DirectLoad, std::string& o_rError )
+	{
+		try
+		{
+			if( i_rLoader.Upload( i_DirectLoad ) )
+			{
+				std::stringstream error;
+				error << "SQLLoader failed! Standard output: " << i_rLoader.GetStandardOutput() << ". Standard error: " << i_rLoader.GetStandardError();
+				o_rError = error.str();
+			}
+		}
+		catch( const std::exception& i_rException )
+		{
+			o_rError = i_rException.what();
+		}
+	}
+
+	// runs the loaders concurrently (each is a session of its own), and throws if any of them failed
+	void UploadAll( const std::vector< boost::shared_ptr< SQLLoader > >& i_rLoaders, bool i_DirectLoad )
+	{
+		std::vector< std::string > errors( i_rLoaders.size() );
+		boost::thread_group threads;
+		for( size_t i = 1; i < i_rLoaders.size(); ++i )
+		{
+			threads.create_thread( boost::bind( &Upload, boost::ref( *i_rLoaders[i] ), i_DirectLoad, boost::ref( errors[i] ) ) );
+		}
+		Upload( *i_rLoaders[0], i_DirectLoad, errors[0] );
+		threads.join_all();
+
+		for( size_t i = 0; i < errors.size(); ++i )
+		{
+			if( !errors[i].empty() && errors.size() == 1 )
+			{
+				MV_THROW( DatabaseProxyException, errors[i] );
+			}
+			if( !errors[i].empty() )
+			{
+				MV_THROW( DatabaseProxyException, "Uploading chunk " << i + 1 << " of " << errors.size() << " failed: " << errors[i] );
+			}
 		}
-		file.close();
-		return count;
 	}
 
 	void WriteControlFile( const std::string& i_rFileSpec, const std::string& i_rDataFileSpec, const std::string& i_rColumns, const std::string& i_rStagingTable, const std::map<std::string, size_t> i_rWriteColumnSizes )
@@ -466,6 +667,8 @@ DatabaseProxy::DatabaseProxy( const std::string& i_rName, boost::shared_ptr< Req
 	m_ReadHeader(),
 	m_ReadFieldSeparator( "," ),
 	m_ReadRecordSeparator( "\n" ),
+	m_ReadNullValue(),
+	m_ReadQuote(),
 	m_ReadConnectionByTable( false ),
 	m_WriteEnabled( false ),
 	m_WriteConnectionName(),
@@ -475,7 +678,10 @@ DatabaseProxy::DatabaseProxy( const std::string& i_rName, boost::shared_ptr< Req
 	m_WriteMySqlMergeQuery(),
 	m_WriteOracleMergeQuery(),
 	m_WriteVerticaMergeQuery(),
+	m_WriteMySqlBatchQuery(),
+	m_WriteOracleBatchQuery(),
 	m_WriteBindColumns(),
+	m_WriteBatchSize( 1 ),
 	m_WriteOnColumnParameterCollision( FAIL ),
 	m_PreStatement(),
 	m_PostStatement(),
@@ -485,6 +691,8 @@ DatabaseProxy::DatabaseProxy( const std::string& i_rName, boost::shared_ptr< Req
 	m_WriteDirectLoad( true ),
 	m_WriteLocalDataFile( true ),
 	m_WriteNoCleanUp( false ),
+	m_WriteStreamDataFile( false ),
+	m_WriteUploadParallelism( 1 ),
 	m_WriteRequiredColumns(),
 	m_WriteConnectionByTable( false ),
 	m_DeleteEnabled( false ),
@@ -494,7 +702,8 @@ DatabaseProxy::DatabaseProxy( const std::string& i_rName, boost::shared_ptr< Req
 	m_rDatabaseConnectionManager( i_rDatabaseConnectionManager ),
 	m_PendingCommits(),
 	m_PendingDrops(),
-	m_TableMutex(),
+	m_StagingTableLocks(),
+	m_TargetTableLocks(),
 	m_PendingCommitsMutex(),
 	m_PendingDropsMutex()
 {
@@ -515,6 +724,8 @@ DatabaseProxy::DatabaseProxy( const std::string& i_rName, boost::shared_ptr< Req
 	allowedReadAttributes.insert(ROWS_BUFFERED_ATTRIBUTE);
 	allowedReadAttributes.insert(FIELD_SEPARATOR_ATTRIBUTE);
 	allowedReadAttributes.insert(RECORD_SEPARATOR_ATTRIBUTE);
+	allowedReadAttributes.insert(NULL_VALUE_ATTRIBUTE);
+	allowedReadAttributes.insert(QUOTE_ATTRIBUTE);
 	allowedWriteAttributes.insert( CONNECTION_ATTRIBUTE );
 	allowedWriteAttributes.insert( CONNECTION_BY_TABLE_ATTRIBUTE );
 	allowedWriteAttributes.insert( MAX_BIND_SIZE_ATTRIBUTE );
@@ -527,9 +738,12 @@ DatabaseProxy::DatabaseProxy( const std::string& i_rName, boost::shared_ptr< Req
 	allowedWriteAttributes.insert( NO_CLEAN_UP_ATTRIBUTE );
 	allowedWriteAttributes.insert( INSERT_ONLY_ATTRIBUTE );
 	allowedWriteAttributes.insert( LOCAL_DATA_ATTRIBUTE );
+	allowedWriteAttributes.insert( STREAM_DATA_FILE_ATTRIBUTE );
+	allowedWriteAttributes.insert( UPLOAD_PARALLELISM_ATTRIBUTE );
 	allowedWriteAttributes.insert( ON_COLUMN_PARAMETER_COLLISION_ATTRIBUTE );
 	allowedWriteAttributes.insert( PRE_STATEMENT_ATTRIBUTE );
 	allowedWriteAttributes.insert( POST_STATEMENT_ATTRIBUTE );
+	allowedWriteAttributes.insert( BATCH_SIZE_ATTRIBUTE );
 	allowedDeleteAttributes.insert(CONNECTION_BY_TABLE_ATTRIBUTE);
 	allowedDeleteAttributes.insert(CONNECTION_ATTRIBUTE);
 	allowedDeleteAttributes.insert(QUERY_ATTRIBUTE);
@@ -562,6 +776,21 @@ DatabaseProxy::DatabaseProxy( const std::string& i_rName, boost::shared_ptr< Req
 		{
 			m_ReadRecordSeparator = XMLUtilities::XMLChToString(pAttribute->getValue());
 		}
+		pAttribute = XMLUtilities::GetAttribute( pNode, NULL_VALUE_ATTRIBUTE );
+		if( pAttribute != NULL )
+		{
+			m_ReadNullValue = XMLUtilities::XMLChToString(pAttribute->getValue());
+		}
+		pAttribute = XMLUtilities::GetAttribute( pNode, QUOTE_ATTRIBUTE );
+		if( pAttribute != NULL )
+		{
+			std::string quote = XMLUtilities::XMLChToString(pAttribute->getValue());
+			if( quote.size() != 1 )
+			{
+				MV_THROW( DatabaseProxyException, "Read attribute: " << QUOTE_ATTRIBUTE << " must be a single character" );
+			}
+			m_ReadQuote = quote[0];
+		}
 		pAttribute = XMLUtilities::GetAttribute( pNode, CONNECTION_ATTRIBUTE );
 		if( pAttribute != NULL )
 		{
@@ -629,6 +858,31 @@ DatabaseProxy::DatabaseProxy( const std::string& i_rName, boost::shared_ptr< Req
 		bool insertOnly = ProxyUtilities::GetBool( *pNode, INSERT_ONLY_ATTRIBUTE, false );
 		m_WriteLocalDataFile = ProxyUtilities::GetBool( *pNode, LOCAL_DATA_ATTRIBUTE, true );
 		m_WriteNoCleanUp = ProxyUtilities::GetBool( *pNode, NO_CLEAN_UP_ATTRIBUTE, false );
+		m_WriteStreamDataFile = ProxyUtilities::GetBool( *pNode, STREAM_DATA_FILE_ATTRIBUTE, false );
+		if( m_WriteStreamDataFile && m_WriteStagingTable.empty() )
+		{
+			MV_THROW( DatabaseProxyException, "Write attribute: " << STREAM_DATA_FILE_ATTRIBUTE << " can only be used with the " << STAGING_TABLE_ATTRIBUTE << " attribute" );
+		}
+
+		pAttribute = XMLUtilities::GetAttribute( pNode, UPLOAD_PARALLELISM_ATTRIBUTE );
+		if( pAttribute != NULL )
+		{
+			m_WriteUploadParallelism = boost::lexical_cast< size_t >( XMLUtilities::XMLChToString(pAttribute->getValue()) );
+			if( m_WriteUploadParallelism == 0 )
+			{
+				MV_THROW( DatabaseProxyException, "Write attribute: " << UPLOAD_PARALLELISM_ATTRIBUTE << " must be positive" );
+			}
+			// each chunk beyond the first needs a staging table of its own
+			if( m_WriteUploadParallelism > 1 && ( m_WriteStagingTable.empty() || !m_WriteDynamicStagingTable ) )
+			{
+				MV_THROW( DatabaseProxyException, "Write attribute: " << UPLOAD_PARALLELISM_ATTRIBUTE << " can only be greater than 1 with the "
+					<< STAGING_TABLE_ATTRIBUTE << " attribute and " << DYNAMIC_STAGING_TABLE_ATTRIBUTE << " set to true" );
+			}
+			if( m_WriteUploadParallelism > 1 && m_WriteStreamDataFile )
+			{
+				MV_THROW( DatabaseProxyException, "Write attribute: " << UPLOAD_PARALLELISM_ATTRIBUTE << " can only be greater than 1 without the " << STREAM_DATA_FILE_ATTRIBUTE << " attribute" );
+			}
+		}
 
 		pAttribute = XMLUtilities::GetAttribute( pNode, MAX_TABLE_NAME_LENGTH_ATTRIBUTE );
 		if( pAttribute != NULL )
@@ -649,6 +903,20 @@ DatabaseProxy::DatabaseProxy( const std::string& i_rName, boost::shared_ptr< Req
 			}
 		}
 
+		pAttribute = XMLUtilities::GetAttribute( pNode, BATCH_SIZE_ATTRIBUTE );
+		if( pAttribute != NULL )
+		{
+			m_WriteBatchSize = boost::lexical_cast< size_t >( XMLUtilities::XMLChToString(pAttribute->getValue()) );
+			if( m_WriteBatchSize == 0 )
+			{
+				MV_THROW( DatabaseProxyException, "Write attribute: " << BATCH_SIZE_ATTRIBUTE << " must be positive" );
+			}
+			if( !m_WriteStagingTable.empty() )
+			{
+				MV_THROW( DatabaseProxyException, "Write attribute: " << BATCH_SIZE_ATTRIBUTE << " cannot be used with the " << STAGING_TABLE_ATTRIBUTE << " attribute" );
+			}
+		}
+
 		pAttribute = XMLUtilities::GetAttribute( pNode, PRE_STATEMENT_ATTRIBUTE );
 		if( pAttribute != NULL )
 		{
@@ -683,6 +951,10 @@ DatabaseProxy::DatabaseProxy( const std::string& i_rName, boost::shared_ptr< Req
 		if( !m_WriteConnectionByTable )
 		{
 			std::string dbType = m_rDatabaseConnectionManager.GetDatabaseType( m_WriteConnectionName );
+			if( m_WriteStreamDataFile && dbType == VERTICA_DB_TYPE )
+			{
+				MV_THROW( DatabaseProxyException, "Write attribute: " << STREAM_DATA_FILE_ATTRIBUTE << " is not supported for " << VERTICA_DB_TYPE << " connections" );
+			}
 			std::string query = ProxyUtilities::GetMergeQuery( m_rDatabaseConnectionManager, m_WriteConnectionName,
 															   dbType, m_WriteTable, stagingTablePlaceholder,
 															   *XMLUtilities::GetSingletonChildByName( pNode, COLUMNS_NODE ),
@@ -715,6 +987,34 @@ DatabaseProxy::DatabaseProxy( const std::string& i_rName, boost::shared_ptr< Req
 																	  *XMLUtilities::GetSingletonChildByName( pNode, COLUMNS_NODE ),
 																	  insertOnly, m_WriteRequiredColumns, m_WriteNodeColumnLengths );
 		}
+
+		// batches are stored with the query for a staging table, which reads the rows from an inline table in its place
+		if( m_WriteBatchSize > 1 )
+		{
+			if( m_WriteBatchSize * m_WriteRequiredColumns.size() > MAX_BATCH_BIND_VARIABLES )
+			{
+				MV_THROW( DatabaseProxyException, "Write attribute: " << BATCH_SIZE_ATTRIBUTE << " is too large; batches of " << m_WriteBatchSize << " rows of "
+					<< m_WriteRequiredColumns.size() << " columns exceed the limit of " << MAX_BATCH_BIND_VARIABLES << " bind variables" );
+			}
+
+			std::map< std::string, std::string > requiredColumns;
+			std::map< std::string, size_t > columnLengths;
+			std::string dbType = ( m_WriteConnectionByTable ? "" : m_rDatabaseConnectionManager.GetDatabaseType( m_WriteConnectionName ) );
+			if( m_WriteConnectionByTable || dbType == MYSQL_DB_TYPE )
+			{
+				m_WriteMySqlBatchQuery = ProxyUtilities::GetMergeQuery( m_rDatabaseConnectionManager, m_WriteConnectionName,
+																		MYSQL_DB_TYPE, m_WriteTable, STAGING_TABLE_PLACEHOLDER,
+																		*XMLUtilities::GetSingletonChildByName( pNode, COLUMNS_NODE ),
+																		insertOnly, requiredColumns, columnLengths );
+			}
+			if( m_WriteConnectionByTable || dbType == ORACLE_DB_TYPE )
+			{
+				m_WriteOracleBatchQuery = ProxyUtilities::GetMergeQuery( m_rDatabaseConnectionManager, m_WriteConnectionName,
+																		 ORACLE_DB_TYPE, m_WriteTable, STAGING_TABLE_PLACEHOLDER,
+																		 *XMLUtilities::GetSingletonChildByName( pNode, COLUMNS_NODE ),
+																		 insertOnly, requiredColumns, columnLengths );
+			}
+		}
 	}
 
 	pNode = XMLUtilities::TryGetSingletonChildByName( &i_rNode, DELETE_NODE );
@@ -783,7 +1083,8 @@ void DatabaseProxy::LoadImpl( const std::map<std::string,std::string>& i_rParame
 	size_t rowCount = 0;
 	Stopwatch stopwatch;
 
-	if( dbType == VERTICA_DB_TYPE )
+	// vertica's internal load can't quote fields or write nulls as anything but empty
+	if( dbType == VERTICA_DB_TYPE && m_ReadNullValue.IsNull() && m_ReadQuote.IsNull() )
 	{
 		stmt.DoInternalBinding( numColumns, m_RowsBuffered );
 		stmt.Execute();
@@ -800,24 +1101,20 @@ void DatabaseProxy::LoadImpl( const std::map<std::string,std::string>& i_rParame
 		stmt.CompleteBinding( m_RowsBuffered );
 
 		//now iterate over the results, writing them into the stream in csv format
-		std::vector< Nullable<std::string> >::iterator colIter;
+		CsvRowWriter writer( o_rData, m_ReadFieldSeparator, m_ReadRecordSeparator );
+		if( !m_ReadNullValue.IsNull() )
+		{
+			writer.SetNullValue( m_ReadNullValue );
+		}
+		if( !m_ReadQuote.IsNull() )
+		{
+			writer.SetQuote( m_ReadQuote );
+		}
 		for (; stmt.NextRow(); ++rowCount)
 		{
-			colIter = columnsVector.begin();
-			for (; colIter != columnsVector.end(); ++colIter)
-			{
-				if (colIter == columnsVector.begin())
-				{
-					o_rData << *colIter;
-				}
-				else
-				{
-					o_rData << m_ReadFieldSeparator << *colIter;
-				}
-			}
-			o_rData << m_ReadRecordSeparator;
-		}	
-		o_rData << std::flush;
+			writer.WriteRow( columnsVector );
+		}
+		writer.Flush();
 	}
 
 	MVLOGGER("root.lib.DataProxy.DatabaseProxy.Load.ExecutingStmt.Finished", 
@@ -960,7 +1257,6 @@ void DatabaseProxy::StoreImpl( const std::map<std::string,std::string>& i_rParam
 		}
 		std::string sql( databaseType == ORACLE_DB_TYPE ? oracleMergeQuery : 
 					   ( databaseType == MYSQL_DB_TYPE ? mysqlMergeQuery : verticaMergeQuery ) );
-		Database::Statement statement( *pTransactionDatabase, sql );
 
 		// create a vector for all necessary pieces of data
 		std::vector< std::string > dataColumns( m_WriteBindColumns.size() );
@@ -989,10 +1285,20 @@ void DatabaseProxy::StoreImpl( const std::map<std::string,std::string>& i_rParam
 			{
 				MV_THROW( DatabaseProxyException, "Unable to find column: " << *iter << " in incoming data or parameters" );
 			}
-			size_t bindSize = GetWriteNodeBindSizeWithSourceName(*iter, m_WriteRequiredColumns, m_WriteNodeColumnLengths);
-			statement.BindVar( dataColumns[i], bindSize );
 		}
-		statement.CompleteBinding();
+
+		// the per-row statement is only needed when it will be executed; batch mode prepares its own statements
+		boost::scoped_ptr< Database::Statement > pStatement;
+		if( !needToRead || m_WriteBatchSize <= 1 )
+		{
+			pStatement.reset( new Database::Statement( *pTransactionDatabase, sql ) );
+			for( size_t i=0; i < m_WriteBindColumns.size(); ++i )
+			{
+				size_t bindSize = GetWriteNodeBindSizeWithSourceName( m_WriteBindColumns[i], m_WriteRequiredColumns, m_WriteNodeColumnLengths );
+				pStatement->BindVar( dataColumns[i], bindSize );
+			}
+			pStatement->CompleteBinding();
+		}
 
 		// issue the pre-statement query if one exists
 		if (!m_PreStatement.IsNull())
@@ -1011,9 +1317,69 @@ void DatabaseProxy::StoreImpl( const std::map<std::string,std::string>& i_rParam
 		{
 			Stopwatch stopwatch;
 			MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.Statement.Begin", "Executing the following statement once (since all fields have been provided via parameters: " << sql );
-			statement.Execute();
+			pStatement->Execute();
 			MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.Statement.Finished", "Statement:" << sql << " finished after " << stopwatch.GetElapsedSeconds() << " seconds" );
 		}
+		else if( m_WriteBatchSize > 1 )
+		{
+			// the inline table has a column per required column, whose value for each row is taken from where the
+			// per-row statement would have bound it
+			std::vector< std::string > batchColumns;
+			std::vector< size_t > batchSources;
+			std::vector< size_t > bindSizes;
+			std::map< std::string, std::string >::const_iterator columnIter = m_WriteRequiredColumns.begin();
+			for( ; columnIter != m_WriteRequiredColumns.end(); ++columnIter )
+			{
+				int bindIndex = IndexOf( columnIter->first, m_WriteBindColumns );
+				if( bindIndex == -1 )
+				{
+					MV_THROW( DatabaseProxyException, "Unable to find column: " << columnIter->first << " in bound data" );
+				}
+				batchColumns.push_back( columnIter->second );
+				batchSources.push_back( bindIndex );
+				bindSizes.push_back( GetWriteNodeBindSizeWithSourceName( columnIter->first, m_WriteRequiredColumns, m_WriteNodeColumnLengths ) );
+			}
+
+			std::string batchQuery = ProxyUtilities::GetVariableSubstitutedString(
+				databaseType == ORACLE_DB_TYPE ? m_WriteOracleBatchQuery : m_WriteMySqlBatchQuery, i_rParameters );
+			std::string fullBatchSql = GetBatchQuery( batchQuery, batchColumns, m_WriteBatchSize );
+			boost::shared_ptr< Database::Statement > pFullBatch;
+			std::vector< std::string > batchData( m_WriteBatchSize * batchColumns.size() );
+
+			Stopwatch stopwatch;
+			MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.Statement.Begin", "Executing the following statement for every " << m_WriteBatchSize
+				<< " rows of input: " << fullBatchSql );
+			long long rows( 0 );
+			long long batches( 0 );
+			size_t batchRows( 0 );
+			while( reader.NextRow() )
+			{
+				for( size_t i = 0; i < batchColumns.size(); ++i )
+				{
+					batchData[ batchRows * batchColumns.size() + i ] = dataColumns[ batchSources[i] ];
+				}
+				++rows;
+				if( ++batchRows == m_WriteBatchSize )
+				{
+					if( !pFullBatch )
+					{
+						pFullBatch = PrepareBatch( *pTransactionDatabase, fullBatchSql, batchData, bindSizes, m_WriteBatchSize );
+					}
+					ExecuteBatch( *pFullBatch, rows - batchRows + 1, batchRows );
+					++batches;
+					batchRows = 0;
+				}
+			}
+			if( batchRows > 0 )
+			{
+				boost::shared_ptr< Database::Statement > pLastBatch =
+					PrepareBatch( *pTransactionDatabase, GetBatchQuery( batchQuery, batchColumns, batchRows ), batchData, bindSizes, batchRows );
+				ExecuteBatch( *pLastBatch, rows - batchRows + 1, batchRows );
+				++batches;
+			}
+			MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.Statement.Finished", "Statement: " << batchQuery << " finished storing " << rows << " rows in "
+				<< batches << " batches after " << stopwatch.GetElapsedSeconds() << " seconds" );
+		}
 		else
 		{
 			// otherwise, execute the statement for every row in the incoming data
@@ -1022,7 +1388,7 @@ void DatabaseProxy::StoreImpl( const std::map<std::string,std::string>& i_rParam
 			long long i=0;
 			while( reader.NextRow() )
 			{
-				statement.Execute();
+				pStatement->Execute();
 				++i;
 			}
 			MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.Statement.Finished", "Statement: " << sql << " finished executing " << i << " times after " << stopwatch.GetElapsedSeconds() << " seconds" );
@@ -1049,16 +1415,50 @@ void DatabaseProxy::StoreImpl( const std::map<std::string,std::string>& i_rParam
 		std::string rejectedFileSpec;
 		GetUniqueFileSpecs( m_WriteWorkingDir, m_Name, dataFileSpec, controlFileSpec, logFileSpec, exceptionFileSpec, rejectedFileSpec );
 
-		// write the data file
-		MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.WritingDataFile.Begin", "Writing data to file: " << dataFileSpec );
+		std::string table;
+		std::string databaseType;
+		if( m_WriteConnectionByTable )
+		{
+			table = ProxyUtilities::GetVariableSubstitutedString( m_WriteConnectionName, i_rParameters );
+			databaseType = m_rDatabaseConnectionManager.GetDatabaseTypeByTable( table );
+		}
+		else
+		{
+			table = ProxyUtilities::GetVariableSubstitutedString( m_WriteTable, i_rParameters );
+			databaseType = m_rDatabaseConnectionManager.GetDatabaseType( m_WriteConnectionName );
+		}
+
+		// only SQLLoader & LOAD DATA are known to read a named pipe, so vertica's COPY FROM LOCAL is never given one.
+		// a connection-by-table node only learns its database type here, so it can't be refused when it is configured
+		if( m_WriteStreamDataFile && databaseType == VERTICA_DB_TYPE )
+		{
+			MV_THROW( DatabaseProxyException, "Write attribute: " << STREAM_DATA_FILE_ATTRIBUTE << " is not supported for " << VERTICA_DB_TYPE << " connections; unable to store to table: " << table );
+		}
+
+		// the data is split into chunks that are uploaded concurrently; only SQLLoader uploads outside of the
+		// transaction's connection (MySQL & Vertica load through it), so only Oracle uploads can be split
+		size_t chunks = ( databaseType == ORACLE_DB_TYPE ) ? m_WriteUploadParallelism : 1;
+		std::vector< std::string > dataFileSpecs = GetChunkFileSpecs( dataFileSpec, chunks );
+		std::vector< std::string > controlFileSpecs = GetChunkFileSpecs( controlFileSpec, chunks );
+		std::vector< std::string > logFileSpecs = GetChunkFileSpecs( logFileSpec, chunks );
+
 		std::string columns = GetOutputColumns( foundColumns, m_WriteRequiredColumns );
 		Stopwatch stopwatch;
-		long long count = WriteDataFile( dataFileSpec, columns, usedParameters, i_rData, incomingHeaderColumns.size(), usedIndeces );
-		MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.WritingDataFile.Finished", "Done writing " << count
-			<< " rows of data to file: " << dataFileSpec << " after " << stopwatch.GetElapsedSeconds() << " seconds" );
+		long long count( 0LL );
+
+		// write the data file, unless it is to be streamed to the loader as it reads it
+		if( !m_WriteStreamDataFile )
+		{
+			MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.WritingDataFile.Begin", "Writing data to file: " << dataFileSpec << ( chunks > 1 ? " in " + boost::lexical_cast< std::string >( chunks ) + " chunks" : "" ) );
+			stopwatch.Reset();
+			count = WriteDataFiles( dataFileSpecs, columns, usedParameters, i_rData, incomingHeaderColumns.size(), usedIndeces );
+			MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.WritingDataFile.Finished", "Done writing " << count
+				<< " rows of data to file: " << dataFileSpec << " after " << stopwatch.GetElapsedSeconds() << " seconds" );
+		}
 
 		// if there's no data, we can remove the file and just do the pre / post statements
-		if( count == 0LL )
+		// (streamed data isn't counted until it has been uploaded, so it is always uploaded & merged)
+		if( !m_WriteStreamDataFile && count == 0LL )
 		{
 			// issue the pre-statement query if one exists
 			if (!m_PreStatement.IsNull())
@@ -1074,7 +1474,7 @@ void DatabaseProxy::StoreImpl( const std::map<std::string,std::string>& i_rParam
 			MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.NoData", "There is no data to upload; skipping the upload / merge stage" );
 			if( !m_WriteNoCleanUp )
 			{
-				FileUtilities::Remove( dataFileSpec );
+				RemoveFiles( dataFileSpecs );
 			}
 
 			// issue the post-statement query if one exists
@@ -1095,19 +1495,7 @@ void DatabaseProxy::StoreImpl( const std::map<std::string,std::string>& i_rParam
 			boost::shared_ptr< ScopedTempTable > pTempTable;
 			boost::shared_ptr< Database > pDataDefinitionDatabase = GetDataDefinitionConnection( m_WriteConnectionName, m_WriteConnectionByTable, m_rDatabaseConnectionManager, i_rParameters );
 			std::string stagingTable = ProxyUtilities::GetVariableSubstitutedString( m_WriteStagingTable, i_rParameters );
-			std::string table;
-			std::string databaseType;
-			
-			if( m_WriteConnectionByTable )
-			{
-				table = ProxyUtilities::GetVariableSubstitutedString( m_WriteConnectionName, i_rParameters );
-				databaseType = m_rDatabaseConnectionManager.GetDatabaseTypeByTable( table );
-			}
-			else
-			{
-				table = ProxyUtilities::GetVariableSubstitutedString( m_WriteTable, i_rParameters );
-				databaseType = m_rDatabaseConnectionManager.GetDatabaseType( m_WriteConnectionName );
-			}
+			std::string stagingTablePrefix = stagingTable;
 
 			// if we're dynamically creating a staging table, create one via a data-definition connection, and set the staging table name
 			if( m_WriteDynamicStagingTable )
@@ -1124,13 +1512,41 @@ void DatabaseProxy::StoreImpl( const std::map<std::string,std::string>& i_rParam
 				pPendingInsert.reset( new PendingDropInserter( pTempTable, m_PendingDrops, m_PendingDropsMutex ) );
 			}
 
+			// each chunk of data after the first is uploaded into a dynamic staging table of its own
+			std::vector< std::string > stagingTables( 1, stagingTable );
+			std::vector< boost::shared_ptr< PendingDropInserter > > chunkPendingInserts;
+			for( size_t i = 1; i < chunks; ++i )
+			{
+				stagingTables.push_back( GetDynamicStagingTable( stagingTablePrefix, m_WriteMaxTableNameLength ) );
+				boost::shared_ptr< ScopedTempTable > pChunkTable( new ScopedTempTable( pDataDefinitionDatabase, databaseType, table, stagingTables.back() ) );
+				chunkPendingInserts.push_back( boost::shared_ptr< PendingDropInserter >( new PendingDropInserter( pChunkTable, m_PendingDrops, m_PendingDropsMutex ) ) );
+			}
+
 			std::string mysqlMergeQuery = GetAllSubstitutions( m_WriteMySqlMergeQuery, i_rParameters, stagingTable );
-			std::string oracleMergeQuery = GetAllSubstitutions( m_WriteOracleMergeQuery, i_rParameters, stagingTable );
+			std::string oracleMergeQuery = GetAllSubstitutions( chunks > 1 ? GetChunkedQuery( m_WriteOracleMergeQuery, stagingTables ) : m_WriteOracleMergeQuery,
+																i_rParameters, stagingTable );
 			std::string verticaMergeQuery = GetAllSubstitutions( m_WriteVerticaMergeQuery, i_rParameters, stagingTable );
 						
-			// obtain a write-lock for entire manipulation
 			{
-				boost::unique_lock< boost::shared_mutex > lock( m_TableMutex );
+				// a fixed staging table is shared by every store through this node, from its truncation through the merge
+				// that reads it back; dynamic (and MySQL's temporary) staging tables belong to this store alone, so their
+				// uploads can run concurrently
+				boost::scoped_ptr< TableLocks::Lock > pStagingLock;
+				boost::scoped_ptr< TableLocks::Lock > pMergeLock;
+				if( !m_WriteDynamicStagingTable && databaseType != MYSQL_DB_TYPE )
+				{
+					pStagingLock.reset( LockTable( m_StagingTableLocks, stagingTable ) );
+				}
+
+				// when streaming, the data file is a named pipe that is written as the loader reads it
+				boost::scoped_ptr< NamedPipeWriter > pDataWriter;
+				if( m_WriteStreamDataFile )
+				{
+					MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.StreamingDataFile", "Streaming data to the loader through named pipe: " << dataFileSpec );
+					pDataWriter.reset( new NamedPipeWriter( dataFileSpec, boost::bind( &StreamDataFile, _1, boost::cref( dataFileSpec ), boost::cref( columns ),
+						boost::cref( usedParameters ), boost::ref( i_rData ), int( incomingHeaderColumns.size() ), boost::cref( usedIndeces ), boost::ref( count ) ) ) );
+				}
+				std::string uploadRows( pDataWriter ? std::string( "streamed" ) : boost::lexical_cast< std::string >( count ) );
 
 				// ORACLE
 				if( databaseType == ORACLE_DB_TYPE )
@@ -1144,19 +1560,29 @@ void DatabaseProxy::StoreImpl( const std::map<std::string,std::string>& i_rParam
 						Database::Statement( *pDataDefinitionDatabase, sql.str() ).Execute();
 					}
 
-					// write the control file & prepare SQLLoader
-					WriteControlFile( controlFileSpec, dataFileSpec, columns, PrefixTable( stagingTable, pTransactionDatabase->GetSchema() ), m_WriteNodeColumnLengths);
-					SQLLoader loader( pTransactionDatabase->GetDBName(), pTransactionDatabase->GetUserName(), pTransactionDatabase->GetPassword(), controlFileSpec, logFileSpec );
+					// write the control files & prepare a SQLLoader per chunk
+					std::vector< boost::shared_ptr< SQLLoader > > loaders;
+					for( size_t i = 0; i < chunks; ++i )
+					{
+						WriteControlFile( controlFileSpecs[i], dataFileSpecs[i], columns, PrefixTable( stagingTables[i], pTransactionDatabase->GetSchema() ), m_WriteNodeColumnLengths);
+						loaders.push_back( boost::shared_ptr< SQLLoader >( new SQLLoader( pTransactionDatabase->GetDBName(), pTransactionDatabase->GetUserName(),
+							pTransactionDatabase->GetPassword(), controlFileSpecs[i], logFileSpecs[i] ) ) );
+					}
 
 					// upload!
-					MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.Upload.Begin", "Uploading " << count << " rows of data to staging table: " << stagingTable );
+					MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.Upload.Begin", "Uploading " << uploadRows << " rows of data to staging table: " << stagingTable
+						<< ( chunks > 1 ? " and " + boost::lexical_cast< std::string >( chunks - 1 ) + " more in parallel" : "" ) );
 					stopwatch.Reset();
-					if( loader.Upload( m_WriteDirectLoad ) )
+					UploadAll( loaders, m_WriteDirectLoad );
+					if( pDataWriter )
 					{
-						MV_THROW( DatabaseProxyException, "SQLLoader failed! Standard output: " << loader.GetStandardOutput() << ". Standard error: " << loader.GetStandardError());
+						pDataWriter->Finish();
 					}
 					MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.Upload.Finished", "Done uploading " << count << " rows of data to staging table: " << stagingTable << " after " << stopwatch.GetElapsedSeconds() << " seconds" );
 
+					// merges into the target table (and the statements around them) are serialized
+					pMergeLock.reset( LockTable( m_TargetTableLocks, table ) );
+
 					// issue the pre-statement query if one exists
 					if (!m_PreStatement.IsNull())
 					{
@@ -1188,9 +1614,9 @@ void DatabaseProxy::StoreImpl( const std::map<std::string,std::string>& i_rParam
 					// if cleaning up, remove files
 					if( !m_WriteNoCleanUp )
 					{
-						FileUtilities::Remove( dataFileSpec );
-						FileUtilities::Remove( controlFileSpec );
-						FileUtilities::Remove( logFileSpec );
+						RemoveFiles( dataFileSpecs );
+						RemoveFiles( controlFileSpecs );
+						RemoveFiles( logFileSpecs );
 					}
 				}
 				else if( databaseType == MYSQL_DB_TYPE )
@@ -1205,11 +1631,18 @@ void DatabaseProxy::StoreImpl( const std::map<std::string,std::string>& i_rParam
 						<< "FIELDS TERMINATED BY ',' OPTIONALLY ENCLOSED BY '\"'" << std::endl
 						<< "IGNORE 1 LINES" << std::endl
 						<< "( " << columns << " )" << std::endl;
-					MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.Upload.Begin", "Uploading " << count << " rows of data to staging table: " << stagingTable );
+					MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.Upload.Begin", "Uploading " << uploadRows << " rows of data to staging table: " << stagingTable );
 					stopwatch.Reset();
 					Database::Statement( *pTransactionDatabase, sql.str() ).Execute();
+					if( pDataWriter )
+					{
+						pDataWriter->Finish();
+					}
 					MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.Upload.Finished", "Done uploading " << count << " rows of data to staging table: " << stagingTable << " after " << stopwatch.GetElapsedSeconds() << " seconds" );
 
+					// merges into the target table (and the statements around them) are serialized
+					pMergeLock.reset( LockTable( m_TargetTableLocks, table ) );
+
 					// issue the pre-statement query if one exists
 					if (!m_PreStatement.IsNull())
 					{
@@ -1268,7 +1701,7 @@ void DatabaseProxy::StoreImpl( const std::map<std::string,std::string>& i_rParam
 						<< " SKIP 1"
 						<< ( m_WriteDirectLoad ? " DIRECT" : "" )
 						<< " TRAILING NULLCOLS";
-					MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.Upload.Begin", "Uploading " << count << " rows of data to staging table: " << stagingTable );
+					MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.Upload.Begin", "Uploading " << uploadRows << " rows of data to staging table: " << stagingTable );
 					stopwatch.Reset();
 					Database::Statement( *pTransactionDatabase, sql.str() ).Execute();
 					MVLOGGER( "root.lib.DataProxy.DatabaseProxy.Store.Upload.Finished", "Done uploading " << count << " rows of data to staging table: " << stagingTable << " after " << stopwatch.GetElapsedSeconds() << " seconds" );
@@ -1278,6 +1711,9 @@ void DatabaseProxy::StoreImpl( const std::map<std::string,std::string>& i_rParam
 					}
 				
 
+					// merges into the target table (and the statements around them) are serialized
+					pMergeLock.reset( LockTable( m_TargetTableLocks, table ) );
+
 					// issue the pre-statement query if one exists
 					if (!m_PreStatement.IsNull())
 					{
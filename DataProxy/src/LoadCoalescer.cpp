@@ -0,0 +1,99 @@
+#include "LoadCoalescer.hpp"
+
+LoadCoalescer::Flight::Flight()
+:	m_Landed(),
+	m_Complete( false ),
+	m_pResult(),
+	m_pError()
+{
+}
+
+LoadCoalescer::Leader::Leader( LoadCoalescer& i_rCoalescer, const std::string& i_rKey, boost::shared_ptr< Flight > i_pFlight )
+:	m_rCoalescer( i_rCoalescer ),
+	m_Key( i_rKey ),
+	m_pFlight( i_pFlight ),
+	m_pResult(),
+	m_pError()
+{
+}
+
+LoadCoalescer::Leader::~Leader()
+{
+	m_rCoalescer.Land( m_Key, m_pFlight, m_pResult, m_pError );
+}
+
+void LoadCoalescer::Leader::SetResult( boost::shared_ptr< const std::string > i_pResult )
+{
+	m_pResult = i_pResult;
+}
+
+void LoadCoalescer::Leader::SetError( const std::string& i_rError )
+{
+	m_pError.reset( new std::string( i_rError ) );
+}
+
+LoadCoalescer::LoadCoalescer( size_t i_MaxBytes )
+:	m_MaxBytes( i_MaxBytes ),
+	m_Mutex(),
+	m_Flights(),
+	m_FollowerCount( 0 )
+{
+}
+
+LoadCoalescer::~LoadCoalescer()
+{
+}
+
+boost::shared_ptr< LoadCoalescer::Leader > LoadCoalescer::Join( const std::string& i_rKey,
+																boost::shared_ptr< const std::string >& o_rpResult,
+																boost::shared_ptr< const std::string >& o_rpError )
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	o_rpResult.reset();
+	o_rpError.reset();
+
+	std::map< std::string, boost::shared_ptr< Flight > >::iterator iter = m_Flights.find( i_rKey );
+	if( iter == m_Flights.end() )
+	{
+		boost::shared_ptr< Flight > pFlight( new Flight() );
+		m_Flights[ i_rKey ] = pFlight;
+		return boost::shared_ptr< Leader >( new Leader( *this, i_rKey, pFlight ) );
+	}
+
+	boost::shared_ptr< Flight > pFlight = iter->second;
+	++m_FollowerCount;
+	while( !pFlight->m_Complete )
+	{
+		pFlight->m_Landed.wait( lock );
+	}
+	--m_FollowerCount;
+	o_rpResult = pFlight->m_pResult;
+	o_rpError = pFlight->m_pError;
+	return boost::shared_ptr< Leader >();
+}
+
+size_t LoadCoalescer::GetMaxBytes() const
+{
+	return m_MaxBytes;
+}
+
+size_t LoadCoalescer::GetFollowerCount() const
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	return m_FollowerCount;
+}
+
+void LoadCoalescer::Land( const std::string& i_rKey,
+						  boost::shared_ptr< Flight > i_pFlight,
+						  boost::shared_ptr< const std::string > i_pResult,
+						  boost::shared_ptr< const std::string > i_pError )
+{
+	{
+		boost::unique_lock< boost::mutex > lock( m_Mutex );
+		i_pFlight->m_Complete = true;
+		i_pFlight->m_pResult = i_pResult;
+		i_pFlight->m_pError = i_pError;
+		m_Flights.erase( i_rKey );
+	}
+	i_pFlight->m_Landed.notify_all();
+}
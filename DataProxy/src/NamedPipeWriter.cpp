@@ -0,0 +1,155 @@
+#include "NamedPipeWriter.hpp"
+#include <boost/bind.hpp>
+#include <boost/iostreams/categories.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+	// how often to check whether to stop waiting for a reader
+	const useconds_t READER_POLL_MICROSECONDS( 10000 );
+
+	class FileDescriptorSink
+	{
+	public:
+		typedef char char_type;
+		typedef boost::iostreams::sink_tag category;
+
+		FileDescriptorSink( int i_FileDescriptor, const std::string& i_rFileSpec )
+		:	m_FileDescriptor( i_FileDescriptor ),
+			m_FileSpec( i_rFileSpec )
+		{
+		}
+
+		std::streamsize write( const char* i_pData, std::streamsize i_Size )
+		{
+			std::streamsize written = 0;
+			while( written < i_Size )
+			{
+				ssize_t bytes = ::write( m_FileDescriptor, i_pData + written, i_Size - written );
+				if( bytes < 0 && errno == EINTR )
+				{
+					continue;
+				}
+				if( bytes < 0 && errno == EPIPE )
+				{
+					MV_THROW( NamedPipeWriterException, "The reader of named pipe: " << m_FileSpec << " stopped reading before all the data was written" );
+				}
+				if( bytes < 0 )
+				{
+					MV_THROW( NamedPipeWriterException, "Error writing to named pipe: " << m_FileSpec << ": " << ::strerror( errno ) );
+				}
+				written += bytes;
+			}
+			return written;
+		}
+
+	private:
+		int m_FileDescriptor;
+		std::string m_FileSpec;
+	};
+}
+
+NamedPipeWriter::NamedPipeWriter( const std::string& i_rFileSpec, const WriteFunction& i_rWrite )
+:	m_FileSpec( i_rFileSpec ),
+	m_Write( i_rWrite ),
+	m_Mutex(),
+	m_Finishing( false ),
+	m_Error(),
+	m_pThread()
+{
+	if( ::mkfifo( m_FileSpec.c_str(), 0666 ) != 0 )
+	{
+		MV_THROW( NamedPipeWriterException, "Unable to create named pipe: " << m_FileSpec << ": " << ::strerror( errno ) );
+	}
+	m_pThread.reset( new boost::thread( boost::bind( &NamedPipeWriter::Run, this ) ) );
+}
+
+NamedPipeWriter::~NamedPipeWriter()
+{
+	try
+	{
+		Finish();
+	}
+	catch( ... )
+	{
+		// whoever destroys a writer without finishing it is already handling a failure of their own
+	}
+}
+
+void NamedPipeWriter::Finish()
+{
+	if( m_pThread )
+	{
+		{
+			boost::unique_lock< boost::mutex > lock( m_Mutex );
+			m_Finishing = true;
+		}
+		m_pThread->join();
+		m_pThread.reset();
+	}
+	if( !m_Error.empty() )
+	{
+		MV_THROW( NamedPipeWriterException, m_Error );
+	}
+}
+
+void NamedPipeWriter::Run()
+{
+	// a reader that goes away should fail the write (EPIPE), not kill the process
+	sigset_t signals;
+	::sigemptyset( &signals );
+	::sigaddset( &signals, SIGPIPE );
+	::pthread_sigmask( SIG_BLOCK, &signals, NULL );
+
+	int fileDescriptor = -1;
+	try
+	{
+		// a blocking open would wait forever for a reader that never comes, so poll until Finish gives up on it
+		while( ( fileDescriptor = ::open( m_FileSpec.c_str(), O_WRONLY | O_NONBLOCK ) ) < 0 )
+		{
+			if( errno != ENXIO && errno != EINTR )
+			{
+				MV_THROW( NamedPipeWriterException, "Unable to open named pipe: " << m_FileSpec << ": " << ::strerror( errno ) );
+			}
+			{
+				boost::unique_lock< boost::mutex > lock( m_Mutex );
+				if( m_Finishing )
+				{
+					MV_THROW( NamedPipeWriterException, "Nothing opened named pipe: " << m_FileSpec << " for reading" );
+				}
+			}
+			::usleep( READER_POLL_MICROSECONDS );
+		}
+		::fcntl( fileDescriptor, F_SETFL, ::fcntl( fileDescriptor, F_GETFL ) & ~O_NONBLOCK );
+
+		boost::iostreams::stream< FileDescriptorSink > output( FileDescriptorSink( fileDescriptor, m_FileSpec ) );
+		output.exceptions( std::ios_base::badbit );
+		m_Write( output );
+		output.flush();
+	}
+	catch( const std::exception& i_rException )
+	{
+		m_Error = i_rException.what();
+	}
+	catch( ... )
+	{
+		m_Error = "Unknown error writing to named pipe: " + m_FileSpec;
+	}
+
+	if( fileDescriptor >= 0 )
+	{
+		::close( fileDescriptor );
+	}
+
+	// discard the SIGPIPE raised by a reader going away; it is reported as an error instead
+	timespec noWait = { 0, 0 };
+	while( ::sigtimedwait( &signals, NULL, &noWait ) == SIGPIPE )
+	{
+	}
+}
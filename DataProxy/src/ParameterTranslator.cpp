@@ -567,6 +567,11 @@ bool ParameterTranslator::IsSilenced( const std::string& i_rName ) const
 		  && m_PrimaryDefaults.find( i_rName ) == m_PrimaryDefaults.end() );		// there is no value default
 }
 
+bool ParameterTranslator::HasDelayedParameters() const
+{
+	return !m_DelayedEvaluationParameters.empty();
+}
+
 void ParameterTranslator::TranslateDelayedParameters( std::map< std::string, std::string >& o_rTranslatedParameters, std::istream& i_rData ) const
 {
 	std::string md5Value("");
@@ -29,3 +29,25 @@ void RequestForwarder::Delete( const std::string& i_rName, const std::map<std::s
 {
 	m_rDataProxyClient.DeleteImpl( i_rName, i_rParameters );
 }
+
+RequestForwarder::PinnedConfiguration RequestForwarder::PinConfiguration() const
+{
+	return m_rDataProxyClient.GetCurrentConfiguration();
+}
+
+void RequestForwarder::Store( PinnedConfiguration& io_rpConfiguration, const std::string& i_rName, const std::map<std::string,std::string>& i_rParameters, std::istream& i_rData ) const
+{
+	if( io_rpConfiguration == NULL )
+	{
+		Store( i_rName, i_rParameters, i_rData );
+		return;
+	}
+	DataProxyClient::ConfigurationPtr pConfiguration = boost::static_pointer_cast< const DataProxyClient::Configuration >( io_rpConfiguration );
+	io_rpConfiguration.reset();
+	m_rDataProxyClient.StoreImpl( pConfiguration, i_rName, i_rParameters, i_rData );
+}
+
+bool RequestForwarder::InsideTransaction() const
+{
+	return m_rDataProxyClient.m_InsideTransaction;
+}
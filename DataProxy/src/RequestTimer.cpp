@@ -0,0 +1,158 @@
+#include "RequestTimer.hpp"
+#include "ClockUtilities.hpp"
+#include "MonitoringTracker.hpp"
+#include "MVLogger.hpp"
+#include <boost/thread/tss.hpp>
+#include <iomanip>
+#include <sstream>
+
+namespace
+{
+	const std::string RESULT_FAILED( "fail" );
+	const std::string METRIC_SUFFIX( "Seconds" );
+
+	// timers are owned by the requests they time, never by the thread
+	void NoCleanup( RequestTimer* )
+	{
+	}
+
+	// the innermost request being timed on each thread
+	boost::thread_specific_ptr< RequestTimer > s_pCurrentTimer( &NoCleanup );
+}
+
+RequestTimer::Phase::Phase( RequestTimer& i_rTimer, const std::string& i_rName )
+:	m_rTimer( i_rTimer ),
+	m_rName( i_rName ),
+	m_Start( ClockUtilities::Now() )
+{
+}
+
+RequestTimer::Phase::~Phase()
+{
+	m_rTimer.Add( m_rName, ClockUtilities::Now() - m_Start );
+}
+
+RequestTimer::RequestTimer( const std::string& i_rNode, const std::string& i_rOperation, MonitoringTracker& i_rTracker )
+:	m_Node( i_rNode ),
+	m_Operation( i_rOperation ),
+	m_Result( RESULT_FAILED ),
+	m_rTracker( i_rTracker ),
+	m_Start( ClockUtilities::Now() ),
+	m_Phases(),
+	m_Children(),
+	m_pParent( s_pCurrentTimer.get() ),
+	m_Bytes( 0 ),
+	m_Context( RequestTrace::GetCurrent() ),
+	m_pScope()
+{
+	// whether a request is traced is decided once, at the top; those it issues go along with it
+	if( !m_Context.m_InRequest && RequestTrace::Sample() )
+	{
+		m_Context.m_pTrace.reset( new RequestTrace() );
+	}
+	if( m_Context.m_pTrace )
+	{
+		m_Context.m_SpanId = m_Context.m_pTrace->BeginSpan( m_Context.m_SpanId, m_Node, m_Operation );
+	}
+	m_Context.m_InRequest = true;
+	m_pScope.reset( new RequestTrace::Scope( m_Context ) );
+	s_pCurrentTimer.reset( this );
+}
+
+RequestTimer::~RequestTimer()
+{
+	s_pCurrentTimer.reset( m_pParent );
+	m_pScope.reset();
+	try
+	{
+		if( m_Context.m_pTrace )
+		{
+			m_Context.m_pTrace->EndSpan( m_Context.m_SpanId, m_Result, m_Bytes );
+		}
+
+		std::vector< std::pair< std::string, double > >::const_iterator iter = m_Phases.begin();
+		for( ; iter != m_Phases.end(); ++iter )
+		{
+			m_rTracker.Report( iter->first + METRIC_SUFFIX, iter->second );
+		}
+
+		if( m_pParent != NULL )
+		{
+			m_pParent->m_Children.push_back( GetSummary() );
+		}
+		else if( m_Context.m_pTrace )
+		{
+			MVLOGGER( "root.lib.DataProxy.RequestTimer.Timings", "trace=" << m_Context.m_pTrace->GetId() << " " << GetSummary() );
+		}
+		else
+		{
+			MVLOGGER( "root.lib.DataProxy.RequestTimer.Timings", GetSummary() );
+		}
+	}
+	catch( ... )
+	{
+		// timing is never worth failing (or, while unwinding, terminating) a request over
+	}
+}
+
+void RequestTimer::SetResult( const std::string& i_rResult )
+{
+	m_Result = i_rResult;
+}
+
+void RequestTimer::SetBytes( size_t i_Bytes )
+{
+	m_Bytes = i_Bytes;
+}
+
+std::string RequestTimer::GetSummary() const
+{
+	std::stringstream result;
+	result << std::fixed << std::setprecision( 6 )
+		   << "node=" << m_Node << " operation=" << m_Operation << " result=" << m_Result << " total=" << ClockUtilities::Now() - m_Start;
+
+	std::vector< std::pair< std::string, double > >::const_iterator phaseIter = m_Phases.begin();
+	for( ; phaseIter != m_Phases.end(); ++phaseIter )
+	{
+		result << ' ' << phaseIter->first << '=' << phaseIter->second;
+	}
+
+	std::vector< std::string >::const_iterator childIter = m_Children.begin();
+	for( ; childIter != m_Children.end(); ++childIter )
+	{
+		result << " { " << *childIter << " }";
+	}
+	return result.str();
+}
+
+double RequestTimer::GetSeconds( const std::string& i_rPhase ) const
+{
+	std::vector< std::pair< std::string, double > >::const_iterator iter = m_Phases.begin();
+	for( ; iter != m_Phases.end(); ++iter )
+	{
+		if( iter->first == i_rPhase )
+		{
+			return iter->second;
+		}
+	}
+	return 0;
+}
+
+RequestTimer* RequestTimer::GetCurrent()
+{
+	return s_pCurrentTimer.get();
+}
+
+void RequestTimer::Add( const std::string& i_rPhase, double i_Seconds )
+{
+	std::vector< std::pair< std::string, double > >::iterator iter = m_Phases.begin();
+	for( ; iter != m_Phases.end(); ++iter )
+	{
+		if( iter->first == i_rPhase )
+		{
+			iter->second += i_Seconds;
+			return;
+		}
+	}
+	m_Phases.push_back( std::make_pair( i_rPhase, i_Seconds ) );
+}
@@ -0,0 +1,217 @@
+#include "RequestTrace.hpp"
+#include "ClockUtilities.hpp"
+#include "UniqueIdGenerator.hpp"
+#include "MVLogger.hpp"
+#include <boost/thread/tss.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <stdio.h>
+
+namespace
+{
+	// the context requests on each thread are made in
+	boost::thread_specific_ptr< RequestTrace::Context > s_pCurrentContext;
+
+	RequestTrace::Context& GetCurrentContext()
+	{
+		if( s_pCurrentContext.get() == NULL )
+		{
+			s_pCurrentContext.reset( new RequestTrace::Context() );
+		}
+		return *s_pCurrentContext;
+	}
+
+	std::string GetUniqueId()
+	{
+		static UniqueIdGenerator s_UniqueIdGenerator;
+		return s_UniqueIdGenerator.GetUniqueId();
+	}
+
+	void WriteString( std::ostream& o_rOutput, const std::string& i_rValue )
+	{
+		o_rOutput << '"';
+		std::string::const_iterator iter = i_rValue.begin();
+		for( ; iter != i_rValue.end(); ++iter )
+		{
+			switch( *iter )
+			{
+				case '"':
+					o_rOutput << "\\\"";
+					break;
+				case '\\':
+					o_rOutput << "\\\\";
+					break;
+				default:
+					if( (unsigned char)*iter < 0x20 )
+					{
+						char escaped[8];
+						::snprintf( escaped, sizeof( escaped ), "\\u%04x", (unsigned char)*iter );
+						o_rOutput << escaped;
+					}
+					else
+					{
+						o_rOutput << *iter;
+					}
+			}
+		}
+		o_rOutput << '"';
+	}
+}
+
+boost::atomic< double > RequestTrace::s_SampleRate( 0 );
+boost::atomic< boost::uint64_t > RequestTrace::s_SampledRequests( 0 );
+
+RequestTrace::Context::Context()
+:	m_pTrace(),
+	m_SpanId( 0 ),
+	m_InRequest( false )
+{
+}
+
+RequestTrace::Context::Context( const boost::shared_ptr< RequestTrace >& i_pTrace, size_t i_SpanId )
+:	m_pTrace( i_pTrace ),
+	m_SpanId( i_SpanId ),
+	m_InRequest( true )
+{
+}
+
+RequestTrace::Scope::Scope( const Context& i_rContext )
+:	m_Previous( GetCurrentContext() )
+{
+	GetCurrentContext() = i_rContext;
+}
+
+RequestTrace::Scope::~Scope()
+{
+	GetCurrentContext() = m_Previous;
+}
+
+RequestTrace::RequestTrace()
+:	m_Id( GetUniqueId() ),
+	m_Mutex(),
+	m_Spans()
+{
+}
+
+RequestTrace::~RequestTrace()
+{
+	try
+	{
+		MVLOGGER( "root.lib.DataProxy.RequestTrace.Trace", GetJson() );
+	}
+	catch( ... )
+	{
+		// tracing is never worth failing a request over
+	}
+}
+
+RequestTrace::Context RequestTrace::GetCurrent()
+{
+	return GetCurrentContext();
+}
+
+void RequestTrace::SetSampleRate( double i_Rate )
+{
+	s_SampleRate = std::min( std::max( i_Rate, 0.0 ), 1.0 );
+}
+
+double RequestTrace::GetSampleRate()
+{
+	return s_SampleRate;
+}
+
+bool RequestTrace::Sample()
+{
+	double rate = s_SampleRate;
+	if( rate <= 0 )
+	{
+		return false;
+	}
+	// a request is sampled when it takes the running total of rate * requests past another whole number
+	boost::uint64_t request = s_SampledRequests.fetch_add( 1, boost::memory_order_relaxed );
+	return boost::uint64_t( ( request + 1 ) * rate ) != boost::uint64_t( request * rate );
+}
+
+const std::string& RequestTrace::GetId() const
+{
+	return m_Id;
+}
+
+size_t RequestTrace::BeginSpan( size_t i_ParentId, const std::string& i_rNode, const std::string& i_rOperation )
+{
+	Span span;
+	span.m_ParentId = i_ParentId;
+	span.m_Node = i_rNode;
+	span.m_Operation = i_rOperation;
+	span.m_Start = ClockUtilities::Now( CLOCK_REALTIME );
+	span.m_End = 0;
+	span.m_Bytes = 0;
+
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	m_Spans.push_back( span );
+	return m_Spans.size();
+}
+
+void RequestTrace::EndSpan( size_t i_SpanId, const std::string& i_rResult, size_t i_Bytes )
+{
+	double end = ClockUtilities::Now( CLOCK_REALTIME );
+
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	Span& rSpan = m_Spans[ i_SpanId - 1 ];
+	rSpan.m_Result = i_rResult;
+	rSpan.m_End = end;
+	rSpan.m_Bytes = i_Bytes;
+}
+
+std::string RequestTrace::GetJson() const
+{
+	std::stringstream result;
+	result << std::fixed << std::setprecision( 6 );
+	result << "{\"traceId\":";
+	WriteString( result, m_Id );
+	result << ",\"spans\":[";
+
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	// children always begin after their parent, so each list is in the order the spans began
+	std::vector< std::vector< size_t > > children( m_Spans.size() + 1 );
+	for( size_t i = 0; i < m_Spans.size(); ++i )
+	{
+		children[ m_Spans[i].m_ParentId ].push_back( i + 1 );
+	}
+
+	std::vector< size_t >::const_iterator iter = children[0].begin();
+	for( ; iter != children[0].end(); ++iter )
+	{
+		result << ( iter == children[0].begin() ? "" : "," );
+		WriteSpan( result, *iter, children );
+	}
+	result << "]}";
+	return result.str();
+}
+
+void RequestTrace::WriteSpan( std::ostream& o_rOutput, size_t i_SpanId, const std::vector< std::vector< size_t > >& i_rChildren ) const
+{
+	const Span& rSpan = m_Spans[ i_SpanId - 1 ];
+	o_rOutput << "{\"spanId\":" << i_SpanId << ",\"node\":";
+	WriteString( o_rOutput, rSpan.m_Node );
+	o_rOutput << ",\"operation\":";
+	WriteString( o_rOutput, rSpan.m_Operation );
+	o_rOutput << ",\"start\":" << rSpan.m_Start;
+	if( rSpan.m_End > 0 )
+	{
+		o_rOutput << ",\"end\":" << rSpan.m_End << ",\"result\":";
+		WriteString( o_rOutput, rSpan.m_Result );
+		o_rOutput << ",\"bytes\":" << rSpan.m_Bytes;
+	}
+	o_rOutput << ",\"children\":[";
+
+	const std::vector< size_t >& rChildren = i_rChildren[ i_SpanId ];
+	std::vector< size_t >::const_iterator iter = rChildren.begin();
+	for( ; iter != rChildren.end(); ++iter )
+	{
+		o_rOutput << ( iter == rChildren.begin() ? "" : "," );
+		WriteSpan( o_rOutput, *iter, i_rChildren );
+	}
+	o_rOutput << "]}";
+}
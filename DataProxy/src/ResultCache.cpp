@@ -0,0 +1,345 @@
+#include "ResultCache.hpp"
+#include "ClockUtilities.hpp"
+#include "MVLogger.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+	const std::string CACHE_FILE_TEMPLATE( "/dplCache.XXXXXX" );
+
+	bool WriteFully( int i_FileDescriptor, const char* i_pData, size_t i_Size )
+	{
+		while( i_Size > 0 )
+		{
+			ssize_t written = ::write( i_FileDescriptor, i_pData, i_Size );
+			if( written < 0 )
+			{
+				if( errno == EINTR )
+				{
+					continue;
+				}
+				return false;
+			}
+			i_pData += written;
+			i_Size -= written;
+		}
+		return true;
+	}
+
+	bool ReadFully( int i_FileDescriptor, char* o_pData, size_t i_Size )
+	{
+		while( i_Size > 0 )
+		{
+			ssize_t bytesRead = ::read( i_FileDescriptor, o_pData, i_Size );
+			if( bytesRead < 0 && errno == EINTR )
+			{
+				continue;
+			}
+			if( bytesRead <= 0 )
+			{
+				return false;
+			}
+			o_pData += bytesRead;
+			i_Size -= bytesRead;
+		}
+		return true;
+	}
+
+	boost::shared_ptr< const std::string > ReadCacheFile( const std::string& i_rFileName, size_t i_Size )
+	{
+		int fileDescriptor = ::open( i_rFileName.c_str(), O_RDONLY );
+		if( fileDescriptor < 0 )
+		{
+			MVLOGGER( "root.lib.DataProxy.ResultCache.ReadFromDisk.Error", "Unable to open cache file: " << i_rFileName << ": " << ::strerror( errno ) );
+			return boost::shared_ptr< const std::string >();
+		}
+		std::vector< char > buffer( i_Size );
+		bool success = buffer.empty() || ReadFully( fileDescriptor, &buffer[0], buffer.size() );
+		::close( fileDescriptor );
+		if( !success )
+		{
+			MVLOGGER( "root.lib.DataProxy.ResultCache.ReadFromDisk.Error", "Unable to read cache file: " << i_rFileName );
+			return boost::shared_ptr< const std::string >();
+		}
+		return boost::shared_ptr< const std::string >( new std::string( buffer.begin(), buffer.end() ) );
+	}
+
+	bool WriteCacheFile( const std::string& i_rWorkingDir, const std::string& i_rData, std::string& o_rFileName )
+	{
+		std::string fileName = i_rWorkingDir + CACHE_FILE_TEMPLATE;
+		std::vector< char > fileNameBuffer( fileName.begin(), fileName.end() );
+		fileNameBuffer.push_back( '\0' );
+		int fileDescriptor = ::mkstemp( &fileNameBuffer[0] );
+		if( fileDescriptor < 0 )
+		{
+			MVLOGGER( "root.lib.DataProxy.ResultCache.InsertOnDisk.Error", "Unable to create cache file in: " << i_rWorkingDir << ": " << ::strerror( errno ) );
+			return false;
+		}
+		o_rFileName = &fileNameBuffer[0];
+		bool success = WriteFully( fileDescriptor, i_rData.data(), i_rData.size() );
+		::close( fileDescriptor );
+		if( !success )
+		{
+			MVLOGGER( "root.lib.DataProxy.ResultCache.InsertOnDisk.Error", "Unable to write cache file: " << o_rFileName );
+			::unlink( o_rFileName.c_str() );
+			return false;
+		}
+		return true;
+	}
+
+	void UnlinkAll( const std::vector< std::string >& i_rFileNames )
+	{
+		std::vector< std::string >::const_iterator iter = i_rFileNames.begin();
+		for( ; iter != i_rFileNames.end(); ++iter )
+		{
+			::unlink( iter->c_str() );
+		}
+	}
+}
+
+ResultCache::Capture::Capture( std::string& o_rData, bool& o_rOverflowed, size_t i_Limit )
+:	m_pData( &o_rData ),
+	m_pOverflowed( &o_rOverflowed ),
+	m_Limit( i_Limit )
+{
+}
+
+std::streamsize ResultCache::Capture::write( const char* i_pData, std::streamsize i_Size )
+{
+	if( !*m_pOverflowed )
+	{
+		if( m_pData->size() + i_Size > m_Limit )
+		{
+			*m_pOverflowed = true;
+			std::string().swap( *m_pData );
+		}
+		else
+		{
+			m_pData->append( i_pData, i_Size );
+		}
+	}
+	return i_Size;
+}
+
+ResultCache::ResultCache( double i_TimeToLiveSeconds, size_t i_MaxBytes, const std::string& i_rWorkingDir, size_t i_MaxDiskBytes )
+:	m_TimeToLive( i_TimeToLiveSeconds ),
+	m_MaxBytes( i_MaxBytes ),
+	m_WorkingDir( i_rWorkingDir ),
+	m_MaxDiskBytes( i_MaxDiskBytes ),
+	m_Mutex(),
+	m_Memory(),
+	m_Disk(),
+	m_Generation( 0 )
+{
+}
+
+ResultCache::~ResultCache()
+{
+	DiskCache::Iterator iter = m_Disk.Begin();
+	for( ; iter != m_Disk.End(); ++iter )
+	{
+		::unlink( iter->m_Value.c_str() );
+	}
+}
+
+boost::shared_ptr< const std::string > ResultCache::Get( const std::string& i_rKey, size_t& o_rEvictions )
+{
+	o_rEvictions = 0;
+	std::string fileName;
+	size_t size;
+	double expiration;
+	size_t generation;
+	{
+		boost::unique_lock< boost::mutex > lock( m_Mutex );
+		double now = ClockUtilities::Now();
+
+		MemoryCache::Iterator memoryIter = m_Memory.Find( i_rKey );
+		if( memoryIter != m_Memory.End() )
+		{
+			if( memoryIter->m_Expiration <= now )
+			{
+				m_Memory.Remove( memoryIter );
+				return boost::shared_ptr< const std::string >();
+			}
+			m_Memory.Touch( memoryIter );
+			return memoryIter->m_Value;
+		}
+
+		DiskCache::Iterator diskIter = m_Disk.Find( i_rKey );
+		if( diskIter == m_Disk.End() )
+		{
+			return boost::shared_ptr< const std::string >();
+		}
+		// the entry leaves the disk tier either way; the file is this thread's to read & remove
+		size = diskIter->m_Size;
+		expiration = diskIter->m_Expiration;
+		generation = m_Generation;
+		fileName = RemoveFromDisk( diskIter );
+		if( expiration <= now )
+		{
+			lock.unlock();
+			::unlink( fileName.c_str() );
+			return boost::shared_ptr< const std::string >();
+		}
+	}
+
+	boost::shared_ptr< const std::string > pData = ReadCacheFile( fileName, size );
+	::unlink( fileName.c_str() );
+	if( !pData )
+	{
+		return pData;
+	}
+
+	Spills spills;
+	{
+		boost::unique_lock< boost::mutex > lock( m_Mutex );
+		// while the file was being read the key may have been stored again, or the cache cleared; either way the
+		// promoted entry is stale, though it is still an answer to this Get
+		if( generation == m_Generation && m_Memory.Find( i_rKey ) == m_Memory.End() && m_Disk.Find( i_rKey ) == m_Disk.End() )
+		{
+			o_rEvictions = InsertInMemory( i_rKey, pData, expiration, spills );
+		}
+	}
+	o_rEvictions += WriteToDisk( spills, generation );
+	return pData;
+}
+
+size_t ResultCache::Put( const std::string& i_rKey, const std::string& i_rData )
+{
+	return Put( i_rKey, i_rData, GetGeneration() );
+}
+
+size_t ResultCache::Put( const std::string& i_rKey, const std::string& i_rData, size_t i_Generation )
+{
+	if( i_rData.size() > GetMaxEntryBytes() )
+	{
+		return 0;
+	}
+	boost::shared_ptr< const std::string > pData( new std::string( i_rData ) );
+
+	std::vector< std::string > unlinks;
+	Spills spills;
+	size_t evictions( 0 );
+	{
+		boost::unique_lock< boost::mutex > lock( m_Mutex );
+		if( i_Generation != m_Generation )
+		{
+			return 0;
+		}
+		DiskCache::Iterator diskIter = m_Disk.Find( i_rKey );
+		if( diskIter != m_Disk.End() )
+		{
+			unlinks.push_back( RemoveFromDisk( diskIter ) );
+		}
+		evictions = InsertInMemory( i_rKey, pData, ClockUtilities::Now() + m_TimeToLive, spills );
+	}
+	UnlinkAll( unlinks );
+	return evictions + WriteToDisk( spills, i_Generation );
+}
+
+void ResultCache::Clear()
+{
+	std::vector< std::string > unlinks;
+	{
+		boost::unique_lock< boost::mutex > lock( m_Mutex );
+		++m_Generation;
+		while( m_Memory.Begin() != m_Memory.End() )
+		{
+			m_Memory.Remove( m_Memory.Begin() );
+		}
+		while( m_Disk.Begin() != m_Disk.End() )
+		{
+			unlinks.push_back( RemoveFromDisk( m_Disk.Begin() ) );
+		}
+	}
+	UnlinkAll( unlinks );
+}
+
+size_t ResultCache::GetGeneration()
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	return m_Generation;
+}
+
+size_t ResultCache::GetMaxEntryBytes() const
+{
+	return m_MaxBytes;
+}
+
+std::string ResultCache::MakeKey( const std::map< std::string, std::string >& i_rParameters )
+{
+	std::string result;
+	std::map< std::string, std::string >::const_iterator iter = i_rParameters.begin();
+	for( ; iter != i_rParameters.end(); ++iter )
+	{
+		MemoryCache::AppendKeyField( result, iter->first );
+		MemoryCache::AppendKeyField( result, iter->second );
+	}
+	return result;
+}
+
+size_t ResultCache::InsertInMemory( const std::string& i_rKey, boost::shared_ptr< const std::string > i_pData, double i_Expiration, Spills& o_rSpills )
+{
+	m_Memory.Insert( i_rKey, i_pData, i_pData->size(), i_Expiration );
+
+	size_t evictions( 0 );
+	double now = ClockUtilities::Now();
+	while( m_Memory.GetBytes() > m_MaxBytes )
+	{
+		MemoryCache::Iterator oldest = m_Memory.GetOldest();
+		++evictions;
+		if( !m_WorkingDir.empty() && oldest->m_Expiration > now && oldest->m_Size <= m_MaxDiskBytes )
+		{
+			o_rSpills.push_back( *oldest );
+		}
+		m_Memory.Remove( oldest );
+	}
+	return evictions;
+}
+
+size_t ResultCache::WriteToDisk( const Spills& i_rSpills, size_t i_Generation )
+{
+	size_t evictions( 0 );
+	Spills::const_iterator spillIter = i_rSpills.begin();
+	for( ; spillIter != i_rSpills.end(); ++spillIter )
+	{
+		std::string fileName;
+		if( !WriteCacheFile( m_WorkingDir, *spillIter->m_Value, fileName ) )
+		{
+			continue;
+		}
+
+		std::vector< std::string > unlinks;
+		{
+			boost::unique_lock< boost::mutex > lock( m_Mutex );
+			// while the file was being written the key may have been stored again, or the cache cleared
+			if( i_Generation != m_Generation || m_Memory.Find( spillIter->m_Key ) != m_Memory.End() || m_Disk.Find( spillIter->m_Key ) != m_Disk.End() )
+			{
+				unlinks.push_back( fileName );
+			}
+			else
+			{
+				m_Disk.Insert( spillIter->m_Key, fileName, spillIter->m_Size, spillIter->m_Expiration );
+				while( m_Disk.GetBytes() > m_MaxDiskBytes )
+				{
+					unlinks.push_back( RemoveFromDisk( m_Disk.GetOldest() ) );
+					++evictions;
+				}
+			}
+		}
+		UnlinkAll( unlinks );
+	}
+	return evictions;
+}
+
+std::string ResultCache::RemoveFromDisk( DiskCache::Iterator i_Iter )
+{
+	std::string fileName = i_Iter->m_Value;
+	m_Disk.Remove( i_Iter );
+	return fileName;
+}
@@ -301,6 +301,11 @@ void RouterNode::InsertImplDeleteForwards( std::set< std::string >& o_rForwards
 	}
 }
 
+bool RouterNode::StoreImplRewindsInput() const
+{
+	return m_WriteRoute.size() > 1;
+}
+
 void RouterNode::SetWriteDeleteConfig( const xercesc::DOMNode* i_pNode, CriticalErrorBehavior& o_rOnCriticalError, std::vector< RouteConfig >& o_rRoute )
 {
 	xercesc::DOMAttr* pErrorBehavior = XMLUtilities::GetAttribute( i_pNode, ON_CRITICAL_ERROR_ATTRIBUTE );
@@ -33,13 +33,25 @@ ShellStreamTransformer::~ShellStreamTransformer()
 boost::shared_ptr< std::istream > ShellStreamTransformer::TransformInput( boost::shared_ptr< std::istream > i_pInputStream, const std::map< std::string, std::string >& i_rParameters )
 {
 	std::large_stringstream* pResult( new std::large_stringstream() );
+	boost::shared_ptr< std::istream > pResultAsIstream( pResult );
+	TransformInput( *i_pInputStream, *pResult, i_rParameters );
+	return pResultAsIstream;
+}
+
+bool ShellStreamTransformer::SupportsStreaming() const
+{
+	return true;
+}
+
+void ShellStreamTransformer::TransformInput( std::istream& i_rInputStream, std::ostream& o_rOutputStream, const std::map< std::string, std::string >& i_rParameters )
+{
 	std::string command = TransformerUtilities::GetValue( COMMAND, i_rParameters );
 	double timeout = TransformerUtilities::GetValueAs< double >( TIMEOUT, i_rParameters );
 
 	std::large_stringstream standardError;
 	ShellExecutor executor( command );
 	MVLOGGER( "root.lib.DataProxy.DataProxyClient.StreamTransformers.Shell.TransformStream.ExecutingCommand", "Executing command: '" << command << "'" );
-	int status = executor.Run( timeout, *i_pInputStream, *pResult, standardError );
+	int status = executor.Run( timeout, i_rInputStream, o_rOutputStream, standardError );
 	standardError.flush();
 	if( status != 0 )
 	{
@@ -50,6 +62,5 @@ boost::shared_ptr< std::istream > ShellStreamTransformer::TransformInput( boost:
 		MVLOGGER( "root.lib.DataProxy.DataProxyClient.StreamTransformers.Shell.TransformStream.StandardError",
 			"Command: '" << command << "' generated standard error output: " << standardError.rdbuf() );
 	}
-	pResult->flush();
-	return boost::shared_ptr< std::istream >( pResult );
+	o_rOutputStream.flush();
 }
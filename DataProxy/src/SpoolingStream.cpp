@@ -0,0 +1,222 @@
+#include "SpoolingStream.hpp"
+#include "MVLogger.hpp"
+#include <algorithm>
+#include <exception>
+#include <ios>
+
+namespace
+{
+	const size_t READ_BLOCK_SIZE( 64 * 1024 );
+}
+
+SpoolingStreamBuffer::SpoolingStreamBuffer( std::istream& i_rOwner, std::istream& i_rSource, size_t i_MemoryLimit, const std::string& i_rWorkingDir )
+:	std::streambuf(),
+	m_rOwner( i_rOwner ),
+	m_rSource( i_rSource ),
+	m_SourceExhausted( false ),
+	m_Spool( i_MemoryLimit, i_rWorkingDir ),
+	m_SpooledSize( 0 ),
+	m_SpoolBroken( false ),
+	m_GetBuffer( READ_BLOCK_SIZE ),
+	m_GetAreaOffset( 0 )
+{
+	setg( &m_GetBuffer[0], &m_GetBuffer[0], &m_GetBuffer[0] );
+}
+
+SpoolingStreamBuffer::~SpoolingStreamBuffer()
+{
+}
+
+bool SpoolingStreamBuffer::IsSpilled() const
+{
+	return m_Spool.IsSpilled();
+}
+
+size_t SpoolingStreamBuffer::GetSpilledBytes() const
+{
+	return m_Spool.GetSpilledBytes();
+}
+
+SpoolingStreamBuffer::int_type SpoolingStreamBuffer::underflow()
+{
+	if( gptr() < egptr() )
+	{
+		return traits_type::to_int_type( *gptr() );
+	}
+
+	size_t readPosition = GetReadPosition();
+	char* pBase = &m_GetBuffer[0];
+	m_GetAreaOffset = readPosition;
+	setg( pBase, pBase, pBase );
+
+	if( readPosition < m_SpooledSize )
+	{
+		// re-reading data we already have
+		CheckSpool( readPosition );
+		size_t size = std::min( m_GetBuffer.size(), m_SpooledSize - readPosition );
+		m_Spool.clear();
+		m_Spool.seekg( readPosition );
+		m_Spool.read( pBase, size );
+		if( size_t( m_Spool.gcount() ) != size )
+		{
+			MV_THROW( SpoolingStreamException, "Unable to read back " << size << " spooled bytes at position " << readPosition );
+		}
+		setg( pBase, pBase, pBase + size );
+	}
+	else
+	{
+		ReadSource();
+	}
+
+	if( gptr() < egptr() )
+	{
+		return traits_type::to_int_type( *gptr() );
+	}
+	return traits_type::eof();
+}
+
+SpoolingStreamBuffer::pos_type SpoolingStreamBuffer::seekoff( off_type i_Offset, std::ios_base::seekdir i_Direction, std::ios_base::openmode i_Mode )
+{
+	if( i_Mode & std::ios_base::out )
+	{
+		return pos_type( off_type( -1 ) );
+	}
+
+	// reporting the position is by far the most common case; don't disturb the get area for it
+	if( i_Direction == std::ios_base::cur && i_Offset == 0 )
+	{
+		return pos_type( off_type( GetReadPosition() ) );
+	}
+
+	off_type base = 0;
+	if( i_Direction == std::ios_base::cur )
+	{
+		base = GetReadPosition();
+	}
+	else if( i_Direction == std::ios_base::end )
+	{
+		// the end isn't known until the whole source has been spooled
+		while( ReadSource() )
+		{
+		}
+		base = m_SpooledSize;
+	}
+	return seekpos( pos_type( base + i_Offset ), i_Mode );
+}
+
+SpoolingStreamBuffer::pos_type SpoolingStreamBuffer::seekpos( pos_type i_Position, std::ios_base::openmode i_Mode )
+{
+	off_type position = off_type( i_Position );
+	if( ( i_Mode & std::ios_base::out ) || position < 0 )
+	{
+		return pos_type( off_type( -1 ) );
+	}
+
+	// positions past what has been read so far can only be reached by reading up to them
+	while( size_t( position ) > m_SpooledSize && ReadSource() )
+	{
+	}
+	if( size_t( position ) > m_SpooledSize )
+	{
+		return pos_type( off_type( -1 ) );
+	}
+
+	CheckSpool( position );
+
+	// force the next read to come from the spool (or the source, at the end of it)
+	m_GetAreaOffset = position;
+	setg( &m_GetBuffer[0], &m_GetBuffer[0], &m_GetBuffer[0] );
+	return pos_type( position );
+}
+
+size_t SpoolingStreamBuffer::GetReadPosition() const
+{
+	return m_GetAreaOffset + ( gptr() - eback() );
+}
+
+void SpoolingStreamBuffer::CheckSpool( size_t i_Position ) const
+{
+	if( m_SpoolBroken && i_Position < m_SpooledSize )
+	{
+		MV_THROW( SpoolingStreamException, "Unable to return to position " << i_Position
+			<< ": the spool could not be written past some of the first " << m_SpooledSize << " bytes" );
+	}
+}
+
+bool SpoolingStreamBuffer::ReadSource()
+{
+	if( m_SourceExhausted )
+	{
+		return false;
+	}
+
+	char* pBase = &m_GetBuffer[0];
+	// reading through the stream rather than its buffer leaves a source that fails marked bad, for its owner to see
+	m_rSource.read( pBase, m_GetBuffer.size() );
+	std::streamsize bytesRead = m_rSource.gcount();
+	if( bytesRead <= 0 )
+	{
+		// a failed source isn't the end of the data: a retry that rewinds the spool would otherwise store
+		// what was read before the failure as if it were all of it
+		if( m_rSource.bad() )
+		{
+			throw std::ios_base::failure( "Error reading the spooled source" );
+		}
+		m_SourceExhausted = true;
+		return false;
+	}
+
+	if( !m_SpoolBroken && !m_Spool.write( pBase, bytesRead ) )
+	{
+		// what's in the get area is still good, so the current pass can go on; only going back can't
+		MVLOGGER( "root.lib.DataProxy.SpoolingStream.ReadSource.Warning", "Unable to spool " << bytesRead
+			<< " bytes at position " << m_SpooledSize << "; the stream can no longer be rewound" );
+		m_SpoolBroken = true;
+		// the exception has to get past the istream, which otherwise swallows it into badbit
+		m_rOwner.exceptions( m_rOwner.exceptions() | std::ios_base::badbit );
+	}
+	m_GetAreaOffset = m_SpooledSize;
+	m_SpooledSize += bytesRead;
+	setg( pBase, pBase, pBase + bytesRead );
+	return true;
+}
+
+SpoolingStream::SpoolingStream( std::istream& i_rSource, size_t i_MemoryLimit, const std::string& i_rWorkingDir )
+:	std::istream( NULL ),
+	m_Buffer( *this, i_rSource, i_MemoryLimit, i_rWorkingDir )
+{
+	init( &m_Buffer );
+	// a source that throws when it fails (e.g. a decompressor on a corrupt body) throws through the spool too
+	exceptions( i_rSource.exceptions() & std::ios_base::badbit );
+}
+
+SpoolingStream::~SpoolingStream()
+{
+}
+
+bool SpoolingStream::IsSpilled() const
+{
+	return m_Buffer.IsSpilled();
+}
+
+size_t SpoolingStream::GetSpilledBytes() const
+{
+	return m_Buffer.GetSpilledBytes();
+}
+
+bool SpoolingStream::IsSeekable( std::istream& i_rStream )
+{
+	if( i_rStream.rdbuf() == NULL )
+	{
+		return false;
+	}
+	// some buffers (e.g. boost::iostreams chains over a source) throw instead of reporting failure
+	try
+	{
+		return i_rStream.rdbuf()->pubseekoff( 0, std::ios_base::cur, std::ios_base::in ) != std::streampos( -1 );
+	}
+	catch( const std::exception& )
+	{
+		return false;
+	}
+}
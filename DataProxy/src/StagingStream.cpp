@@ -0,0 +1,375 @@
+#include "StagingStream.hpp"
+#include "MVLogger.hpp"
+#include <algorithm>
+#include <limits>
+#include <unistd.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+
+namespace
+{
+	const size_t INITIAL_MEMORY_SIZE( 64 * 1024 );
+	const size_t FILE_BUFFER_SIZE( 256 * 1024 );
+	const std::string STAGING_FILE_TEMPLATE( "/dplStaging.XXXXXX" );
+
+	bool WriteFully( int i_FileDescriptor, const char* i_pData, size_t i_Size, size_t i_Offset )
+	{
+		while( i_Size > 0 )
+		{
+			ssize_t written = ::pwrite( i_FileDescriptor, i_pData, i_Size, i_Offset );
+			if( written < 0 )
+			{
+				if( errno == EINTR )
+				{
+					continue;
+				}
+				return false;
+			}
+			i_pData += written;
+			i_Size -= written;
+			i_Offset += written;
+		}
+		return true;
+	}
+
+	ssize_t ReadSome( int i_FileDescriptor, char* o_pData, size_t i_Size, size_t i_Offset )
+	{
+		ssize_t bytesRead;
+		do
+		{
+			bytesRead = ::pread( i_FileDescriptor, o_pData, i_Size, i_Offset );
+		}
+		while( bytesRead < 0 && errno == EINTR );
+		return bytesRead;
+	}
+}
+
+StagingStreamBuffer::StagingStreamBuffer( size_t i_MemoryLimit, const std::string& i_rWorkingDir )
+:	std::streambuf(),
+	m_MemoryLimit( i_MemoryLimit ),
+	m_WorkingDir( i_rWorkingDir ),
+	m_Memory(),
+	m_FileDescriptor( -1 ),
+	m_FileSize( 0 ),
+	m_GetAreaOffset( 0 ),
+	m_PutBuffer(),
+	m_GetBuffer(),
+	m_SpilledBytes( 0 )
+{
+}
+
+StagingStreamBuffer::~StagingStreamBuffer()
+{
+	CloseFile();
+}
+
+void StagingStreamBuffer::Reset()
+{
+	CloseFile();
+	m_FileSize = 0;
+	m_GetAreaOffset = 0;
+
+	// hold on to whatever memory we already have; a retry will likely need just as much
+	char* pBase = MemoryBase();
+	SetPutArea( pBase, pBase + m_Memory.size(), 0 );
+	setg( pBase, pBase, pBase );
+}
+
+bool StagingStreamBuffer::IsSpilled() const
+{
+	return m_FileDescriptor >= 0;
+}
+
+size_t StagingStreamBuffer::GetSpilledBytes() const
+{
+	return m_SpilledBytes;
+}
+
+std::streamsize StagingStreamBuffer::xsputn( const char* i_pData, std::streamsize i_Size )
+{
+	// large writes to a spilled buffer skip the put area altogether
+	if( !IsSpilled() || size_t( i_Size ) < m_PutBuffer.size() )
+	{
+		return std::streambuf::xsputn( i_pData, i_Size );
+	}
+
+	if( !FlushPutArea() || !WriteFully( m_FileDescriptor, i_pData, i_Size, m_FileSize ) )
+	{
+		return 0;
+	}
+	m_FileSize += i_Size;
+	m_SpilledBytes += i_Size;
+	return i_Size;
+}
+
+StagingStreamBuffer::int_type StagingStreamBuffer::overflow( int_type i_Char )
+{
+	if( traits_type::eq_int_type( i_Char, traits_type::eof() ) )
+	{
+		return traits_type::not_eof( i_Char );
+	}
+
+	if( !IsSpilled() && !GrowMemory() && !Spill() )
+	{
+		// if we can't get to disk, the best we can do is carry on in memory
+		m_MemoryLimit = std::numeric_limits< size_t >::max();
+		GrowMemory();
+	}
+
+	if( IsSpilled() && !FlushPutArea() )
+	{
+		return traits_type::eof();
+	}
+
+	*pptr() = traits_type::to_char_type( i_Char );
+	pbump( 1 );
+	return i_Char;
+}
+
+StagingStreamBuffer::int_type StagingStreamBuffer::underflow()
+{
+	if( gptr() < egptr() )
+	{
+		return traits_type::to_int_type( *gptr() );
+	}
+
+	size_t readPosition = GetReadPosition();
+	if( !IsSpilled() )
+	{
+		// the readable area of memory is simply everything written so far
+		char* pBase = MemoryBase();
+		setg( pBase, pBase + readPosition, pptr() );
+	}
+	else
+	{
+		char* pBase = &m_GetBuffer[0];
+		m_GetAreaOffset = readPosition;
+		setg( pBase, pBase, pBase );
+
+		if( !FlushPutArea() )
+		{
+			return traits_type::eof();
+		}
+		ssize_t bytesRead = ReadSome( m_FileDescriptor, pBase, m_GetBuffer.size(), readPosition );
+		if( bytesRead > 0 )
+		{
+			setg( pBase, pBase, pBase + bytesRead );
+		}
+	}
+
+	if( gptr() < egptr() )
+	{
+		return traits_type::to_int_type( *gptr() );
+	}
+	return traits_type::eof();
+}
+
+int StagingStreamBuffer::sync()
+{
+	if( IsSpilled() && !FlushPutArea() )
+	{
+		return -1;
+	}
+	return 0;
+}
+
+StagingStreamBuffer::pos_type StagingStreamBuffer::seekoff( off_type i_Offset, std::ios_base::seekdir i_Direction, std::ios_base::openmode i_Mode )
+{
+	// data is only ever appended, so the only position that can be reported for writing is the end
+	if( i_Mode & std::ios_base::out )
+	{
+		if( ( i_Mode & std::ios_base::in ) || i_Offset != 0 || i_Direction == std::ios_base::beg )
+		{
+			return pos_type( off_type( -1 ) );
+		}
+		return pos_type( off_type( GetWrittenSize() ) );
+	}
+
+	off_type base = 0;
+	if( i_Direction == std::ios_base::cur )
+	{
+		base = GetReadPosition();
+	}
+	else if( i_Direction == std::ios_base::end )
+	{
+		base = GetWrittenSize();
+	}
+	return seekpos( pos_type( base + i_Offset ), i_Mode );
+}
+
+StagingStreamBuffer::pos_type StagingStreamBuffer::seekpos( pos_type i_Position, std::ios_base::openmode i_Mode )
+{
+	off_type position = off_type( i_Position );
+	if( ( i_Mode & std::ios_base::out ) )
+	{
+		if( ( i_Mode & std::ios_base::in ) || position != off_type( GetWrittenSize() ) )
+		{
+			return pos_type( off_type( -1 ) );
+		}
+		return i_Position;
+	}
+
+	if( position < 0 || size_t( position ) > GetWrittenSize() )
+	{
+		return pos_type( off_type( -1 ) );
+	}
+
+	if( !IsSpilled() )
+	{
+		char* pBase = MemoryBase();
+		setg( pBase, pBase + position, pptr() );
+	}
+	else
+	{
+		// force the next read to come from the file
+		char* pBase = &m_GetBuffer[0];
+		m_GetAreaOffset = position;
+		setg( pBase, pBase, pBase );
+	}
+	return pos_type( position );
+}
+
+char* StagingStreamBuffer::MemoryBase()
+{
+	return m_Memory.empty() ? NULL : &m_Memory[0];
+}
+
+size_t StagingStreamBuffer::GetWrittenSize() const
+{
+	size_t pending = pptr() - pbase();
+	return IsSpilled() ? m_FileSize + pending : pending;
+}
+
+size_t StagingStreamBuffer::GetReadPosition() const
+{
+	size_t position = gptr() - eback();
+	return IsSpilled() ? m_GetAreaOffset + position : position;
+}
+
+void StagingStreamBuffer::SetPutArea( char* i_pBegin, char* i_pEnd, size_t i_Used )
+{
+	setp( i_pBegin, i_pEnd );
+	// pbump only takes an int
+	while( i_Used > 0 )
+	{
+		int step = int( std::min( i_Used, size_t( std::numeric_limits< int >::max() ) ) );
+		pbump( step );
+		i_Used -= step;
+	}
+}
+
+bool StagingStreamBuffer::GrowMemory()
+{
+	size_t writtenSize = GetWrittenSize();
+	if( writtenSize >= m_MemoryLimit )
+	{
+		return false;
+	}
+	size_t readPosition = GetReadPosition();
+
+	size_t newSize = std::min( std::max( writtenSize * 2, INITIAL_MEMORY_SIZE ), m_MemoryLimit );
+	m_Memory.resize( newSize );
+
+	char* pBase = MemoryBase();
+	SetPutArea( pBase, pBase + newSize, writtenSize );
+	setg( pBase, pBase + readPosition, pBase + writtenSize );
+	return true;
+}
+
+bool StagingStreamBuffer::Spill()
+{
+	size_t writtenSize = GetWrittenSize();
+	size_t readPosition = GetReadPosition();
+
+	std::string fileSpec( m_WorkingDir + STAGING_FILE_TEMPLATE );
+	std::vector< char > fileSpecBuffer( fileSpec.begin(), fileSpec.end() );
+	fileSpecBuffer.push_back( '\0' );
+
+	int fileDescriptor = ::mkstemp( &fileSpecBuffer[0] );
+	if( fileDescriptor < 0 )
+	{
+		MVLOGGER( "root.lib.DataProxy.StagingStream.Spill.Warning", "Unable to create staging file in: " << m_WorkingDir
+			<< ": " << strerror( errno ) << ". Continuing to stage data in memory" );
+		return false;
+	}
+	// nobody else needs to see the file, and this way it can never be left behind
+	::unlink( &fileSpecBuffer[0] );
+
+	if( !WriteFully( fileDescriptor, MemoryBase(), writtenSize, 0 ) )
+	{
+		MVLOGGER( "root.lib.DataProxy.StagingStream.Spill.Warning", "Unable to write staging file in: " << m_WorkingDir
+			<< ": " << strerror( errno ) << ". Continuing to stage data in memory" );
+		::close( fileDescriptor );
+		return false;
+	}
+
+	MVLOGGER( "root.lib.DataProxy.StagingStream.Spill.Info", "Staged data exceeded the memory limit of " << m_MemoryLimit
+		<< " bytes; spilling to a file in: " << m_WorkingDir );
+
+	m_FileDescriptor = fileDescriptor;
+	m_FileSize = writtenSize;
+	m_SpilledBytes += writtenSize;
+	std::vector< char >().swap( m_Memory );
+
+	m_PutBuffer.resize( FILE_BUFFER_SIZE );
+	m_GetBuffer.resize( FILE_BUFFER_SIZE );
+	SetPutArea( &m_PutBuffer[0], &m_PutBuffer[0] + m_PutBuffer.size(), 0 );
+	m_GetAreaOffset = readPosition;
+	setg( &m_GetBuffer[0], &m_GetBuffer[0], &m_GetBuffer[0] );
+	return true;
+}
+
+bool StagingStreamBuffer::FlushPutArea()
+{
+	size_t pending = pptr() - pbase();
+	if( pending > 0 )
+	{
+		if( !WriteFully( m_FileDescriptor, pbase(), pending, m_FileSize ) )
+		{
+			MVLOGGER( "root.lib.DataProxy.StagingStream.Write.Error", "Unable to write to staging file in: " << m_WorkingDir
+				<< ": " << strerror( errno ) );
+			return false;
+		}
+		m_FileSize += pending;
+		m_SpilledBytes += pending;
+	}
+	SetPutArea( &m_PutBuffer[0], &m_PutBuffer[0] + m_PutBuffer.size(), 0 );
+	return true;
+}
+
+void StagingStreamBuffer::CloseFile()
+{
+	if( m_FileDescriptor >= 0 )
+	{
+		::close( m_FileDescriptor );
+		m_FileDescriptor = -1;
+	}
+}
+
+StagingStream::StagingStream( size_t i_MemoryLimit, const std::string& i_rWorkingDir )
+:	std::iostream( NULL ),
+	m_Buffer( i_MemoryLimit, i_rWorkingDir )
+{
+	init( &m_Buffer );
+}
+
+StagingStream::~StagingStream()
+{
+}
+
+void StagingStream::Reset()
+{
+	m_Buffer.Reset();
+	clear();
+}
+
+bool StagingStream::IsSpilled() const
+{
+	return m_Buffer.IsSpilled();
+}
+
+size_t StagingStream::GetSpilledBytes() const
+{
+	return m_Buffer.GetSpilledBytes();
+}
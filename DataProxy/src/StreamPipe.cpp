@@ -0,0 +1,121 @@
+#include "StreamPipe.hpp"
+#include <algorithm>
+#include <string.h>
+
+StreamPipe::StreamPipe( size_t i_Capacity )
+:	m_Mutex(),
+	m_NotEmpty(),
+	m_NotFull(),
+	m_Buffer( std::max( i_Capacity, size_t( 1 ) ) ),
+	m_Begin( 0 ),
+	m_Size( 0 ),
+	m_WriteClosed( false ),
+	m_WriteAborted( false ),
+	m_ReadClosed( false )
+{
+}
+
+StreamPipe::~StreamPipe()
+{
+}
+
+void StreamPipe::Write( const char* i_pData, size_t i_Size )
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	while( i_Size > 0 )
+	{
+		while( m_Size == m_Buffer.size() && !m_ReadClosed )
+		{
+			m_NotFull.wait( lock );
+		}
+		if( m_ReadClosed )
+		{
+			MV_THROW( StreamPipeException, "Attempted to write to a pipe whose read end has been closed" );
+		}
+		if( m_WriteClosed )
+		{
+			MV_THROW( StreamPipeException, "Attempted to write to a pipe whose write end has been closed" );
+		}
+
+		// copy as much as will fit contiguously after the current end of the data
+		size_t end = ( m_Begin + m_Size ) % m_Buffer.size();
+		size_t bytes = std::min( i_Size, std::min( m_Buffer.size() - m_Size, m_Buffer.size() - end ) );
+		::memcpy( &m_Buffer[ end ], i_pData, bytes );
+		m_Size += bytes;
+		i_pData += bytes;
+		i_Size -= bytes;
+		m_NotEmpty.notify_one();
+	}
+}
+
+size_t StreamPipe::Read( char* o_pData, size_t i_Size )
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	while( m_Size == 0 && !m_WriteClosed && !m_ReadClosed )
+	{
+		m_NotEmpty.wait( lock );
+	}
+	if( m_ReadClosed )
+	{
+		return 0;
+	}
+	if( m_WriteAborted )
+	{
+		MV_THROW( StreamPipeException, "The writer to this pipe failed before completing the stream" );
+	}
+
+	size_t bytes = std::min( i_Size, std::min( m_Size, m_Buffer.size() - m_Begin ) );
+	if( bytes > 0 )
+	{
+		::memcpy( o_pData, &m_Buffer[ m_Begin ], bytes );
+		m_Begin = ( m_Begin + bytes ) % m_Buffer.size();
+		m_Size -= bytes;
+		m_NotFull.notify_one();
+	}
+	return bytes;
+}
+
+void StreamPipe::CloseWrite()
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	m_WriteClosed = true;
+	m_NotEmpty.notify_all();
+}
+
+void StreamPipe::AbortWrite()
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	m_WriteClosed = true;
+	m_WriteAborted = true;
+	m_NotEmpty.notify_all();
+}
+
+void StreamPipe::CloseRead()
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	m_ReadClosed = true;
+	m_NotFull.notify_all();
+	m_NotEmpty.notify_all();
+}
+
+StreamPipeSource::StreamPipeSource( StreamPipe& i_rPipe )
+:	m_pPipe( &i_rPipe )
+{
+}
+
+std::streamsize StreamPipeSource::read( char* o_pData, std::streamsize i_Size )
+{
+	size_t bytes = m_pPipe->Read( o_pData, i_Size );
+	return bytes == 0 ? -1 : std::streamsize( bytes );
+}
+
+StreamPipeSink::StreamPipeSink( StreamPipe& i_rPipe )
+:	m_pPipe( &i_rPipe )
+{
+}
+
+std::streamsize StreamPipeSink::write( const char* i_pData, std::streamsize i_Size )
+{
+	m_pPipe->Write( i_pData, i_Size );
+	return i_Size;
+}
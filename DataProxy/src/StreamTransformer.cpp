@@ -17,6 +17,8 @@
 #include "Stopwatch.hpp"
 #include "TransformFunctionDomain.hpp"
 #include "ITransformFunction.hpp"
+#include "StreamPipe.hpp"
+#include "LargeStringStream.hpp"
 #include <dlfcn.h>
 #include <xercesc/dom/DOM.hpp>
 #include <xercesc/util/PlatformUtils.hpp>
@@ -24,6 +26,7 @@
 #include <xercesc/sax/HandlerBase.hpp>
 #include <xercesc/framework/LocalFileFormatTarget.hpp>
 #include <boost/algorithm/string/replace.hpp>
+#include <boost/iostreams/copy.hpp>
 #include <sstream>
 
 namespace
@@ -155,6 +158,45 @@ boost::shared_ptr< std::istream > StreamTransformer::TransformStream( const std:
 	return pStream;
 }
 
+void StreamTransformer::TransformStream( const std::map< std::string, std::string >& i_rParameters, std::istream& i_rInput, std::ostream& o_rOutput ) const
+{
+	if( !SupportsStreaming() )
+	{
+		std::large_stringstream* pInput( new std::large_stringstream() );
+		boost::shared_ptr< std::istream > pInputAsIstream( pInput );
+		boost::iostreams::copy( i_rInput, *pInput );
+		boost::iostreams::copy( *TransformStream( i_rParameters, pInputAsIstream ), o_rOutput );
+		return;
+	}
+
+	std::map< std::string, std::string > parameters; 
+	EvaluateParameters( i_rParameters, parameters );
+	Stopwatch stopwatch;
+
+	try
+	{
+		m_pTransformFunction->TransformInput( i_rInput, o_rOutput, parameters );
+	}
+	catch( const StreamPipeException& )
+	{
+		// the next transformer has stopped reading; it will report its own error
+		throw;
+	}
+	catch( const std::exception& e )
+	{
+		MV_THROW( StreamTransformerException, "Caught exception: " << e.what() << " while executing " << m_Description
+												<< " with parameters: " << ProxyUtilities::ToString( parameters )
+												<< " after " << stopwatch.GetElapsedMilliseconds() << " milliseconds" );
+	}
+	MVLOGGER( "root.lib.DataProxy.StreamTransformer.TransformStream.Complete",
+		"Finished executing " << m_Description << " after " << stopwatch.GetElapsedMilliseconds() << " milliseconds" );
+}
+
+bool StreamTransformer::SupportsStreaming() const
+{
+	return m_pTransformFunction->SupportsStreaming();
+}
+
 void StreamTransformer::SwapTransformFunctionDomain( boost::scoped_ptr< ITransformFunctionDomain >& i_pSwapDomain )
 {
 	s_pTransformFunctionDomain.swap( i_pSwapDomain );
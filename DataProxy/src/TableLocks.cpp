@@ -0,0 +1,46 @@
+#include "TableLocks.hpp"
+
+TableLocks::TableLocks()
+:	m_Mutex(),
+	m_Locks()
+{
+}
+
+TableLocks::~TableLocks()
+{
+}
+
+TableLocks::Lock::Lock( TableLocks& i_rLocks, const std::string& i_rTable )
+:	m_rLocks( i_rLocks ),
+	m_Table( i_rTable ),
+	m_pMutex()
+{
+	{
+		boost::unique_lock< boost::mutex > lock( m_rLocks.m_Mutex );
+		boost::shared_ptr< boost::mutex >& rpMutex = m_rLocks.m_Locks[ m_Table ];
+		if( !rpMutex )
+		{
+			rpMutex.reset( new boost::mutex() );
+		}
+		m_pMutex = rpMutex;
+	}
+	m_pMutex->lock();
+}
+
+TableLocks::Lock::~Lock()
+{
+	m_pMutex->unlock();
+
+	// references are only taken under the mutex, so if the map's is the only other one, nobody else wants the table
+	boost::unique_lock< boost::mutex > lock( m_rLocks.m_Mutex );
+	if( m_pMutex.use_count() == 2 )
+	{
+		m_rLocks.m_Locks.erase( m_Table );
+	}
+}
+
+size_t TableLocks::GetSize() const
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	return m_Locks.size();
+}
@@ -15,14 +15,77 @@
 #include "StreamTransformer.hpp"
 #include "DPLCommon.hpp"
 #include "MVLogger.hpp"
+#include "StreamPipe.hpp"
+#include "LargeStringStream.hpp"
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <exception>
 
 namespace
 {
 	const std::string STREAM_TRANSFORMER_NODE( "StreamTransformer" );
+	const std::string PIPELINED_ATTRIBUTE( "pipelined" );
+	const std::string PIPE_SIZE_ATTRIBUTE( "pipeSize" );
+
+	const size_t DEFAULT_PIPE_SIZE( 1024 * 1024 );
+
+	// runs one transformer of a pipeline on its own thread, reading from the previous transformer's pipe (if any)
+	// and writing into its own. once done, successful or not, the neighbors are told so they don't block forever
+	void RunStage( const StreamTransformer& i_rTransformer,
+				   const std::map< std::string, std::string >& i_rParameters,
+				   std::istream& i_rInput,
+				   StreamPipe* i_pInputPipe,
+				   StreamPipe& i_rOutputPipe,
+				   std::exception_ptr& o_rError )
+	{
+		try
+		{
+			StreamPipeSink sink( i_rOutputPipe );
+			boost::iostreams::stream< StreamPipeSink > output( sink );
+			i_rTransformer.TransformStream( i_rParameters, i_rInput, output );
+			output.flush();
+		}
+		catch( ... )
+		{
+			o_rError = std::current_exception();
+		}
+
+		if( i_pInputPipe != NULL )
+		{
+			i_pInputPipe->CloseRead();
+		}
+		i_rOutputPipe.CloseWrite();
+	}
 
+	// a transformer failing to write into a closed pipe is only a consequence of the transformer after it
+	// having stopped reading, which is either that transformer's own error, or perfectly legitimate
+	void RethrowFirstError( const std::vector< std::exception_ptr >& i_rErrors )
+	{
+		std::vector< std::exception_ptr >::const_iterator iter = i_rErrors.begin();
+		for( ; iter != i_rErrors.end(); ++iter )
+		{
+			if( *iter == NULL )
+			{
+				continue;
+			}
+			try
+			{
+				std::rethrow_exception( *iter );
+			}
+			catch( const StreamPipeException& )
+			{
+			}
+		}
+	}
 }
 
 TransformerManager::TransformerManager( const xercesc::DOMNode& i_rNode )
+:	m_Transformers(),
+	m_Pipelined( false ),
+	m_PipeSize( DEFAULT_PIPE_SIZE )
 {
 	xercesc::DOMNode* pTranformersNode = XMLUtilities::TryGetSingletonChildByName( &i_rNode, TRANSFORMERS_NODE );
 	if( pTranformersNode == NULL )
@@ -30,7 +93,25 @@ TransformerManager::TransformerManager( const xercesc::DOMNode& i_rNode )
 	        return;
 	}
 
-	XMLUtilities::ValidateAttributes( pTranformersNode, std::set< std::string >() );
+	std::set< std::string > allowedAttributes;
+	allowedAttributes.insert( PIPELINED_ATTRIBUTE );
+	allowedAttributes.insert( PIPE_SIZE_ATTRIBUTE );
+	XMLUtilities::ValidateAttributes( pTranformersNode, allowedAttributes );
+
+	xercesc::DOMAttr* pAttribute = XMLUtilities::GetAttribute( pTranformersNode, PIPELINED_ATTRIBUTE );
+	if( pAttribute != NULL && XMLUtilities::XMLChToString( pAttribute->getValue() ) == "true" )
+	{
+		m_Pipelined = true;
+	}
+	pAttribute = XMLUtilities::GetAttribute( pTranformersNode, PIPE_SIZE_ATTRIBUTE );
+	if( pAttribute != NULL )
+	{
+		m_PipeSize = boost::lexical_cast< size_t >( XMLUtilities::XMLChToString( pAttribute->getValue() ) );
+		if( m_PipeSize == 0 )
+		{
+			MV_THROW( TransformerManagerException, "Attribute: " << PIPE_SIZE_ATTRIBUTE << " must be greater than 0" );
+		}
+	}
 
 	std::set< std::string > allowedChildren;
 	allowedChildren.insert( STREAM_TRANSFORMER_NODE );
@@ -65,12 +146,20 @@ boost::shared_ptr<std::istream> TransformerManager::TransformStream( const std::
 		return pResult;
 	}
 	
-	MVLOGGER( "root.lib.DataProxy.TransformerManager.TransformStream.Begin", "Beginning transformation of stream via " << m_Transformers.size() << " stream transformers" );
-	std::vector< boost::shared_ptr< StreamTransformer > >::const_iterator transformerIter = m_Transformers.begin();
+	MVLOGGER( "root.lib.DataProxy.TransformerManager.TransformStream.Begin", "Beginning " << ( m_Pipelined ? "pipelined " : "" )
+		<< "transformation of stream via " << m_Transformers.size() << " stream transformers" );
 	Stopwatch stopwatch;
-	for( ; transformerIter != m_Transformers.end() ; ++transformerIter )
+	if( m_Pipelined && m_Transformers.size() > 1 )
+	{
+		pResult = TransformStreamPipelined( i_rParameters, i_pData );
+	}
+	else
 	{
-		pResult = (*transformerIter)->TransformStream( i_rParameters, pResult );
+		std::vector< boost::shared_ptr< StreamTransformer > >::const_iterator transformerIter = m_Transformers.begin();
+		for( ; transformerIter != m_Transformers.end() ; ++transformerIter )
+		{
+			pResult = (*transformerIter)->TransformStream( i_rParameters, pResult );
+		}
 	}
 	MVLOGGER( "root.lib.DataProxy.TransformerManager.TransformStream.Complete",
 		"All transformers complete after " << stopwatch.GetElapsedMilliseconds() << " milliseconds" );
@@ -78,6 +167,70 @@ boost::shared_ptr<std::istream> TransformerManager::TransformStream( const std::
 	return pResult;
 }
 
+boost::shared_ptr<std::istream> TransformerManager::TransformStreamPipelined( const std::map< std::string, std::string >& i_rParameters,
+        boost::shared_ptr< std::istream > i_pData ) const
+{
+	// every transformer but the last runs on its own thread, writing into a pipe read by the next one
+	size_t lastStage = m_Transformers.size() - 1;
+	std::vector< boost::shared_ptr< StreamPipe > > pipes;
+	std::vector< boost::shared_ptr< std::istream > > pipeReaders;
+	for( size_t i = 0; i < lastStage; ++i )
+	{
+		pipes.push_back( boost::shared_ptr< StreamPipe >( new StreamPipe( m_PipeSize ) ) );
+		StreamPipeSource source( *pipes.back() );
+		pipeReaders.push_back( boost::shared_ptr< std::istream >( new boost::iostreams::stream< StreamPipeSource >( source ) ) );
+	}
+
+	std::vector< std::exception_ptr > errors( m_Transformers.size() );
+	boost::shared_ptr< std::istream > pResult;
+	boost::thread_group stages;
+	try
+	{
+		for( size_t i = 0; i < lastStage; ++i )
+		{
+			stages.create_thread( boost::bind( &RunStage,
+											   boost::cref( *m_Transformers[i] ),
+											   boost::cref( i_rParameters ),
+											   boost::ref( i == 0 ? *i_pData : *pipeReaders[i-1] ),
+											   i == 0 ? NULL : pipes[i-1].get(),
+											   boost::ref( *pipes[i] ),
+											   boost::ref( errors[i] ) ) );
+		}
+
+		// the last transformer runs on this thread, producing the (seekable) result
+		const StreamTransformer& rLastTransformer = *m_Transformers.back();
+		if( rLastTransformer.SupportsStreaming() )
+		{
+			std::large_stringstream* pOutput( new std::large_stringstream() );
+			pResult.reset( pOutput );
+			rLastTransformer.TransformStream( i_rParameters, *pipeReaders.back(), *pOutput );
+			pOutput->flush();
+		}
+		else
+		{
+			std::large_stringstream* pInput( new std::large_stringstream() );
+			boost::shared_ptr< std::istream > pInputAsIstream( pInput );
+			boost::iostreams::copy( *pipeReaders.back(), *pInput );
+			pResult = rLastTransformer.TransformStream( i_rParameters, pInputAsIstream );
+		}
+	}
+	catch( ... )
+	{
+		errors[ lastStage ] = std::current_exception();
+	}
+
+	// nothing more will be read from any pipe; release anything still trying to write before waiting
+	std::vector< boost::shared_ptr< StreamPipe > >::const_iterator pipeIter = pipes.begin();
+	for( ; pipeIter != pipes.end(); ++pipeIter )
+	{
+		(*pipeIter)->CloseRead();
+	}
+	stages.join_all();
+
+	RethrowFirstError( errors );
+	return pResult;
+}
+
 bool TransformerManager::HasStreamTransformers() const
 {
 	return m_Transformers.size() > 0;
@@ -0,0 +1,98 @@
+#include "WorkerPool.hpp"
+#include "MVLogger.hpp"
+#include <boost/bind.hpp>
+#include <algorithm>
+
+WorkerPool::WorkerPool( size_t i_NumThreads )
+:	m_Mutex(),
+	m_TaskPosted(),
+	m_Idle(),
+	m_Tasks(),
+	m_Running( 0 ),
+	m_Stopping( false ),
+	m_NumThreads( std::max( i_NumThreads, size_t( 1 ) ) ),
+	m_Threads()
+{
+	for( size_t i = 0; i < m_NumThreads; ++i )
+	{
+		m_Threads.create_thread( boost::bind( &WorkerPool::Run, this ) );
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		boost::unique_lock< boost::mutex > lock( m_Mutex );
+		m_Stopping = true;
+	}
+	m_TaskPosted.notify_all();
+	m_Threads.join_all();
+}
+
+void WorkerPool::Post( const boost::function< void() >& i_rTask )
+{
+	{
+		boost::unique_lock< boost::mutex > lock( m_Mutex );
+		m_Tasks.push_back( i_rTask );
+	}
+	m_TaskPosted.notify_one();
+}
+
+void WorkerPool::WaitForIdle()
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	while( !m_Tasks.empty() || m_Running > 0 )
+	{
+		m_Idle.wait( lock );
+	}
+}
+
+size_t WorkerPool::GetNumThreads() const
+{
+	return m_NumThreads;
+}
+
+void WorkerPool::Run()
+{
+	boost::unique_lock< boost::mutex > lock( m_Mutex );
+	while( true )
+	{
+		while( m_Tasks.empty() && !m_Stopping )
+		{
+			m_TaskPosted.wait( lock );
+		}
+		// only stop once everything posted has been run
+		if( m_Tasks.empty() )
+		{
+			return;
+		}
+
+		boost::function< void() > task;
+		task.swap( m_Tasks.front() );
+		m_Tasks.pop_front();
+		++m_Running;
+		lock.unlock();
+
+		try
+		{
+			task();
+		}
+		catch( const std::exception& e )
+		{
+			MVLOGGER( "root.lib.DataProxy.WorkerPool.Run.Error", "Caught exception running task: " << e.what() );
+		}
+		catch( ... )
+		{
+			MVLOGGER( "root.lib.DataProxy.WorkerPool.Run.Error", "Caught unknown exception running task" );
+		}
+
+		// release whatever the task holds before reporting it done
+		task.clear();
+		lock.lock();
+		--m_Running;
+		if( m_Tasks.empty() && m_Running == 0 )
+		{
+			m_Idle.notify_all();
+		}
+	}
+}
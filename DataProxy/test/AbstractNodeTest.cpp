@@ -34,10 +34,79 @@
 #include <boost/scoped_ptr.hpp>
 #include <boost/ref.hpp>
 #include <boost/iostreams/filter/counter.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
 
 CPPUNIT_TEST_SUITE_REGISTRATION( AbstractNodeTest );
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( AbstractNodeTest, "AbstractNodeTest" );
 
+namespace
+{
+	typedef std::vector< std::pair< std::string, MonitoringMetric > > ReportList;
+
+	// each phase a node's request is timed in is reported as a metric named <phase>Seconds
+	const std::string PHASE_METRIC_SUFFIX( "Seconds" );
+	const char* PHASES[] = { "translate", "impl", "retryDelay", "transform", "tee", "output", "forward" };
+
+	bool IsPhaseReport( const std::pair< std::string, MonitoringMetric >& i_rReport )
+	{
+		return i_rReport.first.find( PHASE_METRIC_SUFFIX ) != std::string::npos;
+	}
+
+	// the reports other than the phase timings, in the order they were made
+	ReportList GetPayloadReports( const ReportList& i_rReports )
+	{
+		ReportList result;
+		ReportList::const_iterator iter = i_rReports.begin();
+		for( ; iter != i_rReports.end(); ++iter )
+		{
+			if( !IsPhaseReport( *iter ) )
+			{
+				result.push_back( *iter );
+			}
+		}
+		return result;
+	}
+
+	// the phases that had their times reported, in the order of PHASES, separated by spaces
+	std::string GetReportedPhases( const ReportList& i_rReports )
+	{
+		std::string result;
+		for( size_t i = 0; i < sizeof( PHASES ) / sizeof( PHASES[0] ); ++i )
+		{
+			std::string metric = PHASES[i] + PHASE_METRIC_SUFFIX;
+			ReportList::const_iterator iter = i_rReports.begin();
+			for( ; iter != i_rReports.end(); ++iter )
+			{
+				if( iter->first.find( metric ) != std::string::npos )
+				{
+					result += ( result.empty() ? "" : " " ) + std::string( PHASES[i] );
+					break;
+				}
+			}
+		}
+		return result;
+	}
+
+	void LoadInto( AbstractNode& i_rNode, const std::map< std::string, std::string >& i_rParameters, std::stringstream& o_rResults )
+	{
+		i_rNode.Load( i_rParameters, o_rResults );
+	}
+
+	// as LoadInto, recording the error of a load that fails
+	void TryLoadInto( AbstractNode& i_rNode, const std::map< std::string, std::string >& i_rParameters, std::stringstream& o_rResults, std::string& o_rError )
+	{
+		try
+		{
+			i_rNode.Load( i_rParameters, o_rResults );
+		}
+		catch( const std::exception& i_rEx )
+		{
+			o_rError = i_rEx.what();
+		}
+	}
+}
+
 AbstractNodeTest::AbstractNodeTest()
 :	m_pTempDir(NULL),
 	m_pMockTransformFunctionDomain( new MockTransformFunctionDomain() )
@@ -199,6 +268,54 @@ void AbstractNodeTest::testIllegalXml()
 
 	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), XMLUtilitiesException,
 		".*:\\d+: Found invalid child: garbage in node: OnFailure" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Write>" << std::endl
+				<< "    <OnFailure retryCount=\"1\" retryUntilFirstByte=\"true\" />" << std::endl
+				<< "  </Write>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), NodeConfigException,
+		".*:\\d+: Attribute \"retryUntilFirstByte\" may only be used in a Read node" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Delete>" << std::endl
+				<< "    <OnFailure retryCount=\"1\" retryUntilFirstByte=\"true\" />" << std::endl
+				<< "  </Delete>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), NodeConfigException,
+		".*:\\d+: Attribute \"retryUntilFirstByte\" may only be used in a Read node" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Read>" << std::endl
+				<< "    <OnFailure forwardTo=\"somewhere\" retryUntilFirstByte=\"true\" />" << std::endl
+				<< "  </Read>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), NodeConfigException,
+		".*:\\d+: Attribute \"retryUntilFirstByte\" requires a nonzero \"retryCount\" attribute" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Read>" << std::endl
+				<< "    <OnFailure forwardTo=\"somewhere\" retryCount=\"0\" retryUntilFirstByte=\"true\" />" << std::endl
+				<< "  </Read>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), NodeConfigException,
+		".*:\\d+: Attribute \"retryUntilFirstByte\" requires a nonzero \"retryCount\" attribute" );
 	
 	xmlContents.str("");
 	xmlContents << "<DataNode>" << std::endl
@@ -383,6 +500,193 @@ void AbstractNodeTest::testIllegalXml()
 
 	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), XMLUtilitiesException,
 		".*:\\d+: Found invalid child: garbage in node: Parameter" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Read>" << std::endl
+				<< "    <Staging workingDir=\"" << m_pTempDir->GetDirectoryName() << "\" />" << std::endl
+				<< "  </Read>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), XMLUtilitiesException,
+		".*:\\d+: Unable to find attribute: 'memoryLimit' in node: Staging" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Read>" << std::endl
+				<< "    <Staging memoryLimit=\"1000\" garbage=\"true\" />" << std::endl
+				<< "  </Read>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), XMLUtilitiesException,
+		".*:\\d+: Found invalid attribute: garbage in node: Staging" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Read>" << std::endl
+				<< "    <Staging memoryLimit=\"-1\" workingDir=\"" << m_pTempDir->GetDirectoryName() << "\" />" << std::endl
+				<< "  </Read>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), NodeConfigException,
+		".*:\\d+: Attribute \"memoryLimit\" must not be negative" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Read>" << std::endl
+				<< "    <Staging memoryLimit=\"1000\" workingDir=\"/nonexistent\" />" << std::endl
+				<< "  </Read>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), InvalidDirectoryException,
+		".*:\\d+: /nonexistent does not exist or is not a valid directory." );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Write>" << std::endl
+				<< "    <Staging memoryLimit=\"1000\" workingDir=\"/nonexistent\" />" << std::endl
+				<< "  </Write>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), InvalidDirectoryException,
+		".*:\\d+: /nonexistent does not exist or is not a valid directory." );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Delete>" << std::endl
+				<< "    <Staging memoryLimit=\"1000\" />" << std::endl
+				<< "  </Delete>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), XMLUtilitiesException,
+		".*:\\d+: Found invalid child: Staging in node: Delete" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Read>" << std::endl
+				<< "    <Tee forwardTo=\"teeName\" async=\"true\" />" << std::endl
+				<< "  </Read>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), NodeConfigException,
+		".*:\\d+: Attributes \"async\" and \"bufferSize\" may only be used on a Tee that is concurrent" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Read>" << std::endl
+				<< "    <Tee forwardTo=\"teeName\" concurrent=\"true\" bufferSize=\"0\" />" << std::endl
+				<< "  </Read>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), NodeConfigException,
+		".*:\\d+: Attribute \"bufferSize\" must be greater than 0" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Read>" << std::endl
+				<< "    <Cache maxBytes=\"1000\" />" << std::endl
+				<< "  </Read>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), XMLUtilitiesException,
+		".*:\\d+: Unable to find attribute: 'ttl' in node: Cache" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Read>" << std::endl
+				<< "    <Cache ttl=\"60\" maxBytes=\"0\" />" << std::endl
+				<< "  </Read>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), NodeConfigException,
+		".*:\\d+: Attributes \"ttl\" and \"maxBytes\" must be greater than 0" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Read>" << std::endl
+				<< "    <Cache ttl=\"60\" maxBytes=\"1000\" workingDir=\"" << m_pTempDir->GetDirectoryName() << "\" />" << std::endl
+				<< "  </Read>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), XMLUtilitiesException,
+		".*:\\d+: Unable to find attribute: 'maxDiskBytes' in node: Cache" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Read>" << std::endl
+				<< "    <Cache ttl=\"60\" maxBytes=\"1000\" maxDiskBytes=\"1000\" />" << std::endl
+				<< "  </Read>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), NodeConfigException,
+		".*:\\d+: Attribute \"maxDiskBytes\" may only be used on a Cache that has a workingDir" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Read>" << std::endl
+				<< "    <Cache ttl=\"60\" maxBytes=\"1000\" workingDir=\"/nonexistent\" maxDiskBytes=\"1000\" />" << std::endl
+				<< "  </Read>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), InvalidDirectoryException,
+		".*:\\d+: /nonexistent does not exist or is not a valid directory." );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Read>" << std::endl
+				<< "    <Coalesce maxBytes=\"0\" />" << std::endl
+				<< "  </Read>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), NodeConfigException,
+		".*:\\d+: Attribute \"maxBytes\" must be greater than 0" );
+
+	std::string librarySpec;
+	TransformerTestHelpers::SetupLibraryFile( m_pTempDir->GetDirectoryName(), librarySpec );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode>" << std::endl
+				<< "  <Read>" << std::endl
+				<< "    <OnFailure retryCount=\"1\" />" << std::endl
+				<< "    <StreamTransformers>" << std::endl
+				<< "      <StreamTransformer path=\"" << librarySpec << "\" functionName=\"TransformFunction\" />" << std::endl
+				<< "    </StreamTransformers>" << std::endl
+				<< "    <Tee forwardTo=\"teeName\" concurrent=\"true\" />" << std::endl
+				<< "  </Read>" << std::endl
+				<< "</DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TestableNode node( "name", client, *nodes[0] ), NodeConfigException,
+		".*:\\d+: A concurrent Tee of the untransformed stream cannot be used on a node that also has retries and stream transformers" );
 }
 
 void AbstractNodeTest::testLoad()
@@ -540,11 +844,13 @@ void AbstractNodeTest::testLoadTransformStream()
 			 << "original node data\n";
 	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
 
-	const std::vector< std::pair< std::string, MonitoringMetric > >& rReports = pMonitoringInstance->GetReports();
-	CPPUNIT_ASSERT_EQUAL( size_t(35), rReports.size() );
+	const ReportList& rReports = pMonitoringInstance->GetReports();
+	CPPUNIT_ASSERT_EQUAL( std::string( "translate impl transform output" ), GetReportedPhases( rReports ) );
+	ReportList payloadReports = GetPayloadReports( rReports );
+	CPPUNIT_ASSERT_EQUAL( size_t(35), payloadReports.size() );
 
-	CPPUNIT_ASSERT_DOUBLES_EQUAL( double( cnt.characters() ), rReports[14].second.GetDouble(), 1e-9 );
-	CPPUNIT_ASSERT_DOUBLES_EQUAL( double( cnt.lines() ), rReports[21].second.GetDouble(), 1e-9 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( double( cnt.characters() ), payloadReports[14].second.GetDouble(), 1e-9 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( double( cnt.lines() ), payloadReports[21].second.GetDouble(), 1e-9 );
 }
 
 void AbstractNodeTest::testLoadFailureForwarding()
@@ -622,24 +928,655 @@ void AbstractNodeTest::testLoadRetryCount()
 	expected.str("");
 	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
 
-	// now repeat the test with success
-	node.SetLoadException( false );
-	node.SetDataToReturn( "this is some data" );
-	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
-	expected.str("");
-	expected << "this is some data";
-	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
+	// now repeat the test with success
+	node.SetLoadException( false );
+	node.SetDataToReturn( "this is some data" );
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+	expected.str("");
+	expected << "this is some data";
+	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
+}
+
+void AbstractNodeTest::testLoadRetryUntilFirstByte()
+{
+	std::stringstream xmlContents;
+	xmlContents << "  <DataNode>" << std::endl
+				<< "    <Read>" << std::endl
+				<< "      <OnFailure retryCount=\"2\" retryUntilFirstByte=\"true\" />" << std::endl
+				<< "    </Read>" << std::endl
+				<< "  </DataNode>" << std::endl;
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	MockDataProxyClient client;
+	TestableNode node( "name", client, *nodes[0] );
+	node.SetLoadException( true );
+	node.SetWriteOnLoadException( true );
+
+	std::map<std::string,std::string> parameters;
+
+	// data that is still buffered when a load fails is discarded, so the load can be retried
+	std::stringstream results;
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( node.Load( parameters, results ), MVException,
+		".*:\\d+: Set to throw exception" );
+
+	std::stringstream expected;
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
+
+	expected.str("");
+	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
+
+	// once data has been passed on, the load is no longer retried
+	TestableNode node2( "name", client, *nodes[0] );
+	node2.SetLoadException( true );
+	node2.SetWriteOnLoadException( true );
+	node2.SetFlushOnLoadException( true );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( node2.Load( parameters, results ), MVException,
+		".*:\\d+: Set to throw exception" );
+
+	expected.str("");
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node2.GetLog() );
+
+	expected.str("");
+	expected << "This is some exception data" << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
+
+	// now repeat the test with success
+	results.str("");
+	node.SetLoadException( false );
+	node.SetDataToReturn( "this is some data" );
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+	expected.str("");
+	expected << "this is some data";
+	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
+}
+
+void AbstractNodeTest::testLoadRetryUntilFirstByteFailureForwarding()
+{
+	std::stringstream xmlContents;
+	xmlContents << "  <DataNode>" << std::endl
+				<< "    <Read>" << std::endl
+				<< "      <OnFailure forwardTo=\"failureName\" retryCount=\"1\" retryUntilFirstByte=\"true\" />" << std::endl
+				<< "    </Read>" << std::endl
+				<< "  </DataNode>" << std::endl;
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	MockDataProxyClient client;
+	client.SetDataToReturn( "failureName", "default data" );
+
+	std::map<std::string,std::string> parameters;
+
+	// a load that fails before producing data is forwarded once its retries run out
+	TestableNode node( "name", client, *nodes[0] );
+	node.SetLoadException( true );
+	node.SetWriteOnLoadException( true );
+
+	std::stringstream results;
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+
+	std::stringstream expected;
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
+
+	expected.str("");
+	expected << "Load called with Name: failureName Parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+
+	expected.str("");
+	expected << "default data";
+	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
+
+	// one that fails mid-stream throws, rather than appending the forwarded result to its partial one
+	MockDataProxyClient client2;
+	client2.SetDataToReturn( "failureName", "default data" );
+	TestableNode node2( "name", client2, *nodes[0] );
+	node2.SetLoadException( true );
+	node2.SetWriteOnLoadException( true );
+	node2.SetFlushOnLoadException( true );
+
+	results.str("");
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( node2.Load( parameters, results ), MVException,
+		".*:\\d+: Set to throw exception" );
+
+	expected.str("");
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node2.GetLog() );
+
+	CPPUNIT_ASSERT_EQUAL( std::string(), client2.GetLog() );
+
+	expected.str("");
+	expected << "This is some exception data" << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
+}
+
+void AbstractNodeTest::testLoadFailureForwarding_ParameterTranslationFail()
+{
+	std::stringstream xmlContents;
+	xmlContents << "  <DataNode>" << std::endl
+				<< "    <Read>" << std::endl
+				<< "	  <TranslateParameters>" << std::endl
+				<< "	    <Parameter name=\"p1\" valueOverride=\"`nonexistent`\" />" << std::endl
+				<< "	  </TranslateParameters>" << std::endl
+				<< "      <OnFailure forwardTo=\"failureName\" includeNameAsParameter=\"myFirstFailedDplName\" forwardTranslatedParameters=\"true\" />" << std::endl
+				<< "    </Read>" << std::endl
+				<< "  </DataNode>" << std::endl;
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	MockDataProxyClient client;
+	client.SetDataToReturn( "failureName", "default data" );
+
+	TestableNode node( "name", client, *nodes[0] );
+	node.AddReadForward( "implForward1" );
+	node.AddReadForward( "implForward2" );
+
+	std::map<std::string,std::string> parameters;
+
+	std::stringstream results;
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+
+	parameters["myFirstFailedDplName"] = "name";
+
+	std::stringstream expected;
+	expected << "Load called with Name: failureName Parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+
+	expected.str("");
+	expected << "default data";
+	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
+
+	std::set< std::string > forwards;
+	node.InsertReadForwards( forwards );
+	CPPUNIT_ASSERT_EQUAL( size_t(3), forwards.size() );
+	CPPUNIT_ASSERT( forwards.find( "failureName" ) != forwards.end() );
+	CPPUNIT_ASSERT( forwards.find( "implForward1" ) != forwards.end() );
+	CPPUNIT_ASSERT( forwards.find( "implForward2" ) != forwards.end() );
+}
+
+void AbstractNodeTest::testLoadFailureForwarding_ParameterValidationFail()
+{
+	std::stringstream xmlContents;
+	xmlContents << "  <DataNode>" << std::endl
+				<< "    <Read>" << std::endl
+				<< "	  <RequiredParameters>" << std::endl
+				<< "	    <Parameter name=\"nonexistent\" />" << std::endl
+				<< "	  </RequiredParameters>" << std::endl
+				<< "      <OnFailure forwardTo=\"failureName\" includeNameAsParameter=\"myFirstFailedDplName\" forwardTranslatedParameters=\"true\" />" << std::endl
+				<< "    </Read>" << std::endl
+				<< "  </DataNode>" << std::endl;
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	MockDataProxyClient client;
+	client.SetDataToReturn( "failureName", "default data" );
+
+	TestableNode node( "name", client, *nodes[0] );
+	node.AddReadForward( "implForward1" );
+	node.AddReadForward( "implForward2" );
+
+	std::map<std::string,std::string> parameters;
+
+	std::stringstream results;
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+
+	parameters["myFirstFailedDplName"] = "name";
+
+	std::stringstream expected;
+	expected << "Load called with Name: failureName Parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+
+	expected.str("");
+	expected << "default data";
+	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
+
+	std::set< std::string > forwards;
+	node.InsertReadForwards( forwards );
+	CPPUNIT_ASSERT_EQUAL( size_t(3), forwards.size() );
+	CPPUNIT_ASSERT( forwards.find( "failureName" ) != forwards.end() );
+	CPPUNIT_ASSERT( forwards.find( "implForward1" ) != forwards.end() );
+	CPPUNIT_ASSERT( forwards.find( "implForward2" ) != forwards.end() );
+}
+
+void AbstractNodeTest::testLoadFailureForwarding_UseTranslatedParams_False()
+{
+	std::stringstream xmlContents;
+	xmlContents << "  <DataNode>" << std::endl
+				<< "    <Read>" << std::endl
+				<< "      <TranslateParameters>" << std::endl
+				<< "        <Parameter name=\"default1\" valueDefault=\"defaultValue1\" />" << std::endl
+				<< "      </TranslateParameters>" << std::endl
+				<< "      <OnFailure forwardTo=\"failureName\" forwardTranslatedParameters=\"false\" />" << std::endl
+				<< "    </Read>" << std::endl
+				<< "  </DataNode>" << std::endl;
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	MockDataProxyClient client;
+	client.SetDataToReturn( "failureName", "default data" );
+
+	TestableNode node( "name", client, *nodes[0] );
+	node.SetLoadException( true );
+
+	std::map<std::string,std::string> parameters;
+
+	std::stringstream results;
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+
+	std::stringstream expected;
+	expected << "Load called with Name: failureName Parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+
+	expected.str("");
+	expected << "default data";
+	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
+}
+
+void AbstractNodeTest::testLoadFailureForwarding_UseTranslatedParams_True()
+{
+	std::stringstream xmlContents;
+	xmlContents << "  <DataNode>" << std::endl
+				<< "    <Read>" << std::endl
+				<< "      <TranslateParameters>" << std::endl
+				<< "        <Parameter name=\"default1\" valueDefault=\"defaultValue1\" />" << std::endl
+				<< "      </TranslateParameters>" << std::endl
+				<< "      <OnFailure forwardTo=\"failureName\" forwardTranslatedParameters=\"true\" />" << std::endl
+				<< "    </Read>" << std::endl
+				<< "  </DataNode>" << std::endl;
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	MockDataProxyClient client;
+	client.SetDataToReturn( "failureName", "default data" );
+
+	TestableNode node( "name", client, *nodes[0] );
+	node.SetLoadException( true );
+
+	std::map<std::string,std::string> parameters;
+
+	std::stringstream results;
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+
+	parameters["default1"] = "defaultValue1";
+
+	std::stringstream expected;
+	expected << "Load called with Name: failureName Parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+
+	expected.str("");
+	expected << "default data";
+	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
+}
+
+void AbstractNodeTest::testLoadTee()
+{
+	std::stringstream xmlContents;
+	xmlContents << "  <DataNode>" << std::endl
+				<< "    <Read>" << std::endl
+				<< "      <Tee forwardTo=\"teeName\" />" << std::endl
+				<< "    </Read>" << std::endl
+				<< "  </DataNode>" << std::endl;
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	MockDataProxyClient client;
+
+	TestableNode node( "name", client, *nodes[0] );
+	std::string data( "this is some data that will be teed & returned" );
+	node.SetDataToReturn( data );
+
+	std::map<std::string,std::string> parameters;
+	parameters[ "name1" ] = "value1";
+
+	std::stringstream results;
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+
+	std::stringstream expected;
+	expected << "Store called with Name: teeName Parameters: " << ProxyUtilities::ToString( parameters ) << " Data: " << data << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+
+	CPPUNIT_ASSERT_EQUAL( data, results.str() );
+}
+
+void AbstractNodeTest::testLoadStaging()
+{
+	MockMonitoringInstance* pMonitoringInstance = new MockMonitoringInstance();
+	boost::scoped_ptr< MonitoringInstance > pTemp( pMonitoringInstance );
+	ApplicationMonitor::Swap( pTemp );
+
+	std::stringstream xmlContents;
+	xmlContents << "  <DataNode>" << std::endl
+				<< "    <Read>" << std::endl
+				<< "      <Staging memoryLimit=\"10\" workingDir=\"" << m_pTempDir->GetDirectoryName() << "\" />" << std::endl
+				<< "      <Tee forwardTo=\"teeName\" />" << std::endl
+				<< "    </Read>" << std::endl
+				<< "  </DataNode>" << std::endl;
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	MockDataProxyClient client;
+
+	TestableNode node( "name", client, *nodes[0] );
+	std::string data( "this is some data that is larger than the memory limit, so will be staged on disk" );
+	node.SetDataToReturn( data );
+
+	std::map<std::string,std::string> parameters;
+	parameters[ "name1" ] = "value1";
+
+	std::stringstream results;
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+
+	std::stringstream expected;
+	expected << "Store called with Name: teeName Parameters: " << ProxyUtilities::ToString( parameters ) << " Data: " << data << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+
+	CPPUNIT_ASSERT_EQUAL( data, results.str() );
+
+	// the bytes spilled are reported alongside the payload metrics
+	const ReportList& rReports = pMonitoringInstance->GetReports();
+	CPPUNIT_ASSERT_EQUAL( std::string( "translate impl tee output" ), GetReportedPhases( rReports ) );
+	ReportList payloadReports = GetPayloadReports( rReports );
+	CPPUNIT_ASSERT_EQUAL( size_t(12), payloadReports.size() );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( double( data.size() ), payloadReports[6].second.GetDouble(), 1e-9 );
+}
+
+void AbstractNodeTest::testLoadTee_UseTranslatedParams_False()
+{
+	std::stringstream xmlContents;
+	xmlContents << "  <DataNode>" << std::endl
+				<< "    <Read>" << std::endl
+				<< "      <TranslateParameters> <Parameter name=\"name2\" valueOverride=\"override2\" /> </TranslateParameters>" << std::endl
+				<< "      <Tee forwardTo=\"teeName\" forwardTranslatedParameters=\"false\"/>" << std::endl
+				<< "    </Read>" << std::endl
+				<< "  </DataNode>" << std::endl;
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	MockDataProxyClient client;
+
+	TestableNode node( "name", client, *nodes[0] );
+	std::string data( "this is some data that will be teed & returned" );
+	node.SetDataToReturn( data );
+
+	std::map<std::string,std::string> parameters;
+	parameters[ "name1" ] = "value1";
+
+	std::stringstream results;
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+
+	std::stringstream expected;
+	expected << "Store called with Name: teeName Parameters: " << ProxyUtilities::ToString( parameters ) << " Data: " << data << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+
+	CPPUNIT_ASSERT_EQUAL( data, results.str() );
+}
+
+void AbstractNodeTest::testLoadTee_UseTranslatedParams_True()
+{
+	std::stringstream xmlContents;
+	xmlContents << "  <DataNode>" << std::endl
+				<< "    <Read>" << std::endl
+				<< "      <TranslateParameters> <Parameter name=\"name2\" valueOverride=\"override2\" /> </TranslateParameters>" << std::endl
+				<< "      <Tee forwardTo=\"teeName\" forwardTranslatedParameters=\"true\"/>" << std::endl
+				<< "    </Read>" << std::endl
+				<< "  </DataNode>" << std::endl;
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	MockDataProxyClient client;
+
+	TestableNode node( "name", client, *nodes[0] );
+	std::string data( "this is some data that will be teed & returned" );
+	node.SetDataToReturn( data );
+
+	std::map<std::string,std::string> parameters;
+	parameters[ "name1" ] = "value1";
+
+	std::stringstream results;
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+	parameters[ "name2" ] = "override2";
+
+	std::stringstream expected;
+	expected << "Store called with Name: teeName Parameters: " << ProxyUtilities::ToString( parameters ) << " Data: " << data << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+
+	CPPUNIT_ASSERT_EQUAL( data, results.str() );
+}
+
+void AbstractNodeTest::testLoadTee_UseTransformedStream_False()
+{
+	std::string m_LibrarySpec;
+	TransformerTestHelpers::SetupLibraryFile( m_pTempDir->GetDirectoryName(), m_LibrarySpec );
+
+	std::stringstream xmlContents;
+	xmlContents << "  <DataNode>" << std::endl
+				<< "    <Read>" << std::endl
+			 	<< "      <StreamTransformers>" << std::endl
+				<< "		 <StreamTransformer path=\"" << m_LibrarySpec << "\"" << " functionName=\"TransformFunction\">" << std::endl
+				<< " 		  	<Parameter name=\"st_param1\" value=\"st_value1\" /> " << std::endl
+				<< "	     </StreamTransformer>" << std::endl
+				<< "      </StreamTransformers>" << std::endl
+				<< "      <Tee forwardTo=\"teeName\" forwardTransformedStream=\"false\" />" << std::endl
+				<< "    </Read>" << std::endl
+				<< "  </DataNode>" << std::endl;
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	MockDataProxyClient client;
+
+	TestableNode node( "name", client, *nodes[0] );
+	std::string data( "this is some data that will be teed & returned" );
+	node.SetDataToReturn( data );
+
+	std::map<std::string,std::string> parameters;
+	parameters[ "name1" ] = "value1";
+
+	std::stringstream results;
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+	std::string additionalData( "st_param1 : st_value1\n" );
+
+	std::stringstream expected;
+	expected << "Store called with Name: teeName Parameters: " << ProxyUtilities::ToString( parameters ) << " Data: " << data << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+
+	CPPUNIT_ASSERT_EQUAL( additionalData + data, results.str() );
+}
+
+void AbstractNodeTest::testLoadTee_UseTransformedStream_True()
+{
+	std::string m_LibrarySpec;
+	TransformerTestHelpers::SetupLibraryFile( m_pTempDir->GetDirectoryName(), m_LibrarySpec );
+
+	std::stringstream xmlContents;
+	xmlContents << "  <DataNode>" << std::endl
+				<< "    <Read>" << std::endl
+			 	<< "      <StreamTransformers>" << std::endl
+				<< "		 <StreamTransformer path=\"" << m_LibrarySpec << "\"" << " functionName=\"TransformFunction\">" << std::endl
+				<< " 		  	<Parameter name=\"st_param1\" value=\"st_value1\" /> " << std::endl
+				<< "	     </StreamTransformer>" << std::endl
+				<< "      </StreamTransformers>" << std::endl
+				<< "      <Tee forwardTo=\"teeName\" forwardTransformedStream=\"true\"/>" << std::endl
+				<< "    </Read>" << std::endl
+				<< "  </DataNode>" << std::endl;
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	MockDataProxyClient client;
+
+	TestableNode node( "name", client, *nodes[0] );
+	std::string data( "this is some data that will be teed & returned" );
+	node.SetDataToReturn( data );
+
+	std::map<std::string,std::string> parameters;
+	parameters[ "name1" ] = "value1";
+
+	std::stringstream results;
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+	std::string additionalData( "st_param1 : st_value1\n" );
+
+	std::stringstream expected;
+	expected << "Store called with Name: teeName Parameters: " << ProxyUtilities::ToString( parameters ) << " Data: "
+			 << additionalData << data << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+
+	CPPUNIT_ASSERT_EQUAL( additionalData + data, results.str() );
+}
+
+void AbstractNodeTest::testLoadTee_Concurrent()
+{
+	std::stringstream xmlContents;
+	xmlContents << "  <DataNode>" << std::endl
+				<< "    <Read>" << std::endl
+				<< "      <Tee forwardTo=\"teeName\" concurrent=\"true\" bufferSize=\"4\" />" << std::endl
+				<< "    </Read>" << std::endl
+				<< "  </DataNode>" << std::endl;
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	MockDataProxyClient client;
+
+	TestableNode node( "name", client, *nodes[0] );
+	std::string data( "this is some data that will be teed & returned" );
+	node.SetDataToReturn( data );
+
+	std::map<std::string,std::string> parameters;
+	parameters[ "name1" ] = "value1";
+
+	std::stringstream results;
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+
+	std::stringstream expected;
+	expected << "Store called with Name: teeName Parameters: " << ProxyUtilities::ToString( parameters ) << " Data: " << data << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+
+	CPPUNIT_ASSERT_EQUAL( data, results.str() );
+}
+
+void AbstractNodeTest::testLoadTee_Concurrent_UseTransformedStream()
+{
+	std::string m_LibrarySpec;
+	TransformerTestHelpers::SetupLibraryFile( m_pTempDir->GetDirectoryName(), m_LibrarySpec );
+
+	std::string additionalData( "st_param1 : st_value1\n" );
+	std::string data( "this is some data that will be teed & returned" );
+	std::map<std::string,std::string> parameters;
+	parameters[ "name1" ] = "value1";
+
+	// with retries, the raw stream has to be staged; the transformed stream is teed as it is returned
+	std::stringstream xmlContents;
+	xmlContents << "  <DataNode>" << std::endl
+				<< "    <Read>" << std::endl
+				<< "      <OnFailure retryCount=\"2\" />" << std::endl
+			 	<< "      <StreamTransformers>" << std::endl
+				<< "		 <StreamTransformer path=\"" << m_LibrarySpec << "\"" << " functionName=\"TransformFunction\">" << std::endl
+				<< " 		  	<Parameter name=\"st_param1\" value=\"st_value1\" /> " << std::endl
+				<< "	     </StreamTransformer>" << std::endl
+				<< "      </StreamTransformers>" << std::endl
+				<< "      <Tee forwardTo=\"teeName\" forwardTransformedStream=\"true\" concurrent=\"true\" />" << std::endl
+				<< "    </Read>" << std::endl
+				<< "  </DataNode>" << std::endl;
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	MockDataProxyClient client;
+
+	TestableNode node( "name", client, *nodes[0] );
+	node.SetDataToReturn( data );
+
+	std::stringstream results;
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+
+	std::stringstream expected;
+	expected << "Store called with Name: teeName Parameters: " << ProxyUtilities::ToString( parameters ) << " Data: "
+			 << additionalData << data << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+
+	CPPUNIT_ASSERT_EQUAL( additionalData + data, results.str() );
+
+	// without retries, the untransformed stream is teed as it is loaded
+	xmlContents.str("");
+	xmlContents << "  <DataNode>" << std::endl
+				<< "    <Read>" << std::endl
+			 	<< "      <StreamTransformers>" << std::endl
+				<< "		 <StreamTransformer path=\"" << m_LibrarySpec << "\"" << " functionName=\"TransformFunction\">" << std::endl
+				<< " 		  	<Parameter name=\"st_param1\" value=\"st_value1\" /> " << std::endl
+				<< "	     </StreamTransformer>" << std::endl
+				<< "      </StreamTransformers>" << std::endl
+				<< "      <Tee forwardTo=\"teeName\" forwardTransformedStream=\"false\" concurrent=\"true\" />" << std::endl
+				<< "    </Read>" << std::endl
+				<< "  </DataNode>" << std::endl;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	client.ClearLog();
+	TestableNode node2( "name", client, *nodes[0] );
+	node2.SetDataToReturn( data );
+
+	results.str("");
+	CPPUNIT_ASSERT_NO_THROW( node2.Load( parameters, results ) );
+
+	expected.str("");
+	expected << "Store called with Name: teeName Parameters: " << ProxyUtilities::ToString( parameters ) << " Data: " << data << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+
+	CPPUNIT_ASSERT_EQUAL( additionalData + data, results.str() );
+}
+
+void AbstractNodeTest::testLoadTee_Concurrent_Failure()
+{
+	std::stringstream xmlContents;
+	xmlContents << "  <DataNode>" << std::endl
+				<< "    <Read>" << std::endl
+				<< "      <Tee forwardTo=\"teeName\" concurrent=\"true\" />" << std::endl
+				<< "    </Read>" << std::endl
+				<< "  </DataNode>" << std::endl;
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	MockDataProxyClient client;
+	client.SetExceptionForName( "teeName" );
+
+	TestableNode node( "name", client, *nodes[0] );
+	std::string data( "this is some data that will be teed & returned" );
+	node.SetDataToReturn( data );
+
+	std::map<std::string,std::string> parameters;
+	parameters[ "name1" ] = "value1";
+
+	// a synchronous tee still fails the load, even though the data has already been returned
+	std::stringstream results;
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( node.Load( parameters, results ), DataProxyClientException,
+		".*:\\d+: Set to throw an exception for name: teeName" );
+	CPPUNIT_ASSERT_EQUAL( data, results.str() );
 }
 
-void AbstractNodeTest::testLoadFailureForwarding_ParameterTranslationFail()
+void AbstractNodeTest::testLoadTee_Concurrent_Async()
 {
 	std::stringstream xmlContents;
 	xmlContents << "  <DataNode>" << std::endl
 				<< "    <Read>" << std::endl
-				<< "	  <TranslateParameters>" << std::endl
-				<< "	    <Parameter name=\"p1\" valueOverride=\"`nonexistent`\" />" << std::endl
-				<< "	  </TranslateParameters>" << std::endl
-				<< "      <OnFailure forwardTo=\"failureName\" includeNameAsParameter=\"myFirstFailedDplName\" forwardTranslatedParameters=\"true\" />" << std::endl
+				<< "      <Tee forwardTo=\"teeName\" concurrent=\"true\" async=\"true\" />" << std::endl
 				<< "    </Read>" << std::endl
 				<< "  </DataNode>" << std::endl;
 	std::vector<xercesc::DOMNode*> nodes;
@@ -647,124 +1584,126 @@ void AbstractNodeTest::testLoadFailureForwarding_ParameterTranslationFail()
 	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
 
 	MockDataProxyClient client;
-	client.SetDataToReturn( "failureName", "default data" );
-
-	TestableNode node( "name", client, *nodes[0] );
-	node.AddReadForward( "implForward1" );
-	node.AddReadForward( "implForward2" );
+	client.SetExceptionForName( "teeName" );
 
+	std::string data( "this is some data that will be teed & returned" );
 	std::map<std::string,std::string> parameters;
+	parameters[ "name1" ] = "value1";
 
 	std::stringstream results;
-	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+	{
+		TestableNode node( "name", client, *nodes[0] );
+		node.SetDataToReturn( data );
 
-	parameters["myFirstFailedDplName"] = "name";
+		// an asynchronous tee only logs its failure
+		CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+
+		// destroying the node waits for its outstanding tees
+	}
 
 	std::stringstream expected;
-	expected << "Load called with Name: failureName Parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	expected << "Store called with Name: teeName Parameters: " << ProxyUtilities::ToString( parameters ) << " Data: " << data << std::endl;
 	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
 
-	expected.str("");
-	expected << "default data";
-	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
-
-	std::set< std::string > forwards;
-	node.InsertReadForwards( forwards );
-	CPPUNIT_ASSERT_EQUAL( size_t(3), forwards.size() );
-	CPPUNIT_ASSERT( forwards.find( "failureName" ) != forwards.end() );
-	CPPUNIT_ASSERT( forwards.find( "implForward1" ) != forwards.end() );
-	CPPUNIT_ASSERT( forwards.find( "implForward2" ) != forwards.end() );
+	CPPUNIT_ASSERT_EQUAL( data, results.str() );
 }
 
-void AbstractNodeTest::testLoadFailureForwarding_ParameterValidationFail()
+void AbstractNodeTest::testLoadTee_Concurrent_IntoNode()
 {
 	std::stringstream xmlContents;
 	xmlContents << "  <DataNode>" << std::endl
 				<< "    <Read>" << std::endl
-				<< "	  <RequiredParameters>" << std::endl
-				<< "	    <Parameter name=\"nonexistent\" />" << std::endl
-				<< "	  </RequiredParameters>" << std::endl
-				<< "      <OnFailure forwardTo=\"failureName\" includeNameAsParameter=\"myFirstFailedDplName\" forwardTranslatedParameters=\"true\" />" << std::endl
+				<< "      <Tee forwardTo=\"teeName\" concurrent=\"true\" bufferSize=\"4\" />" << std::endl
 				<< "    </Read>" << std::endl
+				<< "  </DataNode>" << std::endl
+				<< "  <DataNode>" << std::endl
+				<< "  </DataNode>" << std::endl
+				<< "  <DataNode>" << std::endl
+				<< "    <Write>" << std::endl
+				<< "      <OnFailure retryCount=\"1\" forwardTo=\"failureName\" />" << std::endl
+				<< "      <Staging memoryLimit=\"10\" workingDir=\"" << m_pTempDir->GetDirectoryName() << "\" />" << std::endl
+				<< "    </Write>" << std::endl
 				<< "  </DataNode>" << std::endl;
 	std::vector<xercesc::DOMNode*> nodes;
 	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
-	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+	CPPUNIT_ASSERT_EQUAL( size_t(3), nodes.size() );
 
 	MockDataProxyClient client;
-	client.SetDataToReturn( "failureName", "default data" );
 
 	TestableNode node( "name", client, *nodes[0] );
-	node.AddReadForward( "implForward1" );
-	node.AddReadForward( "implForward2" );
+	TestableNode directTee( "teeName", client, *nodes[1] );
+	TestableNode retryTee( "teeName", client, *nodes[2] );
+	retryTee.SetStoreException( true );
+
+	std::string data( "this is some data that will be teed & returned" );
+	node.SetDataToReturn( data );
 
 	std::map<std::string,std::string> parameters;
+	parameters[ "name1" ] = "value1";
+
+	std::stringstream expected;
+	expected << "StoreImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << " with data: " << data << std::endl;
 
+	// a tee into a node that never rewinds its input reads the pipe as it is filled, without spooling it
+	client.SetNodeForName( "teeName", directTee );
 	std::stringstream results;
 	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+	CPPUNIT_ASSERT_EQUAL( data, results.str() );
+	CPPUNIT_ASSERT_EQUAL( expected.str(), directTee.GetLog() );
+	CPPUNIT_ASSERT( !directTee.WasStoreInputSeekable() );
 
-	parameters["myFirstFailedDplName"] = "name";
-
-	std::stringstream expected;
-	expected << "Load called with Name: failureName Parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
-	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+	// a tee into a node that retries spools the pipe (here spilling to disk) so the retry & the failure forward
+	// can replay it
+	client.SetNodeForName( "teeName", retryTee );
+	results.str("");
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+	CPPUNIT_ASSERT_EQUAL( data, results.str() );
+	CPPUNIT_ASSERT_EQUAL( expected.str() + expected.str(), retryTee.GetLog() );
+	CPPUNIT_ASSERT( retryTee.WasStoreInputSeekable() );
 
 	expected.str("");
-	expected << "default data";
-	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
-
-	std::set< std::string > forwards;
-	node.InsertReadForwards( forwards );
-	CPPUNIT_ASSERT_EQUAL( size_t(3), forwards.size() );
-	CPPUNIT_ASSERT( forwards.find( "failureName" ) != forwards.end() );
-	CPPUNIT_ASSERT( forwards.find( "implForward1" ) != forwards.end() );
-	CPPUNIT_ASSERT( forwards.find( "implForward2" ) != forwards.end() );
+	expected << "Store called with Name: failureName Parameters: " << ProxyUtilities::ToString( parameters ) << " Data: " << data << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
 }
 
-void AbstractNodeTest::testLoadFailureForwarding_UseTranslatedParams_False()
+void AbstractNodeTest::testLoadOperationIgnore()
 {
 	std::stringstream xmlContents;
 	xmlContents << "  <DataNode>" << std::endl
-				<< "    <Read>" << std::endl
-				<< "      <TranslateParameters>" << std::endl
-				<< "        <Parameter name=\"default1\" valueDefault=\"defaultValue1\" />" << std::endl
-				<< "      </TranslateParameters>" << std::endl
-				<< "      <OnFailure forwardTo=\"failureName\" forwardTranslatedParameters=\"false\" />" << std::endl
-				<< "    </Read>" << std::endl
+				<< "    <Read operation=\"ignore\">" << std::endl
 				<< "  </DataNode>" << std::endl;
 	std::vector<xercesc::DOMNode*> nodes;
 	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
 	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
 
 	MockDataProxyClient client;
-	client.SetDataToReturn( "failureName", "default data" );
 
 	TestableNode node( "name", client, *nodes[0] );
-	node.SetLoadException( true );
 
 	std::map<std::string,std::string> parameters;
+	parameters["param1"] = "value1";
+	parameters["param2"] = "value2";
+	parameters["param3"] = "value3";
+	parameters["param4"] = "value4";
 
 	std::stringstream results;
+
 	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
 
 	std::stringstream expected;
-	expected << "Load called with Name: failureName Parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
-	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
-
-	expected.str("");
-	expected << "default data";
-	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
 }
 
-void AbstractNodeTest::testLoadFailureForwarding_UseTranslatedParams_True()
+void AbstractNodeTest::testLoadCache()
 {
 	std::stringstream xmlContents;
 	xmlContents << "  <DataNode>" << std::endl
 				<< "    <Read>" << std::endl
 				<< "      <TranslateParameters>" << std::endl
-				<< "        <Parameter name=\"default1\" valueDefault=\"defaultValue1\" />" << std::endl
+				<< "        <Parameter name=\"ignored\" />" << std::endl
 				<< "      </TranslateParameters>" << std::endl
-				<< "      <OnFailure forwardTo=\"failureName\" forwardTranslatedParameters=\"true\" />" << std::endl
+				<< "      <Cache ttl=\"60\" maxBytes=\"1000\" workingDir=\"" << m_pTempDir->GetDirectoryName() << "\" maxDiskBytes=\"1000\" />" << std::endl
+				<< "      <Tee forwardTo=\"teeName\" />" << std::endl
 				<< "    </Read>" << std::endl
 				<< "  </DataNode>" << std::endl;
 	std::vector<xercesc::DOMNode*> nodes;
@@ -772,33 +1711,64 @@ void AbstractNodeTest::testLoadFailureForwarding_UseTranslatedParams_True()
 	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
 
 	MockDataProxyClient client;
-	client.SetDataToReturn( "failureName", "default data" );
 
 	TestableNode node( "name", client, *nodes[0] );
-	node.SetLoadException( true );
+	node.SetDataToReturn( "original data" );
 
 	std::map<std::string,std::string> parameters;
+	parameters[ "name1" ] = "value1";
 
 	std::stringstream results;
 	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
-
-	parameters["default1"] = "defaultValue1";
+	CPPUNIT_ASSERT_EQUAL( std::string( "original data" ), results.str() );
 
 	std::stringstream expected;
-	expected << "Load called with Name: failureName Parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
-	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
 
-	expected.str("");
-	expected << "default data";
-	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
+	std::stringstream expectedTee;
+	expectedTee << "Store called with Name: teeName Parameters: " << ProxyUtilities::ToString( parameters ) << " Data: original data" << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expectedTee.str(), client.GetLog() );
+
+	// the same parameters (after translation) are served from the cache, and not teed again
+	node.SetDataToReturn( "new data" );
+	std::map<std::string,std::string> translatedToSame( parameters );
+	translatedToSame[ "ignored" ] = "anything";
+	results.str( "" );
+	CPPUNIT_ASSERT_NO_THROW( node.Load( translatedToSame, results ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "original data" ), results.str() );
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
+	CPPUNIT_ASSERT_EQUAL( expectedTee.str(), client.GetLog() );
+
+	// other parameters are loaded
+	std::map<std::string,std::string> otherParameters;
+	otherParameters[ "name1" ] = "value2";
+	results.str( "" );
+	CPPUNIT_ASSERT_NO_THROW( node.Load( otherParameters, results ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "new data" ), results.str() );
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( otherParameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
+
+	// failed loads are not cached
+	std::map<std::string,std::string> failedParameters;
+	failedParameters[ "name1" ] = "value3";
+	node.SetLoadException( true );
+	results.str( "" );
+	CPPUNIT_ASSERT_THROW( node.Load( failedParameters, results ), MVException );
+	node.SetLoadException( false );
+	CPPUNIT_ASSERT_NO_THROW( node.Load( failedParameters, results ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "new data" ), results.str() );
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( failedParameters ) << std::endl;
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( failedParameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
 }
 
-void AbstractNodeTest::testLoadTee()
+void AbstractNodeTest::testLoadCache_TooLarge()
 {
 	std::stringstream xmlContents;
 	xmlContents << "  <DataNode>" << std::endl
 				<< "    <Read>" << std::endl
-				<< "      <Tee forwardTo=\"teeName\" />" << std::endl
+				<< "      <Cache ttl=\"60\" maxBytes=\"10\" />" << std::endl
 				<< "    </Read>" << std::endl
 				<< "  </DataNode>" << std::endl;
 	std::vector<xercesc::DOMNode*> nodes;
@@ -808,29 +1778,30 @@ void AbstractNodeTest::testLoadTee()
 	MockDataProxyClient client;
 
 	TestableNode node( "name", client, *nodes[0] );
-	std::string data( "this is some data that will be teed & returned" );
+	std::string data( "this is more data than the cache can hold" );
 	node.SetDataToReturn( data );
 
 	std::map<std::string,std::string> parameters;
 	parameters[ "name1" ] = "value1";
 
-	std::stringstream results;
-	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
-
+	// the result is still returned in full, but each load goes to the node
 	std::stringstream expected;
-	expected << "Store called with Name: teeName Parameters: " << ProxyUtilities::ToString( parameters ) << " Data: " << data << std::endl;
-	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
-
-	CPPUNIT_ASSERT_EQUAL( data, results.str() );
+	for( int i = 0; i < 2; ++i )
+	{
+		std::stringstream results;
+		CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+		CPPUNIT_ASSERT_EQUAL( data, results.str() );
+		expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	}
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
 }
 
-void AbstractNodeTest::testLoadTee_UseTranslatedParams_False()
+void AbstractNodeTest::testLoadCache_Transaction()
 {
 	std::stringstream xmlContents;
 	xmlContents << "  <DataNode>" << std::endl
 				<< "    <Read>" << std::endl
-				<< "      <TranslateParameters> <Parameter name=\"name2\" valueOverride=\"override2\" /> </TranslateParameters>" << std::endl
-				<< "      <Tee forwardTo=\"teeName\" forwardTranslatedParameters=\"false\"/>" << std::endl
+				<< "      <Cache ttl=\"60\" maxBytes=\"1000\" />" << std::endl
 				<< "    </Read>" << std::endl
 				<< "  </DataNode>" << std::endl;
 	std::vector<xercesc::DOMNode*> nodes;
@@ -840,29 +1811,45 @@ void AbstractNodeTest::testLoadTee_UseTranslatedParams_False()
 	MockDataProxyClient client;
 
 	TestableNode node( "name", client, *nodes[0] );
-	std::string data( "this is some data that will be teed & returned" );
-	node.SetDataToReturn( data );
+	node.SetDataToReturn( "committed data" );
 
 	std::map<std::string,std::string> parameters;
 	parameters[ "name1" ] = "value1";
 
 	std::stringstream results;
 	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "committed data" ), results.str() );
 
 	std::stringstream expected;
-	expected << "Store called with Name: teeName Parameters: " << ProxyUtilities::ToString( parameters ) << " Data: " << data << std::endl;
-	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
 
-	CPPUNIT_ASSERT_EQUAL( data, results.str() );
+	// inside a transaction, loads go to the node (which may hold the transaction's writes), and their results aren't cached
+	client.BeginTransaction();
+	node.SetDataToReturn( "uncommitted data" );
+	for( int i = 0; i < 2; ++i )
+	{
+		results.str( "" );
+		CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+		CPPUNIT_ASSERT_EQUAL( std::string( "uncommitted data" ), results.str() );
+		expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	}
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
+
+	// outside it, the cache is used again
+	client.Rollback();
+	results.str( "" );
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "committed data" ), results.str() );
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
 }
 
-void AbstractNodeTest::testLoadTee_UseTranslatedParams_True()
+void AbstractNodeTest::testLoadCache_ClearedByWrites()
 {
 	std::stringstream xmlContents;
 	xmlContents << "  <DataNode>" << std::endl
 				<< "    <Read>" << std::endl
-				<< "      <TranslateParameters> <Parameter name=\"name2\" valueOverride=\"override2\" /> </TranslateParameters>" << std::endl
-				<< "      <Tee forwardTo=\"teeName\" forwardTranslatedParameters=\"true\"/>" << std::endl
+				<< "      <Cache ttl=\"60\" maxBytes=\"1000\" />" << std::endl
 				<< "    </Read>" << std::endl
 				<< "  </DataNode>" << std::endl;
 	std::vector<xercesc::DOMNode*> nodes;
@@ -872,37 +1859,54 @@ void AbstractNodeTest::testLoadTee_UseTranslatedParams_True()
 	MockDataProxyClient client;
 
 	TestableNode node( "name", client, *nodes[0] );
-	std::string data( "this is some data that will be teed & returned" );
-	node.SetDataToReturn( data );
 
 	std::map<std::string,std::string> parameters;
 	parameters[ "name1" ] = "value1";
 
+	std::stringstream expected;
 	std::stringstream results;
+	node.SetDataToReturn( "data 1" );
 	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
-	parameters[ "name2" ] = "override2";
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
 
-	std::stringstream expected;
-	expected << "Store called with Name: teeName Parameters: " << ProxyUtilities::ToString( parameters ) << " Data: " << data << std::endl;
-	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+	// a store drops the cached result
+	std::stringstream data( "data 2" );
+	CPPUNIT_ASSERT_NO_THROW( node.Store( parameters, data ) );
+	expected << "StoreImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << " with data: data 2" << std::endl;
+	node.SetDataToReturn( "data 2" );
+	results.str( "" );
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "data 2" ), results.str() );
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
 
-	CPPUNIT_ASSERT_EQUAL( data, results.str() );
+	// as does a delete, even one that fails
+	node.SetDeleteException( true );
+	CPPUNIT_ASSERT_THROW( node.Delete( parameters ), MVException );
+	expected << "DeleteImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	node.SetDataToReturn( "" );
+	results.str( "" );
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "" ), results.str() );
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
+
+	// & an explicit clear (e.g. on commit)
+	node.SetDataToReturn( "data 3" );
+	node.ClearCache();
+	results.str( "" );
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "data 3" ), results.str() );
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
 }
 
-void AbstractNodeTest::testLoadTee_UseTransformedStream_False()
+void AbstractNodeTest::testLoadCoalesce()
 {
-	std::string m_LibrarySpec;
-	TransformerTestHelpers::SetupLibraryFile( m_pTempDir->GetDirectoryName(), m_LibrarySpec );
-
 	std::stringstream xmlContents;
 	xmlContents << "  <DataNode>" << std::endl
 				<< "    <Read>" << std::endl
-			 	<< "      <StreamTransformers>" << std::endl
-				<< "		 <StreamTransformer path=\"" << m_LibrarySpec << "\"" << " functionName=\"TransformFunction\">" << std::endl
-				<< " 		  	<Parameter name=\"st_param1\" value=\"st_value1\" /> " << std::endl
-				<< "	     </StreamTransformer>" << std::endl
-				<< "      </StreamTransformers>" << std::endl
-				<< "      <Tee forwardTo=\"teeName\" forwardTransformedStream=\"false\" />" << std::endl
+				<< "      <Coalesce />" << std::endl
 				<< "    </Read>" << std::endl
 				<< "  </DataNode>" << std::endl;
 	std::vector<xercesc::DOMNode*> nodes;
@@ -912,37 +1916,52 @@ void AbstractNodeTest::testLoadTee_UseTransformedStream_False()
 	MockDataProxyClient client;
 
 	TestableNode node( "name", client, *nodes[0] );
-	std::string data( "this is some data that will be teed & returned" );
+	std::string data( "shared data" );
 	node.SetDataToReturn( data );
+	node.HoldLoads();
 
 	std::map<std::string,std::string> parameters;
 	parameters[ "name1" ] = "value1";
 
-	std::stringstream results;
-	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
-	std::string additionalData( "st_param1 : st_value1\n" );
-
+	// the first load leads; the rest arrive while it is still loading and share its result
+	const size_t numLoads( 5 );
+	std::stringstream results[ numLoads ];
+	boost::thread_group loads;
+	loads.create_thread( boost::bind( &LoadInto, boost::ref( node ), boost::cref( parameters ), boost::ref( results[0] ) ) );
+	node.WaitForLoadsStarted( 1 );
+	for( size_t i = 1; i < numLoads; ++i )
+	{
+		loads.create_thread( boost::bind( &LoadInto, boost::ref( node ), boost::cref( parameters ), boost::ref( results[i] ) ) );
+	}
+	while( node.GetCoalescedLoadCount() < numLoads - 1 )
+	{
+		boost::this_thread::yield();
+	}
+	node.ReleaseLoads();
+	loads.join_all();
+
+	for( size_t i = 0; i < numLoads; ++i )
+	{
+		CPPUNIT_ASSERT_EQUAL( data, results[i].str() );
+	}
 	std::stringstream expected;
-	expected << "Store called with Name: teeName Parameters: " << ProxyUtilities::ToString( parameters ) << " Data: " << data << std::endl;
-	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
 
-	CPPUNIT_ASSERT_EQUAL( additionalData + data, results.str() );
+	// once complete, nothing is held on to: the next load goes to the node
+	std::stringstream nextResults;
+	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, nextResults ) );
+	CPPUNIT_ASSERT_EQUAL( data, nextResults.str() );
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
 }
 
-void AbstractNodeTest::testLoadTee_UseTransformedStream_True()
+void AbstractNodeTest::testLoadCoalesceFailure()
 {
-	std::string m_LibrarySpec;
-	TransformerTestHelpers::SetupLibraryFile( m_pTempDir->GetDirectoryName(), m_LibrarySpec );
-
 	std::stringstream xmlContents;
 	xmlContents << "  <DataNode>" << std::endl
 				<< "    <Read>" << std::endl
-			 	<< "      <StreamTransformers>" << std::endl
-				<< "		 <StreamTransformer path=\"" << m_LibrarySpec << "\"" << " functionName=\"TransformFunction\">" << std::endl
-				<< " 		  	<Parameter name=\"st_param1\" value=\"st_value1\" /> " << std::endl
-				<< "	     </StreamTransformer>" << std::endl
-				<< "      </StreamTransformers>" << std::endl
-				<< "      <Tee forwardTo=\"teeName\" forwardTransformedStream=\"true\"/>" << std::endl
+				<< "      <Coalesce />" << std::endl
 				<< "    </Read>" << std::endl
 				<< "  </DataNode>" << std::endl;
 	std::vector<xercesc::DOMNode*> nodes;
@@ -952,49 +1971,85 @@ void AbstractNodeTest::testLoadTee_UseTransformedStream_True()
 	MockDataProxyClient client;
 
 	TestableNode node( "name", client, *nodes[0] );
-	std::string data( "this is some data that will be teed & returned" );
-	node.SetDataToReturn( data );
+	node.SetLoadException( true );
+	node.HoldLoads();
 
 	std::map<std::string,std::string> parameters;
 	parameters[ "name1" ] = "value1";
 
-	std::stringstream results;
-	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
-	std::string additionalData( "st_param1 : st_value1\n" );
-
+	// the leader fails; the loads waiting on it fail with its error (and would be forwarded, if the node forwarded
+	// failures) without going to the node themselves
+	const size_t numLoads( 5 );
+	std::stringstream results[ numLoads ];
+	std::string errors[ numLoads ];
+	boost::thread_group loads;
+	loads.create_thread( boost::bind( &TryLoadInto, boost::ref( node ), boost::cref( parameters ), boost::ref( results[0] ), boost::ref( errors[0] ) ) );
+	node.WaitForLoadsStarted( 1 );
+	for( size_t i = 1; i < numLoads; ++i )
+	{
+		loads.create_thread( boost::bind( &TryLoadInto, boost::ref( node ), boost::cref( parameters ), boost::ref( results[i] ), boost::ref( errors[i] ) ) );
+	}
+	while( node.GetCoalescedLoadCount() < numLoads - 1 )
+	{
+		boost::this_thread::yield();
+	}
+	node.ReleaseLoads();
+	loads.join_all();
+
+	CPPUNIT_ASSERT_MESSAGE( errors[0], boost::regex_match( errors[0], boost::regex( ".*:\\d+: Set to throw exception" ) ) );
+	for( size_t i = 1; i < numLoads; ++i )
+	{
+		CPPUNIT_ASSERT_MESSAGE( errors[i], boost::regex_match( errors[i],
+			boost::regex( ".*:\\d+: Identical load in flight failed: .*:\\d+: Set to throw exception" ) ) );
+		CPPUNIT_ASSERT_EQUAL( std::string(), results[i].str() );
+	}
 	std::stringstream expected;
-	expected << "Store called with Name: teeName Parameters: " << ProxyUtilities::ToString( parameters ) << " Data: "
-			 << additionalData << data << std::endl;
-	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
-
-	CPPUNIT_ASSERT_EQUAL( additionalData + data, results.str() );
+	expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
 }
 
-void AbstractNodeTest::testLoadOperationIgnore()
+void AbstractNodeTest::testLoadCoalesce_Transaction()
 {
 	std::stringstream xmlContents;
 	xmlContents << "  <DataNode>" << std::endl
-				<< "    <Read operation=\"ignore\">" << std::endl
+				<< "    <Read>" << std::endl
+				<< "      <Coalesce />" << std::endl
+				<< "    </Read>" << std::endl
 				<< "  </DataNode>" << std::endl;
 	std::vector<xercesc::DOMNode*> nodes;
 	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
 	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
 
 	MockDataProxyClient client;
+	client.BeginTransaction();
 
 	TestableNode node( "name", client, *nodes[0] );
+	std::string data( "uncommitted data" );
+	node.SetDataToReturn( data );
+	node.HoldLoads();
 
 	std::map<std::string,std::string> parameters;
-	parameters["param1"] = "value1";
-	parameters["param2"] = "value2";
-	parameters["param3"] = "value3";
-	parameters["param4"] = "value4";
-
-	std::stringstream results;
+	parameters[ "name1" ] = "value1";
 
-	CPPUNIT_ASSERT_NO_THROW( node.Load( parameters, results ) );
+	// inside a transaction, identical loads in flight at once each go to the node rather than sharing a result
+	const size_t numLoads( 3 );
+	std::stringstream results[ numLoads ];
+	boost::thread_group loads;
+	for( size_t i = 0; i < numLoads; ++i )
+	{
+		loads.create_thread( boost::bind( &LoadInto, boost::ref( node ), boost::cref( parameters ), boost::ref( results[i] ) ) );
+	}
+	node.WaitForLoadsStarted( numLoads );
+	CPPUNIT_ASSERT_EQUAL( size_t(0), node.GetCoalescedLoadCount() );
+	node.ReleaseLoads();
+	loads.join_all();
 
 	std::stringstream expected;
+	for( size_t i = 0; i < numLoads; ++i )
+	{
+		CPPUNIT_ASSERT_EQUAL( data, results[i].str() );
+		expected << "LoadImpl called with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	}
 	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
 }
 
@@ -1025,10 +2080,12 @@ void AbstractNodeTest::testLoadSuccessMonitoring()
 
 	CPPUNIT_ASSERT_NO_THROW( node.Load( std::map< std::string, std::string >(), *output ) );
 
-	const std::vector< std::pair< std::string, MonitoringMetric > >& rReports = pMonitoringInstance->GetReports();
-	CPPUNIT_ASSERT_EQUAL( size_t(9), rReports.size() );
-	CPPUNIT_ASSERT_DOUBLES_EQUAL( double( cnt.characters() ), rReports[0].second.GetDouble(), 1e-9 );
-	CPPUNIT_ASSERT_DOUBLES_EQUAL( double( cnt.lines() ), rReports[3].second.GetDouble(), 1e-9 );
+	const ReportList& rReports = pMonitoringInstance->GetReports();
+	CPPUNIT_ASSERT_EQUAL( std::string( "impl" ), GetReportedPhases( rReports ) );
+	ReportList payloadReports = GetPayloadReports( rReports );
+	CPPUNIT_ASSERT_EQUAL( size_t(9), payloadReports.size() );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( double( cnt.characters() ), payloadReports[0].second.GetDouble(), 1e-9 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( double( cnt.lines() ), payloadReports[3].second.GetDouble(), 1e-9 );
 }
 
 void AbstractNodeTest::testLoadFailedMonitoring()
@@ -1053,8 +2110,10 @@ void AbstractNodeTest::testLoadFailedMonitoring()
 	std::string str( "original node data" );
 	node.SetDataToReturn( str );
 
-	const std::vector< std::pair< std::string, MonitoringMetric > >& rReports = pMonitoringInstance->GetReports();
-	CPPUNIT_ASSERT_EQUAL( size_t(3), rReports.size() );
+	const ReportList& rReports = pMonitoringInstance->GetReports();
+	CPPUNIT_ASSERT_EQUAL( std::string( "impl" ), GetReportedPhases( rReports ) );
+	ReportList payloadReports = GetPayloadReports( rReports );
+	CPPUNIT_ASSERT_EQUAL( size_t(3), payloadReports.size() );
 }
 
 void AbstractNodeTest::testStore()
@@ -1266,8 +2325,10 @@ void AbstractNodeTest::testStoreTransformStream()
 	expected << "StoreImpl called with parameters: " << ProxyUtilities::ToString( expectedParameters ) << " with data: " << data.str() << std::endl;
 	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
 
-	const std::vector< std::pair< std::string, MonitoringMetric > >& rReports = pMonitoringInstance->GetReports();	
-	CPPUNIT_ASSERT_EQUAL( size_t(35), rReports.size() );
+	const ReportList& rReports = pMonitoringInstance->GetReports();
+	CPPUNIT_ASSERT_EQUAL( std::string( "translate impl transform" ), GetReportedPhases( rReports ) );
+	ReportList payloadReports = GetPayloadReports( rReports );
+	CPPUNIT_ASSERT_EQUAL( size_t(35), payloadReports.size() );
 }
 
 void AbstractNodeTest::testStoreRetryCount()
@@ -1664,10 +2725,12 @@ void AbstractNodeTest::testStoreSuccessMonitoring()
 	input->push( data );
 	CPPUNIT_ASSERT_NO_THROW( node.Store( std::map< std::string, std::string >(), *input ) );
 
-	const std::vector< std::pair< std::string, MonitoringMetric > >& rReports = pMonitoringInstance->GetReports();
-	CPPUNIT_ASSERT_EQUAL( size_t(9), rReports.size() );
-	CPPUNIT_ASSERT_DOUBLES_EQUAL( cnt.characters(), rReports[0].second.GetDouble(), 1e-9 );	
-	CPPUNIT_ASSERT_DOUBLES_EQUAL( cnt.lines(), rReports[3].second.GetDouble(), 1e-9 );	
+	const ReportList& rReports = pMonitoringInstance->GetReports();
+	CPPUNIT_ASSERT_EQUAL( std::string( "impl" ), GetReportedPhases( rReports ) );
+	ReportList payloadReports = GetPayloadReports( rReports );
+	CPPUNIT_ASSERT_EQUAL( size_t(9), payloadReports.size() );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( cnt.characters(), payloadReports[0].second.GetDouble(), 1e-9 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( cnt.lines(), payloadReports[3].second.GetDouble(), 1e-9 );
 }
 
 void AbstractNodeTest::testStoreFailedMonitoring()
@@ -1691,8 +2754,10 @@ void AbstractNodeTest::testStoreFailedMonitoring()
 	node.SetStoreException( true );
 	CPPUNIT_ASSERT_THROW( node.Store( std::map< std::string, std::string >(), data ), MVException );
 
-	const std::vector< std::pair< std::string, MonitoringMetric > >& rReports = pMonitoringInstance->GetReports();
-	CPPUNIT_ASSERT_EQUAL( size_t(3), rReports.size() );
+	const ReportList& rReports = pMonitoringInstance->GetReports();
+	CPPUNIT_ASSERT_EQUAL( std::string( "impl" ), GetReportedPhases( rReports ) );
+	ReportList payloadReports = GetPayloadReports( rReports );
+	CPPUNIT_ASSERT_EQUAL( size_t(3), payloadReports.size() );
 }
 
 void AbstractNodeTest::testDelete()
@@ -2038,8 +3103,10 @@ void AbstractNodeTest::testDeleteSuccessMonitoring()
 	TestableNode node( "name", client, *nodes[0] );
 	CPPUNIT_ASSERT_NO_THROW( node.Delete( std::map< std::string, std::string >() ) );
 
-	const std::vector< std::pair< std::string, MonitoringMetric > >& rReports = pMonitoringInstance->GetReports();
-	CPPUNIT_ASSERT_EQUAL( size_t(3), rReports.size() );
+	const ReportList& rReports = pMonitoringInstance->GetReports();
+	CPPUNIT_ASSERT_EQUAL( std::string( "impl" ), GetReportedPhases( rReports ) );
+	ReportList payloadReports = GetPayloadReports( rReports );
+	CPPUNIT_ASSERT_EQUAL( size_t(3), payloadReports.size() );
 }
 
 void AbstractNodeTest::testDeleteFailedMonitoring()
@@ -2061,7 +3128,55 @@ void AbstractNodeTest::testDeleteFailedMonitoring()
 	node.SetDeleteException( true );
 	CPPUNIT_ASSERT_THROW( node.Delete( std::map< std::string, std::string >() ) , MVException );
 
-	const std::vector< std::pair< std::string, MonitoringMetric > >& rReports = pMonitoringInstance->GetReports();
-	CPPUNIT_ASSERT_EQUAL( size_t(3), rReports.size() );
+	const ReportList& rReports = pMonitoringInstance->GetReports();
+	CPPUNIT_ASSERT_EQUAL( std::string( "impl" ), GetReportedPhases( rReports ) );
+	ReportList payloadReports = GetPayloadReports( rReports );
+	CPPUNIT_ASSERT_EQUAL( size_t(3), payloadReports.size() );
 }
 
+void AbstractNodeTest::testStoreForwardOnlyInput()
+{
+	std::stringstream xmlContents;
+	xmlContents << "  <DataNode>" << std::endl
+				<< "    <Write>" << std::endl
+				<< "      <TranslateParameters>" << std::endl
+				<< "        <Parameter name=\"byteCount\" valueOverride=\"[byteCount]\" />" << std::endl
+				<< "      </TranslateParameters>" << std::endl
+				<< "      <OnFailure retryCount=\"1\" forwardTo=\"failureName\" />" << std::endl
+				<< "      <Staging memoryLimit=\"10\" workingDir=\"" << m_pTempDir->GetDirectoryName() << "\" />" << std::endl
+				<< "    </Write>" << std::endl
+				<< "  </DataNode>" << std::endl;
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	MockDataProxyClient client;
+
+	TestableNode node( "name", client, *nodes[0] );
+	node.SetStoreException( true );
+	node.SetSeekOnStore( true );
+
+	std::map<std::string,std::string> parameters;
+	parameters["param1"] = "value1";
+
+	// the input chain can't seek, so everything that rewinds it (the byte count, the retry & the
+	// failure forward) has to be served from the spooled copy
+	std::string data( "this is some data that is longer than the memory limit" );
+	std::stringstream source( data );
+	boost::iostreams::filtering_istream forwardOnly;
+	forwardOnly.push( source );
+
+	CPPUNIT_ASSERT_NO_THROW( CPPUNIT_ASSERT( !node.Store( parameters, forwardOnly ) ) );
+
+	std::map<std::string,std::string> translatedParameters( parameters );
+	translatedParameters["byteCount"] = boost::lexical_cast< std::string >( data.size() );
+
+	std::stringstream expected;
+	expected << "StoreImpl called with parameters: " << ProxyUtilities::ToString( translatedParameters ) << " with data: " << data << std::endl;
+	expected << "StoreImpl called with parameters: " << ProxyUtilities::ToString( translatedParameters ) << " with data: " << data << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), node.GetLog() );
+
+	expected.str("");
+	expected << "Store called with Name: failureName Parameters: " << ProxyUtilities::ToString( parameters ) << " Data: " << data << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), client.GetLog() );
+}
@@ -29,16 +29,31 @@ private:
 	CPPUNIT_TEST( testLoadRequiredParameters );
 	CPPUNIT_TEST( testLoadTransformStream );
 	CPPUNIT_TEST( testLoadRetryCount );
+	CPPUNIT_TEST( testLoadRetryUntilFirstByte );
+	CPPUNIT_TEST( testLoadRetryUntilFirstByteFailureForwarding );
 	CPPUNIT_TEST( testLoadFailureForwarding );
 	CPPUNIT_TEST( testLoadFailureForwarding_ParameterTranslationFail );
 	CPPUNIT_TEST( testLoadFailureForwarding_ParameterValidationFail );
 	CPPUNIT_TEST( testLoadFailureForwarding_UseTranslatedParams_False );
 	CPPUNIT_TEST( testLoadFailureForwarding_UseTranslatedParams_True );
 	CPPUNIT_TEST( testLoadTee );
+	CPPUNIT_TEST( testLoadStaging );
+	CPPUNIT_TEST( testLoadCache );
+	CPPUNIT_TEST( testLoadCache_TooLarge );
+	CPPUNIT_TEST( testLoadCache_Transaction );
+	CPPUNIT_TEST( testLoadCache_ClearedByWrites );
+	CPPUNIT_TEST( testLoadCoalesce );
+	CPPUNIT_TEST( testLoadCoalesceFailure );
+	CPPUNIT_TEST( testLoadCoalesce_Transaction );
 	CPPUNIT_TEST( testLoadTee_UseTranslatedParams_False );
 	CPPUNIT_TEST( testLoadTee_UseTranslatedParams_True );
 	CPPUNIT_TEST( testLoadTee_UseTransformedStream_False );
 	CPPUNIT_TEST( testLoadTee_UseTransformedStream_True );
+	CPPUNIT_TEST( testLoadTee_Concurrent );
+	CPPUNIT_TEST( testLoadTee_Concurrent_UseTransformedStream );
+	CPPUNIT_TEST( testLoadTee_Concurrent_Failure );
+	CPPUNIT_TEST( testLoadTee_Concurrent_Async );
+	CPPUNIT_TEST( testLoadTee_Concurrent_IntoNode );
 	CPPUNIT_TEST( testLoadOperationIgnore );
 	CPPUNIT_TEST( testLoadSuccessMonitoring );
 	CPPUNIT_TEST( testLoadFailedMonitoring );
@@ -60,6 +75,7 @@ private:
 	CPPUNIT_TEST( testStoreOperationIgnore ); 
 	CPPUNIT_TEST( testStoreSuccessMonitoring );
 	CPPUNIT_TEST( testStoreFailedMonitoring );
+	CPPUNIT_TEST( testStoreForwardOnlyInput );
 
 	CPPUNIT_TEST( testDelete );
 	CPPUNIT_TEST( testDeleteTranslateParameters );
@@ -90,16 +106,31 @@ public:
 	void testLoadRequiredParameters();
 	void testLoadTransformStream();
 	void testLoadRetryCount();
+	void testLoadRetryUntilFirstByte();
+	void testLoadRetryUntilFirstByteFailureForwarding();
 	void testLoadFailureForwarding();
 	void testLoadFailureForwarding_ParameterTranslationFail();
 	void testLoadFailureForwarding_ParameterValidationFail();
 	void testLoadFailureForwarding_UseTranslatedParams_False();
 	void testLoadFailureForwarding_UseTranslatedParams_True();
 	void testLoadTee();
+	void testLoadStaging();
+	void testLoadCache();
+	void testLoadCache_TooLarge();
+	void testLoadCache_Transaction();
+	void testLoadCache_ClearedByWrites();
+	void testLoadCoalesce();
+	void testLoadCoalesceFailure();
+	void testLoadCoalesce_Transaction();
 	void testLoadTee_UseTranslatedParams_False();
 	void testLoadTee_UseTranslatedParams_True();
 	void testLoadTee_UseTransformedStream_False();
 	void testLoadTee_UseTransformedStream_True();
+	void testLoadTee_Concurrent();
+	void testLoadTee_Concurrent_UseTransformedStream();
+	void testLoadTee_Concurrent_Failure();
+	void testLoadTee_Concurrent_Async();
+	void testLoadTee_Concurrent_IntoNode();
 	void testLoadOperationIgnore();
 	void testLoadSuccessMonitoring();
 	void testLoadFailedMonitoring();
@@ -121,6 +152,7 @@ public:
 	void testStoreOperationIgnore(); 
 	void testStoreSuccessMonitoring();
 	void testStoreFailedMonitoring();
+	void testStoreForwardOnlyInput();
 
 	void testDelete();
 	void testDeleteTranslateParameters();
@@ -0,0 +1,266 @@
+#include "ConfigChangeDetectorTest.hpp"
+#include "ConfigChangeDetector.hpp"
+#include "TempDirectory.hpp"
+#include <fstream>
+#include <stdio.h>
+#include <utime.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ConfigChangeDetectorTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( ConfigChangeDetectorTest, "ConfigChangeDetectorTest" );
+
+namespace
+{
+	void WriteFile( const std::string& i_rFileSpec, const std::string& i_rContents )
+	{
+		std::ofstream file( i_rFileSpec.c_str() );
+		file << i_rContents;
+		file.close();
+	}
+
+	// the files in these tests have all just been written, so they would be considered too recently
+	// changed to fingerprint; pretend that they were read sometime in the near future instead
+	time_t FutureReadTime()
+	{
+		return ::time( NULL ) + 10;
+	}
+}
+
+ConfigChangeDetectorTest::ConfigChangeDetectorTest()
+:	m_pTempDir( NULL )
+{
+}
+
+ConfigChangeDetectorTest::~ConfigChangeDetectorTest()
+{
+}
+
+void ConfigChangeDetectorTest::setUp()
+{
+	m_pTempDir.reset( new TempDirectory() );
+}
+
+void ConfigChangeDetectorTest::tearDown()
+{
+	m_pTempDir.reset( NULL );
+}
+
+void ConfigChangeDetectorTest::testNotAcknowledged()
+{
+	std::string configFileSpec( m_pTempDir->GetDirectoryName() + "/config.xml" );
+	WriteFile( configFileSpec, "<DPLConfig />" );
+
+	ConfigChangeDetector detector;
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+}
+
+void ConfigChangeDetectorTest::testUnchanged()
+{
+	std::string configFileSpec( m_pTempDir->GetDirectoryName() + "/config.xml" );
+	WriteFile( configFileSpec, "<DPLConfig />" );
+
+	ConfigChangeDetector detector;
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+	detector.Acknowledge( configFileSpec, std::vector< std::string >(), FutureReadTime() );
+	CPPUNIT_ASSERT( !detector.HasChanged( configFileSpec ) );
+	CPPUNIT_ASSERT( !detector.HasChanged( configFileSpec ) );
+}
+
+void ConfigChangeDetectorTest::testDifferentFile()
+{
+	std::string configFileSpec( m_pTempDir->GetDirectoryName() + "/config.xml" );
+	std::string otherFileSpec( m_pTempDir->GetDirectoryName() + "/other.xml" );
+	WriteFile( configFileSpec, "<DPLConfig />" );
+	WriteFile( otherFileSpec, "<DPLConfig />" );
+
+	ConfigChangeDetector detector;
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+	detector.Acknowledge( configFileSpec, std::vector< std::string >(), FutureReadTime() );
+	CPPUNIT_ASSERT( detector.HasChanged( otherFileSpec ) );
+
+	// acknowledging a file other than the one being checked has no effect
+	detector.Acknowledge( configFileSpec, std::vector< std::string >(), FutureReadTime() );
+	CPPUNIT_ASSERT( detector.HasChanged( otherFileSpec ) );
+}
+
+void ConfigChangeDetectorTest::testContentChanged()
+{
+	std::string configFileSpec( m_pTempDir->GetDirectoryName() + "/config.xml" );
+	WriteFile( configFileSpec, "<DPLConfig />" );
+
+	ConfigChangeDetector detector;
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+	detector.Acknowledge( configFileSpec, std::vector< std::string >(), FutureReadTime() );
+	CPPUNIT_ASSERT( !detector.HasChanged( configFileSpec ) );
+
+	WriteFile( configFileSpec, "<DPLConfig></DPLConfig>" );
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+	// stays changed until acknowledged
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+	detector.Acknowledge( configFileSpec, std::vector< std::string >(), FutureReadTime() );
+	CPPUNIT_ASSERT( !detector.HasChanged( configFileSpec ) );
+}
+
+void ConfigChangeDetectorTest::testTimestampChanged()
+{
+	std::string configFileSpec( m_pTempDir->GetDirectoryName() + "/config.xml" );
+	WriteFile( configFileSpec, "<DPLConfig />" );
+
+	ConfigChangeDetector detector;
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+	detector.Acknowledge( configFileSpec, std::vector< std::string >(), FutureReadTime() );
+	CPPUNIT_ASSERT( !detector.HasChanged( configFileSpec ) );
+
+	// same size, different timestamp
+	WriteFile( configFileSpec, "<DPLCONFIG />" );
+	struct utimbuf times;
+	times.actime = 1000;
+	times.modtime = 1000;
+	CPPUNIT_ASSERT_EQUAL( 0, ::utime( configFileSpec.c_str(), &times ) );
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+}
+
+void ConfigChangeDetectorTest::testFileReplaced()
+{
+	std::string configFileSpec( m_pTempDir->GetDirectoryName() + "/config.xml" );
+	std::string newFileSpec( m_pTempDir->GetDirectoryName() + "/config.xml.new" );
+	WriteFile( configFileSpec, "<DPLConfig />" );
+
+	ConfigChangeDetector detector;
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+	detector.Acknowledge( configFileSpec, std::vector< std::string >(), FutureReadTime() );
+	CPPUNIT_ASSERT( !detector.HasChanged( configFileSpec ) );
+
+	WriteFile( newFileSpec, "<DPLConfig />" );
+	CPPUNIT_ASSERT_EQUAL( 0, ::rename( newFileSpec.c_str(), configFileSpec.c_str() ) );
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+}
+
+void ConfigChangeDetectorTest::testFileRemoved()
+{
+	std::string configFileSpec( m_pTempDir->GetDirectoryName() + "/config.xml" );
+	WriteFile( configFileSpec, "<DPLConfig />" );
+
+	ConfigChangeDetector detector;
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+	detector.Acknowledge( configFileSpec, std::vector< std::string >(), FutureReadTime() );
+	CPPUNIT_ASSERT( !detector.HasChanged( configFileSpec ) );
+
+	CPPUNIT_ASSERT_EQUAL( 0, ::remove( configFileSpec.c_str() ) );
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+
+	// acknowledging a missing file is ignored
+	detector.Acknowledge( configFileSpec, std::vector< std::string >(), FutureReadTime() );
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+}
+
+void ConfigChangeDetectorTest::testEntityChanged()
+{
+	std::string configFileSpec( m_pTempDir->GetDirectoryName() + "/config.xml" );
+	std::string entityFileSpec( m_pTempDir->GetDirectoryName() + "/entity.xml" );
+	WriteFile( configFileSpec, "<DPLConfig>&contents;</DPLConfig>" );
+	WriteFile( entityFileSpec, "<DataNode name=\"n\" type=\"type1\" />" );
+
+	std::vector< std::string > entities;
+	entities.push_back( entityFileSpec );
+
+	ConfigChangeDetector detector;
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+	detector.Acknowledge( configFileSpec, entities, FutureReadTime() );
+	CPPUNIT_ASSERT( !detector.HasChanged( configFileSpec ) );
+
+	WriteFile( entityFileSpec, "<DataNode name=\"name1\" type=\"type1\" />" );
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+}
+
+void ConfigChangeDetectorTest::testRecentlyChanged()
+{
+	std::string configFileSpec( m_pTempDir->GetDirectoryName() + "/config.xml" );
+	WriteFile( configFileSpec, "<DPLConfig />" );
+
+	ConfigChangeDetector detector;
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+	detector.Acknowledge( configFileSpec, std::vector< std::string >(), ::time( NULL ) );
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+}
+
+void ConfigChangeDetectorTest::testMinimumRecheck()
+{
+	std::string configFileSpec( m_pTempDir->GetDirectoryName() + "/config.xml" );
+	WriteFile( configFileSpec, "<DPLConfig />" );
+
+	ConfigChangeDetector detector;
+	detector.SetOptions( 3600, false );
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+	detector.Acknowledge( configFileSpec, std::vector< std::string >(), FutureReadTime() );
+
+	// change is not noticed until the recheck interval elapses
+	WriteFile( configFileSpec, "<DPLConfig></DPLConfig>" );
+	CPPUNIT_ASSERT( !detector.HasChanged( configFileSpec ) );
+
+	// changing the options forces a recheck
+	detector.SetOptions( 0, false );
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+}
+
+void ConfigChangeDetectorTest::testFileNotification()
+{
+	std::string configFileSpec( m_pTempDir->GetDirectoryName() + "/config.xml" );
+	std::string entityFileSpec( m_pTempDir->GetDirectoryName() + "/entity.xml" );
+	std::string unrelatedFileSpec( m_pTempDir->GetDirectoryName() + "/unrelated.xml" );
+	WriteFile( configFileSpec, "<DPLConfig>&contents;</DPLConfig>" );
+	WriteFile( entityFileSpec, "<DataNode name=\"n\" type=\"type1\" />" );
+
+	std::vector< std::string > entities;
+	entities.push_back( entityFileSpec );
+
+	ConfigChangeDetector detector;
+	detector.SetOptions( 0, true );
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+	detector.Acknowledge( configFileSpec, entities, FutureReadTime() );
+	CPPUNIT_ASSERT( !detector.HasChanged( configFileSpec ) );
+
+	// other files in the same directory are not of interest
+	WriteFile( unrelatedFileSpec, "unrelated" );
+	CPPUNIT_ASSERT( !detector.HasChanged( configFileSpec ) );
+
+	WriteFile( entityFileSpec, "<DataNode name=\"name1\" type=\"type1\" />" );
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+	detector.Acknowledge( configFileSpec, entities, FutureReadTime() );
+	CPPUNIT_ASSERT( !detector.HasChanged( configFileSpec ) );
+
+	WriteFile( configFileSpec, "<DPLConfig> &contents; </DPLConfig>" );
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+}
+
+void ConfigChangeDetectorTest::testFileNotificationReplaced()
+{
+	std::string configFileSpec( m_pTempDir->GetDirectoryName() + "/config.xml" );
+	std::string newFileSpec( m_pTempDir->GetDirectoryName() + "/config.xml.new" );
+	WriteFile( configFileSpec, "<DPLConfig />" );
+
+	ConfigChangeDetector detector;
+	detector.SetOptions( 0, true );
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+	detector.Acknowledge( configFileSpec, std::vector< std::string >(), FutureReadTime() );
+
+	// writing the new file is not interesting, but moving it into place is
+	WriteFile( newFileSpec, "<DPLConfig />" );
+	CPPUNIT_ASSERT( !detector.HasChanged( configFileSpec ) );
+	CPPUNIT_ASSERT_EQUAL( 0, ::rename( newFileSpec.c_str(), configFileSpec.c_str() ) );
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+}
+
+void ConfigChangeDetectorTest::testReset()
+{
+	std::string configFileSpec( m_pTempDir->GetDirectoryName() + "/config.xml" );
+	WriteFile( configFileSpec, "<DPLConfig />" );
+
+	ConfigChangeDetector detector;
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+	detector.Acknowledge( configFileSpec, std::vector< std::string >(), FutureReadTime() );
+	CPPUNIT_ASSERT( !detector.HasChanged( configFileSpec ) );
+
+	detector.Reset();
+	CPPUNIT_ASSERT( detector.HasChanged( configFileSpec ) );
+}
@@ -0,0 +1,56 @@
+#ifndef _CONFIG_CHANGE_DETECTOR_TEST_HPP_
+#define _CONFIG_CHANGE_DETECTOR_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <boost/scoped_ptr.hpp>
+
+class TempDirectory;
+
+class ConfigChangeDetectorTest : public CppUnit::TestFixture
+{
+private:
+	CPPUNIT_TEST_SUITE( ConfigChangeDetectorTest );
+
+	CPPUNIT_TEST( testNotAcknowledged );
+	CPPUNIT_TEST( testUnchanged );
+	CPPUNIT_TEST( testDifferentFile );
+	CPPUNIT_TEST( testContentChanged );
+	CPPUNIT_TEST( testTimestampChanged );
+	CPPUNIT_TEST( testFileReplaced );
+	CPPUNIT_TEST( testFileRemoved );
+	CPPUNIT_TEST( testEntityChanged );
+	CPPUNIT_TEST( testRecentlyChanged );
+	CPPUNIT_TEST( testMinimumRecheck );
+	CPPUNIT_TEST( testFileNotification );
+	CPPUNIT_TEST( testFileNotificationReplaced );
+	CPPUNIT_TEST( testReset );
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	ConfigChangeDetectorTest();
+	virtual ~ConfigChangeDetectorTest();
+
+	void setUp();
+	void tearDown();
+
+	void testNotAcknowledged();
+	void testUnchanged();
+	void testDifferentFile();
+	void testContentChanged();
+	void testTimestampChanged();
+	void testFileReplaced();
+	void testFileRemoved();
+	void testEntityChanged();
+	void testRecentlyChanged();
+	void testMinimumRecheck();
+	void testFileNotification();
+	void testFileNotificationReplaced();
+	void testReset();
+
+private:
+	boost::scoped_ptr< TempDirectory > m_pTempDir;
+};
+
+#endif //_CONFIG_CHANGE_DETECTOR_TEST_HPP_
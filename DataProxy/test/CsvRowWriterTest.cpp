@@ -0,0 +1,121 @@
+#include "CsvRowWriterTest.hpp"
+#include "CsvRowWriter.hpp"
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION( CsvRowWriterTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( CsvRowWriterTest, "CsvRowWriterTest" );
+
+namespace
+{
+	std::vector< Nullable< std::string > > MakeRow( const std::string& i_rFirst, const Nullable< std::string >& i_rSecond, const std::string& i_rThird )
+	{
+		std::vector< Nullable< std::string > > result;
+		result.push_back( i_rFirst );
+		result.push_back( i_rSecond );
+		result.push_back( i_rThird );
+		return result;
+	}
+}
+
+CsvRowWriterTest::CsvRowWriterTest()
+{
+}
+
+CsvRowWriterTest::~CsvRowWriterTest()
+{
+}
+
+void CsvRowWriterTest::setUp()
+{
+}
+
+void CsvRowWriterTest::tearDown()
+{
+}
+
+void CsvRowWriterTest::testWriteRow()
+{
+	std::stringstream results;
+	CsvRowWriter writer( results, ",", "\n" );
+	writer.WriteRow( MakeRow( "1", std::string( "Alpha" ), "x" ) );
+	writer.WriteRow( MakeRow( "2", Nullable< std::string >(), "" ) );
+	writer.WriteRow( MakeRow( "3", std::string( "has,comma" ), "y" ) );
+
+	// nothing is written until the block is full or flushed
+	CPPUNIT_ASSERT_EQUAL( std::string( "" ), results.str() );
+	writer.Flush();
+
+	CPPUNIT_ASSERT_EQUAL( std::string( "1,Alpha,x\n2,,\n3,has,comma,y\n" ), results.str() );
+}
+
+void CsvRowWriterTest::testCustomSeparators()
+{
+	std::stringstream results;
+	CsvRowWriter writer( results, " | ", ";;;" );
+	writer.WriteRow( MakeRow( "1", std::string( "Alpha" ), "x" ) );
+	writer.WriteRow( MakeRow( "3", std::string( "Charlie" ), "y" ) );
+	writer.Flush();
+
+	CPPUNIT_ASSERT_EQUAL( std::string( "1 | Alpha | x;;;3 | Charlie | y;;;" ), results.str() );
+}
+
+void CsvRowWriterTest::testNullValue()
+{
+	std::stringstream results;
+	CsvRowWriter writer( results, ",", "\n" );
+	writer.SetNullValue( "\\N" );
+	writer.WriteRow( MakeRow( "1", Nullable< std::string >(), "" ) );
+	writer.WriteRow( MakeRow( "2", std::string( "\\N" ), "x" ) );
+	writer.Flush();
+
+	// without quoting, a value matching the null value is written as is
+	CPPUNIT_ASSERT_EQUAL( std::string( "1,\\N,\n2,\\N,x\n" ), results.str() );
+}
+
+void CsvRowWriterTest::testQuote()
+{
+	std::stringstream results;
+	CsvRowWriter writer( results, ",", "\n" );
+	writer.SetQuote( '"' );
+	writer.WriteRow( MakeRow( "1", std::string( "plain" ), "has,comma" ) );
+	writer.WriteRow( MakeRow( "2", std::string( "say \"hi\"" ), "two\nlines" ) );
+	writer.WriteRow( MakeRow( "3", Nullable< std::string >(), "" ) );
+	writer.WriteRow( MakeRow( "\"", std::string( "\"\"" ), "end\"" ) );
+	writer.Flush();
+
+	std::stringstream expected;
+	expected << "1,plain,\"has,comma\"\n"
+			 << "2,\"say \"\"hi\"\"\",\"two\nlines\"\n"
+			 << "3,,\"\"\n"
+			 << "\"\"\"\",\"\"\"\"\"\",\"end\"\"\"\n";
+	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
+
+	results.str( "" );
+	CsvRowWriter nullWriter( results, "\t", "\n" );
+	nullWriter.SetQuote( '\'' );
+	nullWriter.SetNullValue( "NULL" );
+	nullWriter.WriteRow( MakeRow( "NULL", Nullable< std::string >(), "it's\there" ) );
+	nullWriter.Flush();
+
+	CPPUNIT_ASSERT_EQUAL( std::string( "'NULL'\tNULL\t'it''s\there'\n" ), results.str() );
+}
+
+void CsvRowWriterTest::testBlocks()
+{
+	std::stringstream results;
+	CsvRowWriter writer( results, ",", "\n", 16 );
+
+	// 10 bytes per row: only the full block is written, even though it ends mid row
+	writer.WriteRow( MakeRow( "1", std::string( "abcd" ), "xy" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "" ), results.str() );
+	writer.WriteRow( MakeRow( "2", std::string( "efgh" ), "zw" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "1,abcd,xy\n2,efgh" ), results.str() );
+
+	// a field longer than the block is written straight through
+	std::string longField( 40, 'q' );
+	writer.WriteRow( MakeRow( "3", longField, "z" ) );
+	CPPUNIT_ASSERT_EQUAL( "1,abcd,xy\n2,efgh,zw\n3," + longField, results.str() );
+
+	writer.Flush();
+	CPPUNIT_ASSERT_EQUAL( "1,abcd,xy\n2,efgh,zw\n3," + longField + ",z\n", results.str() );
+}
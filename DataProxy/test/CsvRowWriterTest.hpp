@@ -0,0 +1,34 @@
+#ifndef _CSV_ROW_WRITER_TEST_HPP_
+#define _CSV_ROW_WRITER_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class CsvRowWriterTest : public CppUnit::TestFixture
+{
+private:
+	CPPUNIT_TEST_SUITE( CsvRowWriterTest );
+
+	CPPUNIT_TEST( testWriteRow );
+	CPPUNIT_TEST( testCustomSeparators );
+	CPPUNIT_TEST( testNullValue );
+	CPPUNIT_TEST( testQuote );
+	CPPUNIT_TEST( testBlocks );
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	CsvRowWriterTest();
+	virtual ~CsvRowWriterTest();
+
+	void setUp();
+	void tearDown();
+
+	void testWriteRow();
+	void testCustomSeparators();
+	void testNullValue();
+	void testQuote();
+	void testBlocks();
+};
+
+#endif //_CSV_ROW_WRITER_TEST_HPP_
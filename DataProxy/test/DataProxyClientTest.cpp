@@ -25,14 +25,96 @@
 #include <iostream>
 #include <unistd.h>
 #include <fstream>
+#include <algorithm>
 #include <boost/regex.hpp>
+#include <boost/bind.hpp>
+#include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/replace.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 
 CPPUNIT_TEST_SUITE_REGISTRATION( DataProxyClientTest );
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( DataProxyClientTest, "DataProxyClientTest" );
 
 namespace
 {
+	// lets one thread wait until another has reached a given point
+	class Signal
+	{
+	public:
+		Signal()
+		:	m_Set( false ),
+			m_Mutex(),
+			m_SetCondition()
+		{
+		}
+
+		void Set()
+		{
+			boost::unique_lock< boost::mutex > lock( m_Mutex );
+			m_Set = true;
+			m_SetCondition.notify_all();
+		}
+
+		void Wait()
+		{
+			boost::unique_lock< boost::mutex > lock( m_Mutex );
+			while( !m_Set )
+			{
+				m_SetCondition.wait( lock );
+			}
+		}
+
+	private:
+		bool m_Set;
+		boost::mutex m_Mutex;
+		boost::condition_variable m_SetCondition;
+	};
+
+	// publishes a new configuration from inside a request, and lets other requests wait until it has been published
+	class ConfigPublisher
+	{
+	public:
+		ConfigPublisher( TestableDataProxyClient& i_rClient, const std::string& i_rConfigFileSpec, INodeFactory& i_rNodeFactory )
+		:	m_rClient( i_rClient ),
+			m_ConfigFileSpec( i_rConfigFileSpec ),
+			m_rNodeFactory( i_rNodeFactory ),
+			m_Published()
+		{
+		}
+
+		void Publish()
+		{
+			try
+			{
+				m_rClient.Initialize( m_ConfigFileSpec, m_rNodeFactory );
+			}
+			catch( ... )
+			{
+				m_Published.Set();
+				throw;
+			}
+			m_Published.Set();
+		}
+
+		void WaitForPublish()
+		{
+			m_Published.Wait();
+		}
+
+	private:
+		TestableDataProxyClient& m_rClient;
+		std::string m_ConfigFileSpec;
+		INodeFactory& m_rNodeFactory;
+		Signal m_Published;
+	};
+
+	void SignalAndWait( Signal& o_rStarted, Signal& i_rRelease )
+	{
+		o_rStarted.Set();
+		i_rRelease.Wait();
+	}
 }
 
 DataProxyClientTest::DataProxyClientTest()
@@ -201,6 +283,36 @@ void DataProxyClientTest::testDatabaseConnectionsNode()
 	expected << "CreateNode called with Name: foo1 NodeType: DataNode" << std::endl;
 	expected << "CreateNode called with Name: foo2 NodeType: DataNode" << std::endl;
 	CPPUNIT_ASSERT_EQUAL( expected.str(), factory.GetLog() );
+
+	// the published configuration's connections are left alone by a re-initialization; it needs a manager of its own
+	file.open( fileSpec.c_str() );
+	file << "<DPLConfig>" << std::endl;
+	file << "  <DataNode name=\"foo3\" type=\"bar3\" />" << std::endl;
+	file << "  <DatabaseConnections>" << std::endl;
+	file << "     <MockDatabase" << std::endl;
+	file << "        mockConnectionName=\"node3db1\" " << std::endl;
+	file << "     />" << std::endl;
+	file << "  </DatabaseConnections>" << std::endl;
+	file << "</DPLConfig>" << std::endl;
+	file.close();
+
+	std::string managerLog( databaseConnectionManager.GetLog() );
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( client.Initialize( fileSpec, factory, databaseConnectionManager ), DataProxyClientException,
+		".*:\\d+: Attempted to re-initialize with the DatabaseConnectionManager used by the published configuration" );
+	CPPUNIT_ASSERT_EQUAL( managerLog, databaseConnectionManager.GetLog() );
+	std::map< std::string, std::string > parameters;
+	std::stringstream results;
+	CPPUNIT_ASSERT_NO_THROW( client.Load( "foo1", parameters, results ) );
+
+	MockDatabaseConnectionManager newDatabaseConnectionManager;
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( fileSpec, factory, newDatabaseConnectionManager ) );
+	expected.str("");
+	expected << "MockDatabaseConnectionManager::Parse" << std::endl
+			 << "Node: node3db1" << std::endl
+			 << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), newDatabaseConnectionManager.GetLog() );
+	CPPUNIT_ASSERT_EQUAL( managerLog, databaseConnectionManager.GetLog() );
+	CPPUNIT_ASSERT_NO_THROW( client.Load( "foo3", parameters, results ) );
 }
 
 void DataProxyClientTest::testStoreDeleteUnsuccessfulRollback()
@@ -885,6 +997,299 @@ void DataProxyClientTest::testAutoRollback()
 	CPPUNIT_ASSERT_EQUAL( expected.str(), factory.GetLog() );
 }
 
+void DataProxyClientTest::testLoadMany()
+{
+	std::string fileSpec( m_pTempDir->GetDirectoryName() + "/dataProxyConfig.xml" );
+	std::ofstream file( fileSpec.c_str() );
+
+	file << "<DPLConfig>" << std::endl
+		 << "  <DataNode name=\"name1\" type=\"type1\" />" << std::endl
+		 << "  <DataNode name=\"name2\" type=\"type2\" />" << std::endl
+		 << "  <DataNode name=\"name3\" type=\"type3\" />" << std::endl
+		 << "</DPLConfig>" << std::endl;
+	file.close();
+
+	MockNodeFactory factory;
+	factory.SetDataToReturn( "name1", "data1" );
+	factory.SetDataToReturn( "name3", "data3" );
+	factory.SetLoadException( "name2", true );
+
+	std::map< std::string, std::string > parameters;
+	parameters[ "key" ] = "value";
+	std::stringstream result1;
+	std::stringstream result2;
+	std::stringstream result3;
+	std::vector< DataProxyClient::LoadRequest > requests;
+	requests.push_back( DataProxyClient::LoadRequest( "name1", parameters, result1 ) );
+	requests.push_back( DataProxyClient::LoadRequest( "name2", parameters, result2 ) );
+	requests.push_back( DataProxyClient::LoadRequest( "name3", parameters, result3 ) );
+
+	TestableDataProxyClient client;
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( client.LoadMany( requests, 2 ), DataProxyClientException,
+		".*:\\d+: Attempted to issue LoadMany request on uninitialized DataProxyClient" );
+
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( fileSpec, factory ) );
+	std::string initializeLog( factory.GetLog() );
+
+	// nothing is loaded unless every name is known
+	std::vector< DataProxyClient::LoadRequest > badRequests( requests );
+	badRequests.push_back( DataProxyClient::LoadRequest( "unknown1", parameters, result1 ) );
+	badRequests.push_back( DataProxyClient::LoadRequest( "unknown2", parameters, result1 ) );
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( client.LoadMany( badRequests, 2 ), DataProxyClientException,
+		".*:\\d+: Attempted to issue LoadMany request on unknown data node\\(s\\): unknown1,unknown2. Check XML configuration." );
+	CPPUNIT_ASSERT_EQUAL( initializeLog, factory.GetLog() );
+
+	// a single thread loads them in order, carrying on past a failure
+	CPPUNIT_ASSERT( !client.LoadMany( requests, 1 ) );
+
+	std::stringstream expected;
+	expected << initializeLog
+			 << "Load called on: name1 with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl
+			 << "Load called on: name2 with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl
+			 << "Load called on: name3 with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), factory.GetLog() );
+
+	CPPUNIT_ASSERT( requests[0].m_Succeeded );
+	CPPUNIT_ASSERT_EQUAL( std::string(), requests[0].m_Error );
+	CPPUNIT_ASSERT_EQUAL( std::string( "data1" ), result1.str() );
+	CPPUNIT_ASSERT( !requests[1].m_Succeeded );
+	CPPUNIT_ASSERT( requests[1].m_Error.find( "Set to throw exception" ) != std::string::npos );
+	CPPUNIT_ASSERT( requests[2].m_Succeeded );
+	CPPUNIT_ASSERT_EQUAL( std::string( "data3" ), result3.str() );
+}
+
+void DataProxyClientTest::testLoadManyConcurrentReinitialization()
+{
+	std::string fileSpec( m_pTempDir->GetDirectoryName() + "/dataProxyConfig.xml" );
+	std::ofstream file( fileSpec.c_str() );
+
+	file << "<DPLConfig>" << std::endl
+		 << "  <DataNode name=\"name1\" type=\"type1\" />" << std::endl
+		 << "  <DataNode name=\"name2\" type=\"type2\" />" << std::endl
+		 << "  <DataNode name=\"name3\" type=\"type3\" />" << std::endl
+		 << "</DPLConfig>" << std::endl;
+	file.close();
+
+	// the new configuration drops name3 and returns different data for the rest
+	std::string newFileSpec( m_pTempDir->GetDirectoryName() + "/newDataProxyConfig.xml" );
+	file.open( newFileSpec.c_str() );
+	file << "<DPLConfig>" << std::endl
+		 << "  <DataNode name=\"name1\" type=\"type1\" />" << std::endl
+		 << "  <DataNode name=\"name2\" type=\"type2\" />" << std::endl
+		 << "</DPLConfig>" << std::endl;
+	file.close();
+
+	MockNodeFactory newFactory;
+	newFactory.SetDataToReturn( "name1", "newData1" );
+	newFactory.SetDataToReturn( "name2", "newData2" );
+
+	TestableDataProxyClient client;
+	ConfigPublisher publisher( client, newFileSpec, newFactory );
+
+	// name1 publishes the new configuration, and name2 (running alongside it) waits for that before completing. name3
+	// can only be picked up once one of them is done, so it is issued after the new configuration has been published
+	MockNodeFactory factory;
+	factory.SetDataToReturn( "name1", "data1" );
+	factory.SetDataToReturn( "name2", "data2" );
+	factory.SetDataToReturn( "name3", "data3" );
+	factory.SetLoadCallback( "name1", boost::bind( &ConfigPublisher::Publish, &publisher ) );
+	factory.SetLoadCallback( "name2", boost::bind( &ConfigPublisher::WaitForPublish, &publisher ) );
+
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( fileSpec, factory ) );
+	std::string initializeLog( factory.GetLog() );
+
+	std::map< std::string, std::string > parameters;
+	parameters[ "key" ] = "value";
+	std::stringstream result1;
+	std::stringstream result2;
+	std::stringstream result3;
+	std::vector< DataProxyClient::LoadRequest > requests;
+	requests.push_back( DataProxyClient::LoadRequest( "name1", parameters, result1 ) );
+	requests.push_back( DataProxyClient::LoadRequest( "name2", parameters, result2 ) );
+	requests.push_back( DataProxyClient::LoadRequest( "name3", parameters, result3 ) );
+
+	// every load in the batch uses the configuration it started with
+	CPPUNIT_ASSERT( client.LoadMany( requests, 2 ) );
+	for( size_t i = 0; i < requests.size(); ++i )
+	{
+		CPPUNIT_ASSERT_EQUAL( std::string(), requests[i].m_Error );
+		CPPUNIT_ASSERT( requests[i].m_Succeeded );
+	}
+	CPPUNIT_ASSERT_EQUAL( std::string( "data1" ), result1.str() );
+	CPPUNIT_ASSERT_EQUAL( std::string( "data2" ), result2.str() );
+	CPPUNIT_ASSERT_EQUAL( std::string( "data3" ), result3.str() );
+
+	// the loads may have been logged in any order
+	std::string loadLog( factory.GetLog().substr( initializeLog.size() ) );
+	std::string loadLines( boost::trim_right_copy( loadLog ) );
+	std::vector< std::string > loads;
+	boost::split( loads, loadLines, boost::is_any_of( "\n" ) );
+	std::sort( loads.begin(), loads.end() );
+	std::stringstream expected;
+	expected << "Load called on: name1 with parameters: " << ProxyUtilities::ToString( parameters ) << ","
+			 << "Load called on: name2 with parameters: " << ProxyUtilities::ToString( parameters ) << ","
+			 << "Load called on: name3 with parameters: " << ProxyUtilities::ToString( parameters );
+	CPPUNIT_ASSERT_EQUAL( expected.str(), boost::join( loads, "," ) );
+
+	// requests issued after the batch use the new configuration
+	std::string newInitializeLog( newFactory.GetLog() );
+	std::stringstream newResult1;
+	CPPUNIT_ASSERT_NO_THROW( client.Load( "name1", parameters, newResult1 ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "newData1" ), newResult1.str() );
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( client.Load( "name3", parameters, result3 ), DataProxyClientException,
+		".*:\\d+: Attempted to issue Load request on unknown data node 'name3'. Check XML configuration." );
+	CPPUNIT_ASSERT_EQUAL( newInitializeLog + "Load called on: name1 with parameters: " + ProxyUtilities::ToString( parameters ) + "\n", newFactory.GetLog() );
+	CPPUNIT_ASSERT_EQUAL( loadLog, factory.GetLog().substr( initializeLog.size() ) );
+}
+
+void DataProxyClientTest::testAsync()
+{
+	std::string fileSpec( m_pTempDir->GetDirectoryName() + "/dataProxyConfig.xml" );
+	std::ofstream file( fileSpec.c_str() );
+
+	file << "<DPLConfig>" << std::endl
+		 << "  <DataNode name=\"name1\" type=\"type1\" />" << std::endl
+		 << "  <DataNode name=\"name2\" type=\"type2\" />" << std::endl
+		 << "  <DataNode name=\"name3\" type=\"type3\" />" << std::endl
+		 << "</DPLConfig>" << std::endl;
+	file.close();
+
+	MockNodeFactory factory;
+	factory.SetDataToReturn( "name1", "data1" );
+	factory.SetLoadException( "name2", true );
+
+	TestableDataProxyClient client;
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( client.SetAsyncWorkerThreads( 0 ), DataProxyClientException,
+		".*:\\d+: The number of asynchronous worker threads must be greater than 0" );
+	// a single worker runs the requests in the order they were issued
+	CPPUNIT_ASSERT_NO_THROW( client.SetAsyncWorkerThreads( 1 ) );
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( fileSpec, factory ) );
+	std::string initializeLog( factory.GetLog() );
+
+	std::map< std::string, std::string > parameters;
+	parameters[ "key" ] = "value";
+	std::stringstream result1;
+	std::stringstream result2;
+	std::stringstream data3( "data3" );
+
+	boost::unique_future< void > load1 = client.LoadAsync( "name1", parameters, result1 );
+	boost::unique_future< void > load2 = client.LoadAsync( "name2", parameters, result2 );
+	boost::unique_future< void > store3 = client.StoreAsync( "name3", parameters, data3 );
+	boost::unique_future< void > delete3 = client.DeleteAsync( "name3", parameters );
+	boost::unique_future< void > unknown = client.LoadAsync( "unknown", parameters, result2 );
+
+	CPPUNIT_ASSERT_NO_THROW( load1.get() );
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( load2.get(), MVException, ".*:\\d+: Set to throw exception" );
+	CPPUNIT_ASSERT_NO_THROW( store3.get() );
+	CPPUNIT_ASSERT_NO_THROW( delete3.get() );
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( unknown.get(), DataProxyClientException,
+		".*:\\d+: Attempted to issue Load request on unknown data node 'unknown'. Check XML configuration." );
+
+	CPPUNIT_ASSERT_EQUAL( std::string( "data1" ), result1.str() );
+
+	std::stringstream expected;
+	expected << initializeLog
+			 << "Load called on: name1 with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl
+			 << "Load called on: name2 with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl
+			 << "Store called on: name3 with parameters: " << ProxyUtilities::ToString( parameters ) << " with data: data3" << std::endl
+			 << "Delete called on: name3 with parameters: " << ProxyUtilities::ToString( parameters ) << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), factory.GetLog() );
+}
+
+void DataProxyClientTest::testAsyncTransaction()
+{
+	std::string fileSpec( m_pTempDir->GetDirectoryName() + "/dataProxyConfig.xml" );
+	std::ofstream file( fileSpec.c_str() );
+
+	file << "<DPLConfig>" << std::endl
+		 << "  <DataNode name=\"name1\" type=\"type1\" />" << std::endl
+		 << "  <DataNode name=\"name2\" type=\"type2\" />" << std::endl
+		 << "</DPLConfig>" << std::endl;
+	file.close();
+
+	MockNodeFactory factory;
+	factory.SetSupportsTransactions( "name1", true );
+	factory.SetSupportsTransactions( "name2", true );
+
+	TestableDataProxyClient client;
+	CPPUNIT_ASSERT_NO_THROW( client.SetAsyncWorkerThreads( 1 ) );
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( fileSpec, factory ) );
+	std::string initializeLog( factory.GetLog() );
+
+	std::map< std::string, std::string > parameters;
+	std::stringstream data1( "data1" );
+	std::stringstream data2( "data2" );
+
+	// commit waits for the requests issued during the transaction, which are then committed with it
+	CPPUNIT_ASSERT_NO_THROW( client.BeginTransaction() );
+	boost::unique_future< void > store1 = client.StoreAsync( "name1", parameters, data1 );
+	boost::unique_future< void > store2 = client.StoreAsync( "name2", parameters, data2 );
+	CPPUNIT_ASSERT_NO_THROW( client.Commit() );
+
+	std::stringstream expected;
+	expected << initializeLog
+			 << "Store called on: name1 with parameters: " << ProxyUtilities::ToString( parameters ) << " with data: data1" << std::endl
+			 << "Store called on: name2 with parameters: " << ProxyUtilities::ToString( parameters ) << " with data: data2" << std::endl
+			 << "Commit called on: name1" << std::endl
+			 << "Commit called on: name2" << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), factory.GetLog() );
+	CPPUNIT_ASSERT_NO_THROW( store1.get() );
+	CPPUNIT_ASSERT_NO_THROW( store2.get() );
+}
+
+void DataProxyClientTest::testReinitializeInsideTransaction()
+{
+	std::string fileSpec( m_pTempDir->GetDirectoryName() + "/dataProxyConfig.xml" );
+	std::ofstream file( fileSpec.c_str() );
+
+	file << "<DPLConfig>" << std::endl
+		 << "  <DataNode name=\"name1\" type=\"type1\" />" << std::endl
+		 << "</DPLConfig>" << std::endl;
+	file.close();
+
+	std::string newFileSpec( m_pTempDir->GetDirectoryName() + "/newDataProxyConfig.xml" );
+	file.open( newFileSpec.c_str() );
+	file << "<DPLConfig>" << std::endl
+		 << "  <DataNode name=\"name2\" type=\"type2\" />" << std::endl
+		 << "</DPLConfig>" << std::endl;
+	file.close();
+
+	Signal storeStarted;
+	Signal releaseStore;
+	MockNodeFactory factory;
+	factory.SetSupportsTransactions( "name1", true );
+	factory.SetStoreCallback( "name1", boost::bind( &SignalAndWait, boost::ref( storeStarted ), boost::ref( releaseStore ) ) );
+	MockNodeFactory newFactory;
+
+	TestableDataProxyClient client;
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( fileSpec, factory ) );
+	std::string initializeLog( factory.GetLog() );
+	ConfigPublisher publisher( client, newFileSpec, newFactory );
+
+	std::map< std::string, std::string > parameters;
+	std::stringstream data1( "data1" );
+
+	// a store is still running inside the transaction when the new configuration is published
+	CPPUNIT_ASSERT_NO_THROW( client.BeginTransaction() );
+	boost::thread storer( boost::bind( &DataProxyClient::Store, &client, "name1", parameters, boost::ref( data1 ) ) );
+	storeStarted.Wait();
+	boost::thread initializer( boost::bind( &ConfigPublisher::Publish, &publisher ) );
+
+	// the transaction isn't rolled back until the store has finished and been recorded in it
+	::usleep( 100000 );
+	CPPUNIT_ASSERT( client.InsideTransaction() );
+	releaseStore.Set();
+	storer.join();
+	initializer.join();
+	CPPUNIT_ASSERT( !client.InsideTransaction() );
+
+	std::stringstream expected;
+	expected << initializeLog
+			 << "Store called on: name1 with parameters: " << ProxyUtilities::ToString( parameters ) << " with data: data1" << std::endl
+			 << "Rollback called on: name1" << std::endl;
+	CPPUNIT_ASSERT_EQUAL( expected.str(), factory.GetLog() );
+}
+
 void DataProxyClientTest::testForwardingOk()
 {
 	std::string fileSpec( m_pTempDir->GetDirectoryName() + "/dataProxyConfig.xml" );
@@ -1197,6 +1602,58 @@ void DataProxyClientTest::testConfigFileMD5()
 
 }
 
+void DataProxyClientTest::testFailedReinitialization()
+{
+	std::string configFileSpec( m_pTempDir->GetDirectoryName() + "/dataProxyConfig.xml" );
+	std::ofstream file( configFileSpec.c_str() );
+	file << "<DPLConfig>" << std::endl
+		 << "  <DataNode name=\"n\" type=\"type1\" />" << std::endl
+		 << "</DPLConfig>" << std::endl;
+	file.close();
+
+	std::string data( "this is some data that will be returned" );
+	std::map< std::string, std::string > parameters;
+	std::stringstream result;
+
+	MockNodeFactory factory;
+	factory.SetDataToReturn( "n", data );
+	TestableDataProxyClient client;
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( configFileSpec, factory ) );
+	CPPUNIT_ASSERT_NO_THROW( client.Load( "n", parameters, result ) );
+	CPPUNIT_ASSERT_EQUAL( data, result.str() );
+
+	// an ambiguous config fails to initialize...
+	file.open( configFileSpec.c_str() );
+	file << "<DPLConfig>" << std::endl
+		 << "  <DataNode name=\"n\" type=\"type1\" />" << std::endl
+		 << "  <DataNode name=\"n\" type=\"type2\" />" << std::endl
+		 << "</DPLConfig>" << std::endl;
+	file.close();
+	factory.SetDataToReturn( "n", "new data" );
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( client.Initialize( configFileSpec, factory ), DataProxyClientException,
+		".*:\\d+: Node name: 'n' is configured ambiguously" );
+
+	// ...but the previous configuration remains in service
+	result.str("");
+	CPPUNIT_ASSERT_NO_THROW( client.Load( "n", parameters, result ) );
+	CPPUNIT_ASSERT_EQUAL( data, result.str() );
+
+	// once fixed, the new configuration takes over
+	file.open( configFileSpec.c_str() );
+	file << "<DPLConfig>" << std::endl
+		 << "  <DataNode name=\"n\" type=\"type1\" />" << std::endl
+		 << "  <DataNode name=\"name1\" type=\"type2\" />" << std::endl
+		 << "</DPLConfig>" << std::endl;
+	file.close();
+	CPPUNIT_ASSERT_NO_THROW( client.Initialize( configFileSpec, factory ) );
+	result.str("");
+	CPPUNIT_ASSERT_NO_THROW( client.Load( "n", parameters, result ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "new data" ), result.str() );
+	result.str("");
+	CPPUNIT_ASSERT_NO_THROW( client.Load( "name1", parameters, result ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "" ), result.str() );
+}
+
 void DataProxyClientTest::testConfigFileMissing()
 {
 	std::string fileSpec( "randomfilenotexist" );
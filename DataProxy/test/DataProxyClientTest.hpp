@@ -35,6 +35,11 @@ private:
 	CPPUNIT_TEST( testRollbackImpliedByBeginTransaction );
 	CPPUNIT_TEST( testRollbackException );
 	CPPUNIT_TEST( testAutoRollback );
+	CPPUNIT_TEST( testLoadMany );
+	CPPUNIT_TEST( testLoadManyConcurrentReinitialization );
+	CPPUNIT_TEST( testAsync );
+	CPPUNIT_TEST( testAsyncTransaction );
+	CPPUNIT_TEST( testReinitializeInsideTransaction );
 	CPPUNIT_TEST( testForwardingOk );
 	CPPUNIT_TEST( testReadCycles );
 	CPPUNIT_TEST( testWriteCycles );
@@ -44,6 +49,7 @@ private:
 	CPPUNIT_TEST( testUndefinedDeleteForwards );
 	CPPUNIT_TEST( testEntityResolution );
 	CPPUNIT_TEST( testConfigFileMD5 );
+	CPPUNIT_TEST( testFailedReinitialization );
 	CPPUNIT_TEST( testConfigFileMissing );
 	CPPUNIT_TEST( testBadXml );
 	CPPUNIT_TEST_SUITE_END();
@@ -69,6 +75,11 @@ public:
 	void testRollbackImpliedByBeginTransaction();
 	void testRollbackException();
 	void testAutoRollback();
+	void testLoadMany();
+	void testLoadManyConcurrentReinitialization();
+	void testAsync();
+	void testAsyncTransaction();
+	void testReinitializeInsideTransaction();
 	void testForwardingOk();
 	void testReadCycles();
 	void testWriteCycles();
@@ -78,6 +89,7 @@ public:
 	void testUndefinedDeleteForwards();
 	void testEntityResolution();
 	void testConfigFileMD5();
+	void testFailedReinitialization();
 	void testConfigFileMissing();
 	void testBadXml();
 
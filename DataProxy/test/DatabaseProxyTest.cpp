@@ -24,6 +24,7 @@
 #include "MockDatabaseConnectionManager.hpp"
 #include <fstream>
 #include <boost/regex.hpp>
+#include <sys/stat.h>
 
 CPPUNIT_TEST_SUITE_REGISTRATION( DatabaseProxyTest );
 CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( DatabaseProxyTest, "DatabaseProxyTest" );
@@ -1537,6 +1538,83 @@ void DatabaseProxyTest::testLoadCustomSeparators()
 
 }
 
+void DatabaseProxyTest::testLoadQuoteAndNullValue()
+{
+	MockDataProxyClient client;
+	//Create a Database table and populate it
+	Database::Statement(*m_pOracleDB, "Create Table OracleTable(ot_id INT, ot_desc VARCHAR(64))").Execute();
+	std::string cmd( "INSERT INTO OracleTable (ot_id, ot_desc) VALUES ");
+	std::vector<std::string> values;
+
+	values.push_back( "(1, 'Alpha, Bravo')");
+	values.push_back( "(2, 'say \"hi\"')");
+	values.push_back( "(3, NULL)");
+	values.push_back( "(4, 'NULL')");
+	values.push_back( "(5, 'Echo')");
+
+	for( size_t i = 0; i < values.size(); ++i )
+	{
+		Database::Statement stmt( *m_pOracleDB, cmd+values[i] );
+		stmt.Execute();
+	}
+	//Create a Database XML node
+	std::stringstream xmlContents;
+	xmlContents << "<DataNode type = \"db\" >"
+				<< " <Read connection = \"myOracleConnection\" "
+				<< "  header = \"id,desc\" "
+				<< "  quote = '\"' "
+				<< "  nullValue = \"NULL\" "
+				<< "  query = \"Select ot_id, ot_desc from OracleTable order by ot_id\" />"
+				<< "</DataNode>";
+
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	MockDatabaseConnectionManager dbManager;
+
+	DatabaseProxy proxy( "name", boost::shared_ptr< RequestForwarder >( new MockRequestForwarder( client ) ), *nodes[0], dbManager );
+
+	std::map< std::string, std::string > parameters;
+	std::stringstream results;
+
+	dbManager.InsertConnection("myOracleConnection", m_pOracleDB);
+
+	CPPUNIT_ASSERT_NO_THROW( proxy.Load( parameters, results ) );
+
+	std::stringstream expected;
+	expected << "id,desc" << std::endl;
+	expected << "1,\"Alpha, Bravo\"" << std::endl;
+	expected << "2,\"say \"\"hi\"\"\"" << std::endl;
+	expected << "3,NULL" << std::endl;
+	expected << "4,\"NULL\"" << std::endl;
+	expected << "5,Echo" << std::endl;
+
+	CPPUNIT_ASSERT_EQUAL( expected.str(), results.str() );
+}
+
+void DatabaseProxyTest::testLoadQuoteIllegal()
+{
+	MockDataProxyClient client;
+	MockDatabaseConnectionManager dbManager;
+
+	std::stringstream xmlContents;
+	xmlContents << "<DataNode type = \"db\" >"
+				<< " <Read connection = \"myOracleConnection\" "
+				<< "  header = \"id,desc\" "
+				<< "  quote = \"''\" "
+				<< "  query = \"Select ot_id, ot_desc from OracleTable\" />"
+				<< "</DataNode>";
+
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( DatabaseProxy proxy( "name", boost::shared_ptr< RequestForwarder >( new MockRequestForwarder( client ) ), *nodes[0], dbManager ),
+									   DatabaseProxyException,
+									   MATCH_FILE_AND_LINE_NUMBER + "Read attribute: quote must be a single character" );
+}
+
 void DatabaseProxyTest::testStoreException()
 {
 	MockDataProxyClient client;
@@ -2460,6 +2538,518 @@ void DatabaseProxyTest::testMySqlStoreNoStaging()
 }
 
 
+void DatabaseProxyTest::testOracleStoreNoStagingBatched()
+{
+	MockDataProxyClient client;
+	// create primary table
+	Database::Statement(*m_pOracleDB, GetOracleTableDDL("kna")).Execute();
+
+	MockDatabaseConnectionManager dbManager;
+	dbManager.InsertConnection( "myOracleConnection", m_pOracleDB );
+
+	std::stringstream xmlContents;
+	xmlContents << "<DataNode type = \"db\" >"
+				<< " <Write connection = \"myOracleConnection\""
+				<< "  table = \"kna\""
+				<< "  batchSize = \"4\" >"
+				<< "	<Columns>"
+				<< "      <Column name=\"media_id\" sourceName=\"MEDIA_ID\" type=\"key\" />"
+				<< "      <Column name=\"website_id\" type=\"key\" />"
+				<< "      <Column name=\"impressions\" type=\"data\" ifNew=\"%v\" />"
+				<< "      <Column name=\"revenue\" type=\"data\" ifNew=\"%v\" />"
+				<< "      <Column name=\"dummy\" type=\"data\" ifNew=\"17\" />"
+				<< "      <Column name=\"myConstant\" sourceName=\"MY_CONSTANT\" type=\"data\" ifNew=\"%v\" />"
+				<< "	</Columns>"
+				<< " </Write>"
+				<< "</DataNode>";
+
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	DatabaseProxy proxy( "name", boost::shared_ptr< RequestForwarder >( new MockRequestForwarder( client ) ), *nodes[0], dbManager );
+
+	// one full batch & one partial one
+	std::stringstream data;
+	data << "MEDIA_ID,ignore,website_id,ignore,impressions,revenue,ignore" << std::endl
+		 << "12,-1,13,-1,14,15.5,-1" << std::endl
+		 << "22,-2,23,-2,24,25.5,-2" << std::endl
+		 << "32,-3,33,-3,34,35.5,-3" << std::endl
+		 << "42,-4,43,-4,44,45.5,-4" << std::endl
+		 << "52,-5,53,-5,54,55.5,-5" << std::endl
+		 << "62,-6,63,-6,64,65.5,-6" << std::endl;
+
+	std::map< std::string, std::string > parameters;
+	parameters[ "MY_CONSTANT" ] = "24";
+
+	CPPUNIT_ASSERT_NO_THROW( proxy.Store( parameters, data ) );
+	CPPUNIT_ASSERT_TABLE_ORDERED_CONTENTS( std::string(""), *m_pOracleObservationDB, "kna", "media_id,website_id,impressions,revenue,dummy,myConstant", "media_id" )
+	CPPUNIT_ASSERT_NO_THROW( proxy.Commit() );
+
+	std::stringstream expected;
+	expected << "12,13,14,15.5,17,24" << std::endl
+			 << "22,23,24,25.5,17,24" << std::endl
+			 << "32,33,34,35.5,17,24" << std::endl
+			 << "42,43,44,45.5,17,24" << std::endl
+			 << "52,53,54,55.5,17,24" << std::endl
+			 << "62,63,64,65.5,17,24" << std::endl;
+	CPPUNIT_ASSERT_TABLE_ORDERED_CONTENTS( expected.str(), *m_pOracleObservationDB, "kna", "media_id,website_id,impressions,revenue,dummy,myConstant", "media_id" )
+
+	// a failing batch identifies the rows in it
+	data.clear();
+	data.str("");
+	data << "MEDIA_ID,website_id,impressions,revenue" << std::endl
+		 << "72,73,74,75.5" << std::endl
+		 << "82,83,84,85.5" << std::endl
+		 << "92,93,94,95.5" << std::endl
+		 << "102,103,104,105.5" << std::endl
+		 << "112,113,notANumber,115.5" << std::endl;
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( proxy.Store( parameters, data ), DatabaseProxyException,
+									   MATCH_FILE_AND_LINE_NUMBER + "Error storing rows 5 through 5 of the incoming data: .*" );
+	CPPUNIT_ASSERT_NO_THROW( proxy.Rollback() );
+	CPPUNIT_ASSERT_TABLE_ORDERED_CONTENTS( expected.str(), *m_pOracleObservationDB, "kna", "media_id,website_id,impressions,revenue,dummy,myConstant", "media_id" )
+}
+
+void DatabaseProxyTest::testMySqlStoreNoStagingBatched()
+{
+	MockDataProxyClient client;
+	// create primary table
+	Database::Statement(*m_pMySQLDB, GetMySqlTableDDL("kna")).Execute();
+
+	MockDatabaseConnectionManager dbManager;
+	dbManager.InsertConnection( "myMySqlConnection", m_pMySQLDB );
+
+	std::stringstream xmlContents;
+	xmlContents << "<DataNode type = \"db\" >"
+				<< " <Write connection = \"myMySqlConnection\""
+				<< "  table = \"kna\""
+				<< "  batchSize = \"4\" >"
+				<< "	<Columns>"
+				<< "      <Column name=\"media_id\" type=\"key\" />"
+				<< "      <Column name=\"website_id\" type=\"key\" sourceName=\"WEBSITE_ID\" />"
+				<< "      <Column name=\"impressions\" type=\"data\" ifNew=\"%v\" ifMatched=\"%t + %v\" />"
+				<< "      <Column name=\"revenue\" type=\"data\" ifNew=\"%v\" />"
+				<< "      <Column name=\"dummy\" type=\"data\" ifNew=\"17\" sourceName=\"WHATEVER\" />"
+				<< "      <Column name=\"myConstant\" type=\"data\" ifNew=\"%v\" sourceName=\"MY_CONSTANT\" />"
+				<< "	</Columns>"
+				<< " </Write>"
+				<< "</DataNode>";
+
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	DatabaseProxy proxy( "name", boost::shared_ptr< RequestForwarder >( new MockRequestForwarder( client ) ), *nodes[0], dbManager );
+
+	// rows repeating a key within & across batches are merged in order
+	std::stringstream data;
+	data << "media_id,ignore,WEBSITE_ID,ignore,impressions,revenue,ignore" << std::endl
+		 << "12,-1,13,-1,14,15.5,-1" << std::endl
+		 << "22,-2,23,-2,24,25.5,-2" << std::endl
+		 << "12,-3,13,-3,100,35.5,-3" << std::endl
+		 << "42,-4,43,-4,44,45.5,-4" << std::endl
+		 << "52,-5,53,-5,54,55.5,-5" << std::endl
+		 << "12,-6,13,-6,1000,65.5,-6" << std::endl;
+
+	std::map< std::string, std::string > parameters;
+	parameters[ "MY_CONSTANT" ] = "24";
+
+	CPPUNIT_ASSERT_NO_THROW( proxy.Store( parameters, data ) );
+	CPPUNIT_ASSERT_TABLE_ORDERED_CONTENTS( std::string(""), *m_pMySQLObservationDB, "kna", "media_id,website_id,impressions,revenue,dummy,myConstant", "media_id" )
+	CPPUNIT_ASSERT_NO_THROW( proxy.Commit() );
+
+	std::stringstream expected;
+	expected << "12,13,1114,15.5,17,24" << std::endl
+			 << "22,23,24,25.5,17,24" << std::endl
+			 << "42,43,44,45.5,17,24" << std::endl
+			 << "52,53,54,55.5,17,24" << std::endl;
+	CPPUNIT_ASSERT_TABLE_ORDERED_CONTENTS( expected.str(), *m_pMySQLObservationDB, "kna", "media_id,website_id,impressions,revenue,dummy,myConstant", "media_id" )
+}
+
+void DatabaseProxyTest::testStoreBatchSizeIllegal()
+{
+	MockDataProxyClient client;
+	MockDatabaseConnectionManager dbManager;
+	dbManager.InsertConnection( "myMySqlConnection", m_pMySQLDB );
+
+	std::stringstream xmlContents;
+	xmlContents << "<DataNode type = \"db\" >"
+				<< " <Write connection = \"myMySqlConnection\""
+				<< "  table = \"kna\""
+				<< "  batchSize = \"0\" >"
+				<< "	<Columns><Column name=\"media_id\" type=\"key\" /></Columns>"
+				<< " </Write>"
+				<< "</DataNode>";
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( DatabaseProxy proxy( "name", boost::shared_ptr< RequestForwarder >( new MockRequestForwarder( client ) ), *nodes[0], dbManager ),
+									   DatabaseProxyException,
+									   MATCH_FILE_AND_LINE_NUMBER + "Write attribute: batchSize must be positive" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode type = \"db\" >"
+				<< " <Write connection = \"myMySqlConnection\""
+				<< "  table = \"kna\""
+				<< "  stagingTable = \"kna_stg\""
+				<< "  workingDir = \"" << m_pTempDir->GetDirectoryName() << "\""
+				<< "  batchSize = \"100\" >"
+				<< "	<Columns><Column name=\"media_id\" type=\"key\" /></Columns>"
+				<< " </Write>"
+				<< "</DataNode>";
+	nodes.clear();
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( DatabaseProxy proxy( "name", boost::shared_ptr< RequestForwarder >( new MockRequestForwarder( client ) ), *nodes[0], dbManager ),
+									   DatabaseProxyException,
+									   MATCH_FILE_AND_LINE_NUMBER + "Write attribute: batchSize cannot be used with the stagingTable attribute" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode type = \"db\" >"
+				<< " <Write connection = \"myMySqlConnection\""
+				<< "  table = \"kna\""
+				<< "  batchSize = \"40000\" >"
+				<< "	<Columns>"
+				<< "      <Column name=\"media_id\" type=\"key\" />"
+				<< "      <Column name=\"impressions\" type=\"data\" ifNew=\"%v\" />"
+				<< "	</Columns>"
+				<< " </Write>"
+				<< "</DataNode>";
+	nodes.clear();
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( DatabaseProxy proxy( "name", boost::shared_ptr< RequestForwarder >( new MockRequestForwarder( client ) ), *nodes[0], dbManager ),
+									   DatabaseProxyException,
+									   MATCH_FILE_AND_LINE_NUMBER + "Write attribute: batchSize is too large; batches of 40000 rows of 2 columns exceed the limit of 65535 bind variables" );
+}
+
+void DatabaseProxyTest::testOracleStoreStreamed()
+{
+	MockDataProxyClient client;
+	// create primary & staging tables
+	Database::Statement(*m_pOracleDB, GetOracleTableDDL("kna")).Execute();
+	Database::Statement(*m_pOracleDB, GetOracleTableDDL("stg_kna")).Execute();
+
+	MockDatabaseConnectionManager dbManager;
+	dbManager.InsertConnection( "myOracleConnection", m_pOracleDB );
+
+	std::stringstream xmlContents;
+	xmlContents << "<DataNode type = \"db\" >"
+				<< " <Write connection = \"myOracleConnection\""
+				<< "  table = \"kna\" "
+				<< "  stagingTable = \"stg_kna\" "
+				<< "  workingDir = \"" << m_pTempDir->GetDirectoryName() << "\""
+				<< "  streamDataFile = \"true\" "
+				<< "  noCleanUp = \"true\" "
+				<< "  insertOnly = \"true\" >"
+				<< "	<Columns>"
+				<< "      <Column name=\"media_id\" type=\"key\" />"
+				<< "      <Column name=\"website_id\" type=\"key\" />"
+				<< "      <Column name=\"impressions\" type=\"data\" ifNew=\"%v\" />"
+				<< "      <Column name=\"revenue\" type=\"data\" ifNew=\"%v\" />"
+				<< "      <Column name=\"dummy\" type=\"data\" ifNew=\"17\" />"
+				<< "      <Column name=\"myConstant\" sourceName=\"MY_CONSTANT\" type=\"data\" ifNew=\"%v\" />"
+				<< "	</Columns>"
+				<< " </Write>"
+				<< "</DataNode>";
+
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	DatabaseProxy proxy( "name", boost::shared_ptr< RequestForwarder >( new MockRequestForwarder( client ) ), *nodes[0], dbManager );
+
+	FileUtilities::ClearDirectory( m_pTempDir->GetDirectoryName() );
+
+	std::stringstream data;
+	data << "media_id,website_id,impressions,revenue" << std::endl
+		 << "12,13,14,15.5" << std::endl
+		 << "22,23,24,25.5" << std::endl
+		 << "32,33,34,35.5" << std::endl;
+
+	std::map< std::string, std::string > parameters;
+	parameters[ "MY_CONSTANT" ] = "24";
+
+	CPPUNIT_ASSERT_NO_THROW( proxy.Store( parameters, data ) );
+	CPPUNIT_ASSERT_NO_THROW( proxy.Commit() );
+
+	std::stringstream expected;
+	expected << "12,13,14,15.5,17,24" << std::endl
+			 << "22,23,24,25.5,17,24" << std::endl
+			 << "32,33,34,35.5,17,24" << std::endl;
+	CPPUNIT_ASSERT_TABLE_ORDERED_CONTENTS( expected.str(), *m_pOracleObservationDB, "kna", "media_id,website_id,impressions,revenue,dummy,myConstant", "media_id" )
+
+	// the data file left behind is the named pipe the loader read from
+	std::vector< std::string > files;
+	FileUtilities::ListDirectory( m_pTempDir->GetDirectoryName(), files, false );
+	std::vector< std::string >::const_iterator iter = files.begin();
+	for( ; iter != files.end(); ++iter )
+	{
+		if( boost::regex_match( *iter, boost::regex( ".*\\.dat" ) ) )
+		{
+			struct stat status;
+			CPPUNIT_ASSERT_EQUAL( 0, ::stat( ( m_pTempDir->GetDirectoryName() + "/" + *iter ).c_str(), &status ) );
+			CPPUNIT_ASSERT( S_ISFIFO( status.st_mode ) );
+		}
+	}
+}
+
+void DatabaseProxyTest::testMySqlStoreStreamed()
+{
+	MockDataProxyClient client;
+	// create primary & staging tables
+	Database::Statement(*m_pMySQLDB, GetMySqlTableDDL("kna")).Execute();
+	Database::Statement(*m_pMySQLDB, GetMySqlTableDDL("stg_kna")).Execute();
+
+	MockDatabaseConnectionManager dbManager;
+	dbManager.InsertConnection( "myMySqlConnection", m_pMySQLDB );
+
+	std::stringstream xmlContents;
+	xmlContents << "<DataNode type = \"db\" >"
+				<< " <Write connection = \"myMySqlConnection\""
+				<< "  table = \"kna\" "
+				<< "  stagingTable = \"stg_kna\" "
+				<< "  workingDir = \"" << m_pTempDir->GetDirectoryName() << "\""
+				<< "  streamDataFile = \"true\" "
+				<< "  insertOnly = \"true\" >"
+				<< "	<Columns>"
+				<< "      <Column name=\"media_id\" type=\"key\" />"
+				<< "      <Column name=\"website_id\" type=\"key\" />"
+				<< "      <Column name=\"impressions\" type=\"data\" ifNew=\"%v\" />"
+				<< "      <Column name=\"revenue\" type=\"data\" ifNew=\"%v\" />"
+				<< "      <Column name=\"dummy\" type=\"data\" ifNew=\"17\" />"
+				<< "      <Column name=\"myConstant\" sourceName=\"MY_CONSTANT\" type=\"data\" ifNew=\"%v\" />"
+				<< "	</Columns>"
+				<< " </Write>"
+				<< "</DataNode>";
+
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	DatabaseProxy proxy( "name", boost::shared_ptr< RequestForwarder >( new MockRequestForwarder( client ) ), *nodes[0], dbManager );
+
+	FileUtilities::ClearDirectory( m_pTempDir->GetDirectoryName() );
+
+	std::stringstream data;
+	data << "media_id,website_id,impressions,revenue" << std::endl;
+	std::stringstream expected;
+	for( int i = 1; i <= 10000; ++i )
+	{
+		data << i << "," << i + 1 << "," << i + 2 << "," << i + 3.5 << std::endl;
+		expected << i << "," << i + 1 << "," << i + 2 << "," << i + 3.5 << ",17,24" << std::endl;
+	}
+
+	std::map< std::string, std::string > parameters;
+	parameters[ "MY_CONSTANT" ] = "24";
+
+	CPPUNIT_ASSERT_NO_THROW( proxy.Store( parameters, data ) );
+	CPPUNIT_ASSERT_NO_THROW( proxy.Commit() );
+
+	CPPUNIT_ASSERT_TABLE_ORDERED_CONTENTS( expected.str(), *m_pMySQLObservationDB, "kna", "media_id,website_id,impressions,revenue,dummy,myConstant", "media_id" )
+
+	// the named pipe has been cleaned up
+	std::vector< std::string > files;
+	FileUtilities::ListDirectory( m_pTempDir->GetDirectoryName(), files, false );
+	CPPUNIT_ASSERT_EQUAL( size_t(0), files.size() );
+
+	// with no incoming rows, the (empty) pipe is still loaded & merged
+	data.str( "" );
+	data.clear();
+	data << "media_id,website_id,impressions,revenue" << std::endl;
+	CPPUNIT_ASSERT_NO_THROW( proxy.Store( parameters, data ) );
+	CPPUNIT_ASSERT_NO_THROW( proxy.Commit() );
+	CPPUNIT_ASSERT_TABLE_ORDERED_CONTENTS( expected.str(), *m_pMySQLObservationDB, "kna", "media_id,website_id,impressions,revenue,dummy,myConstant", "media_id" )
+}
+
+void DatabaseProxyTest::testStoreStreamDataFileIllegal()
+{
+	MockDataProxyClient client;
+	MockDatabaseConnectionManager dbManager;
+	dbManager.InsertConnection( "myMySqlConnection", m_pMySQLDB );
+
+	std::stringstream xmlContents;
+	xmlContents << "<DataNode type = \"db\" >"
+				<< " <Write connection = \"myMySqlConnection\""
+				<< "  table = \"kna\""
+				<< "  streamDataFile = \"true\" >"
+				<< "	<Columns><Column name=\"media_id\" type=\"key\" /></Columns>"
+				<< " </Write>"
+				<< "</DataNode>";
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( DatabaseProxy proxy( "name", boost::shared_ptr< RequestForwarder >( new MockRequestForwarder( client ) ), *nodes[0], dbManager ),
+									   DatabaseProxyException,
+									   MATCH_FILE_AND_LINE_NUMBER + "Write attribute: streamDataFile can only be used with the stagingTable attribute" );
+
+	// vertica's loader isn't given a named pipe
+	dbManager.InsertConnection( "myVerticaConnection", m_pMySQLDB, "vertica" );
+	xmlContents.str("");
+	xmlContents << "<DataNode type = \"db\" >"
+				<< " <Write connection = \"myVerticaConnection\""
+				<< "  table = \"kna\""
+				<< "  stagingTable = \"stg_kna\""
+				<< "  workingDir = \"" << m_pTempDir->GetDirectoryName() << "\""
+				<< "  streamDataFile = \"true\" >"
+				<< "	<Columns><Column name=\"media_id\" type=\"key\" /></Columns>"
+				<< " </Write>"
+				<< "</DataNode>";
+	nodes.clear();
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( DatabaseProxy proxy( "name", boost::shared_ptr< RequestForwarder >( new MockRequestForwarder( client ) ), *nodes[0], dbManager ),
+									   DatabaseProxyException,
+									   MATCH_FILE_AND_LINE_NUMBER + "Write attribute: streamDataFile is not supported for vertica connections" );
+}
+
+void DatabaseProxyTest::testOracleStoreParallelUpload()
+{
+	MockDataProxyClient client;
+	// create primary table only
+	Database::Statement(*m_pOracleDB, GetOracleTableDDL("kna")).Execute();
+
+	MockDatabaseConnectionManager dbManager;
+	dbManager.InsertConnection( "myOracleConnection", m_pOracleDB );
+
+	std::stringstream xmlContents;
+	xmlContents << "<DataNode type = \"db\" >"
+				<< " <Write connection = \"myOracleConnection\""
+				<< "  table = \"kna\" "
+				<< "  stagingTable = \"stg_kna\" "
+				<< "  workingDir = \"" << m_pTempDir->GetDirectoryName() << "\""
+				<< "  maxTableNameLength = \"30\" "
+				<< "  dynamicStagingTable = \"true\" "
+				<< "  uploadParallelism = \"3\" "
+				<< "  noCleanUp = \"true\" "
+				<< "  insertOnly = \"true\" >"
+				<< "	<Columns>"
+				<< "      <Column name=\"media_id\" type=\"key\" />"
+				<< "      <Column name=\"website_id\" type=\"key\" />"
+				<< "      <Column name=\"impressions\" type=\"data\" ifNew=\"%v\" />"
+				<< "      <Column name=\"revenue\" type=\"data\" ifNew=\"%v\" />"
+				<< "      <Column name=\"dummy\" type=\"data\" ifNew=\"17\" />"
+				<< "      <Column name=\"myConstant\" type=\"data\" ifNew=\"%v\" sourceName=\"MY_CONSTANT\" />"
+				<< "	</Columns>"
+				<< " </Write>"
+				<< "</DataNode>";
+
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	DatabaseProxy proxy( "name", boost::shared_ptr< RequestForwarder >( new MockRequestForwarder( client ) ), *nodes[0], dbManager );
+
+	FileUtilities::ClearDirectory( m_pTempDir->GetDirectoryName() );
+
+	// seven rows don't split evenly three ways
+	std::stringstream data;
+	data << "media_id,website_id,impressions,revenue" << std::endl;
+	std::stringstream expected;
+	for( int i = 1; i <= 7; ++i )
+	{
+		data << i << "2," << i << "3," << i << "4," << i << "5.5" << std::endl;
+		expected << i << "2," << i << "3," << i << "4," << i << "5.5,17,24" << std::endl;
+	}
+
+	std::map< std::string, std::string > parameters;
+	parameters[ "MY_CONSTANT" ] = "24";
+
+	CPPUNIT_ASSERT_NO_THROW( proxy.Store( parameters, data ) );
+	CPPUNIT_ASSERT_NO_THROW( proxy.Commit() );
+
+	CPPUNIT_ASSERT_TABLE_ORDERED_CONTENTS( expected.str(), *m_pOracleObservationDB, "kna", "media_id,website_id,impressions,revenue,dummy,myConstant", "media_id" )
+
+	// each chunk had a data, control & log file of its own
+	std::vector< std::string > files;
+	FileUtilities::ListDirectory( m_pTempDir->GetDirectoryName(), files, false );
+	std::sort( files.begin(), files.end() );
+	CPPUNIT_ASSERT_EQUAL( size_t(9), files.size() );
+	CPPUNIT_ASSERT_MESSAGE( files[0], boost::regex_match( files[0], boost::regex( ".*\\.ctl" ) ) );
+	CPPUNIT_ASSERT_MESSAGE( files[1], boost::regex_match( files[1], boost::regex( ".*\\.ctl\\.1" ) ) );
+	CPPUNIT_ASSERT_MESSAGE( files[2], boost::regex_match( files[2], boost::regex( ".*\\.ctl\\.2" ) ) );
+	CPPUNIT_ASSERT_MESSAGE( files[3], boost::regex_match( files[3], boost::regex( ".*\\.dat" ) ) );
+	CPPUNIT_ASSERT_MESSAGE( files[4], boost::regex_match( files[4], boost::regex( ".*\\.dat\\.1" ) ) );
+	CPPUNIT_ASSERT_MESSAGE( files[5], boost::regex_match( files[5], boost::regex( ".*\\.dat\\.2" ) ) );
+
+	// rows are dealt out to the chunks in turn
+	CPPUNIT_ASSERT_FILE_CONTENTS( "media_id,website_id,impressions,revenue,myConstant\n12,13,14,15.5,24\n42,43,44,45.5,24\n72,73,74,75.5,24\n",
+								  m_pTempDir->GetDirectoryName() + "/" + files[3] );
+	CPPUNIT_ASSERT_FILE_CONTENTS( "media_id,website_id,impressions,revenue,myConstant\n22,23,24,25.5,24\n52,53,54,55.5,24\n",
+								  m_pTempDir->GetDirectoryName() + "/" + files[4] );
+	CPPUNIT_ASSERT_FILE_CONTENTS( "media_id,website_id,impressions,revenue,myConstant\n32,33,34,35.5,24\n62,63,64,65.5,24\n",
+								  m_pTempDir->GetDirectoryName() + "/" + files[5] );
+}
+
+void DatabaseProxyTest::testStoreUploadParallelismIllegal()
+{
+	MockDataProxyClient client;
+	MockDatabaseConnectionManager dbManager;
+	dbManager.InsertConnection( "myOracleConnection", m_pOracleDB );
+
+	std::stringstream xmlContents;
+	xmlContents << "<DataNode type = \"db\" >"
+				<< " <Write connection = \"myOracleConnection\""
+				<< "  table = \"kna\""
+				<< "  stagingTable = \"stg_kna\""
+				<< "  workingDir = \"" << m_pTempDir->GetDirectoryName() << "\""
+				<< "  dynamicStagingTable = \"true\""
+				<< "  uploadParallelism = \"0\" >"
+				<< "	<Columns><Column name=\"media_id\" type=\"key\" /></Columns>"
+				<< " </Write>"
+				<< "</DataNode>";
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( DatabaseProxy proxy( "name", boost::shared_ptr< RequestForwarder >( new MockRequestForwarder( client ) ), *nodes[0], dbManager ),
+									   DatabaseProxyException,
+									   MATCH_FILE_AND_LINE_NUMBER + "Write attribute: uploadParallelism must be positive" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode type = \"db\" >"
+				<< " <Write connection = \"myOracleConnection\""
+				<< "  table = \"kna\""
+				<< "  stagingTable = \"stg_kna\""
+				<< "  workingDir = \"" << m_pTempDir->GetDirectoryName() << "\""
+				<< "  uploadParallelism = \"4\" >"
+				<< "	<Columns><Column name=\"media_id\" type=\"key\" /></Columns>"
+				<< " </Write>"
+				<< "</DataNode>";
+	nodes.clear();
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( DatabaseProxy proxy( "name", boost::shared_ptr< RequestForwarder >( new MockRequestForwarder( client ) ), *nodes[0], dbManager ),
+									   DatabaseProxyException,
+									   MATCH_FILE_AND_LINE_NUMBER + "Write attribute: uploadParallelism can only be greater than 1 with the stagingTable attribute and dynamicStagingTable set to true" );
+
+	xmlContents.str("");
+	xmlContents << "<DataNode type = \"db\" >"
+				<< " <Write connection = \"myOracleConnection\""
+				<< "  table = \"kna\""
+				<< "  stagingTable = \"stg_kna\""
+				<< "  workingDir = \"" << m_pTempDir->GetDirectoryName() << "\""
+				<< "  dynamicStagingTable = \"true\""
+				<< "  streamDataFile = \"true\""
+				<< "  uploadParallelism = \"4\" >"
+				<< "	<Columns><Column name=\"media_id\" type=\"key\" /></Columns>"
+				<< " </Write>"
+				<< "</DataNode>";
+	nodes.clear();
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "DataNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( DatabaseProxy proxy( "name", boost::shared_ptr< RequestForwarder >( new MockRequestForwarder( client ) ), *nodes[0], dbManager ),
+									   DatabaseProxyException,
+									   MATCH_FILE_AND_LINE_NUMBER + "Write attribute: uploadParallelism can only be greater than 1 without the streamDataFile attribute" );
+}
+
 void DatabaseProxyTest::testStoreColumnParameterCollisionBehaviors()
 {
 	MockDataProxyClient client;
@@ -43,6 +43,8 @@ private:
 	CPPUNIT_TEST( testLoadMaxStringParameter );
 	CPPUNIT_TEST( testLoadSameVarNameReplacedTwice );
 	CPPUNIT_TEST( testLoadCustomSeparators );
+	CPPUNIT_TEST( testLoadQuoteAndNullValue );
+	CPPUNIT_TEST( testLoadQuoteIllegal );
 	CPPUNIT_TEST( testLoadExceptionMissingVariableNameDefinition );
 	CPPUNIT_TEST( testLoadExceptionWithBadConnection );
 	CPPUNIT_TEST( testLoadExceptionEmptyVarName );
@@ -53,6 +55,14 @@ private:
 	CPPUNIT_TEST( testOracleStoreDifferentSchema );
 	CPPUNIT_TEST( testOracleStoreNoStaging );
 	CPPUNIT_TEST( testMySqlStoreNoStaging );
+	CPPUNIT_TEST( testOracleStoreNoStagingBatched );
+	CPPUNIT_TEST( testMySqlStoreNoStagingBatched );
+	CPPUNIT_TEST( testStoreBatchSizeIllegal );
+	CPPUNIT_TEST( testOracleStoreStreamed );
+	CPPUNIT_TEST( testMySqlStoreStreamed );
+	CPPUNIT_TEST( testStoreStreamDataFileIllegal );
+	CPPUNIT_TEST( testOracleStoreParallelUpload );
+	CPPUNIT_TEST( testStoreUploadParallelismIllegal );
 	CPPUNIT_TEST( testMySqlStoreDynamicTables );
 	CPPUNIT_TEST( testOracleStoreDynamicTables );
 	CPPUNIT_TEST( testDynamicTableNameLength );
@@ -112,6 +122,8 @@ public:
 	void testLoadMaxStringParameter();
 	void testLoadSameVarNameReplacedTwice();
 	void testLoadCustomSeparators();
+	void testLoadQuoteAndNullValue();
+	void testLoadQuoteIllegal();
 	void testLoadExceptionMissingVariableNameDefinition();
 	void testLoadExceptionWithBadConnection();
 	void testLoadExceptionEmptyVarName();
@@ -124,6 +136,14 @@ public:
 	void testOracleMultipleStore();
 	void testMySqlStore();
 	void testMySqlStoreNoStaging();
+	void testOracleStoreNoStagingBatched();
+	void testMySqlStoreNoStagingBatched();
+	void testStoreBatchSizeIllegal();
+	void testOracleStoreStreamed();
+	void testMySqlStoreStreamed();
+	void testStoreStreamDataFileIllegal();
+	void testOracleStoreParallelUpload();
+	void testStoreUploadParallelismIllegal();
 	void testMySqlMultipleStore();
 	void testMySqlStoreDynamicTables();
 	void testOracleStoreDynamicTables();
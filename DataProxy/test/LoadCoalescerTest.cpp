@@ -0,0 +1,164 @@
+#include "LoadCoalescerTest.hpp"
+#include "LoadCoalescer.hpp"
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <vector>
+
+CPPUNIT_TEST_SUITE_REGISTRATION( LoadCoalescerTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( LoadCoalescerTest, "LoadCoalescerTest" );
+
+namespace
+{
+	const size_t NUM_FOLLOWERS( 10 );
+
+	// joins under the key, recording whether it led and what result & error it was handed
+	void Join( LoadCoalescer& i_rCoalescer,
+			   const std::string& i_rKey,
+			   bool& o_rLed,
+			   boost::shared_ptr< const std::string >& o_rpResult,
+			   boost::shared_ptr< const std::string >& o_rpError )
+	{
+		o_rLed = ( i_rCoalescer.Join( i_rKey, o_rpResult, o_rpError ) != NULL );
+	}
+
+	// starts followers while a leader holds the key, then once they are all waiting, has the leader land
+	// with the given result (or error, if there is one)
+	void RunFlight( LoadCoalescer& i_rCoalescer,
+					boost::shared_ptr< const std::string > i_pResult,
+					const std::string& i_rError,
+					std::vector< char >& o_rLed,
+					std::vector< boost::shared_ptr< const std::string > >& o_rResults,
+					std::vector< boost::shared_ptr< const std::string > >& o_rErrors )
+	{
+		boost::shared_ptr< const std::string > pResult;
+		boost::shared_ptr< const std::string > pError;
+		boost::shared_ptr< LoadCoalescer::Leader > pLeader = i_rCoalescer.Join( "key", pResult, pError );
+		CPPUNIT_ASSERT( pLeader != NULL );
+
+		// std::vector< bool > can't hand out references to its elements
+		bool led[ NUM_FOLLOWERS ];
+		o_rResults.assign( NUM_FOLLOWERS, boost::shared_ptr< const std::string >() );
+		o_rErrors.assign( NUM_FOLLOWERS, boost::shared_ptr< const std::string >() );
+		boost::thread_group followers;
+		for( size_t i = 0; i < NUM_FOLLOWERS; ++i )
+		{
+			followers.create_thread( boost::bind( &Join, boost::ref( i_rCoalescer ), "key", boost::ref( led[i] ),
+												  boost::ref( o_rResults[i] ), boost::ref( o_rErrors[i] ) ) );
+		}
+
+		while( i_rCoalescer.GetFollowerCount() < NUM_FOLLOWERS )
+		{
+			boost::this_thread::yield();
+		}
+		pLeader->SetResult( i_pResult );
+		if( !i_rError.empty() )
+		{
+			pLeader->SetError( i_rError );
+		}
+		pLeader.reset();
+		followers.join_all();
+		CPPUNIT_ASSERT_EQUAL( size_t(0), i_rCoalescer.GetFollowerCount() );
+
+		o_rLed.assign( led, led + NUM_FOLLOWERS );
+	}
+}
+
+LoadCoalescerTest::LoadCoalescerTest()
+{
+}
+
+LoadCoalescerTest::~LoadCoalescerTest()
+{
+}
+
+void LoadCoalescerTest::setUp()
+{
+}
+
+void LoadCoalescerTest::tearDown()
+{
+}
+
+void LoadCoalescerTest::testLead()
+{
+	LoadCoalescer coalescer( 1024 );
+	CPPUNIT_ASSERT_EQUAL( size_t(1024), coalescer.GetMaxBytes() );
+
+	boost::shared_ptr< const std::string > pResult( new std::string( "stale" ) );
+	boost::shared_ptr< const std::string > pError( new std::string( "stale" ) );
+	boost::shared_ptr< LoadCoalescer::Leader > pLeader = coalescer.Join( "key", pResult, pError );
+	CPPUNIT_ASSERT( pLeader != NULL );
+	CPPUNIT_ASSERT( pResult == NULL );
+	CPPUNIT_ASSERT( pError == NULL );
+	pLeader->SetResult( boost::shared_ptr< const std::string >( new std::string( "data" ) ) );
+	pLeader.reset();
+
+	// once landed, the next load under the key leads a new flight
+	pLeader = coalescer.Join( "key", pResult, pError );
+	CPPUNIT_ASSERT( pLeader != NULL );
+	CPPUNIT_ASSERT( pResult == NULL );
+	CPPUNIT_ASSERT( pError == NULL );
+}
+
+void LoadCoalescerTest::testFollow()
+{
+	LoadCoalescer coalescer( 1024 );
+	boost::shared_ptr< const std::string > pData( new std::string( "data" ) );
+	std::vector< char > led;
+	std::vector< boost::shared_ptr< const std::string > > results;
+	std::vector< boost::shared_ptr< const std::string > > errors;
+	RunFlight( coalescer, pData, "", led, results, errors );
+
+	// every follower is handed the leader's buffer
+	for( size_t i = 0; i < NUM_FOLLOWERS; ++i )
+	{
+		CPPUNIT_ASSERT( !led[i] );
+		CPPUNIT_ASSERT( results[i] == pData );
+		CPPUNIT_ASSERT( errors[i] == NULL );
+	}
+}
+
+void LoadCoalescerTest::testFollowNoResult()
+{
+	LoadCoalescer coalescer( 1024 );
+	std::vector< char > led;
+	std::vector< boost::shared_ptr< const std::string > > results;
+	std::vector< boost::shared_ptr< const std::string > > errors;
+	RunFlight( coalescer, boost::shared_ptr< const std::string >(), "", led, results, errors );
+
+	for( size_t i = 0; i < NUM_FOLLOWERS; ++i )
+	{
+		CPPUNIT_ASSERT( !led[i] );
+		CPPUNIT_ASSERT( results[i] == NULL );
+		CPPUNIT_ASSERT( errors[i] == NULL );
+	}
+}
+
+void LoadCoalescerTest::testFollowError()
+{
+	LoadCoalescer coalescer( 1024 );
+	std::vector< char > led;
+	std::vector< boost::shared_ptr< const std::string > > results;
+	std::vector< boost::shared_ptr< const std::string > > errors;
+	RunFlight( coalescer, boost::shared_ptr< const std::string >(), "the load failed", led, results, errors );
+
+	// every follower is handed the leader's error rather than being left to load for itself
+	for( size_t i = 0; i < NUM_FOLLOWERS; ++i )
+	{
+		CPPUNIT_ASSERT( !led[i] );
+		CPPUNIT_ASSERT( results[i] == NULL );
+		CPPUNIT_ASSERT( errors[i] != NULL );
+		CPPUNIT_ASSERT_EQUAL( std::string( "the load failed" ), *errors[i] );
+	}
+}
+
+void LoadCoalescerTest::testDistinctKeys()
+{
+	LoadCoalescer coalescer( 1024 );
+	boost::shared_ptr< const std::string > pResult;
+	boost::shared_ptr< const std::string > pError;
+	boost::shared_ptr< LoadCoalescer::Leader > pLeader1 = coalescer.Join( "key1", pResult, pError );
+	boost::shared_ptr< LoadCoalescer::Leader > pLeader2 = coalescer.Join( "key2", pResult, pError );
+	CPPUNIT_ASSERT( pLeader1 != NULL );
+	CPPUNIT_ASSERT( pLeader2 != NULL );
+}
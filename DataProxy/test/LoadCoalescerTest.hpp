@@ -0,0 +1,34 @@
+#ifndef _LOAD_COALESCER_TEST_HPP_
+#define _LOAD_COALESCER_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class LoadCoalescerTest : public CppUnit::TestFixture
+{
+private:
+	CPPUNIT_TEST_SUITE( LoadCoalescerTest );
+
+	CPPUNIT_TEST( testLead );
+	CPPUNIT_TEST( testFollow );
+	CPPUNIT_TEST( testFollowNoResult );
+	CPPUNIT_TEST( testFollowError );
+	CPPUNIT_TEST( testDistinctKeys );
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	LoadCoalescerTest();
+	virtual ~LoadCoalescerTest();
+
+	void setUp();
+	void tearDown();
+
+	void testLead();
+	void testFollow();
+	void testFollowNoResult();
+	void testFollowError();
+	void testDistinctKeys();
+};
+
+#endif //_LOAD_COALESCER_TEST_HPP_
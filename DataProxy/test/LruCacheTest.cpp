@@ -0,0 +1,90 @@
+#include "LruCacheTest.hpp"
+#include "LruCache.hpp"
+
+CPPUNIT_TEST_SUITE_REGISTRATION( LruCacheTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( LruCacheTest, "LruCacheTest" );
+
+namespace
+{
+	// the keys from most to least recently used
+	std::string GetOrder( LruCache< int >& i_rCache )
+	{
+		std::string result;
+		LruCache< int >::Iterator iter = i_rCache.Begin();
+		for( ; iter != i_rCache.End(); ++iter )
+		{
+			result += iter->m_Key;
+		}
+		return result;
+	}
+}
+
+LruCacheTest::LruCacheTest()
+{
+}
+
+LruCacheTest::~LruCacheTest()
+{
+}
+
+void LruCacheTest::testInsertFind()
+{
+	LruCache< int > cache;
+	CPPUNIT_ASSERT( cache.Find( "a" ) == cache.End() );
+	CPPUNIT_ASSERT_EQUAL( size_t(0), cache.GetBytes() );
+
+	cache.Insert( "a", 1, 10, 100.0 );
+	cache.Insert( "b", 2, 20, 200.0 );
+	CPPUNIT_ASSERT_EQUAL( size_t(30), cache.GetBytes() );
+	LruCache< int >::Iterator iter = cache.Find( "a" );
+	CPPUNIT_ASSERT( iter != cache.End() );
+	CPPUNIT_ASSERT_EQUAL( 1, iter->m_Value );
+	CPPUNIT_ASSERT_EQUAL( size_t(10), iter->m_Size );
+	CPPUNIT_ASSERT_EQUAL( 100.0, iter->m_Expiration );
+
+	// replacing an entry replaces its size too
+	cache.Insert( "a", 3, 5, 300.0 );
+	CPPUNIT_ASSERT_EQUAL( size_t(25), cache.GetBytes() );
+	CPPUNIT_ASSERT_EQUAL( 3, cache.Find( "a" )->m_Value );
+	CPPUNIT_ASSERT_EQUAL( std::string( "ab" ), GetOrder( cache ) );
+
+	cache.Remove( cache.Find( "b" ) );
+	CPPUNIT_ASSERT( cache.Find( "b" ) == cache.End() );
+	CPPUNIT_ASSERT_EQUAL( size_t(5), cache.GetBytes() );
+	CPPUNIT_ASSERT_EQUAL( std::string( "a" ), GetOrder( cache ) );
+}
+
+void LruCacheTest::testRecency()
+{
+	LruCache< int > cache;
+	cache.Insert( "a", 1, 1, 0.0 );
+	cache.Insert( "b", 2, 1, 0.0 );
+	cache.Insert( "c", 3, 1, 0.0 );
+	CPPUNIT_ASSERT_EQUAL( std::string( "cba" ), GetOrder( cache ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "a" ), cache.GetOldest()->m_Key );
+
+	cache.Touch( cache.Find( "a" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "acb" ), GetOrder( cache ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "b" ), cache.GetOldest()->m_Key );
+
+	cache.Remove( cache.GetOldest() );
+	cache.Remove( cache.GetOldest() );
+	CPPUNIT_ASSERT_EQUAL( std::string( "a" ), GetOrder( cache ) );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), cache.GetBytes() );
+}
+
+void LruCacheTest::testAppendKeyField()
+{
+	std::string key1;
+	LruCache< int >::AppendKeyField( key1, "a:" );
+	LruCache< int >::AppendKeyField( key1, "b" );
+	std::string key2;
+	LruCache< int >::AppendKeyField( key2, "a" );
+	LruCache< int >::AppendKeyField( key2, ":b" );
+	CPPUNIT_ASSERT_EQUAL( std::string( "2:a:1:b" ), key1 );
+	CPPUNIT_ASSERT( key1 != key2 );
+
+	std::string empty;
+	LruCache< int >::AppendKeyField( empty, "" );
+	CPPUNIT_ASSERT_EQUAL( std::string( "0:" ), empty );
+}
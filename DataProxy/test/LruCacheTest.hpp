@@ -0,0 +1,27 @@
+#ifndef _LRU_CACHE_TEST_HPP_
+#define _LRU_CACHE_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class LruCacheTest : public CppUnit::TestFixture
+{
+private:
+	CPPUNIT_TEST_SUITE( LruCacheTest );
+
+	CPPUNIT_TEST( testInsertFind );
+	CPPUNIT_TEST( testRecency );
+	CPPUNIT_TEST( testAppendKeyField );
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	LruCacheTest();
+	virtual ~LruCacheTest();
+
+	void testInsertFind();
+	void testRecency();
+	void testAppendKeyField();
+};
+
+#endif //_LRU_CACHE_TEST_HPP_
@@ -0,0 +1,133 @@
+#include "NamedPipeWriterTest.hpp"
+#include "NamedPipeWriter.hpp"
+#include "TempDirectory.hpp"
+#include "AssertThrowWithMessage.hpp"
+#include <boost/bind.hpp>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION( NamedPipeWriterTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( NamedPipeWriterTest, "NamedPipeWriterTest" );
+
+namespace
+{
+	std::string MakeData( size_t i_Lines )
+	{
+		std::stringstream data;
+		for( size_t i = 0; i < i_Lines; ++i )
+		{
+			data << "line " << i << ",some,column,data" << std::endl;
+		}
+		return data.str();
+	}
+
+	void WriteData( std::ostream& o_rOutput, const std::string& i_rData )
+	{
+		o_rOutput << i_rData;
+	}
+
+	void WriteAndFail( std::ostream& o_rOutput )
+	{
+		o_rOutput << "partial,row";
+		MV_THROW( MVException, "Unable to parse the rest of the data" );
+	}
+}
+
+NamedPipeWriterTest::NamedPipeWriterTest()
+:	m_pTempDir( NULL )
+{
+}
+
+NamedPipeWriterTest::~NamedPipeWriterTest()
+{
+}
+
+void NamedPipeWriterTest::setUp()
+{
+	m_pTempDir.reset( new TempDirectory() );
+}
+
+void NamedPipeWriterTest::tearDown()
+{
+	m_pTempDir.reset( NULL );
+}
+
+void NamedPipeWriterTest::testWrite()
+{
+	std::string fileSpec = m_pTempDir->GetDirectoryName() + "/data.dat";
+	std::string data = MakeData( 100000 );
+
+	NamedPipeWriter writer( fileSpec, boost::bind( &WriteData, _1, boost::cref( data ) ) );
+
+	struct stat status;
+	CPPUNIT_ASSERT_EQUAL( 0, ::stat( fileSpec.c_str(), &status ) );
+	CPPUNIT_ASSERT( S_ISFIFO( status.st_mode ) );
+
+	std::ifstream file( fileSpec.c_str() );
+	std::stringstream result;
+	result << file.rdbuf();
+	file.close();
+
+	CPPUNIT_ASSERT_NO_THROW( writer.Finish() );
+	CPPUNIT_ASSERT( result.str() == data );
+
+	// the pipe is left for the caller to remove
+	CPPUNIT_ASSERT_EQUAL( 0, ::stat( fileSpec.c_str(), &status ) );
+}
+
+void NamedPipeWriterTest::testNoReader()
+{
+	std::string fileSpec = m_pTempDir->GetDirectoryName() + "/data.dat";
+	std::string data = MakeData( 10 );
+
+	NamedPipeWriter writer( fileSpec, boost::bind( &WriteData, _1, boost::cref( data ) ) );
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( writer.Finish(), NamedPipeWriterException,
+		".*/NamedPipeWriter.cpp:\\d+: Nothing opened named pipe: " + fileSpec + " for reading" );
+}
+
+void NamedPipeWriterTest::testReaderStopsEarly()
+{
+	std::string fileSpec = m_pTempDir->GetDirectoryName() + "/data.dat";
+	std::string data = MakeData( 100000 );
+
+	NamedPipeWriter writer( fileSpec, boost::bind( &WriteData, _1, boost::cref( data ) ) );
+
+	// far more data than a pipe holds, so the writer is still writing when the reader goes away
+	std::ifstream file( fileSpec.c_str() );
+	std::string line;
+	std::getline( file, line );
+	CPPUNIT_ASSERT_EQUAL( std::string( "line 0,some,column,data" ), line );
+	file.close();
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( writer.Finish(), NamedPipeWriterException,
+		".*/NamedPipeWriter.cpp:\\d+: The reader of named pipe: " + fileSpec + " stopped reading before all the data was written" );
+}
+
+void NamedPipeWriterTest::testWriteFails()
+{
+	std::string fileSpec = m_pTempDir->GetDirectoryName() + "/data.dat";
+
+	NamedPipeWriter writer( fileSpec, &WriteAndFail );
+
+	std::ifstream file( fileSpec.c_str() );
+	std::stringstream result;
+	result << file.rdbuf();
+	file.close();
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( writer.Finish(), NamedPipeWriterException,
+		".*/NamedPipeWriter.cpp:\\d+: .*/NamedPipeWriterTest.cpp:\\d+: Unable to parse the rest of the data" );
+
+	// a failure is reported every time the writer is asked to finish
+	CPPUNIT_ASSERT_THROW( writer.Finish(), NamedPipeWriterException );
+}
+
+void NamedPipeWriterTest::testFileExists()
+{
+	std::string fileSpec = m_pTempDir->GetDirectoryName() + "/data.dat";
+	std::ofstream file( fileSpec.c_str() );
+	file.close();
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( NamedPipeWriter writer( fileSpec, &WriteAndFail ), NamedPipeWriterException,
+		".*/NamedPipeWriter.cpp:\\d+: Unable to create named pipe: " + fileSpec + ": File exists" );
+}
@@ -0,0 +1,40 @@
+#ifndef _NAMED_PIPE_WRITER_TEST_HPP_
+#define _NAMED_PIPE_WRITER_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <boost/scoped_ptr.hpp>
+
+class TempDirectory;
+
+class NamedPipeWriterTest : public CppUnit::TestFixture
+{
+private:
+	CPPUNIT_TEST_SUITE( NamedPipeWriterTest );
+
+	CPPUNIT_TEST( testWrite );
+	CPPUNIT_TEST( testNoReader );
+	CPPUNIT_TEST( testReaderStopsEarly );
+	CPPUNIT_TEST( testWriteFails );
+	CPPUNIT_TEST( testFileExists );
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	NamedPipeWriterTest();
+	virtual ~NamedPipeWriterTest();
+
+	void setUp();
+	void tearDown();
+
+	void testWrite();
+	void testNoReader();
+	void testReaderStopsEarly();
+	void testWriteFails();
+	void testFileExists();
+
+private:
+	boost::scoped_ptr< TempDirectory > m_pTempDir;
+};
+
+#endif //_NAMED_PIPE_WRITER_TEST_HPP_
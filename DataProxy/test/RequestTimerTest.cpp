@@ -0,0 +1,153 @@
+#include "RequestTimerTest.hpp"
+#include "RequestTimer.hpp"
+#include "MonitoringTracker.hpp"
+#include "MockMonitoringInstance.hpp"
+#include <boost/regex.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
+
+CPPUNIT_TEST_SUITE_REGISTRATION( RequestTimerTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( RequestTimerTest, "RequestTimerTest" );
+
+namespace
+{
+	const std::string PHASE_IMPL( "impl" );
+	const std::string PHASE_FORWARD( "forward" );
+
+	void Sleep( int i_Milliseconds )
+	{
+		boost::this_thread::sleep( boost::posix_time::milliseconds( i_Milliseconds ) );
+	}
+
+	// the value last reported for the metric, or -1 if it wasn't reported
+	double GetReported( const std::vector< std::pair< std::string, MonitoringMetric > >& i_rReports, const std::string& i_rMetric )
+	{
+		double result( -1 );
+		std::vector< std::pair< std::string, MonitoringMetric > >::const_iterator iter = i_rReports.begin();
+		for( ; iter != i_rReports.end(); ++iter )
+		{
+			if( iter->first.find( i_rMetric ) != std::string::npos )
+			{
+				result = iter->second.GetDouble();
+			}
+		}
+		return result;
+	}
+}
+
+RequestTimerTest::RequestTimerTest()
+{
+}
+
+RequestTimerTest::~RequestTimerTest()
+{
+}
+
+void RequestTimerTest::setUp()
+{
+}
+
+void RequestTimerTest::tearDown()
+{
+}
+
+void RequestTimerTest::testPhases()
+{
+	MonitoringTracker tracker( "dpl.load" );
+	RequestTimer timer( "name", "load", tracker );
+	CPPUNIT_ASSERT_EQUAL( 0.0, timer.GetSeconds( PHASE_IMPL ) );
+
+	// a phase entered more than once (e.g. on retry) adds up
+	{
+		RequestTimer::Phase phase( timer, PHASE_IMPL );
+		Sleep( 20 );
+	}
+	double first = timer.GetSeconds( PHASE_IMPL );
+	CPPUNIT_ASSERT( first >= 0.02 );
+	{
+		RequestTimer::Phase phase( timer, PHASE_IMPL );
+		Sleep( 20 );
+	}
+	CPPUNIT_ASSERT( timer.GetSeconds( PHASE_IMPL ) >= first + 0.02 );
+	CPPUNIT_ASSERT_EQUAL( 0.0, timer.GetSeconds( PHASE_FORWARD ) );
+}
+
+void RequestTimerTest::testSummary()
+{
+	MonitoringTracker tracker( "dpl.load" );
+	RequestTimer timer( "name", "load", tracker );
+	{
+		RequestTimer::Phase phase( timer, PHASE_IMPL );
+	}
+	{
+		RequestTimer::Phase phase( timer, PHASE_FORWARD );
+	}
+
+	// results default to failed; phases appear in the order they were first entered
+	boost::regex expected( "node=name operation=load result=fail total=\\d+\\.\\d{6} impl=\\d+\\.\\d{6} forward=\\d+\\.\\d{6}" );
+	CPPUNIT_ASSERT_MESSAGE( timer.GetSummary(), boost::regex_match( timer.GetSummary(), expected ) );
+
+	timer.SetResult( "success" );
+	expected = "node=name operation=load result=success total=.*";
+	CPPUNIT_ASSERT_MESSAGE( timer.GetSummary(), boost::regex_match( timer.GetSummary(), expected ) );
+}
+
+void RequestTimerTest::testNesting()
+{
+	CPPUNIT_ASSERT( RequestTimer::GetCurrent() == NULL );
+	MonitoringTracker tracker( "dpl.load" );
+	RequestTimer timer( "name", "load", tracker );
+	CPPUNIT_ASSERT( RequestTimer::GetCurrent() == &timer );
+	{
+		RequestTimer::Phase phase( timer, PHASE_FORWARD );
+
+		// a request issued while another is being timed on the same thread is its child
+		MonitoringTracker forwardTracker( "dpl.load" );
+		RequestTimer forwardTimer( "forwardName", "load", forwardTracker );
+		CPPUNIT_ASSERT( RequestTimer::GetCurrent() == &forwardTimer );
+		RequestTimer::Phase forwardPhase( forwardTimer, PHASE_IMPL );
+		forwardTimer.SetResult( "success" );
+	}
+	CPPUNIT_ASSERT( RequestTimer::GetCurrent() == &timer );
+	timer.SetResult( "forwarded" );
+
+	boost::regex expected( "node=name operation=load result=forwarded total=\\S+ forward=\\S+ "
+						   "\\{ node=forwardName operation=load result=success total=\\S+ impl=\\S+ \\}" );
+	CPPUNIT_ASSERT_MESSAGE( timer.GetSummary(), boost::regex_match( timer.GetSummary(), expected ) );
+
+	// once the child is done, requests are children of the parent again rather than of it
+	{
+		MonitoringTracker teeTracker( "dpl.store" );
+		RequestTimer teeTimer( "teeName", "store", teeTracker );
+	}
+	expected = ".* \\{ node=forwardName .* \\} \\{ node=teeName operation=store result=fail total=\\S+ \\}";
+	CPPUNIT_ASSERT_MESSAGE( timer.GetSummary(), boost::regex_match( timer.GetSummary(), expected ) );
+}
+
+void RequestTimerTest::testReports()
+{
+	MockMonitoringInstance* pMonitoringInstance = new MockMonitoringInstance();
+	boost::scoped_ptr< MonitoringInstance > pTemp( pMonitoringInstance );
+	ApplicationMonitor::Swap( pTemp );
+
+	{
+		MonitoringTracker tracker( "dpl.load" );
+		tracker.AddChild( "node", "name" );
+		RequestTimer timer( "name", "load", tracker );
+		{
+			RequestTimer::Phase phase( timer, PHASE_IMPL );
+			Sleep( 10 );
+		}
+		{
+			RequestTimer::Phase phase( timer, PHASE_FORWARD );
+		}
+		CPPUNIT_ASSERT_EQUAL( size_t(0), pMonitoringInstance->GetReports().size() );
+	}
+
+	// each phase is reported once the timer is done, as a metric named after it
+	const std::vector< std::pair< std::string, MonitoringMetric > >& rReports = pMonitoringInstance->GetReports();
+	CPPUNIT_ASSERT( GetReported( rReports, "implSeconds" ) >= 0.01 );
+	CPPUNIT_ASSERT( GetReported( rReports, "forwardSeconds" ) >= 0 );
+	CPPUNIT_ASSERT( GetReported( rReports, "forwardSeconds" ) < 0.01 );
+	CPPUNIT_ASSERT( GetReported( rReports, "translateSeconds" ) < 0 );
+}
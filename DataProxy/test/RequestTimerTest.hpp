@@ -0,0 +1,32 @@
+#ifndef _REQUEST_TIMER_TEST_HPP_
+#define _REQUEST_TIMER_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class RequestTimerTest : public CppUnit::TestFixture
+{
+private:
+	CPPUNIT_TEST_SUITE( RequestTimerTest );
+
+	CPPUNIT_TEST( testPhases );
+	CPPUNIT_TEST( testSummary );
+	CPPUNIT_TEST( testNesting );
+	CPPUNIT_TEST( testReports );
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	RequestTimerTest();
+	virtual ~RequestTimerTest();
+
+	void setUp();
+	void tearDown();
+
+	void testPhases();
+	void testSummary();
+	void testNesting();
+	void testReports();
+};
+
+#endif //_REQUEST_TIMER_TEST_HPP_
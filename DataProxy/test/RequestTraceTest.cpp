@@ -0,0 +1,190 @@
+#include "RequestTraceTest.hpp"
+#include "RequestTrace.hpp"
+#include "RequestTimer.hpp"
+#include "MonitoringTracker.hpp"
+#include <boost/bind.hpp>
+#include <boost/regex.hpp>
+#include <boost/thread/thread.hpp>
+
+CPPUNIT_TEST_SUITE_REGISTRATION( RequestTraceTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( RequestTraceTest, "RequestTraceTest" );
+
+namespace
+{
+	// times vary from run to run; replace them so the json can be compared
+	std::string StripTimes( const std::string& i_rJson )
+	{
+		return boost::regex_replace( i_rJson, boost::regex( "\"(start|end)\":\\d+\\.\\d{6}" ), "\"$1\":T" );
+	}
+
+	// records the context seen by a request made on another thread, inside & outside of the scope it was handed
+	void IssueRequest( const RequestTrace::Context& i_rContext, RequestTrace::Context& o_rOutside, RequestTrace::Context& o_rInside, size_t& o_rSpanId )
+	{
+		o_rOutside = RequestTrace::GetCurrent();
+		RequestTrace::Scope scope( i_rContext );
+		o_rInside = RequestTrace::GetCurrent();
+		o_rSpanId = i_rContext.m_pTrace->BeginSpan( i_rContext.m_SpanId, "teeName", "store" );
+		i_rContext.m_pTrace->EndSpan( o_rSpanId, "success", 10 );
+	}
+}
+
+RequestTraceTest::RequestTraceTest()
+:	m_SampleRate( 0 )
+{
+}
+
+RequestTraceTest::~RequestTraceTest()
+{
+}
+
+void RequestTraceTest::setUp()
+{
+	m_SampleRate = RequestTrace::GetSampleRate();
+}
+
+void RequestTraceTest::tearDown()
+{
+	RequestTrace::SetSampleRate( m_SampleRate );
+}
+
+void RequestTraceTest::testJson()
+{
+	RequestTrace trace;
+	CPPUNIT_ASSERT( !trace.GetId().empty() );
+
+	size_t root = trace.BeginSpan( 0, "router", "load" );
+	size_t first = trace.BeginSpan( root, "join", "load" );
+	size_t grandchild = trace.BeginSpan( first, "db\"1\"", "load" );
+	trace.EndSpan( grandchild, "success", 100 );
+	trace.EndSpan( first, "success", 150 );
+	size_t second = trace.BeginSpan( root, "file", "store" );
+
+	std::string expected = "{\"traceId\":\"" + trace.GetId() + "\",\"spans\":["
+		"{\"spanId\":1,\"node\":\"router\",\"operation\":\"load\",\"start\":T,\"children\":["
+			"{\"spanId\":2,\"node\":\"join\",\"operation\":\"load\",\"start\":T,\"end\":T,\"result\":\"success\",\"bytes\":150,\"children\":["
+				"{\"spanId\":3,\"node\":\"db\\\"1\\\"\",\"operation\":\"load\",\"start\":T,\"end\":T,\"result\":\"success\",\"bytes\":100,\"children\":[]}]},"
+			"{\"spanId\":4,\"node\":\"file\",\"operation\":\"store\",\"start\":T,\"children\":[]}]}]}";
+	CPPUNIT_ASSERT_EQUAL( expected, StripTimes( trace.GetJson() ) );
+
+	trace.EndSpan( second, "fail", 0 );
+	trace.EndSpan( root, "forwarded", 0 );
+	boost::regex finished( ".*\"spanId\":1,\"node\":\"router\",\"operation\":\"load\",\"start\":T,\"end\":T,\"result\":\"forwarded\",\"bytes\":0,.*"
+						   "\"spanId\":4,\"node\":\"file\",\"operation\":\"store\",\"start\":T,\"end\":T,\"result\":\"fail\",\"bytes\":0,.*" );
+	CPPUNIT_ASSERT_MESSAGE( trace.GetJson(), boost::regex_match( StripTimes( trace.GetJson() ), finished ) );
+}
+
+void RequestTraceTest::testScope()
+{
+	CPPUNIT_ASSERT( RequestTrace::GetCurrent().m_pTrace == NULL );
+
+	boost::shared_ptr< RequestTrace > pTrace( new RequestTrace() );
+	{
+		RequestTrace::Scope outer( RequestTrace::Context( pTrace, 1 ) );
+		CPPUNIT_ASSERT( RequestTrace::GetCurrent().m_pTrace == pTrace );
+		CPPUNIT_ASSERT_EQUAL( size_t(1), RequestTrace::GetCurrent().m_SpanId );
+		{
+			RequestTrace::Scope inner( RequestTrace::Context( pTrace, 2 ) );
+			CPPUNIT_ASSERT_EQUAL( size_t(2), RequestTrace::GetCurrent().m_SpanId );
+		}
+		CPPUNIT_ASSERT_EQUAL( size_t(1), RequestTrace::GetCurrent().m_SpanId );
+	}
+	CPPUNIT_ASSERT( RequestTrace::GetCurrent().m_pTrace == NULL );
+	CPPUNIT_ASSERT_EQUAL( size_t(0), RequestTrace::GetCurrent().m_SpanId );
+}
+
+void RequestTraceTest::testOtherThread()
+{
+	boost::shared_ptr< RequestTrace > pTrace( new RequestTrace() );
+	size_t root = pTrace->BeginSpan( 0, "name", "load" );
+	RequestTrace::Scope scope( RequestTrace::Context( pTrace, root ) );
+
+	// the context doesn't follow work to another thread unless it is handed over
+	RequestTrace::Context outside;
+	RequestTrace::Context inside;
+	size_t spanId( 0 );
+	boost::thread thread( boost::bind( &IssueRequest, RequestTrace::GetCurrent(), boost::ref( outside ), boost::ref( inside ), boost::ref( spanId ) ) );
+	thread.join();
+
+	CPPUNIT_ASSERT( outside.m_pTrace == NULL );
+	CPPUNIT_ASSERT( inside.m_pTrace == pTrace );
+	CPPUNIT_ASSERT_EQUAL( root, inside.m_SpanId );
+	boost::regex expected( ".*\"spanId\":1,\"node\":\"name\".*\"children\":\\[\\{\"spanId\":2,\"node\":\"teeName\",\"operation\":\"store\".*\"bytes\":10,.*" );
+	CPPUNIT_ASSERT_MESSAGE( pTrace->GetJson(), boost::regex_match( pTrace->GetJson(), expected ) );
+}
+
+void RequestTraceTest::testRequestTimer()
+{
+	RequestTrace::SetSampleRate( 1 );
+	boost::shared_ptr< RequestTrace > pTrace;
+	{
+		MonitoringTracker tracker( "dpl.load" );
+		RequestTimer timer( "name", "load", tracker );
+		pTrace = RequestTrace::GetCurrent().m_pTrace;
+		CPPUNIT_ASSERT( pTrace != NULL );
+		{
+			// requests made while another is being timed are spans of the same trace
+			MonitoringTracker forwardTracker( "dpl.load" );
+			RequestTimer forwardTimer( "forwardName", "load", forwardTracker );
+			CPPUNIT_ASSERT( RequestTrace::GetCurrent().m_pTrace == pTrace );
+			CPPUNIT_ASSERT_EQUAL( size_t(2), RequestTrace::GetCurrent().m_SpanId );
+			forwardTimer.SetResult( "success" );
+			forwardTimer.SetBytes( 20 );
+		}
+		CPPUNIT_ASSERT_EQUAL( size_t(1), RequestTrace::GetCurrent().m_SpanId );
+		timer.SetResult( "forwarded" );
+	}
+	CPPUNIT_ASSERT( RequestTrace::GetCurrent().m_pTrace == NULL );
+
+	std::string expected = "{\"traceId\":\"" + pTrace->GetId() + "\",\"spans\":["
+		"{\"spanId\":1,\"node\":\"name\",\"operation\":\"load\",\"start\":T,\"end\":T,\"result\":\"forwarded\",\"bytes\":0,\"children\":["
+			"{\"spanId\":2,\"node\":\"forwardName\",\"operation\":\"load\",\"start\":T,\"end\":T,\"result\":\"success\",\"bytes\":20,\"children\":[]}]}]}";
+	CPPUNIT_ASSERT_EQUAL( expected, StripTimes( pTrace->GetJson() ) );
+}
+
+void RequestTraceTest::testSampling()
+{
+	// tracing is off by default
+	CPPUNIT_ASSERT_EQUAL( 0.0, m_SampleRate );
+	RequestTrace::SetSampleRate( 0 );
+	{
+		MonitoringTracker tracker( "dpl.load" );
+		RequestTimer timer( "name", "load", tracker );
+		CPPUNIT_ASSERT( RequestTrace::GetCurrent().m_pTrace == NULL );
+		CPPUNIT_ASSERT( RequestTrace::GetCurrent().m_InRequest );
+	}
+	CPPUNIT_ASSERT( !RequestTrace::GetCurrent().m_InRequest );
+
+	// samples are evenly spaced
+	RequestTrace::SetSampleRate( 0.25 );
+	size_t sampled( 0 );
+	for( size_t i = 0; i < 100; ++i )
+	{
+		sampled += RequestTrace::Sample() ? 1 : 0;
+	}
+	CPPUNIT_ASSERT_EQUAL( size_t(25), sampled );
+
+	// a request that isn't sampled doesn't have the requests it issues sampled on their own, while one that
+	// is takes them all along
+	RequestTrace::SetSampleRate( 0.5 );
+	size_t traced( 0 );
+	for( size_t i = 0; i < 2; ++i )
+	{
+		MonitoringTracker tracker( "dpl.load" );
+		RequestTimer timer( "name", "load", tracker );
+		boost::shared_ptr< RequestTrace > pTrace = RequestTrace::GetCurrent().m_pTrace;
+		traced += ( pTrace ? 1 : 0 );
+		for( size_t j = 0; j < 3; ++j )
+		{
+			MonitoringTracker forwardTracker( "dpl.load" );
+			RequestTimer forwardTimer( "forwardName", "load", forwardTracker );
+			CPPUNIT_ASSERT( RequestTrace::GetCurrent().m_pTrace == pTrace );
+		}
+	}
+	CPPUNIT_ASSERT_EQUAL( size_t(1), traced );
+
+	// out of range rates are clamped
+	RequestTrace::SetSampleRate( 2 );
+	CPPUNIT_ASSERT_EQUAL( 1.0, RequestTrace::GetSampleRate() );
+	RequestTrace::SetSampleRate( -1 );
+	CPPUNIT_ASSERT_EQUAL( 0.0, RequestTrace::GetSampleRate() );
+}
@@ -0,0 +1,37 @@
+#ifndef _REQUEST_TRACE_TEST_HPP_
+#define _REQUEST_TRACE_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class RequestTraceTest : public CppUnit::TestFixture
+{
+private:
+	CPPUNIT_TEST_SUITE( RequestTraceTest );
+
+	CPPUNIT_TEST( testJson );
+	CPPUNIT_TEST( testScope );
+	CPPUNIT_TEST( testOtherThread );
+	CPPUNIT_TEST( testRequestTimer );
+	CPPUNIT_TEST( testSampling );
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	RequestTraceTest();
+	virtual ~RequestTraceTest();
+
+	void setUp();
+	void tearDown();
+
+	void testJson();
+	void testScope();
+	void testOtherThread();
+	void testRequestTimer();
+	void testSampling();
+
+private:
+	double m_SampleRate;
+};
+
+#endif //_REQUEST_TRACE_TEST_HPP_
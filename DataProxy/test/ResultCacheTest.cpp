@@ -0,0 +1,285 @@
+#include "ResultCacheTest.hpp"
+#include "ResultCache.hpp"
+#include "TempDirectory.hpp"
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/tee.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <sstream>
+#include <dirent.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ResultCacheTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( ResultCacheTest, "ResultCacheTest" );
+
+namespace
+{
+	size_t CountFiles( const std::string& i_rDirectory )
+	{
+		size_t result( 0 );
+		DIR* pDirectory = ::opendir( i_rDirectory.c_str() );
+		if( pDirectory == NULL )
+		{
+			return result;
+		}
+		struct dirent* pEntry;
+		while( ( pEntry = ::readdir( pDirectory ) ) != NULL )
+		{
+			std::string name( pEntry->d_name );
+			if( name != "." && name != ".." )
+			{
+				++result;
+			}
+		}
+		::closedir( pDirectory );
+		return result;
+	}
+
+	std::string Get( ResultCache& i_rCache, const std::string& i_rKey )
+	{
+		size_t evictions;
+		boost::shared_ptr< const std::string > pData = i_rCache.Get( i_rKey, evictions );
+		return pData ? *pData : "<miss>";
+	}
+
+	// stores & finds entries that keep being spilled to disk & promoted back, recording any wrong data found
+	void SpillAndPromote( ResultCache& i_rCache, char i_Key, size_t& o_rErrors )
+	{
+		for( int i = 0; i < 200; ++i )
+		{
+			std::string key( 1, i_Key + ( i % 4 ) );
+			i_rCache.Put( key, std::string( 10, key[0] ) );
+			std::string data = Get( i_rCache, std::string( 1, i_Key + ( ( i + 2 ) % 4 ) ) );
+			if( data != "<miss>" && data != std::string( 10, i_Key + ( ( i + 2 ) % 4 ) ) )
+			{
+				++o_rErrors;
+			}
+		}
+	}
+}
+
+ResultCacheTest::ResultCacheTest()
+:	m_pTempDir( NULL )
+{
+}
+
+ResultCacheTest::~ResultCacheTest()
+{
+}
+
+void ResultCacheTest::setUp()
+{
+	m_pTempDir.reset( new TempDirectory() );
+}
+
+void ResultCacheTest::tearDown()
+{
+	m_pTempDir.reset( NULL );
+}
+
+void ResultCacheTest::testGetPut()
+{
+	ResultCache cache( 60, 1024, "", 0 );
+	CPPUNIT_ASSERT_EQUAL( std::string( "<miss>" ), Get( cache, "a" ) );
+
+	CPPUNIT_ASSERT_EQUAL( size_t(0), cache.Put( "a", "data a" ) );
+	CPPUNIT_ASSERT_EQUAL( size_t(0), cache.Put( "b", "data b" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "data a" ), Get( cache, "a" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "data b" ), Get( cache, "b" ) );
+
+	// replacing an entry
+	CPPUNIT_ASSERT_EQUAL( size_t(0), cache.Put( "a", "new data a" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "new data a" ), Get( cache, "a" ) );
+
+	// empty results are cached too
+	cache.Put( "c", "" );
+	CPPUNIT_ASSERT_EQUAL( std::string( "" ), Get( cache, "c" ) );
+}
+
+void ResultCacheTest::testExpiration()
+{
+	ResultCache cache( 0.05, 1024, "", 0 );
+	cache.Put( "a", "data a" );
+	CPPUNIT_ASSERT_EQUAL( std::string( "data a" ), Get( cache, "a" ) );
+
+	boost::this_thread::sleep( boost::posix_time::milliseconds( 100 ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "<miss>" ), Get( cache, "a" ) );
+
+	// an expired entry frees its space
+	CPPUNIT_ASSERT_EQUAL( size_t(0), cache.Put( "b", std::string( 1024, 'b' ) ) );
+}
+
+void ResultCacheTest::testLeastRecentlyUsedEviction()
+{
+	ResultCache cache( 60, 30, "", 0 );
+	cache.Put( "a", std::string( 10, 'a' ) );
+	cache.Put( "b", std::string( 10, 'b' ) );
+	cache.Put( "c", std::string( 10, 'c' ) );
+
+	// a becomes the most recently used, so b is evicted first
+	CPPUNIT_ASSERT_EQUAL( std::string( 10, 'a' ), Get( cache, "a" ) );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), cache.Put( "d", std::string( 10, 'd' ) ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "<miss>" ), Get( cache, "b" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( 10, 'a' ), Get( cache, "a" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( 10, 'c' ), Get( cache, "c" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( 10, 'd' ), Get( cache, "d" ) );
+
+	// a large entry may evict several
+	CPPUNIT_ASSERT_EQUAL( size_t(3), cache.Put( "e", std::string( 30, 'e' ) ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "<miss>" ), Get( cache, "a" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( 30, 'e' ), Get( cache, "e" ) );
+}
+
+void ResultCacheTest::testTooLarge()
+{
+	ResultCache cache( 60, 30, "", 0 );
+	CPPUNIT_ASSERT_EQUAL( size_t(30), cache.GetMaxEntryBytes() );
+	cache.Put( "a", std::string( 10, 'a' ) );
+
+	// an entry that could never fit is not stored, and evicts nothing
+	CPPUNIT_ASSERT_EQUAL( size_t(0), cache.Put( "b", std::string( 31, 'b' ) ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "<miss>" ), Get( cache, "b" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( 10, 'a' ), Get( cache, "a" ) );
+}
+
+void ResultCacheTest::testDiskTier()
+{
+	std::string dir = m_pTempDir->GetDirectoryName();
+	{
+		ResultCache cache( 60, 20, dir, 1024 );
+		cache.Put( "a", std::string( 10, 'a' ) );
+		cache.Put( "b", std::string( 10, 'b' ) );
+		CPPUNIT_ASSERT_EQUAL( size_t(0), CountFiles( dir ) );
+
+		// a is spilled to disk rather than dropped
+		CPPUNIT_ASSERT_EQUAL( size_t(1), cache.Put( "c", std::string( 10, 'c' ) ) );
+		CPPUNIT_ASSERT_EQUAL( size_t(1), CountFiles( dir ) );
+
+		// finding it promotes it back to memory, spilling b
+		size_t evictions;
+		boost::shared_ptr< const std::string > pData = cache.Get( "a", evictions );
+		CPPUNIT_ASSERT( pData );
+		CPPUNIT_ASSERT_EQUAL( std::string( 10, 'a' ), *pData );
+		CPPUNIT_ASSERT_EQUAL( size_t(1), evictions );
+		CPPUNIT_ASSERT_EQUAL( size_t(1), CountFiles( dir ) );
+
+		CPPUNIT_ASSERT_EQUAL( std::string( 10, 'b' ), Get( cache, "b" ) );
+		CPPUNIT_ASSERT_EQUAL( std::string( 10, 'c' ), Get( cache, "c" ) );
+		CPPUNIT_ASSERT_EQUAL( std::string( 10, 'a' ), Get( cache, "a" ) );
+
+		// replacing an entry that is on disk removes its file
+		CPPUNIT_ASSERT_EQUAL( size_t(1), CountFiles( dir ) );
+		cache.Put( "b", std::string( 5, 'B' ) );
+		CPPUNIT_ASSERT_EQUAL( std::string( 5, 'B' ), Get( cache, "b" ) );
+	}
+
+	// files are cleaned up when the cache is destroyed
+	CPPUNIT_ASSERT_EQUAL( size_t(0), CountFiles( dir ) );
+}
+
+void ResultCacheTest::testDiskEviction()
+{
+	std::string dir = m_pTempDir->GetDirectoryName();
+	ResultCache cache( 60, 10, dir, 20 );
+	cache.Put( "a", std::string( 10, 'a' ) );
+	cache.Put( "b", std::string( 10, 'b' ) );
+	cache.Put( "c", std::string( 10, 'c' ) );
+	CPPUNIT_ASSERT_EQUAL( size_t(2), CountFiles( dir ) );
+
+	// spilling c pushes a off the disk as well
+	CPPUNIT_ASSERT_EQUAL( size_t(2), cache.Put( "d", std::string( 10, 'd' ) ) );
+	CPPUNIT_ASSERT_EQUAL( size_t(2), CountFiles( dir ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "<miss>" ), Get( cache, "a" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( 10, 'd' ), Get( cache, "d" ) );
+}
+
+void ResultCacheTest::testClear()
+{
+	std::string dir = m_pTempDir->GetDirectoryName();
+	ResultCache cache( 60, 10, dir, 20 );
+	size_t generation = cache.GetGeneration();
+	cache.Put( "a", std::string( 10, 'a' ) );
+	cache.Put( "b", std::string( 10, 'b' ) );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), CountFiles( dir ) );
+
+	// both tiers are emptied
+	cache.Clear();
+	CPPUNIT_ASSERT_EQUAL( size_t(0), CountFiles( dir ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "<miss>" ), Get( cache, "a" ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "<miss>" ), Get( cache, "b" ) );
+
+	// a result loaded before the clear isn't stored; one loaded after it is
+	CPPUNIT_ASSERT( cache.GetGeneration() != generation );
+	cache.Put( "a", std::string( 10, 'a' ), generation );
+	CPPUNIT_ASSERT_EQUAL( std::string( "<miss>" ), Get( cache, "a" ) );
+	cache.Put( "a", std::string( 10, 'A' ), cache.GetGeneration() );
+	CPPUNIT_ASSERT_EQUAL( std::string( 10, 'A' ), Get( cache, "a" ) );
+}
+
+void ResultCacheTest::testConcurrentDiskTier()
+{
+	std::string dir = m_pTempDir->GetDirectoryName();
+	{
+		// files are written & read outside the cache's lock; entries must still never be mixed up
+		ResultCache cache( 60, 30, dir, 50 );
+		const size_t numThreads( 4 );
+		size_t errors[ numThreads ] = { 0 };
+		boost::thread_group threads;
+		for( size_t i = 0; i < numThreads; ++i )
+		{
+			threads.create_thread( boost::bind( &SpillAndPromote, boost::ref( cache ), char( 'a' + 4 * i ), boost::ref( errors[i] ) ) );
+		}
+		threads.create_thread( boost::bind( &ResultCache::Clear, boost::ref( cache ) ) );
+		threads.join_all();
+
+		for( size_t i = 0; i < numThreads; ++i )
+		{
+			CPPUNIT_ASSERT_EQUAL( size_t(0), errors[i] );
+		}
+		CPPUNIT_ASSERT( CountFiles( dir ) <= 5 );
+	}
+	CPPUNIT_ASSERT_EQUAL( size_t(0), CountFiles( dir ) );
+}
+
+void ResultCacheTest::testMakeKey()
+{
+	std::map< std::string, std::string > parameters;
+	CPPUNIT_ASSERT_EQUAL( std::string( "" ), ResultCache::MakeKey( parameters ) );
+
+	parameters[ "a" ] = "b";
+	parameters[ "cd" ] = "";
+	CPPUNIT_ASSERT_EQUAL( std::string( "1:a1:b2:cd0:" ), ResultCache::MakeKey( parameters ) );
+
+	// keys don't collide just because the concatenated names & values do
+	std::map< std::string, std::string > parameters1;
+	std::map< std::string, std::string > parameters2;
+	parameters1[ "ab" ] = "c";
+	parameters2[ "a" ] = "bc";
+	CPPUNIT_ASSERT( ResultCache::MakeKey( parameters1 ) != ResultCache::MakeKey( parameters2 ) );
+}
+
+void ResultCacheTest::testCapture()
+{
+	std::stringstream output;
+	std::string captured;
+	bool overflowed( false );
+	{
+		boost::iostreams::filtering_ostream stream;
+		stream.push( boost::iostreams::tee( ResultCache::Capture( captured, overflowed, 10 ) ) );
+		stream.push( output );
+		stream << "12345";
+	}
+	CPPUNIT_ASSERT_EQUAL( std::string( "12345" ), output.str() );
+	CPPUNIT_ASSERT_EQUAL( std::string( "12345" ), captured );
+	CPPUNIT_ASSERT( !overflowed );
+
+	// once over the limit, the capture is abandoned but the output is unaffected
+	{
+		boost::iostreams::filtering_ostream stream;
+		stream.push( boost::iostreams::tee( ResultCache::Capture( captured, overflowed, 10 ) ) );
+		stream.push( output );
+		stream << "678901";
+	}
+	CPPUNIT_ASSERT_EQUAL( std::string( "12345678901" ), output.str() );
+	CPPUNIT_ASSERT_EQUAL( std::string( "" ), captured );
+	CPPUNIT_ASSERT( overflowed );
+}
@@ -0,0 +1,50 @@
+#ifndef _RESULT_CACHE_TEST_HPP_
+#define _RESULT_CACHE_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <boost/scoped_ptr.hpp>
+
+class TempDirectory;
+
+class ResultCacheTest : public CppUnit::TestFixture
+{
+private:
+	CPPUNIT_TEST_SUITE( ResultCacheTest );
+
+	CPPUNIT_TEST( testGetPut );
+	CPPUNIT_TEST( testExpiration );
+	CPPUNIT_TEST( testLeastRecentlyUsedEviction );
+	CPPUNIT_TEST( testTooLarge );
+	CPPUNIT_TEST( testDiskTier );
+	CPPUNIT_TEST( testDiskEviction );
+	CPPUNIT_TEST( testClear );
+	CPPUNIT_TEST( testConcurrentDiskTier );
+	CPPUNIT_TEST( testMakeKey );
+	CPPUNIT_TEST( testCapture );
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	ResultCacheTest();
+	virtual ~ResultCacheTest();
+
+	void setUp();
+	void tearDown();
+
+	void testGetPut();
+	void testExpiration();
+	void testLeastRecentlyUsedEviction();
+	void testTooLarge();
+	void testDiskTier();
+	void testDiskEviction();
+	void testClear();
+	void testConcurrentDiskTier();
+	void testMakeKey();
+	void testCapture();
+
+private:
+	boost::scoped_ptr< TempDirectory > m_pTempDir;
+};
+
+#endif //_RESULT_CACHE_TEST_HPP_
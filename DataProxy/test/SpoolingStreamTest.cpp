@@ -0,0 +1,322 @@
+#include "SpoolingStreamTest.hpp"
+#include "SpoolingStream.hpp"
+#include "TempDirectory.hpp"
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <limits>
+#include <sstream>
+#include <signal.h>
+#include <sys/resource.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION( SpoolingStreamTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( SpoolingStreamTest, "SpoolingStreamTest" );
+
+namespace
+{
+	std::string MakeData( size_t i_Lines )
+	{
+		std::stringstream data;
+		for( size_t i = 0; i < i_Lines; ++i )
+		{
+			data << "line " << i << ",some,column,data" << std::endl;
+		}
+		return data.str();
+	}
+
+	std::string ReadAll( std::istream& i_rInput )
+	{
+		std::stringstream result;
+		result << i_rInput.rdbuf();
+		return result.str();
+	}
+
+	// caps the size of any file this process writes, so spilled data past the cap fails to be written
+	class ScopedFileSizeLimit
+	{
+	public:
+		ScopedFileSizeLimit( rlim_t i_Limit )
+		{
+			::getrlimit( RLIMIT_FSIZE, &m_Original );
+			rlimit limit( m_Original );
+			limit.rlim_cur = i_Limit;
+			::setrlimit( RLIMIT_FSIZE, &limit );
+			// report EFBIG instead of killing the process
+			m_pOriginalHandler = ::signal( SIGXFSZ, SIG_IGN );
+		}
+
+		~ScopedFileSizeLimit()
+		{
+			::setrlimit( RLIMIT_FSIZE, &m_Original );
+			::signal( SIGXFSZ, m_pOriginalHandler );
+		}
+
+	private:
+		rlimit m_Original;
+		sighandler_t m_pOriginalHandler;
+	};
+
+	// a forward-only source that records how far it has been read
+	class CountingSource
+	{
+	public:
+		typedef char char_type;
+		typedef boost::iostreams::source_tag category;
+
+		CountingSource( const std::string& i_rData, size_t& o_rConsumed )
+		:	m_pData( &i_rData ),
+			m_pConsumed( &o_rConsumed )
+		{
+		}
+
+		std::streamsize read( char* o_pData, std::streamsize i_Size )
+		{
+			std::streamsize size = std::min( i_Size, std::streamsize( m_pData->size() - *m_pConsumed ) );
+			if( size == 0 )
+			{
+				return -1;
+			}
+			m_pData->copy( o_pData, size, *m_pConsumed );
+			*m_pConsumed += size;
+			return size;
+		}
+
+	private:
+		const std::string* m_pData;
+		size_t* m_pConsumed;
+	};
+
+	// a forward-only source that fails once it has returned its data
+	class FailingSource
+	{
+	public:
+		typedef char char_type;
+		typedef boost::iostreams::source_tag category;
+
+		FailingSource( const std::string& i_rData )
+		:	m_pData( &i_rData ),
+			m_Consumed( 0 )
+		{
+		}
+
+		std::streamsize read( char* o_pData, std::streamsize i_Size )
+		{
+			std::streamsize size = std::min( i_Size, std::streamsize( m_pData->size() - m_Consumed ) );
+			if( size == 0 )
+			{
+				throw std::ios_base::failure( "source failed" );
+			}
+			m_pData->copy( o_pData, size, m_Consumed );
+			m_Consumed += size;
+			return size;
+		}
+
+	private:
+		const std::string* m_pData;
+		size_t m_Consumed;
+	};
+}
+
+SpoolingStreamTest::SpoolingStreamTest()
+:	m_pTempDir( NULL )
+{
+}
+
+SpoolingStreamTest::~SpoolingStreamTest()
+{
+}
+
+void SpoolingStreamTest::setUp()
+{
+	m_pTempDir.reset( new TempDirectory() );
+}
+
+void SpoolingStreamTest::tearDown()
+{
+	m_pTempDir.reset( NULL );
+}
+
+void SpoolingStreamTest::testReadThrough()
+{
+	std::string data( MakeData( 10000 ) );
+	size_t consumed( 0 );
+	boost::iostreams::filtering_istream source;
+	source.push( CountingSource( data, consumed ) );
+
+	SpoolingStream stream( source, std::numeric_limits< size_t >::max(), m_pTempDir->GetDirectoryName() );
+	CPPUNIT_ASSERT_EQUAL( std::streampos( 0 ), stream.tellg() );
+	CPPUNIT_ASSERT_EQUAL( data, ReadAll( stream ) );
+	CPPUNIT_ASSERT( !stream.IsSpilled() );
+	CPPUNIT_ASSERT_EQUAL( size_t(0), stream.GetSpilledBytes() );
+}
+
+void SpoolingStreamTest::testReadsIncrementally()
+{
+	std::string data( MakeData( 100000 ) );
+	size_t consumed( 0 );
+	boost::iostreams::filtering_istream source;
+	source.push( CountingSource( data, consumed ), 1024 );
+
+	SpoolingStream stream( source, std::numeric_limits< size_t >::max(), m_pTempDir->GetDirectoryName() );
+	CPPUNIT_ASSERT_EQUAL( size_t(0), consumed );
+
+	// reading the first line must not drain the source
+	std::string line;
+	CPPUNIT_ASSERT( std::getline( stream, line ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "line 0,some,column,data" ), line );
+	CPPUNIT_ASSERT( consumed > 0 );
+	CPPUNIT_ASSERT( consumed < data.size() / 2 );
+}
+
+void SpoolingStreamTest::testRewind()
+{
+	std::string data( MakeData( 10000 ) );
+	size_t consumed( 0 );
+	boost::iostreams::filtering_istream source;
+	source.push( CountingSource( data, consumed ) );
+
+	SpoolingStream stream( source, std::numeric_limits< size_t >::max(), m_pTempDir->GetDirectoryName() );
+	std::vector< char > buffer( 100 );
+	CPPUNIT_ASSERT( stream.read( &buffer[0], buffer.size() ) );
+	std::streampos position = stream.tellg();
+	CPPUNIT_ASSERT_EQUAL( std::streampos( 100 ), position );
+
+	// read to the end, then go back to the saved position & to the beginning
+	CPPUNIT_ASSERT_EQUAL( data.substr( 100 ), ReadAll( stream ) );
+	stream.clear();
+	stream.seekg( position );
+	CPPUNIT_ASSERT_EQUAL( data.substr( 100 ), ReadAll( stream ) );
+	stream.clear();
+	stream.seekg( 0 );
+	CPPUNIT_ASSERT_EQUAL( data, ReadAll( stream ) );
+	stream.clear();
+	stream.seekg( -10, std::ios_base::end );
+	CPPUNIT_ASSERT_EQUAL( data.substr( data.size() - 10 ), ReadAll( stream ) );
+}
+
+void SpoolingStreamTest::testSeekForward()
+{
+	std::string data( MakeData( 10000 ) );
+	size_t consumed( 0 );
+	boost::iostreams::filtering_istream source;
+	source.push( CountingSource( data, consumed ) );
+
+	SpoolingStream stream( source, std::numeric_limits< size_t >::max(), m_pTempDir->GetDirectoryName() );
+	stream.seekg( 200000 );
+	CPPUNIT_ASSERT( stream.good() );
+	CPPUNIT_ASSERT_EQUAL( std::streampos( 200000 ), stream.tellg() );
+	CPPUNIT_ASSERT_EQUAL( data.substr( 200000 ), ReadAll( stream ) );
+
+	// and back again
+	stream.clear();
+	stream.seekg( 10 );
+	CPPUNIT_ASSERT_EQUAL( data.substr( 10 ), ReadAll( stream ) );
+
+	// past the end of the source
+	stream.clear();
+	stream.seekg( data.size() + 1 );
+	CPPUNIT_ASSERT( stream.fail() );
+}
+
+void SpoolingStreamTest::testSeekEnd()
+{
+	std::string data( MakeData( 10000 ) );
+	size_t consumed( 0 );
+	boost::iostreams::filtering_istream source;
+	source.push( CountingSource( data, consumed ) );
+
+	SpoolingStream stream( source, std::numeric_limits< size_t >::max(), m_pTempDir->GetDirectoryName() );
+	std::string line;
+	CPPUNIT_ASSERT( std::getline( stream, line ) );
+	std::streampos position = stream.tellg();
+
+	// measuring the size (as the byte count parameter translation does) drains the source
+	stream.seekg( 0, std::ios_base::end );
+	CPPUNIT_ASSERT_EQUAL( std::streampos( data.size() ), stream.tellg() );
+	CPPUNIT_ASSERT_EQUAL( data.size(), consumed );
+
+	stream.seekg( position );
+	CPPUNIT_ASSERT_EQUAL( data.substr( line.size() + 1 ), ReadAll( stream ) );
+}
+
+void SpoolingStreamTest::testSpill()
+{
+	std::string data( MakeData( 100000 ) );
+	size_t consumed( 0 );
+	boost::iostreams::filtering_istream source;
+	source.push( CountingSource( data, consumed ) );
+
+	SpoolingStream stream( source, 100 * 1024, m_pTempDir->GetDirectoryName() );
+	CPPUNIT_ASSERT_EQUAL( data, ReadAll( stream ) );
+	CPPUNIT_ASSERT( stream.IsSpilled() );
+	CPPUNIT_ASSERT( stream.GetSpilledBytes() > 0 );
+
+	stream.clear();
+	stream.seekg( 12345 );
+	CPPUNIT_ASSERT_EQUAL( data.substr( 12345 ), ReadAll( stream ) );
+}
+
+void SpoolingStreamTest::testIsSeekable()
+{
+	std::stringstream seekable( "some data" );
+	CPPUNIT_ASSERT( SpoolingStream::IsSeekable( seekable ) );
+
+	std::string data( "some data" );
+	size_t consumed( 0 );
+	boost::iostreams::filtering_istream source;
+	source.push( CountingSource( data, consumed ) );
+	CPPUNIT_ASSERT( !SpoolingStream::IsSeekable( source ) );
+
+	SpoolingStream stream( source, std::numeric_limits< size_t >::max(), m_pTempDir->GetDirectoryName() );
+	CPPUNIT_ASSERT( SpoolingStream::IsSeekable( stream ) );
+}
+
+void SpoolingStreamTest::testSourceFailure()
+{
+	std::string data( MakeData( 10000 ) );
+	boost::iostreams::filtering_istream source;
+	source.push( FailingSource( data ) );
+	source.exceptions( std::ios_base::badbit );
+
+	SpoolingStream stream( source, std::numeric_limits< size_t >::max(), m_pTempDir->GetDirectoryName() );
+	std::vector< char > buffer( data.size() + 1 );
+	CPPUNIT_ASSERT_THROW( stream.read( &buffer[0], buffer.size() ), std::ios_base::failure );
+
+	// rewinding doesn't turn the failure into the end of the data
+	stream.clear();
+	stream.seekg( 0 );
+	CPPUNIT_ASSERT_THROW( stream.read( &buffer[0], buffer.size() ), std::ios_base::failure );
+
+	// a source that doesn't throw leaves the spool bad instead
+	boost::iostreams::filtering_istream quietSource;
+	quietSource.push( FailingSource( data ) );
+	SpoolingStream quietStream( quietSource, std::numeric_limits< size_t >::max(), m_pTempDir->GetDirectoryName() );
+	CPPUNIT_ASSERT( !quietStream.read( &buffer[0], buffer.size() ) );
+	CPPUNIT_ASSERT( quietStream.bad() );
+}
+
+void SpoolingStreamTest::testSpoolFailure()
+{
+	std::string data( MakeData( 100000 ) );
+	size_t consumed( 0 );
+	boost::iostreams::filtering_istream source;
+	source.push( CountingSource( data, consumed ) );
+
+	SpoolingStream stream( source, 100 * 1024, m_pTempDir->GetDirectoryName() );
+	{
+		ScopedFileSizeLimit limit( 1024 * 1024 );
+		// the data is still read through once...
+		CPPUNIT_ASSERT_EQUAL( data, ReadAll( stream ) );
+	}
+	CPPUNIT_ASSERT( stream.IsSpilled() );
+
+	// ...but going back over what couldn't be spooled is an error, not a short read
+	stream.clear();
+	CPPUNIT_ASSERT_THROW( stream.seekg( 0 ), SpoolingStreamException );
+	stream.clear();
+	CPPUNIT_ASSERT_THROW( stream.seekg( 12345 ), SpoolingStreamException );
+
+	// reading on from the end is still fine
+	stream.clear();
+	stream.seekg( 0, std::ios_base::end );
+	CPPUNIT_ASSERT_EQUAL( std::streampos( data.size() ), stream.tellg() );
+}
@@ -0,0 +1,48 @@
+#ifndef _SPOOLING_STREAM_TEST_HPP_
+#define _SPOOLING_STREAM_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <boost/scoped_ptr.hpp>
+
+class TempDirectory;
+
+class SpoolingStreamTest : public CppUnit::TestFixture
+{
+private:
+	CPPUNIT_TEST_SUITE( SpoolingStreamTest );
+
+	CPPUNIT_TEST( testReadThrough );
+	CPPUNIT_TEST( testReadsIncrementally );
+	CPPUNIT_TEST( testRewind );
+	CPPUNIT_TEST( testSeekForward );
+	CPPUNIT_TEST( testSeekEnd );
+	CPPUNIT_TEST( testSpill );
+	CPPUNIT_TEST( testIsSeekable );
+	CPPUNIT_TEST( testSourceFailure );
+	CPPUNIT_TEST( testSpoolFailure );
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	SpoolingStreamTest();
+	virtual ~SpoolingStreamTest();
+
+	void setUp();
+	void tearDown();
+
+	void testReadThrough();
+	void testReadsIncrementally();
+	void testRewind();
+	void testSeekForward();
+	void testSeekEnd();
+	void testSpill();
+	void testIsSeekable();
+	void testSourceFailure();
+	void testSpoolFailure();
+
+private:
+	boost::scoped_ptr< TempDirectory > m_pTempDir;
+};
+
+#endif //_SPOOLING_STREAM_TEST_HPP_
@@ -0,0 +1,232 @@
+#include "StagingStreamTest.hpp"
+#include "StagingStream.hpp"
+#include "TempDirectory.hpp"
+#include <sstream>
+#include <dirent.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION( StagingStreamTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( StagingStreamTest, "StagingStreamTest" );
+
+namespace
+{
+	size_t CountFiles( const std::string& i_rDirectory )
+	{
+		size_t result( 0 );
+		DIR* pDirectory = ::opendir( i_rDirectory.c_str() );
+		if( pDirectory == NULL )
+		{
+			return result;
+		}
+		struct dirent* pEntry;
+		while( ( pEntry = ::readdir( pDirectory ) ) != NULL )
+		{
+			std::string name( pEntry->d_name );
+			if( name != "." && name != ".." )
+			{
+				++result;
+			}
+		}
+		::closedir( pDirectory );
+		return result;
+	}
+
+	std::string MakeData( size_t i_Lines )
+	{
+		std::stringstream data;
+		for( size_t i = 0; i < i_Lines; ++i )
+		{
+			data << "line " << i << ",some,column,data" << std::endl;
+		}
+		return data.str();
+	}
+
+	std::string ReadAll( std::istream& i_rInput )
+	{
+		std::stringstream result;
+		result << i_rInput.rdbuf();
+		return result.str();
+	}
+}
+
+StagingStreamTest::StagingStreamTest()
+:	m_pTempDir( NULL )
+{
+}
+
+StagingStreamTest::~StagingStreamTest()
+{
+}
+
+void StagingStreamTest::setUp()
+{
+	m_pTempDir.reset( new TempDirectory() );
+}
+
+void StagingStreamTest::tearDown()
+{
+	m_pTempDir.reset( NULL );
+}
+
+void StagingStreamTest::testInMemory()
+{
+	std::string data( MakeData( 1000 ) );
+	StagingStream stream( 1024 * 1024, m_pTempDir->GetDirectoryName() );
+	stream << data;
+	stream.flush();
+
+	CPPUNIT_ASSERT( stream.good() );
+	CPPUNIT_ASSERT( !stream.IsSpilled() );
+	CPPUNIT_ASSERT_EQUAL( size_t(0), stream.GetSpilledBytes() );
+	CPPUNIT_ASSERT_EQUAL( data, ReadAll( stream ) );
+	CPPUNIT_ASSERT_EQUAL( size_t(0), CountFiles( m_pTempDir->GetDirectoryName() ) );
+}
+
+void StagingStreamTest::testSpill()
+{
+	std::string data( MakeData( 10000 ) );
+	StagingStream stream( 1000, m_pTempDir->GetDirectoryName() );
+	stream << data;
+	stream.flush();
+
+	CPPUNIT_ASSERT( stream.good() );
+	CPPUNIT_ASSERT( stream.IsSpilled() );
+	CPPUNIT_ASSERT_EQUAL( data.size(), stream.GetSpilledBytes() );
+	CPPUNIT_ASSERT_EQUAL( data, ReadAll( stream ) );
+
+	// the staging file is never visible in the working directory
+	CPPUNIT_ASSERT_EQUAL( size_t(0), CountFiles( m_pTempDir->GetDirectoryName() ) );
+
+	stream.clear();
+	stream.seekg( 0L );
+	CPPUNIT_ASSERT_EQUAL( data, ReadAll( stream ) );
+}
+
+void StagingStreamTest::testSpillImmediately()
+{
+	StagingStream stream( 0, m_pTempDir->GetDirectoryName() );
+	CPPUNIT_ASSERT( !stream.IsSpilled() );
+	stream << "x";
+	CPPUNIT_ASSERT( stream.IsSpilled() );
+	stream << "yz";
+	stream.flush();
+
+	CPPUNIT_ASSERT_EQUAL( size_t(3), stream.GetSpilledBytes() );
+	CPPUNIT_ASSERT_EQUAL( std::string( "xyz" ), ReadAll( stream ) );
+}
+
+void StagingStreamTest::testLargeWrites()
+{
+	std::string data( MakeData( 100000 ) );
+	StagingStream stream( 1000, m_pTempDir->GetDirectoryName() );
+	stream.write( data.c_str(), 500 );
+	stream.write( data.c_str() + 500, data.size() - 500 );
+	stream.write( data.c_str(), data.size() );
+	stream.flush();
+
+	CPPUNIT_ASSERT( stream.good() );
+	CPPUNIT_ASSERT( stream.IsSpilled() );
+	CPPUNIT_ASSERT_EQUAL( 2 * data.size(), stream.GetSpilledBytes() );
+	CPPUNIT_ASSERT_EQUAL( data + data, ReadAll( stream ) );
+}
+
+void StagingStreamTest::testSeek()
+{
+	std::string data( MakeData( 10000 ) );
+	size_t limits[] = { data.size() * 2, 1000 };
+	for( size_t i = 0; i < sizeof( limits ) / sizeof( size_t ); ++i )
+	{
+		StagingStream stream( limits[i], m_pTempDir->GetDirectoryName() );
+		stream << data;
+		stream.flush();
+		CPPUNIT_ASSERT_EQUAL( std::streampos( data.size() ), stream.tellp() );
+
+		std::string line;
+		std::getline( stream, line );
+		CPPUNIT_ASSERT_EQUAL( std::string( "line 0,some,column,data" ), line );
+		std::streampos position = stream.tellg();
+		CPPUNIT_ASSERT_EQUAL( std::streampos( line.size() + 1 ), position );
+
+		stream.seekg( 0L, std::ios_base::end );
+		CPPUNIT_ASSERT_EQUAL( std::streampos( data.size() ), stream.tellg() );
+		CPPUNIT_ASSERT_EQUAL( std::string(), ReadAll( stream ) );
+
+		stream.clear();
+		stream.seekg( position );
+		CPPUNIT_ASSERT_EQUAL( data.substr( position ), ReadAll( stream ) );
+
+		stream.clear();
+		stream.seekg( -5L, std::ios_base::end );
+		CPPUNIT_ASSERT_EQUAL( std::string( "data\n" ), ReadAll( stream ) );
+
+		// seeking past the data written is not allowed
+		stream.clear();
+		stream.seekg( data.size() + 1 );
+		CPPUNIT_ASSERT( stream.fail() );
+	}
+}
+
+void StagingStreamTest::testInterleavedReadWrite()
+{
+	std::string data( MakeData( 10000 ) );
+	size_t limits[] = { data.size() * 2, data.size() / 2 };
+	for( size_t i = 0; i < sizeof( limits ) / sizeof( size_t ); ++i )
+	{
+		StagingStream stream( limits[i], m_pTempDir->GetDirectoryName() );
+		std::string firstHalf( data.substr( 0, data.size() / 2 - 10 ) );
+		std::string secondHalf( data.substr( firstHalf.size() ) );
+
+		stream << firstHalf;
+		std::string readBack( ReadAll( stream ) );
+		stream.clear();
+
+		// more data becomes readable as it is written
+		stream << secondHalf;
+		readBack += ReadAll( stream );
+		CPPUNIT_ASSERT_EQUAL( data, readBack );
+		CPPUNIT_ASSERT_EQUAL( i > 0, stream.IsSpilled() );
+	}
+}
+
+void StagingStreamTest::testReset()
+{
+	std::string data( MakeData( 10000 ) );
+	StagingStream stream( 1000, m_pTempDir->GetDirectoryName() );
+	stream << data;
+	stream.flush();
+	CPPUNIT_ASSERT( stream.IsSpilled() );
+	CPPUNIT_ASSERT_EQUAL( data, ReadAll( stream ) );
+	stream.get();
+	CPPUNIT_ASSERT( stream.eof() );
+
+	stream.Reset();
+	CPPUNIT_ASSERT( stream.good() );
+	CPPUNIT_ASSERT( !stream.IsSpilled() );
+	CPPUNIT_ASSERT_EQUAL( std::string(), ReadAll( stream ) );
+
+	stream.clear();
+	stream << "small";
+	stream.flush();
+	CPPUNIT_ASSERT( !stream.IsSpilled() );
+	CPPUNIT_ASSERT_EQUAL( std::string( "small" ), ReadAll( stream ) );
+
+	// spilled bytes accumulate across resets
+	stream.Reset();
+	stream << data;
+	stream.flush();
+	CPPUNIT_ASSERT( stream.IsSpilled() );
+	CPPUNIT_ASSERT_EQUAL( 2 * data.size(), stream.GetSpilledBytes() );
+	CPPUNIT_ASSERT_EQUAL( data, ReadAll( stream ) );
+}
+
+void StagingStreamTest::testBadWorkingDir()
+{
+	std::string data( MakeData( 10000 ) );
+	StagingStream stream( 1000, m_pTempDir->GetDirectoryName() + "/nonexistent" );
+	stream << data;
+	stream.flush();
+
+	CPPUNIT_ASSERT( stream.good() );
+	CPPUNIT_ASSERT( !stream.IsSpilled() );
+	CPPUNIT_ASSERT_EQUAL( size_t(0), stream.GetSpilledBytes() );
+	CPPUNIT_ASSERT_EQUAL( data, ReadAll( stream ) );
+}
@@ -0,0 +1,46 @@
+#ifndef _STAGING_STREAM_TEST_HPP_
+#define _STAGING_STREAM_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <boost/scoped_ptr.hpp>
+
+class TempDirectory;
+
+class StagingStreamTest : public CppUnit::TestFixture
+{
+private:
+	CPPUNIT_TEST_SUITE( StagingStreamTest );
+
+	CPPUNIT_TEST( testInMemory );
+	CPPUNIT_TEST( testSpill );
+	CPPUNIT_TEST( testSpillImmediately );
+	CPPUNIT_TEST( testLargeWrites );
+	CPPUNIT_TEST( testSeek );
+	CPPUNIT_TEST( testInterleavedReadWrite );
+	CPPUNIT_TEST( testReset );
+	CPPUNIT_TEST( testBadWorkingDir );
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	StagingStreamTest();
+	virtual ~StagingStreamTest();
+
+	void setUp();
+	void tearDown();
+
+	void testInMemory();
+	void testSpill();
+	void testSpillImmediately();
+	void testLargeWrites();
+	void testSeek();
+	void testInterleavedReadWrite();
+	void testReset();
+	void testBadWorkingDir();
+
+private:
+	boost::scoped_ptr< TempDirectory > m_pTempDir;
+};
+
+#endif //_STAGING_STREAM_TEST_HPP_
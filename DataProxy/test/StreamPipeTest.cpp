@@ -0,0 +1,183 @@
+#include "StreamPipeTest.hpp"
+#include "StreamPipe.hpp"
+#include "AssertThrowWithMessage.hpp"
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION( StreamPipeTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( StreamPipeTest, "StreamPipeTest" );
+
+namespace
+{
+	std::string MakeData( size_t i_Lines )
+	{
+		std::stringstream data;
+		for( size_t i = 0; i < i_Lines; ++i )
+		{
+			data << "line " << i << ",some,column,data" << std::endl;
+		}
+		return data.str();
+	}
+
+	void WriteInPieces( StreamPipe& i_rPipe, const std::string& i_rData, size_t i_PieceSize )
+	{
+		for( size_t i = 0; i < i_rData.size(); i += i_PieceSize )
+		{
+			i_rPipe.Write( i_rData.data() + i, std::min( i_PieceSize, i_rData.size() - i ) );
+		}
+		i_rPipe.CloseWrite();
+	}
+
+	std::string ReadAll( StreamPipe& i_rPipe, size_t i_PieceSize )
+	{
+		std::string result;
+		std::vector< char > buffer( i_PieceSize );
+		size_t bytes;
+		while( ( bytes = i_rPipe.Read( &buffer[0], buffer.size() ) ) > 0 )
+		{
+			result.append( &buffer[0], bytes );
+		}
+		return result;
+	}
+
+	void WriteCatching( StreamPipe& i_rPipe, const std::string& i_rData, bool& o_rThrew )
+	{
+		try
+		{
+			i_rPipe.Write( i_rData.data(), i_rData.size() );
+		}
+		catch( const StreamPipeException& )
+		{
+			o_rThrew = true;
+		}
+	}
+
+	void WriteToStream( StreamPipe& i_rPipe, const std::string& i_rData )
+	{
+		StreamPipeSink sink( i_rPipe );
+		boost::iostreams::stream< StreamPipeSink > output( sink );
+		output << i_rData;
+		output.flush();
+		i_rPipe.CloseWrite();
+	}
+}
+
+StreamPipeTest::StreamPipeTest()
+{
+}
+
+StreamPipeTest::~StreamPipeTest()
+{
+}
+
+void StreamPipeTest::setUp()
+{
+}
+
+void StreamPipeTest::tearDown()
+{
+}
+
+void StreamPipeTest::testReadWrite()
+{
+	StreamPipe pipe( 16 );
+	pipe.Write( "abcdef", 6 );
+
+	char buffer[ 16 ];
+	CPPUNIT_ASSERT_EQUAL( size_t( 4 ), pipe.Read( buffer, 4 ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "abcd" ), std::string( buffer, 4 ) );
+
+	pipe.CloseWrite();
+	CPPUNIT_ASSERT_EQUAL( size_t( 2 ), pipe.Read( buffer, sizeof( buffer ) ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "ef" ), std::string( buffer, 2 ) );
+
+	// once drained, a closed pipe is at end-of-stream, and stays there
+	CPPUNIT_ASSERT_EQUAL( size_t( 0 ), pipe.Read( buffer, sizeof( buffer ) ) );
+	CPPUNIT_ASSERT_EQUAL( size_t( 0 ), pipe.Read( buffer, sizeof( buffer ) ) );
+
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( pipe.Write( "x", 1 ), StreamPipeException,
+		".*/StreamPipe.cpp:\\d+: Attempted to write to a pipe whose write end has been closed" );
+}
+
+void StreamPipeTest::testWrapAround()
+{
+	StreamPipe pipe( 5 );
+	char buffer[ 8 ];
+
+	pipe.Write( "abcd", 4 );
+	CPPUNIT_ASSERT_EQUAL( size_t( 3 ), pipe.Read( buffer, 3 ) );
+	CPPUNIT_ASSERT_EQUAL( std::string( "abc" ), std::string( buffer, 3 ) );
+
+	// this write wraps past the end of the buffer
+	pipe.Write( "efgh", 4 );
+	pipe.CloseWrite();
+
+	std::string result;
+	size_t bytes;
+	while( ( bytes = pipe.Read( buffer, sizeof( buffer ) ) ) > 0 )
+	{
+		result.append( buffer, bytes );
+	}
+	CPPUNIT_ASSERT_EQUAL( std::string( "defgh" ), result );
+}
+
+void StreamPipeTest::testAcrossThreads()
+{
+	// far more data than the pipe can hold, in pieces that don't line up with its capacity
+	std::string data = MakeData( 10000 );
+	StreamPipe pipe( 100 );
+
+	boost::thread writer( boost::bind( &WriteInPieces, boost::ref( pipe ), boost::cref( data ), 37 ) );
+	std::string result = ReadAll( pipe, 23 );
+	writer.join();
+
+	CPPUNIT_ASSERT( data == result );
+}
+
+void StreamPipeTest::testCloseRead()
+{
+	StreamPipe pipe( 10 );
+	pipe.Write( "0123456789", 10 );
+
+	// a writer blocked on a full pipe is released (with an exception) when the reader goes away
+	std::string data = MakeData( 10 );
+	bool threw( false );
+	boost::thread writer( boost::bind( &WriteCatching, boost::ref( pipe ), boost::cref( data ), boost::ref( threw ) ) );
+	pipe.CloseRead();
+	writer.join();
+	CPPUNIT_ASSERT( threw );
+
+	char buffer[ 10 ];
+	CPPUNIT_ASSERT_EQUAL( size_t( 0 ), pipe.Read( buffer, sizeof( buffer ) ) );
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( pipe.Write( "x", 1 ), StreamPipeException,
+		".*/StreamPipe.cpp:\\d+: Attempted to write to a pipe whose read end has been closed" );
+}
+
+void StreamPipeTest::testAbortWrite()
+{
+	StreamPipe pipe( 10 );
+	pipe.Write( "0123", 4 );
+	pipe.AbortWrite();
+
+	// unlike a closed pipe, an aborted one does not hand out what's left as if the stream were complete
+	char buffer[ 10 ];
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( pipe.Read( buffer, sizeof( buffer ) ), StreamPipeException,
+		".*/StreamPipe.cpp:\\d+: The writer to this pipe failed before completing the stream" );
+}
+
+void StreamPipeTest::testStreams()
+{
+	std::string data = MakeData( 10000 );
+	StreamPipe pipe( 64 );
+
+	boost::thread writer( boost::bind( &WriteToStream, boost::ref( pipe ), boost::cref( data ) ) );
+	StreamPipeSource source( pipe );
+	boost::iostreams::stream< StreamPipeSource > input( source );
+	std::stringstream result;
+	result << input.rdbuf();
+	writer.join();
+
+	CPPUNIT_ASSERT( data == result.str() );
+}
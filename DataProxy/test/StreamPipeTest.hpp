@@ -0,0 +1,36 @@
+#ifndef _STREAM_PIPE_TEST_HPP_
+#define _STREAM_PIPE_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class StreamPipeTest : public CppUnit::TestFixture
+{
+private:
+	CPPUNIT_TEST_SUITE( StreamPipeTest );
+
+	CPPUNIT_TEST( testReadWrite );
+	CPPUNIT_TEST( testWrapAround );
+	CPPUNIT_TEST( testAcrossThreads );
+	CPPUNIT_TEST( testCloseRead );
+	CPPUNIT_TEST( testAbortWrite );
+	CPPUNIT_TEST( testStreams );
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	StreamPipeTest();
+	virtual ~StreamPipeTest();
+
+	void setUp();
+	void tearDown();
+
+	void testReadWrite();
+	void testWrapAround();
+	void testAcrossThreads();
+	void testCloseRead();
+	void testAbortWrite();
+	void testStreams();
+};
+
+#endif //_STREAM_PIPE_TEST_HPP_
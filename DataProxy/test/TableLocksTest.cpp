@@ -0,0 +1,82 @@
+#include "TableLocksTest.hpp"
+#include "TableLocks.hpp"
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <unistd.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION( TableLocksTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( TableLocksTest, "TableLocksTest" );
+
+namespace
+{
+	void LockAndCount( TableLocks& i_rLocks, const std::string& i_rTable, boost::mutex& i_rMutex, int& o_rHolders, int& o_rMaxHolders )
+	{
+		TableLocks::Lock lock( i_rLocks, i_rTable );
+		{
+			boost::unique_lock< boost::mutex > countLock( i_rMutex );
+			o_rMaxHolders = std::max( o_rMaxHolders, ++o_rHolders );
+		}
+		::usleep( 20000 );
+		{
+			boost::unique_lock< boost::mutex > countLock( i_rMutex );
+			--o_rHolders;
+		}
+	}
+
+	int RunConcurrently( TableLocks& i_rLocks, const std::string& i_rTable1, const std::string& i_rTable2 )
+	{
+		boost::mutex mutex;
+		int holders = 0;
+		int maxHolders = 0;
+		boost::thread thread1( boost::bind( &LockAndCount, boost::ref( i_rLocks ), boost::cref( i_rTable1 ), boost::ref( mutex ), boost::ref( holders ), boost::ref( maxHolders ) ) );
+		boost::thread thread2( boost::bind( &LockAndCount, boost::ref( i_rLocks ), boost::cref( i_rTable2 ), boost::ref( mutex ), boost::ref( holders ), boost::ref( maxHolders ) ) );
+		thread1.join();
+		thread2.join();
+		return maxHolders;
+	}
+}
+
+TableLocksTest::TableLocksTest()
+{
+}
+
+TableLocksTest::~TableLocksTest()
+{
+}
+
+void TableLocksTest::setUp()
+{
+}
+
+void TableLocksTest::tearDown()
+{
+}
+
+void TableLocksTest::testSameTable()
+{
+	TableLocks locks;
+	CPPUNIT_ASSERT_EQUAL( 1, RunConcurrently( locks, "stg_kna", "stg_kna" ) );
+}
+
+void TableLocksTest::testDifferentTables()
+{
+	TableLocks locks;
+	CPPUNIT_ASSERT_EQUAL( 2, RunConcurrently( locks, "stg_kna", "stg_kna2" ) );
+}
+
+void TableLocksTest::testCleanup()
+{
+	TableLocks locks;
+	CPPUNIT_ASSERT_EQUAL( size_t( 0 ), locks.GetSize() );
+	{
+		TableLocks::Lock lock1( locks, "kna" );
+		TableLocks::Lock lock2( locks, "stg_kna" );
+		CPPUNIT_ASSERT_EQUAL( size_t( 2 ), locks.GetSize() );
+	}
+	CPPUNIT_ASSERT_EQUAL( size_t( 0 ), locks.GetSize() );
+
+	// and once everyone that waited on a table has had it
+	RunConcurrently( locks, "kna", "kna" );
+	CPPUNIT_ASSERT_EQUAL( size_t( 0 ), locks.GetSize() );
+}
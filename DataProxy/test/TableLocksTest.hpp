@@ -0,0 +1,30 @@
+#ifndef _TABLE_LOCKS_TEST_HPP_
+#define _TABLE_LOCKS_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class TableLocksTest : public CppUnit::TestFixture
+{
+private:
+	CPPUNIT_TEST_SUITE( TableLocksTest );
+
+	CPPUNIT_TEST( testSameTable );
+	CPPUNIT_TEST( testDifferentTables );
+	CPPUNIT_TEST( testCleanup );
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	TableLocksTest();
+	virtual ~TableLocksTest();
+
+	void setUp();
+	void tearDown();
+
+	void testSameTable();
+	void testDifferentTables();
+	void testCleanup();
+};
+
+#endif //_TABLE_LOCKS_TEST_HPP_
@@ -73,6 +73,15 @@ void TransformerManagerTest::testGarbageNode()
 	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "testGarbageNode", nodes );
 	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
 	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TransformerManager transformer( *nodes[0] ), XMLUtilitiesException, ".*/XMLUtilities.cpp:\\d+: Found invalid attribute: randomname in node: StreamTransformers" );
+
+	xmlContents.str("");	
+	xmlContents << "<testGarbageNode>"
+				<< " <StreamTransformers pipelined=\"true\" pipeSize=\"0\">"
+				<< " </StreamTransformers>"
+				<< "</testGarbageNode>";
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "testGarbageNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( TransformerManager transformer( *nodes[0] ), TransformerManagerException, ".*/TransformerManager.cpp:\\d+: Attribute: pipeSize must be greater than 0" );
 	
 }
 
@@ -152,6 +161,91 @@ void TransformerManagerTest::testTransformStream()
 	
 }
 
+void TransformerManagerTest::testTransformStreamPipelined()
+{
+	// a tiny pipe forces every stage to block on its neighbors over and over
+	std::stringstream xmlContents;
+	xmlContents << "<testGarbageNode>"
+				<< " <StreamTransformers pipelined=\"true\" pipeSize=\"1\">"
+				<< " <StreamTransformer type=\"StreamingTransformFunction\">"
+				<< "		<Parameter name=\"name1\" value=\"value1\"/>"
+				<< " </StreamTransformer>"
+				<< " <StreamTransformer path=\"" << m_LibrarySpec << "\"" << " functionName=\"TransformFunction\">"
+				<< "		<Parameter name=\"name2\" value=\"value2\"/>"
+				<< " </StreamTransformer>"
+				<< " <StreamTransformer type=\"StreamingTransformFunction\">"
+				<< "		<Parameter name=\"name3\" value=\"value3\"/>"
+				<< " </StreamTransformer>"
+				<< " </StreamTransformers>"
+				<< "</testGarbageNode>";
+	std::vector<xercesc::DOMNode*> nodes;
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "testGarbageNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	std::map< std::string, std::string > parameters;
+	parameters["runtimeParam1"] = "runtimeValue1";
+
+	TransformerManager transformerManager( *nodes[0] );
+	std::stringstream* pInputStream = new std::stringstream();
+	boost::shared_ptr< std::istream > pInputStreamAsIstream( pInputStream );
+	*pInputStream << "DATA FROM TEST JOB";
+
+	CPPUNIT_ASSERT_EQUAL( std::string("name3 : value3\nname2 : value2\nname1 : value1\nDATA FROM TEST JOB"), StreamToString( *transformerManager.TransformStream( parameters, pInputStreamAsIstream ) ) );
+
+	pInputStream->str("");
+	pInputStream->clear();
+	CPPUNIT_ASSERT_EQUAL( std::string("name3 : value3\nname2 : value2\nname1 : value1\n"), StreamToString( *transformerManager.TransformStream( parameters, pInputStreamAsIstream ) ) );
+
+	// the last transformer does not support streaming
+	xmlContents.str("");
+	xmlContents << "<testGarbageNode>"
+				<< " <StreamTransformers pipelined=\"true\">"
+				<< " <StreamTransformer type=\"StreamingTransformFunction\">"
+				<< "		<Parameter name=\"name1\" value=\"value1\"/>"
+				<< " </StreamTransformer>"
+				<< " <StreamTransformer type=\"StreamingTransformFunction\">"
+				<< "		<Parameter name=\"name2\" value=\"value2\"/>"
+				<< " </StreamTransformer>"
+				<< " <StreamTransformer type=\"StandardTransformFunction\">"
+				<< "		<Parameter name=\"name3\" value=\"value3\"/>"
+				<< " </StreamTransformer>"
+				<< " </StreamTransformers>"
+				<< "</testGarbageNode>";
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "testGarbageNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	TransformerManager transformerManager1( *nodes[0] );
+	pInputStream->str("");
+	pInputStream->clear();
+	*pInputStream << "DATA FROM TEST JOB";
+	CPPUNIT_ASSERT_EQUAL( std::string("name3 : value3\nname2 : value2\nname1 : value1\nDATA FROM TEST JOB"), StreamToString( *transformerManager1.TransformStream( parameters, pInputStreamAsIstream ) ) );
+
+	// an error in the middle of the pipeline is reported, rather than a truncated result
+	xmlContents.str("");
+	xmlContents << "<testGarbageNode>"
+				<< " <StreamTransformers pipelined=\"true\" pipeSize=\"4\">"
+				<< " <StreamTransformer type=\"StreamingTransformFunction\">"
+				<< "		<Parameter name=\"name1\" value=\"value1\"/>"
+				<< " </StreamTransformer>"
+				<< " <StreamTransformer type=\"ThrowingTransformFunction\">"
+				<< "		<Parameter name=\"name2\" value=\"value2\"/>"
+				<< " </StreamTransformer>"
+				<< " <StreamTransformer type=\"StreamingTransformFunction\">"
+				<< "		<Parameter name=\"name3\" value=\"value3\"/>"
+				<< " </StreamTransformer>"
+				<< " </StreamTransformers>"
+				<< "</testGarbageNode>";
+	ProxyTestHelpers::GetDataNodes( m_pTempDir->GetDirectoryName(), xmlContents.str(), "testGarbageNode", nodes );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), nodes.size() );
+
+	TransformerManager transformerManager2( *nodes[0] );
+	pInputStream->str("");
+	pInputStream->clear();
+	*pInputStream << "DATA FROM TEST JOB";
+	CPPUNIT_ASSERT_THROW_WITH_MESSAGE( transformerManager2.TransformStream( parameters, pInputStreamAsIstream ), StreamTransformerException,
+		".*/StreamTransformer.cpp:\\d+: Caught exception: an exception while executing transformer type: ThrowingTransformFunction with parameters: name2~value2 after .* milliseconds" );
+}
+
 void TransformerManagerTest::testHasTransformers()
 {
 	std::stringstream xmlContents;
@@ -26,6 +26,7 @@ private:
 	CPPUNIT_TEST( testGarbageNode );
 	CPPUNIT_TEST( testConstructor );
 	CPPUNIT_TEST( testTransformStream );
+	CPPUNIT_TEST( testTransformStreamPipelined );
 	CPPUNIT_TEST( testHasTransformers );
 	CPPUNIT_TEST_SUITE_END();
 
@@ -39,6 +40,7 @@ public:
 	void testGarbageNode();
 	void testConstructor();
 	void testTransformStream();
+	void testTransformStreamPipelined();
 	void testHasTransformers();
 
 private:
@@ -0,0 +1,127 @@
+#include "WorkerPoolTest.hpp"
+#include "WorkerPool.hpp"
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+CPPUNIT_TEST_SUITE_REGISTRATION( WorkerPoolTest );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( WorkerPoolTest, "WorkerPoolTest" );
+
+namespace
+{
+	void Append( boost::mutex& i_rMutex, std::vector< int >& o_rValues, int i_Value )
+	{
+		boost::unique_lock< boost::mutex > lock( i_rMutex );
+		o_rValues.push_back( i_Value );
+	}
+
+	// tracks the most tasks seen running at once
+	class ConcurrencyTracker
+	{
+	public:
+		ConcurrencyTracker() : m_Mutex(), m_Running( 0 ), m_MaxRunning( 0 ), m_Total( 0 ) {}
+
+		void Task()
+		{
+			{
+				boost::unique_lock< boost::mutex > lock( m_Mutex );
+				m_MaxRunning = std::max( m_MaxRunning, ++m_Running );
+			}
+			boost::this_thread::sleep( boost::posix_time::milliseconds( 5 ) );
+			boost::unique_lock< boost::mutex > lock( m_Mutex );
+			--m_Running;
+			++m_Total;
+		}
+
+		boost::mutex m_Mutex;
+		size_t m_Running;
+		size_t m_MaxRunning;
+		size_t m_Total;
+	};
+
+	void Throw()
+	{
+		throw std::runtime_error( "task failed" );
+	}
+}
+
+WorkerPoolTest::WorkerPoolTest()
+{
+}
+
+WorkerPoolTest::~WorkerPoolTest()
+{
+}
+
+void WorkerPoolTest::setUp()
+{
+}
+
+void WorkerPoolTest::tearDown()
+{
+}
+
+void WorkerPoolTest::testOrder()
+{
+	boost::mutex mutex;
+	std::vector< int > values;
+
+	WorkerPool pool( 1 );
+	CPPUNIT_ASSERT_EQUAL( size_t(1), pool.GetNumThreads() );
+	for( int i = 0; i < 100; ++i )
+	{
+		pool.Post( boost::bind( &Append, boost::ref( mutex ), boost::ref( values ), i ) );
+	}
+	pool.WaitForIdle();
+
+	CPPUNIT_ASSERT_EQUAL( size_t(100), values.size() );
+	for( int i = 0; i < 100; ++i )
+	{
+		CPPUNIT_ASSERT_EQUAL( i, values[i] );
+	}
+}
+
+void WorkerPoolTest::testConcurrencyBound()
+{
+	ConcurrencyTracker tracker;
+
+	WorkerPool pool( 3 );
+	for( int i = 0; i < 30; ++i )
+	{
+		pool.Post( boost::bind( &ConcurrencyTracker::Task, &tracker ) );
+	}
+	pool.WaitForIdle();
+
+	CPPUNIT_ASSERT_EQUAL( size_t(30), tracker.m_Total );
+	CPPUNIT_ASSERT( tracker.m_MaxRunning <= 3 );
+	CPPUNIT_ASSERT( tracker.m_MaxRunning > 1 );
+}
+
+void WorkerPoolTest::testException()
+{
+	boost::mutex mutex;
+	std::vector< int > values;
+
+	// a failing task does not take its thread down with it
+	WorkerPool pool( 1 );
+	pool.Post( &Throw );
+	pool.Post( boost::bind( &Append, boost::ref( mutex ), boost::ref( values ), 1 ) );
+	pool.WaitForIdle();
+
+	CPPUNIT_ASSERT_EQUAL( size_t(1), values.size() );
+}
+
+void WorkerPoolTest::testDestroyRunsPostedTasks()
+{
+	ConcurrencyTracker tracker;
+	{
+		WorkerPool pool( 2 );
+		for( int i = 0; i < 10; ++i )
+		{
+			pool.Post( boost::bind( &ConcurrencyTracker::Task, &tracker ) );
+		}
+	}
+	CPPUNIT_ASSERT_EQUAL( size_t(10), tracker.m_Total );
+}
@@ -0,0 +1,32 @@
+#ifndef _WORKER_POOL_TEST_HPP_
+#define _WORKER_POOL_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class WorkerPoolTest : public CppUnit::TestFixture
+{
+private:
+	CPPUNIT_TEST_SUITE( WorkerPoolTest );
+
+	CPPUNIT_TEST( testOrder );
+	CPPUNIT_TEST( testConcurrencyBound );
+	CPPUNIT_TEST( testException );
+	CPPUNIT_TEST( testDestroyRunsPostedTasks );
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	WorkerPoolTest();
+	virtual ~WorkerPoolTest();
+
+	void setUp();
+	void tearDown();
+
+	void testOrder();
+	void testConcurrencyBound();
+	void testException();
+	void testDestroyRunsPostedTasks();
+};
+
+#endif //_WORKER_POOL_TEST_HPP_